@@ -1,25 +1,150 @@
 {
+  "variables": {
+    "zlgcan_engine_sources": [
+      "src/zlgcan/api_stats.cpp",
+      "src/zlgcan/trace_buffer.cpp",
+      "src/zlgcan/device_gate.cpp",
+      "src/zlgcan/thread_scheduling.cpp",
+      "src/zlgcan/channel_health.cpp",
+      "src/zlgcan/pipeline_watchdog.cpp",
+      "src/zlgcan/device_monitor.cpp",
+      "src/zlgcan/channel_quiesce.cpp",
+      "src/zlgcan/uds_client.cpp",
+      "src/zlgcan/receive_pump.cpp",
+      "src/zlgcan/isotp_engine.cpp",
+      "src/zlgcan/j1939_engine.cpp",
+      "src/zlgcan/xcp_master.cpp",
+      "src/zlgcan/canopen_client.cpp",
+      "src/zlgcan/rest_bus_engine.cpp",
+      "src/zlgcan/e2e_protection.cpp",
+      "src/zlgcan/firmware_image.cpp",
+      "src/zlgcan/flash_pipeline.cpp",
+      "src/zlgcan/lin_receive_pump.cpp"
+    ]
+  },
   "targets": [
     {
-      "target_name": "zlgcan",
+      "target_name": "zlgcan_sim",
       "sources": [
-        "src/zlgcan/zlgcan_wrapper.cpp"
+        "src/zlgcan/zlgcan_wrapper.cpp",
+        "<@(zlgcan_engine_sources)",
+        "src/zlgcan/zlgcan_unsupported.cpp",
+        "src/zlgcan/sim/sim_can.cpp",
+        "src/zlgcan/sim/zlgcan_sim.cpp"
       ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")",
         "src/zlgcan/include"
       ],
-      "libraries": [
-        "<(module_root_dir)/src/zlgcan/lib/zlgcan.lib"
-      ],
       "defines": [
         "NAPI_CPP_EXCEPTIONS"
       ],
+      "cflags!": ["-fno-exceptions"],
+      "cflags_cc!": ["-fno-exceptions"],
+      "xcode_settings": {
+        "GCC_ENABLE_CPP_EXCEPTIONS": "YES"
+      },
+      "msvs_settings": {
+        "VCCLCompilerTool": {
+          "ExceptionHandling": 1
+        }
+      }
+    },
+    {
+      "target_name": "zlgcan_native_tests",
+      "type": "executable",
+      "sources": [
+        "<@(zlgcan_engine_sources)",
+        "src/zlgcan/zlgcan_unsupported.cpp",
+        "src/zlgcan/sim/sim_can.cpp",
+        "src/zlgcan/sim/zlgcan_sim.cpp",
+        "test/native/native_test_main.cpp",
+        "test/native/api_stats_test.cpp",
+        "test/native/channel_health_test.cpp",
+        "test/native/channel_quiesce_test.cpp",
+        "test/native/device_gate_test.cpp",
+        "test/native/device_monitor_test.cpp",
+        "test/native/e2e_protection_test.cpp",
+        "test/native/pipeline_watchdog_test.cpp",
+        "test/native/receive_pump_test.cpp",
+        "test/native/sim_can_test.cpp",
+        "test/native/thread_scheduling_test.cpp",
+        "test/native/trace_buffer_test.cpp"
+      ],
+      "include_dirs": [
+        "src/zlgcan",
+        "src/zlgcan/include"
+      ],
+      "conditions": [
+        ["OS=='linux'", {
+          "sources": [
+            "src/zlgcan/socketcan/socketcan_port.cpp",
+            "test/native/socketcan_port_test.cpp"
+          ]
+        }]
+      ],
+      "cflags!": ["-fno-exceptions"],
+      "cflags_cc!": ["-fno-exceptions"],
+      "xcode_settings": {
+        "GCC_ENABLE_CPP_EXCEPTIONS": "YES"
+      },
       "msvs_settings": {
         "VCCLCompilerTool": {
           "ExceptionHandling": 1
         }
       }
     }
+  ],
+  "conditions": [
+    ["OS=='linux'", {
+      "targets": [
+        {
+          "target_name": "zlgcan_socketcan",
+          "sources": [
+            "src/zlgcan/zlgcan_wrapper.cpp",
+        "<@(zlgcan_engine_sources)",
+            "src/zlgcan/zlgcan_unsupported.cpp",
+            "src/zlgcan/socketcan/socketcan_port.cpp",
+            "src/zlgcan/socketcan/socketcan_backend.cpp",
+            "src/zlgcan/socketcan/zlgcan_socketcan.cpp"
+          ],
+          "include_dirs": [
+            "<!@(node -p \"require('node-addon-api').include\")",
+            "src/zlgcan/include"
+          ],
+          "defines": [
+            "NAPI_CPP_EXCEPTIONS"
+          ],
+          "cflags!": ["-fno-exceptions"],
+          "cflags_cc!": ["-fno-exceptions"]
+        }
+      ]
+    }],
+    ["OS=='win'", {
+      "targets": [
+        {
+          "target_name": "zlgcan",
+          "sources": [
+            "src/zlgcan/zlgcan_wrapper.cpp",
+            "<@(zlgcan_engine_sources)"
+          ],
+          "include_dirs": [
+            "<!@(node -p \"require('node-addon-api').include\")",
+            "src/zlgcan/include"
+          ],
+          "libraries": [
+            "<(module_root_dir)/src/zlgcan/lib/zlgcan.lib"
+          ],
+          "defines": [
+            "NAPI_CPP_EXCEPTIONS"
+          ],
+          "msvs_settings": {
+            "VCCLCompilerTool": {
+              "ExceptionHandling": 1
+            }
+          }
+        }
+      ]
+    }]
   ]
 }
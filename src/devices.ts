@@ -3,6 +3,7 @@
  * 提供统一的CAN设备接口，适配不同厂商的CAN设备
  */
 
+import { Readable } from 'stream';
 import * as zlgcan from './zlgcan';
 
 // ============== 错误码定义 ==============
@@ -73,6 +74,22 @@ export enum CanDeviceState {
   Error = 'Error',
 }
 
+/**
+ * CAN总线状态
+ */
+export enum CanBusState {
+  /** 尚未采样 */
+  Unknown = 'Unknown',
+  /** 错误主动 */
+  Active = 'Active',
+  /** 错误告警 */
+  Warning = 'Warning',
+  /** 错误被动 */
+  Passive = 'Passive',
+  /** 总线关闭 */
+  BusOff = 'BusOff',
+}
+
 // ============== 接口定义 ==============
 
 /**
@@ -151,6 +168,253 @@ export interface IChannelConfig {
   mode?: number;
 }
 
+/**
+ * 通道健康监视配置
+ */
+export interface IHealthMonitorOptions {
+  /** 错误计数器采样周期(ms) */
+  pollIntervalMs?: number;
+  /** 总线关闭后自动恢复通道 */
+  autoRecover?: boolean;
+  /** 首次恢复前的等待时间(ms) */
+  recoveryDelayMs?: number;
+  /** 退避等待上限(ms) */
+  maxRecoveryDelayMs?: number;
+  /** 最大恢复次数 (0:不限) */
+  maxRecoveryAttempts?: number;
+  /** 状态好转须连续一致的采样次数 */
+  settlePolls?: number;
+}
+
+/**
+ * 通道健康事件接口
+ */
+export interface IChannelHealthEvent {
+  /** 事件类型 */
+  type: 'stateChange' | 'recoveryAttempt' | 'recovered';
+  /** 通道索引 */
+  channelIndex: number;
+  /** 当前总线状态 */
+  state: CanBusState;
+  /** 之前的总线状态 */
+  previousState: CanBusState;
+  /** 事件时间 (Date.now()基准, ms) */
+  timestamp: number;
+  /** 接收错误计数 */
+  rxErrCount: number;
+  /** 发送错误计数 */
+  txErrCount: number;
+  /** 恢复尝试序号 */
+  attempt: number;
+  /** 恢复调用是否成功 */
+  success: boolean;
+  /** 恢复耗时 (微秒) */
+  latencyUs: number;
+}
+
+/**
+ * 设备热插拔事件接口
+ */
+export interface IDeviceHotplugEvent {
+  /** 事件类型 */
+  type: 'offline' | 'reconnected';
+  /** 事件时间 (Date.now()基准, ms) */
+  timestamp: number;
+  /** 重新打开设备的尝试次数 */
+  attempts: number;
+  /** 回放失败的操作数 */
+  replayFailures: number;
+  /** 重连耗时 (微秒) */
+  reconnectUs: number;
+}
+
+/**
+ * 接收链路监视配置
+ */
+export interface IPipelineWatchdogOptions {
+  /** 采样及事件循环探测周期(ms) */
+  intervalMs?: number;
+  /** 事件循环延迟告警阈值(ms) */
+  lagWarnMs?: number;
+  /** 接收环形缓冲占用率告警阈值 (0~1) */
+  ringWarnRatio?: number;
+  /** 驱动接收缓冲帧数告警阈值 */
+  vendorWarnFrames?: number;
+  /** 保留的采样点数 */
+  historySize?: number;
+}
+
+/**
+ * 接收链路告警接口
+ */
+export interface IPipelineWarning {
+  /** 告警类型 */
+  type: 'eventLoopLag' | 'ringFilling' | 'vendorQueue' | 'framesDropped';
+  /** 设备通道索引 (eventLoopLag无此字段) */
+  channelIndex?: number;
+  /** 告警产生时间 (Date.now()基准, ms) */
+  timestamp: number;
+  /** 延迟(ms)、占用率、帧数或丢帧数 */
+  value: number;
+  /** 对应阈值 */
+  threshold: number;
+  /** 同一时刻的事件循环延迟(ms) */
+  lagMs: number;
+  /** 预计缓冲写满时间(ms)，-1表示未在增长 */
+  etaMs: number;
+}
+
+/**
+ * 接收链路采样点接口
+ */
+export interface IPipelineSample {
+  /** 采样时间 (Date.now()基准, ms) */
+  timestamp: number;
+  /** 事件循环延迟(ms) */
+  lagMs: number;
+  /** 探测尚未应答 */
+  stalled: boolean;
+  /** 各通道缓冲深度与丢帧数 */
+  channels: {
+    channelIndex: number;
+    ringDepth: number;
+    ringCapacity: number;
+    vendorDepth: number;
+    framesReceived: number;
+    framesDropped: number;
+  }[];
+}
+
+/**
+ * 接收线程读取方式
+ * - blocking: 驱动内阻塞等待，CPU占用最低，适合笔记本编辑调试
+ * - adaptive: 按驱动缓冲帧数读取，空闲时退避（默认）
+ * - busyPoll: 持续轮询，延迟最低，独占一个CPU核，适合专用HIL测试机
+ */
+export type ReceiveMode = 'blocking' | 'adaptive' | 'busyPoll';
+
+/**
+ * 接收线程配置
+ */
+export interface IReceiveThreadOptions {
+  /** 读取方式 */
+  mode?: ReceiveMode;
+  /** 原生接收缓冲容量（帧） */
+  ringCapacity?: number;
+  /** 缓冲满时的丢弃策略 */
+  dropPolicy?: RingDropPolicy;
+  /** blocking单次读取的最长等待(ms) */
+  blockWaitMs?: number;
+  /** adaptive空闲等待间隔范围(微秒) */
+  minIdleSleepUs?: number;
+  idleSleepUs?: number;
+  /** 未认领的帧是否放入receive缓冲，只通过帧流取帧时设为false */
+  sharedRing?: boolean;
+}
+
+/**
+ * 接收线程统计接口
+ */
+export interface IReceiveThreadStats {
+  /** 读取方式 */
+  mode: ReceiveMode;
+  /** 从驱动读取的帧数 */
+  framesReceived: number;
+  /** 缓冲满时丢弃的帧数 */
+  framesDropped: number;
+  /** 线程运行时长 (微秒) */
+  uptimeUs: number;
+  /** 线程累计CPU时间 (微秒) */
+  cpuTimeUs: number;
+  /** 取帧延迟分位数 (微秒)，以最近最快一帧为基准 */
+  latencyP50Us: number;
+  latencyP99Us: number;
+  latencyMaxUs: number;
+}
+
+/**
+ * 接收缓冲写满时的丢弃策略
+ * - dropOldest: 丢弃最旧的帧，保留最新状态（监视界面）
+ * - dropNewest: 丢弃新到的帧，保留较早的连续序列（记录与分析）
+ */
+export type RingDropPolicy = 'dropOldest' | 'dropNewest';
+
+/**
+ * 帧流配置
+ */
+export interface IFrameStreamOptions {
+  /** 该帧流原生缓冲的容量（帧，CAN和CANFD各一份），即背压阈值，默认65536 */
+  highWaterMark?: number;
+  /** 缓冲满时的丢弃策略，默认dropOldest */
+  dropPolicy?: RingDropPolicy;
+  /** 每批最多帧数（CAN和CANFD各计） */
+  batchSize?: number;
+  /** 接收线程读取方式，接收线程已以其他方式运行时打开失败 */
+  mode?: ReceiveMode;
+}
+
+/**
+ * 帧流中的一批帧
+ */
+export interface IFrameBatch {
+  frames: IReceivedFrame[];
+  fdFrames: IReceivedFDFrame[];
+  /** 上一批之后因该帧流消费跟不上被其原生缓冲丢弃的帧数 */
+  dropped: number;
+}
+
+/**
+ * 接收帧流（objectMode Readable，每个数据块为一批帧IFrameBatch）
+ * 每个帧流有独立的原生缓冲，收到通道上全部未被协议引擎认领的帧，不与receive或其他帧流分取。
+ * 丢帧时额外触发'drop'事件，参数为丢弃的帧数
+ */
+export interface IFrameStream extends Readable {
+  /** 原生缓冲的实际容量 */
+  readonly ringCapacity: number;
+  /** 原生缓冲的实际丢弃策略 */
+  readonly dropPolicy: RingDropPolicy;
+}
+
+/**
+ * UDS诊断请求接口
+ */
+export interface IUdsRequest {
+  /** 请求地址 */
+  srcAddr: number;
+  /** 响应地址 */
+  dstAddr: number;
+  /** 请求服务ID */
+  sid: number;
+  /** 请求数据（不含SID） */
+  data?: number[];
+  /** 抑制积极响应 */
+  suppressResponse?: boolean;
+  /** P2超时 (ms) */
+  timeoutMs?: number;
+  /** P2*超时 (ms) */
+  enhancedTimeoutMs?: number;
+  /** 是否使用扩展帧 */
+  extFrame?: boolean;
+}
+
+/**
+ * UDS诊断响应接口
+ */
+export interface IUdsResponse {
+  /** 是否为积极响应 */
+  positive: boolean;
+  /** 积极响应为响应服务ID，消极响应为请求服务ID */
+  sid?: number;
+  /** 消极响应码 */
+  negativeCode?: number;
+  /** 积极响应数据（不含SID） */
+  data: number[];
+  /** 排队等待耗时 (微秒) */
+  queuedUs: number;
+  /** 请求耗时 (微秒) */
+  requestUs: number;
+}
+
 /**
  * CAN通道接口
  */
@@ -202,6 +466,49 @@ export interface ICanChannel {
    */
   receiveFD(count: number, waitTime: number): Promise<IReceivedFDFrame[]>;
 
+  /**
+   * 清空通道接收缓冲区
+   */
+  clearBuffer(): Promise<void>;
+
+  /**
+   * 启动通道健康监视（在驱动线程中运行，不依赖事件循环）
+   * @param options 监视配置
+   * @param callback 健康事件回调
+   */
+  startHealthMonitor(options: IHealthMonitorOptions, callback: (event: IChannelHealthEvent) => void): void;
+
+  /**
+   * 停止通道健康监视
+   */
+  stopHealthMonitor(): void;
+
+  /**
+   * 启动驱动接收线程，之后receive/receiveFD从线程的缓存中取帧
+   * @param options 接收线程配置
+   */
+  startReceiveThread(options: IReceiveThreadOptions): void;
+
+  /**
+   * 获取接收线程统计，未启动时返回null
+   */
+  getReceiveThreadStats(): IReceiveThreadStats | null;
+
+  /**
+   * 以流的形式读取接收帧，例如 for await (const batch of channel.frames())
+   * 未启动接收线程时自动启动；每个通道同时只能有一个帧流，且与receive/receiveFD共用同一缓冲。
+   * 消费方跟不上时帧留在原生缓冲中，写满后按丢弃策略丢弃；通道关闭后流结束
+   * @param options 帧流配置
+   */
+  frames(options?: IFrameStreamOptions): IFrameStream;
+
+  /**
+   * 发送UDS诊断请求（在驱动线程中执行，不同通道的请求可并发）
+   * 超时、发送失败等无响应的情况抛出异常，消极响应正常返回
+   * @param request 诊断请求
+   */
+  udsRequest(request: IUdsRequest): Promise<IUdsResponse>;
+
   /**
    * 关闭通道
    */
@@ -243,6 +550,42 @@ export interface ICanDevice {
    * 检查设备是否在线
    */
   isOnline(): boolean;
+
+  /**
+   * 静默所有通道：取消设备端周期发送，等待发送队列排空并清空接收缓冲区
+   * @param timeoutMs 最长等待时间(ms)
+   * @returns 时限内发送队列是否已排空
+   */
+  quiesce(timeoutMs: number): Promise<boolean>;
+
+  /**
+   * 启动热插拔监视，设备掉线后自动重连并恢复通道配置
+   * @param callback 热插拔事件回调
+   */
+  startHotplugMonitor(callback: (event: IDeviceHotplugEvent) => void): void;
+
+  /**
+   * 停止热插拔监视
+   */
+  stopHotplugMonitor(): void;
+
+  /**
+   * 启动接收链路监视：测量事件循环延迟并采样各通道缓冲深度，在丢帧前告警
+   * @param options 监视配置
+   * @param callback 告警回调
+   */
+  startPipelineWatchdog(options: IPipelineWatchdogOptions, callback: (warning: IPipelineWarning) => void): void;
+
+  /**
+   * 停止接收链路监视
+   */
+  stopPipelineWatchdog(): void;
+
+  /**
+   * 获取接收链路采样序列
+   * @param sinceTimestamp 只返回晚于该时间的采样点
+   */
+  getPipelineHistory(sinceTimestamp?: number): IPipelineSample[];
 }
 
 /**
@@ -274,6 +617,33 @@ export interface ICanDriver {
 
 // ============== ZLG CAN 实现 ==============
 
+/** 设备打开超时(ms)，网络设备打开可能需要数秒 */
+const DEVICE_OPEN_TIMEOUT_MS = 10000;
+
+/** 通道初始化/启动超时(ms) */
+const CHANNEL_OPERATION_TIMEOUT_MS = 5000;
+
+/** 帧流原生缓冲的默认容量（帧） */
+const FRAME_STREAM_DEFAULT_CAPACITY = 65536;
+
+/**
+ * ZLG节点状态转换为总线状态
+ */
+function toCanBusState(nodeState: number): CanBusState {
+  switch (nodeState) {
+    case zlgcan.NodeState.ZCAN_NODE_STATE_ACTIVE:
+      return CanBusState.Active;
+    case zlgcan.NodeState.ZCAN_NODE_STATE_WARNNING:
+      return CanBusState.Warning;
+    case zlgcan.NodeState.ZCAN_NODE_STATE_PASSIVE:
+      return CanBusState.Passive;
+    case zlgcan.NodeState.ZCAN_NODE_STATE_BUSOFF:
+      return CanBusState.BusOff;
+    default:
+      return CanBusState.Unknown;
+  }
+}
+
 /**
  * 波特率转换工具
  */
@@ -333,8 +703,9 @@ class ZlgCanChannel implements ICanChannel {
 
   constructor(
     public readonly channelIndex: number,
-    private readonly handle: zlgcan.ChannelHandle,
-    private readonly device: zlgcan.ZlgCanDevice
+    readonly handle: zlgcan.ChannelHandle,
+    private readonly device: zlgcan.ZlgCanDevice,
+    private readonly isFD: boolean = false
   ) {}
 
   get isRunning(): boolean {
@@ -346,7 +717,15 @@ class ZlgCanChannel implements ICanChannel {
       return;
     }
 
-    const success = this.device.startCanChannel(this.handle);
+    let success: boolean;
+    try {
+      success = await this.device.startCanChannelAsync(this.handle, CHANNEL_OPERATION_TIMEOUT_MS);
+    } catch (error: any) {
+      throw new CanDeviceError(
+        ErrorCode.CHANNEL_START_FAILED,
+        `通道 ${this.channelIndex} 启动失败: ${error.message}`
+      );
+    }
     if (!success) {
       throw new CanDeviceError(
         ErrorCode.CHANNEL_START_FAILED,
@@ -377,6 +756,16 @@ class ZlgCanChannel implements ICanChannel {
     }
   }
 
+  async clearBuffer(): Promise<void> {
+    const success = this.device.clearBuffer(this.handle);
+    if (!success) {
+      throw new CanDeviceError(
+        ErrorCode.BUS_ERROR,
+        `通道 ${this.channelIndex} 清空缓冲区失败`
+      );
+    }
+  }
+
   async transmit(frame: ICanFrame): Promise<void> {
     const zlgFrame: zlgcan.CanFrame = {
       id: frame.id,
@@ -447,12 +836,211 @@ class ZlgCanChannel implements ICanChannel {
     }
   }
 
+  startHealthMonitor(options: IHealthMonitorOptions, callback: (event: IChannelHealthEvent) => void): void {
+    const success = this.device.startHealthMonitor(this.handle, options, (event) => {
+      callback({
+        type: event.type,
+        channelIndex: event.channelIndex,
+        state: toCanBusState(event.state),
+        previousState: toCanBusState(event.previousState),
+        timestamp: event.timestamp,
+        rxErrCount: event.rxErrCount,
+        txErrCount: event.txErrCount,
+        attempt: event.attempt,
+        success: event.success,
+        latencyUs: event.latencyUs,
+      });
+    });
+    if (!success) {
+      throw new CanDeviceError(
+        ErrorCode.BUS_ERROR,
+        `通道 ${this.channelIndex} 健康监视启动失败`
+      );
+    }
+  }
+
+  stopHealthMonitor(): void {
+    this.device.stopHealthMonitor(this.handle);
+  }
+
+  startReceiveThread(options: IReceiveThreadOptions): void {
+    try {
+      // 已启动时返回false，配置保持不变
+      this.device.startReceiveThread(this.handle, options);
+    } catch (error: any) {
+      throw new CanDeviceError(
+        ErrorCode.BUS_ERROR,
+        `通道 ${this.channelIndex} 接收线程启动失败: ${error.message}`
+      );
+    }
+  }
+
+  getReceiveThreadStats(): IReceiveThreadStats | null {
+    const stats = this.device.getReceiveThreadStats(this.handle);
+    if (!stats) {
+      return null;
+    }
+    return {
+      mode: stats.mode,
+      framesReceived: stats.framesReceived,
+      framesDropped: stats.framesDropped,
+      uptimeUs: stats.uptimeUs,
+      cpuTimeUs: stats.cpuTimeUs,
+      latencyP50Us: stats.pickupLatency.p50Us,
+      latencyP99Us: stats.pickupLatency.p99Us,
+      latencyMaxUs: stats.pickupLatency.maxUs,
+    };
+  }
+
+  frames(options: IFrameStreamOptions = {}): IFrameStream {
+    const running = this.device.getReceiveThreadStats(this.handle);
+    if (!running) {
+      // 帧流各有缓冲，接收线程由帧流启动时不缓存给receive
+      const threadOptions: IReceiveThreadOptions = { sharedRing: false };
+      if (options.mode !== undefined) {
+        threadOptions.mode = options.mode;
+      }
+      this.startReceiveThread(threadOptions);
+    } else if (options.mode !== undefined && options.mode !== running.mode) {
+      throw new CanDeviceError(
+        ErrorCode.INVALID_PARAMETER,
+        `通道 ${this.channelIndex} 接收线程已以${running.mode}方式运行`
+      );
+    }
+
+    const ringCapacity = Math.max(1, options.highWaterMark ?? FRAME_STREAM_DEFAULT_CAPACITY);
+    const dropPolicy = options.dropPolicy ?? 'dropOldest';
+    let stream: ZlgFrameStream | null = null;
+    const streamId = this.device.openReceiveStream(
+      this.handle,
+      { capacity: ringCapacity, dropPolicy },
+      () => stream?.notify()
+    );
+    if (streamId === null) {
+      throw new CanDeviceError(
+        ErrorCode.BUS_ERROR,
+        `通道 ${this.channelIndex} 接收线程未运行`
+      );
+    }
+    stream = new ZlgFrameStream(this.device, this.handle, streamId, options.batchSize ?? 256, ringCapacity, dropPolicy);
+    return stream;
+  }
+
+  async udsRequest(request: IUdsRequest): Promise<IUdsResponse> {
+    const response = await this.device.udsRequestAsync({
+      channel: this.channelIndex,
+      srcAddr: request.srcAddr,
+      dstAddr: request.dstAddr,
+      sid: request.sid,
+      data: request.data,
+      frameType: this.isFD ? zlgcan.UdsFrameType.CANFD : zlgcan.UdsFrameType.CAN,
+      suppressResponse: request.suppressResponse,
+      timeoutMs: request.timeoutMs,
+      enhancedTimeoutMs: request.enhancedTimeoutMs,
+      transport: { extFrame: request.extFrame },
+    });
+
+    if (response.type === zlgcan.UdsResponseType.NONE && !request.suppressResponse) {
+      throw new CanDeviceError(
+        response.status === zlgcan.UdsError.TIMEOUT ? ErrorCode.RECEIVE_TIMEOUT : ErrorCode.TRANSMIT_FAILED,
+        `通道 ${this.channelIndex} 诊断请求 0x${request.sid.toString(16)} 失败 (状态 0x${response.status.toString(16)})`
+      );
+    }
+
+    return {
+      positive: response.type === zlgcan.UdsResponseType.POSITIVE,
+      sid: response.sid,
+      negativeCode: response.negativeCode,
+      data: response.data,
+      queuedUs: response.timing.queuedUs,
+      requestUs: response.timing.requestUs,
+    };
+  }
+
   async close(): Promise<void> {
     // ZLG通道句柄在设备关闭时自动释放
+    this.stopHealthMonitor();
     this._isRunning = false;
   }
 }
 
+/**
+ * ZLG接收帧流
+ * 只在消费方需要数据时（_read）从自己的原生缓冲取帧，缓冲为空时登记一次就绪通知而不轮询。
+ * JS侧只保留一批，积压全部留在容量固定的原生缓冲中。
+ */
+class ZlgFrameStream extends Readable implements IFrameStream {
+  private waiting = false;
+  private ended = false;
+  private droppedSeen = 0;
+
+  constructor(
+    private readonly device: zlgcan.ZlgCanDevice,
+    private readonly handle: zlgcan.ChannelHandle,
+    private readonly streamId: number,
+    private readonly batchSize: number,
+    public readonly ringCapacity: number,
+    public readonly dropPolicy: RingDropPolicy
+  ) {
+    super({ objectMode: true, highWaterMark: 1 });
+  }
+
+  /** 原生缓冲就绪通知（也在接收线程停止时调用） */
+  notify(): void {
+    if (this.waiting) {
+      this.waiting = false;
+      this.drain();
+    }
+  }
+
+  _read(): void {
+    this.waiting = false;
+    this.drain();
+  }
+
+  _destroy(error: Error | null, callback: (error?: Error | null) => void): void {
+    this.ended = true;
+    this.device.closeReceiveStream(this.handle, this.streamId);
+    callback(error);
+  }
+
+  private drain(): void {
+    while (!this.ended) {
+      const read = this.device.readReceiveStream(this.handle, this.streamId, this.batchSize);
+      if (!read) {
+        // 接收线程已停止（通道关闭或设备断开）
+        this.ended = true;
+        this.push(null);
+        return;
+      }
+
+      if (read.frames.length === 0 && read.fdFrames.length === 0) {
+        // 登记期间有帧到达时继续读取
+        if (!this.device.armReceiveStream(this.handle, this.streamId)) {
+          this.waiting = true;
+          return;
+        }
+        continue;
+      }
+
+      const dropped = read.dropped - this.droppedSeen;
+      this.droppedSeen = read.dropped;
+      if (dropped > 0) {
+        this.emit('drop', dropped);
+      }
+      const batch: IFrameBatch = {
+        frames: read.frames.map(f => ({ id: f.id, dlc: f.dlc, data: f.data, timestamp: f.timestamp })),
+        fdFrames: read.fdFrames.map(f => ({ id: f.id, length: f.len, data: f.data, flags: f.flags, timestamp: f.timestamp })),
+        dropped,
+      };
+      // 返回false表示消费方暂不需要数据，等下次_read
+      if (!this.push(batch)) {
+        return;
+      }
+    }
+  }
+}
+
 /**
  * ZLG CAN设备实现
  */
@@ -484,7 +1072,13 @@ class ZlgCanDevice implements ICanDevice {
       );
     }
 
-    const success = this.zlgDevice.openDevice(this._deviceType, deviceIndex, 0);
+    let success: boolean;
+    try {
+      success = await this.zlgDevice.openDeviceAsync(this._deviceType, deviceIndex, 0, DEVICE_OPEN_TIMEOUT_MS);
+    } catch {
+      // 超时
+      success = false;
+    }
     if (!success) {
       this._state = CanDeviceState.Error;
       return false;
@@ -528,7 +1122,15 @@ class ZlgCanDevice implements ICanDevice {
     }
 
     // 初始化通道
-    const handle = this.zlgDevice.initCanChannel(channelIndex, zlgConfig);
+    let handle: zlgcan.ChannelHandle;
+    try {
+      handle = await this.zlgDevice.initCanChannelAsync(channelIndex, zlgConfig, CHANNEL_OPERATION_TIMEOUT_MS);
+    } catch (error: any) {
+      throw new CanDeviceError(
+        ErrorCode.CHANNEL_INIT_FAILED,
+        `通道 ${channelIndex} 初始化失败: ${error.message}`
+      );
+    }
     if (handle === zlgcan.INVALID_CHANNEL_HANDLE) {
       throw new CanDeviceError(
         ErrorCode.CHANNEL_INIT_FAILED,
@@ -537,7 +1139,7 @@ class ZlgCanDevice implements ICanDevice {
     }
 
     // 创建通道对象
-    const channel = new ZlgCanChannel(channelIndex, handle, this.zlgDevice);
+    const channel = new ZlgCanChannel(channelIndex, handle, this.zlgDevice, config.protocolType === CanProtocolType.CANFD);
     this.channels.set(channelIndex, channel);
 
     return channel;
@@ -563,6 +1165,67 @@ class ZlgCanDevice implements ICanDevice {
     }
     return this.zlgDevice.isDeviceOnLine();
   }
+
+  async quiesce(timeoutMs: number): Promise<boolean> {
+    if (this._state !== CanDeviceState.Connected || this.channels.size === 0) {
+      return true;
+    }
+
+    const handles = [...this.channels.values()].map(channel => channel.handle);
+    try {
+      const result = await this.zlgDevice.quiesceAsync(handles, { timeoutMs });
+      return result.clean;
+    } catch (error: any) {
+      throw new CanDeviceError(
+        ErrorCode.BUS_ERROR,
+        `通道静默失败: ${error.message}`
+      );
+    }
+  }
+
+  startHotplugMonitor(callback: (event: IDeviceHotplugEvent) => void): void {
+    if (this._state !== CanDeviceState.Connected) {
+      throw new CanDeviceError(
+        ErrorCode.DEVICE_NOT_OPEN,
+        '设备未打开，无法启动热插拔监视'
+      );
+    }
+
+    // 通道句柄由原生层在重连后自动映射，通道对象无需更新
+    this.zlgDevice.startDeviceMonitor({}, (event) => {
+      callback({
+        type: event.type,
+        timestamp: event.timestamp,
+        attempts: event.attempts,
+        replayFailures: event.replayFailures,
+        reconnectUs: event.reconnectUs,
+      });
+    });
+  }
+
+  stopHotplugMonitor(): void {
+    this.zlgDevice.stopDeviceMonitor();
+  }
+
+  startPipelineWatchdog(options: IPipelineWatchdogOptions, callback: (warning: IPipelineWarning) => void): void {
+    if (this._state !== CanDeviceState.Connected) {
+      throw new CanDeviceError(
+        ErrorCode.DEVICE_NOT_OPEN,
+        '设备未打开，无法启动接收链路监视'
+      );
+    }
+
+    // 新初始化的通道和接收线程由原生层自动纳入采样
+    this.zlgDevice.startPipelineWatchdog(options, callback);
+  }
+
+  stopPipelineWatchdog(): void {
+    this.zlgDevice.stopPipelineWatchdog();
+  }
+
+  getPipelineHistory(sinceTimestamp?: number): IPipelineSample[] {
+    return this.zlgDevice.getPipelineHistory(sinceTimestamp) ?? [];
+  }
 }
 
 /**
@@ -595,6 +1258,23 @@ export class ZlgCanDriver implements ICanDriver {
   dispose(): void {
     // 释放驱动资源（如果需要）
   }
+
+  /**
+   * 设置原生线程（接收、周期发送、监视）的优先级和CPU绑定，进程内所有设备共用
+   * 权限不足时降级而不抛出异常，实际结果见返回值
+   * @param role 线程角色
+   * @param policy 调度策略
+   */
+  configureThreadScheduling(role: zlgcan.ThreadRole, policy: zlgcan.ThreadSchedulingPolicy): zlgcan.ThreadSchedulingState {
+    return zlgcan.ZlgCanDevice.setThreadScheduling(role, policy);
+  }
+
+  /**
+   * 获取各类原生线程的调度生效情况和唤醒延迟
+   */
+  getThreadScheduling(): Record<zlgcan.ThreadRole, zlgcan.ThreadSchedulingState> {
+    return zlgcan.ZlgCanDevice.getThreadScheduling();
+  }
 }
 
 // ============== 设备管理器 ==============
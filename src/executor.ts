@@ -40,9 +40,18 @@ import {
   IReceivedFDFrame,
   CanProtocolType,
   CanDeviceState,
+  CanBusState,
+  IChannelHealthEvent,
+  IDeviceHotplugEvent,
+  IPipelineWarning,
+  IPipelineSample,
+  IReceiveThreadStats,
+  ReceiveMode,
   CanDeviceManager,
   ZlgCanDriver,
 } from "./devices";
+import { TraceRecorder } from "./traceRecorder";
+import { ThreadRole, ThreadSchedulingPolicy, ThreadSchedulingState } from "./zlgcan";
 
 /** 发送任务 */
 interface SendTask {
@@ -140,6 +149,23 @@ export interface ChannelInfo {
   running: boolean;
 }
 
+/** 接收链路告警（附带项目通道索引） */
+export interface PipelineWarningEvent extends IPipelineWarning {
+  projectChannelIndex?: number;
+}
+
+/** 接收链路采样点（各通道附带项目通道索引） */
+export interface PipelineSampleInfo extends IPipelineSample {
+  channels: (IPipelineSample["channels"][number] & { projectChannelIndex?: number })[];
+}
+
+/** 通道接收线程统计（附带项目通道索引） */
+export interface ReceiveThreadInfo extends IReceiveThreadStats {
+  projectChannelIndex: number;
+  /** 距上次查询期间的CPU占用(%)，首次查询为启动以来的平均值 */
+  cpuPercent: number;
+}
+
 /**
  * Tester脚本执行器
  */
@@ -162,6 +188,10 @@ export class TesterExecutor {
   private deviceInitialized: boolean = false;
   private currentConfigHash: string = "";
 
+  // 设备会话：运行结束后保持设备打开，空闲超时后关闭
+  private sessionIdleTimer: ReturnType<typeof globalThis.setTimeout> | null = null;
+  private readonly SESSION_IDLE_TIMEOUT_MS = 5 * 60 * 1000; // 设备会话空闲超时(ms)
+
   // 程序定义（枚举和位域函数）
   private enums: Map<string, EnumDefinition> = new Map();
   private bitFieldFunctions: Map<string, BitFieldFunction> = new Map();
@@ -183,12 +213,21 @@ export class TesterExecutor {
   private _onMessageSent: vscode.EventEmitter<SentCanMessage> = new vscode.EventEmitter<SentCanMessage>();
   public readonly onMessageSent: vscode.Event<SentCanMessage> = this._onMessageSent.event;
 
+  // 接收链路告警事件
+  private _onPipelineWarning: vscode.EventEmitter<PipelineWarningEvent> = new vscode.EventEmitter<PipelineWarningEvent>();
+  public readonly onPipelineWarning: vscode.Event<PipelineWarningEvent> = this._onPipelineWarning.event;
+
   // 报文接收轮询
   private receivePollingTimer: ReturnType<typeof globalThis.setInterval> | null = null;
-  private readonly RECEIVE_POLLING_INTERVAL_MS = 10; // 接收轮询间隔(ms)
+  private readonly RECEIVE_POLLING_INTERVAL_MS = 10; // 接收轮询间隔(ms)；tester.receiveMode启用接收线程时只取其缓存
+  private receiveCpuSamples: Map<number, { uptimeUs: number; cpuTimeUs: number }> = new Map();
   private receiveErrorCount = 0; // 接收错误计数
   private readonly MAX_RECEIVE_ERROR_LOGS = 5; // 最大错误日志次数
   private readonly CAN_DATA_MAX_BYTES = 8; // CAN 标准数据最大字节数
+  private readonly QUIESCE_TIMEOUT_MS = 100; // 切换测试用例时等待总线静默的上限(ms)
+
+  // 时间线记录
+  private tracer: TraceRecorder = TraceRecorder.getInstance();
 
   constructor() {
     this.outputChannel = vscode.window.createOutputChannel("Tester 执行器");
@@ -361,7 +400,7 @@ export class TesterExecutor {
   }
 
   /**
-   * 关闭设备（公共方法）
+   * 关闭设备（公共方法），保留的设备会话随之失效
    */
   public closeDeviceManually(): void {
     this.stopAllTasks(true);
@@ -430,6 +469,71 @@ export class TesterExecutor {
     }
   }
 
+  /**
+   * 结束一次运行：停止发送任务，设备保持打开，空闲超时后自动关闭
+   * 配置不变时下次运行只需清空缓冲区即可复用
+   */
+  private releaseDeviceSession(): void {
+    this.stopAllTasks();
+    this.armSessionIdleTimer();
+    this.setState("idle");
+  }
+
+  /**
+   * 启动设备会话空闲计时，超时后关闭设备
+   * 仍有发送任务运行时会话不算空闲，重新计时
+   */
+  private armSessionIdleTimer(): void {
+    this.clearSessionIdleTimer();
+
+    if (this.deviceInitialized && this.device) {
+      this.sessionIdleTimer = globalThis.setTimeout(() => {
+        this.sessionIdleTimer = null;
+        if (this.sendTasks.size > 0) {
+          this.armSessionIdleTimer();
+          return;
+        }
+        this.log("设备空闲超时，自动关闭");
+        this.stopAllTasks(true);
+      }, this.SESSION_IDLE_TIMEOUT_MS);
+    }
+  }
+
+  /**
+   * 取消设备会话空闲计时
+   */
+  private clearSessionIdleTimer(): void {
+    if (this.sessionIdleTimer) {
+      globalThis.clearTimeout(this.sessionIdleTimer);
+      this.sessionIdleTimer = null;
+    }
+  }
+
+  /**
+   * 静默所有通道：取消设备端周期发送，等待发送队列排空并清空接收缓冲区
+   * 期间暂停接收轮询，避免上一个用例的残留报文被当作本用例的接收
+   */
+  private async quiesceChannels(): Promise<void> {
+    if (!this.device || !this.deviceInitialized) {
+      return;
+    }
+
+    const polling = this.receivePollingTimer !== null;
+    this.stopReceivePolling();
+    try {
+      const clean = await this.device.quiesce(this.QUIESCE_TIMEOUT_MS);
+      if (!clean) {
+        this.log(`    发送队列在${this.QUIESCE_TIMEOUT_MS}ms内未排空`);
+      }
+    } catch (error: any) {
+      this.logError(error.message);
+    } finally {
+      if (polling && this.deviceInitialized) {
+        this.startReceivePolling();
+      }
+    }
+  }
+
   /**
    * 启动报文接收轮询
    */
@@ -467,6 +571,7 @@ export class TesterExecutor {
     // 遍历所有通道接收报文
     for (const [projectChannelIndex, channel] of this.channels) {
       try {
+        const pollStart = this.tracer.now();
         const isFD = this.isCanFD.get(projectChannelIndex) || false;
         const frames = isFD
           ? await channel.receiveFD(100, 0) // 非阻塞接收
@@ -483,6 +588,7 @@ export class TesterExecutor {
               isFD,
             });
           }
+          this.tracer.span("poll", "executor", pollStart, { channel: projectChannelIndex, frames: frames.length });
         }
       } catch (error: any) {
         // 接收错误处理：仅记录前几次错误，避免频繁输出
@@ -539,6 +645,7 @@ export class TesterExecutor {
    * 发送单帧
    */
   private sendSingleFrame(channel: ICanChannel, task: SendTask, isFD: boolean): boolean {
+    const sendStart = this.tracer.now();
     try {
       if (isFD) {
         const frame: ICanFDFrame = {
@@ -574,6 +681,7 @@ export class TesterExecutor {
       });
 
       task.remainingCount--;
+      this.tracer.span("tcans.send", "executor", sendStart, { task: task.id, id: task.messageId });
       return true;
     } catch (error: any) {
       this.logError(`发送帧失败: ${error.message}`);
@@ -597,6 +705,7 @@ export class TesterExecutor {
     this.log("========================================\n");
 
     const startTime = Date.now();
+    const traceStart = this.tracer.now();
     const result: AllTestsResult = {
       suiteResults: [],
       totalPassed: 0,
@@ -651,11 +760,12 @@ export class TesterExecutor {
         result.totalFailed += suiteResult.failed;
       }
     } finally {
-      // 停止所有发送任务并关闭设备
-      this.stopAllTasks(true);
+      // 停止所有发送任务，保留设备供下次运行复用
+      this.releaseDeviceSession();
     }
 
     result.duration = Date.now() - startTime;
+    this.tracer.span("runAllTests", "executor", traceStart, { passed: result.totalPassed, failed: result.totalFailed });
 
     this.log("\n========================================");
     this.log("测试执行完成");
@@ -745,8 +855,8 @@ export class TesterExecutor {
     try {
       result = await this.executeTestSuite(suite);
     } finally {
-      // 停止所有发送任务并关闭设备
-      this.stopAllTasks(true);
+      // 停止所有发送任务，保留设备供下次运行复用
+      this.releaseDeviceSession();
     }
 
     this.log("\n========================================");
@@ -829,7 +939,13 @@ export class TesterExecutor {
 
     this.setState("running");
 
-    const result = await this.executeTestCase(testCase, false);
+    let result: TestCaseResult;
+    try {
+      result = await this.executeTestCase(testCase, false);
+    } finally {
+      // 发送任务保持运行，设备会话在任务停止且空闲超时后关闭
+      this.armSessionIdleTimer();
+    }
 
     this.log("\n========================================");
     this.log(`测试用例 "${caseName}" 执行完成`);
@@ -866,15 +982,24 @@ export class TesterExecutor {
 
   /**
    * 初始化CAN设备（不支持模拟模式）
-   * 如果设备已初始化且配置相同，则复用现有设备
+   * 如果设备已初始化且配置（设备类型、设备索引、通道配置）相同，则复用现有设备
    */
   private async initializeDevice(config: ConfigurationBlock): Promise<ExecutionResult> {
     const configHash = this.getConfigHash(config);
 
-    // 如果设备已初始化且配置相同，直接返回成功
+    // 如果设备已初始化且配置相同，清空缓冲区后直接复用
     if (this.deviceInitialized && this.device && this.currentConfigHash === configHash) {
-      this.log("复用已初始化的CAN设备\n");
-      return { success: true, message: "设备已就绪" };
+      this.clearSessionIdleTimer();
+      const reuseStartTime = Date.now();
+      try {
+        await Promise.all([...this.channels.values()].map((channel) => channel.clearBuffer()));
+        this.log(`复用已初始化的CAN设备 (清空缓冲区 ${Date.now() - reuseStartTime}ms)\n`);
+        return { success: true, message: "设备已就绪" };
+      } catch (error: any) {
+        // 设备状态异常时不再复用，重新初始化
+        this.logError(`复用设备失败: ${error.message}，重新初始化设备...`);
+        this.closeDevice();
+      }
     }
 
     // 如果设备已打开但配置不同，先关闭
@@ -896,6 +1021,7 @@ export class TesterExecutor {
         await this.zlgDriver.initialize();
         this.deviceManager.registerDriver(this.zlgDriver);
       }
+      this.applyThreadScheduling(this.zlgDriver);
 
       // 按设备分组初始化
       const deviceGroups = new Map<string, ChannelConfig[]>();
@@ -924,6 +1050,7 @@ export class TesterExecutor {
         }
 
         // 打开设备
+        const openStartTime = Date.now();
         const opened = await this.device.open(firstChannel.deviceIndex);
         if (!opened) {
           return {
@@ -931,9 +1058,18 @@ export class TesterExecutor {
             message: `无法打开设备 ${firstChannel.deviceId}-${firstChannel.deviceIndex}`,
           };
         }
+        this.log(`    打开耗时: ${Date.now() - openStartTime}ms`);
+
+        // USB掉线后自动重连，通道配置由驱动回放
+        this.startHotplugMonitor(this.device, firstChannel.deviceId, firstChannel.deviceIndex);
 
-        // 初始化每个通道
-        for (const channelCfg of channelList) {
+        // 事件循环阻塞时接收缓冲会积压，在丢帧前告警
+        this.startPipelineWatchdog(this.device);
+
+        // 各通道相互独立，并行初始化和启动，总耗时取决于最慢的通道
+        const device = this.device;
+        const bringUpStartTime = Date.now();
+        const bringUpResults = await Promise.all(channelList.map(async (channelCfg) => {
           const isFD = channelCfg.dataBaudrate !== undefined;
           this.isCanFD.set(channelCfg.projectChannelIndex, isFD);
           this.channelIndexMap.set(channelCfg.projectChannelIndex, channelCfg.channelIndex);
@@ -951,21 +1087,41 @@ export class TesterExecutor {
 
           try {
             // 初始化通道
-            const channel = await this.device.initChannel(channelCfg.channelIndex, channelConfig);
+            const initStartTime = Date.now();
+            const channel = await device.initChannel(channelCfg.channelIndex, channelConfig);
+            const initMs = Date.now() - initStartTime;
 
             // 启动通道
+            const startStartTime = Date.now();
             await channel.start();
+            const startMs = Date.now() - startStartTime;
 
-            this.channels.set(channelCfg.projectChannelIndex, channel);
+            return { channelCfg, channel, initMs, startMs, error: null };
           } catch (error: any) {
-            // 通道初始化失败，关闭设备后返回错误
-            this.closeDevice();
-            return {
-              success: false,
-              message: `初始化通道 ${channelCfg.channelIndex} 失败: ${error.message}`,
-            };
+            return { channelCfg, channel: null, initMs: 0, startMs: 0, error };
           }
+        }));
+
+        const failed = bringUpResults.find((result) => result.error !== null);
+        if (failed) {
+          // 通道初始化失败，关闭设备后返回错误
+          this.closeDevice();
+          return {
+            success: false,
+            message: `初始化通道 ${failed.channelCfg.channelIndex} 失败: ${failed.error.message}`,
+          };
+        }
+
+        for (const { channelCfg, channel, initMs, startMs } of bringUpResults) {
+          this.log(`    项目通道${channelCfg.projectChannelIndex}: 初始化 ${initMs}ms, 启动 ${startMs}ms`);
+
+          // 监视总线状态，总线关闭时自动恢复
+          this.startChannelHealthMonitor(channelCfg.projectChannelIndex, channel!);
+          this.startReceiveThread(channelCfg.projectChannelIndex, channel!);
+
+          this.channels.set(channelCfg.projectChannelIndex, channel!);
         }
+        this.log(`    通道就绪耗时: ${Date.now() - bringUpStartTime}ms (${channelList.length}个通道并行)`);
       }
 
       this.deviceInitialized = true;
@@ -986,10 +1142,210 @@ export class TesterExecutor {
     }
   }
 
+  /**
+   * 启动通道健康监视
+   * 总线状态变化和恢复结果写入输出，监视失败不影响测试执行
+   */
+  private startChannelHealthMonitor(projectChannelIndex: number, channel: ICanChannel): void {
+    try {
+      channel.startHealthMonitor({ autoRecover: true }, (event: IChannelHealthEvent) => {
+        if (event.type === "stateChange") {
+          // 首次采样为主动错误时不输出
+          if (event.previousState === CanBusState.Unknown && event.state === CanBusState.Active) {
+            return;
+          }
+          const message = `通道${projectChannelIndex} 总线状态: ${event.previousState} -> ${event.state} (REC=${event.rxErrCount}, TEC=${event.txErrCount})`;
+          if (event.state === CanBusState.BusOff) {
+            this.logError(message);
+          } else {
+            this.log(message);
+          }
+        } else if (event.type === "recoveryAttempt") {
+          this.log(`通道${projectChannelIndex} 第${event.attempt}次总线恢复${event.success ? "" : "失败"}`);
+        } else {
+          this.log(`通道${projectChannelIndex} 总线已恢复，耗时 ${(event.latencyUs / 1000).toFixed(1)}ms`);
+        }
+      });
+    } catch (error: any) {
+      this.logError(`通道${projectChannelIndex} 健康监视启动失败: ${error.message}`);
+    }
+  }
+
+  /**
+   * 按tester.receiveMode启动通道的驱动接收线程
+   * polling（默认）不启动线程；启动失败时接收轮询直接读取驱动缓冲区，不影响测试执行
+   */
+  private startReceiveThread(projectChannelIndex: number, channel: ICanChannel): void {
+    const mode = vscode.workspace.getConfiguration("tester").get<ReceiveMode | "polling">("receiveMode", "polling");
+    if (mode === "polling") {
+      return;
+    }
+    try {
+      channel.startReceiveThread({ mode });
+      this.log(`    项目通道${projectChannelIndex}: 接收方式 ${mode}`);
+    } catch (error: any) {
+      this.logError(`项目通道${projectChannelIndex} ${error.message}，改为直接轮询驱动`);
+    }
+  }
+
+  /**
+   * 获取各通道接收线程的CPU占用与取帧延迟，未启动接收线程的通道不返回
+   */
+  public getReceiveThreadStats(): ReceiveThreadInfo[] {
+    if (!this.deviceInitialized) {
+      return [];
+    }
+    const result: ReceiveThreadInfo[] = [];
+    for (const [projectChannelIndex, channel] of this.channels) {
+      let stats: IReceiveThreadStats | null = null;
+      try {
+        stats = channel.getReceiveThreadStats();
+      } catch {
+        stats = null;
+      }
+      if (!stats) {
+        continue;
+      }
+      // 线程重启后运行时长变小，退回启动以来的平均值
+      const previous = this.receiveCpuSamples.get(projectChannelIndex);
+      const interval = previous && stats.uptimeUs > previous.uptimeUs && stats.cpuTimeUs >= previous.cpuTimeUs
+        ? { uptimeUs: stats.uptimeUs - previous.uptimeUs, cpuTimeUs: stats.cpuTimeUs - previous.cpuTimeUs }
+        : stats;
+      this.receiveCpuSamples.set(projectChannelIndex, { uptimeUs: stats.uptimeUs, cpuTimeUs: stats.cpuTimeUs });
+      result.push({
+        ...stats,
+        projectChannelIndex,
+        cpuPercent: interval.uptimeUs > 0 ? (interval.cpuTimeUs / interval.uptimeUs) * 100 : 0,
+      });
+    }
+    return result;
+  }
+
+  /**
+   * 启动设备热插拔监视
+   */
+  private startHotplugMonitor(device: ICanDevice, deviceId: number, deviceIndex: number): void {
+    try {
+      device.startHotplugMonitor((event: IDeviceHotplugEvent) => {
+        if (event.type === "offline") {
+          this.logError(`设备 ${deviceId}-${deviceIndex} 已离线，正在重连...`);
+        } else if (event.replayFailures > 0) {
+          this.logError(`设备 ${deviceId}-${deviceIndex} 已重连 (耗时 ${(event.reconnectUs / 1000).toFixed(1)}ms)，${event.replayFailures}项配置恢复失败`);
+        } else {
+          this.log(`设备 ${deviceId}-${deviceIndex} 已重连，耗时 ${(event.reconnectUs / 1000).toFixed(1)}ms`);
+        }
+      });
+    } catch (error: any) {
+      this.logError(`设备热插拔监视启动失败: ${error.message}`);
+    }
+  }
+
+  /**
+   * 按tester.threadScheduling配置设置原生线程调度
+   * 未配置的角色保持系统默认；权限不足时驱动自动降级，此处只记录结果
+   */
+  private applyThreadScheduling(driver: ZlgCanDriver): void {
+    const config = vscode.workspace.getConfiguration("tester")
+      .get<Partial<Record<ThreadRole, ThreadSchedulingPolicy>>>("threadScheduling", {});
+    for (const role of ["receive", "transmit", "monitor"] as ThreadRole[]) {
+      const policy = config[role];
+      if (!policy) {
+        continue;
+      }
+      try {
+        const state = driver.configureThreadScheduling(role, policy);
+        const cpus = policy.cpus && policy.cpus.length > 0 ? `CPU ${policy.cpus.join(",")}` : "不绑定CPU";
+        this.log(`  线程调度 ${role}: ${policy.realtime ? "实时优先级" : "普通优先级"}, ${cpus}`);
+        if (state.error) {
+          this.logError(`  线程调度 ${role}: ${state.error}${state.fallback ? `，已降级为${state.fallback}` : ""}`);
+        }
+      } catch (error: any) {
+        this.logError(`线程调度 ${role} 设置失败: ${error.message}`);
+      }
+    }
+  }
+
+  /**
+   * 获取原生线程调度生效情况和唤醒延迟，驱动未加载时返回null
+   */
+  public getThreadScheduling(): Record<ThreadRole, ThreadSchedulingState> | null {
+    if (!this.zlgDriver) {
+      return null;
+    }
+    try {
+      return this.zlgDriver.getThreadScheduling();
+    } catch {
+      return null;
+    }
+  }
+
+  /**
+   * 启动接收链路监视
+   * 告警写入输出并转发给设备状态视图，监视失败不影响测试执行
+   */
+  private startPipelineWatchdog(device: ICanDevice): void {
+    try {
+      device.startPipelineWatchdog({}, (warning: IPipelineWarning) => {
+        const projectIndex = warning.channelIndex === undefined ? undefined : this.toProjectChannelIndex(warning.channelIndex);
+        const channelLabel = projectIndex === undefined ? "" : `通道${projectIndex} `;
+        switch (warning.type) {
+          case "eventLoopLag":
+            this.logError(`事件循环阻塞 ${warning.value.toFixed(0)}ms，接收可能积压`);
+            break;
+          case "ringFilling":
+            this.logError(`${channelLabel}接收缓冲占用 ${(warning.value * 100).toFixed(0)}%` +
+              (warning.etaMs >= 0 ? `，预计 ${warning.etaMs.toFixed(0)}ms 后写满` : "") +
+              ` (事件循环延迟 ${warning.lagMs.toFixed(0)}ms)`);
+            break;
+          case "vendorQueue":
+            this.logError(`${channelLabel}驱动接收缓冲积压 ${warning.value} 帧 (事件循环延迟 ${warning.lagMs.toFixed(0)}ms)`);
+            break;
+          default:
+            this.logError(`${channelLabel}接收缓冲丢弃 ${warning.value} 帧 (事件循环延迟 ${warning.lagMs.toFixed(0)}ms)`);
+            break;
+        }
+        this._onPipelineWarning.fire({ ...warning, projectChannelIndex: projectIndex });
+      });
+    } catch (error: any) {
+      this.logError(`接收链路监视启动失败: ${error.message}`);
+    }
+  }
+
+  /**
+   * 获取接收链路采样序列，通道附带项目通道索引
+   * @param sinceTimestamp 只返回晚于该时间的采样点
+   */
+  public getPipelineHistory(sinceTimestamp?: number): PipelineSampleInfo[] {
+    if (!this.deviceInitialized || !this.device) {
+      return [];
+    }
+    return this.device.getPipelineHistory(sinceTimestamp).map((sample) => ({
+      ...sample,
+      channels: sample.channels.map((channel) => ({
+        ...channel,
+        projectChannelIndex: this.toProjectChannelIndex(channel.channelIndex),
+      })),
+    }));
+  }
+
+  /**
+   * 设备通道索引转换为项目通道索引，未映射时返回undefined
+   */
+  private toProjectChannelIndex(deviceChannelIndex: number): number | undefined {
+    for (const [projectIndex, deviceIndex] of this.channelIndexMap) {
+      if (deviceIndex === deviceChannelIndex) {
+        return projectIndex;
+      }
+    }
+    return undefined;
+  }
+
   /**
    * 关闭CAN设备
    */
   private closeDevice(): void {
+    this.clearSessionIdleTimer();
+
     // 停止报文接收轮询
     this.stopReceivePolling();
 
@@ -1003,6 +1359,7 @@ export class TesterExecutor {
       this.device = null;
     }
     this.channels.clear();
+    this.receiveCpuSamples.clear();
     this.deviceInitialized = false;
     this.currentConfigHash = "";
   }
@@ -1014,6 +1371,7 @@ export class TesterExecutor {
    */
   private async executeTestSuite(suite: TestSuite): Promise<TestSuiteResult> {
     const startTime = Date.now();
+    const traceStart = this.tracer.now();
     this.log(`\n>>> 测试用例集: ${suite.name}`);
     this.log("-".repeat(40));
 
@@ -1039,6 +1397,7 @@ export class TesterExecutor {
     }
 
     result.duration = Date.now() - startTime;
+    this.tracer.span(suite.name, "suite", traceStart, { passed: result.passed, failed: result.failed });
     this.log(`<<< 用例集完成: 通过=${result.passed}, 失败=${result.failed}, 耗时=${result.duration}ms\n`);
     return result;
   }
@@ -1050,12 +1409,16 @@ export class TesterExecutor {
    */
   private async executeTestCase(testCase: TestCase, stopPrevious: boolean = true): Promise<TestCaseResult> {
     const startTime = Date.now();
+    const traceStart = this.tracer.now();
     const seqStr = testCase.sequenceNumber !== undefined ? `[${testCase.sequenceNumber}] ` : "";
     this.log(`\n  ${seqStr}${testCase.name}`);
 
-    // 切换测试用例时停止之前的发送任务
+    // 切换测试用例时停止之前的发送任务，并清除残留报文
     if (stopPrevious) {
       this.stopAllTasks();
+      const quiesceStart = this.tracer.now();
+      await this.quiesceChannels();
+      this.tracer.span("quiesce", "executor", quiesceStart);
     }
     this.setState("running");
 
@@ -1084,6 +1447,7 @@ export class TesterExecutor {
     }
 
     result.duration = Date.now() - startTime;
+    this.tracer.span(testCase.name, "testcase", traceStart, { success: result.success });
     this.log(`    结果: ${result.success ? "PASS" : "FAIL"} (${result.duration}ms)`);
     return result;
   }
@@ -1092,6 +1456,16 @@ export class TesterExecutor {
    * 执行单个命令
    */
   private async executeCommand(command: TestCommand): Promise<CommandResult> {
+    const traceStart = this.tracer.now();
+    const result = await this.dispatchCommand(command);
+    this.tracer.span(command.type, "command", traceStart, { line: result.line + 1, success: result.success });
+    return result;
+  }
+
+  /**
+   * 按命令类型分派执行
+   */
+  private async dispatchCommand(command: TestCommand): Promise<CommandResult> {
     switch (command.type) {
       case "tcans":
         return await this.executeTcans(command);
@@ -1581,6 +1955,7 @@ export class TesterExecutor {
 
     // 清理事件发射器
     this._onStateChange.dispose();
+    this._onPipelineWarning.dispose();
     this._onMessageReceived.dispose();
     this._onMessageSent.dispose();
 
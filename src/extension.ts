@@ -15,6 +15,7 @@ import { TesterDefinitionProvider } from "./definitionProvider";
 import { TesterReferenceProvider } from "./referenceProvider";
 import { TesterRenameProvider } from "./renameProvider";
 import { CanDeviceManager } from "./devices";
+import { TraceRecorder } from "./traceRecorder";
 
 // 全局诊断集合
 let diagnosticCollection: vscode.DiagnosticCollection;
@@ -288,6 +289,37 @@ export function activate(context: vscode.ExtensionContext) {
     statusBar.setRunning(state === 'running');
   });
 
+  // 接收链路：告警立即转发，采样序列、线程调度状态和接收线程统计在设备视图可见时增量推送
+  executor.onPipelineWarning((warning) => deviceStatusProvider.showPipelineWarning(warning));
+  let pipelineSince = 0;
+  let pipelineShown = false;
+  const pipelineTimer = setInterval(() => {
+    if (!deviceStatusProvider.visible) {
+      // 视图隐藏后webview内容被销毁，重新显示时推送完整序列
+      pipelineShown = false;
+      return;
+    }
+    const reset = !pipelineShown;
+    if (reset) {
+      pipelineSince = 0;
+      pipelineShown = true;
+    }
+    const scheduling = executor.getThreadScheduling();
+    if (scheduling) {
+      deviceStatusProvider.updateThreadScheduling(scheduling);
+    }
+    deviceStatusProvider.updateReceiveThreads(executor.getReceiveThreadStats());
+    const samples = executor.getPipelineHistory(pipelineSince);
+    if (samples.length > 0) {
+      pipelineSince = samples[samples.length - 1].timestamp;
+      deviceStatusProvider.updatePipeline(samples, reset);
+    } else if (reset || (pipelineSince !== 0 && !executor.getDeviceInfo().connected)) {
+      pipelineSince = 0;
+      deviceStatusProvider.updatePipeline([], true);
+    }
+  }, 1000);
+  context.subscriptions.push({ dispose: () => clearInterval(pipelineTimer) });
+
   // 辅助函数：更新设备状态视图
   const updateDeviceStatus = () => {
     const deviceInfo = executor.getDeviceInfo();
@@ -499,6 +531,56 @@ export function activate(context: vscode.ExtensionContext) {
     )
   );
 
+  // 注册开始记录时间线命令
+  context.subscriptions.push(
+    vscode.commands.registerCommand(
+      "tester.startTrace",
+      () => {
+        TraceRecorder.getInstance().start();
+        vscode.window.showInformationMessage('已开始记录时间线，运行测试后执行"导出时间线"');
+      }
+    )
+  );
+
+  // 注册导出时间线命令（停止记录并保存为Chrome trace JSON）
+  context.subscriptions.push(
+    vscode.commands.registerCommand(
+      "tester.exportTrace",
+      async () => {
+        const tracer = TraceRecorder.getInstance();
+        if (!tracer.isEnabled) {
+          vscode.window.showWarningMessage('尚未开始记录时间线');
+          return;
+        }
+        tracer.stop();
+
+        const target = await vscode.window.showSaveDialog({
+          defaultUri: vscode.Uri.file(`tester-trace-${Date.now()}.json`),
+          filters: { 'Chrome Trace': ['json'] },
+        });
+        if (!target) {
+          return;
+        }
+
+        try {
+          const result = tracer.exportChromeTrace(target.fsPath);
+          const notes: string[] = [];
+          if (result.overwritten > 0) {
+            notes.push(`${result.overwritten} 个较早的事件已被覆盖`);
+          }
+          if (!result.nativeAvailable) {
+            notes.push('原生层时间线不可用');
+          }
+          const suffix = notes.length > 0 ? ` (${notes.join('，')})` : '';
+          vscode.window.showInformationMessage(`已导出 ${result.events} 个事件，可在 chrome://tracing 或 ui.perfetto.dev 中打开${suffix}`);
+        } catch (error) {
+          const errorMessage = error instanceof Error ? error.message : String(error);
+          vscode.window.showErrorMessage(`导出时间线失败: ${errorMessage}`);
+        }
+      }
+    )
+  );
+
   // 监听手动发送请求
   manualSendProvider.onSendMessage(async (request: { channel: number; id: number; data: number[]; isFD: boolean }) => {
     const result = await executor.manualSendMessage(
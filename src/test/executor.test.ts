@@ -0,0 +1,115 @@
+import * as assert from "assert";
+import * as fs from "fs";
+import * as os from "os";
+import * as path from "path";
+import * as vscode from "vscode";
+import { TesterExecutor } from "../executor";
+
+/**
+ * 执行器设备会话测试
+ * 设备初始化、解析和用例执行以桩替换，只验证运行结束后的会话空闲计时
+ */
+
+const IDLE_TIMEOUT_MS = 50;
+
+function sleep(ms: number): Promise<void> {
+  return new Promise((resolve) => globalThis.setTimeout(resolve, ms));
+}
+
+interface StubbedExecutor {
+  executor: TesterExecutor;
+  closed: () => boolean;
+}
+
+function createStubbedExecutor(): StubbedExecutor {
+  const executor = new TesterExecutor();
+  const internal = executor as any;
+  let closed = false;
+
+  internal.SESSION_IDLE_TIMEOUT_MS = IDLE_TIMEOUT_MS;
+  internal.parser = {
+    parse: () => ({ program: null, errors: [] }),
+    parseTestCaseAtLine: () => ({
+      testCase: { name: "case", commands: [], startLine: 0, endLine: 0 },
+      configuration: { channels: [], diagnose: {}, startLine: 0, endLine: 0 },
+    }),
+  };
+  internal.initializeDevice = async () => {
+    internal.device = { close: () => { closed = true; } };
+    internal.deviceInitialized = true;
+    return { success: true, message: "设备已就绪" };
+  };
+  internal.executeTestCase = async () => ({ name: "case", success: true, commandResults: [], duration: 0 });
+
+  return { executor, closed: () => closed };
+}
+
+suite("TesterExecutor 设备会话", () => {
+  let documentUri: vscode.Uri;
+
+  suiteSetup(() => {
+    const file = path.join(os.tmpdir(), `tester-executor-${process.pid}.tester`);
+    fs.writeFileSync(file, "");
+    documentUri = vscode.Uri.file(file);
+  });
+
+  suiteTeardown(() => {
+    fs.rmSync(documentUri.fsPath, { force: true });
+  });
+
+  test("runTestCaseByLine 结束后启动空闲计时并在超时后关闭设备", async () => {
+    const { executor, closed } = createStubbedExecutor();
+
+    await executor.runTestCaseByLine(documentUri, 0, "case");
+    assert.notStrictEqual((executor as any).sessionIdleTimer, null);
+    assert.strictEqual(closed(), false);
+
+    await sleep(IDLE_TIMEOUT_MS * 4);
+    assert.strictEqual(closed(), true);
+    assert.strictEqual((executor as any).deviceInitialized, false);
+  });
+
+  test("发送任务运行期间空闲计时不关闭设备", async () => {
+    const { executor, closed } = createStubbedExecutor();
+
+    await executor.runTestCaseByLine(documentUri, 0, "case");
+    (executor as any).sendTasks.set(1, { timerId: null, isPaused: false });
+
+    await sleep(IDLE_TIMEOUT_MS * 4);
+    assert.strictEqual(closed(), false);
+    assert.notStrictEqual((executor as any).sessionIdleTimer, null);
+
+    (executor as any).sendTasks.clear();
+    await sleep(IDLE_TIMEOUT_MS * 4);
+    assert.strictEqual(closed(), true);
+  });
+});
+
+suite("TesterExecutor 接收方式", () => {
+  function createChannel(modes: string[]): unknown {
+    return {
+      startReceiveThread: (options: { mode: string }) => {
+        modes.push(options.mode);
+      },
+    };
+  }
+
+  teardown(async () => {
+    await vscode.workspace.getConfiguration("tester").update("receiveMode", undefined, vscode.ConfigurationTarget.Global);
+  });
+
+  test("默认polling不启动原生接收线程", () => {
+    const modes: string[] = [];
+    (new TesterExecutor() as any).startReceiveThread(0, createChannel(modes));
+    assert.deepStrictEqual(modes, []);
+  });
+
+  test("配置的接收方式传给通道接收线程", async () => {
+    for (const mode of ["blocking", "adaptive", "busyPoll"]) {
+      await vscode.workspace.getConfiguration("tester").update("receiveMode", mode, vscode.ConfigurationTarget.Global);
+      const modes: string[] = [];
+      (new TesterExecutor() as any).startReceiveThread(0, createChannel(modes));
+      assert.deepStrictEqual(modes, [mode]);
+    }
+  });
+});
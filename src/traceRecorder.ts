@@ -0,0 +1,195 @@
+/**
+ * 时间线记录器
+ * 记录执行器活动（用例、tcans/tcanr/tdelay命令、接收轮询），与原生层事件（驱动调用、接收线程唤醒、
+ * 环形缓存交接）合并导出为Chrome trace JSON，可在chrome://tracing或Perfetto UI (ui.perfetto.dev) 中打开。
+ *
+ * 两侧时间戳均取自单调时钟（process.hrtime与原生steady_clock同源），可直接对齐。
+ */
+
+import * as fs from 'fs';
+import { ZlgCanDevice, NativeTraceDump } from './zlgcan';
+
+/** Chrome trace事件 */
+interface ChromeTraceEvent {
+  name: string;
+  cat: string;
+  ph: string;
+  ts: number;
+  dur?: number;
+  pid: number;
+  tid: number;
+  s?: string;
+  args?: Record<string, unknown>;
+}
+
+/** JS侧事件（环形存储，时间单位ns） */
+interface JsTraceEvent {
+  name: string;
+  cat: string;
+  ph: 'X' | 'i';
+  start: bigint;
+  end: bigint;
+  args?: Record<string, unknown>;
+}
+
+/** 导出结果 */
+export interface TraceExportResult {
+  /** 写入的事件数 */
+  events: number;
+  /** 缓冲区写满后被覆盖的事件数（JS侧+原生层） */
+  overwritten: number;
+  /** 原生层时间线是否可用 */
+  nativeAvailable: boolean;
+}
+
+const TRACE_PID = 1;
+const JS_TID_FALLBACK = 0;
+
+export class TraceRecorder {
+  private static instance: TraceRecorder | null = null;
+
+  private enabled = false;
+  private nativeAvailable = false;
+  private ring: (JsTraceEvent | undefined)[] = [];
+  private head = 0;
+
+  public static getInstance(): TraceRecorder {
+    if (!TraceRecorder.instance) {
+      TraceRecorder.instance = new TraceRecorder();
+    }
+    return TraceRecorder.instance;
+  }
+
+  public get isEnabled(): boolean {
+    return this.enabled;
+  }
+
+  /**
+   * 开始记录，清除此前的事件
+   * @param capacity JS侧缓冲区事件数，写满后覆盖最旧的事件
+   * @param nativeCapacity 原生层缓冲区事件数
+   */
+  public start(capacity: number = 1 << 16, nativeCapacity: number = 1 << 18): void {
+    this.ring = new Array(capacity);
+    this.head = 0;
+    try {
+      ZlgCanDevice.traceStart(nativeCapacity);
+      this.nativeAvailable = true;
+    } catch {
+      this.nativeAvailable = false;
+    }
+    this.enabled = true;
+  }
+
+  /**
+   * 停止记录，事件保留到下次start
+   */
+  public stop(): void {
+    this.enabled = false;
+    if (this.nativeAvailable) {
+      ZlgCanDevice.traceStop();
+    }
+  }
+
+  /** 当前时刻，作为span的起点 */
+  public now(): bigint {
+    return process.hrtime.bigint();
+  }
+
+  /**
+   * 记录从start到当前时刻的持续事件
+   */
+  public span(name: string, cat: string, start: bigint, args?: Record<string, unknown>): void {
+    if (!this.enabled) {
+      return;
+    }
+    this.push({ name, cat, ph: 'X', start, end: process.hrtime.bigint(), args });
+  }
+
+  /**
+   * 记录瞬时事件
+   */
+  public instant(name: string, cat: string, args?: Record<string, unknown>): void {
+    if (!this.enabled) {
+      return;
+    }
+    const at = process.hrtime.bigint();
+    this.push({ name, cat, ph: 'i', start: at, end: at, args });
+  }
+
+  /**
+   * 合并JS侧与原生层事件，写出Chrome trace JSON
+   */
+  public exportChromeTrace(filePath: string): TraceExportResult {
+    let native: NativeTraceDump | null = null;
+    if (this.nativeAvailable) {
+      try {
+        native = ZlgCanDevice.traceDump();
+      } catch {
+        native = null;
+      }
+    }
+    const jsTid = native ? native.callerTid : JS_TID_FALLBACK;
+
+    const traceEvents: ChromeTraceEvent[] = [];
+    traceEvents.push({ name: 'process_name', cat: '__metadata', ph: 'M', ts: 0, pid: TRACE_PID, tid: jsTid, args: { name: 'tester' } });
+    traceEvents.push({ name: 'thread_name', cat: '__metadata', ph: 'M', ts: 0, pid: TRACE_PID, tid: jsTid, args: { name: 'js-main' } });
+
+    if (native) {
+      for (const [tid, name] of Object.entries(native.threads)) {
+        if (Number(tid) !== jsTid) {
+          traceEvents.push({ name: 'thread_name', cat: '__metadata', ph: 'M', ts: 0, pid: TRACE_PID, tid: Number(tid), args: { name } });
+        }
+      }
+      for (const event of native.events) {
+        traceEvents.push({
+          name: event.name,
+          cat: event.cat,
+          ph: event.ph,
+          ts: event.ts,
+          dur: event.ph === 'X' ? event.dur : undefined,
+          pid: TRACE_PID,
+          tid: event.tid,
+          s: event.ph === 'i' ? 't' : undefined,
+          args: event.arg ? { count: event.arg } : undefined,
+        });
+      }
+    }
+
+    const capacity = this.ring.length;
+    const from = Math.max(0, this.head - capacity);
+    for (let i = from; i < this.head; i++) {
+      const event = this.ring[i % capacity];
+      if (!event) {
+        continue;
+      }
+      traceEvents.push({
+        name: event.name,
+        cat: event.cat,
+        ph: event.ph,
+        ts: Number(event.start) / 1000,
+        dur: event.ph === 'X' ? Number(event.end - event.start) / 1000 : undefined,
+        pid: TRACE_PID,
+        tid: jsTid,
+        s: event.ph === 'i' ? 't' : undefined,
+        args: event.args,
+      });
+    }
+
+    fs.writeFileSync(filePath, JSON.stringify({ traceEvents, displayTimeUnit: 'ns' }));
+    return {
+      events: traceEvents.length,
+      overwritten: from + (native ? native.overwritten : 0),
+      nativeAvailable: native !== null,
+    };
+  }
+
+  private push(event: JsTraceEvent): void {
+    const capacity = this.ring.length;
+    if (capacity === 0) {
+      return;
+    }
+    this.ring[this.head % capacity] = event;
+    this.head++;
+  }
+}
@@ -1,5 +1,7 @@
 import * as vscode from "vscode";
 import { SavedDeviceConfig, DeviceChannelConfig } from "../deviceConfigManager";
+import type { PipelineSampleInfo, PipelineWarningEvent, ReceiveThreadInfo } from "../executor";
+import type { ThreadRole, ThreadSchedulingState } from "../zlgcan";
 
 export interface DeviceStatus {
   connected: boolean;
@@ -200,6 +202,40 @@ export class DeviceStatusViewProvider implements vscode.WebviewViewProvider {
     }
   }
 
+  /** 视图是否可见，不可见时无需推送接收链路采样 */
+  public get visible(): boolean {
+    return this._view?.visible ?? false;
+  }
+
+  /**
+   * 追加接收链路采样，reset为true时先清空已显示的序列
+   */
+  public updatePipeline(samples: PipelineSampleInfo[], reset: boolean = false) {
+    if (this._view) {
+      this._view.webview.postMessage({ type: "updatePipeline", samples, reset });
+    }
+  }
+
+  /** 原生线程调度生效情况与唤醒延迟 */
+  public updateThreadScheduling(scheduling: Record<ThreadRole, ThreadSchedulingState>) {
+    if (this._view) {
+      this._view.webview.postMessage({ type: "updateThreadScheduling", scheduling });
+    }
+  }
+
+  /** 各通道接收线程的读取方式、CPU占用与取帧延迟 */
+  public updateReceiveThreads(threads: ReceiveThreadInfo[]) {
+    if (this._view) {
+      this._view.webview.postMessage({ type: "updateReceiveThreads", threads });
+    }
+  }
+
+  public showPipelineWarning(warning: PipelineWarningEvent) {
+    if (this._view) {
+      this._view.webview.postMessage({ type: "pipelineWarning", warning });
+    }
+  }
+
   private _getHtmlForWebview(webview: vscode.Webview) {
     return `<!DOCTYPE html>
 <html lang="zh-CN">
@@ -457,6 +493,57 @@ export class DeviceStatusViewProvider implements vscode.WebviewViewProvider {
       cursor: not-allowed;
     }
 
+    /* 接收链路 */
+    .pipeline {
+      display: none;
+      padding: 8px 0;
+      border-top: 1px solid var(--vscode-widget-border);
+      font-size: 11px;
+    }
+
+    .pipeline.active {
+      display: block;
+    }
+
+    .pipeline-title {
+      font-weight: 600;
+      margin-bottom: 6px;
+    }
+
+    .pipeline-chart {
+      width: 100%;
+      height: 40px;
+      display: block;
+      margin: 6px 0;
+    }
+
+    .pipeline-chart polyline {
+      fill: none;
+      stroke: var(--vscode-charts-blue, #3b82f6);
+      stroke-width: 1;
+    }
+
+    .pipeline-chart line {
+      stroke: #ef4444;
+      stroke-dasharray: 2 2;
+      stroke-width: 1;
+    }
+
+    .pipeline-channels {
+      display: flex;
+      flex-wrap: wrap;
+      gap: 4px 16px;
+    }
+
+    .stat-value.warning {
+      color: #ef4444;
+    }
+
+    .pipeline-warning {
+      margin-top: 6px;
+      color: #ef4444;
+    }
+
     /* 空状态 */
     .empty-state {
       text-align: center;
@@ -802,6 +889,36 @@ export class DeviceStatusViewProvider implements vscode.WebviewViewProvider {
     </div>
   </div>
 
+  <!-- 接收链路：事件循环延迟与缓冲深度 -->
+  <div class="pipeline" id="pipeline">
+    <div class="pipeline-title">接收链路</div>
+    <div class="stats">
+      <div class="stat-item">
+        <span class="stat-label">事件循环延迟:</span>
+        <span class="stat-value" id="pipelineLag">0ms</span>
+      </div>
+      <div class="stat-item">
+        <span class="stat-label">窗口峰值:</span>
+        <span class="stat-value" id="pipelineLagMax">0ms</span>
+      </div>
+    </div>
+    <svg class="pipeline-chart" id="pipelineChart" viewBox="0 0 600 40" preserveAspectRatio="none"></svg>
+    <div class="pipeline-channels" id="pipelineChannels"></div>
+    <div class="pipeline-warning" id="pipelineWarning"></div>
+  </div>
+
+  <!-- 通道接收线程：读取方式、CPU占用与取帧延迟 -->
+  <div class="pipeline" id="receiveThreads">
+    <div class="pipeline-title">接收线程</div>
+    <div class="pipeline-channels" id="receiveThreadChannels"></div>
+  </div>
+
+  <!-- 原生线程调度与唤醒延迟 -->
+  <div class="pipeline" id="threadScheduling">
+    <div class="pipeline-title">线程调度</div>
+    <div class="pipeline-channels" id="threadSchedulingRoles"></div>
+  </div>
+
   <!-- 底部统计 -->
   <div class="footer">
     <div class="stats">
@@ -1353,6 +1470,117 @@ export class DeviceStatusViewProvider implements vscode.WebviewViewProvider {
       }, 3000);
     }
 
+    // 接收链路采样窗口
+    const PIPELINE_WINDOW = 600;
+    const PIPELINE_LAG_WARN_MS = 100;
+    let pipelineSamples = [];
+
+    function updatePipeline(samples, reset) {
+      if (reset) {
+        pipelineSamples = [];
+      }
+      pipelineSamples = pipelineSamples.concat(samples || []).slice(-PIPELINE_WINDOW);
+
+      const panel = document.getElementById('pipeline');
+      if (pipelineSamples.length === 0) {
+        panel.classList.remove('active');
+        document.getElementById('pipelineWarning').textContent = '';
+        return;
+      }
+      panel.classList.add('active');
+
+      const latest = pipelineSamples[pipelineSamples.length - 1];
+      const lagMax = Math.max(...pipelineSamples.map(s => s.lagMs));
+      const lagEl = document.getElementById('pipelineLag');
+      lagEl.textContent = latest.lagMs.toFixed(1) + 'ms' + (latest.stalled ? ' (阻塞中)' : '');
+      lagEl.className = 'stat-value' + (latest.lagMs >= PIPELINE_LAG_WARN_MS ? ' warning' : '');
+      document.getElementById('pipelineLagMax').textContent = lagMax.toFixed(1) + 'ms';
+
+      // 纵轴上限取阈值的两倍，超出部分截断
+      const scale = PIPELINE_LAG_WARN_MS * 2;
+      const step = 600 / PIPELINE_WINDOW;
+      const offset = PIPELINE_WINDOW - pipelineSamples.length;
+      const points = pipelineSamples.map((s, i) =>
+        ((offset + i) * step).toFixed(1) + ',' + (40 - Math.min(s.lagMs, scale) / scale * 40).toFixed(1)
+      ).join(' ');
+      document.getElementById('pipelineChart').innerHTML =
+        '<line x1="0" y1="20" x2="600" y2="20"></line><polyline points="' + points + '"></polyline>';
+
+      // 丢帧数取窗口内累计
+      const dropped = {};
+      for (const sample of pipelineSamples) {
+        for (const ch of sample.channels) {
+          dropped[ch.channelIndex] = (dropped[ch.channelIndex] || 0) + ch.framesDropped;
+        }
+      }
+      document.getElementById('pipelineChannels').innerHTML = latest.channels.map(ch => {
+        const label = ch.projectChannelIndex !== undefined ? '项目通道' + ch.projectChannelIndex : '设备通道' + ch.channelIndex;
+        const ring = ch.ringCapacity > 0 ? ch.ringDepth + '/' + ch.ringCapacity : '-';
+        const drops = dropped[ch.channelIndex] || 0;
+        return '<div class="stat-item"><span class="stat-label">' + label + ':</span>' +
+          '<span class="stat-value">缓冲 ' + ring + ' · 驱动 ' + ch.vendorDepth + '</span>' +
+          '<span class="stat-value' + (drops > 0 ? ' warning' : '') + '">丢帧 ' + drops + '</span></div>';
+      }).join('');
+    }
+
+    const THREAD_ROLE_NAMES = { receive: '接收', transmit: '周期发送', monitor: '监视' };
+
+    function updateThreadScheduling(scheduling) {
+      const roles = Object.keys(THREAD_ROLE_NAMES).filter(role =>
+        scheduling[role] && (scheduling[role].threads > 0 || scheduling[role].wakeupLatency.wakeups > 0));
+      const panel = document.getElementById('threadScheduling');
+      panel.classList.toggle('active', roles.length > 0);
+      document.getElementById('threadSchedulingRoles').innerHTML = roles.map(role => {
+        const state = scheduling[role];
+        let priority = '普通';
+        if (state.realtime) {
+          priority = state.realtimeApplied ? '实时' : '降级(' + (state.fallback || '普通') + ')';
+        }
+        const cpus = state.cpus.length > 0 ? ' · CPU ' + state.cpus.join(',') + (state.affinityApplied ? '' : '(未生效)') : '';
+        const latency = state.wakeupLatency;
+        const title = state.error ? ' title="' + state.error.replace(/"/g, '&quot;') + '"' : '';
+        return '<div class="stat-item"' + title + '><span class="stat-label">' + THREAD_ROLE_NAMES[role] + ' ×' + state.threads + ':</span>' +
+          '<span class="stat-value' + (state.realtime && !state.realtimeApplied ? ' warning' : '') + '">' + priority + cpus + '</span>' +
+          '<span class="stat-value">唤醒延迟 p99 ' + latency.p99Us.toFixed(0) + 'µs · 最大 ' + latency.maxUs.toFixed(0) + 'µs</span></div>';
+      }).join('');
+    }
+
+    const RECEIVE_MODE_NAMES = { blocking: '阻塞', adaptive: '自适应', busyPoll: '忙轮询' };
+
+    function updateReceiveThreads(threads) {
+      const panel = document.getElementById('receiveThreads');
+      panel.classList.toggle('active', threads.length > 0);
+      document.getElementById('receiveThreadChannels').innerHTML = threads.map(t =>
+        '<div class="stat-item"><span class="stat-label">项目通道' + t.projectChannelIndex + ':</span>' +
+        '<span class="stat-value">' + (RECEIVE_MODE_NAMES[t.mode] || t.mode) + ' · CPU ' + t.cpuPercent.toFixed(1) + '%</span>' +
+        '<span class="stat-value">取帧延迟 p50 ' + t.latencyP50Us.toFixed(0) + 'µs · p99 ' + t.latencyP99Us.toFixed(0) +
+        'µs · 最大 ' + t.latencyMaxUs.toFixed(0) + 'µs</span></div>'
+      ).join('');
+    }
+
+    function showPipelineWarning(warning) {
+      const label = warning.projectChannelIndex !== undefined ? '项目通道' + warning.projectChannelIndex + ' ' : '';
+      const time = new Date(warning.timestamp).toLocaleTimeString();
+      let text;
+      switch (warning.type) {
+        case 'eventLoopLag':
+          text = '事件循环阻塞 ' + warning.value.toFixed(0) + 'ms';
+          break;
+        case 'ringFilling':
+          text = label + '接收缓冲占用 ' + (warning.value * 100).toFixed(0) + '%' +
+            (warning.etaMs >= 0 ? '，约 ' + warning.etaMs.toFixed(0) + 'ms 后写满' : '');
+          break;
+        case 'vendorQueue':
+          text = label + '驱动接收缓冲积压 ' + warning.value + ' 帧';
+          break;
+        default:
+          text = label + '丢弃 ' + warning.value + ' 帧';
+          break;
+      }
+      document.getElementById('pipelineWarning').textContent =
+        time + ' ' + text + ' (事件循环延迟 ' + warning.lagMs.toFixed(0) + 'ms)';
+    }
+
     // 接收消息
     window.addEventListener('message', event => {
       const message = event.data;
@@ -1377,6 +1605,21 @@ export class DeviceStatusViewProvider implements vscode.WebviewViewProvider {
         case 'showMessage':
           showToast(message.message, message.success);
           break;
+
+        case 'updatePipeline':
+          updatePipeline(message.samples, message.reset);
+          break;
+
+        case 'pipelineWarning':
+          showPipelineWarning(message.warning);
+          break;
+
+        case 'updateThreadScheduling':
+          updateThreadScheduling(message.scheduling);
+          break;
+        case 'updateReceiveThreads':
+          updateReceiveThreads(message.threads);
+          break;
       }
     });
 
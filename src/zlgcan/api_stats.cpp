@@ -0,0 +1,336 @@
+#include "api_stats.h"
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+constexpr size_t API_COUNT = static_cast<size_t>(ApiId::Count);
+
+const char* const API_NAMES[API_COUNT] = {
+    "ZCAN_OpenDevice",
+    "ZCAN_CloseDevice",
+    "ZCAN_GetDeviceInf",
+    "ZCAN_GetDeviceInfoEx",
+    "ZCAN_IsDeviceOnLine",
+    "ZCAN_InitCAN",
+    "ZCAN_StartCAN",
+    "ZCAN_ResetCAN",
+    "ZCAN_ClearBuffer",
+    "ZCAN_ReadChannelErrInfo",
+    "ZCAN_ReadChannelStatus",
+    "ZCAN_GetReceiveNum",
+    "ZCAN_Transmit",
+    "ZCAN_TransmitFD",
+    "ZCAN_Receive",
+    "ZCAN_ReceiveFD",
+    "ZCAN_TransmitData",
+    "ZCAN_ReceiveData",
+    "ZCAN_SetValue",
+    "ZCAN_GetValue",
+    "GetIProperty",
+    "ReleaseIProperty",
+    "IProperty.SetValue",
+    "IProperty.GetValue",
+    "ZCAN_InitLIN",
+    "ZCAN_StartLIN",
+    "ZCAN_ResetLIN",
+    "ZCAN_TransmitLIN",
+    "ZCAN_ReceiveLIN",
+    "ZCAN_GetLINReceiveNum",
+    "ZCAN_SetLINPublish",
+    "ZCAN_SetLINPublishEx",
+    "ZCAN_SetLINSubscribe",
+    "ZCAN_WakeUpLIN",
+    "ZCAN_CreateLINSchedule",
+    "ZCAN_DestroyLINSchedule",
+    "ZCAN_AddLINSchedule",
+    "ZCAN_ClrLINSchedule",
+    "ZCAN_StartLINSchedule",
+    "ZCAN_StopLINSchedule",
+    "ZCAN_SetLINScheduleEnabled",
+    "ZCAN_SetLINScheduleItemEnabled",
+    "ZCAN_GetLINScheduleStatus",
+    "ZCAN_UDS_Request",
+    "ZCAN_UDS_Control",
+    "ZCAN_UDS_RequestEX",
+    "ZCAN_UDS_ControlEX",
+    "js.transmit",
+    "js.transmitFD",
+    "js.transmitData",
+    "js.receive",
+    "js.receiveFD",
+    "js.receiveData",
+};
+
+// 普通整数形式的累计值，用于已退出线程的汇总、重置零点和快照计算
+struct ApiTotals {
+    struct Entry {
+        uint64_t calls = 0;
+        uint64_t errors = 0;
+        uint64_t frames = 0;
+        uint64_t bytes = 0;
+        uint64_t ticks = 0;
+        uint64_t histogram[API_HIST_BUCKETS] = {};
+    };
+    Entry entries[API_COUNT];
+};
+
+struct ApiRegistry {
+    std::mutex mutex;
+    std::vector<ApiThreadCounters*> active;
+    std::vector<ApiThreadCounters*> spare;   // 已退出线程归还的计数块（已清零）
+    ApiTotals retired;
+    ApiTotals baseline;
+};
+
+// 故意不释放：线程局部对象的析构可能晚于静态对象析构（进程退出时）
+ApiRegistry& Registry() {
+    static ApiRegistry* registry = new ApiRegistry();
+    return *registry;
+}
+
+#ifdef ZLGCAN_API_STATS_TSC
+struct TscOrigin {
+    uint64_t tsc;
+    std::chrono::steady_clock::time_point wall;
+};
+
+const TscOrigin& Origin() {
+    static const TscOrigin origin{ApiStatsNow(), std::chrono::steady_clock::now()};
+    return origin;
+}
+#endif
+
+// TSC频率按起点（模块初始化时刻）以来的墙钟跨度标定，跨度越长越精确；不等待，
+// 模块加载后立即取快照时跨度较短、精度较低，跨度为零时退回1.0
+double NsPerTick() {
+#ifdef ZLGCAN_API_STATS_TSC
+    const TscOrigin& origin = Origin();
+    const uint64_t ticks = ApiStatsNow() - origin.tsc;
+    const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - origin.wall).count());
+    return ticks == 0 || ns <= 0 ? 1.0 : ns / static_cast<double>(ticks);
+#else
+    return 1.0;
+#endif
+}
+
+void Accumulate(ApiTotals& totals, const ApiThreadCounters& counters) {
+    for (size_t i = 0; i < API_COUNT; i++) {
+        const ApiThreadCounters::Entry& from = counters.entries[i];
+        ApiTotals::Entry& to = totals.entries[i];
+        to.calls += from.calls.load(std::memory_order_relaxed);
+        to.errors += from.errors.load(std::memory_order_relaxed);
+        to.frames += from.frames.load(std::memory_order_relaxed);
+        to.bytes += from.bytes.load(std::memory_order_relaxed);
+        to.ticks += from.ticks.load(std::memory_order_relaxed);
+        for (int b = 0; b < API_HIST_BUCKETS; b++) {
+            to.histogram[b] += from.histogram[b].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Accumulate(ApiTotals& totals, const ApiTotals& other) {
+    for (size_t i = 0; i < API_COUNT; i++) {
+        const ApiTotals::Entry& from = other.entries[i];
+        ApiTotals::Entry& to = totals.entries[i];
+        to.calls += from.calls;
+        to.errors += from.errors;
+        to.frames += from.frames;
+        to.bytes += from.bytes;
+        to.ticks += from.ticks;
+        for (int b = 0; b < API_HIST_BUCKETS; b++) {
+            to.histogram[b] += from.histogram[b];
+        }
+    }
+}
+
+void Clear(ApiThreadCounters& counters) {
+    for (ApiThreadCounters::Entry& entry : counters.entries) {
+        entry.calls.store(0, std::memory_order_relaxed);
+        entry.errors.store(0, std::memory_order_relaxed);
+        entry.frames.store(0, std::memory_order_relaxed);
+        entry.bytes.store(0, std::memory_order_relaxed);
+        entry.ticks.store(0, std::memory_order_relaxed);
+        for (std::atomic<uint64_t>& bucket : entry.histogram) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+// 调用方持有registry.mutex
+void CollectLocked(ApiRegistry& registry, ApiTotals& totals) {
+    for (const ApiThreadCounters* counters : registry.active) {
+        Accumulate(totals, *counters);
+    }
+    Accumulate(totals, registry.retired);
+}
+
+ApiThreadCounters* AcquireCounters() {
+#ifdef ZLGCAN_API_STATS_TSC
+    Origin();
+#endif
+    ApiRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    ApiThreadCounters* counters;
+    if (!registry.spare.empty()) {
+        counters = registry.spare.back();
+        registry.spare.pop_back();
+    } else {
+        counters = new ApiThreadCounters();
+    }
+    registry.active.push_back(counters);
+    return counters;
+}
+
+void ReleaseCounters(ApiThreadCounters* counters) {
+    ApiRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    Accumulate(registry.retired, *counters);
+    Clear(*counters);
+    for (size_t i = 0; i < registry.active.size(); i++) {
+        if (registry.active[i] == counters) {
+            registry.active[i] = registry.active.back();
+            registry.active.pop_back();
+            break;
+        }
+    }
+    registry.spare.push_back(counters);
+}
+
+struct ApiLocalSlot {
+    ApiThreadCounters* counters = nullptr;
+    ~ApiLocalSlot() {
+        if (counters != nullptr) {
+            ReleaseCounters(counters);
+        }
+    }
+};
+
+thread_local ApiLocalSlot t_localSlot;
+
+// 减去零点；计数块被回收清零后不会出现倒退，但仍按饱和减法防御
+uint64_t Since(uint64_t now, uint64_t base) {
+    return now > base ? now - base : 0;
+}
+
+}  // namespace
+
+uint64_t ApiHistBucketUpper(int index) {
+    if (index < API_HIST_SUB_BUCKETS) {
+        return static_cast<uint64_t>(index);
+    }
+    const int exponent = (index - API_HIST_SUB_BUCKETS) / API_HIST_SUB_BUCKETS + API_HIST_SUB_BITS;
+    const uint64_t sub = static_cast<uint64_t>((index - API_HIST_SUB_BUCKETS) % API_HIST_SUB_BUCKETS);
+    return ((API_HIST_SUB_BUCKETS + sub + 1) << (exponent - API_HIST_SUB_BITS)) - 1;
+}
+
+double ApiHistPercentile(const uint64_t* histogram, uint64_t total, double quantile, double nsPerTick) {
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(total)));
+    if (rank == 0) {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (int b = 0; b < API_HIST_BUCKETS; b++) {
+        seen += histogram[b];
+        if (seen >= rank) {
+            return static_cast<double>(ApiHistBucketUpper(b)) * nsPerTick;
+        }
+    }
+    return static_cast<double>(ApiHistBucketUpper(API_HIST_BUCKETS - 1)) * nsPerTick;
+}
+
+const char* ApiName(ApiId api) {
+    const size_t index = static_cast<size_t>(api);
+    return index < API_COUNT ? API_NAMES[index] : "unknown";
+}
+
+ApiThreadCounters& ApiLocalCounters() {
+    ApiThreadCounters* counters = t_localSlot.counters;
+    if (counters == nullptr) {
+        counters = AcquireCounters();
+        t_localSlot.counters = counters;
+    }
+    return *counters;
+}
+
+void ApiStatsInit() {
+#ifdef ZLGCAN_API_STATS_TSC
+    Origin();
+#endif
+}
+
+ApiClockMapping ApiStatsClock() {
+    ApiClockMapping mapping;
+#ifdef ZLGCAN_API_STATS_TSC
+    mapping.nsPerTick = NsPerTick();
+    mapping.originTicks = Origin().tsc;
+    mapping.originNs = static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Origin().wall.time_since_epoch()).count());
+#endif
+    return mapping;
+}
+
+ApiStatsSnapshot ApiStatsTake() {
+    ApiStatsSnapshot snapshot;
+    snapshot.nsPerTick = NsPerTick();
+
+    std::unique_ptr<ApiTotals> totals(new ApiTotals());
+    std::unique_ptr<ApiTotals> baseline(new ApiTotals());
+    {
+        ApiRegistry& registry = Registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        CollectLocked(registry, *totals);
+        *baseline = registry.baseline;
+        snapshot.threads = registry.active.size();
+    }
+
+    uint64_t histogram[API_HIST_BUCKETS];
+    for (size_t i = 0; i < API_COUNT; i++) {
+        const ApiTotals::Entry& now = totals->entries[i];
+        const ApiTotals::Entry& base = baseline->entries[i];
+        const uint64_t calls = Since(now.calls, base.calls);
+        if (calls == 0) {
+            continue;
+        }
+
+        ApiStatsEntry entry;
+        entry.name = API_NAMES[i];
+        entry.calls = calls;
+        entry.errors = Since(now.errors, base.errors);
+        entry.frames = Since(now.frames, base.frames);
+        entry.bytes = Since(now.bytes, base.bytes);
+        entry.totalNs = static_cast<double>(Since(now.ticks, base.ticks)) * snapshot.nsPerTick;
+
+        uint64_t recorded = 0;
+        for (int b = 0; b < API_HIST_BUCKETS; b++) {
+            histogram[b] = Since(now.histogram[b], base.histogram[b]);
+            recorded += histogram[b];
+            if (histogram[b] != 0) {
+                const double upperNs = static_cast<double>(ApiHistBucketUpper(b)) * snapshot.nsPerTick;
+                entry.histogram.emplace_back(upperNs, histogram[b]);
+                entry.maxNs = upperNs;
+            }
+        }
+        entry.p50Ns = ApiHistPercentile(histogram, recorded, 0.50, snapshot.nsPerTick);
+        entry.p90Ns = ApiHistPercentile(histogram, recorded, 0.90, snapshot.nsPerTick);
+        entry.p99Ns = ApiHistPercentile(histogram, recorded, 0.99, snapshot.nsPerTick);
+        entry.p999Ns = ApiHistPercentile(histogram, recorded, 0.999, snapshot.nsPerTick);
+        snapshot.entries.push_back(std::move(entry));
+    }
+    return snapshot;
+}
+
+void ApiStatsReset() {
+    ApiRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::unique_ptr<ApiTotals> totals(new ApiTotals());
+    CollectLocked(registry, *totals);
+    registry.baseline = *totals;
+}
@@ -0,0 +1,263 @@
+#ifndef ZLGCAN_API_STATS_H_
+#define ZLGCAN_API_STATS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "trace_buffer.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define ZLGCAN_API_STATS_TSC 1
+#elif (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <x86intrin.h>
+#define ZLGCAN_API_STATS_TSC 1
+#else
+#include <chrono>
+#endif
+
+// 被计量的调用：ZCAN_*驱动接口，以及JS收发方法的整体耗时（减去对应驱动调用即为封送开销）
+enum class ApiId : uint8_t {
+    OpenDevice,
+    CloseDevice,
+    GetDeviceInf,
+    GetDeviceInfoEx,
+    IsDeviceOnLine,
+    InitCAN,
+    StartCAN,
+    ResetCAN,
+    ClearBuffer,
+    ReadChannelErrInfo,
+    ReadChannelStatus,
+    GetReceiveNum,
+    Transmit,
+    TransmitFD,
+    Receive,
+    ReceiveFD,
+    TransmitData,
+    ReceiveData,
+    SetValue,
+    GetValue,
+    GetIProperty,
+    ReleaseIProperty,
+    PropertySetValue,
+    PropertyGetValue,
+    InitLIN,
+    StartLIN,
+    ResetLIN,
+    TransmitLIN,
+    ReceiveLIN,
+    GetLINReceiveNum,
+    SetLINPublish,
+    SetLINPublishEx,
+    SetLINSubscribe,
+    WakeUpLIN,
+    CreateLINSchedule,
+    DestroyLINSchedule,
+    AddLINSchedule,
+    ClrLINSchedule,
+    StartLINSchedule,
+    StopLINSchedule,
+    SetLINScheduleEnabled,
+    SetLINScheduleItemEnabled,
+    GetLINScheduleStatus,
+    UdsRequest,
+    UdsControl,
+    UdsRequestEx,
+    UdsControlEx,
+    JsTransmit,
+    JsTransmitFD,
+    JsTransmitData,
+    JsReceive,
+    JsReceiveFD,
+    JsReceiveData,
+    Count
+};
+
+const char* ApiName(ApiId api);
+
+// 直方图：对数-线性分桶，每个2的幂区间4个子桶（相对误差不超过25%），计数单位为时钟滴答
+constexpr int API_HIST_SUB_BITS = 2;
+constexpr int API_HIST_SUB_BUCKETS = 1 << API_HIST_SUB_BITS;
+constexpr int API_HIST_MAX_EXPONENT = 42;        // 超出的耗时计入最后一个桶
+constexpr int API_HIST_BUCKETS = API_HIST_SUB_BUCKETS + (API_HIST_MAX_EXPONENT - API_HIST_SUB_BITS + 1) * API_HIST_SUB_BUCKETS;
+
+inline int ApiHighestBit(uint64_t value) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(value);
+#else
+    int index = 63;
+    while ((value >> index) == 0) {
+        index--;
+    }
+    return index;
+#endif
+}
+
+inline int ApiHistBucket(uint64_t ticks) {
+    if (ticks < static_cast<uint64_t>(API_HIST_SUB_BUCKETS)) {
+        return static_cast<int>(ticks);
+    }
+    const int exponent = ApiHighestBit(ticks);
+    if (exponent > API_HIST_MAX_EXPONENT) {
+        return API_HIST_BUCKETS - 1;
+    }
+    const int sub = static_cast<int>((ticks >> (exponent - API_HIST_SUB_BITS)) & (API_HIST_SUB_BUCKETS - 1));
+    return API_HIST_SUB_BUCKETS + (exponent - API_HIST_SUB_BITS) * API_HIST_SUB_BUCKETS + sub;
+}
+
+// 桶的计数上界（含）
+uint64_t ApiHistBucketUpper(int index);
+
+// 按桶上界估算分位数，nsPerTick为计数单位对应的纳秒数
+double ApiHistPercentile(const uint64_t* histogram, uint64_t total, double quantile, double nsPerTick);
+
+// 每个线程一份计数，只由所属线程写入（relaxed读改写，无锁前缀），快照时由其他线程读取
+struct ApiThreadCounters {
+    struct Entry {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> errors{0};
+        std::atomic<uint64_t> frames{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> ticks{0};
+        std::atomic<uint64_t> histogram[API_HIST_BUCKETS] = {};
+    };
+    Entry entries[static_cast<size_t>(ApiId::Count)];
+};
+
+// 当前线程的计数块，首次使用时登记，线程退出时并入全局累计并回收
+ApiThreadCounters& ApiLocalCounters();
+
+inline uint64_t ApiStatsNow() {
+#ifdef ZLGCAN_API_STATS_TSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// 未取到数据的接收调用和接收队列深度查询是轮询的常态，不写入时间线以免淹没有效事件（仍计入统计）
+inline bool ApiTraceWorthy(ApiId api, uint64_t frames) {
+    switch (api) {
+    case ApiId::Receive:
+    case ApiId::ReceiveFD:
+    case ApiId::ReceiveData:
+    case ApiId::ReceiveLIN:
+    case ApiId::JsReceive:
+    case ApiId::JsReceiveFD:
+    case ApiId::JsReceiveData:
+        return frames != 0;
+    case ApiId::GetReceiveNum:
+    case ApiId::GetLINReceiveNum:
+        return false;
+    default:
+        return true;
+    }
+}
+
+inline void ApiBump(std::atomic<uint64_t>& counter, uint64_t delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+/**
+ * 记录一次调用
+ * start为ApiStatsNow()取得的起点；frames为搬运的帧/报文数，bytes为跨越接口的结构体字节数
+ */
+inline void ApiStatsRecord(ApiId api, uint64_t start, uint64_t frames, uint64_t bytes, bool error) {
+    const uint64_t end = ApiStatsNow();
+    const uint64_t elapsed = end - start;
+    ApiThreadCounters::Entry& entry = ApiLocalCounters().entries[static_cast<size_t>(api)];
+    ApiBump(entry.calls, 1);
+    if (error) {
+        ApiBump(entry.errors, 1);
+    }
+    if (frames != 0) {
+        ApiBump(entry.frames, frames);
+        ApiBump(entry.bytes, bytes);
+    }
+    ApiBump(entry.ticks, elapsed);
+    ApiBump(entry.histogram[ApiHistBucket(elapsed)], 1);
+    if (TraceEnabled() && ApiTraceWorthy(api, frames)) {
+        TraceComplete(ApiName(api), api >= ApiId::JsTransmit ? "js" : "zcan", start, end, frames);
+    }
+}
+
+// 整个作用域计为一次调用（用于JS方法），frames/error可在返回前设置
+class ApiScope {
+public:
+    explicit ApiScope(ApiId api) : api_(api), start_(ApiStatsNow()) {}
+    ~ApiScope() { ApiStatsRecord(api_, start_, frames_, bytes_, error_); }
+
+    ApiScope(const ApiScope&) = delete;
+    ApiScope& operator=(const ApiScope&) = delete;
+
+    void SetFrames(uint64_t frames, size_t frameSize) {
+        frames_ = frames;
+        bytes_ = frames * frameSize;
+    }
+    void SetError(bool error) { error_ = error; }
+
+private:
+    ApiId api_;
+    uint64_t start_;
+    uint64_t frames_ = 0;
+    uint64_t bytes_ = 0;
+    bool error_ = false;
+};
+
+// ==================== 快照 ====================
+
+struct ApiStatsEntry {
+    const char* name = nullptr;
+    uint64_t calls = 0;
+    uint64_t errors = 0;
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+    double totalNs = 0;
+    double p50Ns = 0;
+    double p90Ns = 0;
+    double p99Ns = 0;
+    double p999Ns = 0;
+    double maxNs = 0;                  // 最高非空桶的上界
+    std::vector<std::pair<double, uint64_t>> histogram;  // (桶上界ns, 次数)，只含非空桶
+};
+
+struct ApiStatsSnapshot {
+    double nsPerTick = 1.0;
+    uint64_t threads = 0;              // 登记过计数块的活动线程数
+    std::vector<ApiStatsEntry> entries;  // 只含自上次重置以来有调用的接口
+};
+
+// 计时滴答到steady_clock纳秒的线性换算，按标定起点以来的跨度计算，不阻塞
+struct ApiClockMapping {
+    double nsPerTick = 1.0;
+    uint64_t originTicks = 0;
+    int64_t originNs = 0;
+
+    int64_t ToSteadyNs(uint64_t ticks) const {
+        return originNs + static_cast<int64_t>(static_cast<double>(static_cast<int64_t>(ticks - originTicks)) * nsPerTick);
+    }
+};
+
+// 固定TSC标定起点；模块初始化时调用，使首次快照时已有足够的标定跨度
+void ApiStatsInit();
+
+ApiClockMapping ApiStatsClock();
+
+// 汇总所有线程（含已退出线程）自上次ApiStatsReset以来的计数
+ApiStatsSnapshot ApiStatsTake();
+
+// 以当前累计值为新的零点；不修改各线程的计数块，因而不与写入方竞争
+void ApiStatsReset();
+
+#endif  // ZLGCAN_API_STATS_H_
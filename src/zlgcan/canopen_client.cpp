@@ -0,0 +1,1039 @@
+#include "canopen_client.h"
+#include "zlgcan_api.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+// 预定义连接集的功能码
+constexpr UINT COB_NMT = 0x000;
+constexpr UINT COB_EMCY = 0x080;
+constexpr UINT COB_SDO_TX = 0x580;         // 服务器 -> 客户端
+constexpr UINT COB_SDO_RX = 0x600;         // 客户端 -> 服务器
+constexpr UINT COB_HEARTBEAT = 0x700;
+constexpr UINT FUNCTION_MASK = 0x780;
+constexpr BYTE NODE_ID_MASK = 0x7F;
+constexpr BYTE MAX_NODE_ID = 127;
+
+// SDO命令字（高3位）
+constexpr BYTE CCS_DOWNLOAD_SEGMENT = 0x00;
+constexpr BYTE CCS_INITIATE_DOWNLOAD = 0x20;
+constexpr BYTE CCS_INITIATE_UPLOAD = 0x40;
+constexpr BYTE CCS_UPLOAD_SEGMENT = 0x60;
+constexpr BYTE CS_ABORT = 0x80;
+constexpr BYTE CCS_BLOCK_UPLOAD = 0xA0;
+constexpr BYTE CCS_BLOCK_DOWNLOAD = 0xC0;
+
+constexpr BYTE SCS_UPLOAD_SEGMENT = 0x00;
+constexpr BYTE SCS_DOWNLOAD_SEGMENT = 0x20;
+constexpr BYTE SCS_INITIATE_UPLOAD = 0x40;
+constexpr BYTE SCS_INITIATE_DOWNLOAD = 0x60;
+constexpr BYTE SCS_BLOCK_DOWNLOAD = 0xA0;
+constexpr BYTE SCS_BLOCK_UPLOAD = 0xC0;
+constexpr BYTE SCS_MASK = 0xE0;
+
+// 块传输的子命令和标志
+constexpr BYTE BLOCK_INITIATE = 0x00;
+constexpr BYTE BLOCK_END = 0x01;
+constexpr BYTE BLOCK_ACK = 0x02;
+constexpr BYTE BLOCK_START = 0x03;
+constexpr BYTE BLOCK_SUBCOMMAND_MASK = 0xE3;     // 块下载响应的子命令占位1-0
+constexpr BYTE BLOCK_UPLOAD_SUBCOMMAND_MASK = 0xE1;  // 块上传响应的子命令只占位0
+constexpr BYTE BLOCK_CRC = 0x04;
+constexpr BYTE BLOCK_SIZE_INDICATED = 0x02;
+constexpr BYTE BLOCK_LAST_SEGMENT = 0x80;
+
+// 中止码
+constexpr uint32_t ABORT_TOGGLE = 0x05030000;
+constexpr uint32_t ABORT_TIMEOUT = 0x05040000;
+constexpr uint32_t ABORT_COMMAND = 0x05040001;
+constexpr uint32_t ABORT_BLOCK_SIZE = 0x05040002;
+constexpr uint32_t ABORT_SEQUENCE = 0x05040003;
+constexpr uint32_t ABORT_CRC = 0x05040004;
+constexpr uint32_t ABORT_OUT_OF_MEMORY = 0x05040005;
+constexpr uint32_t ABORT_LENGTH = 0x06070010;
+constexpr uint32_t ABORT_GENERAL = 0x08000000;
+
+constexpr size_t SEGMENT_SIZE = 7;
+constexpr size_t SDO_FRAME_SIZE = 8;
+constexpr BYTE MAX_BLOCK_SIZE = 127;
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t ElapsedUs(Clock::time_point from, Clock::time_point to) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+}
+
+uint32_t GetDword(const BYTE* data) {
+    return data[0] | (static_cast<uint32_t>(data[1]) << 8) | (static_cast<uint32_t>(data[2]) << 16) |
+        (static_cast<uint32_t>(data[3]) << 24);
+}
+
+void PutDword(BYTE* data, uint32_t value) {
+    data[0] = static_cast<BYTE>(value);
+    data[1] = static_cast<BYTE>(value >> 8);
+    data[2] = static_cast<BYTE>(value >> 16);
+    data[3] = static_cast<BYTE>(value >> 24);
+}
+
+const char* AbortName(uint32_t code) {
+    switch (code) {
+        case 0x05030000: return "toggle bit not alternated";
+        case 0x05040000: return "SDO protocol timed out";
+        case 0x05040001: return "command specifier not valid or unknown";
+        case 0x05040002: return "invalid block size";
+        case 0x05040003: return "invalid sequence number";
+        case 0x05040004: return "CRC error";
+        case 0x05040005: return "out of memory";
+        case 0x06010000: return "unsupported access to an object";
+        case 0x06010001: return "attempt to read a write only object";
+        case 0x06010002: return "attempt to write a read only object";
+        case 0x06020000: return "object does not exist";
+        case 0x06040041: return "object cannot be mapped to the PDO";
+        case 0x06040042: return "mapped objects would exceed PDO length";
+        case 0x06040043: return "general parameter incompatibility";
+        case 0x06040047: return "general internal incompatibility";
+        case 0x06060000: return "access failed due to a hardware error";
+        case 0x06070010: return "data type or length does not match";
+        case 0x06070012: return "data type does not match, length too high";
+        case 0x06070013: return "data type does not match, length too low";
+        case 0x06090011: return "sub-index does not exist";
+        case 0x06090030: return "invalid value for parameter";
+        case 0x06090031: return "value of parameter written too high";
+        case 0x06090032: return "value of parameter written too low";
+        case 0x08000000: return "general error";
+        case 0x08000020: return "data cannot be transferred or stored";
+        case 0x08000021: return "data cannot be transferred or stored because of local control";
+        case 0x08000022: return "data cannot be transferred or stored because of the device state";
+        case 0x08000024: return "no data available";
+        default: return "unknown abort code";
+    }
+}
+
+std::string AbortMessage(uint32_t code) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "SDO abort 0x%08X: ", code);
+    return std::string(buffer) + AbortName(code);
+}
+
+bool IsSigned(CanOpenDataType type) {
+    return type == CanOpenDataType::I8 || type == CanOpenDataType::I16 ||
+        type == CanOpenDataType::I32 || type == CanOpenDataType::I64;
+}
+
+}  // namespace
+
+struct CanOpenClient::SdoTransfer {
+    enum class Phase : uint8_t { Initiate, Segment, BlockInitiate, BlockData, BlockEnd };
+
+    bool upload = true;
+    BYTE nodeId = 0;
+    UINT index = 0;
+    BYTE subIndex = 0;
+    CanOpenSdoMode mode = CanOpenSdoMode::Auto;
+    bool block = false;                // 当前以块传输进行（自动模式下可能回退）
+    bool expedited = false;
+    Phase phase = Phase::Initiate;
+    std::vector<BYTE> data;            // 下载的数据或上传已收到的数据
+    size_t offset = 0;                 // 下载：从站已确认的字节数
+    size_t segmentBytes = 0;           // 下载：发出中的段的数据字节数
+    size_t size = 0;                   // 上传：从站指示的长度
+    bool sizeIndicated = false;
+    BYTE toggle = 0;
+    bool crc = false;                  // 双方都支持块传输CRC
+    BYTE blockSize = 0;
+    BYTE sequence = 0;                 // 上传：当前块中连续收到的最后序号；下载：当前块发出的段数
+    size_t blockStart = 0;             // 下载：当前块起始偏移
+    bool lastReceived = false;         // 上传：已收到最后一段
+    Clock::time_point startedAt;
+    Clock::time_point deadline;
+    bool done = false;
+    CanOpenSdoResult result;
+};
+
+struct CanOpenClient::PdoPlan {
+    // 一个映射项：先右移再按位宽取掩码
+    struct Step {
+        uint8_t shift = 0;
+        uint8_t bits = 0;
+        CanOpenDataType type = CanOpenDataType::U8;
+        uint64_t mask = 0;
+    };
+
+    UINT index = 0;
+    std::shared_ptr<const CanOpenPdoConfig> config;
+    std::vector<Step> steps;
+    UINT minLength = 0;
+    std::vector<uint64_t> last;        // 上一次的原始值
+    bool valid = false;
+};
+
+struct CanOpenClient::NodeMonitor {
+    BYTE state = 0xFF;
+    UINT timeoutMs = 0;                // 心跳消费者超时，0不监视
+    Clock::time_point lastSeen;
+    uint64_t lastTimestamp = 0;
+    bool lost = false;
+};
+
+CanOpenClient::CanOpenClient(CHANNEL_HANDLE channelHandle, const CanOpenOptions& options, BatchCallback callback)
+    : channelHandle_(channelHandle), options_(options), callback_(std::move(callback)) {
+    pdoByCobId_.fill(-1);
+    const auto now = Clock::now();
+    nodes_.resize(MAX_NODE_ID + 1);
+    for (auto& node : nodes_) {
+        node.reset(new NodeMonitor());
+        node->lastSeen = now;
+    }
+    for (const auto& consumer : options_.heartbeats) {
+        if (consumer.nodeId >= 1 && consumer.nodeId <= MAX_NODE_ID) {
+            nodes_[consumer.nodeId]->timeoutMs = consumer.timeoutMs;
+        }
+    }
+}
+
+CanOpenClient::~CanOpenClient() {
+    Close();
+}
+
+size_t CanOpenClient::TypeBits(CanOpenDataType type) {
+    switch (type) {
+        case CanOpenDataType::U8:
+        case CanOpenDataType::I8: return 8;
+        case CanOpenDataType::U16:
+        case CanOpenDataType::I16: return 16;
+        case CanOpenDataType::U32:
+        case CanOpenDataType::I32:
+        case CanOpenDataType::F32: return 32;
+        default: return 64;
+    }
+}
+
+uint16_t CanOpenClient::Crc16(const BYTE* data, size_t length, uint16_t crc) {
+    // CRC-16-CCITT，多项式0x1021，初值0（CiA 301块传输）
+    static const std::array<uint16_t, 256> table = [] {
+        std::array<uint16_t, 256> t{};
+        for (UINT i = 0; i < 256; i++) {
+            uint16_t value = static_cast<uint16_t>(i << 8);
+            for (int bit = 0; bit < 8; bit++) {
+                value = static_cast<uint16_t>((value & 0x8000) ? (value << 1) ^ 0x1021 : value << 1);
+            }
+            t[i] = value;
+        }
+        return t;
+    }();
+    for (size_t i = 0; i < length; i++) {
+        crc = static_cast<uint16_t>((crc << 8) ^ table[((crc >> 8) ^ data[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+void CanOpenClient::Close() {
+    std::lock_guard<std::mutex> lock(sdoMutex_);
+    closed_ = true;
+    for (auto& entry : transfers_) {
+        if (!entry.second->done) {
+            Abort(*entry.second, ABORT_GENERAL, "client closed");
+        }
+    }
+    sdoCv_.notify_all();
+}
+
+CanOpenStats CanOpenClient::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+bool CanOpenClient::TransmitFrame(UINT canId, const BYTE* data, UINT len) {
+    ZCAN_Transmit_Data frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.frame.can_id = canId;
+    frame.frame.can_dlc = static_cast<BYTE>(len);
+    memcpy(frame.frame.data, data, len);
+    return ZcanTransmit(channelHandle_.load(), &frame, 1) == 1;
+}
+
+bool CanOpenClient::TransmitSdo(const SdoTransfer& transfer, const BYTE data[8]) {
+    return TransmitFrame(COB_SDO_RX + transfer.nodeId, data, SDO_FRAME_SIZE);
+}
+
+bool CanOpenClient::SendNmt(BYTE command, BYTE nodeId) {
+    const BYTE data[2] = {command, nodeId};
+    return TransmitFrame(COB_NMT, data, sizeof(data));
+}
+
+// ==================== SDO ====================
+
+CanOpenSdoResult CanOpenClient::SdoUpload(BYTE nodeId, UINT index, BYTE subIndex, CanOpenSdoMode mode) {
+    auto transfer = std::make_shared<SdoTransfer>();
+    transfer->upload = true;
+    transfer->nodeId = nodeId;
+    transfer->index = index;
+    transfer->subIndex = subIndex;
+    transfer->mode = mode;
+    // 上传长度事先未知，自动模式以块上传发起，由协议切换阈值让从站对小对象回到普通上传
+    transfer->block = mode == CanOpenSdoMode::Block || (mode == CanOpenSdoMode::Auto && options_.blockThreshold > 0);
+    return Run(transfer);
+}
+
+CanOpenSdoResult CanOpenClient::SdoDownload(BYTE nodeId, UINT index, BYTE subIndex, const std::vector<BYTE>& data,
+                                            CanOpenSdoMode mode) {
+    auto transfer = std::make_shared<SdoTransfer>();
+    transfer->upload = false;
+    transfer->nodeId = nodeId;
+    transfer->index = index;
+    transfer->subIndex = subIndex;
+    transfer->mode = mode;
+    transfer->data = data;
+    transfer->block = !data.empty() && (mode == CanOpenSdoMode::Block ||
+        (mode == CanOpenSdoMode::Auto && options_.blockThreshold > 0 && data.size() >= options_.blockThreshold));
+    return Run(transfer);
+}
+
+CanOpenSdoResult CanOpenClient::Run(const std::shared_ptr<SdoTransfer>& transfer) {
+    CanOpenSdoResult result;
+    if (transfer->nodeId < 1 || transfer->nodeId > MAX_NODE_ID) {
+        result.error = "invalid node id";
+        return result;
+    }
+
+    std::unique_lock<std::mutex> lock(sdoMutex_);
+    sdoCv_.wait(lock, [&] { return closed_ || transfers_.find(transfer->nodeId) == transfers_.end(); });
+    if (closed_) {
+        result.error = "client closed";
+        return result;
+    }
+
+    transfers_[transfer->nodeId] = transfer;
+    transfer->startedAt = Clock::now();
+    StartTransfer(*transfer);
+
+    // 接收线程每收到一帧响应都会推迟截止时间
+    while (!transfer->done) {
+        if (sdoCv_.wait_until(lock, transfer->deadline) == std::cv_status::timeout &&
+            !transfer->done && Clock::now() >= transfer->deadline) {
+            {
+                std::lock_guard<std::mutex> statsLock(mutex_);
+                stats_.sdoTimeouts++;
+            }
+            transfer->result.timeout = true;
+            Abort(*transfer, ABORT_TIMEOUT, "SDO timeout");
+        }
+    }
+    transfers_.erase(transfer->nodeId);
+    sdoCv_.notify_all();
+    return transfer->result;
+}
+
+void CanOpenClient::StartTransfer(SdoTransfer& transfer) {
+    BYTE request[SDO_FRAME_SIZE] = {0};
+    request[1] = static_cast<BYTE>(transfer.index);
+    request[2] = static_cast<BYTE>(transfer.index >> 8);
+    request[3] = transfer.subIndex;
+    transfer.deadline = Clock::now() + std::chrono::milliseconds(options_.sdoTimeoutMs);
+    transfer.offset = 0;
+    transfer.toggle = 0;
+    transfer.expedited = false;
+
+    if (transfer.upload) {
+        transfer.data.clear();
+        if (transfer.block) {
+            request[0] = CCS_BLOCK_UPLOAD | BLOCK_CRC | BLOCK_INITIATE;
+            request[4] = std::min<BYTE>(std::max<BYTE>(options_.blockSize, 1), MAX_BLOCK_SIZE);
+            request[5] = static_cast<BYTE>(std::min<UINT>(options_.blockThreshold, 0xFF));
+            transfer.phase = SdoTransfer::Phase::BlockInitiate;
+        } else {
+            request[0] = CCS_INITIATE_UPLOAD;
+            transfer.phase = SdoTransfer::Phase::Initiate;
+        }
+    } else {
+        const size_t size = transfer.data.size();
+        if (transfer.block) {
+            request[0] = CCS_BLOCK_DOWNLOAD | BLOCK_CRC | BLOCK_SIZE_INDICATED | BLOCK_INITIATE;
+            PutDword(request + 4, static_cast<uint32_t>(size));
+            transfer.phase = SdoTransfer::Phase::BlockInitiate;
+        } else if (size >= 1 && size <= 4) {
+            // 加速下载：e=1, s=1, n=4-长度
+            request[0] = static_cast<BYTE>(CCS_INITIATE_DOWNLOAD | ((4 - size) << 2) | 0x03);
+            memcpy(request + 4, transfer.data.data(), size);
+            transfer.expedited = true;
+            transfer.phase = SdoTransfer::Phase::Initiate;
+        } else {
+            request[0] = CCS_INITIATE_DOWNLOAD | 0x01;
+            PutDword(request + 4, static_cast<uint32_t>(size));
+            transfer.phase = SdoTransfer::Phase::Initiate;
+        }
+    }
+
+    if (!TransmitSdo(transfer, request)) {
+        Complete(transfer, "transmit failed");
+    }
+}
+
+void CanOpenClient::SendSegment(SdoTransfer& transfer) {
+    BYTE request[SDO_FRAME_SIZE] = {0};
+    if (transfer.upload) {
+        request[0] = static_cast<BYTE>(CCS_UPLOAD_SEGMENT | (transfer.toggle << 4));
+    } else {
+        const size_t remaining = transfer.data.size() - transfer.offset;
+        transfer.segmentBytes = std::min(remaining, SEGMENT_SIZE);
+        const bool last = transfer.segmentBytes == remaining;
+        request[0] = static_cast<BYTE>(CCS_DOWNLOAD_SEGMENT | (transfer.toggle << 4) |
+            ((SEGMENT_SIZE - transfer.segmentBytes) << 1) | (last ? 0x01 : 0x00));
+        memcpy(request + 1, transfer.data.data() + transfer.offset, transfer.segmentBytes);
+    }
+    if (!TransmitSdo(transfer, request)) {
+        Abort(transfer, ABORT_GENERAL, "transmit failed");
+    }
+}
+
+void CanOpenClient::SendBlock(SdoTransfer& transfer) {
+    const size_t size = transfer.data.size();
+    transfer.blockStart = transfer.offset;
+
+    std::vector<ZCAN_Transmit_Data> frames;
+    frames.reserve(transfer.blockSize);
+    size_t position = transfer.offset;
+    while (frames.size() < transfer.blockSize && position < size) {
+        const size_t n = std::min(size - position, SEGMENT_SIZE);
+        ZCAN_Transmit_Data frame;
+        memset(&frame, 0, sizeof(frame));
+        frame.frame.can_id = COB_SDO_RX + transfer.nodeId;
+        frame.frame.can_dlc = SDO_FRAME_SIZE;
+        frame.frame.data[0] = static_cast<BYTE>(frames.size() + 1);
+        if (position + n >= size) {
+            frame.frame.data[0] |= BLOCK_LAST_SEGMENT;
+        }
+        memcpy(frame.frame.data + 1, transfer.data.data() + position, n);
+        frames.push_back(frame);
+        position += n;
+    }
+    transfer.sequence = static_cast<BYTE>(frames.size());
+
+    // 整块一次交给驱动；发送缓冲满时在超时内继续提交剩余的段
+    const UINT total = static_cast<UINT>(frames.size());
+    UINT sent = 0;
+    const auto giveUp = Clock::now() + std::chrono::milliseconds(options_.sdoTimeoutMs);
+    while (sent < total) {
+        sent += ZcanTransmit(channelHandle_.load(), frames.data() + sent, total - sent);
+        if (sent < total) {
+            if (Clock::now() >= giveUp) {
+                Abort(transfer, ABORT_GENERAL, "transmit failed");
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+
+void CanOpenClient::Abort(SdoTransfer& transfer, uint32_t abortCode, const std::string& error) {
+    BYTE request[SDO_FRAME_SIZE] = {0};
+    request[0] = CS_ABORT;
+    request[1] = static_cast<BYTE>(transfer.index);
+    request[2] = static_cast<BYTE>(transfer.index >> 8);
+    request[3] = transfer.subIndex;
+    PutDword(request + 4, abortCode);
+    TransmitSdo(transfer, request);
+    transfer.result.abortCode = abortCode;
+    Complete(transfer, error.c_str());
+}
+
+void CanOpenClient::Complete(SdoTransfer& transfer, const char* error) {
+    CanOpenSdoResult& result = transfer.result;
+    result.success = error == nullptr;
+    if (error) {
+        result.error = error;
+    }
+    result.durationUs = ElapsedUs(transfer.startedAt, Clock::now());
+    if (transfer.upload && result.success) {
+        result.data = std::move(transfer.data);
+    }
+    transfer.done = true;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.sdoTransfers++;
+        if (!result.success) {
+            stats_.sdoErrors++;
+        } else {
+            const size_t bytes = transfer.upload ? result.data.size() : transfer.data.size();
+            stats_.sdoBytes += bytes;
+            stats_.lastSdoUs = result.durationUs;
+            stats_.lastSdoBytesPerSec = result.durationUs > 0 ? bytes * 1e6 / result.durationUs : 0;
+        }
+    }
+    sdoCv_.notify_all();
+}
+
+void CanOpenClient::HandleSdo(SdoTransfer& transfer, const BYTE* data) {
+    transfer.deadline = Clock::now() + std::chrono::milliseconds(options_.sdoTimeoutMs);
+
+    // 块上传数据段的序号从1开始，0x80只可能是中止
+    if (data[0] == CS_ABORT) {
+        const uint32_t code = GetDword(data + 4);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.sdoAborts++;
+        }
+        if (transfer.mode == CanOpenSdoMode::Auto && transfer.block &&
+            transfer.phase == SdoTransfer::Phase::BlockInitiate && code == ABORT_COMMAND) {
+            // 从站不支持块传输，以普通方式重新发起
+            transfer.block = false;
+            StartTransfer(transfer);
+            return;
+        }
+        transfer.result.abortCode = code;
+        Complete(transfer, AbortMessage(code).c_str());
+        return;
+    }
+
+    if (transfer.block) {
+        if (transfer.upload) {
+            HandleBlockUpload(transfer, data);
+        } else {
+            HandleBlockDownload(transfer, data);
+        }
+    } else if (transfer.upload) {
+        HandleUpload(transfer, data);
+    } else {
+        HandleDownload(transfer, data);
+    }
+}
+
+namespace {
+
+bool MatchesObject(UINT index, BYTE subIndex, const BYTE* data) {
+    return (data[1] | (static_cast<UINT>(data[2]) << 8)) == index && data[3] == subIndex;
+}
+
+}  // namespace
+
+void CanOpenClient::HandleUpload(SdoTransfer& transfer, const BYTE* data) {
+    const BYTE command = data[0];
+
+    if (transfer.phase == SdoTransfer::Phase::Initiate) {
+        if ((command & SCS_MASK) != SCS_INITIATE_UPLOAD || !MatchesObject(transfer.index, transfer.subIndex, data)) {
+            Abort(transfer, ABORT_COMMAND, "unexpected SDO response");
+            return;
+        }
+        if (command & 0x02) {
+            // 加速上传，s=1时n为不含数据的字节数
+            const size_t unused = (command & 0x01) ? (command >> 2) & 0x03 : 0;
+            transfer.data.assign(data + 4, data + SDO_FRAME_SIZE - unused);
+            transfer.result.transfer = CanOpenSdoResult::Transfer::Expedited;
+            Complete(transfer, nullptr);
+            return;
+        }
+        if (command & 0x01) {
+            transfer.size = GetDword(data + 4);
+            transfer.sizeIndicated = true;
+            if (transfer.size > options_.maxUploadSize) {
+                Abort(transfer, ABORT_OUT_OF_MEMORY, "object too large");
+                return;
+            }
+            transfer.data.reserve(transfer.size);
+        }
+        transfer.result.transfer = CanOpenSdoResult::Transfer::Segmented;
+        transfer.phase = SdoTransfer::Phase::Segment;
+        SendSegment(transfer);
+        return;
+    }
+
+    if ((command & SCS_MASK) != SCS_UPLOAD_SEGMENT) {
+        Abort(transfer, ABORT_COMMAND, "unexpected SDO response");
+        return;
+    }
+    if (((command >> 4) & 0x01) != transfer.toggle) {
+        Abort(transfer, ABORT_TOGGLE, "toggle bit not alternated");
+        return;
+    }
+    const size_t unused = (command >> 1) & 0x07;
+    transfer.data.insert(transfer.data.end(), data + 1, data + SDO_FRAME_SIZE - unused);
+    if (transfer.data.size() > options_.maxUploadSize) {
+        Abort(transfer, ABORT_OUT_OF_MEMORY, "object too large");
+        return;
+    }
+    if (command & 0x01) {
+        if (transfer.sizeIndicated && transfer.data.size() != transfer.size) {
+            Abort(transfer, ABORT_LENGTH, "uploaded size does not match indicated size");
+            return;
+        }
+        Complete(transfer, nullptr);
+        return;
+    }
+    transfer.toggle ^= 1;
+    SendSegment(transfer);
+}
+
+void CanOpenClient::HandleDownload(SdoTransfer& transfer, const BYTE* data) {
+    const BYTE command = data[0];
+
+    if (transfer.phase == SdoTransfer::Phase::Initiate) {
+        if ((command & SCS_MASK) != SCS_INITIATE_DOWNLOAD || !MatchesObject(transfer.index, transfer.subIndex, data)) {
+            Abort(transfer, ABORT_COMMAND, "unexpected SDO response");
+            return;
+        }
+        if (transfer.expedited) {
+            transfer.result.transfer = CanOpenSdoResult::Transfer::Expedited;
+            Complete(transfer, nullptr);
+            return;
+        }
+        transfer.result.transfer = CanOpenSdoResult::Transfer::Segmented;
+        transfer.phase = SdoTransfer::Phase::Segment;
+        SendSegment(transfer);
+        return;
+    }
+
+    if ((command & SCS_MASK) != SCS_DOWNLOAD_SEGMENT) {
+        Abort(transfer, ABORT_COMMAND, "unexpected SDO response");
+        return;
+    }
+    if (((command >> 4) & 0x01) != transfer.toggle) {
+        Abort(transfer, ABORT_TOGGLE, "toggle bit not alternated");
+        return;
+    }
+    transfer.offset += transfer.segmentBytes;
+    if (transfer.offset >= transfer.data.size()) {
+        Complete(transfer, nullptr);
+        return;
+    }
+    transfer.toggle ^= 1;
+    SendSegment(transfer);
+}
+
+void CanOpenClient::HandleBlockUpload(SdoTransfer& transfer, const BYTE* data) {
+    const BYTE command = data[0];
+    BYTE request[SDO_FRAME_SIZE] = {0};
+
+    switch (transfer.phase) {
+        case SdoTransfer::Phase::BlockInitiate: {
+            if ((command & SCS_MASK) == SCS_INITIATE_UPLOAD) {
+                // 对象不超过协议切换阈值，从站改用普通上传
+                transfer.block = false;
+                transfer.phase = SdoTransfer::Phase::Initiate;
+                HandleUpload(transfer, data);
+                return;
+            }
+            if ((command & BLOCK_UPLOAD_SUBCOMMAND_MASK) != (SCS_BLOCK_UPLOAD | BLOCK_INITIATE) ||
+                !MatchesObject(transfer.index, transfer.subIndex, data)) {
+                Abort(transfer, ABORT_COMMAND, "unexpected SDO response");
+                return;
+            }
+            transfer.crc = (command & BLOCK_CRC) != 0;
+            if (command & BLOCK_SIZE_INDICATED) {
+                transfer.size = GetDword(data + 4);
+                transfer.sizeIndicated = true;
+                if (transfer.size > options_.maxUploadSize) {
+                    Abort(transfer, ABORT_OUT_OF_MEMORY, "object too large");
+                    return;
+                }
+                transfer.data.reserve(transfer.size + SEGMENT_SIZE);
+            }
+            transfer.result.transfer = CanOpenSdoResult::Transfer::Block;
+            transfer.blockSize = std::min<BYTE>(std::max<BYTE>(options_.blockSize, 1), MAX_BLOCK_SIZE);
+            transfer.sequence = 0;
+            transfer.lastReceived = false;
+            transfer.phase = SdoTransfer::Phase::BlockData;
+            request[0] = CCS_BLOCK_UPLOAD | BLOCK_START;
+            if (!TransmitSdo(transfer, request)) {
+                Abort(transfer, ABORT_GENERAL, "transmit failed");
+            }
+            return;
+        }
+
+        case SdoTransfer::Phase::BlockData: {
+            const BYTE sequence = command & 0x7F;
+            const bool last = (command & BLOCK_LAST_SEGMENT) != 0;
+            if (sequence == transfer.sequence + 1) {
+                transfer.sequence = sequence;
+                transfer.data.insert(transfer.data.end(), data + 1, data + SDO_FRAME_SIZE);
+                transfer.lastReceived = last;
+                if (transfer.data.size() > options_.maxUploadSize + SEGMENT_SIZE) {
+                    Abort(transfer, ABORT_OUT_OF_MEMORY, "object too large");
+                    return;
+                }
+            } else {
+                // 丢失或乱序的段丢弃，确认中的序号让从站从第一个缺失的段重发
+                std::lock_guard<std::mutex> lock(mutex_);
+                stats_.blockRetransmits++;
+            }
+            if (!last && sequence < transfer.blockSize) {
+                return;
+            }
+            request[0] = CCS_BLOCK_UPLOAD | BLOCK_ACK;
+            request[1] = transfer.sequence;
+            request[2] = transfer.blockSize;
+            transfer.sequence = 0;
+            if (transfer.lastReceived) {
+                transfer.phase = SdoTransfer::Phase::BlockEnd;
+            }
+            if (!TransmitSdo(transfer, request)) {
+                Abort(transfer, ABORT_GENERAL, "transmit failed");
+            }
+            return;
+        }
+
+        case SdoTransfer::Phase::BlockEnd: {
+            if ((command & BLOCK_UPLOAD_SUBCOMMAND_MASK) != (SCS_BLOCK_UPLOAD | BLOCK_END)) {
+                Abort(transfer, ABORT_COMMAND, "unexpected SDO response");
+                return;
+            }
+            // 最后一段中不含数据的字节数
+            const size_t unused = std::min<size_t>((command >> 2) & 0x07, transfer.data.size());
+            transfer.data.resize(transfer.data.size() - unused);
+            if (transfer.sizeIndicated && transfer.data.size() != transfer.size) {
+                Abort(transfer, ABORT_LENGTH, "uploaded size does not match indicated size");
+                return;
+            }
+            if (transfer.crc) {
+                const uint16_t expected = static_cast<uint16_t>(data[1] | (data[2] << 8));
+                if (Crc16(transfer.data.data(), transfer.data.size()) != expected) {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        stats_.crcErrors++;
+                    }
+                    Abort(transfer, ABORT_CRC, "CRC error");
+                    return;
+                }
+            }
+            request[0] = CCS_BLOCK_UPLOAD | BLOCK_END;
+            TransmitSdo(transfer, request);
+            Complete(transfer, nullptr);
+            return;
+        }
+
+        default:
+            Abort(transfer, ABORT_COMMAND, "unexpected SDO response");
+            return;
+    }
+}
+
+void CanOpenClient::HandleBlockDownload(SdoTransfer& transfer, const BYTE* data) {
+    const BYTE command = data[0];
+    const size_t size = transfer.data.size();
+
+    switch (transfer.phase) {
+        case SdoTransfer::Phase::BlockInitiate: {
+            if ((command & BLOCK_SUBCOMMAND_MASK) != (SCS_BLOCK_DOWNLOAD | BLOCK_INITIATE) ||
+                !MatchesObject(transfer.index, transfer.subIndex, data)) {
+                Abort(transfer, ABORT_COMMAND, "unexpected SDO response");
+                return;
+            }
+            if (data[4] == 0 || data[4] > MAX_BLOCK_SIZE) {
+                Abort(transfer, ABORT_BLOCK_SIZE, "invalid block size");
+                return;
+            }
+            transfer.crc = (command & BLOCK_CRC) != 0;
+            transfer.blockSize = data[4];
+            transfer.result.transfer = CanOpenSdoResult::Transfer::Block;
+            transfer.phase = SdoTransfer::Phase::BlockData;
+            SendBlock(transfer);
+            return;
+        }
+
+        case SdoTransfer::Phase::BlockData: {
+            if ((command & BLOCK_SUBCOMMAND_MASK) != (SCS_BLOCK_DOWNLOAD | BLOCK_ACK)) {
+                Abort(transfer, ABORT_COMMAND, "unexpected SDO response");
+                return;
+            }
+            const BYTE acknowledged = data[1];
+            if (acknowledged > transfer.sequence) {
+                Abort(transfer, ABORT_SEQUENCE, "invalid sequence number");
+                return;
+            }
+            if (data[2] == 0 || data[2] > MAX_BLOCK_SIZE) {
+                Abort(transfer, ABORT_BLOCK_SIZE, "invalid block size");
+                return;
+            }
+            if (acknowledged < transfer.sequence) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stats_.blockRetransmits += transfer.sequence - acknowledged;
+            }
+            transfer.offset = std::min(size, transfer.blockStart + acknowledged * SEGMENT_SIZE);
+            transfer.blockSize = data[2];
+            if (transfer.offset < size) {
+                SendBlock(transfer);
+                return;
+            }
+
+            // 全部段已确认，结束时带上最后一段中不含数据的字节数和CRC
+            BYTE request[SDO_FRAME_SIZE] = {0};
+            const size_t tail = size % SEGMENT_SIZE;
+            const size_t unused = tail == 0 ? 0 : SEGMENT_SIZE - tail;
+            const uint16_t crc = transfer.crc ? Crc16(transfer.data.data(), size) : 0;
+            request[0] = static_cast<BYTE>(CCS_BLOCK_DOWNLOAD | (unused << 2) | BLOCK_END);
+            request[1] = static_cast<BYTE>(crc);
+            request[2] = static_cast<BYTE>(crc >> 8);
+            transfer.phase = SdoTransfer::Phase::BlockEnd;
+            if (!TransmitSdo(transfer, request)) {
+                Abort(transfer, ABORT_GENERAL, "transmit failed");
+            }
+            return;
+        }
+
+        case SdoTransfer::Phase::BlockEnd: {
+            if ((command & BLOCK_SUBCOMMAND_MASK) != (SCS_BLOCK_DOWNLOAD | BLOCK_END)) {
+                Abort(transfer, ABORT_COMMAND, "unexpected SDO response");
+                return;
+            }
+            Complete(transfer, nullptr);
+            return;
+        }
+
+        default:
+            Abort(transfer, ABORT_COMMAND, "unexpected SDO response");
+            return;
+    }
+}
+
+// ==================== PDO ====================
+
+bool CanOpenClient::SetPdoMappings(const std::vector<CanOpenPdoConfig>& pdos, std::string* error) {
+    std::vector<std::unique_ptr<PdoPlan>> plans;
+    std::array<int16_t, 0x800> byCobId;
+    byCobId.fill(-1);
+
+    for (size_t i = 0; i < pdos.size(); i++) {
+        const CanOpenPdoConfig& config = pdos[i];
+        if (config.cobId == 0 || config.cobId > CAN_SFF_MASK) {
+            *error = "PDO的COB-ID必须为11位标准帧ID";
+            return false;
+        }
+        if (byCobId[config.cobId] >= 0) {
+            *error = "PDO的COB-ID重复";
+            return false;
+        }
+        if (config.entries.empty()) {
+            *error = "PDO需要至少一个映射项";
+            return false;
+        }
+
+        std::unique_ptr<PdoPlan> plan(new PdoPlan());
+        plan->index = static_cast<UINT>(i);
+        plan->config = std::make_shared<const CanOpenPdoConfig>(config);
+        UINT bitOffset = 0;
+        for (const auto& entry : config.entries) {
+            const size_t typeBits = TypeBits(entry.type);
+            const size_t bits = entry.bitLength == 0 ? typeBits : entry.bitLength;
+            const bool isFloat = entry.type == CanOpenDataType::F32 || entry.type == CanOpenDataType::F64;
+            if (bits > typeBits || (isFloat && bits != typeBits)) {
+                *error = "映射项" + entry.name + "的位长与类型不符";
+                return false;
+            }
+            if (bitOffset + bits > 64) {
+                *error = "PDO映射超过8字节";
+                return false;
+            }
+            PdoPlan::Step step;
+            step.shift = static_cast<uint8_t>(bitOffset);
+            step.bits = static_cast<uint8_t>(bits);
+            step.type = entry.type;
+            step.mask = bits == 64 ? ~0ULL : ((1ULL << bits) - 1);
+            plan->steps.push_back(step);
+            bitOffset += static_cast<UINT>(bits);
+        }
+        plan->minLength = (bitOffset + 7) / 8;
+        plan->last.assign(plan->steps.size(), 0);
+        byCobId[config.cobId] = static_cast<int16_t>(i);
+        plans.push_back(std::move(plan));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pdos_.swap(plans);
+    pdoByCobId_ = byCobId;
+    return true;
+}
+
+namespace {
+
+double DecodePdoValue(CanOpenDataType type, uint8_t bits, uint64_t raw) {
+    if (type == CanOpenDataType::F32) {
+        const uint32_t word = static_cast<uint32_t>(raw);
+        float value;
+        memcpy(&value, &word, sizeof(value));
+        return value;
+    }
+    if (type == CanOpenDataType::F64) {
+        double value;
+        memcpy(&value, &raw, sizeof(value));
+        return value;
+    }
+    if (IsSigned(type) && bits < 64) {
+        // 按映射位宽做符号扩展
+        const uint8_t unused = static_cast<uint8_t>(64 - bits);
+        return static_cast<double>(static_cast<int64_t>(raw << unused) >> unused);
+    }
+    return IsSigned(type) ? static_cast<double>(static_cast<int64_t>(raw)) : static_cast<double>(raw);
+}
+
+}  // namespace
+
+void CanOpenClient::HandlePdo(PdoPlan& plan, const ZCAN_ReceiveFD_Data& frame) {
+    stats_.pdoFrames++;
+    const UINT length = std::min<UINT>(frame.frame.len, CAN_MAX_DLEN);
+    if (length < plan.minLength) {
+        stats_.pdoLengthErrors++;
+        return;
+    }
+
+    // 数据域按小端装入一个64位字，各映射项只需移位和掩码
+    uint64_t raw = 0;
+    for (UINT i = 0; i < length; i++) {
+        raw |= static_cast<uint64_t>(frame.frame.data[i]) << (8 * i);
+    }
+
+    CanOpenEvent event;
+    for (size_t i = 0; i < plan.steps.size(); i++) {
+        const PdoPlan::Step& step = plan.steps[i];
+        const uint64_t value = (raw >> step.shift) & step.mask;
+        if (options_.changesOnly && plan.valid && plan.last[i] == value) {
+            continue;
+        }
+        plan.last[i] = value;
+        event.values.emplace_back(static_cast<UINT>(i), DecodePdoValue(step.type, step.bits, value));
+    }
+    plan.valid = true;
+    if (event.values.empty()) {
+        stats_.pdoUnchanged++;
+        return;
+    }
+
+    event.type = CanOpenEvent::Type::Pdo;
+    event.nodeId = static_cast<BYTE>(plan.config->cobId & NODE_ID_MASK);
+    event.timestamp = frame.timestamp;
+    event.pdoIndex = plan.index;
+    event.pdo = plan.config;
+    stats_.pdoValues += event.values.size();
+    Deliver(std::move(event));
+}
+
+// ==================== NMT/心跳/紧急报文 ====================
+
+void CanOpenClient::HandleHeartbeat(BYTE nodeId, const ZCAN_ReceiveFD_Data& frame) {
+    if (frame.frame.len < 1) {
+        return;
+    }
+    stats_.heartbeats++;
+    NodeMonitor& node = *nodes_[nodeId];
+    const BYTE state = frame.frame.data[0] & 0x7F;
+    // 启动报文（状态0）每次都上报，节点重启后状态可能与之前相同
+    if (state != node.state || node.lost || state == 0) {
+        CanOpenEvent event;
+        event.type = CanOpenEvent::Type::NodeState;
+        event.nodeId = nodeId;
+        event.timestamp = frame.timestamp;
+        event.state = state;
+        event.previousState = node.lost ? 0xFF : node.state;
+        Deliver(std::move(event));
+    }
+    node.state = state;
+    node.lost = false;
+    node.lastSeen = Clock::now();
+    node.lastTimestamp = frame.timestamp;
+}
+
+void CanOpenClient::HandleEmergency(BYTE nodeId, const ZCAN_ReceiveFD_Data& frame) {
+    const UINT length = std::min<UINT>(frame.frame.len, CAN_MAX_DLEN);
+    if (length < 3) {
+        return;
+    }
+    stats_.emergencies++;
+    CanOpenEvent event;
+    event.type = CanOpenEvent::Type::Emergency;
+    event.nodeId = nodeId;
+    event.timestamp = frame.timestamp;
+    event.errorCode = frame.frame.data[0] | (static_cast<UINT>(frame.frame.data[1]) << 8);
+    event.errorRegister = frame.frame.data[2];
+    event.data.assign(frame.frame.data + 3, frame.frame.data + length);
+    Deliver(std::move(event));
+}
+
+void CanOpenClient::Deliver(CanOpenEvent&& event) {
+    pending_.push_back(std::move(event));
+    stats_.events++;
+    if (pending_.size() >= std::max<UINT>(options_.maxBatch, 1)) {
+        Flush();
+    }
+}
+
+void CanOpenClient::Flush() {
+    if (pending_.empty()) {
+        return;
+    }
+    std::vector<CanOpenEvent> batch;
+    batch.swap(pending_);
+    stats_.batches++;
+    if (callback_) {
+        callback_(std::move(batch));
+    }
+}
+
+bool CanOpenClient::OnFrame(const ZCAN_ReceiveFD_Data& frame, bool fd) {
+    // 只处理标准数据帧；本端发送的回显帧忽略
+    const UINT canId = frame.frame.can_id;
+    if ((frame.frame.flags & TX_ECHO_FLAG) || (canId & (CAN_EFF_FLAG | CAN_RTR_FLAG | CAN_ERR_FLAG))) {
+        return false;
+    }
+    const UINT cobId = canId & CAN_SFF_MASK;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const int16_t pdo = pdoByCobId_[cobId];
+        if (pdo >= 0) {
+            HandlePdo(*pdos_[pdo], frame);
+            return true;
+        }
+    }
+
+    const BYTE nodeId = static_cast<BYTE>(cobId & NODE_ID_MASK);
+    if (nodeId == 0) {
+        return false;
+    }
+    switch (cobId & FUNCTION_MASK) {
+        case COB_SDO_TX: {
+            std::lock_guard<std::mutex> lock(sdoMutex_);
+            auto it = transfers_.find(nodeId);
+            if (it == transfers_.end() || it->second->done) {
+                return false;
+            }
+            BYTE data[SDO_FRAME_SIZE] = {0};
+            memcpy(data, frame.frame.data, std::min<size_t>(frame.frame.len, SDO_FRAME_SIZE));
+            HandleSdo(*it->second, data);
+            return true;
+        }
+        case COB_HEARTBEAT: {
+            std::lock_guard<std::mutex> lock(mutex_);
+            HandleHeartbeat(nodeId, frame);
+            return true;
+        }
+        case COB_EMCY: {
+            std::lock_guard<std::mutex> lock(mutex_);
+            HandleEmergency(nodeId, frame);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+void CanOpenClient::OnTick(std::chrono::steady_clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (BYTE nodeId = 1; nodeId <= MAX_NODE_ID; nodeId++) {
+        NodeMonitor& node = *nodes_[nodeId];
+        if (node.timeoutMs == 0 || node.lost || now - node.lastSeen < std::chrono::milliseconds(node.timeoutMs)) {
+            continue;
+        }
+        node.lost = true;
+        stats_.heartbeatsLost++;
+        CanOpenEvent event;
+        event.type = CanOpenEvent::Type::HeartbeatLost;
+        event.nodeId = nodeId;
+        event.timestamp = node.lastTimestamp;
+        event.previousState = node.state;
+        Deliver(std::move(event));
+    }
+    Flush();
+}
@@ -0,0 +1,205 @@
+#ifndef ZLGCAN_CANOPEN_CLIENT_H_
+#define ZLGCAN_CANOPEN_CLIENT_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "zlgcan.h"
+#include "receive_pump.h"
+
+// 心跳消费者：超过timeoutMs未收到节点心跳时上报丢失
+struct CanOpenHeartbeatConsumer {
+    BYTE nodeId = 0;
+    UINT timeoutMs = 0;
+};
+
+// CANopen客户端配置
+struct CanOpenOptions {
+    UINT sdoTimeoutMs = 1000;          // SDO单帧响应超时
+    BYTE blockSize = 127;              // 块上传时本端的块大小（1~127）
+    UINT blockThreshold = 64;          // 自动模式下达到该长度时使用块传输，也作为块上传的协议切换阈值
+    UINT maxUploadSize = 1 << 20;      // 上传数据长度上限，超过时中止
+    bool changesOnly = true;           // PDO只上报变化的值
+    UINT maxBatch = 256;               // 单批最多的事件数，达到时立即上报
+    std::vector<CanOpenHeartbeatConsumer> heartbeats;
+};
+
+// PDO映射项的数据类型
+enum class CanOpenDataType : uint8_t { U8, I8, U16, I16, U32, I32, U64, I64, F32, F64 };
+
+// PDO映射项，按顺序从数据域最低位开始紧密排列
+struct CanOpenPdoEntry {
+    std::string name;
+    CanOpenDataType type = CanOpenDataType::U8;
+    BYTE bitLength = 0;                // 0表示类型的完整位宽
+};
+
+struct CanOpenPdoConfig {
+    UINT cobId = 0;                    // 11位COB-ID
+    std::vector<CanOpenPdoEntry> entries;
+};
+
+// SDO传输方式
+enum class CanOpenSdoMode : uint8_t {
+    Auto,                              // 按长度选择，从站不支持块传输时回退到分段传输
+    Segmented,                         // 加速或分段传输
+    Block,
+};
+
+// SDO结果
+struct CanOpenSdoResult {
+    enum class Transfer : uint8_t { Expedited, Segmented, Block };
+
+    bool success = false;
+    std::string error;
+    uint32_t abortCode = 0;            // 收到或发出的中止码，0表示无中止
+    bool timeout = false;
+    Transfer transfer = Transfer::Expedited;
+    std::vector<BYTE> data;            // 上传的数据
+    uint64_t durationUs = 0;
+};
+
+// 事件（PDO值变化、节点状态、心跳丢失、紧急报文）
+struct CanOpenEvent {
+    enum class Type : uint8_t { Pdo, NodeState, HeartbeatLost, Emergency };
+
+    Type type = Type::Pdo;
+    BYTE nodeId = 0;
+    uint64_t timestamp = 0;            // 设备时间戳(us)；心跳丢失为最后一次心跳的时间戳
+
+    // Pdo：变化的映射项序号和值（64位整数超过2^53时有精度损失）
+    UINT pdoIndex = 0;
+    std::shared_ptr<const CanOpenPdoConfig> pdo;
+    std::vector<std::pair<UINT, double>> values;
+
+    // NodeState：NMT状态，0xFF表示未知
+    BYTE state = 0xFF;
+    BYTE previousState = 0xFF;
+
+    // Emergency
+    UINT errorCode = 0;
+    BYTE errorRegister = 0;
+    std::vector<BYTE> data;
+};
+
+// CANopen统计
+struct CanOpenStats {
+    uint64_t sdoTransfers = 0;
+    uint64_t sdoErrors = 0;
+    uint64_t sdoTimeouts = 0;
+    uint64_t sdoAborts = 0;            // 从站发出的中止
+    uint64_t sdoBytes = 0;
+    uint64_t blockRetransmits = 0;     // 块传输中重发或丢弃的段数
+    uint64_t crcErrors = 0;
+    uint64_t lastSdoUs = 0;
+    double lastSdoBytesPerSec = 0;
+    uint64_t pdoFrames = 0;
+    uint64_t pdoValues = 0;            // 上报的映射项值数
+    uint64_t pdoUnchanged = 0;         // 无变化而未上报的帧数
+    uint64_t pdoLengthErrors = 0;      // 长度小于映射长度而丢弃的帧数
+    uint64_t heartbeats = 0;
+    uint64_t heartbeatsLost = 0;
+    uint64_t emergencies = 0;
+    uint64_t events = 0;
+    uint64_t batches = 0;
+};
+
+/**
+ * CANopen客户端（CiA 301）
+ * 作为接收线程的监听者运行：SDO的分段和块传输在接收线程中按响应立即推进，
+ * 块下载的一个块以一次ZCAN_Transmit批量发出，块传输以CRC校验；
+ * 心跳和紧急报文在接收线程中解析，配置的PDO按编译好的提取计划解码，
+ * 默认只上报变化的值。事件在每轮轮询末尾整批交给回调（在接收线程中执行）。
+ * SDO请求为阻塞调用，应在工作线程中执行；同一节点的请求依次执行。
+ */
+class CanOpenClient : public FrameListener {
+public:
+    using BatchCallback = std::function<void(std::vector<CanOpenEvent>&& events)>;
+
+    CanOpenClient(CHANNEL_HANDLE channelHandle, const CanOpenOptions& options, BatchCallback callback);
+    ~CanOpenClient() override;
+
+    CanOpenClient(const CanOpenClient&) = delete;
+    CanOpenClient& operator=(const CanOpenClient&) = delete;
+
+    CanOpenSdoResult SdoUpload(BYTE nodeId, UINT index, BYTE subIndex, CanOpenSdoMode mode);
+    CanOpenSdoResult SdoDownload(BYTE nodeId, UINT index, BYTE subIndex, const std::vector<BYTE>& data,
+                                 CanOpenSdoMode mode);
+
+    // 发送NMT命令，nodeId为0时发往全部节点
+    bool SendNmt(BYTE command, BYTE nodeId);
+
+    /**
+     * 替换PDO映射表
+     * 每个PDO编译为按位移和掩码提取的计划，并清除已记录的值
+     * @return 映射无效时返回false并设置error
+     */
+    bool SetPdoMappings(const std::vector<CanOpenPdoConfig>& pdos, std::string* error);
+
+    // 结束进行中的SDO请求，之后的请求直接返回失败
+    void Close();
+
+    CanOpenStats Stats() const;
+
+    void SetChannelHandle(CHANNEL_HANDLE channelHandle) { channelHandle_.store(channelHandle); }
+
+    bool OnFrame(const ZCAN_ReceiveFD_Data& frame, bool fd) override;
+    void OnTick(std::chrono::steady_clock::time_point now) override;
+
+    static size_t TypeBits(CanOpenDataType type);
+    static uint16_t Crc16(const BYTE* data, size_t length, uint16_t crc = 0);
+
+private:
+    struct SdoTransfer;
+    struct PdoPlan;
+    struct NodeMonitor;
+
+    CanOpenSdoResult Run(const std::shared_ptr<SdoTransfer>& transfer);
+    bool TransmitFrame(UINT canId, const BYTE* data, UINT len);
+    bool TransmitSdo(const SdoTransfer& transfer, const BYTE data[8]);
+    void StartTransfer(SdoTransfer& transfer);
+    void SendSegment(SdoTransfer& transfer);
+    void SendBlock(SdoTransfer& transfer);
+    void HandleSdo(SdoTransfer& transfer, const BYTE* data);
+    void HandleUpload(SdoTransfer& transfer, const BYTE* data);
+    void HandleDownload(SdoTransfer& transfer, const BYTE* data);
+    void HandleBlockUpload(SdoTransfer& transfer, const BYTE* data);
+    void HandleBlockDownload(SdoTransfer& transfer, const BYTE* data);
+    void Abort(SdoTransfer& transfer, uint32_t abortCode, const std::string& error);
+    void Complete(SdoTransfer& transfer, const char* error);
+
+    void HandlePdo(PdoPlan& plan, const ZCAN_ReceiveFD_Data& frame);
+    void HandleHeartbeat(BYTE nodeId, const ZCAN_ReceiveFD_Data& frame);
+    void HandleEmergency(BYTE nodeId, const ZCAN_ReceiveFD_Data& frame);
+    void Deliver(CanOpenEvent&& event);
+    void Flush();
+
+    std::atomic<CHANNEL_HANDLE> channelHandle_;
+    const CanOpenOptions options_;
+    const BatchCallback callback_;
+
+    // SDO传输，按节点号；接收线程推进状态并唤醒等待者
+    std::mutex sdoMutex_;
+    std::condition_variable sdoCv_;
+    std::map<BYTE, std::shared_ptr<SdoTransfer>> transfers_;
+    bool closed_ = false;
+
+    // PDO、心跳和待上报事件，接收线程持有
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<PdoPlan>> pdos_;
+    std::array<int16_t, 0x800> pdoByCobId_;     // COB-ID -> PDO序号，-1未配置
+    std::vector<std::unique_ptr<NodeMonitor>> nodes_;  // 按节点号，0未使用
+    std::vector<CanOpenEvent> pending_;
+    CanOpenStats stats_;
+};
+
+#endif  // ZLGCAN_CANOPEN_CLIENT_H_
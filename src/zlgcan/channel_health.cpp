@@ -0,0 +1,271 @@
+#include "channel_health.h"
+#include "zlgcan_api.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "thread_scheduling.h"
+
+namespace {
+
+// SJA1000兼容状态寄存器位
+constexpr BYTE SR_BUS_STATUS = 0x80;    // 总线关闭
+constexpr BYTE SR_ERROR_STATUS = 0x40;  // 错误计数达到告警限
+
+constexpr BYTE ERROR_WARNING_LIMIT = 96;
+constexpr BYTE ERROR_PASSIVE_LIMIT = 128;
+
+// 错误记录触发的提前采样之间的最小间隔，错误帧密集时不以总线速率读取驱动
+constexpr auto MIN_EARLY_POLL_INTERVAL = std::chrono::milliseconds(1);
+
+uint64_t NowMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+}  // namespace
+
+ChannelHealthMonitor::ChannelHealthMonitor(CHANNEL_HANDLE channelHandle, UINT channelIndex,
+                                           const HealthMonitorOptions& options, EventCallback callback)
+    : channelHandle_(channelHandle), channelIndex_(channelIndex), options_(options),
+      callback_(std::move(callback)) {
+}
+
+ChannelHealthMonitor::~ChannelHealthMonitor() {
+    Stop();
+}
+
+void ChannelHealthMonitor::Start() {
+    if (thread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopRequested_ = false;
+    }
+    thread_ = std::thread(&ChannelHealthMonitor::Run, this);
+}
+
+void ChannelHealthMonitor::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopRequested_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void ChannelHealthMonitor::OnErrorRecord(const ZCANErrorData& /*errData*/) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pollRequested_ = true;
+    }
+    cv_.notify_all();
+}
+
+UINT ChannelHealthMonitor::ReadErrInfo(ZCAN_CHANNEL_ERR_INFO* errInfo) {
+    CHANNEL_HANDLE handle;
+    {
+        std::lock_guard<std::mutex> lock(handleMutex_);
+        handle = channelHandle_;
+    }
+    std::lock_guard<std::mutex> lock(errInfoMutex_);
+    const UINT result = ReadDriverErrInfo(handle, errInfo);
+    *errInfo = cachedErrInfo_;
+    memset(&cachedErrInfo_, 0, sizeof(cachedErrInfo_));
+    return result == STATUS_OK || errInfo->error_code != 0 ? STATUS_OK : result;
+}
+
+// 读取驱动错误信息并并入缓存：错误码按位累积，被动错误和仲裁丢失数据取最近一次有错误时的值
+UINT ChannelHealthMonitor::ReadDriverErrInfo(CHANNEL_HANDLE handle, ZCAN_CHANNEL_ERR_INFO* errInfo) {
+    memset(errInfo, 0, sizeof(*errInfo));
+    const UINT result = ZcanReadChannelErrInfo(handle, errInfo);
+    if (result != STATUS_OK) {
+        errInfo->error_code = 0;
+    } else if (errInfo->error_code != 0) {
+        cachedErrInfo_.error_code |= errInfo->error_code;
+        memcpy(cachedErrInfo_.passive_ErrData, errInfo->passive_ErrData, sizeof(cachedErrInfo_.passive_ErrData));
+        cachedErrInfo_.arLost_ErrData = errInfo->arLost_ErrData;
+    }
+    return result;
+}
+
+void ChannelHealthMonitor::SetChannelHandle(CHANNEL_HANDLE channelHandle) {
+    std::lock_guard<std::mutex> lock(handleMutex_);
+    channelHandle_ = channelHandle;
+}
+
+BusState ChannelHealthMonitor::ClassifyState(const ZCAN_CHANNEL_STATUS& status, UINT errorCode) {
+    if ((errorCode & ZCAN_ERROR_CAN_BUSOFF) || (status.regStatus & SR_BUS_STATUS)) {
+        return BusState::BusOff;
+    }
+    if ((errorCode & ZCAN_ERROR_CAN_PASSIVE) ||
+        status.regTECounter >= ERROR_PASSIVE_LIMIT || status.regRECounter >= ERROR_PASSIVE_LIMIT) {
+        return BusState::Passive;
+    }
+    if ((errorCode & ZCAN_ERROR_CAN_ERRALARM) || (status.regStatus & SR_ERROR_STATUS) ||
+        status.regTECounter >= ERROR_WARNING_LIMIT || status.regRECounter >= ERROR_WARNING_LIMIT) {
+        return BusState::Warning;
+    }
+    return BusState::Active;
+}
+
+void ChannelHealthMonitor::Run() {
+    ThreadSchedulingScope scheduling(ThreadRole::Monitor);
+    const auto interval = std::chrono::milliseconds(std::max<UINT>(options_.pollIntervalMs, 1));
+    auto nextPollAt = std::chrono::steady_clock::now();
+    auto lastPollAt = nextPollAt - interval;
+
+    while (true) {
+        bool early = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait_until(lock, nextPollAt, [this] { return stopRequested_ || pollRequested_; });
+            if (stopRequested_) {
+                break;
+            }
+            early = pollRequested_;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= nextPollAt || (early && now >= lastPollAt + MIN_EARLY_POLL_INTERVAL)) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                pollRequested_ = false;
+            }
+            Poll();
+            lastPollAt = now;
+            nextPollAt = now + interval;
+        } else if (early) {
+            // 距上次采样不足最小间隔，推迟到满足间隔时采样
+            nextPollAt = std::min(nextPollAt, lastPollAt + MIN_EARLY_POLL_INTERVAL);
+            std::lock_guard<std::mutex> lock(mutex_);
+            pollRequested_ = false;
+        }
+
+        if (options_.autoRecover && state_.load() == BusState::BusOff) {
+            TryRecover();
+        }
+    }
+}
+
+void ChannelHealthMonitor::Poll() {
+    CHANNEL_HANDLE handle;
+    {
+        std::lock_guard<std::mutex> lock(handleMutex_);
+        handle = channelHandle_;
+    }
+
+    ZCAN_CHANNEL_STATUS status;
+    memset(&status, 0, sizeof(status));
+    if (ZcanReadChannelStatus(handle, &status) != STATUS_OK) {
+        return;
+    }
+
+    ZCAN_CHANNEL_ERR_INFO errInfo;
+    {
+        std::lock_guard<std::mutex> lock(errInfoMutex_);
+        ReadDriverErrInfo(handle, &errInfo);
+    }
+
+    Evaluate(ClassifyState(status, errInfo.error_code),
+             status.regRECounter, status.regTECounter, errInfo.error_code);
+}
+
+// 首次采样和状态恶化立即生效；好转须连续settlePolls次采样一致，错误计数在门限附近抖动时不反复报告
+void ChannelHealthMonitor::Evaluate(BusState next, BYTE rec, BYTE tec, UINT errorCode) {
+    const BusState prev = state_.load();
+    if (next == prev) {
+        candidatePolls_ = 0;
+        return;
+    }
+    if (prev == BusState::Unknown || next > prev) {
+        Transition(next, rec, tec, errorCode);
+        return;
+    }
+    if (next != candidate_) {
+        candidate_ = next;
+        candidatePolls_ = 0;
+    }
+    if (++candidatePolls_ >= std::max<UINT>(options_.settlePolls, 1)) {
+        Transition(next, rec, tec, errorCode);
+    }
+}
+
+void ChannelHealthMonitor::Transition(BusState next, BYTE rec, BYTE tec, UINT errorCode) {
+    const BusState prev = state_.load();
+    if (next == prev) {
+        return;
+    }
+    state_.store(next);
+    candidatePolls_ = 0;
+
+    const auto now = std::chrono::steady_clock::now();
+
+    HealthEvent event;
+    event.type = HealthEvent::Type::StateChange;
+    event.channelIndex = channelIndex_;
+    event.state = next;
+    event.previousState = prev;
+    event.timestampMs = NowMs();
+    event.rxErrCount = rec;
+    event.txErrCount = tec;
+    event.errorCode = errorCode;
+    callback_(event);
+
+    if (next == BusState::BusOff) {
+        busOffSince_ = now;
+        recoveryAttempt_ = 0;
+        recoveryDelayMs_ = options_.recoveryDelayMs;
+        nextRecoveryAt_ = now + std::chrono::milliseconds(recoveryDelayMs_);
+    } else if (prev == BusState::BusOff && recoveryAttempt_ > 0) {
+        recoveryCount_++;
+
+        HealthEvent recovered = event;
+        recovered.type = HealthEvent::Type::Recovered;
+        recovered.attempt = recoveryAttempt_;
+        recovered.success = true;
+        recovered.latencyUs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - busOffSince_).count());
+        callback_(recovered);
+    }
+}
+
+void ChannelHealthMonitor::TryRecover() {
+    const auto now = std::chrono::steady_clock::now();
+    if (now < nextRecoveryAt_) {
+        return;
+    }
+    if (options_.maxRecoveryAttempts > 0 && recoveryAttempt_ >= options_.maxRecoveryAttempts) {
+        return;
+    }
+    // 上次恢复后的好转正在确认，不再重复复位
+    if (candidatePolls_ > 0) {
+        return;
+    }
+
+    CHANNEL_HANDLE handle;
+    {
+        std::lock_guard<std::mutex> lock(handleMutex_);
+        handle = channelHandle_;
+    }
+
+    recoveryAttempt_++;
+    const bool ok = ZcanResetCAN(handle) == STATUS_OK && ZcanStartCAN(handle) == STATUS_OK;
+
+    HealthEvent event;
+    event.type = HealthEvent::Type::RecoveryAttempt;
+    event.channelIndex = channelIndex_;
+    event.state = BusState::BusOff;
+    event.previousState = BusState::BusOff;
+    event.timestampMs = NowMs();
+    event.attempt = recoveryAttempt_;
+    event.success = ok;
+    callback_(event);
+
+    // 指数退避，直到状态离开总线关闭
+    recoveryDelayMs_ = std::min(std::max<UINT>(recoveryDelayMs_, 1) * 2, options_.maxRecoveryDelayMs);
+    nextRecoveryAt_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(recoveryDelayMs_);
+}
@@ -0,0 +1,124 @@
+#ifndef ZLGCAN_CHANNEL_HEALTH_H_
+#define ZLGCAN_CHANNEL_HEALTH_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "zlgcan.h"
+
+// 通道总线状态（取值与ZCAN_NODE_STATE_*一致，0表示尚未采样）
+enum class BusState : uint8_t {
+    Unknown = 0,
+    Active = ZCAN_NODE_STATE_ACTIVE,
+    Warning = ZCAN_NODE_STATE_WARNNING,
+    Passive = ZCAN_NODE_STATE_PASSIVE,
+    BusOff = ZCAN_NODE_STATE_BUSOFF,
+};
+
+// 健康监视配置
+struct HealthMonitorOptions {
+    UINT pollIntervalMs = 50;          // 错误计数器采样周期
+    bool autoRecover = false;          // 总线关闭后是否自动执行 ResetCAN + StartCAN
+    UINT recoveryDelayMs = 100;        // 首次恢复前的等待时间
+    UINT maxRecoveryDelayMs = 5000;    // 退避等待上限
+    UINT maxRecoveryAttempts = 0;      // 最大恢复次数，0表示不限
+    UINT settlePolls = 2;              // 状态好转须连续一致的采样次数，恶化立即生效
+};
+
+// 健康事件
+struct HealthEvent {
+    enum class Type : uint8_t { StateChange, RecoveryAttempt, Recovered };
+
+    Type type = Type::StateChange;
+    UINT channelIndex = 0;
+    BusState state = BusState::Unknown;
+    BusState previousState = BusState::Unknown;
+    uint64_t timestampMs = 0;          // 系统时间(ms)，与JS Date.now()同基准
+    BYTE rxErrCount = 0;
+    BYTE txErrCount = 0;
+    UINT errorCode = 0;                // ZCAN_ReadChannelErrInfo 的 error_code
+    UINT attempt = 0;                  // 恢复尝试序号（从1开始）
+    bool success = false;              // 本次恢复调用是否成功
+    uint64_t latencyUs = 0;            // Recovered: 从检测到总线关闭到恢复为非关闭状态的耗时
+};
+
+/**
+ * 单通道健康监视器
+ * 在独立线程中周期读取错误计数器和错误信息，状态只由这一采样决定，好转须连续settlePolls次一致，
+ * 状态变化时回调；可选在总线关闭后按指数退避自动恢复通道。回调在监视线程中执行。
+ * 驱动的错误信息读取即清除，监视器读到的错误信息累积保存，由ReadErrInfo交给JS读取方。
+ */
+class ChannelHealthMonitor {
+public:
+    using EventCallback = std::function<void(const HealthEvent&)>;
+
+    ChannelHealthMonitor(CHANNEL_HANDLE channelHandle, UINT channelIndex,
+                         const HealthMonitorOptions& options, EventCallback callback);
+    ~ChannelHealthMonitor();
+
+    ChannelHealthMonitor(const ChannelHealthMonitor&) = delete;
+    ChannelHealthMonitor& operator=(const ChannelHealthMonitor&) = delete;
+
+    void Start();
+    void Stop();
+
+    // 由接收路径转交的错误数据（ZCAN_ReceiveData中的ZCAN_DT_ZCAN_ERROR_DATA记录），只提前一次采样
+    void OnErrorRecord(const ZCANErrorData& errData);
+
+    // 读取错误信息：驱动当前的错误信息与监视器上次交付以来读到的合并，读取后清除
+    UINT ReadErrInfo(ZCAN_CHANNEL_ERR_INFO* errInfo);
+
+    // 通道句柄变化时更新（例如设备重连后）
+    void SetChannelHandle(CHANNEL_HANDLE channelHandle);
+
+    BusState State() const { return state_.load(); }
+    UINT ChannelIndex() const { return channelIndex_; }
+    UINT RecoveryCount() const { return recoveryCount_.load(); }
+
+    // 根据错误计数器和状态寄存器推断总线状态
+    static BusState ClassifyState(const ZCAN_CHANNEL_STATUS& status, UINT errorCode);
+
+private:
+    void Run();
+    void Poll();
+    UINT ReadDriverErrInfo(CHANNEL_HANDLE handle, ZCAN_CHANNEL_ERR_INFO* errInfo);
+    void Evaluate(BusState next, BYTE rec, BYTE tec, UINT errorCode);
+    void Transition(BusState next, BYTE rec, BYTE tec, UINT errorCode);
+    void TryRecover();
+
+    std::mutex handleMutex_;
+    CHANNEL_HANDLE channelHandle_;
+    const UINT channelIndex_;
+    const HealthMonitorOptions options_;
+    EventCallback callback_;
+
+    std::atomic<BusState> state_{BusState::Unknown};
+    std::atomic<UINT> recoveryCount_{0};
+
+    // 恢复状态，仅监视线程访问
+    std::chrono::steady_clock::time_point busOffSince_;
+    std::chrono::steady_clock::time_point nextRecoveryAt_;
+    UINT recoveryAttempt_ = 0;
+    UINT recoveryDelayMs_ = 0;
+
+    // 好转候选状态及其连续采样次数，仅监视线程访问
+    BusState candidate_ = BusState::Unknown;
+    UINT candidatePolls_ = 0;
+
+    // 监视器读到、尚未交给JS的错误信息
+    std::mutex errInfoMutex_;
+    ZCAN_CHANNEL_ERR_INFO cachedErrInfo_ = {};
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopRequested_ = false;
+    bool pollRequested_ = false;
+    std::thread thread_;
+};
+
+#endif  // ZLGCAN_CHANNEL_HEALTH_H_
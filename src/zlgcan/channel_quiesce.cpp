@@ -0,0 +1,88 @@
+#include "channel_quiesce.h"
+#include "zlgcan_api.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+namespace {
+
+constexpr auto DRAIN_POLL_INTERVAL = std::chrono::milliseconds(1);
+
+// 设备剩余可用发送缓存数，不支持该属性的设备返回-1
+long long AvailableTxCount(DEVICE_HANDLE deviceHandle, UINT channelIndex) {
+    const std::string path = std::to_string(channelIndex) + "/get_device_available_tx_count/1";
+    const void* value = ZcanGetValue(deviceHandle, path.c_str());
+    if (value == nullptr) {
+        return -1;
+    }
+    return std::atoll(static_cast<const char*>(value));
+}
+
+UINT ClearReceived(const std::vector<std::pair<UINT, CHANNEL_HANDLE>>& channels) {
+    UINT discarded = 0;
+    for (const auto& channel : channels) {
+        discarded += ZcanGetReceiveNum(channel.second, TYPE_ALL_DATA);
+        ZcanClearBuffer(channel.second);
+    }
+    return discarded;
+}
+
+}  // namespace
+
+QuiesceResult QuiesceChannels(DEVICE_HANDLE deviceHandle,
+                              const std::vector<std::pair<UINT, CHANNEL_HANDLE>>& channels,
+                              const QuiesceOptions& options) {
+    using Clock = std::chrono::steady_clock;
+    const auto startAt = Clock::now();
+    const auto deadline = startAt + std::chrono::milliseconds(options.timeoutMs);
+
+    QuiesceResult result;
+
+    // 取消设备端定时发送和队列发送，不支持的设备忽略返回值
+    for (const auto& channel : channels) {
+        const std::string prefix = std::to_string(channel.first) + "/";
+        ZcanSetValue(deviceHandle, (prefix + "clear_auto_send").c_str(), "0");
+        ZcanSetValue(deviceHandle, (prefix + "clear_delay_send_queue").c_str(), "0");
+    }
+
+    // 可用发送缓存数回到容量即发送队列已排空；容量未知时要求一个时间窗内不再增加，
+    // 单次采样未增加可能只是正在发送的帧尚未完成
+    const auto settle = std::chrono::milliseconds(options.settleMs);
+    bool drained = true;
+    for (const auto& channel : channels) {
+        long long current = AvailableTxCount(deviceHandle, channel.first);
+        if (current < 0) {
+            continue;
+        }
+        long long highest = current;
+        auto risenAt = Clock::now();
+        while (true) {
+            if (options.txCapacity != 0 ? current >= static_cast<long long>(options.txCapacity)
+                                        : Clock::now() - risenAt >= settle) {
+                break;
+            }
+            if (Clock::now() >= deadline) {
+                drained = false;
+                break;
+            }
+            std::this_thread::sleep_for(DRAIN_POLL_INTERVAL);
+            current = AvailableTxCount(deviceHandle, channel.first);
+            if (current > highest) {
+                highest = current;
+                risenAt = Clock::now();
+            }
+        }
+    }
+
+    // 排空后再等一个时间窗，使已在总线上的本方报文到达接收端，然后清空一次：截止点之前收到的报文
+    // 全部丢弃。DUT和残余总线节点的周期报文不会停止，截止点之后到达的报文属于下一个用例，不要求总线静默
+    std::this_thread::sleep_for(settle);
+    result.discardedFrames = ClearReceived(channels);
+
+    result.clean = drained;
+    result.elapsedUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - startAt).count());
+    return result;
+}
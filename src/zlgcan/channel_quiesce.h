@@ -0,0 +1,36 @@
+#ifndef ZLGCAN_CHANNEL_QUIESCE_H_
+#define ZLGCAN_CHANNEL_QUIESCE_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "zlgcan.h"
+
+// 静默配置
+struct QuiesceOptions {
+    UINT timeoutMs = 100;              // 等待发送队列排空的总时限
+    UINT settleMs = 2;                 // 排空后等待在途报文到达再清空缓冲区的时间窗
+    UINT txCapacity = 0;               // 每通道发送缓存容量（帧），可用数回到该值即排空；0表示未知，
+                                       // 此时以可用数在一个时间窗内不再增加为准
+};
+
+// 静默结果
+struct QuiesceResult {
+    bool clean = false;                // 时限内发送队列已排空
+    UINT discardedFrames = 0;          // 清空缓冲区时丢弃的报文数
+    uint64_t elapsedUs = 0;
+};
+
+/**
+ * 通道静默（测试用例之间的隔离屏障）
+ * 依次取消设备定时发送和队列发送、等待设备发送队列排空，再等一个时间窗后清空接收缓冲区一次。
+ * 其他节点的报文不受本方控制，不要求总线静默：截止点之前收到的报文丢弃，之后的报文留给下一个用例。
+ * 阻塞执行，应在工作线程中调用。
+ * @param channels 通道索引与句柄
+ */
+QuiesceResult QuiesceChannels(DEVICE_HANDLE deviceHandle,
+                              const std::vector<std::pair<UINT, CHANNEL_HANDLE>>& channels,
+                              const QuiesceOptions& options);
+
+#endif  // ZLGCAN_CHANNEL_QUIESCE_H_
@@ -0,0 +1,138 @@
+#include "device_gate.h"
+
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+// 句柄到所属闸门的登记表。查询只持有共享锁；登记为空时（没有运行中的监视线程）不加锁直接返回
+struct DeviceGateRegistry {
+    std::shared_mutex mutex;
+    std::unordered_map<const void*, DeviceGateState*> handles;
+    std::atomic<size_t> count{0};
+};
+
+DeviceGateRegistry& Registry() {
+    static DeviceGateRegistry registry;
+    return registry;
+}
+
+}  // namespace
+
+DeviceGateState& DeviceGateFor(uint32_t deviceType, uint32_t deviceIndex) {
+    static std::mutex mutex;
+    static std::map<std::pair<uint32_t, uint32_t>, std::unique_ptr<DeviceGateState>> gates;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<DeviceGateState>& gate = gates[{deviceType, deviceIndex}];
+    if (!gate) {
+        gate.reset(new DeviceGateState());
+    }
+    return *gate;
+}
+
+DeviceGateState*& DeviceGateOwnedByThisThread() {
+    static thread_local DeviceGateState* owned = nullptr;
+    return owned;
+}
+
+DeviceGateState* DeviceGateLookup(const void* handle) {
+    DeviceGateRegistry& registry = Registry();
+    if (handle == nullptr || registry.count.load(std::memory_order_relaxed) == 0) {
+        return nullptr;
+    }
+    std::shared_lock<std::shared_mutex> lock(registry.mutex);
+    auto it = registry.handles.find(handle);
+    return it == registry.handles.end() ? nullptr : it->second;
+}
+
+void DeviceGateRegister(DeviceGateState& gate, const void* handle) {
+    if (handle == nullptr) {
+        return;
+    }
+    DeviceGateRegistry& registry = Registry();
+    std::unique_lock<std::shared_mutex> lock(registry.mutex);
+    registry.handles[handle] = &gate;
+    registry.count.store(registry.handles.size());
+}
+
+void DeviceGateUnregister(DeviceGateState& gate, bool keepRetired) {
+    DeviceGateExclusive exclusive(gate);
+    DeviceGateRegistry& registry = Registry();
+    std::unique_lock<std::shared_mutex> lock(registry.mutex);
+    for (auto it = registry.handles.begin(); it != registry.handles.end();) {
+        if (it->second == &gate && !(keepRetired && gate.retired.count(it->first) != 0)) {
+            it = registry.handles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    registry.count.store(registry.handles.size());
+    if (!keepRetired) {
+        gate.retired.clear();
+        gate.retiredCount.store(0);
+    }
+}
+
+void DeviceGateWaitOpen(DeviceGateState& gate) {
+    std::unique_lock<std::mutex> lock(gate.waitMutex);
+    gate.waitCv.wait(lock, [&gate] { return !gate.closing.load(); });
+}
+
+DeviceGateExclusive::DeviceGateExclusive(DeviceGateState& gate) : gate_(gate) {
+    DeviceGateState*& owned = DeviceGateOwnedByThisThread();
+    if (owned == &gate) {
+        nested_ = true;
+        return;
+    }
+    gate.ownerMutex.lock();
+    gate.closing.store(true);
+    // 进行中的调用最长为一次阻塞接收或UDS请求，短暂让出即可
+    while (gate.readers.load() != 0) {
+        std::this_thread::yield();
+    }
+    previous_ = owned;
+    owned = &gate;
+}
+
+DeviceGateExclusive::~DeviceGateExclusive() {
+    if (nested_) {
+        return;
+    }
+    DeviceGateOwnedByThisThread() = previous_;
+    {
+        std::lock_guard<std::mutex> lock(gate_.waitMutex);
+        gate_.closing.store(false);
+    }
+    gate_.waitCv.notify_all();
+    gate_.ownerMutex.unlock();
+}
+
+void DeviceGateRetire(const void* handle) {
+    DeviceGateState* gate = DeviceGateOwnedByThisThread();
+    if (handle == nullptr || gate == nullptr) {
+        return;
+    }
+    DeviceGateRegister(*gate, handle);
+    gate->retired.insert(handle);
+    gate->retiredCount.store(gate->retired.size());
+}
+
+void DeviceGateAdopt(const void* handle) {
+    DeviceGateState* gate = DeviceGateLookup(handle);
+    if (gate == nullptr || gate->retiredCount.load() == 0) {
+        return;
+    }
+    DeviceGateExclusive exclusive(*gate);
+    if (gate->retired.erase(handle) == 0) {
+        return;
+    }
+    gate->retiredCount.store(gate->retired.size());
+    DeviceGateRegistry& registry = Registry();
+    std::unique_lock<std::shared_mutex> lock(registry.mutex);
+    registry.handles.erase(handle);
+    registry.count.store(registry.handles.size());
+}
@@ -0,0 +1,108 @@
+#ifndef ZLGCAN_DEVICE_GATE_H_
+#define ZLGCAN_DEVICE_GATE_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+
+/**
+ * 设备句柄闸门
+ * 设备热插拔监视线程关闭和重新打开设备时，接收线程、健康监视、残余总线和各协议引擎仍可能
+ * 在旧句柄上调用ZCAN_*。以句柄为参数的ZCAN_*封装（zlgcan_api.h）在调用期间持有句柄所属设备的
+ * 共享闸门；监视线程独占该设备的闸门后才关闭设备，并把关闭的设备/通道句柄登记为失效，此后仍持有
+ * 旧句柄的调用直接失败而不进入驱动。重新打开和回放在新句柄上进行，不持有闸门，只有各线程句柄的
+ * 替换在独占闸门内完成。
+ * 闸门按设备分配，一个设备重连期间不影响其他设备的调用。句柄只在监视线程运行期间登记，
+ * 未登记的句柄（未启用热插拔监视的设备）不经过闸门。
+ * 独占方优先：独占请求发出后新的共享进入在入口等待，避免持续轮询的线程使监视线程饿死。
+ */
+struct DeviceGateState {
+    std::atomic<uint32_t> readers{0};
+    std::atomic<bool> closing{false};
+    std::atomic<size_t> retiredCount{0};
+    std::mutex ownerMutex;                       // 串行化独占方
+    std::mutex waitMutex;                        // 共享方等待独占结束
+    std::condition_variable waitCv;
+    std::unordered_set<const void*> retired;     // 失效句柄，只在独占期间修改
+};
+
+// 设备的闸门，按设备类型和索引分配，进程内不释放（登记表查到的指针在调用期间始终有效）
+DeviceGateState& DeviceGateFor(uint32_t deviceType, uint32_t deviceIndex);
+
+// 当前线程独占的闸门（持有方在该设备句柄上的ZCAN_*调用不经过闸门），未独占时为nullptr
+DeviceGateState*& DeviceGateOwnedByThisThread();
+
+// 句柄所属的闸门，未登记时为nullptr
+DeviceGateState* DeviceGateLookup(const void* handle);
+
+// 登记句柄所属的闸门
+void DeviceGateRegister(DeviceGateState& gate, const void* handle);
+
+// 移除闸门的句柄登记；keepRetired为true时保留失效句柄，使之后的调用仍直接失败
+void DeviceGateUnregister(DeviceGateState& gate, bool keepRetired);
+
+void DeviceGateWaitOpen(DeviceGateState& gate);
+
+// 共享闸门：构造后bool为false表示句柄已失效，调用方应直接返回失败
+class DeviceGateScope {
+public:
+    explicit DeviceGateScope(const void* handle) {
+        DeviceGateState* gate = DeviceGateLookup(handle);
+        if (gate == nullptr || gate == DeviceGateOwnedByThisThread()) {
+            return;
+        }
+        for (;;) {
+            gate->readers.fetch_add(1);
+            if (!gate->closing.load()) {
+                break;
+            }
+            gate->readers.fetch_sub(1);
+            DeviceGateWaitOpen(*gate);
+        }
+        gate_ = gate;
+        if (gate->retiredCount.load(std::memory_order_relaxed) != 0 && gate->retired.count(handle) != 0) {
+            admitted_ = false;
+        }
+    }
+
+    ~DeviceGateScope() {
+        if (gate_ != nullptr) {
+            gate_->readers.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    DeviceGateScope(const DeviceGateScope&) = delete;
+    DeviceGateScope& operator=(const DeviceGateScope&) = delete;
+
+    explicit operator bool() const { return admitted_; }
+
+private:
+    DeviceGateState* gate_ = nullptr;
+    bool admitted_ = true;
+};
+
+// 独占闸门：等待该设备上进行中的ZCAN_*调用返回，持有期间其他线程的调用在入口等待；同一线程可嵌套
+class DeviceGateExclusive {
+public:
+    explicit DeviceGateExclusive(DeviceGateState& gate);
+    ~DeviceGateExclusive();
+
+    DeviceGateExclusive(const DeviceGateExclusive&) = delete;
+    DeviceGateExclusive& operator=(const DeviceGateExclusive&) = delete;
+
+private:
+    DeviceGateState& gate_;
+    DeviceGateState* previous_ = nullptr;
+    bool nested_ = false;
+};
+
+// 登记失效句柄，须在句柄所属设备的独占闸门内调用
+void DeviceGateRetire(const void* handle);
+
+// 新分配的句柄与失效登记中的旧句柄值相同时（驱动复用了地址）解除登记，由新的所有者重新登记
+void DeviceGateAdopt(const void* handle);
+
+#endif  // ZLGCAN_DEVICE_GATE_H_
@@ -0,0 +1,473 @@
+#include "device_monitor.h"
+#include "zlgcan_api.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "thread_scheduling.h"
+
+namespace {
+
+uint64_t NowMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+bool StartsWith(const std::string& str, const std::string& prefix) {
+    return str.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool EndsWith(const std::string& str, const std::string& suffix) {
+    return str.size() >= suffix.size() &&
+        str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// "0/filter_clear" -> "0/"
+std::string ChannelPrefix(const std::string& path) {
+    size_t pos = path.find('/');
+    return pos == std::string::npos ? std::string() : path.substr(0, pos + 1);
+}
+
+// 仿真后端的总线控制和错误注入
+bool IsSimControl(const std::string& path) {
+    return StartsWith(path, "sim/") || EndsWith(path, "/sim_bus_off") ||
+        EndsWith(path, "/sim_tec") || EndsWith(path, "/sim_rec");
+}
+
+}  // namespace
+
+DeviceMonitor::DeviceMonitor(UINT deviceType, UINT deviceIndex, UINT reserved, DEVICE_HANDLE deviceHandle)
+    : deviceType_(deviceType), deviceIndex_(deviceIndex), reserved_(reserved), deviceHandle_(deviceHandle),
+      gate_(DeviceGateFor(deviceType, deviceIndex)) {
+}
+
+DeviceMonitor::~DeviceMonitor() {
+    Stop();
+    DeviceGateUnregister(gate_, false);
+}
+
+void DeviceMonitor::RegisterHandle(const void* handle) {
+    if (gated_) {
+        DeviceGateRegister(gate_, handle);
+    }
+}
+
+void DeviceMonitor::EraseOperations(const std::function<bool(const Operation&)>& predicate) {
+    for (auto it = operations_.begin(); it != operations_.end();) {
+        if (predicate(*it)) {
+            it = operations_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool DeviceMonitor::IsLinKind(Operation::Kind kind) {
+    return kind == Operation::Kind::InitLin || kind == Operation::Kind::StartLin ||
+        kind == Operation::Kind::LinPublish || kind == Operation::Kind::LinSubscribe;
+}
+
+bool DeviceMonitor::IsChannelSetupKind(Operation::Kind kind) {
+    return kind == Operation::Kind::InitCan || kind == Operation::Kind::StartCan ||
+        kind == Operation::Kind::InitLin || kind == Operation::Kind::StartLin;
+}
+
+void DeviceMonitor::RecordInitCan(UINT channelIndex, const ZCAN_CHANNEL_INIT_CONFIG& config,
+                                  CHANNEL_HANDLE channelHandle) {
+    std::lock_guard<std::mutex> lock(operationsMutex_);
+    // 重新初始化后，之前的初始化和启动记录已失效
+    EraseOperations([channelIndex](const Operation& op) {
+        return (op.kind == Operation::Kind::InitCan || op.kind == Operation::Kind::StartCan) &&
+            op.channelIndex == channelIndex;
+    });
+    Operation op{};
+    op.kind = Operation::Kind::InitCan;
+    op.channelIndex = channelIndex;
+    op.config = config;
+    operations_.push_back(op);
+    canHandles_[channelIndex] = channelHandle;
+    RegisterHandle(channelHandle);
+}
+
+void DeviceMonitor::RecordStartCan(UINT channelIndex) {
+    std::lock_guard<std::mutex> lock(operationsMutex_);
+    EraseOperations([channelIndex](const Operation& op) {
+        return op.kind == Operation::Kind::StartCan && op.channelIndex == channelIndex;
+    });
+    Operation op{};
+    op.kind = Operation::Kind::StartCan;
+    op.channelIndex = channelIndex;
+    operations_.push_back(op);
+}
+
+void DeviceMonitor::RecordResetCan(UINT channelIndex) {
+    std::lock_guard<std::mutex> lock(operationsMutex_);
+    EraseOperations([channelIndex](const Operation& op) {
+        return op.kind == Operation::Kind::StartCan && op.channelIndex == channelIndex;
+    });
+}
+
+void DeviceMonitor::RecordSetValue(const std::string& path, const std::string& value) {
+    // 仿真控制不是设备配置，回放会使设备再次离线或总线关闭
+    if (IsSimControl(path)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(operationsMutex_);
+
+    // 清除类命令使之前同通道的滤波/定时发送设置失效
+    const std::string prefix = ChannelPrefix(path);
+    if (EndsWith(path, "/filter_clear")) {
+        EraseOperations([&prefix](const Operation& op) {
+            return op.kind == Operation::Kind::SetValue && StartsWith(op.path, prefix + "filter_");
+        });
+    } else if (EndsWith(path, "/clear_auto_send")) {
+        EraseOperations([&prefix](const Operation& op) {
+            return op.kind == Operation::Kind::SetValue &&
+                (StartsWith(op.path, prefix + "auto_send") || op.path == prefix + "clear_auto_send");
+        });
+    }
+
+    // 新值覆盖同一路径的最新记录：其后没有通道初始化/启动时原位替换（初始化前的设置须在初始化前回放）；
+    // 否则追加在后，只保留紧邻初始化之前的一条，记录不随运行时间增长
+    auto latest = operations_.end();
+    for (auto it = operations_.begin(); it != operations_.end(); ++it) {
+        if (it->kind == Operation::Kind::SetValue && it->path == path) {
+            latest = it;
+        }
+    }
+    if (latest != operations_.end()) {
+        const bool initAfter = std::any_of(latest + 1, operations_.end(), [](const Operation& op) {
+            return IsChannelSetupKind(op.kind);
+        });
+        if (!initAfter) {
+            latest->value = value;
+            return;
+        }
+        // 更早的记录都在latest之前，从后向前删除不影响latest之前的下标
+        for (auto it = latest; it != operations_.begin();) {
+            --it;
+            if (it->kind == Operation::Kind::SetValue && it->path == path) {
+                it = operations_.erase(it);
+            }
+        }
+    }
+    Operation op{};
+    op.kind = Operation::Kind::SetValue;
+    op.path = path;
+    op.value = value;
+    operations_.push_back(op);
+}
+
+void DeviceMonitor::RecordInitLin(UINT linIndex, const ZCAN_LIN_INIT_CONFIG& config, CHANNEL_HANDLE channelHandle) {
+    std::lock_guard<std::mutex> lock(operationsMutex_);
+    // 重新初始化后，同一LIN通道之前的初始化、启动和发布/订阅记录已失效
+    EraseOperations([linIndex](const Operation& op) {
+        return IsLinKind(op.kind) && op.channelIndex == linIndex;
+    });
+    Operation op{};
+    op.kind = Operation::Kind::InitLin;
+    op.channelIndex = linIndex;
+    op.linConfig = config;
+    operations_.push_back(op);
+    linHandles_[linIndex] = channelHandle;
+    RegisterHandle(channelHandle);
+}
+
+void DeviceMonitor::RecordStartLin(UINT linIndex) {
+    std::lock_guard<std::mutex> lock(operationsMutex_);
+    EraseOperations([linIndex](const Operation& op) {
+        return op.kind == Operation::Kind::StartLin && op.channelIndex == linIndex;
+    });
+    Operation op{};
+    op.kind = Operation::Kind::StartLin;
+    op.channelIndex = linIndex;
+    operations_.push_back(op);
+}
+
+void DeviceMonitor::RecordResetLin(UINT linIndex) {
+    std::lock_guard<std::mutex> lock(operationsMutex_);
+    EraseOperations([linIndex](const Operation& op) {
+        return op.kind == Operation::Kind::StartLin && op.channelIndex == linIndex;
+    });
+}
+
+void DeviceMonitor::RecordLinPublish(UINT linIndex, const std::vector<ZCAN_LIN_PUBLISH_CFG_EX>& configs,
+                                     bool extended) {
+    std::lock_guard<std::mutex> lock(operationsMutex_);
+    // 从节点应答数据常被周期性刷新，每个帧ID只保留最后一次设置
+    for (const auto& config : configs) {
+        EraseOperations([linIndex, &config](const Operation& op) {
+            return op.kind == Operation::Kind::LinPublish && op.channelIndex == linIndex &&
+                op.publish.ID == config.ID;
+        });
+        Operation op{};
+        op.kind = Operation::Kind::LinPublish;
+        op.channelIndex = linIndex;
+        op.publish = config;
+        op.publishExtended = extended;
+        operations_.push_back(op);
+    }
+}
+
+void DeviceMonitor::RecordLinSubscribe(UINT linIndex, const std::vector<ZCAN_LIN_SUBSCIBE_CFG>& configs) {
+    std::lock_guard<std::mutex> lock(operationsMutex_);
+    for (const auto& config : configs) {
+        EraseOperations([linIndex, &config](const Operation& op) {
+            return op.kind == Operation::Kind::LinSubscribe && op.channelIndex == linIndex &&
+                op.subscribe.ID == config.ID;
+        });
+        Operation op{};
+        op.kind = Operation::Kind::LinSubscribe;
+        op.channelIndex = linIndex;
+        op.subscribe = config;
+        operations_.push_back(op);
+    }
+}
+
+void DeviceMonitor::RecordProperty(const void* property) {
+    std::lock_guard<std::mutex> lock(operationsMutex_);
+    property_ = property;
+    RegisterHandle(property);
+}
+
+void DeviceMonitor::Start(const DeviceMonitorOptions& options, EventCallback callback,
+                          HandleSwapCallback swapHandles) {
+    if (thread_.joinable()) {
+        return;
+    }
+    options_ = options;
+    callback_ = std::move(callback);
+    swapHandles_ = std::move(swapHandles);
+    {
+        std::lock_guard<std::mutex> lock(operationsMutex_);
+        gated_ = true;
+        RegisterHandle(deviceHandle_.load());
+        for (const auto& channel : canHandles_) {
+            RegisterHandle(channel.second);
+        }
+        for (const auto& channel : linHandles_) {
+            RegisterHandle(channel.second);
+        }
+        RegisterHandle(property_);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopRequested_ = false;
+    }
+    thread_ = std::thread(&DeviceMonitor::Run, this);
+}
+
+void DeviceMonitor::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopRequested_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(operationsMutex_);
+        if (!gated_) {
+            return;
+        }
+        gated_ = false;
+    }
+    // 失效句柄保留登记，监视停止后持有旧句柄的调用仍直接失败
+    DeviceGateUnregister(gate_, true);
+}
+
+bool DeviceMonitor::WaitFor(UINT ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return !cv_.wait_for(lock, std::chrono::milliseconds(ms), [this] { return stopRequested_; });
+}
+
+void DeviceMonitor::ReplayLin(DEVICE_HANDLE deviceHandle, const Operation& op,
+                              std::map<UINT, CHANNEL_HANDLE>* linChannels, DeviceEvent* event) {
+    if (op.kind == Operation::Kind::InitLin) {
+        ZCAN_LIN_INIT_CONFIG config = op.linConfig;
+        CHANNEL_HANDLE channelHandle = ZcanInitLIN(deviceHandle, op.channelIndex, &config);
+        if (channelHandle == INVALID_CHANNEL_HANDLE) {
+            event->replayFailures++;
+        } else {
+            (*linChannels)[op.channelIndex] = channelHandle;
+        }
+        return;
+    }
+
+    auto it = linChannels->find(op.channelIndex);
+    if (it == linChannels->end()) {
+        event->replayFailures++;
+        return;
+    }
+    UINT result = STATUS_ERR;
+    switch (op.kind) {
+        case Operation::Kind::StartLin:
+            result = ZcanStartLIN(it->second);
+            break;
+        case Operation::Kind::LinPublish:
+            if (op.publishExtended) {
+                ZCAN_LIN_PUBLISH_CFG_EX config = op.publish;
+                result = ZcanSetLINPublishEx(it->second, &config, 1);
+            } else {
+                ZCAN_LIN_PUBLISH_CFG config;
+                memset(&config, 0, sizeof(config));
+                config.ID = op.publish.ID;
+                config.dataLen = op.publish.dataLen;
+                memcpy(config.data, op.publish.data, sizeof(config.data));
+                config.chkSumMode = op.publish.chkSumMode;
+                result = ZcanSetLINPublish(it->second, &config, 1);
+            }
+            break;
+        case Operation::Kind::LinSubscribe: {
+            ZCAN_LIN_SUBSCIBE_CFG config = op.subscribe;
+            result = ZcanSetLINSubscribe(it->second, &config, 1);
+            break;
+        }
+        default:
+            break;
+    }
+    if (result != STATUS_OK) {
+        event->replayFailures++;
+    }
+}
+
+DEVICE_HANDLE DeviceMonitor::Replay(DeviceEvent* event) {
+    DEVICE_HANDLE handle = ZcanOpenDevice(deviceType_, deviceIndex_, reserved_);
+    if (handle == INVALID_DEVICE_HANDLE) {
+        return INVALID_DEVICE_HANDLE;
+    }
+
+    std::vector<Operation> operations;
+    {
+        std::lock_guard<std::mutex> lock(operationsMutex_);
+        operations = operations_;
+    }
+
+    std::map<UINT, CHANNEL_HANDLE> channels;
+    std::map<UINT, CHANNEL_HANDLE> linChannels;
+    for (const auto& op : operations) {
+        switch (op.kind) {
+            case Operation::Kind::SetValue:
+                if (ZcanSetValue(handle, op.path.c_str(), op.value.c_str()) != STATUS_OK) {
+                    event->replayFailures++;
+                }
+                break;
+            case Operation::Kind::InitCan: {
+                ZCAN_CHANNEL_INIT_CONFIG config = op.config;
+                CHANNEL_HANDLE channelHandle = ZcanInitCAN(handle, op.channelIndex, &config);
+                if (channelHandle == INVALID_CHANNEL_HANDLE) {
+                    event->replayFailures++;
+                } else {
+                    channels[op.channelIndex] = channelHandle;
+                }
+                break;
+            }
+            case Operation::Kind::StartCan: {
+                auto it = channels.find(op.channelIndex);
+                if (it == channels.end() || ZcanStartCAN(it->second) != STATUS_OK) {
+                    event->replayFailures++;
+                }
+                break;
+            }
+            default:
+                ReplayLin(handle, op, &linChannels, event);
+                break;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(operationsMutex_);
+        canHandles_ = channels;
+        linHandles_ = linChannels;
+        RegisterHandle(handle);
+        for (const auto& channel : channels) {
+            RegisterHandle(channel.second);
+        }
+        for (const auto& channel : linChannels) {
+            RegisterHandle(channel.second);
+        }
+    }
+    event->channels.assign(channels.begin(), channels.end());
+    event->linChannels.assign(linChannels.begin(), linChannels.end());
+    return handle;
+}
+
+void DeviceMonitor::RetireHandles(DEVICE_HANDLE deviceHandle) {
+    std::lock_guard<std::mutex> lock(operationsMutex_);
+    DeviceGateRetire(deviceHandle);
+    for (const auto& channel : canHandles_) {
+        DeviceGateRetire(channel.second);
+    }
+    for (const auto& channel : linHandles_) {
+        DeviceGateRetire(channel.second);
+    }
+    canHandles_.clear();
+    linHandles_.clear();
+}
+
+void DeviceMonitor::Run() {
+    ThreadSchedulingScope scheduling(ThreadRole::Monitor);
+    while (WaitFor(options_.pollIntervalMs)) {
+        // 仅明确返回离线时处理，不支持在线检测的设备返回STATUS_ERR
+        DEVICE_HANDLE current = deviceHandle_.load();
+        if (current == INVALID_DEVICE_HANDLE || ZcanIsDeviceOnLine(current) != STATUS_OFFLINE) {
+            continue;
+        }
+
+        const auto offlineAt = std::chrono::steady_clock::now();
+        online_.store(false);
+
+        DeviceEvent offline;
+        offline.type = DeviceEvent::Type::Offline;
+        offline.timestampMs = NowMs();
+        {
+            // 其他线程进行中的调用返回后才关闭设备；此后持有旧句柄的调用直接失败
+            DeviceGateExclusive gate(gate_);
+            deviceHandle_.store(INVALID_DEVICE_HANDLE);
+            if (swapHandles_) {
+                swapHandles_(offline);
+            }
+            RetireHandles(current);
+            ZcanCloseDevice(current);
+        }
+        callback_(offline);
+
+        DeviceEvent reconnected;
+        reconnected.type = DeviceEvent::Type::Reconnected;
+        DEVICE_HANDLE handle = INVALID_DEVICE_HANDLE;
+        do {
+            reconnected.attempts++;
+            reconnected.channels.clear();
+            reconnected.linChannels.clear();
+            reconnected.replayFailures = 0;
+
+            // 新句柄在替换前只有本线程持有，打开和回放不需要闸门；其他线程此时在旧句柄上的调用直接失败
+            handle = Replay(&reconnected);
+        } while (handle == INVALID_DEVICE_HANDLE && WaitFor(options_.retryIntervalMs));
+
+        if (handle == INVALID_DEVICE_HANDLE) {
+            break;  // 停止请求
+        }
+        {
+            DeviceGateExclusive gate(gate_);
+            deviceHandle_.store(handle);
+            reconnected.deviceHandle = handle;
+            if (swapHandles_) {
+                swapHandles_(reconnected);
+            }
+        }
+
+        const uint64_t elapsedUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - offlineAt).count());
+
+        online_.store(true);
+        reconnectCount_++;
+        lastReconnectUs_.store(elapsedUs);
+
+        reconnected.timestampMs = NowMs();
+        reconnected.reconnectUs = elapsedUs;
+        callback_(reconnected);
+    }
+}
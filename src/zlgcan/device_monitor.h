@@ -0,0 +1,139 @@
+#ifndef ZLGCAN_DEVICE_MONITOR_H_
+#define ZLGCAN_DEVICE_MONITOR_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "device_gate.h"
+#include "zlgcan.h"
+
+// 设备监视配置
+struct DeviceMonitorOptions {
+    UINT pollIntervalMs = 200;         // ZCAN_IsDeviceOnLine 轮询周期
+    UINT retryIntervalMs = 200;        // 离线后重新打开设备的间隔
+};
+
+// 设备事件
+struct DeviceEvent {
+    enum class Type : uint8_t { Offline, Reconnected };
+
+    Type type = Type::Offline;
+    uint64_t timestampMs = 0;          // 系统时间(ms)，与JS Date.now()同基准
+    DEVICE_HANDLE deviceHandle = INVALID_DEVICE_HANDLE;
+    std::vector<std::pair<UINT, CHANNEL_HANDLE>> channels;  // Reconnected: 回放后的通道索引与新句柄
+    std::vector<std::pair<UINT, CHANNEL_HANDLE>> linChannels;  // Reconnected: 回放后的LIN通道索引与新句柄
+    UINT attempts = 0;                 // Reconnected: 重新打开设备的尝试次数
+    UINT replayFailures = 0;           // Reconnected: 回放失败的操作数
+    uint64_t reconnectUs = 0;          // Reconnected: 从检测到离线到回放完成的耗时
+};
+
+/**
+ * 设备热插拔监视器
+ * 记录设备打开后的CAN/LIN通道初始化、启动、LIN发布/订阅和属性设置操作；监视线程检测到设备离线后
+ * 周期性重新打开设备并按原顺序回放这些操作。回调在监视线程中执行。
+ * 监视线程运行期间设备和通道句柄登记在该设备的句柄闸门（device_gate.h）。关闭设备在独占闸门内进行：
+ * 其他线程进行中的ZCAN_*调用返回后才关闭，关闭的设备和通道句柄登记为失效。重新打开和回放在新句柄上
+ * 进行，不持有闸门；回放完成后由句柄替换回调在独占闸门内更新各线程持有的句柄。
+ */
+class DeviceMonitor {
+public:
+    using EventCallback = std::function<void(const DeviceEvent&)>;
+    // 在独占闸门内执行：Offline时设备尚未关闭，Reconnected时回放已完成、其他线程尚未换用新句柄
+    using HandleSwapCallback = std::function<void(const DeviceEvent&)>;
+
+    DeviceMonitor(UINT deviceType, UINT deviceIndex, UINT reserved, DEVICE_HANDLE deviceHandle);
+    ~DeviceMonitor();
+
+    DeviceMonitor(const DeviceMonitor&) = delete;
+    DeviceMonitor& operator=(const DeviceMonitor&) = delete;
+
+    // 操作记录（由JS线程在对应调用成功后写入）
+    void RecordInitCan(UINT channelIndex, const ZCAN_CHANNEL_INIT_CONFIG& config, CHANNEL_HANDLE channelHandle);
+    void RecordStartCan(UINT channelIndex);
+    void RecordResetCan(UINT channelIndex);
+    void RecordSetValue(const std::string& path, const std::string& value);
+    void RecordInitLin(UINT linIndex, const ZCAN_LIN_INIT_CONFIG& config, CHANNEL_HANDLE channelHandle);
+    void RecordStartLin(UINT linIndex);
+    void RecordResetLin(UINT linIndex);
+    // extended为true时以ZCAN_SetLINPublishEx回放（数据超过8字节）
+    void RecordLinPublish(UINT linIndex, const std::vector<ZCAN_LIN_PUBLISH_CFG_EX>& configs, bool extended);
+    void RecordLinSubscribe(UINT linIndex, const std::vector<ZCAN_LIN_SUBSCIBE_CFG>& configs);
+    // IProperty句柄不回放（重连后由JS线程重新获取），只登记在闸门；掉线时由句柄替换回调登记为失效
+    void RecordProperty(const void* property);
+
+    void Start(const DeviceMonitorOptions& options, EventCallback callback, HandleSwapCallback swapHandles);
+    void Stop();
+
+    bool IsRunning() const { return thread_.joinable(); }
+    bool IsOnline() const { return online_.load(); }
+    UINT ReconnectCount() const { return reconnectCount_.load(); }
+    uint64_t LastReconnectUs() const { return lastReconnectUs_.load(); }
+
+    // 当前设备句柄，离线期间为INVALID_DEVICE_HANDLE
+    DEVICE_HANDLE Handle() const { return deviceHandle_.load(); }
+
+private:
+    struct Operation {
+        enum class Kind : uint8_t { SetValue, InitCan, StartCan, InitLin, StartLin, LinPublish, LinSubscribe };
+
+        Kind kind;
+        UINT channelIndex;                     // CAN或LIN通道索引
+        ZCAN_CHANNEL_INIT_CONFIG config;
+        std::string path;
+        std::string value;
+        ZCAN_LIN_INIT_CONFIG linConfig;
+        ZCAN_LIN_PUBLISH_CFG_EX publish;       // 每个帧ID一条记录，后设置的覆盖先设置的
+        bool publishExtended;
+        ZCAN_LIN_SUBSCIBE_CFG subscribe;
+    };
+
+    static bool IsLinKind(Operation::Kind kind);
+    // 通道初始化/启动：其前后的属性设置回放时须保持相对顺序
+    static bool IsChannelSetupKind(Operation::Kind kind);
+
+    void Run();
+    bool WaitFor(UINT ms);
+    DEVICE_HANDLE Replay(DeviceEvent* event);
+    void ReplayLin(DEVICE_HANDLE deviceHandle, const Operation& op, std::map<UINT, CHANNEL_HANDLE>* linChannels,
+                   DeviceEvent* event);
+    // 监视线程运行期间登记句柄，须持有operationsMutex_
+    void RegisterHandle(const void* handle);
+    void RetireHandles(DEVICE_HANDLE deviceHandle);
+    void EraseOperations(const std::function<bool(const Operation&)>& predicate);
+
+    const UINT deviceType_;
+    const UINT deviceIndex_;
+    const UINT reserved_;
+    std::atomic<DEVICE_HANDLE> deviceHandle_;
+    DeviceGateState& gate_;
+
+    std::mutex operationsMutex_;
+    bool gated_ = false;                           // 句柄已登记在闸门
+    std::vector<Operation> operations_;
+    std::map<UINT, CHANNEL_HANDLE> canHandles_;    // 当前设备上的通道句柄，关闭设备时登记为失效
+    std::map<UINT, CHANNEL_HANDLE> linHandles_;
+    const void* property_ = nullptr;
+
+    DeviceMonitorOptions options_;
+    EventCallback callback_;
+    HandleSwapCallback swapHandles_;
+
+    std::atomic<bool> online_{true};
+    std::atomic<UINT> reconnectCount_{0};
+    std::atomic<uint64_t> lastReconnectUs_{0};
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopRequested_ = false;
+    std::thread thread_;
+};
+
+#endif  // ZLGCAN_DEVICE_MONITOR_H_
@@ -0,0 +1,393 @@
+#include "e2e_protection.h"
+
+#include <algorithm>
+
+namespace {
+
+/**
+ * slice-by-8查表CRC
+ * 每次处理8字节：寄存器与前几个字节异或后，8个字节分别查表[7-i]再合并，
+ * 表[k]为单字节后接k个零字节的CRC。不足8字节的尾部逐字节查表[0]。
+ */
+template <typename T, int Width, bool Reflected>
+class SliceBy8 {
+public:
+    explicit SliceBy8(T poly) {
+        const T mask = Width == 64 ? ~T(0) : static_cast<T>((uint64_t(1) << Width) - 1);
+        for (UINT b = 0; b < 256; b++) {
+            T r;
+            if (Reflected) {
+                r = static_cast<T>(b);
+                for (int bit = 0; bit < 8; bit++) {
+                    r = (r & 1) ? static_cast<T>((r >> 1) ^ poly) : static_cast<T>(r >> 1);
+                }
+            } else {
+                r = static_cast<T>(T(b) << (Width - 8));
+                const T top = static_cast<T>(T(1) << (Width - 1));
+                for (int bit = 0; bit < 8; bit++) {
+                    r = (r & top) ? static_cast<T>(((r << 1) ^ poly) & mask) : static_cast<T>((r << 1) & mask);
+                }
+            }
+            table_[0][b] = r;
+        }
+        for (int k = 1; k < 8; k++) {
+            for (UINT b = 0; b < 256; b++) {
+                const T prev = table_[k - 1][b];
+                table_[k][b] = Reflected ? static_cast<T>((prev >> 8) ^ table_[0][prev & 0xFF])
+                                         : static_cast<T>(((Shl8(prev)) & mask) ^ table_[0][(prev >> (Width - 8)) & 0xFF]);
+            }
+        }
+        mask_ = mask;
+    }
+
+    T Update(const BYTE* data, size_t length, T crc) const {
+        while (length >= 8) {
+            BYTE b[8];
+            for (int i = 0; i < 8; i++) {
+                b[i] = data[i];
+                if (i < Width / 8) {
+                    b[i] ^= Reflected ? static_cast<BYTE>(crc >> (8 * i)) : static_cast<BYTE>(crc >> (Width - 8 - 8 * i));
+                }
+            }
+            crc = static_cast<T>(table_[7][b[0]] ^ table_[6][b[1]] ^ table_[5][b[2]] ^ table_[4][b[3]] ^
+                                 table_[3][b[4]] ^ table_[2][b[5]] ^ table_[1][b[6]] ^ table_[0][b[7]]);
+            data += 8;
+            length -= 8;
+        }
+        for (size_t i = 0; i < length; i++) {
+            crc = Reflected ? static_cast<T>((crc >> 8) ^ table_[0][(crc ^ data[i]) & 0xFF])
+                            : static_cast<T>((Shl8(crc) & mask_) ^ table_[0][((crc >> (Width - 8)) ^ data[i]) & 0xFF]);
+        }
+        return crc;
+    }
+
+private:
+    // 8位寄存器左移8位后为0，避免移位宽度等于类型宽度
+    static T Shl8(T value) { return Width == 8 ? T(0) : static_cast<T>(uint64_t(value) << 8); }
+
+    T table_[8][256];
+    T mask_;
+};
+
+const SliceBy8<uint8_t, 8, false>& Crc8Kernel() {
+    static const SliceBy8<uint8_t, 8, false> kernel(0x1D);
+    return kernel;
+}
+
+const SliceBy8<uint8_t, 8, false>& Crc8H2FKernel() {
+    static const SliceBy8<uint8_t, 8, false> kernel(0x2F);
+    return kernel;
+}
+
+const SliceBy8<uint16_t, 16, false>& Crc16Kernel() {
+    static const SliceBy8<uint16_t, 16, false> kernel(0x1021);
+    return kernel;
+}
+
+const SliceBy8<uint32_t, 32, true>& Crc32P4Kernel() {
+    static const SliceBy8<uint32_t, 32, true> kernel(0xC8DF352Fu);
+    return kernel;
+}
+
+const SliceBy8<uint64_t, 64, true>& Crc64Kernel() {
+    static const SliceBy8<uint64_t, 64, true> kernel(0xC96C5795D7870F42ULL);
+    return kernel;
+}
+
+// 头部字段，P04/P07为大端，P05的CRC为小端
+void PutBe(BYTE* p, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        p[i] = static_cast<BYTE>(value >> (8 * (bytes - 1 - i)));
+    }
+}
+
+uint64_t GetBe(const BYTE* p, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+// 各配置文件的最短长度
+size_t MinLength(const E2eConfig& config) {
+    switch (config.profile) {
+        case E2eProfile::P04: return config.offset + 12;
+        case E2eProfile::P05: return config.offset + 3;
+        case E2eProfile::P07: return config.offset + 20;
+        default: return config.offset + 2;
+    }
+}
+
+// 计算CRC（不含CRC字段本身），头部中的计数器、长度和DataID须已写入
+uint64_t ComputeCrc(const E2eConfig& config, const BYTE* data, size_t length, uint32_t counter) {
+    const UINT o = config.offset;
+    switch (config.profile) {
+        case E2eProfile::P01:
+        case E2eProfile::P11: {
+            // P01以起始值0xFF、IsFirstCall=FALSE调用CRC库，库先把起始值异或0xFF，寄存器实际从0x00开始；
+            // 库的结果异或与P01最后的异或0xFF相互抵消。P11以0xFF为初值并保留结果异或
+            const bool p11 = config.profile == E2eProfile::P11;
+            const BYTE id[2] = {static_cast<BYTE>(config.dataId), static_cast<BYTE>(config.dataId >> 8)};
+            uint8_t crc = E2eCrc8(id, 2, p11 ? 0xFF : 0x00);
+            crc = E2eCrc8(data, o, crc);
+            crc = E2eCrc8(data + o + 1, length - o - 1, crc);
+            return p11 ? static_cast<uint8_t>(crc ^ 0xFF) : crc;
+        }
+        case E2eProfile::P02: {
+            uint8_t crc = E2eCrc8H2F(data, o, 0xFF);
+            crc = E2eCrc8H2F(data + o + 1, length - o - 1, crc);
+            crc = E2eCrc8H2F(&config.dataIdList[counter & 0x0F], 1, crc);
+            return static_cast<uint8_t>(crc ^ 0xFF);
+        }
+        case E2eProfile::P04: {
+            uint32_t crc = E2eCrc32P4(data, o + 8, 0xFFFFFFFFu);
+            crc = E2eCrc32P4(data + o + 12, length - o - 12, crc);
+            return crc ^ 0xFFFFFFFFu;
+        }
+        case E2eProfile::P05: {
+            const BYTE id[2] = {static_cast<BYTE>(config.dataId), static_cast<BYTE>(config.dataId >> 8)};
+            uint16_t crc = E2eCrc16(data, o, 0xFFFF);
+            crc = E2eCrc16(data + o + 2, length - o - 2, crc);
+            return E2eCrc16(id, 2, crc);
+        }
+        case E2eProfile::P07: {
+            uint64_t crc = E2eCrc64(data, o, ~0ULL);
+            crc = E2eCrc64(data + o + 8, length - o - 8, crc);
+            return ~crc;
+        }
+    }
+    return 0;
+}
+
+UINT NormalizeId(UINT id) {
+    return id & (CAN_EFF_FLAG | CAN_EFF_MASK);
+}
+
+}  // namespace
+
+uint8_t E2eCrc8(const BYTE* data, size_t length, uint8_t crc) {
+    return Crc8Kernel().Update(data, length, crc);
+}
+
+uint8_t E2eCrc8H2F(const BYTE* data, size_t length, uint8_t crc) {
+    return Crc8H2FKernel().Update(data, length, crc);
+}
+
+uint16_t E2eCrc16(const BYTE* data, size_t length, uint16_t crc) {
+    return Crc16Kernel().Update(data, length, crc);
+}
+
+uint32_t E2eCrc32P4(const BYTE* data, size_t length, uint32_t crc) {
+    return Crc32P4Kernel().Update(data, length, crc);
+}
+
+uint64_t E2eCrc64(const BYTE* data, size_t length, uint64_t crc) {
+    return Crc64Kernel().Update(data, length, crc);
+}
+
+uint64_t E2eCounterModulo(E2eProfile profile) {
+    switch (profile) {
+        case E2eProfile::P01:
+        case E2eProfile::P11: return 15;   // 0xF保留
+        case E2eProfile::P02: return 16;
+        case E2eProfile::P04: return 0x10000;
+        case E2eProfile::P05: return 0x100;
+        case E2eProfile::P07: return 0x100000000ULL;
+    }
+    return 1;
+}
+
+bool E2eProtect(const E2eConfig& config, BYTE* data, size_t length, uint32_t counter) {
+    if (length < MinLength(config)) {
+        return false;
+    }
+    counter = static_cast<uint32_t>(counter % E2eCounterModulo(config.profile));
+    const UINT o = config.offset;
+    switch (config.profile) {
+        case E2eProfile::P01:
+        case E2eProfile::P02:
+        case E2eProfile::P11:
+            data[o + 1] = static_cast<BYTE>((data[o + 1] & 0xF0) | (counter & 0x0F));
+            data[o] = static_cast<BYTE>(ComputeCrc(config, data, length, counter));
+            break;
+        case E2eProfile::P04:
+            if (length > 0xFFFF) {
+                return false;
+            }
+            PutBe(data + o, length, 2);
+            PutBe(data + o + 2, counter, 2);
+            PutBe(data + o + 4, config.dataId, 4);
+            PutBe(data + o + 8, ComputeCrc(config, data, length, counter), 4);
+            break;
+        case E2eProfile::P05: {
+            data[o + 2] = static_cast<BYTE>(counter);
+            const uint16_t crc = static_cast<uint16_t>(ComputeCrc(config, data, length, counter));
+            data[o] = static_cast<BYTE>(crc);
+            data[o + 1] = static_cast<BYTE>(crc >> 8);
+            break;
+        }
+        case E2eProfile::P07:
+            PutBe(data + o + 8, length, 4);
+            PutBe(data + o + 12, counter, 4);
+            PutBe(data + o + 16, config.dataId, 4);
+            PutBe(data + o, ComputeCrc(config, data, length, counter), 8);
+            break;
+    }
+    return true;
+}
+
+E2eStatus E2eCheck(const E2eConfig& config, const BYTE* data, size_t length, E2eCheckState* state, uint32_t* counter) {
+    *counter = 0;
+    if (length < MinLength(config)) {
+        return E2eStatus::BadLength;
+    }
+
+    const UINT o = config.offset;
+    uint64_t received = 0;
+    switch (config.profile) {
+        case E2eProfile::P01:
+        case E2eProfile::P02:
+        case E2eProfile::P11:
+            *counter = data[o + 1] & 0x0F;
+            received = data[o];
+            break;
+        case E2eProfile::P04:
+            *counter = static_cast<uint32_t>(GetBe(data + o + 2, 2));
+            received = GetBe(data + o + 8, 4);
+            break;
+        case E2eProfile::P05:
+            *counter = data[o + 2];
+            received = data[o] | (static_cast<uint64_t>(data[o + 1]) << 8);
+            break;
+        case E2eProfile::P07:
+            *counter = static_cast<uint32_t>(GetBe(data + o + 12, 4));
+            received = GetBe(data + o, 8);
+            break;
+    }
+
+    if (ComputeCrc(config, data, length, *counter) != received) {
+        return E2eStatus::WrongCrc;
+    }
+    if (config.profile == E2eProfile::P04 || config.profile == E2eProfile::P07) {
+        const int lengthBytes = config.profile == E2eProfile::P04 ? 2 : 4;
+        const UINT lengthOffset = config.profile == E2eProfile::P04 ? o : o + 8;
+        const UINT dataIdOffset = config.profile == E2eProfile::P04 ? o + 4 : o + 16;
+        if (GetBe(data + lengthOffset, lengthBytes) != length) {
+            return E2eStatus::BadLength;
+        }
+        if (GetBe(data + dataIdOffset, 4) != config.dataId) {
+            return E2eStatus::WrongDataId;
+        }
+    }
+
+    const uint64_t modulo = E2eCounterModulo(config.profile);
+    if (*counter >= modulo) {
+        return E2eStatus::WrongSequence;
+    }
+    if (!state->initialized) {
+        state->initialized = true;
+        state->lastCounter = *counter;
+        return E2eStatus::Ok;
+    }
+    const uint64_t delta = (*counter + modulo - state->lastCounter) % modulo;
+    state->lastCounter = *counter;
+    if (delta == 0) {
+        return E2eStatus::Repeated;
+    }
+    return delta > config.maxDeltaCounter ? E2eStatus::WrongSequence : E2eStatus::Ok;
+}
+
+void E2eTransmitProtector::Set(UINT id, const E2eConfig& config) {
+    Entry& entry = entries_[NormalizeId(id)];
+    entry.config = config;
+    entry.counter = 0;
+}
+
+bool E2eTransmitProtector::Apply(UINT canId, BYTE* data, size_t length) {
+    auto it = entries_.find(NormalizeId(canId));
+    if (it == entries_.end()) {
+        return false;
+    }
+    Entry& entry = it->second;
+    if (E2eProtect(entry.config, data, length, entry.counter)) {
+        entry.counter = static_cast<uint32_t>((uint64_t(entry.counter) + 1) % E2eCounterModulo(entry.config.profile));
+    }
+    return true;
+}
+
+E2eMonitor::E2eMonitor(const std::vector<std::pair<UINT, E2eConfig>>& configs, UINT maxBatch, BatchCallback callback)
+    : maxBatch_(std::max<UINT>(1, maxBatch)), callback_(std::move(callback)) {
+    for (const auto& item : configs) {
+        Entry& entry = entries_[NormalizeId(item.first)];
+        entry.config = item.second;
+        entry.stats.id = NormalizeId(item.first);
+    }
+}
+
+std::vector<E2eIdStats> E2eMonitor::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<E2eIdStats> result;
+    result.reserve(entries_.size());
+    for (const auto& item : entries_) {
+        result.push_back(item.second.stats);
+    }
+    std::sort(result.begin(), result.end(), [](const E2eIdStats& a, const E2eIdStats& b) { return a.id < b.id; });
+    return result;
+}
+
+bool E2eMonitor::OnFrame(const ZCAN_ReceiveFD_Data& frame, bool fd) {
+    // 本通道发出的回显不检查
+    if ((frame.frame.flags & TX_ECHO_FLAG) || (frame.frame.can_id & (CAN_RTR_FLAG | CAN_ERR_FLAG))) {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = entries_.find(NormalizeId(frame.frame.can_id));
+    if (it == entries_.end()) {
+        return false;
+    }
+
+    Entry& entry = it->second;
+    uint32_t counter = 0;
+    const E2eStatus status = E2eCheck(entry.config, frame.frame.data, std::min<size_t>(frame.frame.len, CANFD_MAX_DLEN),
+                                      &entry.state, &counter);
+    E2eIdStats& stats = entry.stats;
+    stats.lastStatus = status;
+    stats.lastCounter = counter;
+    switch (status) {
+        case E2eStatus::Ok: stats.ok++; break;
+        case E2eStatus::Repeated: stats.repeated++; break;
+        case E2eStatus::WrongSequence: stats.wrongSequence++; break;
+        case E2eStatus::WrongCrc: stats.wrongCrc++; break;
+        case E2eStatus::WrongDataId: stats.wrongDataId++; break;
+        case E2eStatus::BadLength: stats.badLength++; break;
+    }
+
+    if (status != E2eStatus::Ok && callback_) {
+        E2eFailure failure;
+        failure.id = stats.id;
+        failure.status = status;
+        failure.counter = counter;
+        failure.timestamp = frame.timestamp;
+        pending_.push_back(failure);
+        if (pending_.size() >= maxBatch_) {
+            std::vector<E2eFailure> batch;
+            batch.swap(pending_);
+            lock.unlock();
+            callback_(std::move(batch));
+        }
+    }
+    return false;
+}
+
+void E2eMonitor::OnTick(std::chrono::steady_clock::time_point now) {
+    std::vector<E2eFailure> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_.empty()) {
+            return;
+        }
+        batch.swap(pending_);
+    }
+    callback_(std::move(batch));
+}
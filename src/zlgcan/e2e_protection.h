@@ -0,0 +1,151 @@
+#ifndef ZLGCAN_E2E_PROTECTION_H_
+#define ZLGCAN_E2E_PROTECTION_H_
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "zlgcan.h"
+#include "receive_pump.h"
+
+// ==================== CRC ====================
+// 均为查表slice-by-8实现，参数和返回值为CRC寄存器（不含初值和结果异或），可分段连续计算
+
+// CRC8 SAE J1850，多项式0x1D
+uint8_t E2eCrc8(const BYTE* data, size_t length, uint8_t crc);
+// CRC8H2F，多项式0x2F
+uint8_t E2eCrc8H2F(const BYTE* data, size_t length, uint8_t crc);
+// CRC16 CCITT，多项式0x1021
+uint16_t E2eCrc16(const BYTE* data, size_t length, uint16_t crc);
+// CRC32P4，反射多项式0xC8DF352F（0xF4ACFB13）
+uint32_t E2eCrc32P4(const BYTE* data, size_t length, uint32_t crc);
+// CRC64 ECMA-182，反射多项式0xC96C5795D7870F42（0x42F0E1EBA9EA3693）
+uint64_t E2eCrc64(const BYTE* data, size_t length, uint64_t crc);
+
+// ==================== E2E配置 ====================
+
+// E2E配置文件
+enum class E2eProfile : uint8_t {
+    P01,                               // CRC8 J1850（初值0x00，无结果异或）+ 4位计数器，DataID两字节参与CRC
+    P02,                               // CRC8H2F + 4位计数器，DataID按计数器从列表中选取
+    P04,                               // 12字节头：长度、16位计数器、DataID、CRC32P4
+    P05,                               // 3字节头：CRC16 + 8位计数器，DataID参与CRC
+    P07,                               // 20字节头：CRC64、长度、32位计数器、DataID
+    P11,                               // 与P01布局相同，CRC初值0xFF并带结果异或
+};
+
+struct E2eConfig {
+    E2eProfile profile = E2eProfile::P01;
+    uint32_t dataId = 0;
+    std::array<BYTE, 16> dataIdList{}; // P02
+    UINT offset = 0;                   // 头部起始字节；P01/P02/P11为CRC字节，计数器在下一字节低4位
+    UINT maxDeltaCounter = 1;          // 接收时允许的计数器跳变
+};
+
+// 接收检查结果
+enum class E2eStatus : uint8_t {
+    Ok,
+    Repeated,                          // 计数器未变化
+    WrongSequence,                     // 计数器跳变超过maxDeltaCounter
+    WrongCrc,
+    WrongDataId,                       // 头部中的DataID与配置不一致（P04/P07）
+    BadLength,                         // 报文短于头部或长度字段不一致
+};
+
+// 单个ID的接收状态
+struct E2eCheckState {
+    bool initialized = false;
+    uint32_t lastCounter = 0;
+};
+
+// 计数器取值个数
+uint64_t E2eCounterModulo(E2eProfile profile);
+
+// 写入计数器、长度、DataID和CRC；报文长度不足时返回false
+bool E2eProtect(const E2eConfig& config, BYTE* data, size_t length, uint32_t counter);
+
+// 检查CRC和计数器并更新state；counter返回报文中的计数器
+E2eStatus E2eCheck(const E2eConfig& config, const BYTE* data, size_t length, E2eCheckState* state, uint32_t* counter);
+
+// ==================== 发送保护 ====================
+
+/**
+ * 发送路径的E2E保护
+ * 按CAN ID保存配置和发送计数器，transmit/transmitFD在调用驱动前对匹配的帧写入E2E头。
+ */
+class E2eTransmitProtector {
+public:
+    void Set(UINT id, const E2eConfig& config);
+    bool Empty() const { return entries_.empty(); }
+
+    // 对匹配ID的帧加保护并递增计数器，返回是否匹配
+    bool Apply(UINT canId, BYTE* data, size_t length);
+
+private:
+    struct Entry {
+        E2eConfig config;
+        uint32_t counter = 0;
+    };
+
+    std::unordered_map<UINT, Entry> entries_;
+};
+
+// ==================== 接收检查 ====================
+
+// 单个ID的检查统计
+struct E2eIdStats {
+    UINT id = 0;
+    uint64_t ok = 0;
+    uint64_t repeated = 0;
+    uint64_t wrongSequence = 0;
+    uint64_t wrongCrc = 0;
+    uint64_t wrongDataId = 0;
+    uint64_t badLength = 0;
+    E2eStatus lastStatus = E2eStatus::Ok;
+    uint32_t lastCounter = 0;
+};
+
+// 检查失败事件
+struct E2eFailure {
+    UINT id = 0;
+    E2eStatus status = E2eStatus::Ok;
+    uint32_t counter = 0;
+    uint64_t timestamp = 0;            // 设备时间戳(us)
+};
+
+/**
+ * 接收路径的E2E检查
+ * 作为接收线程的监听者，按ID检查每批帧的CRC和计数器，不认领帧（帧仍进入receive()的缓冲）。
+ * 失败事件在每轮轮询末尾整批交给回调（在接收线程中执行），统计按ID累计。
+ */
+class E2eMonitor : public FrameListener {
+public:
+    using BatchCallback = std::function<void(std::vector<E2eFailure>&& failures)>;
+
+    // callback可为空，此时只累计统计
+    E2eMonitor(const std::vector<std::pair<UINT, E2eConfig>>& configs, UINT maxBatch, BatchCallback callback);
+
+    std::vector<E2eIdStats> Stats() const;
+
+    bool OnFrame(const ZCAN_ReceiveFD_Data& frame, bool fd) override;
+    void OnTick(std::chrono::steady_clock::time_point now) override;
+
+private:
+    struct Entry {
+        E2eConfig config;
+        E2eCheckState state;
+        E2eIdStats stats;
+    };
+
+    const UINT maxBatch_;
+    const BatchCallback callback_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<UINT, Entry> entries_;
+    std::vector<E2eFailure> pending_;
+};
+
+#endif  // ZLGCAN_E2E_PROTECTION_H_
@@ -0,0 +1,371 @@
+#include "firmware_image.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+int HexValue(uint8_t c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// 解码一行中的十六进制字节，返回false表示包含非法字符
+bool DecodeHex(const uint8_t* text, size_t length, std::vector<uint8_t>* bytes) {
+    if (length % 2 != 0) {
+        return false;
+    }
+    bytes->resize(length / 2);
+    for (size_t i = 0; i < bytes->size(); i++) {
+        int hi = HexValue(text[2 * i]);
+        int lo = HexValue(text[2 * i + 1]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        (*bytes)[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+
+// 逐行遍历文本，回调返回false时停止
+template <typename Fn>
+bool ForEachLine(const uint8_t* data, size_t size, Fn fn) {
+    size_t lineNo = 0;
+    size_t pos = 0;
+    while (pos < size) {
+        size_t end = pos;
+        while (end < size && data[end] != '\n' && data[end] != '\r') {
+            end++;
+        }
+        lineNo++;
+        size_t begin = pos;
+        size_t stop = end;
+        while (begin < stop && std::isspace(data[begin])) begin++;
+        while (stop > begin && std::isspace(data[stop - 1])) stop--;
+        if (stop > begin && !fn(data + begin, stop - begin, lineNo)) {
+            return false;
+        }
+        pos = end;
+        while (pos < size && (data[pos] == '\n' || data[pos] == '\r')) {
+            pos++;
+        }
+    }
+    return true;
+}
+
+bool EndsWithNoCase(const std::string& str, const char* suffix) {
+    const size_t n = strlen(suffix);
+    if (str.size() < n) {
+        return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (std::tolower(static_cast<unsigned char>(str[str.size() - n + i])) != suffix[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+// ==================== MappedFile ====================
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::string& path, std::string* error) {
+    Close();
+#ifdef _WIN32
+    int wideLength = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    std::wstring widePath(wideLength > 0 ? wideLength : 0, L'\0');
+    if (wideLength > 0) {
+        MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &widePath[0], wideLength);
+    }
+
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        *error = "无法打开文件: " + path;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        *error = "无法获取文件大小: " + path;
+        return false;
+    }
+    file_ = file;
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+    if (size_ == 0) {
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        Close();
+        *error = "无法映射文件: " + path;
+        return false;
+    }
+    mapping_ = mapping;
+    data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        *error = "无法打开文件: " + path;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        *error = "无法获取文件大小: " + path;
+        return false;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ == 0) {
+        close(fd);
+        return true;
+    }
+    void* mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped != MAP_FAILED) {
+        madvise(mapped, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const uint8_t*>(mapped);
+    }
+#endif
+    if (data_ == nullptr) {
+        Close();
+        *error = "无法映射文件: " + path;
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_ != nullptr) {
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+    }
+    if (file_ != nullptr) {
+        CloseHandle(file_);
+        file_ = nullptr;
+    }
+#else
+    if (data_ != nullptr) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+// ==================== FirmwareImage ====================
+
+FirmwareFormat FirmwareImage::DetectFormat(const std::string& path, const uint8_t* data, size_t size) {
+    if (EndsWithNoCase(path, ".hex") || EndsWithNoCase(path, ".ihex")) {
+        return FirmwareFormat::IntelHex;
+    }
+    if (EndsWithNoCase(path, ".s19") || EndsWithNoCase(path, ".s28") || EndsWithNoCase(path, ".s37") ||
+        EndsWithNoCase(path, ".srec") || EndsWithNoCase(path, ".mot")) {
+        return FirmwareFormat::SRecord;
+    }
+    if (EndsWithNoCase(path, ".bin")) {
+        return FirmwareFormat::Binary;
+    }
+    // 未知扩展名按首字符判断
+    if (size > 0 && data[0] == ':') {
+        return FirmwareFormat::IntelHex;
+    }
+    if (size > 1 && data[0] == 'S' && data[1] >= '0' && data[1] <= '9') {
+        return FirmwareFormat::SRecord;
+    }
+    return FirmwareFormat::Binary;
+}
+
+bool FirmwareImage::Load(const std::string& path, FirmwareFormat format, uint32_t baseAddress, std::string* error) {
+    blocks_.clear();
+    segments_.clear();
+    if (!file_.Open(path, error)) {
+        return false;
+    }
+
+    format_ = format == FirmwareFormat::Auto ? DetectFormat(path, file_.Data(), file_.Size()) : format;
+    bool ok = true;
+    switch (format_) {
+        case FirmwareFormat::IntelHex:
+            ok = ParseIntelHex(file_.Data(), file_.Size(), error);
+            break;
+        case FirmwareFormat::SRecord:
+            ok = ParseSRecord(file_.Data(), file_.Size(), error);
+            break;
+        default:
+            if (file_.Size() > 0) {
+                segments_.push_back({baseAddress, file_.Data(), file_.Size()});
+            }
+            return true;
+    }
+
+    // 文本格式解析完成后不再需要映射
+    file_.Close();
+    if (!ok) {
+        blocks_.clear();
+        return false;
+    }
+    BuildSegments();
+    return true;
+}
+
+size_t FirmwareImage::TotalSize() const {
+    size_t total = 0;
+    for (const auto& segment : segments_) {
+        total += segment.size;
+    }
+    return total;
+}
+
+void FirmwareImage::AppendBytes(uint32_t address, const uint8_t* bytes, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    // 记录通常按地址顺序排列，与上一块相邻时直接追加
+    if (!blocks_.empty()) {
+        Block& last = blocks_.back();
+        if (last.address + last.bytes.size() == address) {
+            last.bytes.insert(last.bytes.end(), bytes, bytes + count);
+            return;
+        }
+    }
+    blocks_.push_back({address, std::vector<uint8_t>(bytes, bytes + count)});
+}
+
+void FirmwareImage::BuildSegments() {
+    std::stable_sort(blocks_.begin(), blocks_.end(),
+                     [](const Block& a, const Block& b) { return a.address < b.address; });
+
+    // 乱序记录排序后再次合并相邻块，重叠部分以后出现的记录为准
+    std::vector<Block> merged;
+    for (auto& block : blocks_) {
+        if (!merged.empty()) {
+            Block& last = merged.back();
+            const uint64_t lastEnd = static_cast<uint64_t>(last.address) + last.bytes.size();
+            if (block.address <= lastEnd) {
+                const size_t offset = block.address - last.address;
+                const size_t overlap = std::min<size_t>(last.bytes.size() - offset, block.bytes.size());
+                std::copy(block.bytes.begin(), block.bytes.begin() + overlap, last.bytes.begin() + offset);
+                last.bytes.insert(last.bytes.end(), block.bytes.begin() + overlap, block.bytes.end());
+                continue;
+            }
+        }
+        merged.push_back(std::move(block));
+    }
+    blocks_.swap(merged);
+
+    for (const auto& block : blocks_) {
+        segments_.push_back({block.address, block.bytes.data(), block.bytes.size()});
+    }
+}
+
+bool FirmwareImage::ParseIntelHex(const uint8_t* data, size_t size, std::string* error) {
+    uint32_t upperAddress = 0;
+    bool finished = false;
+    std::vector<uint8_t> record;
+
+    bool ok = ForEachLine(data, size, [&](const uint8_t* line, size_t length, size_t lineNo) {
+        if (finished) {
+            return true;
+        }
+        if (line[0] != ':' || !DecodeHex(line + 1, length - 1, &record) || record.size() < 5 ||
+            record.size() != static_cast<size_t>(record[0]) + 5) {
+            *error = "Intel HEX格式错误，行" + std::to_string(lineNo);
+            return false;
+        }
+        uint8_t checksum = 0;
+        for (uint8_t b : record) {
+            checksum += b;
+        }
+        if (checksum != 0) {
+            *error = "Intel HEX校验和错误，行" + std::to_string(lineNo);
+            return false;
+        }
+
+        const uint8_t count = record[0];
+        const uint16_t offset = static_cast<uint16_t>((record[1] << 8) | record[2]);
+        const uint8_t type = record[3];
+        const uint8_t* payload = record.data() + 4;
+        switch (type) {
+            case 0x00:
+                AppendBytes(upperAddress + offset, payload, count);
+                break;
+            case 0x01:
+                finished = true;
+                break;
+            case 0x02:  // 扩展段地址
+                if (count == 2) upperAddress = static_cast<uint32_t>((payload[0] << 8) | payload[1]) << 4;
+                break;
+            case 0x04:  // 扩展线性地址
+                if (count == 2) upperAddress = static_cast<uint32_t>((payload[0] << 8) | payload[1]) << 16;
+                break;
+            default:    // 03/05为起始地址，与下载无关
+                break;
+        }
+        return true;
+    });
+    return ok;
+}
+
+bool FirmwareImage::ParseSRecord(const uint8_t* data, size_t size, std::string* error) {
+    std::vector<uint8_t> record;
+
+    return ForEachLine(data, size, [&](const uint8_t* line, size_t length, size_t lineNo) {
+        if (length < 4 || line[0] != 'S' || !DecodeHex(line + 2, length - 2, &record) || record.empty() ||
+            record.size() != static_cast<size_t>(record[0]) + 1) {
+            *error = "S-record格式错误，行" + std::to_string(lineNo);
+            return false;
+        }
+        uint8_t checksum = 0;
+        for (uint8_t b : record) {
+            checksum += b;
+        }
+        if (checksum != 0xFF) {
+            *error = "S-record校验和错误，行" + std::to_string(lineNo);
+            return false;
+        }
+
+        size_t addressLength;
+        switch (line[1]) {
+            case '1': addressLength = 2; break;
+            case '2': addressLength = 3; break;
+            case '3': addressLength = 4; break;
+            default:  return true;   // S0头、S5/S6计数、S7-S9结束记录
+        }
+        if (record.size() < 2 + addressLength) {
+            *error = "S-record长度错误，行" + std::to_string(lineNo);
+            return false;
+        }
+        uint32_t address = 0;
+        for (size_t i = 0; i < addressLength; i++) {
+            address = (address << 8) | record[1 + i];
+        }
+        AppendBytes(address, record.data() + 1 + addressLength, record.size() - 2 - addressLength);
+        return true;
+    });
+}
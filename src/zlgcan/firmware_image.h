@@ -0,0 +1,80 @@
+#ifndef ZLGCAN_FIRMWARE_IMAGE_H_
+#define ZLGCAN_FIRMWARE_IMAGE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 固件文件格式
+enum class FirmwareFormat : uint8_t { Auto, IntelHex, SRecord, Binary };
+
+// 连续地址段
+struct FirmwareSegment {
+    uint32_t address = 0;
+    const uint8_t* data = nullptr;     // 指向映射文件（二进制）或解析缓冲区，生命周期同FirmwareImage
+    size_t size = 0;
+};
+
+/**
+ * 只读内存映射文件
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // path为UTF-8编码
+    bool Open(const std::string& path, std::string* error);
+    void Close();
+
+    const uint8_t* Data() const { return data_; }
+    size_t Size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+
+/**
+ * 固件映像
+ * 以内存映射方式读取文件：二进制文件的数据段直接指向映射内存，
+ * Intel HEX/S-record按记录解析并合并相邻地址为连续段。
+ */
+class FirmwareImage {
+public:
+    // baseAddress仅用于二进制文件
+    bool Load(const std::string& path, FirmwareFormat format, uint32_t baseAddress, std::string* error);
+
+    const std::vector<FirmwareSegment>& Segments() const { return segments_; }
+    size_t TotalSize() const;
+    FirmwareFormat Format() const { return format_; }
+
+    static FirmwareFormat DetectFormat(const std::string& path, const uint8_t* data, size_t size);
+
+private:
+    bool ParseIntelHex(const uint8_t* data, size_t size, std::string* error);
+    bool ParseSRecord(const uint8_t* data, size_t size, std::string* error);
+    void AppendBytes(uint32_t address, const uint8_t* bytes, size_t count);
+    void BuildSegments();
+
+    struct Block {
+        uint32_t address;
+        std::vector<uint8_t> bytes;
+    };
+
+    MappedFile file_;
+    FirmwareFormat format_ = FirmwareFormat::Binary;
+    std::vector<Block> blocks_;        // 文本格式解析结果
+    std::vector<FirmwareSegment> segments_;
+};
+
+#endif  // ZLGCAN_FIRMWARE_IMAGE_H_
@@ -0,0 +1,448 @@
+#include "flash_pipeline.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+
+namespace {
+
+constexpr BYTE SID_REQUEST_DOWNLOAD = 0x34;
+constexpr BYTE SID_TRANSFER_DATA = 0x36;
+constexpr BYTE SID_REQUEST_TRANSFER_EXIT = 0x37;
+constexpr BYTE SID_ROUTINE_CONTROL = 0x31;
+constexpr BYTE ROUTINE_START = 0x01;
+constexpr BYTE SID_NEGATIVE_RESPONSE = 0x7F;
+constexpr BYTE POSITIVE_RESPONSE_OFFSET = 0x40;
+constexpr BYTE NRC_RESPONSE_PENDING = 0x78;
+
+// CRC线程每次处理的数据量，便于及时响应取消
+constexpr size_t CRC_CHUNK_SIZE = 64 * 1024;
+
+// STmin可编码的最大值（ISO 15765-2 0x7F = 127ms）
+constexpr int MAX_STMIN_US = 127000;
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t ElapsedUs(Clock::time_point from, Clock::time_point to) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+}
+
+std::string HexByte(BYTE value) {
+    char buf[8];
+    snprintf(buf, sizeof(buf), "0x%02X", value);
+    return buf;
+}
+
+void AppendBigEndian(std::vector<BYTE>* out, uint64_t value, UINT bytes) {
+    for (UINT i = bytes; i > 0; i--) {
+        out->push_back(static_cast<BYTE>(value >> (8 * (i - 1))));
+    }
+}
+
+}  // namespace
+
+// 预组块队列：生产线程按序号组好0x36请求，下载线程依次取出
+struct FlashPipeline::BlockQueue {
+    explicit BlockQueue(size_t depth) : depth(std::max<size_t>(depth, 1)) {}
+
+    bool Push(std::vector<BYTE> block) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return stopped || blocks.size() < depth; });
+        if (stopped) {
+            return false;
+        }
+        blocks.push_back(std::move(block));
+        cv.notify_all();
+        return true;
+    }
+
+    bool Pop(std::vector<BYTE>* block) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return stopped || finished || !blocks.empty(); });
+        if (stopped || blocks.empty()) {
+            return false;
+        }
+        *block = std::move(blocks.front());
+        blocks.pop_front();
+        cv.notify_all();
+        return true;
+    }
+
+    void Finish() {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+        cv.notify_all();
+    }
+
+    void Stop() {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+        cv.notify_all();
+    }
+
+    const size_t depth;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::vector<BYTE>> blocks;
+    bool finished = false;
+    bool stopped = false;
+};
+
+FlashPipeline::FlashPipeline(std::shared_ptr<IsoTpEngine> engine, UINT sessionId, std::string path,
+                             FirmwareFormat format, uint32_t baseAddress, const FlashOptions& options,
+                             ProgressCallback progress)
+    : engine_(std::move(engine)), sessionId_(sessionId), path_(std::move(path)), format_(format),
+      baseAddress_(baseAddress), options_(options), progress_(std::move(progress)) {
+}
+
+uint32_t FlashPipeline::Crc32(uint32_t crc, const uint8_t* data, size_t size) {
+    static const auto table = [] {
+        std::vector<uint32_t> t(256);
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+void FlashPipeline::Cancel() {
+    {
+        std::lock_guard<std::mutex> lock(responseMutex_);
+        cancelled_.store(true);
+    }
+    responseCv_.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(crcMutex_);
+    }
+    crcCv_.notify_all();
+}
+
+void FlashPipeline::OnIsoTpEvent(const IsoTpEvent& event) {
+    if (event.type != IsoTpEvent::Type::Message) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(responseMutex_);
+        responses_.push_back(event.data);
+    }
+    responseCv_.notify_all();
+}
+
+FlashResult FlashPipeline::Run() {
+    FlashResult result;
+    startedAt_ = Clock::now();
+    lastProgressAt_ = startedAt_;
+    // 发送间隔从ECU流控中的STmin开始，ISO 15765-2不允许比它更快
+    stMinUs_ = -1;
+
+    std::string error;
+    if (!image_.Load(path_, format_, baseAddress_, &error)) {
+        result.error = error;
+        return result;
+    }
+    const std::vector<FirmwareSegment>& segments = image_.Segments();
+    if (segments.empty()) {
+        result.error = "固件中没有数据";
+        return result;
+    }
+    result.totalBytes = image_.TotalSize();
+    for (const auto& segment : segments) {
+        FlashSegmentResult segmentResult;
+        segmentResult.address = segment.address;
+        segmentResult.size = segment.size;
+        result.segments.push_back(segmentResult);
+    }
+
+    // CRC与传输并行计算，每段算完即可用于该段的校验例程
+    {
+        std::lock_guard<std::mutex> lock(crcMutex_);
+        segmentCrcs_.assign(segments.size(), 0);
+        crcDone_ = 0;
+    }
+    uint32_t imageCrc = 0;
+    std::thread crcThread([this, &segments, &imageCrc]() {
+        for (size_t i = 0; i < segments.size() && !cancelled_.load(); i++) {
+            uint32_t crc = 0;
+            for (size_t offset = 0; offset < segments[i].size && !cancelled_.load(); offset += CRC_CHUNK_SIZE) {
+                const size_t n = std::min(CRC_CHUNK_SIZE, segments[i].size - offset);
+                crc = Crc32(crc, segments[i].data + offset, n);
+                imageCrc = Crc32(imageCrc, segments[i].data + offset, n);
+            }
+            {
+                std::lock_guard<std::mutex> lock(crcMutex_);
+                segmentCrcs_[i] = crc;
+                crcDone_ = i + 1;
+            }
+            crcCv_.notify_all();
+        }
+    });
+
+    bool ok = true;
+    for (size_t i = 0; i < segments.size() && ok; i++) {
+        ok = DownloadSegment(segments[i], static_cast<UINT>(i), &result);
+    }
+    crcThread.join();
+
+    for (size_t i = 0; i < segments.size(); i++) {
+        result.segments[i].crc32 = segmentCrcs_[i];
+    }
+    result.imageCrc32 = imageCrc;
+    result.success = ok;
+    result.stMinUs = stMinUs_;
+    result.elapsedUs = ElapsedUs(startedAt_, Clock::now());
+    result.bytesPerSec = result.elapsedUs > 0
+        ? static_cast<double>(result.bytesSent) * 1000000.0 / static_cast<double>(result.elapsedUs) : 0;
+    if (ok) {
+        ReportProgress(static_cast<UINT>(segments.size() - 1), &result, true);
+    }
+    return result;
+}
+
+bool FlashPipeline::DownloadSegment(const FirmwareSegment& segment, UINT index, FlashResult* result) {
+    const UINT addressBytes = options_.addressAndLengthFormat & 0x0F;
+    const UINT sizeBytes = options_.addressAndLengthFormat >> 4;
+    if (addressBytes < 1 || addressBytes > 4 || sizeBytes < 1 || sizeBytes > 4) {
+        result->error = "addressAndLengthFormat无效";
+        return false;
+    }
+
+    // RequestDownload
+    std::vector<BYTE> request = {SID_REQUEST_DOWNLOAD, options_.dataFormatIdentifier, options_.addressAndLengthFormat};
+    AppendBigEndian(&request, segment.address, addressBytes);
+    AppendBigEndian(&request, segment.size, sizeBytes);
+
+    std::vector<BYTE> response;
+    if (Request(request, &response, result, false) != ResponseStatus::Positive) {
+        return false;
+    }
+    const UINT lengthBytes = response.size() > 1 ? response[1] >> 4 : 0;
+    if (lengthBytes == 0 || lengthBytes > 4 || response.size() < 2 + lengthBytes) {
+        result->error = "0x34响应格式错误";
+        return false;
+    }
+    UINT maxBlockLength = 0;
+    for (UINT i = 0; i < lengthBytes; i++) {
+        maxBlockLength = (maxBlockLength << 8) | response[2 + i];
+    }
+    if (options_.maxBlockLength > 0) {
+        maxBlockLength = std::min(maxBlockLength, options_.maxBlockLength);
+    }
+    if (maxBlockLength < 3) {
+        result->error = "maxNumberOfBlockLength过小";
+        return false;
+    }
+    blockLength_ = maxBlockLength;
+    result->blockLength = maxBlockLength;
+
+    // 当前块传输期间预先组好后续块
+    const size_t chunkSize = maxBlockLength - 2;
+    BlockQueue queue(options_.pipelineDepth);
+    std::thread producer([&segment, &queue, chunkSize]() {
+        BYTE sequence = 1;
+        for (size_t offset = 0; offset < segment.size; offset += chunkSize) {
+            const size_t n = std::min(chunkSize, segment.size - offset);
+            std::vector<BYTE> block;
+            block.reserve(2 + n);
+            block.push_back(SID_TRANSFER_DATA);
+            block.push_back(sequence++);  // 0xFF之后回绕到0x00
+            block.insert(block.end(), segment.data + offset, segment.data + offset + n);
+            if (!queue.Push(std::move(block))) {
+                return;
+            }
+        }
+        queue.Finish();
+    });
+
+    bool ok = true;
+    UINT blocks = 0;
+    std::vector<BYTE> block;
+    while (queue.Pop(&block)) {
+        if (Request(block, &response, result, true) != ResponseStatus::Positive) {
+            ok = false;
+            break;
+        }
+        if (response.size() < 2 || response[1] != block[1]) {
+            result->error = "0x36响应的序号不匹配";
+            ok = false;
+            break;
+        }
+        result->bytesSent += block.size() - 2;
+        blocks++;
+        ReportProgress(index, result, false);
+    }
+    queue.Stop();
+    producer.join();
+    result->segments[index].blocks = blocks;
+    if (!ok) {
+        return false;
+    }
+
+    // RequestTransferExit
+    if (Request({SID_REQUEST_TRANSFER_EXIT}, &response, result, false) != ResponseStatus::Positive) {
+        return false;
+    }
+    return options_.checkMemoryRoutineId == 0 || CheckSegment(index, result);
+}
+
+bool FlashPipeline::CheckSegment(UINT index, FlashResult* result) {
+    uint32_t crc = 0;
+    {
+        std::unique_lock<std::mutex> lock(crcMutex_);
+        crcCv_.wait(lock, [this, index] { return cancelled_.load() || crcDone_ > index; });
+        if (crcDone_ <= index) {
+            result->error = "已取消";
+            return false;
+        }
+        crc = segmentCrcs_[index];
+    }
+
+    // RoutineControl startRoutine：routineIdentifier + 该段CRC32（大端）
+    const UINT routineId = options_.checkMemoryRoutineId;
+    std::vector<BYTE> request = {SID_ROUTINE_CONTROL, ROUTINE_START,
+                                 static_cast<BYTE>(routineId >> 8), static_cast<BYTE>(routineId)};
+    AppendBigEndian(&request, crc, 4);
+
+    std::vector<BYTE> response;
+    if (Request(request, &response, result, false) != ResponseStatus::Positive) {
+        return false;
+    }
+    if (response.size() < 4 || response[1] != ROUTINE_START || response[2] != request[2] || response[3] != request[3]) {
+        result->error = "0x31响应格式错误";
+        return false;
+    }
+    // routineStatusRecord首字节非0表示ECU计算的CRC与发送的不一致
+    if (response.size() > 4 && response[4] != 0) {
+        result->error = "段" + std::to_string(index) + " CRC校验失败 (状态 " + HexByte(response[4]) + ")";
+        return false;
+    }
+    result->segments[index].crcVerified = true;
+    return true;
+}
+
+FlashPipeline::ResponseStatus FlashPipeline::Request(const std::vector<BYTE>& request, std::vector<BYTE>* response,
+                                                     FlashResult* result, bool allowRetry) {
+    const UINT attempts = allowRetry ? options_.maxRetries + 1 : 1;
+    for (UINT attempt = 0; attempt < attempts; attempt++) {
+        if (cancelled_.load()) {
+            result->error = "已取消";
+            return ResponseStatus::Cancelled;
+        }
+        if (attempt > 0) {
+            result->retries++;
+        }
+        {
+            std::lock_guard<std::mutex> lock(responseMutex_);
+            responses_.clear();
+        }
+
+        engine_->SetStMinOverride(sessionId_, stMinUs_);
+        IsoTpSendResult sent = engine_->Send(sessionId_, request);
+        if (sent.frames > 1) {
+            result->remoteStMinUs = sent.remoteStMinUs;
+        }
+
+        ResponseStatus status = ResponseStatus::Timeout;
+        BYTE negativeCode = 0;
+        if (sent.success) {
+            status = WaitResponse(request[0], response, &negativeCode);
+        } else if (cancelled_.load()) {
+            status = ResponseStatus::Cancelled;
+        }
+
+        switch (status) {
+            case ResponseStatus::Positive:
+                result->error.clear();
+                return status;
+            case ResponseStatus::Negative:
+                result->negativeCode = negativeCode;
+                result->error = "SID " + HexByte(request[0]) + " 消极响应 " + HexByte(negativeCode);
+                return status;
+            case ResponseStatus::Cancelled:
+                result->error = "已取消";
+                return status;
+            case ResponseStatus::Timeout:
+                result->error = sent.success ? "SID " + HexByte(request[0]) + " 响应超时"
+                                             : "SID " + HexByte(request[0]) + " 发送失败: " + sent.error;
+                break;
+        }
+
+        // 超时多因ECU来不及接收连续帧，在流控STmin之上增大发送间隔后重发
+        if (options_.autoTuneStMin) {
+            RaiseStMin(result);
+        }
+    }
+    return ResponseStatus::Timeout;
+}
+
+void FlashPipeline::RaiseStMin(FlashResult* result) {
+    const int current = stMinUs_ >= 0
+        ? stMinUs_ : static_cast<int>(std::min<uint64_t>(result->remoteStMinUs, MAX_STMIN_US));
+    stMinUs_ = std::min(std::max(current * 2, current + 100), MAX_STMIN_US);
+}
+
+FlashPipeline::ResponseStatus FlashPipeline::WaitResponse(BYTE sid, std::vector<BYTE>* response, BYTE* negativeCode) {
+    auto deadline = Clock::now() + std::chrono::milliseconds(options_.p2TimeoutMs);
+    std::unique_lock<std::mutex> lock(responseMutex_);
+    while (true) {
+        responseCv_.wait_until(lock, deadline, [this] { return cancelled_.load() || !responses_.empty(); });
+        if (cancelled_.load()) {
+            return ResponseStatus::Cancelled;
+        }
+        if (responses_.empty()) {
+            return ResponseStatus::Timeout;
+        }
+
+        std::vector<BYTE> message = std::move(responses_.front());
+        responses_.pop_front();
+        if (message.empty()) {
+            continue;
+        }
+        if (message[0] == static_cast<BYTE>(sid + POSITIVE_RESPONSE_OFFSET)) {
+            *response = std::move(message);
+            return ResponseStatus::Positive;
+        }
+        if (message[0] == SID_NEGATIVE_RESPONSE && message.size() >= 3 && message[1] == sid) {
+            if (message[2] == NRC_RESPONSE_PENDING) {
+                deadline = Clock::now() + std::chrono::milliseconds(options_.p2StarTimeoutMs);
+                continue;
+            }
+            *negativeCode = message[2];
+            return ResponseStatus::Negative;
+        }
+        // 其他服务的响应忽略
+    }
+}
+
+void FlashPipeline::ReportProgress(UINT segmentIndex, FlashResult* result, bool force) {
+    if (!progress_) {
+        return;
+    }
+    const auto now = Clock::now();
+    if (!force && now - lastProgressAt_ < std::chrono::milliseconds(options_.progressIntervalMs)) {
+        return;
+    }
+    lastProgressAt_ = now;
+
+    FlashProgress progress;
+    progress.segmentIndex = segmentIndex;
+    progress.segmentCount = static_cast<UINT>(result->segments.size());
+    progress.bytesSent = result->bytesSent;
+    progress.totalBytes = result->totalBytes;
+    progress.elapsedUs = ElapsedUs(startedAt_, now);
+    progress.bytesPerSec = progress.elapsedUs > 0
+        ? static_cast<double>(progress.bytesSent) * 1000000.0 / static_cast<double>(progress.elapsedUs) : 0;
+    progress.blockLength = blockLength_;
+    progress.stMinUs = stMinUs_;
+    progress.retries = result->retries;
+    progress_(progress);
+}
@@ -0,0 +1,134 @@
+#ifndef ZLGCAN_FLASH_PIPELINE_H_
+#define ZLGCAN_FLASH_PIPELINE_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "firmware_image.h"
+#include "isotp_engine.h"
+
+// 烧写配置
+struct FlashOptions {
+    BYTE dataFormatIdentifier = 0x00;  // 0x34请求的dataFormatIdentifier（压缩/加密方式）
+    BYTE addressAndLengthFormat = 0x44;// 0x34请求的addressAndLengthFormatIdentifier
+    UINT maxBlockLength = 0;           // 单个0x36请求的长度上限（含SID和序号），0表示使用ECU允许的最大值
+    UINT p2TimeoutMs = 1000;           // 等待响应超时
+    UINT p2StarTimeoutMs = 5000;       // 收到0x78后的响应超时
+    bool autoTuneStMin = false;        // 块超时后在ECU流控中的STmin之上逐步增大发送间隔（不低于流控值）
+    UINT maxRetries = 3;               // 单个块超时后的重发次数（使用相同的序号）
+    UINT pipelineDepth = 2;            // 预先组好的块数
+    UINT progressIntervalMs = 100;     // 进度回调的最小间隔
+    UINT checkMemoryRoutineId = 0;     // 每段0x37之后以RoutineControl(0x31 01)发送该段CRC32请ECU校验，0表示不发送
+};
+
+// 烧写进度
+struct FlashProgress {
+    UINT segmentIndex = 0;
+    UINT segmentCount = 0;
+    uint64_t bytesSent = 0;
+    uint64_t totalBytes = 0;
+    double bytesPerSec = 0;
+    UINT blockLength = 0;              // 当前0x36请求长度（含SID和序号）
+    int stMinUs = -1;                  // 当前使用的STmin，-1表示使用ECU流控中的值
+    UINT retries = 0;
+    uint64_t elapsedUs = 0;
+};
+
+struct FlashSegmentResult {
+    uint32_t address = 0;
+    uint64_t size = 0;
+    uint32_t crc32 = 0;
+    UINT blocks = 0;
+    bool crcVerified = false;          // ECU的校验例程确认了该段CRC32
+};
+
+// 烧写结果
+struct FlashResult {
+    bool success = false;
+    std::string error;
+    BYTE negativeCode = 0;             // ECU消极响应码
+    uint64_t bytesSent = 0;
+    uint64_t totalBytes = 0;
+    uint64_t elapsedUs = 0;
+    double bytesPerSec = 0;
+    UINT blockLength = 0;
+    int stMinUs = -1;                  // 结束时使用的STmin
+    uint64_t remoteStMinUs = 0;        // ECU流控中的STmin
+    UINT retries = 0;
+    uint32_t imageCrc32 = 0;           // 按段顺序计算的整体CRC32
+    std::vector<FlashSegmentResult> segments;
+};
+
+/**
+ * 固件下载流水线（UDS 0x34/0x36/0x37，可选0x31校验）
+ * 通过ISO-TP会话发送请求；下一块在当前块传输期间预先组好，
+ * CRC32在独立线程中计算，配置校验例程时每段传输结束后发给ECU校验。
+ * Run为阻塞调用，进度回调在Run所在线程执行。
+ */
+class FlashPipeline {
+public:
+    using ProgressCallback = std::function<void(const FlashProgress&)>;
+
+    FlashPipeline(std::shared_ptr<IsoTpEngine> engine, UINT sessionId, std::string path,
+                  FirmwareFormat format, uint32_t baseAddress, const FlashOptions& options,
+                  ProgressCallback progress);
+
+    FlashPipeline(const FlashPipeline&) = delete;
+    FlashPipeline& operator=(const FlashPipeline&) = delete;
+
+    FlashResult Run();
+    void Cancel();
+
+    // ISO-TP会话的接收回调
+    void OnIsoTpEvent(const IsoTpEvent& event);
+
+    static uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t size);
+
+private:
+    enum class ResponseStatus : uint8_t { Positive, Negative, Timeout, Cancelled };
+
+    struct BlockQueue;
+
+    ResponseStatus Request(const std::vector<BYTE>& request, std::vector<BYTE>* response,
+                           FlashResult* result, bool allowRetry);
+    ResponseStatus WaitResponse(BYTE sid, std::vector<BYTE>* response, BYTE* negativeCode);
+    bool DownloadSegment(const FirmwareSegment& segment, UINT index, FlashResult* result);
+    bool CheckSegment(UINT index, FlashResult* result);
+    void RaiseStMin(FlashResult* result);
+    void ReportProgress(UINT segmentIndex, FlashResult* result, bool force);
+
+    const std::shared_ptr<IsoTpEngine> engine_;
+    const UINT sessionId_;
+    const std::string path_;
+    const FirmwareFormat format_;
+    const uint32_t baseAddress_;
+    const FlashOptions options_;
+    const ProgressCallback progress_;
+
+    FirmwareImage image_;
+    std::atomic<bool> cancelled_{false};
+    int stMinUs_ = -1;
+    UINT blockLength_ = 0;
+    std::chrono::steady_clock::time_point startedAt_;
+    std::chrono::steady_clock::time_point lastProgressAt_;
+
+    // CRC线程的结果，crcDone_为已算完的段数
+    std::mutex crcMutex_;
+    std::condition_variable crcCv_;
+    std::vector<uint32_t> segmentCrcs_;
+    size_t crcDone_ = 0;
+
+    std::mutex responseMutex_;
+    std::condition_variable responseCv_;
+    std::deque<std::vector<BYTE>> responses_;
+};
+
+#endif  // ZLGCAN_FLASH_PIPELINE_H_
@@ -13,8 +13,13 @@ if (process.platform === 'win32') {
     }
 }
 
-// 加载zlgcan.node
-const zlgcanPath = path.join(libDir, 'zlgcan.node');
+// 加载zlgcan.node；ZLGCAN_BACKEND=socketcan加载Linux SocketCAN后端zlgcan_socketcan.node，
+// ZLGCAN_BACKEND=sim或其余非Windows平台加载仿真后端zlgcan_sim.node
+const backend = process.env.ZLGCAN_BACKEND;
+const addonName = backend === 'socketcan'
+  ? 'zlgcan_socketcan.node'
+  : backend === 'sim' || process.platform !== 'win32' ? 'zlgcan_sim.node' : 'zlgcan.node';
+const zlgcanPath = path.join(libDir, addonName);
 const zlgcan = require(zlgcanPath);
 
 // ============== 类型定义 ==============
@@ -244,6 +249,12 @@ export const DataType = {
     ZCAN_DT_ZCAN_LIN_DATA: 4,
     /** 总线使用率数据 */
     ZCAN_DT_ZCAN_BUSUSAGE_DATA: 5,
+    /** LIN错误数据 */
+    ZCAN_DT_ZCAN_LIN_ERROR_DATA: 6,
+    /** LIN扩展数据 */
+    ZCAN_DT_ZCAN_LIN_EX_DATA: 7,
+    /** LIN事件数据 */
+    ZCAN_DT_ZCAN_LIN_EVENT_DATA: 8,
 } as const;
 
 export type DataTypeValue = typeof DataType[keyof typeof DataType];
@@ -278,6 +289,109 @@ export const NodeState = {
 
 export type NodeStateValue = typeof NodeState[keyof typeof NodeState];
 
+// ============== UDS诊断常量 ==============
+
+export const UdsFrameType = {
+    /** CAN帧 */
+    CAN: 0,
+    /** CANFD帧 */
+    CANFD: 1,
+    /** CANFD加速帧 */
+    CANFD_BRS: 2,
+} as const;
+
+export type UdsFrameTypeValue = typeof UdsFrameType[keyof typeof UdsFrameType];
+
+export const UdsError = {
+    /** 没错误 */
+    OK: 0x00,
+    /** 响应超时 */
+    TIMEOUT: 0x01,
+    /** 发送数据失败 */
+    TRANSPORT: 0x02,
+    /** 取消请求 */
+    CANCEL: 0x03,
+    /** 抑制响应 */
+    SUPPRESS_RESPONSE: 0x04,
+    /** 忙碌中 */
+    BUSY: 0x05,
+    /** 请求参数错误 */
+    REQ_PARAM: 0x06,
+    /** 其它未知错误 */
+    OTHER: 0x64,
+    /** DoIP: 创建socket失败 */
+    DOIP_FAILED_TO_CREATE_SOCKET: 0x20,
+    /** DoIP: 建立连接失败 */
+    DOIP_FAILED_TO_CONNECT: 0x21,
+    /** DoIP: 操作超时 */
+    DOIP_TIMEOUT: 0x22,
+    /** DoIP: 路由未激活 */
+    DOIP_ROUTING_NOT_ACTIVE: 0x23,
+    /** DoIP: 缓冲区不足 */
+    DOIP_BUFFER_TOO_SMALL: 0x24,
+    /** DoIP: 路由已被激活 */
+    DOIP_ROUTING_ALREADY_ACTIVE: 0x25,
+    /** DoIP: 收到头部NACK (0x26~0x2B) */
+    DOIP_HEADER_NACK_INCORRECT_PATTERN_FORMAT: 0x26,
+    DOIP_HEADER_NACK_UNKNOWN_PAYLOAD_TYPE: 0x27,
+    DOIP_HEADER_NACK_MESSAGE_TOO_LARGE: 0x28,
+    DOIP_HEADER_NACK_OUT_OF_MEMORY: 0x29,
+    DOIP_HEADER_NACK_INVALID_PAYLOAD_LENGTH: 0x2A,
+    DOIP_HEADER_NACK_UNKNOWN: 0x2B,
+    /** DoIP: 收到诊断请求NACK (0x2C~0x33) */
+    DOIP_DIAGNOSTIC_NACK_INVALID_SOURCE_ADDRESS: 0x2C,
+    DOIP_DIAGNOSTIC_NACK_UNKNOWN_TARGET_ADDRESS: 0x2D,
+    DOIP_DIAGNOSTIC_NACK_MESSAGE_TOO_LARGE: 0x2E,
+    DOIP_DIAGNOSTIC_NACK_OUT_OF_MEMORY: 0x2F,
+    DOIP_DIAGNOSTIC_NACK_TARGET_UNREACHABLE: 0x30,
+    DOIP_DIAGNOSTIC_NACK_UNKNOWN_NETWORK: 0x31,
+    DOIP_DIAGNOSTIC_NACK_TRANSPORT_PROTOCOL_ERROR: 0x32,
+    DOIP_DIAGNOSTIC_NACK_UNKNOWN: 0x33,
+    /** DoIP: 无效的句柄 */
+    DOIP_INVALID_HANDLE: 0x34,
+    /** DoIP: 未预期的空指针 */
+    DOIP_UNEXPECTED_NULL_POINTER: 0x35,
+    /** DoIP: 未知的句柄 */
+    DOIP_UNKNOWN_HANDLE: 0x36,
+    /** DoIP: 内存不足 */
+    DOIP_OUT_OF_MEMORY: 0x37,
+    /** DoIP: 未知的错误 */
+    DOIP_UNKNOWN_ERROR: 0x38,
+    /** DoIP: 路由激活失败 */
+    DOIP_ROUTING_ACTIVE_FAIL: 0x39,
+} as const;
+
+export const UdsResponseType = {
+    /** 消极响应 */
+    NEGATIVE: 0,
+    /** 积极响应 */
+    POSITIVE: 1,
+    /** 无响应 */
+    NONE: 2,
+} as const;
+
+// ============== DoIP常量 ==============
+
+export const DoipVersion = {
+    /** ISO 13400-2:2010 */
+    ISO_13400_2_2010: 0x01,
+    /** ISO 13400-2:2012 */
+    ISO_13400_2_2012: 0x02,
+    /** ISO 13400-2:2019 */
+    ISO_13400_2_2019: 0x03,
+    /** 自动检测 */
+    AUTO_DETECTED: 0xFF,
+} as const;
+
+export const DoipActivationType = {
+    /** 默认 */
+    DEFAULT: 0x00,
+    /** WWH-OBD */
+    WWH_OBD: 0x01,
+    /** 中央安全 */
+    CENTRAL_SECURITY: 0xE0,
+} as const;
+
 // ============== CAN帧标志常量 ==============
 
 export const CanFrameFlags = {
@@ -558,6 +672,12 @@ export interface DataObj {
     errData?: ErrorData;
     /** 总线使用率数据 */
     busUsage?: BusUsageData;
+    /** LIN数据 */
+    linData?: LinData;
+    /** LIN错误数据 */
+    linErrData?: LinErrData;
+    /** LIN事件数据 */
+    linEvent?: LinEventData;
 }
 
 /** 接收回调函数类型 */
@@ -566,6 +686,1361 @@ export type ReceiveCallback = (frames: ReceivedFrame[]) => void;
 /** CANFD接收回调函数类型 */
 export type ReceiveFDCallback = (frames: ReceivedFDFrame[]) => void;
 
+/** 通道健康监视配置 */
+export interface HealthMonitorOptions {
+    /** 错误计数器采样周期（毫秒），默认50 */
+    pollIntervalMs?: number;
+    /** 总线关闭后是否自动执行 ResetCAN + StartCAN，默认false */
+    autoRecover?: boolean;
+    /** 首次恢复前的等待时间（毫秒），默认100 */
+    recoveryDelayMs?: number;
+    /** 退避等待上限（毫秒），默认5000 */
+    maxRecoveryDelayMs?: number;
+    /** 最大恢复次数，0表示不限，默认0 */
+    maxRecoveryAttempts?: number;
+    /** 状态好转须连续一致的采样次数，恶化立即生效，默认2 */
+    settlePolls?: number;
+}
+
+/** 通道健康事件类型 */
+export type HealthEventType = 'stateChange' | 'recoveryAttempt' | 'recovered';
+
+/** 通道健康事件 */
+export interface ChannelHealthEvent {
+    /** 事件类型 */
+    type: HealthEventType;
+    /** 通道索引 */
+    channelIndex: number;
+    /** 当前总线状态 (NodeState，0表示未知) */
+    state: number;
+    /** 之前的总线状态 */
+    previousState: number;
+    /** 事件时间 (与Date.now()同基准，毫秒) */
+    timestamp: number;
+    /** 接收错误计数 */
+    rxErrCount: number;
+    /** 发送错误计数 */
+    txErrCount: number;
+    /** 通道错误码 */
+    errorCode: number;
+    /** 恢复尝试序号 */
+    attempt: number;
+    /** 本次恢复调用是否成功 */
+    success: boolean;
+    /** 恢复耗时（微秒），仅recovered事件有效 */
+    latencyUs: number;
+}
+
+/** 通道健康状态 */
+export interface ChannelHealthState {
+    /** 通道索引 */
+    channelIndex: number;
+    /** 当前总线状态 (NodeState，0表示未知) */
+    state: number;
+    /** 已成功恢复的次数 */
+    recoveryCount: number;
+}
+
+/** 通道健康事件回调函数类型 */
+export type HealthEventCallback = (event: ChannelHealthEvent) => void;
+
+/** 接收链路监视配置 */
+export interface PipelineWatchdogOptions {
+    /** 采样及事件循环探测周期（毫秒），默认50 */
+    intervalMs?: number;
+    /** 事件循环延迟告警阈值（毫秒），默认100 */
+    lagWarnMs?: number;
+    /** 接收线程环形缓冲占用率告警阈值，默认0.5 */
+    ringWarnRatio?: number;
+    /** 驱动接收缓冲帧数告警阈值，默认2000 */
+    vendorWarnFrames?: number;
+    /** 保留的采样点数，默认1200 */
+    historySize?: number;
+}
+
+/** 接收链路告警类型 */
+export type PipelineWarningType = 'eventLoopLag' | 'ringFilling' | 'vendorQueue' | 'framesDropped';
+
+/**
+ * 接收链路告警
+ * 告警在原生线程中产生，事件循环阻塞期间会延后到达，产生时间以timestamp为准
+ */
+export interface PipelineWarning {
+    /** 告警类型 */
+    type: PipelineWarningType;
+    /** 通道索引，eventLoopLag无此字段 */
+    channelIndex?: number;
+    /** 告警时间 (与Date.now()同基准，毫秒) */
+    timestamp: number;
+    /** 延迟(ms)、环形缓冲占用率、驱动缓冲帧数或本周期丢帧数 */
+    value: number;
+    /** 对应阈值 */
+    threshold: number;
+    /** 同一时刻的事件循环延迟（毫秒） */
+    lagMs: number;
+    /** 按当前增长速度估算的环形缓冲写满时间（毫秒），-1表示未在增长 */
+    etaMs: number;
+}
+
+/** 接收链路单通道采样 */
+export interface PipelineChannelSample {
+    /** 通道索引 */
+    channelIndex: number;
+    /** 接收线程环形缓冲中等待取走的帧数（CAN+CANFD） */
+    ringDepth: number;
+    /** 环形缓冲容量，0表示未启动接收线程 */
+    ringCapacity: number;
+    /** 驱动接收缓冲帧数 (ZCAN_GetReceiveNum) */
+    vendorDepth: number;
+    /** 本周期接收线程读取的帧数 */
+    framesReceived: number;
+    /** 本周期环形缓冲丢弃的帧数 */
+    framesDropped: number;
+}
+
+/** 接收链路采样点 */
+export interface PipelineSample {
+    /** 采样时间 (与Date.now()同基准，毫秒) */
+    timestamp: number;
+    /** 事件循环延迟（毫秒） */
+    lagMs: number;
+    /** 探测尚未应答，lagMs为已等待时间 */
+    stalled: boolean;
+    /** 各通道采样 */
+    channels: PipelineChannelSample[];
+}
+
+/** 接收链路告警回调函数类型 */
+export type PipelineWarningCallback = (warning: PipelineWarning) => void;
+
+/** 设备热插拔监视配置 */
+export interface DeviceMonitorOptions {
+    /** 在线状态轮询周期（毫秒），默认200 */
+    pollIntervalMs?: number;
+    /** 离线后重新打开设备的间隔（毫秒），默认200 */
+    retryIntervalMs?: number;
+}
+
+/** 设备热插拔事件 */
+export interface DeviceMonitorEvent {
+    /** 事件类型 */
+    type: 'offline' | 'reconnected';
+    /** 事件时间 (与Date.now()同基准，毫秒) */
+    timestamp: number;
+    /** 重新打开设备的尝试次数 */
+    attempts: number;
+    /** 回放失败的操作数 */
+    replayFailures: number;
+    /** 从检测到离线到回放完成的耗时（微秒） */
+    reconnectUs: number;
+    /** 回放后的通道句柄（旧句柄仍可继续使用） */
+    channels: { channelIndex: number; channelHandle: ChannelHandle }[];
+    /** 回放后的LIN通道句柄（旧句柄仍可继续使用；调度表随旧设备失效，需重新添加） */
+    linChannels: { linIndex: number; channelHandle: ChannelHandle }[];
+}
+
+/** 设备热插拔监视状态 */
+export interface DeviceMonitorState {
+    /** 监视线程是否运行中 */
+    running: boolean;
+    /** 设备是否在线 */
+    online: boolean;
+    /** 重连次数 */
+    reconnectCount: number;
+    /** 最近一次重连耗时（微秒） */
+    lastReconnectUs: number;
+}
+
+/** 设备热插拔事件回调函数类型 */
+export type DeviceMonitorCallback = (event: DeviceMonitorEvent) => void;
+
+/** UDS传输层参数 */
+export interface UdsTransportParams {
+    /** 传输协议版本，0: ISO15765-2(2004)，1: ISO15765-2(2016)，默认0 */
+    version?: number;
+    /** 单帧最大数据长度，默认CAN为8，CANFD为64 */
+    maxDataLen?: number;
+    /** 本端发送流控时的STmin，0x00-0x7F(ms)，0xF1-0xF9(100us~900us) */
+    localStMin?: number;
+    /** 流控帧的块大小 */
+    blockSize?: number;
+    /** 填充字节，默认0xCC */
+    fillByte?: number;
+    /** 是否使用扩展帧 */
+    extFrame?: boolean;
+    /** 发送多帧时强制使用的STmin，设置后忽略ECU流控中的STmin */
+    remoteStMin?: number;
+    /** 接收流控超时时间（毫秒），默认1000 */
+    fcTimeoutMs?: number;
+    /** 数据长度填充模式，0: 短帧填充至8字节，1: 不填充，2: 填充至最大长度 */
+    fillMode?: number;
+}
+
+/** UDS诊断请求 */
+export interface UdsRequest {
+    /** 设备通道索引 */
+    channel: number;
+    /** 请求地址 */
+    srcAddr: number;
+    /** 响应地址 */
+    dstAddr: number;
+    /** 请求服务ID */
+    sid: number;
+    /** 请求数据（不含SID） */
+    data?: number[];
+    /** 帧类型 (UdsFrameType)，默认CAN */
+    frameType?: UdsFrameTypeValue;
+    /** 抑制积极响应 */
+    suppressResponse?: boolean;
+    /** 响应超时(P2，毫秒)，默认1000 */
+    timeoutMs?: number;
+    /** 收到0x78后的响应超时(P2*，毫秒)，默认5000 */
+    enhancedTimeoutMs?: number;
+    /** 收到非本次请求服务的消极响应时是否判定为错误 */
+    checkAnyNegativeResponse?: boolean;
+    /** 抑制响应时是否等待消极响应 */
+    waitIfSuppressResponse?: boolean;
+    /** 传输层参数 */
+    transport?: UdsTransportParams;
+    /** 响应数据缓冲区大小，默认4095 */
+    maxResponseLength?: number;
+}
+
+/** 执行中的诊断请求：Promise上附带原生层分配的请求事务ID，可立即用于udsCancel */
+export type PendingUdsRequest<T> = Promise<T> & { readonly reqId: number };
+
+/** UDS请求耗时 */
+export interface UdsTiming {
+    /** 等待同通道前序请求完成的时间（微秒） */
+    queuedUs: number;
+    /** 请求发出到收到最终响应的时间，含P2/P2*等待（微秒） */
+    requestUs: number;
+    /** 总耗时（微秒） */
+    totalUs: number;
+}
+
+/** UDS诊断响应 */
+export interface UdsResponse {
+    /** 请求事务ID */
+    reqId: number;
+    /** 响应状态 (UdsError) */
+    status: number;
+    /** 响应类型 (UdsResponseType) */
+    type: number;
+    /** 积极响应为响应服务ID，消极响应为请求服务ID */
+    sid?: number;
+    /** 消极响应码 */
+    negativeCode?: number;
+    /** 积极响应数据（不含SID） */
+    data: number[];
+    /** 耗时 */
+    timing: UdsTiming;
+}
+
+/** DoIP诊断请求 */
+export interface DoipRequest {
+    /** DoIP实体的IP地址 */
+    serverAddress: string;
+    /** 源逻辑地址（测试仪） */
+    sourceAddress: number;
+    /** 目标逻辑地址（ECU） */
+    targetAddress: number;
+    /** 请求服务ID */
+    sid: number;
+    /** 请求数据（不含SID） */
+    data?: number[];
+    /** 协议版本 (DoipVersion)，默认自动检测 */
+    doipVersion?: number;
+    /** 路由激活类型 (DoipActivationType)，默认DEFAULT */
+    activationType?: number;
+    /** TCP连接超时（毫秒），默认2000 */
+    connectTimeoutMs?: number;
+    /** 路由激活超时（毫秒），默认2000 */
+    routingTimeoutMs?: number;
+    /** UDS请求超时（毫秒），默认5000 */
+    requestTimeoutMs?: number;
+    /** 抑制积极响应 */
+    suppressResponse?: boolean;
+    /** 抑制积极响应时是否等待消极响应 */
+    waitIfSuppressResponse?: boolean;
+    /** 响应数据缓冲区大小，默认65535 */
+    maxResponseLength?: number;
+}
+
+/** DoIP请求耗时 */
+export interface DoipTiming extends UdsTiming {
+    /** 请求发出前连接已建立并完成路由激活；为false时requestUs包含建立连接的时间 */
+    connectionReused: boolean;
+}
+
+/** DoIP诊断响应 */
+export interface DoipResponse extends UdsResponse {
+    /** 耗时 */
+    timing: DoipTiming;
+}
+
+/** DoIP连接统计 */
+export interface DoipConnectionStats {
+    /** DoIP实体的IP地址 */
+    serverAddress: string;
+    /** 源逻辑地址 */
+    sourceAddress: number;
+    /** 协议版本 */
+    doipVersion: number;
+    /** 路由激活类型 */
+    activationType: number;
+    /** 最近一次请求后连接可复用 */
+    established: boolean;
+    /** 建立连接的次数（首个请求及断开后的重连） */
+    connects: number;
+    /** 请求数 */
+    requests: number;
+    /** 失败的请求数 */
+    failures: number;
+    /** 执行中的请求数 */
+    inFlight: number;
+    /** 同时执行的请求数峰值 */
+    maxInFlight: number;
+    /** 发送的诊断数据字节数（含SID） */
+    bytesSent: number;
+    /** 接收的积极响应字节数（含SID） */
+    bytesReceived: number;
+    /** 最近一次建立连接的请求耗时，含TCP连接与路由激活（微秒） */
+    lastConnectRequestUs: number;
+    /** 请求耗时累计（微秒） */
+    totalRequestUs: number;
+}
+
+/** 通道静默配置 */
+export interface QuiesceOptions {
+    /** 等待发送队列排空的总时限（毫秒），默认100 */
+    timeoutMs?: number;
+    /** 排空后等待在途报文到达再清空缓冲区的时间窗（毫秒），默认2 */
+    settleMs?: number;
+    /** 每通道发送缓存容量（帧），可用发送缓存数回到该值即视为排空；不设置时以可用数在一个时间窗内不再增加为准 */
+    txCapacity?: number;
+}
+
+/** 通道静默结果 */
+export interface QuiesceResult {
+    /** 时限内发送队列已排空 */
+    clean: boolean;
+    /** 清空缓冲区时丢弃的报文数 */
+    discardedFrames: number;
+    /** 耗时（微秒） */
+    elapsedUs: number;
+}
+
+/** 接收线程配置 */
+/**
+ * 接收线程读取驱动的方式
+ * - blocking: ZCAN_Receive带等待时间阻塞读取，CPU占用最低
+ * - adaptive: 按ZCAN_GetReceiveNum决定读取量，空闲时等待间隔指数退避
+ * - busyPoll: 不休眠持续读取，延迟最低，独占一个CPU核
+ */
+export type ReceiveMode = 'blocking' | 'adaptive' | 'busyPoll';
+
+/**
+ * 接收缓冲写满（取帧方跟不上）时的丢弃策略
+ * - dropOldest: 丢弃最旧的帧，保留最新状态
+ * - dropNewest: 丢弃新到的帧，保留缓冲中较早的连续序列
+ */
+export type RingDropPolicy = 'dropOldest' | 'dropNewest';
+
+export interface ReceiveThreadOptions {
+    /** 未被协议引擎认领的帧缓存上限（CAN和CANFD各一份），满时按dropPolicy丢弃，默认65536 */
+    ringCapacity?: number;
+    /** 缓冲满时的丢弃策略，默认dropOldest */
+    dropPolicy?: RingDropPolicy;
+    /** 单次从驱动读取的最大帧数，默认256 */
+    batchSize?: number;
+    /** 读取方式，默认adaptive */
+    mode?: ReceiveMode;
+    /** adaptive：空闲等待间隔上限（微秒），默认200 */
+    idleSleepUs?: number;
+    /** adaptive：收到帧后的等待间隔（微秒），空闲时逐轮加倍到idleSleepUs，默认50 */
+    minIdleSleepUs?: number;
+    /** blocking：单次读取的最长等待（毫秒），也是停止线程的最长响应时间，默认10 */
+    blockWaitMs?: number;
+    /** 未认领的帧是否放入receive/receiveFD缓存，默认true；为false时（只通过帧流取帧）首次receive/receiveFD后才开始缓存 */
+    sharedRing?: boolean;
+}
+
+/** 接收线程统计 */
+export interface ReceiveThreadStats {
+    /** 从驱动读取的帧数 */
+    framesReceived: number;
+    /** 被协议引擎（ISO-TP等）认领的帧数 */
+    framesClaimed: number;
+    /** 缓存满时丢弃的帧数 */
+    framesDropped: number;
+    /** 读取到数据的轮询次数 */
+    wakeups: number;
+    /** 尚未被receive取出的CAN帧数 */
+    canRingDepth: number;
+    /** 尚未被receiveFD取出的CANFD帧数 */
+    fdRingDepth: number;
+    /** 缓存上限（CAN和CANFD各一份） */
+    ringCapacity: number;
+    /** 缓冲满时的丢弃策略 */
+    dropPolicy: RingDropPolicy;
+    /** 读取方式 */
+    mode: ReceiveMode;
+    /** 线程运行时长（微秒），与cpuTimeUs同时更新，约每10ms一次 */
+    uptimeUs: number;
+    /** 线程累计CPU时间（微秒），两次采样之差除以uptimeUs之差即CPU占用 */
+    cpuTimeUs: number;
+    /**
+     * 取帧延迟：帧的设备时间戳到被接收线程读出的时间差（微秒）
+     * 以最近1~2秒内最快一帧为基准，不含驱动固有的传输时间
+     */
+    pickupLatency: {
+        samples: number;
+        p50Us: number;
+        p99Us: number;
+        maxUs: number;
+    };
+}
+
+/** 帧流缓冲配置 */
+export interface ReceiveStreamOptions {
+    /** 缓冲容量（CAN和CANFD各一份），满时按dropPolicy丢弃，默认65536 */
+    capacity?: number;
+    /** 缓冲满时的丢弃策略，默认dropOldest */
+    dropPolicy?: RingDropPolicy;
+}
+
+/** 从帧流缓冲取出的一批帧 */
+export interface ReceiveStreamBatch {
+    frames: ReceivedFrame[];
+    fdFrames: ReceivedFDFrame[];
+    /** 帧流打开以来该缓冲丢弃的帧数（累计） */
+    dropped: number;
+}
+
+/** ISO-TP会话配置（正常寻址） */
+export interface IsoTpOptions {
+    /** 发送ID，扩展帧须包含CAN_EFF_FLAG */
+    txId: number;
+    /** 接收ID，扩展帧须包含CAN_EFF_FLAG；同一通道内不能重复 */
+    rxId: number;
+    /** 使用CANFD帧 */
+    fd?: boolean;
+    /** CANFD加速 */
+    brs?: boolean;
+    /** 发送帧的最大数据长度，CAN为8，CANFD为8~64，默认8 */
+    txDataLength?: number;
+    /** 填充字节，默认0xCC；null表示不填充 */
+    padding?: number | null;
+    /** 本端流控的块大小，0表示不限，默认0 */
+    blockSize?: number;
+    /** 本端流控的STmin（微秒），100~900us或整毫秒，默认0 */
+    stMinUs?: number;
+    /** 发送连续帧的间隔（微秒），小于对方流控中的STmin时以流控值为准；默认-1表示使用流控值 */
+    stMinOverrideUs?: number;
+    /** 等待流控帧超时（毫秒），默认1000 */
+    nBsTimeoutMs?: number;
+    /** 等待连续帧超时（毫秒），默认1000 */
+    nCrTimeoutMs?: number;
+    /** 允许连续收到的FC.WAIT数，默认10 */
+    maxWaitFrames?: number;
+    /** 接收消息长度上限，超过时回复FC.OVFLW，默认4095 */
+    maxMessageLength?: number;
+}
+
+/** ISO-TP接收事件 */
+export interface IsoTpEvent {
+    /** message: 接收完成；error: 接收中止 */
+    type: 'message' | 'error';
+    /** 会话ID */
+    sessionId: number;
+    /** 消息数据 */
+    data: number[];
+    /** 最后一帧的设备时间戳（微秒） */
+    timestamp: number;
+    /** 首帧到最后一帧的耗时（微秒） */
+    durationUs: number;
+    /** 错误描述 */
+    error?: string;
+}
+
+/** ISO-TP接收事件回调函数类型 */
+export type IsoTpCallback = (event: IsoTpEvent) => void;
+
+/** ISO-TP发送结果 */
+export interface IsoTpSendResult {
+    success: boolean;
+    /** 错误描述 */
+    error?: string;
+    /** 发出的帧数 */
+    frames: number;
+    /** 发送耗时（微秒） */
+    durationUs: number;
+    /** 等待流控帧的累计时间（微秒） */
+    fcWaitUs: number;
+    /** 对方最近一次流控中的BS */
+    remoteBlockSize: number;
+    /** 对方最近一次流控中的STmin（微秒） */
+    remoteStMinUs: number;
+    /** 吞吐量（字节/秒） */
+    bytesPerSec: number;
+}
+
+/** ISO-TP会话统计 */
+export interface IsoTpStats {
+    txMessages: number;
+    rxMessages: number;
+    txBytes: number;
+    rxBytes: number;
+    txErrors: number;
+    rxErrors: number;
+    /** 最近一次发送耗时（微秒） */
+    lastTxUs: number;
+    /** 最近一次接收耗时（微秒） */
+    lastRxUs: number;
+    lastTxBytesPerSec: number;
+    lastRxBytesPerSec: number;
+    /** 收到首帧/块末帧到发出流控帧的耗时（微秒） */
+    lastFcResponseUs: number;
+    maxFcResponseUs: number;
+    /** 最近一次发送等待流控帧的累计时间（微秒） */
+    lastFcWaitUs: number;
+}
+
+/** 在线烧写配置，传输层字段同IsoTpOptions */
+export interface FlashOptions extends IsoTpOptions {
+    /** 固件文件路径 */
+    file: string;
+    /** 文件格式，默认auto（按扩展名和内容识别） */
+    format?: 'auto' | 'hex' | 'srec' | 'bin';
+    /** 二进制文件的下载地址，默认0 */
+    baseAddress?: number;
+    /** 0x34请求的dataFormatIdentifier，默认0x00 */
+    dataFormatIdentifier?: number;
+    /** 0x34请求的addressAndLengthFormatIdentifier，默认0x44 */
+    addressAndLengthFormat?: number;
+    /** 单个0x36请求的长度上限（含SID和序号），默认0表示使用ECU允许的最大值 */
+    maxBlockLength?: number;
+    /** 等待响应超时（毫秒），默认1000 */
+    p2TimeoutMs?: number;
+    /** 收到0x78后的响应超时（毫秒），默认5000 */
+    p2StarTimeoutMs?: number;
+    /** 以ECU流控中的STmin为下限，块超时后逐步增大发送间隔，默认false */
+    autoTuneStMin?: boolean;
+    /** 单个块超时后的重发次数，默认3 */
+    maxRetries?: number;
+    /** 预先组好的块数，默认2 */
+    pipelineDepth?: number;
+    /** 进度回调的最小间隔（毫秒），默认100 */
+    progressIntervalMs?: number;
+    /** 每段传输结束后以RoutineControl(0x31 01 + routineId + CRC32)请ECU校验，默认0表示不发送 */
+    checkMemoryRoutineId?: number;
+}
+
+/** 烧写进度 */
+export interface FlashProgress {
+    segmentIndex: number;
+    segmentCount: number;
+    bytesSent: number;
+    totalBytes: number;
+    bytesPerSec: number;
+    /** 当前0x36请求长度（含SID和序号） */
+    blockLength: number;
+    /** 当前使用的STmin（微秒），-1表示使用ECU流控中的值 */
+    stMinUs: number;
+    retries: number;
+    elapsedUs: number;
+}
+
+/** 烧写进度回调函数类型 */
+export type FlashProgressCallback = (progress: FlashProgress) => void;
+
+/** 烧写结果 */
+export interface FlashResult {
+    success: boolean;
+    /** 错误描述 */
+    error?: string;
+    /** ECU消极响应码 */
+    negativeCode?: number;
+    bytesSent: number;
+    totalBytes: number;
+    elapsedUs: number;
+    bytesPerSec: number;
+    blockLength: number;
+    /** 结束时使用的STmin（微秒） */
+    stMinUs: number;
+    /** ECU流控中的STmin（微秒） */
+    remoteStMinUs: number;
+    retries: number;
+    /** 按段顺序计算的整体CRC32 */
+    imageCrc32: number;
+    /** crcVerified: ECU的校验例程确认了该段CRC32 */
+    segments: Array<{ address: number; size: number; crc32: number; blocks: number; crcVerified: boolean }>;
+}
+
+/** J1939配置 */
+export interface J1939Options {
+    /** 本节点地址，发往这些地址的RTS由原生层应答CTS和EndOfMsgAck */
+    addresses?: number[];
+    /** 单帧PGN也作为消息上报，默认true */
+    singleFrames?: boolean;
+    /** 被动重组其他节点之间的RTS/CTS会话，默认true */
+    monitorSessions?: boolean;
+    /** 本端CTS一次允许的包数，默认16 */
+    maxPacketsPerCts?: number;
+    /** 单批最多的消息数，默认256 */
+    maxBatch?: number;
+    /** 发送BAM数据包的间隔（毫秒），默认50 */
+    bamIntervalMs?: number;
+    /** 等待下一个数据包超时（毫秒），默认750 */
+    t1Ms?: number;
+    /** 发出CTS后等待数据包超时（毫秒），默认1250 */
+    t2Ms?: number;
+    /** 发出最后一个数据包后等待CTS/EndOfMsgAck超时（毫秒），默认1250 */
+    t3Ms?: number;
+    /** 收到保持连接的CTS后等待下一个CTS超时（毫秒），默认1050 */
+    t4Ms?: number;
+}
+
+/** 完整的J1939消息 */
+export interface J1939Message {
+    pgn: number;
+    priority: number;
+    /** 源地址 */
+    sa: number;
+    /** 目标地址，PDU2和BAM为0xFF */
+    da: number;
+    /** single: 单帧；bam: 广播多包；cmdt: RTS/CTS多包 */
+    transport: 'single' | 'bam' | 'cmdt';
+    data: number[];
+    /** 最后一帧的设备时间戳（微秒） */
+    timestamp: number;
+    /** 多包消息从连接管理帧到最后一个数据包的耗时（微秒） */
+    durationUs: number;
+}
+
+/** J1939消息批次回调函数类型 */
+export type J1939Callback = (messages: J1939Message[]) => void;
+
+/** J1939发送的消息 */
+export interface J1939SendMessage {
+    pgn: number;
+    /** 优先级，默认6 */
+    priority?: number;
+    /** 源地址 */
+    sa: number;
+    /** 目标地址，默认0xFF（多包时以BAM广播） */
+    da?: number;
+    /** 消息数据，最多1785字节 */
+    data: number[];
+}
+
+/** J1939发送结果 */
+export interface J1939SendResult {
+    success: boolean;
+    /** 错误描述 */
+    error?: string;
+    /** 发出的数据包数，单帧为0 */
+    packets: number;
+    /** 发送耗时（微秒） */
+    durationUs: number;
+}
+
+/** J1939统计 */
+export interface J1939Stats {
+    /** 处理的扩展帧数 */
+    framesReceived: number;
+    messages: number;
+    batches: number;
+    bamSessions: number;
+    cmdtSessions: number;
+    ctsSent: number;
+    /** 收到或发出的Abort，以及被新会话替换的未完成会话 */
+    aborts: number;
+    timeouts: number;
+    sequenceErrors: number;
+    /** 收到RTS/窗口末包到发出CTS的最大耗时（微秒） */
+    maxCtsResponseUs: number;
+    activeSessions: number;
+}
+
+/** XCP-on-CAN配置 */
+export interface XcpOptions {
+    /** CRO（主->从）CAN ID，扩展帧需带标志位 */
+    masterId: number;
+    /** CRM/DTO（从->主）CAN ID */
+    slaveId: number;
+    /** 使用CAN FD，默认false */
+    fd?: boolean;
+    /** CAN FD加速，默认false */
+    brs?: boolean;
+    /** 命令帧填充到8字节使用的字节，默认不填充 */
+    padding?: number;
+    /** 命令超时（毫秒），默认100 */
+    timeoutMs?: number;
+    /** 超时或ERR_CMD_BUSY后的重发次数，默认2 */
+    maxRetries?: number;
+    /** DAQ批次上报间隔（毫秒），默认20 */
+    batchIntervalMs?: number;
+    /** 单个DAQ列表单批最多的样本数，默认1024 */
+    maxBatch?: number;
+}
+
+/** 测量变量的数据类型 */
+export type XcpDataType = 'uint8' | 'int8' | 'uint16' | 'int16' | 'uint32' | 'int32'
+    | 'uint64' | 'int64' | 'float32' | 'float64';
+
+/** DAQ测量变量 */
+export interface XcpSignal {
+    /** 批次中signals的键 */
+    name: string;
+    address: number;
+    /** 地址扩展，默认0 */
+    extension?: number;
+    type: XcpDataType;
+}
+
+/** DAQ列表配置 */
+export interface XcpDaqList {
+    /** 触发的事件通道 */
+    eventChannel: number;
+    /** 分频，默认1 */
+    prescaler?: number;
+    /** 优先级，默认0 */
+    priority?: number;
+    signals: XcpSignal[];
+}
+
+/** DAQ配置 */
+export interface XcpDaqConfig {
+    lists: XcpDaqList[];
+    /** 要求从机在首个ODT中携带时间戳，默认true */
+    timestamps?: boolean;
+}
+
+/** XCP命令结果 */
+export interface XcpCommandResult {
+    success: boolean;
+    /** 错误描述 */
+    error?: string;
+    /** 命令超时（含重发） */
+    timeout?: boolean;
+    /** 从机错误响应中的错误码（ERR_*） */
+    errorCode?: number;
+    /** 命令序列耗时（微秒） */
+    durationUs: number;
+}
+
+/** CONNECT结果 */
+export interface XcpConnectResult extends XcpCommandResult {
+    resource?: number;
+    commModeBasic?: number;
+    /** 从机字节序 */
+    byteOrder?: 'intel' | 'motorola';
+    maxCto?: number;
+    maxDto?: number;
+    protocolVersion?: number;
+    transportVersion?: number;
+    sessionStatus?: number;
+    daqProperties?: number;
+    maxDaq?: number;
+    minDaq?: number;
+    maxEventChannel?: number;
+    daqKeyByte?: number;
+    maxOdtEntrySize?: number;
+    /** 位0-2: 时间戳字节数，位4-7: 单位 */
+    timestampMode?: number;
+    timestampTicks?: number;
+}
+
+/** SHORT_UPLOAD结果 */
+export interface XcpUploadResult extends XcpCommandResult {
+    data?: number[];
+}
+
+/** DAQ启动结果 */
+export interface XcpDaqResult extends XcpCommandResult {
+    /** 按配置顺序的分配结果 */
+    lists?: Array<{ daqList: number; firstPid: number; odts: number }>;
+}
+
+/** 信号列的类型化数组 */
+export type XcpColumn = Uint8Array | Int8Array | Uint16Array | Int16Array | Uint32Array | Int32Array
+    | BigUint64Array | BigInt64Array | Float32Array | Float64Array;
+
+/** 一个DAQ列表的列式批次 */
+export interface XcpDaqBatch {
+    /** 配置中的列表序号 */
+    listIndex: number;
+    count: number;
+    /** 校正到设备时间轴的时间戳（微秒） */
+    timestamps: Float64Array;
+    /** 信号名 -> 按样本顺序的值 */
+    signals: Record<string, XcpColumn>;
+}
+
+/** DAQ批次回调函数类型 */
+export type XcpCallback = (batches: XcpDaqBatch[]) => void;
+
+/** XCP统计 */
+export interface XcpStats {
+    commands: number;
+    /** 错误响应 */
+    commandErrors: number;
+    timeouts: number;
+    /** EV包 */
+    events: number;
+    dtos: number;
+    samples: number;
+    /** ODT缺失或乱序而丢弃的样本 */
+    lostSamples: number;
+    unknownPids: number;
+    batches: number;
+    lastCommandUs: number;
+    maxCommandUs: number;
+    /** 从机时钟到设备时间轴的当前偏移（微秒） */
+    clockOffsetUs: number;
+}
+
+/** CANopen客户端配置 */
+export interface CanOpenOptions {
+    /** SDO单帧响应超时（毫秒），默认1000 */
+    sdoTimeoutMs?: number;
+    /** 块上传时本端的块大小（1~127），默认127 */
+    blockSize?: number;
+    /** auto模式下达到该长度时使用块传输，也作为块上传的协议切换阈值，0不使用块传输，默认64 */
+    blockThreshold?: number;
+    /** 上传数据长度上限，默认1MB */
+    maxUploadSize?: number;
+    /** PDO只上报变化的值，默认true */
+    changesOnly?: boolean;
+    /** 单批最多的事件数，默认256 */
+    maxBatch?: number;
+    /** 心跳消费者，超过timeoutMs未收到心跳时上报heartbeatLost */
+    heartbeats?: Array<{ nodeId: number; timeoutMs: number }>;
+}
+
+/** NMT状态 */
+export const CanOpenNmtState = {
+    BOOTUP: 0x00,
+    STOPPED: 0x04,
+    OPERATIONAL: 0x05,
+    PRE_OPERATIONAL: 0x7F,
+} as const;
+
+/** NMT命令 */
+export type CanOpenNmtCommand = 'start' | 'stop' | 'preOperational' | 'resetNode' | 'resetCommunication';
+
+/** PDO映射项的数据类型 */
+export type CanOpenDataType = 'uint8' | 'int8' | 'uint16' | 'int16' | 'uint32' | 'int32'
+    | 'uint64' | 'int64' | 'float32' | 'float64';
+
+/** PDO映射，映射项按顺序从数据域最低位开始紧密排列 */
+export interface CanOpenPdoMapping {
+    /** 11位COB-ID */
+    cobId: number;
+    entries: Array<{
+        /** 事件values的键 */
+        name: string;
+        type: CanOpenDataType;
+        /** 映射位长，默认为类型的完整位宽；整数类型可小于位宽 */
+        bitLength?: number;
+    }>;
+}
+
+/** SDO传输方式：auto按长度选择并在从站不支持时回退，segmented为加速或分段传输 */
+export type CanOpenSdoMode = 'auto' | 'segmented' | 'block';
+
+/** SDO请求 */
+export interface CanOpenSdoRequest {
+    nodeId: number;
+    index: number;
+    /** 子索引，默认0 */
+    subIndex?: number;
+    /** 传输方式，默认auto */
+    mode?: CanOpenSdoMode;
+}
+
+/** SDO结果 */
+export interface CanOpenSdoResult {
+    success: boolean;
+    /** 错误描述 */
+    error?: string;
+    /** SDO超时 */
+    timeout?: boolean;
+    /** 收到或发出的中止码 */
+    abortCode?: number;
+    /** 实际使用的传输方式 */
+    transfer: 'expedited' | 'segmented' | 'block';
+    /** 上传的数据 */
+    data?: number[];
+    /** 传输耗时（微秒） */
+    durationUs: number;
+}
+
+/** CANopen事件 */
+export type CanOpenEvent =
+    /** PDO中变化的映射项（changesOnly为false时为全部映射项） */
+    | { type: 'pdo'; nodeId: number; cobId: number; pdoIndex: number; timestamp: number; values: Record<string, number> }
+    /** 节点状态变化，previousState为null表示之前未知或心跳丢失 */
+    | { type: 'nodeState'; nodeId: number; state: number; previousState: number | null; timestamp: number }
+    /** 心跳超时，timestamp为最后一次心跳的设备时间戳 */
+    | { type: 'heartbeatLost'; nodeId: number; previousState: number | null; timestamp: number }
+    | { type: 'emergency'; nodeId: number; errorCode: number; errorRegister: number; data: number[]; timestamp: number };
+
+/** CANopen事件批次回调函数类型 */
+export type CanOpenCallback = (events: CanOpenEvent[]) => void;
+
+/** CANopen统计 */
+export interface CanOpenStats {
+    sdoTransfers: number;
+    sdoErrors: number;
+    sdoTimeouts: number;
+    /** 从站发出的中止 */
+    sdoAborts: number;
+    sdoBytes: number;
+    /** 块传输中重发或丢弃的段数 */
+    blockRetransmits: number;
+    crcErrors: number;
+    lastSdoUs: number;
+    lastSdoBytesPerSec: number;
+    pdoFrames: number;
+    /** 上报的映射项值数 */
+    pdoValues: number;
+    /** 无变化而未上报的帧数 */
+    pdoUnchanged: number;
+    /** 长度小于映射长度而丢弃的帧数 */
+    pdoLengthErrors: number;
+    heartbeats: number;
+    heartbeatsLost: number;
+    emergencies: number;
+    events: number;
+    batches: number;
+}
+
+/** E2E配置文件 */
+export type E2eProfile = 'p01' | 'p02' | 'p04' | 'p05' | 'p07' | 'p11';
+
+/**
+ * E2E保护配置
+ * - p01/p11：offset处为CRC8（J1850），下一字节低4位为计数器（0~14），dataId低16位参与CRC；p11带结果异或
+ * - p02：布局同p01，CRC8H2F，按计数器从dataIdList选取参与CRC的字节
+ * - p04：offset起12字节头：长度、16位计数器、32位DataID、CRC32P4（均为大端）
+ * - p05：offset起CRC16（小端）和8位计数器，dataId低16位参与CRC
+ * - p07：offset起20字节头：CRC64、长度、32位计数器、32位DataID（均为大端）
+ */
+export interface E2eConfig {
+    profile: E2eProfile;
+    dataId?: number;
+    /** p02必填，16个字节 */
+    dataIdList?: number[];
+    /** 头部起始字节，默认0 */
+    offset?: number;
+    /** 接收时允许的计数器跳变，默认1 */
+    maxDeltaCounter?: number;
+}
+
+/** E2E检查结果 */
+export type E2eStatus = 'ok' | 'repeated' | 'wrongSequence' | 'wrongCrc' | 'wrongDataId' | 'badLength';
+
+/** 单个ID的E2E检查统计 */
+export interface E2eIdStats {
+    id: number;
+    ok: number;
+    repeated: number;
+    wrongSequence: number;
+    wrongCrc: number;
+    wrongDataId: number;
+    badLength: number;
+    lastStatus: E2eStatus;
+    lastCounter: number;
+}
+
+/** E2E检查失败事件 */
+export interface E2eFailure {
+    id: number;
+    status: E2eStatus;
+    counter: number;
+    /** 设备时间戳（微秒） */
+    timestamp: number;
+}
+
+/** E2E检查失败批次回调函数类型 */
+export type E2eCallback = (failures: E2eFailure[]) => void;
+
+/** 残余总线信号和计数器的字节序，motorola的startBit为DBC约定的最高位 */
+export type RestBusByteOrder = 'intel' | 'motorola';
+
+/** 残余总线报文中的信号，物理值 = 原始值 * factor + offset */
+export interface RestBusSignal {
+    /** 信号表中的键为"报文名.信号名" */
+    name: string;
+    startBit: number;
+    /** 1~64 */
+    bitLength: number;
+    /** 默认intel */
+    byteOrder?: RestBusByteOrder;
+    signed?: boolean;
+    /** 默认1 */
+    factor?: number;
+    /** 默认0 */
+    offset?: number;
+    /** 初始物理值，默认0 */
+    initial?: number;
+}
+
+/** 残余总线周期报文 */
+export interface RestBusMessage {
+    /** 报文名，默认为十六进制ID（如"0x123"） */
+    name?: string;
+    /** CAN ID，扩展帧使用buildCanId(id, true) */
+    id: number;
+    fd?: boolean;
+    brs?: boolean;
+    /** 初始数据 */
+    data?: number[];
+    /** 报文长度，默认为data的长度，都未给出时为8 */
+    length?: number;
+    /** 发送周期（毫秒），按引擎刻度取整 */
+    periodMs: number;
+    /** 首次发送相对启动的偏移（毫秒），用于错开同周期的报文 */
+    offsetMs?: number;
+    /** 默认true */
+    enabled?: boolean;
+    signals?: RestBusSignal[];
+    /** 循环计数器，每次发送加step，超过max（默认为位宽最大值）后回到min */
+    counter?: { startBit: number; bitLength: number; byteOrder?: RestBusByteOrder; min?: number; max?: number; step?: number };
+    /** 校验和，在信号和计数器写入后计算，覆盖[start, start+length)中除校验字节外的字节；crc8为SAE J1850 */
+    checksum?: { type: 'sum8' | 'xor8' | 'crc8'; byte: number; start?: number; length?: number };
+    /** E2E保护，在校验和之后写入，发送计数器由引擎维护 */
+    e2e?: E2eConfig;
+}
+
+/** 残余总线引擎配置 */
+export interface RestBusOptions {
+    /** 时间轮刻度（微秒），默认1000 */
+    tickUs?: number;
+    /** 到期前自旋等待的时间（微秒），默认1000，0为只睡眠 */
+    spinUs?: number;
+}
+
+/** 残余总线统计 */
+export interface RestBusStats {
+    /** 有报文到期的刻度数 */
+    ticks: number;
+    frames: number;
+    transmitCalls: number;
+    /** 驱动未接受的帧数 */
+    failedFrames: number;
+    /** 线程延迟超过一个周期而跳过的发送 */
+    skippedCycles: number;
+    /** 唤醒晚于到期时间一个刻度以上的次数 */
+    lateTicks: number;
+    maxLatenessUs: number;
+    maxFramesPerTick: number;
+    /** 引擎读取到的信号表更新次数 */
+    signalSnapshots: number;
+    /** 读取时正在写入而沿用旧值的次数 */
+    snapshotRetries: number;
+}
+
+/** 信号表头部字节数：写入序号（Int32），之后为Float64物理值 */
+const REST_BUS_TABLE_HEADER_BYTES = 8;
+
+/**
+ * 残余总线信号表
+ * 与引擎线程共享内存：写入时序号先变为奇数、写完后变为偶数，引擎只在序号为偶数且读取前后一致时
+ * 取快照，因此update()中写入的多个信号在同一次发送中同时生效
+ */
+export class RestBusSignalTable {
+    /** 信号名，按信号表序号排列 */
+    readonly names: readonly string[];
+    private readonly sequence: Int32Array;
+    private readonly values: Float64Array;
+    private readonly index = new Map<string, number>();
+
+    constructor(table: ArrayBuffer, names: string[]) {
+        this.names = names;
+        this.sequence = new Int32Array(table, 0, 1);
+        this.values = new Float64Array(table, REST_BUS_TABLE_HEADER_BYTES, names.length);
+        names.forEach((name, i) => this.index.set(name, i));
+    }
+
+    /** 当前物理值，信号不存在时返回undefined */
+    get(name: string): number | undefined {
+        const i = this.index.get(name);
+        return i === undefined ? undefined : this.values[i];
+    }
+
+    /** 写入单个信号，返回信号是否存在 */
+    set(name: string, value: number): boolean {
+        const i = this.index.get(name);
+        if (i === undefined) {
+            return false;
+        }
+        Atomics.add(this.sequence, 0, 1);
+        this.values[i] = value;
+        Atomics.add(this.sequence, 0, 1);
+        return true;
+    }
+
+    /**
+     * 原子地写入多个信号
+     * @returns 不存在的信号名
+     */
+    update(values: Record<string, number>): string[] {
+        const missing: string[] = [];
+        Atomics.add(this.sequence, 0, 1);
+        try {
+            for (const [name, value] of Object.entries(values)) {
+                const i = this.index.get(name);
+                if (i === undefined) {
+                    missing.push(name);
+                } else {
+                    this.values[i] = value;
+                }
+            }
+        } finally {
+            Atomics.add(this.sequence, 0, 1);
+        }
+        return missing;
+    }
+}
+
+/** LIN校验方式 */
+export const LinChkSumMode = {
+    /** 使用通道初始化时的配置 */
+    DEFAULT: 0,
+    /** 经典校验 */
+    CLASSIC: 1,
+    /** 增强校验 */
+    ENHANCE: 2,
+    /** 自动识别（仅订阅有效） */
+    AUTOMATIC: 3,
+} as const;
+
+/** LIN事件类型 */
+export const LinEventType = {
+    WAKE_UP: 1,
+    ENTERED_SLEEP_MODE: 2,
+    EXITED_SLEEP_MODE: 3,
+    SWITCH_SCHED: 4,
+} as const;
+
+/** LIN调度表状态 */
+export const LinScheduleStatus = {
+    IDLE: 0,
+    RUNNING: 1,
+} as const;
+
+/** LIN通道初始化配置 */
+export interface LinChannelConfig {
+    /** 0-从机，1-主机，默认1 */
+    linMode?: number;
+    /** 校验方式，默认增强校验 */
+    chkSumMode?: number;
+    /** 最大数据长度，8~64，默认8 */
+    maxLength?: number;
+    /** 波特率，1000~20000，默认19200 */
+    linBaud?: number;
+}
+
+/** LIN发送帧 */
+export interface LinFrame {
+    /** 帧ID，0~63 */
+    id: number;
+    /** 数据，主机发送帧头时可省略 */
+    data?: number[];
+}
+
+/** LIN数据 */
+export interface LinData {
+    /** 帧ID */
+    id: number;
+    /** 受保护的ID（含校验位） */
+    pid: number;
+    /** 时间戳（微秒） */
+    timestamp: number;
+    /** 0-接收，1-发送 */
+    dir: number;
+    chkSum: number;
+    data: number[];
+}
+
+/** LIN错误数据 */
+export interface LinErrData extends LinData {
+    errStage: number;
+    errReason: number;
+}
+
+/** LIN事件数据 */
+export interface LinEventData {
+    /** 时间戳（微秒） */
+    timestamp: number;
+    /** 事件类型，见LinEventType */
+    eventType: number;
+}
+
+/** receiveLin和LIN接收回调中的消息 */
+export type LinMessage =
+    | ({ type: 'data'; chnl: number } & LinData)
+    | ({ type: 'error'; chnl: number } & LinErrData)
+    | ({ type: 'event'; chnl: number } & LinEventData);
+
+/** LIN接收回调函数类型，每次传入接收线程一轮读取到的消息 */
+export type LinReceiveCallback = (messages: LinMessage[]) => void;
+
+/** LIN发布配置 */
+export interface LinPublishConfig {
+    id: number;
+    /** 数据，超过8字节时使用扩展发布配置 */
+    data: number[];
+    chkSumMode?: number;
+}
+
+/** LIN订阅配置 */
+export interface LinSubscribeConfig {
+    id: number;
+    /** 数据长度，默认255表示自动识别 */
+    dataLen?: number;
+    chkSumMode?: number;
+}
+
+/** LIN调度表项 */
+export interface LinScheduleItem {
+    /** 帧类型，默认unconditional */
+    type?: 'unconditional' | 'event' | 'sporadic' | 'masterRequest' | 'slaveResponse' | 'reserved';
+    /** 帧ID；事件触发帧为事件帧ID，偶发帧忽略 */
+    id?: number;
+    /** 帧时隙（毫秒），默认10 */
+    slotMs?: number;
+    /** 事件触发帧或偶发帧关联的无条件帧ID，最多16个，索引0优先级最高 */
+    relatedIds?: number[];
+    /** 事件触发帧冲突时切换的调度表 */
+    resolveSchedule?: number;
+}
+
+/** LIN接收线程统计 */
+export interface LinReceiveThreadStats {
+    /** 从驱动读取的消息数 */
+    framesReceived: number;
+    /** 缓存满或回调队列满（JS处理跟不上）时丢弃的消息数 */
+    framesDropped: number;
+    /** 读取到数据的轮询次数 */
+    wakeups: number;
+    /** 尚未被receiveLin取出的消息数 */
+    ringDepth: number;
+}
+
+/** 单个接口的调用统计（耗时为从调用前到返回后的墙钟时间） */
+export interface ApiCallStats {
+    /** 调用次数 */
+    calls: number;
+    /** 失败次数（返回错误状态/无效句柄/空值，或批量发送未全部发出） */
+    errors: number;
+    /** 搬运的帧/报文数 */
+    frames: number;
+    /** 跨越接口的结构体字节数 */
+    bytes: number;
+    /** 累计耗时 (us) */
+    totalUs: number;
+    /** 平均耗时 (us) */
+    meanUs: number;
+    /** 耗时分位数 (us)，取所在直方图桶的上界，相对误差不超过25% */
+    p50Us: number;
+    p90Us: number;
+    p99Us: number;
+    p999Us: number;
+    /** 最大耗时所在桶的上界 (us) */
+    maxUs: number;
+    /** 非空直方图桶: [桶上界us, 次数] */
+    histogram: Array<[number, number]>;
+}
+
+/** 接口调用统计快照 */
+export interface ApiStats {
+    /** 计时时钟每滴答的纳秒数（x86为TSC，其他平台为1） */
+    nsPerTick: number;
+    /** 当前登记了计数块的线程数 */
+    threads: number;
+    /**
+     * 按接口名索引，只含自上次resetStats以来有调用的接口
+     * ZCAN_*为驱动接口，js.*为对应JS方法的整体耗时（含参数与结果的封送）
+     */
+    apis: Record<string, ApiCallStats>;
+}
+
+/** 原生层时间线事件（时间单位us，时间轴为单调时钟，与process.hrtime一致） */
+export interface NativeTraceEvent {
+    /** 事件名：ZCAN_*驱动调用、js.*方法整体、rx.wakeup/ring.push/ring.pop等 */
+    name: string;
+    /** 类别：zcan/js/rx */
+    cat: string;
+    /** 'X'为持续事件，'i'为瞬时事件 */
+    ph: string;
+    /** 线程编号 */
+    tid: number;
+    /** 起始时间 (us) */
+    ts: number;
+    /** 持续时间 (us) */
+    dur: number;
+    /** 附加值（帧数、丢弃数等） */
+    arg: number;
+}
+
+/** 原生层时间线导出 */
+export interface NativeTraceDump {
+    events: NativeTraceEvent[];
+    /** 线程编号 -> 线程名 */
+    threads: Record<string, string>;
+    /** 调用traceDump的线程（JS主线程）编号 */
+    callerTid: number;
+    /** 缓冲区写满后被覆盖的事件数 */
+    overwritten: number;
+}
+
+/**
+ * 原生线程角色
+ * receive: CAN/LIN接收线程；transmit: 剩余总线周期发送线程；monitor: 健康、热插拔、接收链路监视线程
+ */
+export type ThreadRole = 'receive' | 'transmit' | 'monitor';
+
+/** 原生线程调度策略 */
+export interface ThreadSchedulingPolicy {
+    /** 请求实时调度（Linux SCHED_FIFO，Windows THREAD_PRIORITY_TIME_CRITICAL并将定时器精度提高到1ms），默认false */
+    realtime?: boolean;
+    /** SCHED_FIFO优先级(1~99)，默认50；Windows忽略 */
+    priority?: number;
+    /** 绑定的CPU编号，空表示不限制 */
+    cpus?: number[];
+}
+
+/** 原生线程调度生效情况 */
+export interface ThreadSchedulingState {
+    realtime: boolean;
+    priority: number;
+    cpus: number[];
+    /** 当前运行中的线程数 */
+    threads: number;
+    /** 所有线程均已获得实时优先级 */
+    realtimeApplied: boolean;
+    /** 所有线程均已绑定CPU */
+    affinityApplied: boolean;
+    /** 无实时调度权限时实际采用的优先级，例如'nice -10' */
+    fallback?: string;
+    /** 最近一次设置失败的原因 */
+    error?: string;
+    /** 定时唤醒延迟：期望唤醒时刻到线程实际运行的时间差（微秒） */
+    wakeupLatency: {
+        wakeups: number;
+        meanUs: number;
+        p50Us: number;
+        p99Us: number;
+        p999Us: number;
+        maxUs: number;
+    };
+}
+
 // ============== ZLG CAN设备封装类 ==============
 
 /**
@@ -579,49 +2054,138 @@ export class ZlgCanDevice {
         this.device = new zlgcan.ZlgCanDevice();
     }
 
-    // ==================== 设备操作 ====================
+    // ==================== 接口调用统计 ====================
 
     /**
-     * 打开设备
-     * @param deviceType 设备类型 (参见DeviceType常量)
-     * @param deviceIndex 设备索引 (从0开始)
-     * @param reserved 保留参数 (默认为0)
-     * @returns 成功返回true，失败返回false
+     * 获取进程内所有线程（含接收线程、协议引擎线程）的驱动接口调用统计
+     * @returns 自上次resetStats以来的统计快照
      */
-    openDevice(deviceType: DeviceTypeValue, deviceIndex: number, reserved: number = 0): boolean {
-        return this.device.openDevice(deviceType, deviceIndex, reserved);
+    static getStats(): ApiStats {
+        return zlgcan.ZlgCanDevice.getStats();
     }
 
     /**
-     * 关闭设备
-     * @returns 成功返回true，失败返回false
+     * 将当前累计值设为统计零点
      */
-    closeDevice(): boolean {
-        return this.device.closeDevice();
+    static resetStats(): void {
+        zlgcan.ZlgCanDevice.resetStats();
     }
 
+    // ==================== 时间线记录 ====================
+
     /**
-     * 获取设备信息
-     * @returns 设备信息对象，失败返回null
+     * 开始记录原生层时间线（驱动调用、接收线程唤醒、环形缓存交接）
+     * @param capacity 缓冲区事件数，写满后覆盖最旧的事件 (默认262144)
      */
-    getDeviceInfo(): DeviceInfo | null {
-        return this.device.getDeviceInfo();
+    static traceStart(capacity?: number): void {
+        zlgcan.ZlgCanDevice.traceStart(capacity);
     }
 
     /**
-     * 获取扩展设备信息
-     * @returns 扩展设备信息对象，失败返回null
+     * 停止记录，已记录的事件保留到下次traceStart
      */
-    getDeviceInfoEx(): DeviceInfoEx | null {
-        return this.device.getDeviceInfoEx();
+    static traceStop(): void {
+        zlgcan.ZlgCanDevice.traceStop();
     }
 
     /**
-     * 检查设备是否在线
-     * @returns 在线返回true，离线返回false
+     * 读取自最近一次traceStart以来的事件
      */
-    isDeviceOnLine(): boolean {
-        return this.device.isDeviceOnLine();
+    static traceDump(): NativeTraceDump {
+        return zlgcan.ZlgCanDevice.traceDump();
+    }
+
+    // ==================== 原生线程调度 ====================
+
+    /**
+     * 设置一类原生线程的优先级和CPU绑定，立即作用于运行中的线程，之后启动的线程同样生效
+     * 没有权限时逐级降级，不抛出异常，结果见返回值的realtimeApplied/fallback/error
+     * @param role 线程角色
+     * @param policy 调度策略
+     */
+    static setThreadScheduling(role: ThreadRole, policy: ThreadSchedulingPolicy): ThreadSchedulingState {
+        return zlgcan.ZlgCanDevice.setThreadScheduling(role, policy);
+    }
+
+    /**
+     * 获取各类原生线程的调度生效情况和唤醒延迟
+     */
+    static getThreadScheduling(): Record<ThreadRole, ThreadSchedulingState> {
+        return zlgcan.ZlgCanDevice.getThreadScheduling();
+    }
+
+    /**
+     * 清零唤醒延迟统计
+     */
+    static resetThreadLatency(): void {
+        zlgcan.ZlgCanDevice.resetThreadLatency();
+    }
+
+    // ==================== 设备操作 ====================
+
+    /**
+     * 打开设备
+     * @param deviceType 设备类型 (参见DeviceType常量)
+     * @param deviceIndex 设备索引 (从0开始)
+     * @param reserved 保留参数 (默认为0)
+     * @returns 成功返回true，失败返回false
+     */
+    openDevice(deviceType: DeviceTypeValue, deviceIndex: number, reserved: number = 0): boolean {
+        return this.device.openDevice(deviceType, deviceIndex, reserved);
+    }
+
+    /**
+     * 关闭设备
+     * @returns 成功返回true，失败返回false
+     */
+    closeDevice(): boolean {
+        return this.device.closeDevice();
+    }
+
+    /**
+     * 获取设备信息
+     * @returns 设备信息对象，失败返回null
+     */
+    getDeviceInfo(): DeviceInfo | null {
+        return this.device.getDeviceInfo();
+    }
+
+    /**
+     * 获取扩展设备信息
+     * @returns 扩展设备信息对象，失败返回null
+     */
+    getDeviceInfoEx(): DeviceInfoEx | null {
+        return this.device.getDeviceInfoEx();
+    }
+
+    /**
+     * 检查设备是否在线
+     * @returns 在线返回true，离线返回false
+     */
+    isDeviceOnLine(): boolean {
+        return this.device.isDeviceOnLine();
+    }
+
+    /**
+     * 异步打开设备（在工作线程中执行，适用于打开耗时较长的网络设备）
+     * 超时后才打开成功的设备会被自动关闭
+     * @param deviceType 设备类型 (参见DeviceType常量)
+     * @param deviceIndex 设备索引 (从0开始)
+     * @param reserved 保留参数 (默认为0)
+     * @param timeoutMs 超时时间（毫秒），0表示不限时
+     * @returns 成功返回true，失败返回false；超时则reject
+     */
+    openDeviceAsync(deviceType: DeviceTypeValue, deviceIndex: number, reserved: number = 0, timeoutMs: number = 0): Promise<boolean> {
+        return this.device.openDeviceAsync(deviceType, deviceIndex, reserved, timeoutMs);
+    }
+
+    /**
+     * 异步关闭设备
+     * @param timeoutMs 超时时间（毫秒），0表示不限时
+     * @returns 成功返回true，失败返回false；超时则reject
+     */
+    closeDeviceAsync(timeoutMs: number = 0): Promise<boolean> {
+        return this.device.closeDeviceAsync(timeoutMs);
     }
 
     // ==================== 属性操作 ====================
@@ -691,7 +2255,29 @@ export class ZlgCanDevice {
      * @returns 通道句柄 (BigInt)，0n表示失败
      */
     initCanChannel(channelIndex: number, config: CanChannelConfig): ChannelHandle {
-        const fullConfig = {
+        const handle = this.device.initCanChannel(channelIndex, this.toNativeChannelConfig(config));
+        // C++层返回BigInt
+        return typeof handle === 'bigint' ? handle : BigInt(handle);
+    }
+
+    /**
+     * 异步初始化CAN通道（不同通道可并行初始化）
+     * @param channelIndex 通道索引 (从0开始)
+     * @param config 通道配置
+     * @param timeoutMs 超时时间（毫秒），0表示不限时
+     * @returns 通道句柄 (BigInt)，0n表示失败；超时则reject。
+     *          完成前该通道被复位、重新初始化或设备被关闭时结果作废，同样返回0n
+     */
+    async initCanChannelAsync(channelIndex: number, config: CanChannelConfig, timeoutMs: number = 0): Promise<ChannelHandle> {
+        const handle = await this.device.initCanChannelAsync(channelIndex, this.toNativeChannelConfig(config), timeoutMs);
+        return typeof handle === 'bigint' ? handle : BigInt(handle);
+    }
+
+    /**
+     * 补全通道配置的默认值
+     */
+    private toNativeChannelConfig(config: CanChannelConfig): Required<CanChannelConfig> {
+        return {
             canType: config.canType,
             accCode: config.accCode ?? 0,
             accMask: config.accMask ?? 0xFFFFFFFF,
@@ -705,9 +2291,6 @@ export class ZlgCanDevice {
             brp: config.brp ?? 0,
             pad: config.pad ?? 0,
         };
-        const handle = this.device.initCanChannel(channelIndex, fullConfig);
-        // C++层返回BigInt
-        return typeof handle === 'bigint' ? handle : BigInt(handle);
     }
 
     /**
@@ -719,6 +2302,16 @@ export class ZlgCanDevice {
         return this.device.startCanChannel(channelHandle);
     }
 
+    /**
+     * 异步启动CAN通道
+     * @param channelHandle 通道句柄
+     * @param timeoutMs 超时时间（毫秒），0表示不限时
+     * @returns 成功返回true，失败返回false；超时则reject
+     */
+    startCanChannelAsync(channelHandle: ChannelHandle, timeoutMs: number = 0): Promise<boolean> {
+        return this.device.startCanChannelAsync(channelHandle, timeoutMs);
+    }
+
     /**
      * 复位CAN通道
      * @param channelHandle 通道句柄
@@ -737,8 +2330,19 @@ export class ZlgCanDevice {
         return this.device.clearBuffer(channelHandle);
     }
 
+    /**
+     * 通道静默：取消设备定时发送和队列发送，等待发送队列排空后清空接收缓冲区一次，
+     * 不等待其他节点静默。在工作线程中执行，用于测试用例之间的隔离
+     * @param channelHandles 通道句柄列表
+     * @param options 静默配置
+     */
+    quiesceAsync(channelHandles: ChannelHandle[], options: QuiesceOptions = {}): Promise<QuiesceResult> {
+        return this.device.quiesceAsync(channelHandles, options);
+    }
+
     /**
      * 读取通道错误信息
+     * 驱动读取后即清除；健康监视运行时包含监视器自上次读取以来采样到的错误
      * @param channelHandle 通道句柄
      * @returns 错误信息对象，失败返回null
      */
@@ -836,7 +2440,8 @@ export class ZlgCanDevice {
     /**
      * 接收合并数据对象
      * @param count 最大接收数量
-     * @param waitTime 等待时间（毫秒），-1表示阻塞等待
+     * @param waitTime 等待时间（毫秒），-1表示阻塞等待；接收线程运行时-1至多等待1000毫秒，
+     *                 返回的CAN/CANFD帧与错误、LIN等记录按设备时间戳合并排序
      * @returns 接收到的数据对象数组
      */
     receiveData(count: number, waitTime: number = -1): DataObj[] {
@@ -861,6 +2466,774 @@ export class ZlgCanDevice {
     clearReceiveCallback(channelHandle: ChannelHandle): boolean {
         return this.device.clearReceiveCallback(channelHandle);
     }
+
+    // ==================== 通道健康监视 ====================
+
+    /**
+     * 启动通道健康监视
+     * 监视在原生线程中运行，回调不影响监视和恢复的时序
+     * @param channelHandle 通道句柄
+     * @param options 监视配置
+     * @param callback 健康事件回调
+     * @returns 成功返回true
+     */
+    startHealthMonitor(channelHandle: ChannelHandle, options: HealthMonitorOptions, callback: HealthEventCallback): boolean {
+        return this.device.startHealthMonitor(channelHandle, options, callback);
+    }
+
+    /**
+     * 停止通道健康监视
+     * @param channelHandle 通道句柄
+     * @returns 成功返回true，未启动监视返回false
+     */
+    stopHealthMonitor(channelHandle: ChannelHandle): boolean {
+        return this.device.stopHealthMonitor(channelHandle);
+    }
+
+    /**
+     * 获取通道健康状态
+     * @param channelHandle 通道句柄
+     * @returns 健康状态，未启动监视返回null
+     */
+    getHealthState(channelHandle: ChannelHandle): ChannelHealthState | null {
+        return this.device.getHealthState(channelHandle);
+    }
+
+    // ==================== 接收链路监视 ====================
+
+    /**
+     * 启动接收链路监视
+     * 原生线程周期探测JS事件循环延迟，并采样所有已初始化通道的接收环形缓冲、驱动接收缓冲深度和丢帧数；
+     * 缓冲接近写满或事件循环阻塞时回调告警。重复调用以新配置重新启动，关闭设备时自动停止
+     * @param options 监视配置
+     * @param callback 告警回调
+     * @returns 成功返回true
+     */
+    startPipelineWatchdog(options: PipelineWatchdogOptions, callback: PipelineWarningCallback): boolean {
+        return this.device.startPipelineWatchdog(options, callback);
+    }
+
+    /**
+     * 停止接收链路监视
+     * @returns 成功返回true，未启动监视返回false
+     */
+    stopPipelineWatchdog(): boolean {
+        return this.device.stopPipelineWatchdog();
+    }
+
+    /**
+     * 获取接收链路采样序列
+     * @param sinceTimestamp 只返回晚于该时间的采样点，默认全部
+     * @returns 按时间排序的采样点，未启动监视返回null
+     */
+    getPipelineHistory(sinceTimestamp?: number): PipelineSample[] | null {
+        return this.device.getPipelineHistory(sinceTimestamp);
+    }
+
+    // ==================== 设备热插拔监视 ====================
+
+    /**
+     * 启动设备热插拔监视
+     * 设备离线后在原生线程中重新打开设备，并按原顺序回放通道初始化、启动和setValue设置
+     * @param options 监视配置
+     * @param callback 热插拔事件回调
+     * @returns 成功返回true
+     */
+    startDeviceMonitor(options: DeviceMonitorOptions, callback: DeviceMonitorCallback): boolean {
+        return this.device.startDeviceMonitor(options, callback);
+    }
+
+    /**
+     * 停止设备热插拔监视
+     * @returns 成功返回true，未启动监视返回false
+     */
+    stopDeviceMonitor(): boolean {
+        return this.device.stopDeviceMonitor();
+    }
+
+    /**
+     * 获取设备热插拔监视状态
+     * @returns 监视状态，设备未打开返回null
+     */
+    getDeviceMonitorState(): DeviceMonitorState | null {
+        return this.device.getDeviceMonitorState();
+    }
+
+    // ==================== UDS诊断 ====================
+
+    /**
+     * 异步UDS诊断请求
+     * 请求在原生线程中执行；同一通道的请求依次执行，不同通道的请求并发执行
+     * @param request 请求参数
+     * @returns 诊断响应，超时、取消等结果通过status返回；reqId为分配的请求事务ID
+     */
+    udsRequestAsync(request: UdsRequest): PendingUdsRequest<UdsResponse> {
+        return this.device.udsRequestAsync(request);
+    }
+
+    /**
+     * 取消UDS诊断请求
+     * @param reqId 请求事务ID
+     * @returns 请求存在返回true
+     */
+    udsCancel(reqId: number): boolean {
+        return this.device.udsCancel(reqId);
+    }
+
+    // ==================== DoIP诊断 ====================
+
+    /**
+     * 异步DoIP诊断请求
+     * 服务器地址、源地址、版本和路由激活类型相同的请求复用同一连接；
+     * 同一连接上发往同一目标地址的请求依次执行，发往不同目标地址的请求同时在途。
+     * 取消请求使用udsCancel
+     * @param request 请求参数
+     * @returns 诊断响应，连接失败、超时、NACK等结果通过status返回；reqId为分配的请求事务ID
+     */
+    doipRequestAsync(request: DoipRequest): PendingUdsRequest<DoipResponse> {
+        return this.device.doipRequestAsync(request);
+    }
+
+    /**
+     * 获取DoIP连接统计
+     * @returns 各连接的统计信息
+     */
+    getDoipConnections(): DoipConnectionStats[] {
+        return this.device.getDoipConnections();
+    }
+
+    // ==================== 接收线程 ====================
+
+    /**
+     * 启动通道接收线程
+     * 原生线程持续读取驱动缓冲区，帧先交给ISO-TP等协议引擎，其余帧缓存后由receive/receiveFD取出
+     * @param channelHandle 通道句柄
+     * @param options 接收线程配置
+     * @returns 成功返回true，已启动返回false
+     */
+    startReceiveThread(channelHandle: ChannelHandle, options: ReceiveThreadOptions = {}): boolean {
+        return this.device.startReceiveThread(channelHandle, options);
+    }
+
+    /**
+     * 停止通道接收线程，同时关闭该通道上的ISO-TP会话
+     * @param channelHandle 通道句柄
+     * @returns 成功返回true，未启动返回false
+     */
+    stopReceiveThread(channelHandle: ChannelHandle): boolean {
+        return this.device.stopReceiveThread(channelHandle);
+    }
+
+    /**
+     * 获取接收线程统计
+     * @param channelHandle 通道句柄
+     * @returns 统计信息，未启动返回null
+     */
+    getReceiveThreadStats(channelHandle: ChannelHandle): ReceiveThreadStats | null {
+        return this.device.getReceiveThreadStats(channelHandle);
+    }
+
+    /**
+     * 打开帧流缓冲
+     * 接收线程把每个未被协议引擎认领的帧复制到各帧流缓冲，帧流之间及与receive/receiveFD互不分取，
+     * 容量与丢弃策略各自独立。回调由armReceiveStream登记后触发一次（缓冲有新帧时），
+     * 接收线程停止时也会触发一次
+     * @param channelHandle 通道句柄
+     * @param options 缓冲配置
+     * @param callback 缓冲就绪回调
+     * @returns 帧流ID，接收线程未启动返回null
+     */
+    openReceiveStream(channelHandle: ChannelHandle, options: ReceiveStreamOptions, callback: () => void): number | null {
+        return this.device.openReceiveStream(channelHandle, options, callback);
+    }
+
+    /**
+     * 取出帧流缓冲中的帧，不等待
+     * @param channelHandle 通道句柄
+     * @param streamId 帧流ID
+     * @param count CAN和CANFD各最多取出的帧数
+     * @returns 一批帧，帧流已关闭或接收线程已停止返回null
+     */
+    readReceiveStream(channelHandle: ChannelHandle, streamId: number, count: number): ReceiveStreamBatch | null {
+        return this.device.readReceiveStream(channelHandle, streamId, count);
+    }
+
+    /**
+     * 登记一次帧流缓冲就绪通知
+     * @param channelHandle 通道句柄
+     * @param streamId 帧流ID
+     * @returns 缓冲中已有帧时返回true（不登记，应立即取帧），否则返回false
+     */
+    armReceiveStream(channelHandle: ChannelHandle, streamId: number): boolean {
+        return this.device.armReceiveStream(channelHandle, streamId);
+    }
+
+    /**
+     * 关闭帧流缓冲，返回后不会再有回调
+     * @param channelHandle 通道句柄
+     * @param streamId 帧流ID
+     * @returns 成功返回true，帧流不存在返回false
+     */
+    closeReceiveStream(channelHandle: ChannelHandle, streamId: number): boolean {
+        return this.device.closeReceiveStream(channelHandle, streamId);
+    }
+
+    // ==================== ISO-TP传输层 ====================
+
+    /**
+     * 打开ISO-TP会话
+     * 协议处理在通道接收线程中进行（未启动时自动启动），流控帧在收到首帧后立即回复
+     * @param channelHandle 通道句柄
+     * @param options 会话配置
+     * @param callback 接收事件回调
+     * @returns 会话ID
+     */
+    isotpOpen(channelHandle: ChannelHandle, options: IsoTpOptions, callback: IsoTpCallback): number {
+        return this.device.isotpOpen(channelHandle, options, callback);
+    }
+
+    /**
+     * 关闭ISO-TP会话，发送中的消息以错误结束
+     * @param sessionId 会话ID
+     * @returns 成功返回true，会话不存在返回false
+     */
+    isotpClose(sessionId: number): boolean {
+        return this.device.isotpClose(sessionId);
+    }
+
+    /**
+     * 异步发送ISO-TP消息
+     * 分段、流控等待和STmin间隔在原生线程中完成；同一会话的发送依次执行
+     * @param sessionId 会话ID
+     * @param data 消息数据
+     * @returns 发送结果
+     */
+    isotpSendAsync(sessionId: number, data: number[]): Promise<IsoTpSendResult> {
+        return this.device.isotpSendAsync(sessionId, data);
+    }
+
+    /**
+     * 获取ISO-TP会话统计
+     * @param sessionId 会话ID
+     * @returns 统计信息，会话不存在返回null
+     */
+    isotpGetStats(sessionId: number): IsoTpStats | null {
+        return this.device.isotpGetStats(sessionId);
+    }
+
+    // ==================== 在线烧写 ====================
+
+    /**
+     * 异步烧写固件（UDS 0x34/0x36/0x37）
+     * 调用前须已进入编程会话并完成安全访问；文件以内存映射方式读取，
+     * 传输在原生线程中进行，下一块在当前块传输期间预先组好
+     * @param channelHandle 通道句柄
+     * @param options 烧写配置
+     * @param onProgress 进度回调
+     * @returns 烧写结果
+     */
+    flashAsync(channelHandle: ChannelHandle, options: FlashOptions, onProgress?: FlashProgressCallback): Promise<FlashResult> {
+        return this.device.flashAsync(channelHandle, options, onProgress);
+    }
+
+    /**
+     * 取消通道上进行中的烧写
+     * @param channelHandle 通道句柄
+     * @returns 有进行中的烧写返回true
+     */
+    flashCancel(channelHandle: ChannelHandle): boolean {
+        return this.device.flashCancel(channelHandle);
+    }
+
+    // ==================== J1939传输协议 ====================
+
+    /**
+     * 启动J1939传输协议处理
+     * 在通道接收线程中（未启动时自动启动）提取PGN并重组BAM和RTS/CTS会话，
+     * 完整的消息在每轮轮询末尾整批回调
+     * @param channelHandle 通道句柄
+     * @param options 配置
+     * @param callback 消息批次回调
+     * @returns 成功返回true，已启动返回false
+     */
+    startJ1939(channelHandle: ChannelHandle, options: J1939Options, callback: J1939Callback): boolean {
+        return this.device.startJ1939(channelHandle, options, callback);
+    }
+
+    /**
+     * 停止J1939传输协议处理，发送中的消息以错误结束
+     * @param channelHandle 通道句柄
+     * @returns 成功返回true，未启动返回false
+     */
+    stopJ1939(channelHandle: ChannelHandle): boolean {
+        return this.device.stopJ1939(channelHandle);
+    }
+
+    /**
+     * 异步发送J1939消息
+     * 8字节以内为单帧；目标地址0xFF时以BAM广播，否则以RTS/CTS发送；同一通道的发送依次执行
+     * @param channelHandle 通道句柄
+     * @param message 消息
+     * @returns 发送结果
+     */
+    j1939SendAsync(channelHandle: ChannelHandle, message: J1939SendMessage): Promise<J1939SendResult> {
+        return this.device.j1939SendAsync(channelHandle, message);
+    }
+
+    /**
+     * 获取J1939统计
+     * @param channelHandle 通道句柄
+     * @returns 统计信息，未启动返回null
+     */
+    getJ1939Stats(channelHandle: ChannelHandle): J1939Stats | null {
+        return this.device.getJ1939Stats(channelHandle);
+    }
+
+    // ==================== XCP测量 ====================
+
+    /**
+     * 启动XCP-on-CAN主站
+     * 在通道接收线程中（未启动时自动启动）处理CRM，并按ODT解码表把DTO直接解码为信号列，
+     * 每个批次间隔整批回调
+     * @param channelHandle 通道句柄
+     * @param options 配置
+     * @param callback DAQ批次回调
+     * @returns 成功返回true，已启动返回false
+     */
+    startXcp(channelHandle: ChannelHandle, options: XcpOptions, callback: XcpCallback): boolean {
+        return this.device.startXcp(channelHandle, options, callback);
+    }
+
+    /**
+     * 停止XCP主站，等待中的命令以错误结束
+     * @param channelHandle 通道句柄
+     * @returns 成功返回true，未启动返回false
+     */
+    stopXcp(channelHandle: ChannelHandle): boolean {
+        return this.device.stopXcp(channelHandle);
+    }
+
+    /**
+     * 异步连接从机
+     * 依次执行CONNECT、GET_STATUS，从机支持DAQ时读取DAQ处理器和分辨率信息
+     * @param channelHandle 通道句柄
+     * @returns 连接结果
+     */
+    xcpConnectAsync(channelHandle: ChannelHandle): Promise<XcpConnectResult> {
+        return this.device.xcpConnectAsync(channelHandle);
+    }
+
+    /**
+     * 异步断开从机
+     * @param channelHandle 通道句柄
+     * @returns 命令结果
+     */
+    xcpDisconnectAsync(channelHandle: ChannelHandle): Promise<XcpCommandResult> {
+        return this.device.xcpDisconnectAsync(channelHandle);
+    }
+
+    /**
+     * 异步读取从机内存（SHORT_UPLOAD）
+     * @param channelHandle 通道句柄
+     * @param request 地址、地址扩展和字节数
+     * @returns 读取结果
+     */
+    xcpShortUploadAsync(channelHandle: ChannelHandle,
+                        request: { address: number; extension?: number; length: number }): Promise<XcpUploadResult> {
+        return this.device.xcpShortUploadAsync(channelHandle, request);
+    }
+
+    /**
+     * 异步写入从机内存（SET_MTA + DOWNLOAD，超过单帧时分多次）
+     * @param channelHandle 通道句柄
+     * @param request 地址、地址扩展和数据
+     * @returns 命令结果
+     */
+    xcpDownloadAsync(channelHandle: ChannelHandle,
+                     request: { address: number; extension?: number; data: number[] }): Promise<XcpCommandResult> {
+        return this.device.xcpDownloadAsync(channelHandle, request);
+    }
+
+    /**
+     * 异步配置并启动DAQ
+     * 释放从机中已有的动态DAQ列表，把信号按顺序装入ODT后写入从机，全部列表同步启动
+     * @param channelHandle 通道句柄
+     * @param config DAQ配置
+     * @returns 启动结果
+     */
+    xcpStartDaqAsync(channelHandle: ChannelHandle, config: XcpDaqConfig): Promise<XcpDaqResult> {
+        return this.device.xcpStartDaqAsync(channelHandle, config);
+    }
+
+    /**
+     * 异步停止全部DAQ列表，已解码的样本在下一个批次间隔回调
+     * @param channelHandle 通道句柄
+     * @returns 命令结果
+     */
+    xcpStopDaqAsync(channelHandle: ChannelHandle): Promise<XcpCommandResult> {
+        return this.device.xcpStopDaqAsync(channelHandle);
+    }
+
+    /**
+     * 获取XCP统计
+     * @param channelHandle 通道句柄
+     * @returns 统计信息，未启动返回null
+     */
+    getXcpStats(channelHandle: ChannelHandle): XcpStats | null {
+        return this.device.getXcpStats(channelHandle);
+    }
+
+    // ==================== CANopen ====================
+
+    /**
+     * 启动CANopen客户端
+     * 在通道接收线程中（未启动时自动启动）推进SDO传输，解析心跳、紧急报文和已配置的PDO，
+     * 事件在每轮轮询末尾整批回调。被处理的帧不再进入receive()的缓冲
+     * @param channelHandle 通道句柄
+     * @param options 配置
+     * @param callback 事件批次回调
+     * @returns 成功返回true，已启动返回false
+     */
+    startCanOpen(channelHandle: ChannelHandle, options: CanOpenOptions, callback: CanOpenCallback): boolean {
+        return this.device.startCanOpen(channelHandle, options, callback);
+    }
+
+    /**
+     * 停止CANopen客户端，进行中的SDO请求以错误结束
+     * @param channelHandle 通道句柄
+     * @returns 成功返回true，未启动返回false
+     */
+    stopCanOpen(channelHandle: ChannelHandle): boolean {
+        return this.device.stopCanOpen(channelHandle);
+    }
+
+    /**
+     * 替换PDO映射表
+     * 每个PDO编译为原生层的提取计划，已记录的值被清除，下一帧上报全部映射项
+     * @param channelHandle 通道句柄
+     * @param pdos PDO映射
+     * @returns 成功返回true，映射无效时抛出TypeError
+     */
+    canopenConfigurePdo(channelHandle: ChannelHandle, pdos: CanOpenPdoMapping[]): boolean {
+        return this.device.canopenConfigurePdo(channelHandle, pdos);
+    }
+
+    /**
+     * 异步读取对象字典（SDO上传）
+     * 同一节点的请求依次执行
+     * @param channelHandle 通道句柄
+     * @param request 节点、索引和传输方式
+     * @returns 上传结果
+     */
+    canopenSdoUploadAsync(channelHandle: ChannelHandle, request: CanOpenSdoRequest): Promise<CanOpenSdoResult> {
+        return this.device.canopenSdoUploadAsync(channelHandle, request);
+    }
+
+    /**
+     * 异步写入对象字典（SDO下载）
+     * 同一节点的请求依次执行
+     * @param channelHandle 通道句柄
+     * @param request 节点、索引、数据和传输方式
+     * @returns 下载结果
+     */
+    canopenSdoDownloadAsync(channelHandle: ChannelHandle,
+                            request: CanOpenSdoRequest & { data: number[] }): Promise<CanOpenSdoResult> {
+        return this.device.canopenSdoDownloadAsync(channelHandle, request);
+    }
+
+    /**
+     * 发送NMT命令
+     * @param channelHandle 通道句柄
+     * @param command 命令
+     * @param nodeId 节点号，0表示全部节点
+     * @returns 发送成功返回true
+     */
+    canopenNmt(channelHandle: ChannelHandle, command: CanOpenNmtCommand, nodeId: number = 0): boolean {
+        return this.device.canopenNmt(channelHandle, command, nodeId);
+    }
+
+    /**
+     * 获取CANopen统计
+     * @param channelHandle 通道句柄
+     * @returns 统计信息，未启动返回null
+     */
+    getCanOpenStats(channelHandle: ChannelHandle): CanOpenStats | null {
+        return this.device.getCanOpenStats(channelHandle);
+    }
+
+    // ==================== E2E保护 ====================
+
+    /**
+     * 设置transmit/transmitFD的E2E保护
+     * 匹配ID的帧在调用驱动前写入计数器、DataID和CRC，每个ID独立计数
+     * @param channelHandle 通道句柄
+     * @param entries 按ID的配置，null或空数组取消保护；重新设置时计数器清零
+     * @returns 成功返回true；配置无效时抛出TypeError
+     */
+    setE2eProtection(channelHandle: ChannelHandle, entries: (E2eConfig & { id: number })[] | null): boolean {
+        return this.device.setE2eProtection(channelHandle, entries);
+    }
+
+    /**
+     * 启动接收E2E检查
+     * 在接收线程中随每批帧检查CRC、DataID和计数器，帧仍照常进入receive()的缓冲
+     * @param channelHandle 通道句柄
+     * @param entries 按ID的配置
+     * @param callback 失败事件批次回调，省略时只累计统计
+     * @param options maxBatch为单批最多事件数，默认256
+     * @returns 成功返回true，已启动返回false；配置无效时抛出TypeError
+     */
+    startE2eCheck(channelHandle: ChannelHandle, entries: (E2eConfig & { id: number })[],
+                  callback?: E2eCallback, options: { maxBatch?: number } = {}): boolean {
+        return this.device.startE2eCheck(channelHandle, entries, callback, options);
+    }
+
+    /**
+     * 停止接收E2E检查
+     * @param channelHandle 通道句柄
+     * @returns 成功返回true，未启动返回false
+     */
+    stopE2eCheck(channelHandle: ChannelHandle): boolean {
+        return this.device.stopE2eCheck(channelHandle);
+    }
+
+    /**
+     * 获取按ID的E2E检查统计
+     * @param channelHandle 通道句柄
+     * @returns 按ID排序的统计，未启动返回null
+     */
+    getE2eStats(channelHandle: ChannelHandle): E2eIdStats[] | null {
+        return this.device.getE2eStats(channelHandle);
+    }
+
+    // ==================== 残余总线仿真 ====================
+
+    /**
+     * 启动残余总线仿真
+     * 报文集在独立线程中按时间轮调度，同一刻度到期的报文写入信号、计数器和校验和后
+     * 以一次ZCAN_TransmitFD（经典帧为一次ZCAN_Transmit）批量发出
+     * @param channelHandle 通道句柄
+     * @param messages 周期报文
+     * @param options 配置
+     * @returns 与引擎共享的信号表，已启动返回null；报文配置无效时抛出TypeError
+     */
+    startRestBus(channelHandle: ChannelHandle, messages: RestBusMessage[], options: RestBusOptions = {}): RestBusSignalTable | null {
+        const result = this.device.startRestBus(channelHandle, messages, options);
+        return result ? new RestBusSignalTable(result.table, result.signals) : null;
+    }
+
+    /**
+     * 停止残余总线仿真，之后信号表的写入不再生效
+     * @param channelHandle 通道句柄
+     * @returns 成功返回true，未启动返回false
+     */
+    stopRestBus(channelHandle: ChannelHandle): boolean {
+        return this.device.stopRestBus(channelHandle);
+    }
+
+    /**
+     * 启用或停用报文，停用期间保持相位，计数器不递增
+     * @param channelHandle 通道句柄
+     * @param name 报文名
+     * @param enabled 是否发送
+     * @returns 报文不存在返回false
+     */
+    restBusSetEnabled(channelHandle: ChannelHandle, name: string, enabled: boolean): boolean {
+        return this.device.restBusSetEnabled(channelHandle, name, enabled);
+    }
+
+    /**
+     * 获取残余总线统计
+     * @param channelHandle 通道句柄
+     * @returns 统计信息，未启动返回null
+     */
+    getRestBusStats(channelHandle: ChannelHandle): RestBusStats | null {
+        return this.device.getRestBusStats(channelHandle);
+    }
+
+    // ==================== LIN通道 ====================
+
+    /**
+     * 初始化LIN通道
+     * @param linIndex LIN通道索引
+     * @param config 通道配置
+     * @returns 通道句柄
+     */
+    initLinChannel(linIndex: number, config: LinChannelConfig = {}): ChannelHandle {
+        return this.device.initLinChannel(linIndex, config);
+    }
+
+    /**
+     * 启动LIN通道
+     * @param channelHandle 通道句柄
+     * @returns 成功返回true，失败返回false
+     */
+    startLinChannel(channelHandle: ChannelHandle): boolean {
+        return this.device.startLinChannel(channelHandle);
+    }
+
+    /**
+     * 复位LIN通道，同时停止其接收线程
+     * @param channelHandle 通道句柄
+     * @returns 成功返回true，失败返回false
+     */
+    resetLinChannel(channelHandle: ChannelHandle): boolean {
+        return this.device.resetLinChannel(channelHandle);
+    }
+
+    /**
+     * 发送LIN帧
+     * @param channelHandle 通道句柄
+     * @param frames 单帧或帧数组
+     * @returns 实际发送的帧数
+     */
+    transmitLin(channelHandle: ChannelHandle, frames: LinFrame | LinFrame[]): number {
+        return this.device.transmitLin(channelHandle, frames);
+    }
+
+    /**
+     * 接收LIN消息
+     * 接收线程运行时从其缓存中取出，否则直接读取驱动缓冲区
+     * @param channelHandle 通道句柄
+     * @param count 最大接收数量
+     * @param waitTime 等待时间（毫秒），-1表示无限等待
+     * @returns 消息数组
+     */
+    receiveLin(channelHandle: ChannelHandle, count: number, waitTime: number = -1): LinMessage[] {
+        return this.device.receiveLin(channelHandle, count, waitTime);
+    }
+
+    /**
+     * 获取LIN通道待接收的消息数
+     * @param channelHandle 通道句柄
+     * @returns 消息数
+     */
+    getLinReceiveNum(channelHandle: ChannelHandle): number {
+        return this.device.getLinReceiveNum(channelHandle);
+    }
+
+    /**
+     * 设置LIN发布（本节点应答的帧数据）
+     * @param channelHandle 通道句柄
+     * @param configs 发布配置
+     * @returns 成功返回true，失败返回false
+     */
+    setLinPublish(channelHandle: ChannelHandle, configs: LinPublishConfig[]): boolean {
+        return this.device.setLinPublish(channelHandle, configs);
+    }
+
+    /**
+     * 设置LIN订阅
+     * @param channelHandle 通道句柄
+     * @param configs 订阅配置
+     * @returns 成功返回true，失败返回false
+     */
+    setLinSubscribe(channelHandle: ChannelHandle, configs: LinSubscribeConfig[]): boolean {
+        return this.device.setLinSubscribe(channelHandle, configs);
+    }
+
+    /**
+     * 发送LIN唤醒信号
+     * @param channelHandle 通道句柄
+     * @returns 成功返回true，失败返回false
+     */
+    wakeUpLin(channelHandle: ChannelHandle): boolean {
+        return this.device.wakeUpLin(channelHandle);
+    }
+
+    /**
+     * 启动LIN通道接收线程
+     * 以blockWaitMs为等待时间阻塞读取驱动（mode不适用）；未提供回调时消息放入缓存由receiveLin取出；提供回调时每轮读取到的消息整批推送到JS，无需轮询，
+     * 待交付的批数上限为ringCapacity/batchSize，超出时丢弃并计入framesDropped
+     * @param channelHandle 通道句柄
+     * @param options 接收线程配置
+     * @param callback 接收回调
+     * @returns 启动返回true，已在运行返回false
+     */
+    startLinReceiveThread(channelHandle: ChannelHandle, options: ReceiveThreadOptions = {}, callback?: LinReceiveCallback): boolean {
+        return this.device.startLinReceiveThread(channelHandle, options, callback);
+    }
+
+    /**
+     * 停止LIN通道接收线程
+     * @param channelHandle 通道句柄
+     * @returns 成功返回true，未运行返回false
+     */
+    stopLinReceiveThread(channelHandle: ChannelHandle): boolean {
+        return this.device.stopLinReceiveThread(channelHandle);
+    }
+
+    /**
+     * 获取LIN接收线程统计
+     * @param channelHandle 通道句柄
+     * @returns 统计信息，接收线程未运行返回null
+     */
+    getLinReceiveThreadStats(channelHandle: ChannelHandle): LinReceiveThreadStats | null {
+        return this.device.getLinReceiveThreadStats(channelHandle);
+    }
+
+    // ==================== LIN调度表 ====================
+
+    /**
+     * 创建调度表并添加到LIN通道（主机模式）
+     * 调度表由设备硬件执行；关闭设备或重新初始化通道时自动销毁
+     * @param channelHandle 通道句柄
+     * @param items 调度表项
+     * @param runCount 运行次数，0表示一直运行
+     * @returns 调度表句柄，失败返回null
+     */
+    addLinSchedule(channelHandle: ChannelHandle, items: LinScheduleItem[], runCount: number = 0): number | null {
+        return this.device.addLinSchedule(channelHandle, items, runCount);
+    }
+
+    /**
+     * 启动LIN通道的调度表
+     * @param channelHandle 通道句柄
+     * @returns 成功返回true，失败返回false
+     */
+    startLinSchedule(channelHandle: ChannelHandle): boolean {
+        return this.device.startLinSchedule(channelHandle);
+    }
+
+    /**
+     * 停止LIN通道的调度表
+     * @param channelHandle 通道句柄
+     * @returns 成功返回true，失败返回false
+     */
+    stopLinSchedule(channelHandle: ChannelHandle): boolean {
+        return this.device.stopLinSchedule(channelHandle);
+    }
+
+    /**
+     * 停止并清空LIN通道的调度表，同时销毁通过addLinSchedule创建的调度表
+     * @param channelHandle 通道句柄
+     * @returns 成功返回true，通道未初始化返回false
+     */
+    clearLinSchedules(channelHandle: ChannelHandle): boolean {
+        return this.device.clearLinSchedules(channelHandle);
+    }
+
+    /**
+     * 设置调度表或调度表项的使能状态
+     * @param channelHandle 通道句柄
+     * @param schedule 调度表句柄
+     * @param enabled 是否使能
+     * @param itemIndex 表项索引，省略时设置整个调度表
+     * @returns 成功返回true，失败返回false
+     */
+    setLinScheduleEnabled(channelHandle: ChannelHandle, schedule: number, enabled: boolean, itemIndex?: number): boolean {
+        return this.device.setLinScheduleEnabled(channelHandle, schedule, enabled, itemIndex);
+    }
+
+    /**
+     * 获取调度表状态
+     * @param channelHandle 通道句柄
+     * @param schedule 调度表句柄
+     * @returns 见LinScheduleStatus，失败返回null
+     */
+    getLinScheduleStatus(channelHandle: ChannelHandle, schedule: number): number | null {
+        return this.device.getLinScheduleStatus(channelHandle, schedule);
+    }
 }
 
 // ============== 辅助函数 ==============
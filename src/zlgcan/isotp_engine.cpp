@@ -0,0 +1,654 @@
+#include "isotp_engine.h"
+#include "zlgcan_api.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+// 协议控制信息(PCI)类型
+constexpr BYTE PCI_SF = 0x0;
+constexpr BYTE PCI_FF = 0x1;
+constexpr BYTE PCI_CF = 0x2;
+constexpr BYTE PCI_FC = 0x3;
+
+// 流控状态
+constexpr BYTE FC_CTS = 0x0;
+constexpr BYTE FC_WAIT = 0x1;
+constexpr BYTE FC_OVFLW = 0x2;
+
+constexpr UINT ISOTP_FF_DL_12BIT_MAX = 4095;
+
+// 短于此时间的STmin间隔改为自旋等待，sleep_for在Windows上的精度约为1ms
+constexpr uint64_t SPIN_THRESHOLD_US = 2000;
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t ElapsedUs(Clock::time_point from, Clock::time_point to) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+}
+
+double BytesPerSec(uint64_t bytes, uint64_t us) {
+    return us > 0 ? static_cast<double>(bytes) * 1000000.0 / static_cast<double>(us) : 0;
+}
+
+// CANFD帧长度向上取整到DLC可表示的长度
+BYTE FdFrameLength(UINT len) {
+    static const BYTE lengths[] = {8, 12, 16, 20, 24, 32, 48, 64};
+    if (len <= 8) {
+        return static_cast<BYTE>(len);
+    }
+    for (BYTE l : lengths) {
+        if (len <= l) {
+            return l;
+        }
+    }
+    return CANFD_MAX_DLEN;
+}
+
+// 去掉RTR/ERR位，保留扩展帧标志和ID
+UINT NormalizeId(UINT id) {
+    return id & (CAN_EFF_FLAG | CAN_EFF_MASK);
+}
+
+void WaitUntil(Clock::time_point deadline) {
+    auto now = Clock::now();
+    if (now >= deadline) {
+        return;
+    }
+    if (ElapsedUs(now, deadline) > SPIN_THRESHOLD_US) {
+        std::this_thread::sleep_until(deadline - std::chrono::microseconds(SPIN_THRESHOLD_US / 2));
+    }
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+}  // namespace
+
+struct IsoTpEngine::Session {
+    UINT id = 0;
+    IsoTpOptions options;
+    EventCallback callback;
+
+    // 同一会话的发送串行执行
+    std::mutex sendMutex;
+    std::atomic<int> stMinOverrideUs{-1};
+
+    // 发送方等待的流控帧
+    std::mutex fcMutex;
+    std::condition_variable fcCv;
+    bool fcWaiting = false;
+    bool fcReceived = false;
+    Clock::time_point fcArmedAt;
+    BYTE fcStatus = FC_CTS;
+    BYTE fcBlockSize = 0;
+    BYTE fcStMin = 0;
+    Clock::time_point fcReceivedAt;
+    bool closed = false;
+
+    // 接收状态，由引擎互斥锁保护
+    bool rxActive = false;
+    std::vector<BYTE> rxBuffer;
+    uint64_t rxExpected = 0;
+    BYTE rxSequence = 0;
+    UINT rxBlockCount = 0;
+    Clock::time_point rxStartedAt;
+    Clock::time_point rxLastFrameAt;
+
+    mutable std::mutex statsMutex;
+    IsoTpStats stats;
+};
+
+IsoTpEngine::IsoTpEngine(CHANNEL_HANDLE channelHandle) : channelHandle_(channelHandle) {
+}
+
+IsoTpEngine::~IsoTpEngine() {
+    RemoveAllSessions();
+}
+
+uint64_t IsoTpEngine::DecodeStMinUs(BYTE stMin) {
+    if (stMin <= 0x7F) {
+        return static_cast<uint64_t>(stMin) * 1000;
+    }
+    if (stMin >= 0xF1 && stMin <= 0xF9) {
+        return static_cast<uint64_t>(stMin - 0xF0) * 100;
+    }
+    // 保留值按最大值处理（ISO 15765-2 9.6.5.4）
+    return 127000;
+}
+
+BYTE IsoTpEngine::EncodeStMin(UINT stMinUs) {
+    if (stMinUs == 0) {
+        return 0;
+    }
+    if (stMinUs < 1000) {
+        return static_cast<BYTE>(0xF0 + std::max<UINT>(stMinUs / 100, 1));
+    }
+    return static_cast<BYTE>(std::min<UINT>(stMinUs / 1000, 0x7F));
+}
+
+bool IsoTpEngine::AddSession(UINT sessionId, const IsoTpOptions& options, EventCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const UINT rxKey = NormalizeId(options.rxId);
+    if (sessions_.count(sessionId) || sessionsByRxId_.count(rxKey)) {
+        return false;
+    }
+
+    auto session = std::make_shared<Session>();
+    session->id = sessionId;
+    session->options = options;
+    if (!options.fd || session->options.txDataLength < 8) {
+        session->options.txDataLength = 8;
+    }
+    session->options.txDataLength = FdFrameLength(session->options.txDataLength);
+    session->stMinOverrideUs.store(options.stMinOverrideUs);
+    session->callback = std::move(callback);
+
+    sessions_[sessionId] = session;
+    sessionsByRxId_[rxKey] = session;
+    return true;
+}
+
+bool IsoTpEngine::RemoveSession(UINT sessionId) {
+    std::shared_ptr<Session> session;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sessions_.find(sessionId);
+        if (it == sessions_.end()) {
+            return false;
+        }
+        session = it->second;
+        sessions_.erase(it);
+        sessionsByRxId_.erase(NormalizeId(session->options.rxId));
+    }
+    {
+        std::lock_guard<std::mutex> lock(session->fcMutex);
+        session->closed = true;
+    }
+    session->fcCv.notify_all();
+    return true;
+}
+
+void IsoTpEngine::RemoveAllSessions() {
+    std::map<UINT, std::shared_ptr<Session>> sessions;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessions.swap(sessions_);
+        sessionsByRxId_.clear();
+    }
+    for (auto& entry : sessions) {
+        {
+            std::lock_guard<std::mutex> lock(entry.second->fcMutex);
+            entry.second->closed = true;
+        }
+        entry.second->fcCv.notify_all();
+    }
+}
+
+bool IsoTpEngine::HasSession(UINT sessionId) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sessions_.count(sessionId) > 0;
+}
+
+size_t IsoTpEngine::SessionCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sessions_.size();
+}
+
+std::shared_ptr<IsoTpEngine::Session> IsoTpEngine::FindSession(UINT sessionId) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(sessionId);
+    return it == sessions_.end() ? nullptr : it->second;
+}
+
+bool IsoTpEngine::GetStats(UINT sessionId, IsoTpStats* stats) const {
+    auto session = FindSession(sessionId);
+    if (!session) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(session->statsMutex);
+    *stats = session->stats;
+    return true;
+}
+
+bool IsoTpEngine::SetStMinOverride(UINT sessionId, int stMinUs) {
+    auto session = FindSession(sessionId);
+    if (!session) {
+        return false;
+    }
+    session->stMinOverrideUs.store(stMinUs);
+    return true;
+}
+
+bool IsoTpEngine::TransmitFrame(const Session& session, const BYTE* data, UINT len) {
+    const IsoTpOptions& options = session.options;
+    const CHANNEL_HANDLE handle = channelHandle_.load();
+    const BYTE filler = options.padding >= 0 ? static_cast<BYTE>(options.padding) : 0;
+
+    if (options.fd) {
+        ZCAN_TransmitFD_Data frame;
+        memset(&frame, 0, sizeof(frame));
+        frame.frame.can_id = options.txId;
+        BYTE frameLen = FdFrameLength(len);
+        if (options.padding >= 0 && frameLen < 8) {
+            frameLen = 8;
+        }
+        frame.frame.len = frameLen;
+        frame.frame.flags = options.brs ? CANFD_BRS : 0;
+        memcpy(frame.frame.data, data, len);
+        memset(frame.frame.data + len, filler, frameLen - len);
+        return ZcanTransmitFD(handle, &frame, 1) == 1;
+    }
+
+    ZCAN_Transmit_Data frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.frame.can_id = options.txId;
+    const BYTE frameLen = options.padding >= 0 ? CAN_MAX_DLEN : static_cast<BYTE>(len);
+    frame.frame.can_dlc = frameLen;
+    memcpy(frame.frame.data, data, len);
+    memset(frame.frame.data + len, filler, frameLen - len);
+    return ZcanTransmit(handle, &frame, 1) == 1;
+}
+
+IsoTpSendResult IsoTpEngine::Send(UINT sessionId, const std::vector<BYTE>& payload) {
+    IsoTpSendResult result;
+    auto session = FindSession(sessionId);
+    if (!session) {
+        result.error = "session not found";
+        return result;
+    }
+
+    std::lock_guard<std::mutex> sendLock(session->sendMutex);
+    const IsoTpOptions& options = session->options;
+    const UINT frameLen = options.txDataLength;
+    const auto startedAt = Clock::now();
+
+    auto finish = [&](const char* error) {
+        result.success = error == nullptr;
+        if (error) {
+            result.error = error;
+        }
+        result.durationUs = ElapsedUs(startedAt, Clock::now());
+
+        std::lock_guard<std::mutex> lock(session->statsMutex);
+        IsoTpStats& stats = session->stats;
+        if (result.success) {
+            stats.txMessages++;
+            stats.txBytes += payload.size();
+            stats.lastTxUs = result.durationUs;
+            stats.lastTxBytesPerSec = BytesPerSec(payload.size(), result.durationUs);
+            stats.lastFcWaitUs = result.fcWaitUs;
+        } else {
+            stats.txErrors++;
+        }
+        return result;
+    };
+
+    if (payload.empty() || payload.size() > 0xFFFFFFFFull) {
+        return finish("invalid payload length");
+    }
+
+    BYTE buf[CANFD_MAX_DLEN];
+
+    // 单帧
+    if (payload.size() <= 7 || payload.size() <= frameLen - 2) {
+        UINT offset;
+        if (payload.size() <= 7) {
+            buf[0] = static_cast<BYTE>((PCI_SF << 4) | payload.size());
+            offset = 1;
+        } else {
+            buf[0] = PCI_SF << 4;
+            buf[1] = static_cast<BYTE>(payload.size());
+            offset = 2;
+        }
+        memcpy(buf + offset, payload.data(), payload.size());
+        if (!TransmitFrame(*session, buf, offset + static_cast<UINT>(payload.size()))) {
+            return finish("transmit failed");
+        }
+        result.frames = 1;
+        return finish(nullptr);
+    }
+
+    // 多帧：首帧
+    UINT offset;
+    if (payload.size() <= ISOTP_FF_DL_12BIT_MAX) {
+        buf[0] = static_cast<BYTE>((PCI_FF << 4) | ((payload.size() >> 8) & 0x0F));
+        buf[1] = static_cast<BYTE>(payload.size() & 0xFF);
+        offset = 2;
+    } else {
+        const uint32_t len = static_cast<uint32_t>(payload.size());
+        buf[0] = PCI_FF << 4;
+        buf[1] = 0;
+        buf[2] = static_cast<BYTE>(len >> 24);
+        buf[3] = static_cast<BYTE>(len >> 16);
+        buf[4] = static_cast<BYTE>(len >> 8);
+        buf[5] = static_cast<BYTE>(len);
+        offset = 6;
+    }
+    size_t sent = frameLen - offset;
+    memcpy(buf + offset, payload.data(), sent);
+
+    // 在发出首帧/块末帧之前准备接收流控，避免对端应答过快时丢失
+    auto armFlowControl = [&session]() {
+        std::lock_guard<std::mutex> lock(session->fcMutex);
+        session->fcWaiting = true;
+        session->fcReceived = false;
+        session->fcArmedAt = Clock::now();
+    };
+
+    armFlowControl();
+    if (!TransmitFrame(*session, buf, frameLen)) {
+        return finish("transmit failed");
+    }
+    result.frames = 1;
+
+    BYTE sequence = 1;
+    UINT waitFrames = 0;
+    while (sent < payload.size()) {
+        // 等待流控
+        BYTE fcStatus;
+        BYTE blockSize;
+        uint64_t stMinUs;
+        {
+            // N_Bs从准备接收流控（或收到上一个FC.WAIT）时起算
+            std::unique_lock<std::mutex> lock(session->fcMutex);
+            const bool got = session->fcCv.wait_until(lock,
+                session->fcArmedAt + std::chrono::milliseconds(options.nBsTimeoutMs),
+                [&session] { return session->fcReceived || session->closed; });
+            if (session->closed) {
+                session->fcWaiting = false;
+                return finish("session closed");
+            }
+            if (!got) {
+                session->fcWaiting = false;
+                return finish("N_Bs timeout");
+            }
+            result.fcWaitUs += ElapsedUs(session->fcArmedAt, session->fcReceivedAt);
+            fcStatus = session->fcStatus;
+            blockSize = session->fcBlockSize;
+            stMinUs = DecodeStMinUs(session->fcStMin);
+            session->fcReceived = false;
+            if (fcStatus == FC_WAIT) {
+                // 接收线程收到FC.WAIT时保持等待状态，这里在同一临界区内重新起算N_Bs，
+                // 紧随其后的流控帧不会落在两次加锁之间而丢失
+                session->fcArmedAt = session->fcReceivedAt;
+            } else {
+                session->fcWaiting = false;
+            }
+        }
+        result.remoteBlockSize = blockSize;
+        result.remoteStMinUs = stMinUs;
+        // 覆盖值只能放慢发送：ISO 15765-2要求连续帧间隔不小于接收方流控中的STmin
+        const int overrideUs = session->stMinOverrideUs.load();
+        if (overrideUs >= 0) {
+            stMinUs = std::max(stMinUs, static_cast<uint64_t>(overrideUs));
+        }
+
+        if (fcStatus == FC_WAIT) {
+            if (++waitFrames > options.maxWaitFrames) {
+                std::lock_guard<std::mutex> lock(session->fcMutex);
+                session->fcWaiting = false;
+                return finish("too many FC.WAIT");
+            }
+            continue;
+        }
+        if (fcStatus == FC_OVFLW) {
+            return finish("receiver overflow");
+        }
+        if (fcStatus != FC_CTS) {
+            return finish("invalid flow status");
+        }
+        waitFrames = 0;
+
+        // 连续帧
+        UINT blockCount = 0;
+        Clock::time_point nextSendAt = Clock::now();
+        while (sent < payload.size()) {
+            const size_t chunk = std::min<size_t>(frameLen - 1, payload.size() - sent);
+            const bool lastInBlock = blockSize > 0 && blockCount + 1 == blockSize;
+            const bool lastFrame = sent + chunk >= payload.size();
+            buf[0] = static_cast<BYTE>((PCI_CF << 4) | sequence);
+            memcpy(buf + 1, payload.data() + sent, chunk);
+
+            WaitUntil(nextSendAt);
+            if (lastInBlock && !lastFrame) {
+                armFlowControl();
+            }
+            {
+                std::lock_guard<std::mutex> lock(session->fcMutex);
+                if (session->closed) {
+                    return finish("session closed");
+                }
+            }
+            if (!TransmitFrame(*session, buf, static_cast<UINT>(1 + chunk))) {
+                return finish("transmit failed");
+            }
+            nextSendAt = Clock::now() + std::chrono::microseconds(stMinUs);
+
+            result.frames++;
+            sent += chunk;
+            sequence = (sequence + 1) & 0x0F;
+            if (lastInBlock) {
+                break;
+            }
+            blockCount++;
+        }
+    }
+
+    return finish(nullptr);
+}
+
+void IsoTpEngine::SendFlowControl(Session& session, BYTE status) {
+    BYTE buf[3];
+    buf[0] = static_cast<BYTE>((PCI_FC << 4) | status);
+    buf[1] = session.options.blockSize;
+    buf[2] = EncodeStMin(session.options.stMinUs);
+    TransmitFrame(session, buf, sizeof(buf));
+}
+
+bool IsoTpEngine::OnFrame(const ZCAN_ReceiveFD_Data& frame, bool fd) {
+    // 本端发送的回显帧和远程帧不属于传输层
+    if ((frame.frame.flags & TX_ECHO_FLAG) || (frame.frame.can_id & (CAN_RTR_FLAG | CAN_ERR_FLAG))) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessionsByRxId_.find(NormalizeId(frame.frame.can_id));
+    if (it == sessionsByRxId_.end()) {
+        return false;
+    }
+    Session& session = *it->second;
+
+    const BYTE* data = frame.frame.data;
+    const UINT len = frame.frame.len;
+    if (len == 0) {
+        return true;
+    }
+
+    switch (data[0] >> 4) {
+        case PCI_SF: {
+            UINT dl = data[0] & 0x0F;
+            UINT offset = 1;
+            if (dl == 0 && fd && len > CAN_MAX_DLEN) {
+                dl = data[1];
+                offset = 2;
+            }
+            if (dl == 0 || offset + dl > len) {
+                break;
+            }
+            if (session.rxActive) {
+                FailReceive(session, "unexpected single frame");
+            }
+            session.rxBuffer.assign(data + offset, data + offset + dl);
+            session.rxStartedAt = Clock::now();
+            CompleteReceive(session, frame.timestamp);
+            break;
+        }
+        case PCI_FF: {
+            if (len < 2) {
+                break;
+            }
+            uint64_t dl = (static_cast<uint64_t>(data[0] & 0x0F) << 8) | data[1];
+            UINT offset = 2;
+            if (dl == 0) {
+                if (len < 6) {
+                    break;
+                }
+                dl = (static_cast<uint64_t>(data[2]) << 24) | (static_cast<uint64_t>(data[3]) << 16) |
+                     (static_cast<uint64_t>(data[4]) << 8) | data[5];
+                offset = 6;
+            }
+            if (session.rxActive) {
+                FailReceive(session, "unexpected first frame");
+            }
+            HandleFirstFrame(session, frame, offset, dl);
+            break;
+        }
+        case PCI_CF:
+            HandleConsecutiveFrame(session, frame);
+            break;
+        case PCI_FC:
+            HandleFlowControl(session, frame);
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+void IsoTpEngine::HandleFirstFrame(Session& session, const ZCAN_ReceiveFD_Data& frame,
+                                   UINT payloadOffset, uint64_t length) {
+    const auto receivedAt = Clock::now();
+    if (length > session.options.maxMessageLength) {
+        SendFlowControl(session, FC_OVFLW);
+        std::lock_guard<std::mutex> lock(session.statsMutex);
+        session.stats.rxErrors++;
+        return;
+    }
+
+    const UINT len = frame.frame.len;
+    const size_t chunk = std::min<size_t>(len - payloadOffset, static_cast<size_t>(length));
+    session.rxActive = true;
+    session.rxExpected = length;
+    session.rxBuffer.clear();
+    session.rxBuffer.reserve(static_cast<size_t>(length));
+    session.rxBuffer.insert(session.rxBuffer.end(), frame.frame.data + payloadOffset,
+                            frame.frame.data + payloadOffset + chunk);
+    session.rxSequence = 1;
+    session.rxBlockCount = 0;
+    session.rxStartedAt = receivedAt;
+    session.rxLastFrameAt = receivedAt;
+
+    SendFlowControl(session, FC_CTS);
+
+    const uint64_t responseUs = ElapsedUs(receivedAt, Clock::now());
+    std::lock_guard<std::mutex> lock(session.statsMutex);
+    session.stats.lastFcResponseUs = responseUs;
+    session.stats.maxFcResponseUs = std::max(session.stats.maxFcResponseUs, responseUs);
+}
+
+void IsoTpEngine::HandleConsecutiveFrame(Session& session, const ZCAN_ReceiveFD_Data& frame) {
+    if (!session.rxActive) {
+        return;
+    }
+    const auto receivedAt = Clock::now();
+    if ((frame.frame.data[0] & 0x0F) != session.rxSequence) {
+        FailReceive(session, "wrong sequence number");
+        return;
+    }
+
+    const size_t remaining = static_cast<size_t>(session.rxExpected - session.rxBuffer.size());
+    const size_t chunk = std::min<size_t>(frame.frame.len - 1, remaining);
+    session.rxBuffer.insert(session.rxBuffer.end(), frame.frame.data + 1, frame.frame.data + 1 + chunk);
+    session.rxSequence = (session.rxSequence + 1) & 0x0F;
+    session.rxLastFrameAt = receivedAt;
+
+    if (session.rxBuffer.size() >= session.rxExpected) {
+        CompleteReceive(session, frame.timestamp);
+        return;
+    }
+
+    if (session.options.blockSize > 0 && ++session.rxBlockCount >= session.options.blockSize) {
+        session.rxBlockCount = 0;
+        SendFlowControl(session, FC_CTS);
+
+        const uint64_t responseUs = ElapsedUs(receivedAt, Clock::now());
+        std::lock_guard<std::mutex> lock(session.statsMutex);
+        session.stats.lastFcResponseUs = responseUs;
+        session.stats.maxFcResponseUs = std::max(session.stats.maxFcResponseUs, responseUs);
+    }
+}
+
+void IsoTpEngine::HandleFlowControl(Session& session, const ZCAN_ReceiveFD_Data& frame) {
+    if (frame.frame.len < 3) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(session.fcMutex);
+        if (!session.fcWaiting) {
+            return;
+        }
+        session.fcReceived = true;
+        session.fcStatus = frame.frame.data[0] & 0x0F;
+        // FC.WAIT之后对方还会再发流控，继续等待；发送方取走WAIT时在同一锁内重新起算N_Bs
+        session.fcWaiting = session.fcStatus == FC_WAIT;
+        session.fcBlockSize = frame.frame.data[1];
+        session.fcStMin = frame.frame.data[2];
+        session.fcReceivedAt = Clock::now();
+    }
+    session.fcCv.notify_all();
+}
+
+void IsoTpEngine::CompleteReceive(Session& session, uint64_t timestamp) {
+    IsoTpEvent event;
+    event.type = IsoTpEvent::Type::Message;
+    event.sessionId = session.id;
+    event.data.swap(session.rxBuffer);
+    event.timestamp = timestamp;
+    event.durationUs = ElapsedUs(session.rxStartedAt, Clock::now());
+    session.rxActive = false;
+
+    {
+        std::lock_guard<std::mutex> lock(session.statsMutex);
+        IsoTpStats& stats = session.stats;
+        stats.rxMessages++;
+        stats.rxBytes += event.data.size();
+        stats.lastRxUs = event.durationUs;
+        stats.lastRxBytesPerSec = BytesPerSec(event.data.size(), event.durationUs);
+    }
+
+    if (session.callback) {
+        session.callback(event);
+    }
+}
+
+void IsoTpEngine::FailReceive(Session& session, const std::string& error) {
+    session.rxActive = false;
+    session.rxBuffer.clear();
+    {
+        std::lock_guard<std::mutex> lock(session.statsMutex);
+        session.stats.rxErrors++;
+    }
+
+    IsoTpEvent event;
+    event.type = IsoTpEvent::Type::Error;
+    event.sessionId = session.id;
+    event.durationUs = ElapsedUs(session.rxStartedAt, Clock::now());
+    event.error = error;
+    if (session.callback) {
+        session.callback(event);
+    }
+}
+
+void IsoTpEngine::OnTick(std::chrono::steady_clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : sessions_) {
+        Session& session = *entry.second;
+        if (session.rxActive &&
+            now - session.rxLastFrameAt > std::chrono::milliseconds(session.options.nCrTimeoutMs)) {
+            FailReceive(session, "N_Cr timeout");
+        }
+    }
+}
@@ -0,0 +1,132 @@
+#ifndef ZLGCAN_ISOTP_ENGINE_H_
+#define ZLGCAN_ISOTP_ENGINE_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "zlgcan.h"
+#include "receive_pump.h"
+
+// ISO-TP会话配置（正常寻址）
+struct IsoTpOptions {
+    UINT txId = 0;                     // 发送ID，扩展帧须包含CAN_EFF_FLAG
+    UINT rxId = 0;                     // 接收ID，扩展帧须包含CAN_EFF_FLAG
+    bool fd = false;                   // 使用CANFD帧
+    bool brs = false;                  // CANFD加速
+    BYTE txDataLength = 8;             // 发送帧最大数据长度，CAN为8，CANFD为8~64
+    int padding = 0xCC;                // 填充字节，小于0表示不填充（CANFD长度不在DLC表上时仍以0填充）
+    BYTE blockSize = 0;                // 本端流控的块大小，0表示不限
+    UINT stMinUs = 0;                  // 本端流控的STmin(us)，100~900us或整毫秒
+    int stMinOverrideUs = -1;          // 发送连续帧的间隔(us)，不小于对方流控中的STmin；小于0时使用流控值
+    UINT nBsTimeoutMs = 1000;          // 等待流控帧超时
+    UINT nCrTimeoutMs = 1000;          // 等待连续帧超时
+    UINT maxWaitFrames = 10;           // 允许连续收到的FC.WAIT数
+    UINT maxMessageLength = 4095;      // 接收消息长度上限，超过时回复FC.OVFLW
+};
+
+// ISO-TP会话统计
+struct IsoTpStats {
+    uint64_t txMessages = 0;
+    uint64_t rxMessages = 0;
+    uint64_t txBytes = 0;
+    uint64_t rxBytes = 0;
+    uint64_t txErrors = 0;
+    uint64_t rxErrors = 0;
+    uint64_t lastTxUs = 0;             // 最近一次发送耗时
+    uint64_t lastRxUs = 0;             // 最近一次接收耗时（首帧到最后一帧）
+    double lastTxBytesPerSec = 0;
+    double lastRxBytesPerSec = 0;
+    uint64_t lastFcResponseUs = 0;     // 收到首帧/块末帧到发出流控的耗时
+    uint64_t maxFcResponseUs = 0;
+    uint64_t lastFcWaitUs = 0;         // 发出首帧到收到流控的耗时
+};
+
+// ISO-TP事件（接收完成或接收错误）
+struct IsoTpEvent {
+    enum class Type : uint8_t { Message, Error };
+
+    Type type = Type::Message;
+    UINT sessionId = 0;
+    std::vector<BYTE> data;
+    uint64_t timestamp = 0;            // 最后一帧的设备时间戳(us)
+    uint64_t durationUs = 0;
+    std::string error;
+};
+
+// 发送结果
+struct IsoTpSendResult {
+    bool success = false;
+    std::string error;
+    UINT frames = 0;
+    uint64_t durationUs = 0;
+    uint64_t fcWaitUs = 0;             // 等待流控的累计时间
+    BYTE remoteBlockSize = 0;          // 对方最近一次流控中的BS
+    uint64_t remoteStMinUs = 0;        // 对方最近一次流控中的STmin
+};
+
+/**
+ * ISO 15765-2 传输层引擎
+ * 作为接收线程的监听者运行：首帧和块末连续帧的流控在接收线程中立即回复，
+ * 收到的流控帧唤醒发送线程。同一通道可有多个会话，按接收ID区分。
+ * Send为阻塞调用，应在工作线程中执行。
+ */
+class IsoTpEngine : public FrameListener {
+public:
+    using EventCallback = std::function<void(const IsoTpEvent&)>;
+
+    explicit IsoTpEngine(CHANNEL_HANDLE channelHandle);
+    ~IsoTpEngine() override;
+
+    IsoTpEngine(const IsoTpEngine&) = delete;
+    IsoTpEngine& operator=(const IsoTpEngine&) = delete;
+
+    // 接收ID已被其他会话使用时返回false
+    bool AddSession(UINT sessionId, const IsoTpOptions& options, EventCallback callback);
+    // 返回后不会再有该会话的回调；发送中的请求以错误结束
+    bool RemoveSession(UINT sessionId);
+    void RemoveAllSessions();
+    bool HasSession(UINT sessionId) const;
+    size_t SessionCount() const;
+
+    IsoTpSendResult Send(UINT sessionId, const std::vector<BYTE>& payload);
+    bool GetStats(UINT sessionId, IsoTpStats* stats) const;
+    bool SetStMinOverride(UINT sessionId, int stMinUs);
+
+    void SetChannelHandle(CHANNEL_HANDLE channelHandle) { channelHandle_.store(channelHandle); }
+
+    bool OnFrame(const ZCAN_ReceiveFD_Data& frame, bool fd) override;
+    void OnTick(std::chrono::steady_clock::time_point now) override;
+
+    // STmin编解码
+    static uint64_t DecodeStMinUs(BYTE stMin);
+    static BYTE EncodeStMin(UINT stMinUs);
+
+private:
+    struct Session;
+
+    bool TransmitFrame(const Session& session, const BYTE* data, UINT len);
+    void SendFlowControl(Session& session, BYTE status);
+    void HandleFirstFrame(Session& session, const ZCAN_ReceiveFD_Data& frame, UINT payloadOffset, uint64_t length);
+    void HandleConsecutiveFrame(Session& session, const ZCAN_ReceiveFD_Data& frame);
+    void HandleFlowControl(Session& session, const ZCAN_ReceiveFD_Data& frame);
+    void CompleteReceive(Session& session, uint64_t timestamp);
+    void FailReceive(Session& session, const std::string& error);
+    std::shared_ptr<Session> FindSession(UINT sessionId) const;
+
+    std::atomic<CHANNEL_HANDLE> channelHandle_;
+
+    // 会话表；接收线程处理帧和回调期间持有
+    mutable std::mutex mutex_;
+    std::map<UINT, std::shared_ptr<Session>> sessions_;
+    std::map<UINT, std::shared_ptr<Session>> sessionsByRxId_;
+};
+
+#endif  // ZLGCAN_ISOTP_ENGINE_H_
@@ -0,0 +1,582 @@
+#include "j1939_engine.h"
+#include "zlgcan_api.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// 传输协议PGN
+constexpr uint32_t PGN_TP_CM = 0x00EC00;   // 连接管理
+constexpr uint32_t PGN_TP_DT = 0x00EB00;   // 数据传输
+
+// 连接管理控制字节
+constexpr BYTE CM_RTS = 0x10;
+constexpr BYTE CM_CTS = 0x11;
+constexpr BYTE CM_END_OF_MSG_ACK = 0x13;
+constexpr BYTE CM_BAM = 0x20;
+constexpr BYTE CM_ABORT = 0xFF;
+
+// Abort原因
+constexpr BYTE ABORT_TIMEOUT = 3;
+constexpr BYTE ABORT_BAD_SEQUENCE = 7;
+constexpr BYTE ABORT_MESSAGE_TOO_LARGE = 9;
+
+constexpr BYTE GLOBAL_ADDRESS = 0xFF;
+constexpr BYTE TP_PRIORITY = 7;
+constexpr UINT TP_MIN_SIZE = 9;
+constexpr UINT TP_MAX_SIZE = 1785;         // 255包 x 7字节
+constexpr UINT TP_PACKET_SIZE = 7;
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t ElapsedUs(Clock::time_point from, Clock::time_point to) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+}
+
+uint16_t SessionKey(BYTE sa, BYTE da) {
+    return static_cast<uint16_t>((sa << 8) | da);
+}
+
+uint32_t DecodePgn(const BYTE* data) {
+    return data[0] | (static_cast<uint32_t>(data[1]) << 8) | (static_cast<uint32_t>(data[2]) << 16);
+}
+
+void EncodePgn(uint32_t pgn, BYTE* data) {
+    data[0] = static_cast<BYTE>(pgn);
+    data[1] = static_cast<BYTE>(pgn >> 8);
+    data[2] = static_cast<BYTE>(pgn >> 16);
+}
+
+UINT PacketCount(UINT size) {
+    return (size + TP_PACKET_SIZE - 1) / TP_PACKET_SIZE;
+}
+
+}  // namespace
+
+struct J1939Engine::RxSession {
+    J1939Message::Transport transport = J1939Message::Transport::Bam;
+    BYTE sa = 0;
+    BYTE da = GLOBAL_ADDRESS;
+    BYTE priority = 0;
+    uint32_t pgn = 0;
+    UINT size = 0;
+    UINT packets = 0;
+    bool owned = false;                // 本节点为接收方，负责应答CTS
+    BYTE maxPerCts = 0xFF;             // RTS中发送方一次可发送的包数
+    UINT nextSeq = 1;                  // 期望的下一个包序号
+    UINT windowEnd = 0;                // 当前CTS窗口的最后一个包序号
+    std::vector<BYTE> data;
+    Clock::time_point startedAt;
+    Clock::time_point deadline;
+};
+
+struct J1939Engine::TxSession {
+    enum class Signal : uint8_t { None, Cts, EndOfMsgAck, Abort };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    Signal signal = Signal::None;
+    BYTE ctsPackets = 0;
+    BYTE ctsNext = 0;
+    BYTE abortReason = 0;
+    bool closed = false;
+};
+
+J1939Engine::J1939Engine(CHANNEL_HANDLE channelHandle, const J1939Options& options, BatchCallback callback)
+    : channelHandle_(channelHandle), options_(options), callback_(std::move(callback)) {
+}
+
+J1939Engine::~J1939Engine() {
+    Close();
+}
+
+uint32_t J1939Engine::IdToPgn(UINT canId) {
+    const UINT id = canId & CAN_EFF_MASK;
+    const UINT pf = (id >> 16) & 0xFF;
+    const UINT dp = (id >> 24) & 0x03;  // EDP和DP
+    return (dp << 16) | (pf << 8) | (pf >= 240 ? (id >> 8) & 0xFF : 0);
+}
+
+UINT J1939Engine::MakeId(uint32_t pgn, BYTE priority, BYTE sa, BYTE da) {
+    const UINT pf = (pgn >> 8) & 0xFF;
+    const UINT ps = pf < 240 ? da : (pgn & 0xFF);
+    return CAN_EFF_FLAG | (static_cast<UINT>(priority & 0x07) << 26) | (((pgn >> 16) & 0x03) << 24) |
+        (pf << 16) | (ps << 8) | sa;
+}
+
+bool J1939Engine::IsLocalAddress(BYTE address) const {
+    return std::find(options_.addresses.begin(), options_.addresses.end(), address) != options_.addresses.end();
+}
+
+void J1939Engine::Close() {
+    std::lock_guard<std::mutex> lock(txMutex_);
+    closed_ = true;
+    for (auto& entry : txSessions_) {
+        {
+            std::lock_guard<std::mutex> sessionLock(entry.second->mutex);
+            entry.second->closed = true;
+        }
+        entry.second->cv.notify_all();
+    }
+    closeCv_.notify_all();
+}
+
+J1939Stats J1939Engine::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    J1939Stats stats = stats_;
+    stats.activeSessions = sessions_.size();
+    return stats;
+}
+
+bool J1939Engine::TransmitFrame(UINT canId, const BYTE* data, UINT len) {
+    ZCAN_Transmit_Data frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.frame.can_id = canId;
+    frame.frame.can_dlc = static_cast<BYTE>(len);
+    memcpy(frame.frame.data, data, len);
+    return ZcanTransmit(channelHandle_.load(), &frame, 1) == 1;
+}
+
+void J1939Engine::SendConnectionManagement(BYTE sa, BYTE da, const BYTE payload[8]) {
+    TransmitFrame(MakeId(PGN_TP_CM, TP_PRIORITY, sa, da), payload, 8);
+}
+
+void J1939Engine::SendCts(RxSession& session) {
+    const UINT remaining = session.packets - session.nextSeq + 1;
+    const UINT count = std::min<UINT>({remaining, std::max<UINT>(options_.maxPacketsPerCts, 1),
+                                       std::max<UINT>(session.maxPerCts, 1)});
+    BYTE payload[8] = {CM_CTS, static_cast<BYTE>(count), static_cast<BYTE>(session.nextSeq), 0xFF, 0xFF};
+    EncodePgn(session.pgn, payload + 5);
+    SendConnectionManagement(session.da, session.sa, payload);
+
+    session.windowEnd = session.nextSeq + count - 1;
+    session.deadline = Clock::now() + std::chrono::milliseconds(options_.t2Ms);
+    stats_.ctsSent++;
+}
+
+void J1939Engine::SendEndOfMsgAck(const RxSession& session) {
+    BYTE payload[8] = {CM_END_OF_MSG_ACK, static_cast<BYTE>(session.size), static_cast<BYTE>(session.size >> 8),
+                       static_cast<BYTE>(session.packets), 0xFF};
+    EncodePgn(session.pgn, payload + 5);
+    SendConnectionManagement(session.da, session.sa, payload);
+}
+
+void J1939Engine::SendAbort(BYTE sa, BYTE da, uint32_t pgn, BYTE reason) {
+    BYTE payload[8] = {CM_ABORT, reason, 0xFF, 0xFF, 0xFF};
+    EncodePgn(pgn, payload + 5);
+    SendConnectionManagement(sa, da, payload);
+}
+
+std::shared_ptr<J1939Engine::TxSession> J1939Engine::FindTxSession(BYTE sa, BYTE da) {
+    std::lock_guard<std::mutex> lock(txMutex_);
+    auto it = txSessions_.find(SessionKey(sa, da));
+    return it == txSessions_.end() ? nullptr : it->second;
+}
+
+bool J1939Engine::OnFrame(const ZCAN_ReceiveFD_Data& frame, bool fd) {
+    // J1939只使用扩展帧；本端发送的回显帧不参与重组
+    const UINT canId = frame.frame.can_id;
+    if ((frame.frame.flags & TX_ECHO_FLAG) || !(canId & CAN_EFF_FLAG) || (canId & (CAN_RTR_FLAG | CAN_ERR_FLAG))) {
+        return false;
+    }
+
+    const uint32_t pgn = IdToPgn(canId);
+    const BYTE ps = static_cast<BYTE>(canId >> 8);
+    const BYTE sa = static_cast<BYTE>(canId);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if ((pgn & 0x3FF00) == PGN_TP_CM) {
+        stats_.framesReceived++;
+        HandleConnectionManagement(frame, sa, ps);
+        return true;
+    }
+    if ((pgn & 0x3FF00) == PGN_TP_DT) {
+        stats_.framesReceived++;
+        HandleDataTransfer(frame, sa, ps);
+        return true;
+    }
+    if (!options_.singleFrames) {
+        return false;
+    }
+
+    stats_.framesReceived++;
+    J1939Message message;
+    message.pgn = pgn;
+    message.priority = static_cast<BYTE>((canId >> 26) & 0x07);
+    message.sa = sa;
+    message.da = ((pgn >> 8) & 0xFF) < 240 ? ps : GLOBAL_ADDRESS;
+    message.transport = J1939Message::Transport::Single;
+    message.data.assign(frame.frame.data, frame.frame.data + std::min<UINT>(frame.frame.len, fd ? CANFD_MAX_DLEN : CAN_MAX_DLEN));
+    message.timestamp = frame.timestamp;
+    Deliver(std::move(message));
+    return true;
+}
+
+void J1939Engine::StartSession(std::unique_ptr<RxSession> session) {
+    auto& slot = sessions_[SessionKey(session->sa, session->da)];
+    if (slot) {
+        // 同一对地址上未完成的会话被新会话替换
+        stats_.aborts++;
+    }
+    slot = std::move(session);
+}
+
+void J1939Engine::HandleConnectionManagement(const ZCAN_ReceiveFD_Data& frame, BYTE sa, BYTE da) {
+    if (frame.frame.len < 8) {
+        return;
+    }
+    const BYTE* d = frame.frame.data;
+    const uint32_t pgn = DecodePgn(d + 5);
+    const auto now = Clock::now();
+
+    switch (d[0]) {
+        case CM_BAM:
+        case CM_RTS: {
+            const bool bam = d[0] == CM_BAM;
+            const UINT size = d[1] | (static_cast<UINT>(d[2]) << 8);
+            const UINT packets = d[3];
+            const bool owned = !bam && IsLocalAddress(da);
+            if (bam != (da == GLOBAL_ADDRESS)) {
+                return;
+            }
+            if (size < TP_MIN_SIZE || size > TP_MAX_SIZE || packets != PacketCount(size)) {
+                if (owned) {
+                    SendAbort(da, sa, pgn, ABORT_MESSAGE_TOO_LARGE);
+                    stats_.aborts++;
+                }
+                return;
+            }
+            if (!bam && !owned && !options_.monitorSessions) {
+                return;
+            }
+
+            std::unique_ptr<RxSession> session(new RxSession());
+            session->transport = bam ? J1939Message::Transport::Bam : J1939Message::Transport::Cmdt;
+            session->sa = sa;
+            session->da = da;
+            session->priority = static_cast<BYTE>((frame.frame.can_id >> 26) & 0x07);
+            session->pgn = pgn;
+            session->size = size;
+            session->packets = packets;
+            session->owned = owned;
+            session->maxPerCts = d[4];
+            session->data.assign(size, 0xFF);
+            session->startedAt = now;
+            // 被动监视的会话等待接收方的CTS
+            session->deadline = now + std::chrono::milliseconds(bam ? options_.t1Ms : options_.t3Ms);
+
+            if (bam) {
+                stats_.bamSessions++;
+            } else {
+                stats_.cmdtSessions++;
+            }
+            if (owned) {
+                SendCts(*session);
+                stats_.maxCtsResponseUs = std::max(stats_.maxCtsResponseUs, ElapsedUs(now, Clock::now()));
+            }
+            StartSession(std::move(session));
+            break;
+        }
+        case CM_CTS: {
+            // sa为接收方，da为发送方
+            if (auto tx = FindTxSession(da, sa)) {
+                {
+                    std::lock_guard<std::mutex> lock(tx->mutex);
+                    tx->signal = TxSession::Signal::Cts;
+                    tx->ctsPackets = d[1];
+                    tx->ctsNext = d[2];
+                }
+                tx->cv.notify_all();
+                break;
+            }
+            auto it = sessions_.find(SessionKey(da, sa));
+            if (it == sessions_.end() || it->second->owned) {
+                break;
+            }
+            RxSession& session = *it->second;
+            if (d[1] == 0) {
+                session.deadline = now + std::chrono::milliseconds(options_.t4Ms);
+            } else {
+                // 接收方可要求从指定包重传
+                session.nextSeq = std::max<UINT>(d[2], 1);
+                session.windowEnd = session.nextSeq + d[1] - 1;
+                session.deadline = now + std::chrono::milliseconds(options_.t2Ms);
+            }
+            break;
+        }
+        case CM_END_OF_MSG_ACK: {
+            if (auto tx = FindTxSession(da, sa)) {
+                {
+                    std::lock_guard<std::mutex> lock(tx->mutex);
+                    tx->signal = TxSession::Signal::EndOfMsgAck;
+                }
+                tx->cv.notify_all();
+            }
+            break;
+        }
+        case CM_ABORT: {
+            stats_.aborts++;
+            if (auto tx = FindTxSession(da, sa)) {
+                {
+                    std::lock_guard<std::mutex> lock(tx->mutex);
+                    tx->signal = TxSession::Signal::Abort;
+                    tx->abortReason = d[1];
+                }
+                tx->cv.notify_all();
+            }
+            // 发送方或接收方都可以中止
+            for (uint16_t key : {SessionKey(sa, da), SessionKey(da, sa)}) {
+                auto it = sessions_.find(key);
+                if (it != sessions_.end() && it->second->pgn == pgn) {
+                    sessions_.erase(it);
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void J1939Engine::HandleDataTransfer(const ZCAN_ReceiveFD_Data& frame, BYTE sa, BYTE da) {
+    auto it = sessions_.find(SessionKey(sa, da));
+    if (it == sessions_.end() || frame.frame.len < 1) {
+        return;
+    }
+    RxSession& session = *it->second;
+    const auto now = Clock::now();
+    const UINT seq = frame.frame.data[0];
+
+    if (seq != session.nextSeq) {
+        if (seq != 0 && seq < session.nextSeq) {
+            return;  // 重复的数据包
+        }
+        stats_.sequenceErrors++;
+        if (session.owned) {
+            SendAbort(session.da, session.sa, session.pgn, ABORT_BAD_SEQUENCE);
+            stats_.aborts++;
+        }
+        sessions_.erase(it);
+        return;
+    }
+
+    const UINT offset = (seq - 1) * TP_PACKET_SIZE;
+    const UINT available = frame.frame.len > 1 ? static_cast<UINT>(frame.frame.len) - 1 : 0;
+    const UINT count = std::min<UINT>({TP_PACKET_SIZE, session.size - offset, available});
+    memcpy(session.data.data() + offset, frame.frame.data + 1, count);
+    session.nextSeq++;
+
+    if (seq == session.packets) {
+        if (session.owned) {
+            SendEndOfMsgAck(session);
+        }
+        CompleteSession(session, frame.timestamp);
+        sessions_.erase(it);
+        return;
+    }
+
+    if (session.owned && seq == session.windowEnd) {
+        SendCts(session);
+        stats_.maxCtsResponseUs = std::max(stats_.maxCtsResponseUs, ElapsedUs(now, Clock::now()));
+    } else {
+        session.deadline = now + std::chrono::milliseconds(options_.t1Ms);
+    }
+}
+
+void J1939Engine::CompleteSession(const RxSession& session, uint64_t timestamp) {
+    J1939Message message;
+    message.pgn = session.pgn;
+    message.priority = session.priority;
+    message.sa = session.sa;
+    message.da = session.da;
+    message.transport = session.transport;
+    message.data = session.data;
+    message.timestamp = timestamp;
+    message.durationUs = ElapsedUs(session.startedAt, Clock::now());
+    Deliver(std::move(message));
+}
+
+void J1939Engine::Deliver(J1939Message&& message) {
+    pending_.push_back(std::move(message));
+    stats_.messages++;
+    if (pending_.size() >= std::max<UINT>(options_.maxBatch, 1)) {
+        Flush();
+    }
+}
+
+void J1939Engine::Flush() {
+    if (pending_.empty()) {
+        return;
+    }
+    std::vector<J1939Message> batch;
+    batch.swap(pending_);
+    stats_.batches++;
+    if (callback_) {
+        callback_(std::move(batch));
+    }
+}
+
+void J1939Engine::OnTick(std::chrono::steady_clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = sessions_.begin(); it != sessions_.end();) {
+        const RxSession& session = *it->second;
+        if (now < session.deadline) {
+            ++it;
+            continue;
+        }
+        stats_.timeouts++;
+        if (session.owned) {
+            SendAbort(session.da, session.sa, session.pgn, ABORT_TIMEOUT);
+            stats_.aborts++;
+        }
+        it = sessions_.erase(it);
+    }
+    Flush();
+}
+
+J1939SendResult J1939Engine::Send(uint32_t pgn, BYTE priority, BYTE sa, BYTE da, const std::vector<BYTE>& data) {
+    J1939SendResult result;
+    const auto startedAt = Clock::now();
+    auto finish = [&](const char* error) {
+        result.success = error == nullptr;
+        if (error) {
+            result.error = error;
+        }
+        result.durationUs = ElapsedUs(startedAt, Clock::now());
+        return result;
+    };
+
+    if (data.empty() || data.size() > TP_MAX_SIZE) {
+        return finish("invalid data length");
+    }
+
+    std::lock_guard<std::mutex> sendLock(sendMutex_);
+    {
+        std::lock_guard<std::mutex> lock(txMutex_);
+        if (closed_) {
+            return finish("engine closed");
+        }
+    }
+
+    if (data.size() <= CAN_MAX_DLEN) {
+        if (!TransmitFrame(MakeId(pgn, priority, sa, da), data.data(), static_cast<UINT>(data.size()))) {
+            return finish("transmit failed");
+        }
+        return finish(nullptr);
+    }
+
+    const UINT size = static_cast<UINT>(data.size());
+    const UINT packets = PacketCount(size);
+    const UINT dtId = MakeId(PGN_TP_DT, TP_PRIORITY, sa, da);
+    auto sendPacket = [&](UINT seq) {
+        BYTE buf[8];
+        memset(buf, 0xFF, sizeof(buf));
+        buf[0] = static_cast<BYTE>(seq);
+        const UINT offset = (seq - 1) * TP_PACKET_SIZE;
+        memcpy(buf + 1, data.data() + offset, std::min<UINT>(TP_PACKET_SIZE, size - offset));
+        if (!TransmitFrame(dtId, buf, sizeof(buf))) {
+            return false;
+        }
+        result.packets++;
+        return true;
+    };
+
+    BYTE announce[8] = {CM_RTS, static_cast<BYTE>(size), static_cast<BYTE>(size >> 8),
+                        static_cast<BYTE>(packets), 0xFF};
+    EncodePgn(pgn, announce + 5);
+
+    // BAM：按固定间隔广播数据包，无应答
+    if (da == GLOBAL_ADDRESS) {
+        announce[0] = CM_BAM;
+        SendConnectionManagement(sa, GLOBAL_ADDRESS, announce);
+        for (UINT seq = 1; seq <= packets; seq++) {
+            {
+                std::unique_lock<std::mutex> lock(txMutex_);
+                if (closeCv_.wait_for(lock, std::chrono::milliseconds(options_.bamIntervalMs),
+                                      [this] { return closed_; })) {
+                    return finish("engine closed");
+                }
+            }
+            if (!sendPacket(seq)) {
+                return finish("transmit failed");
+            }
+        }
+        return finish(nullptr);
+    }
+
+    // RTS/CTS：在发出RTS之前登记，避免接收方应答过快时丢失CTS
+    auto tx = std::make_shared<TxSession>();
+    {
+        std::lock_guard<std::mutex> lock(txMutex_);
+        txSessions_[SessionKey(sa, da)] = tx;
+    }
+    auto unregister = [&]() {
+        std::lock_guard<std::mutex> lock(txMutex_);
+        txSessions_.erase(SessionKey(sa, da));
+    };
+
+    SendConnectionManagement(sa, da, announce);
+
+    UINT timeoutMs = options_.t3Ms;
+    UINT sent = 0;
+    while (true) {
+        TxSession::Signal signal;
+        BYTE ctsPackets;
+        BYTE ctsNext;
+        BYTE abortReason;
+        {
+            std::unique_lock<std::mutex> lock(tx->mutex);
+            const bool got = tx->cv.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                [&tx] { return tx->signal != TxSession::Signal::None || tx->closed; });
+            if (tx->closed) {
+                lock.unlock();
+                unregister();
+                return finish("engine closed");
+            }
+            if (!got) {
+                lock.unlock();
+                unregister();
+                SendAbort(sa, da, pgn, ABORT_TIMEOUT);
+                return finish(timeoutMs == options_.t4Ms ? "T4 timeout" : "T3 timeout");
+            }
+            signal = tx->signal;
+            ctsPackets = tx->ctsPackets;
+            ctsNext = tx->ctsNext;
+            abortReason = tx->abortReason;
+            tx->signal = TxSession::Signal::None;
+        }
+
+        if (signal == TxSession::Signal::Abort) {
+            unregister();
+            result.error = "aborted by receiver (reason " + std::to_string(abortReason) + ")";
+            result.durationUs = ElapsedUs(startedAt, Clock::now());
+            return result;
+        }
+        if (signal == TxSession::Signal::EndOfMsgAck) {
+            unregister();
+            return finish(sent >= packets ? nullptr : "unexpected EndOfMsgAck");
+        }
+
+        // CTS：包数为0表示保持连接
+        if (ctsPackets == 0) {
+            timeoutMs = options_.t4Ms;
+            continue;
+        }
+        if (ctsNext < 1 || ctsNext > packets) {
+            unregister();
+            SendAbort(sa, da, pgn, ABORT_BAD_SEQUENCE);
+            return finish("invalid CTS");
+        }
+        const UINT last = std::min<UINT>(ctsNext + ctsPackets - 1, packets);
+        for (UINT seq = ctsNext; seq <= last; seq++) {
+            if (!sendPacket(seq)) {
+                unregister();
+                SendAbort(sa, da, pgn, ABORT_TIMEOUT);
+                return finish("transmit failed");
+            }
+        }
+        sent = std::max(sent, last);
+        timeoutMs = options_.t3Ms;
+    }
+}
@@ -0,0 +1,144 @@
+#ifndef ZLGCAN_J1939_ENGINE_H_
+#define ZLGCAN_J1939_ENGINE_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "zlgcan.h"
+#include "receive_pump.h"
+
+// J1939配置
+struct J1939Options {
+    std::vector<BYTE> addresses;       // 本节点地址，发往这些地址的RTS由引擎应答CTS
+    bool singleFrames = true;          // 单帧PGN也作为消息上报
+    bool monitorSessions = true;       // 被动重组其他节点之间的RTS/CTS会话
+    BYTE maxPacketsPerCts = 16;        // 本端CTS一次允许的包数，不超过RTS中的限制
+    UINT maxBatch = 256;               // 单批最多的消息数，达到时立即上报
+    UINT bamIntervalMs = 50;           // 发送BAM数据包的间隔（J1939-21: 50~200ms）
+    UINT t1Ms = 750;                   // 等待下一个数据包超时
+    UINT t2Ms = 1250;                  // 发出CTS后等待数据包超时
+    UINT t3Ms = 1250;                  // 发出最后一个数据包后等待CTS/EndOfMsgAck超时
+    UINT t4Ms = 1050;                  // 收到保持连接的CTS(包数0)后等待下一个CTS超时
+};
+
+// 完整的PGN消息
+struct J1939Message {
+    enum class Transport : uint8_t { Single, Bam, Cmdt };
+
+    uint32_t pgn = 0;
+    BYTE priority = 0;
+    BYTE sa = 0;
+    BYTE da = 0xFF;                    // PDU2或BAM为0xFF
+    Transport transport = Transport::Single;
+    std::vector<BYTE> data;
+    uint64_t timestamp = 0;            // 最后一帧的设备时间戳(us)
+    uint64_t durationUs = 0;           // 多包消息从连接管理帧到最后一个数据包的耗时
+};
+
+// J1939统计
+struct J1939Stats {
+    uint64_t framesReceived = 0;       // 处理的扩展帧数
+    uint64_t messages = 0;             // 上报的消息数
+    uint64_t batches = 0;
+    uint64_t bamSessions = 0;
+    uint64_t cmdtSessions = 0;
+    uint64_t ctsSent = 0;
+    uint64_t aborts = 0;               // 收到或发出的Abort，以及被新会话替换的未完成会话
+    uint64_t timeouts = 0;
+    uint64_t sequenceErrors = 0;
+    uint64_t maxCtsResponseUs = 0;     // 收到RTS/窗口末包到发出CTS的最大耗时（要求Tr内）
+    size_t activeSessions = 0;
+};
+
+// 发送结果
+struct J1939SendResult {
+    bool success = false;
+    std::string error;
+    UINT packets = 0;                  // 发送的数据包数（单帧为0）
+    uint64_t durationUs = 0;
+};
+
+/**
+ * SAE J1939-21 传输协议引擎
+ * 作为接收线程的监听者运行：按源地址/目标地址同时重组多个BAM和RTS/CTS会话，
+ * 发往本节点地址的RTS在接收线程中立即应答CTS，窗口收完后续发CTS，
+ * 收完全部数据包后回复EndOfMsgAck，超时则发出Abort。
+ * 完整的消息在每轮轮询末尾整批交给回调（在接收线程中执行）。
+ * Send为阻塞调用，应在工作线程中执行。
+ */
+class J1939Engine : public FrameListener {
+public:
+    using BatchCallback = std::function<void(std::vector<J1939Message>&& messages)>;
+
+    J1939Engine(CHANNEL_HANDLE channelHandle, const J1939Options& options, BatchCallback callback);
+    ~J1939Engine() override;
+
+    J1939Engine(const J1939Engine&) = delete;
+    J1939Engine& operator=(const J1939Engine&) = delete;
+
+    /**
+     * 发送PGN消息（阻塞）
+     * 8字节以内为单帧；目标地址0xFF时以BAM广播，否则以RTS/CTS发送
+     */
+    J1939SendResult Send(uint32_t pgn, BYTE priority, BYTE sa, BYTE da, const std::vector<BYTE>& data);
+
+    // 结束发送中的请求，之后的Send直接返回失败
+    void Close();
+
+    J1939Stats Stats() const;
+
+    void SetChannelHandle(CHANNEL_HANDLE channelHandle) { channelHandle_.store(channelHandle); }
+
+    bool OnFrame(const ZCAN_ReceiveFD_Data& frame, bool fd) override;
+    void OnTick(std::chrono::steady_clock::time_point now) override;
+
+    // 29位ID与PGN
+    static uint32_t IdToPgn(UINT canId);
+    static UINT MakeId(uint32_t pgn, BYTE priority, BYTE sa, BYTE da);
+
+private:
+    struct RxSession;
+    struct TxSession;
+
+    bool TransmitFrame(UINT canId, const BYTE* data, UINT len);
+    void SendConnectionManagement(BYTE sa, BYTE da, const BYTE payload[8]);
+    void SendCts(RxSession& session);
+    void SendEndOfMsgAck(const RxSession& session);
+    void SendAbort(BYTE sa, BYTE da, uint32_t pgn, BYTE reason);
+
+    void HandleConnectionManagement(const ZCAN_ReceiveFD_Data& frame, BYTE sa, BYTE da);
+    void HandleDataTransfer(const ZCAN_ReceiveFD_Data& frame, BYTE sa, BYTE da);
+    void StartSession(std::unique_ptr<RxSession> session);
+    void CompleteSession(const RxSession& session, uint64_t timestamp);
+    void Deliver(J1939Message&& message);
+    void Flush();
+    bool IsLocalAddress(BYTE address) const;
+    std::shared_ptr<TxSession> FindTxSession(BYTE sa, BYTE da);
+
+    std::atomic<CHANNEL_HANDLE> channelHandle_;
+    const J1939Options options_;
+    const BatchCallback callback_;
+
+    // 接收会话与待上报消息，接收线程持有
+    mutable std::mutex mutex_;
+    std::map<uint16_t, std::unique_ptr<RxSession>> sessions_;  // (源地址 << 8 | 目标地址) -> 会话
+    std::vector<J1939Message> pending_;
+    J1939Stats stats_;
+
+    // 发送中的RTS/CTS会话，按(本端地址 << 8 | 对端地址)
+    std::mutex txMutex_;
+    std::condition_variable closeCv_;           // BAM数据包间隔等待期间响应Close
+    std::map<uint16_t, std::shared_ptr<TxSession>> txSessions_;
+    std::mutex sendMutex_;                      // 发送串行执行
+    bool closed_ = false;
+};
+
+#endif  // ZLGCAN_J1939_ENGINE_H_
@@ -0,0 +1,140 @@
+#include "lin_receive_pump.h"
+#include "zlgcan_api.h"
+
+#include <algorithm>
+#include <string>
+
+#include "thread_scheduling.h"
+
+LinReceivePump::LinReceivePump(CHANNEL_HANDLE channelHandle, const ReceivePumpOptions& options,
+                               BatchCallback callback)
+    : channelHandle_(channelHandle), options_(options), callback_(std::move(callback)) {
+}
+
+LinReceivePump::~LinReceivePump() {
+    Stop();
+}
+
+void LinReceivePump::Start() {
+    if (thread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopRequested_ = false;
+    }
+    running_.store(true);
+    thread_ = std::thread(&LinReceivePump::Run, this);
+}
+
+void LinReceivePump::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopRequested_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    // 唤醒等待中的Pop
+    {
+        std::lock_guard<std::mutex> lock(ringMutex_);
+        running_.store(false);
+    }
+    ringCv_.notify_all();
+}
+
+void LinReceivePump::Run() {
+    const UINT batchSize = std::max<UINT>(options_.batchSize, 1);
+    const int blockWaitMs = static_cast<int>(std::max<UINT>(options_.blockWaitMs, 1));
+    std::vector<ZCAN_LIN_MSG> messages(batchSize);
+    TraceSetThreadName("lin-rx " + std::to_string(reinterpret_cast<uintptr_t>(channelHandle_.load())));
+    ThreadSchedulingScope scheduling(ThreadRole::Receive);
+
+    while (true) {
+        const uint64_t wakeAt = ApiStatsNow();
+        const auto readAt = std::chrono::steady_clock::now();
+        const UINT count = ZcanReceiveLIN(channelHandle_.load(), messages.data(), batchSize, blockWaitMs);
+        if (count > 0) {
+            framesReceived_ += count;
+            wakeups_++;
+
+            if (callback_) {
+                if (!callback_(std::vector<ZCAN_LIN_MSG>(messages.begin(), messages.begin() + count))) {
+                    framesDropped_ += count;
+                    if (TraceEnabled()) {
+                        TraceInstant("callback.overflow", "rx", ApiStatsNow(), count);
+                    }
+                }
+            } else {
+                uint64_t dropped = 0;
+                {
+                    std::lock_guard<std::mutex> lock(ringMutex_);
+                    ring_.insert(ring_.end(), messages.begin(), messages.begin() + count);
+                    while (ring_.size() > options_.ringCapacity) {
+                        ring_.pop_front();
+                        dropped++;
+                    }
+                }
+                framesDropped_ += dropped;
+                ringCv_.notify_all();
+                if (dropped > 0 && TraceEnabled()) {
+                    TraceInstant("ring.overflow", "rx", ApiStatsNow(), dropped);
+                }
+            }
+            if (TraceEnabled()) {
+                TraceComplete("rx.wakeup", "rx", wakeAt, ApiStatsNow(), count);
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stopRequested_) {
+            break;
+        }
+        // 已在驱动中等待；驱动未等待即返回（通道未启动或复位中）时短暂休眠，避免空转
+        const auto now = std::chrono::steady_clock::now();
+        if (count == 0 && now - readAt < std::chrono::milliseconds(1)) {
+            const auto deadline = now + std::chrono::microseconds(std::max<UINT>(options_.idleSleepUs, 1));
+            if (cv_.wait_until(lock, deadline, [this] { return stopRequested_; })) {
+                break;
+            }
+            ThreadSchedulingRecordWakeup(deadline);
+        }
+    }
+}
+
+UINT LinReceivePump::Pop(ZCAN_LIN_MSG* messages, UINT count, int waitMs) {
+    const uint64_t popAt = ApiStatsNow();
+    std::unique_lock<std::mutex> lock(ringMutex_);
+    if (ring_.empty() && waitMs != 0) {
+        auto ready = [this] { return !ring_.empty() || !running_.load(); };
+        if (waitMs < 0) {
+            ringCv_.wait(lock, ready);
+        } else {
+            ringCv_.wait_for(lock, std::chrono::milliseconds(waitMs), ready);
+        }
+    }
+
+    const UINT n = static_cast<UINT>(std::min<size_t>(count, ring_.size()));
+    std::copy(ring_.begin(), ring_.begin() + n, messages);
+    ring_.erase(ring_.begin(), ring_.begin() + n);
+    if (n > 0 && TraceEnabled()) {
+        TraceComplete("ring.pop", "rx", popAt, ApiStatsNow(), n);
+    }
+    return n;
+}
+
+void LinReceivePump::ClearRing() {
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    ring_.clear();
+}
+
+LinReceivePumpStats LinReceivePump::Stats() const {
+    LinReceivePumpStats stats;
+    stats.framesReceived = framesReceived_.load();
+    stats.framesDropped = framesDropped_.load();
+    stats.wakeups = wakeups_.load();
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    stats.ringDepth = ring_.size();
+    return stats;
+}
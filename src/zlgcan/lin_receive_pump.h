@@ -0,0 +1,78 @@
+#ifndef ZLGCAN_LIN_RECEIVE_PUMP_H_
+#define ZLGCAN_LIN_RECEIVE_PUMP_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "receive_pump.h"
+
+// LIN接收线程统计
+struct LinReceivePumpStats {
+    uint64_t framesReceived = 0;       // 从驱动读取的消息数（数据、错误和事件）
+    uint64_t framesDropped = 0;        // 环形缓冲满或批回调拒收（JS回调队列满）时丢弃的消息数
+    uint64_t wakeups = 0;              // 读取到数据的轮询次数
+    size_t ringDepth = 0;
+};
+
+/**
+ * LIN通道接收线程
+ * 与CAN通道ReceivePump的blocking方式相同：在独立线程中以blockWaitMs为等待时间阻塞调用ZCAN_ReceiveLIN，
+ * 设置了批回调时每轮读取到的消息整批交给回调，否则放入有界环形缓冲由receiveLin取出。
+ * 停止线程的最长响应时间为一次blockWaitMs。
+ */
+class LinReceivePump {
+public:
+    // 在接收线程中执行，返回false表示未能交付（如JS回调队列已满），整批计入丢弃
+    using BatchCallback = std::function<bool(std::vector<ZCAN_LIN_MSG>&& messages)>;
+
+    LinReceivePump(CHANNEL_HANDLE channelHandle, const ReceivePumpOptions& options, BatchCallback callback);
+    ~LinReceivePump();
+
+    LinReceivePump(const LinReceivePump&) = delete;
+    LinReceivePump& operator=(const LinReceivePump&) = delete;
+
+    void Start();
+    void Stop();
+    bool IsRunning() const { return thread_.joinable(); }
+    bool HasCallback() const { return static_cast<bool>(callback_); }
+    // 通道句柄变化时更新（例如设备重连后）
+    void SetChannelHandle(CHANNEL_HANDLE channelHandle) { channelHandle_.store(channelHandle); }
+
+    /**
+     * 取出缓存的消息
+     * @param waitMs 缓冲为空时的等待时间，0不等待，小于0一直等待到有数据或线程停止
+     */
+    UINT Pop(ZCAN_LIN_MSG* messages, UINT count, int waitMs);
+
+    void ClearRing();
+    LinReceivePumpStats Stats() const;
+
+private:
+    void Run();
+
+    std::atomic<CHANNEL_HANDLE> channelHandle_;
+    const ReceivePumpOptions options_;
+    const BatchCallback callback_;
+
+    mutable std::mutex ringMutex_;
+    std::condition_variable ringCv_;
+    std::deque<ZCAN_LIN_MSG> ring_;
+
+    std::atomic<uint64_t> framesReceived_{0};
+    std::atomic<uint64_t> framesDropped_{0};
+    std::atomic<uint64_t> wakeups_{0};
+    std::atomic<bool> running_{false};
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopRequested_ = false;
+    std::thread thread_;
+};
+
+#endif  // ZLGCAN_LIN_RECEIVE_PUMP_H_
@@ -0,0 +1,259 @@
+#include "pipeline_watchdog.h"
+#include "zlgcan_api.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "receive_pump.h"
+#include "thread_scheduling.h"
+#include "trace_buffer.h"
+
+namespace {
+
+uint64_t NowMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+int64_t SteadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* WarningTraceName(PipelineWarning::Type type) {
+    switch (type) {
+        case PipelineWarning::Type::RingFilling: return "pipeline.ring";
+        case PipelineWarning::Type::VendorQueue: return "pipeline.vendor";
+        case PipelineWarning::Type::FramesDropped: return "pipeline.drop";
+        default: return "pipeline.lag";
+    }
+}
+
+}  // namespace
+
+bool PipelineWatchdog::Alarm::Update(bool over, bool clear) {
+    if (over && !raised) {
+        raised = true;
+        return true;
+    }
+    if (clear) {
+        raised = false;
+    }
+    return false;
+}
+
+PipelineWatchdog::PipelineWatchdog(const PipelineWatchdogOptions& options, PingCallback ping,
+                                   WarningCallback warning)
+    : options_(options), ping_(std::move(ping)), warning_(std::move(warning)),
+      probe_(std::make_shared<ProbeState>()) {
+}
+
+PipelineWatchdog::~PipelineWatchdog() {
+    Stop();
+}
+
+void PipelineWatchdog::Start() {
+    if (thread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopRequested_ = false;
+    }
+    thread_ = std::thread(&PipelineWatchdog::Run, this);
+}
+
+void PipelineWatchdog::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopRequested_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void PipelineWatchdog::SetSources(std::vector<PipelineSource> sources) {
+    // 采样全程持有该锁，替换完成即表示旧的接收线程不再被访问
+    std::lock_guard<std::mutex> lock(sourcesMutex_);
+    sources_.swap(sources);
+}
+
+std::vector<PipelineSample> PipelineWatchdog::History(uint64_t sinceMs) const {
+    std::lock_guard<std::mutex> lock(historyMutex_);
+    auto first = std::find_if(history_.begin(), history_.end(),
+        [sinceMs](const PipelineSample& sample) { return sample.timestampMs > sinceMs; });
+    return std::vector<PipelineSample>(first, history_.end());
+}
+
+void PipelineWatchdog::Run() {
+    TraceSetThreadName("pipeline-watchdog");
+    ThreadSchedulingScope scheduling(ThreadRole::Monitor);
+    const auto interval = std::chrono::milliseconds(std::max<UINT>(options_.intervalMs, 1));
+    auto nextTickAt = std::chrono::steady_clock::now();
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait_until(lock, nextTickAt, [this] { return stopRequested_; });
+            if (stopRequested_) {
+                break;
+            }
+        }
+        ThreadSchedulingRecordWakeup(nextTickAt);
+        Tick();
+        nextTickAt += interval;
+        const auto now = std::chrono::steady_clock::now();
+        if (nextTickAt < now) {
+            nextTickAt = now + interval;
+        }
+    }
+}
+
+double PipelineWatchdog::Probe(int64_t nowNs, bool* stalled) {
+    int64_t lagNs = std::max<int64_t>(probe_->lagNs.exchange(-1), 0);
+
+    if (probe_->outstanding.load()) {
+        // 上次探测仍在JS队列中，已等待的时间即为当前延迟的下界
+        *stalled = true;
+        lagNs = std::max(lagNs, nowNs - probe_->sentNs.load());
+        return static_cast<double>(lagNs) / 1e6;
+    }
+
+    *stalled = false;
+    probe_->sentNs.store(nowNs);
+    probe_->outstanding.store(true);
+    std::shared_ptr<ProbeState> probe = probe_;
+    const bool posted = ping_([probe, nowNs] {
+        probe->lagNs.store(SteadyNs() - nowNs);
+        probe->outstanding.store(false);
+    });
+    if (!posted) {
+        probe_->outstanding.store(false);
+    }
+    return static_cast<double>(lagNs) / 1e6;
+}
+
+PipelineSourceReading PipelineWatchdog::Read(const PipelineSource& source) {
+    if (source.read) {
+        return source.read();
+    }
+    PipelineSourceReading reading;
+    reading.vendorDepth = ZcanGetReceiveNum(source.channelHandle, TYPE_ALL_DATA);
+    if (source.receivePump != nullptr) {
+        const ReceivePumpStats stats = source.receivePump->Stats();
+        reading.ringDepth = stats.canRingDepth + stats.fdRingDepth;
+        reading.ringCapacity = static_cast<uint64_t>(source.receivePump->RingCapacity()) * 2;
+        reading.framesReceived = stats.framesReceived;
+        reading.framesDropped = stats.framesDropped;
+    }
+    return reading;
+}
+
+PipelineChannelSample PipelineWatchdog::SampleChannel(const PipelineSource& source, double intervalMs,
+                                                      uint64_t timestampMs, double lagMs) {
+    const PipelineSourceReading reading = Read(source);
+    PipelineChannelSample sample;
+    sample.channelIndex = source.channelIndex;
+    sample.vendorDepth = reading.vendorDepth;
+
+    ChannelState& state = channelStates_[source.channelIndex];
+    if (state.receivePump != source.receivePump) {
+        state = ChannelState();
+        state.receivePump = source.receivePump;
+    }
+
+    uint64_t previousDepth = state.ringDepth;
+    if (reading.ringCapacity > 0) {
+        sample.ringDepth = reading.ringDepth;
+        sample.ringCapacity = reading.ringCapacity;
+        if (state.primed) {
+            sample.framesReceived = reading.framesReceived - state.framesReceived;
+            sample.framesDropped = reading.framesDropped - state.framesDropped;
+        }
+        state.framesReceived = reading.framesReceived;
+        state.framesDropped = reading.framesDropped;
+        state.ringDepth = sample.ringDepth;
+    }
+    const bool primed = state.primed;
+    state.primed = true;
+
+    if (sample.ringCapacity > 0) {
+        const double ratio = static_cast<double>(sample.ringDepth) / static_cast<double>(sample.ringCapacity);
+        double etaMs = -1;
+        if (primed && sample.ringDepth > previousDepth && intervalMs > 0) {
+            const double growthPerMs = static_cast<double>(sample.ringDepth - previousDepth) / intervalMs;
+            etaMs = static_cast<double>(sample.ringCapacity - sample.ringDepth) / growthPerMs;
+        }
+        if (state.ringAlarm.Update(ratio >= options_.ringWarnRatio, ratio < options_.ringWarnRatio / 2)) {
+            Warn(PipelineWarning::Type::RingFilling, source.channelIndex, timestampMs,
+                 ratio, options_.ringWarnRatio, lagMs, etaMs);
+        }
+    }
+
+    const double vendorWarn = static_cast<double>(std::max<UINT>(options_.vendorWarnFrames, 1));
+    const double vendorDepth = static_cast<double>(sample.vendorDepth);
+    if (state.vendorAlarm.Update(vendorDepth >= vendorWarn, vendorDepth < vendorWarn / 2)) {
+        Warn(PipelineWarning::Type::VendorQueue, source.channelIndex, timestampMs,
+             vendorDepth, vendorWarn, lagMs, -1);
+    }
+
+    if (sample.framesDropped > 0) {
+        Warn(PipelineWarning::Type::FramesDropped, source.channelIndex, timestampMs,
+             static_cast<double>(sample.framesDropped), 0, lagMs, 0);
+    }
+    return sample;
+}
+
+void PipelineWatchdog::Tick() {
+    const int64_t nowNs = SteadyNs();
+    const double intervalMs = lastTickNs_ == 0 ? 0 : static_cast<double>(nowNs - lastTickNs_) / 1e6;
+    lastTickNs_ = nowNs;
+
+    PipelineSample sample;
+    sample.timestampMs = NowMs();
+    sample.lagMs = Probe(nowNs, &sample.stalled);
+
+    const double lagWarn = static_cast<double>(options_.lagWarnMs);
+    if (lagAlarm_.Update(sample.lagMs >= lagWarn, !sample.stalled && sample.lagMs < lagWarn / 2)) {
+        Warn(PipelineWarning::Type::EventLoopLag, 0, sample.timestampMs, sample.lagMs, lagWarn, sample.lagMs, -1);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sourcesMutex_);
+        for (const auto& source : sources_) {
+            sample.channels.push_back(SampleChannel(source, intervalMs, sample.timestampMs, sample.lagMs));
+        }
+        for (auto it = channelStates_.begin(); it != channelStates_.end();) {
+            const bool present = std::any_of(sources_.begin(), sources_.end(),
+                [&it](const PipelineSource& source) { return source.channelIndex == it->first; });
+            it = present ? std::next(it) : channelStates_.erase(it);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(historyMutex_);
+    history_.push_back(std::move(sample));
+    while (history_.size() > std::max<UINT>(options_.historySize, 1)) {
+        history_.pop_front();
+    }
+}
+
+void PipelineWatchdog::Warn(PipelineWarning::Type type, UINT channelIndex, uint64_t timestampMs,
+                            double value, double threshold, double lagMs, double etaMs) {
+    if (TraceEnabled()) {
+        TraceInstant(WarningTraceName(type), "watchdog", ApiStatsNow(), static_cast<uint64_t>(value));
+    }
+    if (!warning_) {
+        return;
+    }
+    PipelineWarning warning;
+    warning.type = type;
+    warning.channelIndex = channelIndex;
+    warning.timestampMs = timestampMs;
+    warning.value = value;
+    warning.threshold = threshold;
+    warning.lagMs = lagMs;
+    warning.etaMs = etaMs;
+    warning_(warning);
+}
@@ -0,0 +1,159 @@
+#ifndef ZLGCAN_PIPELINE_WATCHDOG_H_
+#define ZLGCAN_PIPELINE_WATCHDOG_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "zlgcan.h"
+
+class ReceivePump;
+
+// 接收链路监视配置
+struct PipelineWatchdogOptions {
+    UINT intervalMs = 50;              // 采样及事件循环探测周期
+    UINT lagWarnMs = 100;              // 事件循环延迟告警阈值
+    double ringWarnRatio = 0.5;        // 接收环形缓冲占用率告警阈值
+    UINT vendorWarnFrames = 2000;      // 驱动接收缓冲帧数告警阈值
+    UINT historySize = 1200;           // 保留的采样点数
+};
+
+// 通道的一次读数，计数均为累计值
+struct PipelineSourceReading {
+    uint64_t vendorDepth = 0;
+    uint64_t ringDepth = 0;
+    uint64_t ringCapacity = 0;         // 0表示未启动接收线程
+    uint64_t framesReceived = 0;
+    uint64_t framesDropped = 0;
+};
+
+// 被监视的通道，receivePump为空表示该通道由JS侧直接轮询驱动
+struct PipelineSource {
+    UINT channelIndex = 0;
+    CHANNEL_HANDLE channelHandle = INVALID_CHANNEL_HANDLE;
+    ReceivePump* receivePump = nullptr;
+    std::function<PipelineSourceReading()> read;   // 非空时代替驱动和接收线程提供读数（测试用）
+};
+
+// 单通道采样值
+struct PipelineChannelSample {
+    UINT channelIndex = 0;
+    uint64_t ringDepth = 0;            // 接收环形缓冲中等待JS取走的帧数（CAN+CANFD）
+    uint64_t ringCapacity = 0;         // 0表示未启动接收线程
+    uint64_t vendorDepth = 0;          // ZCAN_GetReceiveNum
+    uint64_t framesReceived = 0;       // 本周期接收线程从驱动读取的帧数
+    uint64_t framesDropped = 0;        // 本周期接收环形缓冲丢弃的帧数
+};
+
+struct PipelineSample {
+    uint64_t timestampMs = 0;          // 系统时间(ms)，与JS Date.now()同基准
+    double lagMs = 0;                  // 事件循环延迟；探测未应答时为已等待时间
+    bool stalled = false;              // 探测尚未应答
+    std::vector<PipelineChannelSample> channels;
+};
+
+// 告警事件
+struct PipelineWarning {
+    enum class Type : uint8_t { EventLoopLag, RingFilling, VendorQueue, FramesDropped };
+
+    Type type = Type::EventLoopLag;
+    UINT channelIndex = 0;             // EventLoopLag无意义
+    uint64_t timestampMs = 0;
+    double value = 0;                  // 延迟(ms)、占用率、帧数或丢帧数
+    double threshold = 0;
+    double lagMs = 0;                  // 同一时刻的事件循环延迟，便于关联
+    double etaMs = -1;                 // 按当前增长速度估算的缓冲写满时间，-1表示未在增长
+};
+
+/**
+ * 接收链路监视器
+ * 在独立线程中周期向JS线程发送探测，以应答耗时衡量事件循环延迟；同时采样各通道接收环形缓冲深度、
+ * 驱动接收缓冲深度和丢帧数，保留时间序列，并在缓冲接近写满或事件循环阻塞时提前告警。
+ * ping和告警回调在监视线程中执行；ping须把传入的应答函数转到JS线程执行，返回false表示投递失败。
+ */
+class PipelineWatchdog {
+public:
+    using PongFn = std::function<void()>;
+    using PingCallback = std::function<bool(const PongFn& pong)>;
+    using WarningCallback = std::function<void(const PipelineWarning&)>;
+
+    PipelineWatchdog(const PipelineWatchdogOptions& options, PingCallback ping, WarningCallback warning);
+    ~PipelineWatchdog();
+
+    PipelineWatchdog(const PipelineWatchdog&) = delete;
+    PipelineWatchdog& operator=(const PipelineWatchdog&) = delete;
+
+    void Start();
+    void Stop();
+
+    // 采样一次并按需告警；由监视线程周期调用，未Start时可直接调用以驱动监视逻辑
+    void Tick();
+
+    // 返回后不会再访问此前的接收线程，调用方随后可以销毁它们
+    void SetSources(std::vector<PipelineSource> sources);
+
+    // 时间戳晚于sinceMs的采样点
+    std::vector<PipelineSample> History(uint64_t sinceMs) const;
+
+private:
+    // 探测状态由应答函数共享持有，监视器销毁后JS线程仍可能执行已入队的应答
+    struct ProbeState {
+        std::atomic<bool> outstanding{false};
+        std::atomic<int64_t> sentNs{0};
+        std::atomic<int64_t> lagNs{-1};    // 最近一次应答的延迟，取走后置-1
+    };
+
+    // 告警迟滞：超过阈值告警一次，回落到阈值一半以下后重新启用
+    struct Alarm {
+        bool raised = false;
+        bool Update(bool over, bool clear);
+    };
+
+    struct ChannelState {
+        const ReceivePump* receivePump = nullptr;   // 接收线程变化后重新取基准
+        uint64_t framesReceived = 0;
+        uint64_t framesDropped = 0;
+        uint64_t ringDepth = 0;
+        bool primed = false;
+        Alarm ringAlarm;
+        Alarm vendorAlarm;
+    };
+
+    void Run();
+    static PipelineSourceReading Read(const PipelineSource& source);
+    double Probe(int64_t nowNs, bool* stalled);
+    PipelineChannelSample SampleChannel(const PipelineSource& source, double intervalMs,
+                                        uint64_t timestampMs, double lagMs);
+    void Warn(PipelineWarning::Type type, UINT channelIndex, uint64_t timestampMs,
+              double value, double threshold, double lagMs, double etaMs);
+
+    const PipelineWatchdogOptions options_;
+    PingCallback ping_;
+    WarningCallback warning_;
+    std::shared_ptr<ProbeState> probe_;
+
+    // 监视线程独占
+    Alarm lagAlarm_;
+    std::map<UINT, ChannelState> channelStates_;   // 通道索引 -> 上次采样
+    int64_t lastTickNs_ = 0;
+
+    std::mutex sourcesMutex_;
+    std::vector<PipelineSource> sources_;
+
+    mutable std::mutex historyMutex_;
+    std::deque<PipelineSample> history_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopRequested_ = false;
+    std::thread thread_;
+};
+
+#endif  // ZLGCAN_PIPELINE_WATCHDOG_H_
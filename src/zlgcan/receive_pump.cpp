@@ -0,0 +1,470 @@
+#include "receive_pump.h"
+#include "zlgcan_api.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "thread_scheduling.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ZLGCAN_CPU_RELAX() _mm_pause()
+#else
+#define ZLGCAN_CPU_RELAX() std::this_thread::yield()
+#endif
+
+namespace {
+
+const char* MODE_NAMES[] = { "blocking", "adaptive", "busyPoll" };
+const char* DROP_POLICY_NAMES[] = { "dropOldest", "dropNewest" };
+
+constexpr auto CPU_SAMPLE_INTERVAL = std::chrono::milliseconds(10);
+constexpr int64_t OFFSET_WINDOW_US = 1000000;
+// 偏差突增超过该值视为设备时间戳重置（重连等），重新建立基准
+constexpr int64_t OFFSET_RESET_US = 1000000;
+
+// 按丢弃策略把未认领的帧放入缓冲，返回丢弃的帧数
+template <typename Frame>
+uint64_t PushBounded(std::deque<Frame>& ring, const std::vector<Frame>& frames, size_t capacity, RingDropPolicy policy) {
+    if (policy == RingDropPolicy::DropNewest) {
+        const size_t room = capacity > ring.size() ? capacity - ring.size() : 0;
+        const size_t accepted = std::min(room, frames.size());
+        ring.insert(ring.end(), frames.begin(), frames.begin() + accepted);
+        return frames.size() - accepted;
+    }
+    ring.insert(ring.end(), frames.begin(), frames.end());
+    uint64_t dropped = 0;
+    while (ring.size() > capacity) {
+        ring.pop_front();
+        dropped++;
+    }
+    return dropped;
+}
+
+int64_t SteadyNowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+const char* ReceiveModeName(ReceiveMode mode) {
+    return MODE_NAMES[static_cast<size_t>(mode)];
+}
+
+bool ParseReceiveMode(const std::string& name, ReceiveMode* mode) {
+    for (size_t i = 0; i < sizeof(MODE_NAMES) / sizeof(MODE_NAMES[0]); i++) {
+        if (name == MODE_NAMES[i]) {
+            *mode = static_cast<ReceiveMode>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* RingDropPolicyName(RingDropPolicy policy) {
+    return DROP_POLICY_NAMES[static_cast<size_t>(policy)];
+}
+
+bool ParseRingDropPolicy(const std::string& name, RingDropPolicy* policy) {
+    for (size_t i = 0; i < sizeof(DROP_POLICY_NAMES) / sizeof(DROP_POLICY_NAMES[0]); i++) {
+        if (name == DROP_POLICY_NAMES[i]) {
+            *policy = static_cast<RingDropPolicy>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+ReceivePump::ReceivePump(CHANNEL_HANDLE channelHandle, const ReceivePumpOptions& options)
+    : channelHandle_(channelHandle), options_(options), sharedRing_(options.sharedRing) {
+}
+
+ReceivePump::~ReceivePump() {
+    Stop();
+}
+
+void ReceivePump::Start() {
+    if (thread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopRequested_ = false;
+    }
+    running_.store(true);
+    thread_ = std::thread(&ReceivePump::Run, this);
+}
+
+void ReceivePump::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopRequested_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    // 唤醒等待中的Pop
+    {
+        std::lock_guard<std::mutex> lock(ringMutex_);
+        running_.store(false);
+    }
+    ringCv_.notify_all();
+}
+
+void ReceivePump::AddListener(FrameListener* listener) {
+    std::lock_guard<std::mutex> lock(listenersMutex_);
+    if (std::find(listeners_.begin(), listeners_.end(), listener) == listeners_.end()) {
+        listeners_.push_back(listener);
+    }
+}
+
+void ReceivePump::RemoveListener(FrameListener* listener) {
+    std::lock_guard<std::mutex> lock(listenersMutex_);
+    listeners_.erase(std::remove(listeners_.begin(), listeners_.end(), listener), listeners_.end());
+}
+
+size_t ReceivePump::ListenerCount() const {
+    std::lock_guard<std::mutex> lock(listenersMutex_);
+    return listeners_.size();
+}
+
+bool ReceivePump::Dispatch(const ZCAN_ReceiveFD_Data& frame, bool fd) {
+    for (FrameListener* listener : listeners_) {
+        if (listener->OnFrame(frame, fd)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ReceivePump::RecordPickup(uint64_t frameTimestampUs, int64_t hostUs) {
+    const int64_t offset = hostUs - static_cast<int64_t>(frameTimestampUs);
+    if (!offsetValid_ || offset - std::min(offsetMinUs_, offsetPrevMinUs_) > OFFSET_RESET_US) {
+        offsetWindowStartUs_ = hostUs;
+        offsetMinUs_ = offset;
+        offsetPrevMinUs_ = offset;
+        offsetValid_ = true;
+    } else if (hostUs - offsetWindowStartUs_ >= OFFSET_WINDOW_US) {
+        offsetWindowStartUs_ = hostUs;
+        offsetPrevMinUs_ = offsetMinUs_;
+        offsetMinUs_ = offset;
+    } else {
+        offsetMinUs_ = std::min(offsetMinUs_, offset);
+    }
+
+    const int64_t base = std::min(offsetMinUs_, offsetPrevMinUs_);
+    const uint64_t latencyNs = static_cast<uint64_t>(offset - base) * 1000;
+    latencyHistogram_[ApiHistBucket(latencyNs)].fetch_add(1, std::memory_order_relaxed);
+    if (latencyNs > latencyMaxNs_.load(std::memory_order_relaxed)) {
+        latencyMaxNs_.store(latencyNs, std::memory_order_relaxed);
+    }
+}
+
+void ReceivePump::Run() {
+    const UINT batchSize = std::max<UINT>(options_.batchSize, 1);
+    const UINT maxIdleSleepUs = std::max<UINT>(options_.idleSleepUs, 1);
+    const UINT minIdleSleepUs = std::min(std::max<UINT>(options_.minIdleSleepUs, 1), maxIdleSleepUs);
+    const int blockWaitMs = static_cast<int>(std::max<UINT>(options_.blockWaitMs, 1));
+    std::vector<ZCAN_Receive_Data> canFrames(batchSize);
+    std::vector<ZCAN_ReceiveFD_Data> fdFrames(batchSize);
+    std::vector<ZCAN_Receive_Data> canUnclaimed;
+    std::vector<ZCAN_ReceiveFD_Data> fdUnclaimed;
+    TraceSetThreadName("can-rx " + std::to_string(reinterpret_cast<uintptr_t>(channelHandle_.load())));
+    ThreadSchedulingScope scheduling(ThreadRole::Receive);
+
+    const auto startedAt = std::chrono::steady_clock::now();
+    const uint64_t cpuBaseNs = ThreadCpuTimeNs();
+    auto nextCpuSample = startedAt + CPU_SAMPLE_INTERVAL;
+    UINT idleSleepUs = minIdleSleepUs;
+    bool blockOnFd = false;     // Blocking：在最近有帧的类型上阻塞，另一类型不等待
+
+    while (true) {
+        const uint64_t wakeAt = ApiStatsNow();
+        const auto readAt = std::chrono::steady_clock::now();
+        const CHANNEL_HANDLE handle = channelHandle_.load();
+        UINT canCount = 0;
+        UINT fdCount = 0;
+        switch (options_.mode) {
+        case ReceiveMode::Blocking:
+            if (blockOnFd) {
+                fdCount = ZcanReceiveFD(handle, fdFrames.data(), batchSize, blockWaitMs);
+                canCount = ZcanReceive(handle, canFrames.data(), batchSize, 0);
+                blockOnFd = !(canCount > 0 && fdCount == 0);
+            } else {
+                canCount = ZcanReceive(handle, canFrames.data(), batchSize, blockWaitMs);
+                fdCount = ZcanReceiveFD(handle, fdFrames.data(), batchSize, 0);
+                blockOnFd = fdCount > 0 && canCount == 0;
+            }
+            break;
+        case ReceiveMode::Adaptive: {
+            // 查询比空读便宜，且只读取已到达的帧数
+            const UINT canPending = ZcanGetReceiveNum(handle, TYPE_CAN);
+            const UINT fdPending = ZcanGetReceiveNum(handle, TYPE_CANFD);
+            if (canPending > 0) {
+                canCount = ZcanReceive(handle, canFrames.data(), std::min(canPending, batchSize), 0);
+            }
+            if (fdPending > 0) {
+                fdCount = ZcanReceiveFD(handle, fdFrames.data(), std::min(fdPending, batchSize), 0);
+            }
+            break;
+        }
+        case ReceiveMode::BusyPoll:
+            canCount = ZcanReceive(handle, canFrames.data(), batchSize, 0);
+            fdCount = ZcanReceiveFD(handle, fdFrames.data(), batchSize, 0);
+            break;
+        }
+
+        const UINT received = canCount + fdCount;
+        if (received > 0) {
+            const int64_t hostUs = SteadyNowUs();
+            for (UINT i = 0; i < canCount; i++) {
+                RecordPickup(canFrames[i].timestamp, hostUs);
+            }
+            for (UINT i = 0; i < fdCount; i++) {
+                RecordPickup(fdFrames[i].timestamp, hostUs);
+            }
+        }
+
+        canUnclaimed.clear();
+        fdUnclaimed.clear();
+        {
+            std::lock_guard<std::mutex> lock(listenersMutex_);
+            for (UINT i = 0; i < canCount; i++) {
+                // 统一为CANFD结构交给监听者，__pad中的标志位与CANFD flags定义相同
+                ZCAN_ReceiveFD_Data frame;
+                memset(&frame, 0, sizeof(frame));
+                frame.frame.can_id = canFrames[i].frame.can_id;
+                frame.frame.len = canFrames[i].frame.can_dlc;
+                frame.frame.flags = canFrames[i].frame.__pad;
+                memcpy(frame.frame.data, canFrames[i].frame.data, CAN_MAX_DLEN);
+                frame.timestamp = canFrames[i].timestamp;
+                if (!Dispatch(frame, false)) {
+                    canUnclaimed.push_back(canFrames[i]);
+                }
+            }
+            for (UINT i = 0; i < fdCount; i++) {
+                if (!Dispatch(fdFrames[i], true)) {
+                    fdUnclaimed.push_back(fdFrames[i]);
+                }
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            for (FrameListener* listener : listeners_) {
+                listener->OnTick(now);
+            }
+        }
+
+        if (received > 0) {
+            framesReceived_ += received;
+            framesClaimed_ += received - canUnclaimed.size() - fdUnclaimed.size();
+            wakeups_++;
+        }
+
+        if (!canUnclaimed.empty() || !fdUnclaimed.empty()) {
+            uint64_t dropped = 0;
+            const uint64_t pushAt = ApiStatsNow();
+            {
+                std::lock_guard<std::mutex> lock(ringMutex_);
+                // 没有receive/receiveFD取帧方时不放入，避免缓冲写满后持续计入丢帧
+                if (sharedRing_) {
+                    dropped += PushBounded(canRing_, canUnclaimed, options_.ringCapacity, options_.dropPolicy);
+                    dropped += PushBounded(fdRing_, fdUnclaimed, options_.ringCapacity, options_.dropPolicy);
+                }
+                for (auto& entry : taps_) {
+                    Tap& tap = entry.second;
+                    tap.dropped += PushBounded(tap.canRing, canUnclaimed, tap.capacity, tap.policy);
+                    tap.dropped += PushBounded(tap.fdRing, fdUnclaimed, tap.capacity, tap.policy);
+                    if (tap.armed && tap.notifier && (!tap.canRing.empty() || !tap.fdRing.empty())) {
+                        tap.armed = false;
+                        tap.notifier();
+                    }
+                }
+            }
+            framesDropped_ += dropped;
+            ringCv_.notify_all();
+            if (TraceEnabled()) {
+                TraceComplete("ring.push", "rx", pushAt, ApiStatsNow(), canUnclaimed.size() + fdUnclaimed.size());
+                if (dropped > 0) {
+                    TraceInstant("ring.overflow", "rx", ApiStatsNow(), dropped);
+                }
+            }
+        }
+        if (received > 0 && TraceEnabled()) {
+            TraceComplete("rx.wakeup", "rx", wakeAt, ApiStatsNow(), received);
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= nextCpuSample) {
+            uptimeNs_.store(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - startedAt).count()), std::memory_order_relaxed);
+            cpuTimeNs_.store(ThreadCpuTimeNs() - cpuBaseNs, std::memory_order_relaxed);
+            nextCpuSample = now + CPU_SAMPLE_INTERVAL;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stopRequested_) {
+            break;
+        }
+        // Blocking已在驱动中等待；BusyPoll不休眠；本轮读满时立即继续读取
+        bool idle = false;
+        if (options_.mode == ReceiveMode::Adaptive && canCount < batchSize && fdCount < batchSize) {
+            idleSleepUs = received > 0 ? minIdleSleepUs : std::min(idleSleepUs * 2, maxIdleSleepUs);
+            idle = true;
+        } else if (options_.mode == ReceiveMode::Blocking && received == 0 && now - readAt < std::chrono::milliseconds(1)) {
+            // 驱动未等待即返回（通道未启动或复位中），避免空转
+            idleSleepUs = maxIdleSleepUs;
+            idle = true;
+        }
+        if (idle) {
+            const auto deadline = now + std::chrono::microseconds(idleSleepUs);
+            if (cv_.wait_until(lock, deadline, [this] { return stopRequested_; })) {
+                break;
+            }
+            ThreadSchedulingRecordWakeup(deadline);
+        } else if (options_.mode == ReceiveMode::BusyPoll) {
+            lock.unlock();
+            ZLGCAN_CPU_RELAX();
+        }
+    }
+}
+
+template <typename Frame>
+UINT ReceivePump::Pop(std::deque<Frame>& ring, Frame* frames, UINT count, int waitMs) {
+    const uint64_t popAt = ApiStatsNow();
+    std::unique_lock<std::mutex> lock(ringMutex_);
+    sharedRing_ = true;
+    if (ring.empty() && waitMs != 0) {
+        auto ready = [this, &ring] { return !ring.empty() || !running_.load(); };
+        if (waitMs < 0) {
+            ringCv_.wait(lock, ready);
+        } else {
+            ringCv_.wait_for(lock, std::chrono::milliseconds(waitMs), ready);
+        }
+    }
+
+    const UINT n = static_cast<UINT>(std::min<size_t>(count, ring.size()));
+    std::copy(ring.begin(), ring.begin() + n, frames);
+    ring.erase(ring.begin(), ring.begin() + n);
+    if (n > 0 && TraceEnabled()) {
+        TraceComplete("ring.pop", "rx", popAt, ApiStatsNow(), n);
+    }
+    return n;
+}
+
+UINT ReceivePump::PopCan(ZCAN_Receive_Data* frames, UINT count, int waitMs) {
+    return Pop(canRing_, frames, count, waitMs);
+}
+
+UINT ReceivePump::PopCanFD(ZCAN_ReceiveFD_Data* frames, UINT count, int waitMs) {
+    return Pop(fdRing_, frames, count, waitMs);
+}
+
+bool ReceivePump::WaitUnclaimed(std::chrono::steady_clock::time_point deadline) {
+    std::unique_lock<std::mutex> lock(ringMutex_);
+    sharedRing_ = true;
+    ringCv_.wait_until(lock, deadline, [this] { return !canRing_.empty() || !fdRing_.empty() || !running_.load(); });
+    return !canRing_.empty() || !fdRing_.empty();
+}
+
+UINT ReceivePump::OpenTap(UINT capacity, RingDropPolicy policy, std::function<void()> notifier) {
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    const UINT tapId = nextTapId_++;
+    Tap& tap = taps_[tapId];
+    tap.capacity = std::max<UINT>(capacity, 1);
+    tap.policy = policy;
+    tap.notifier = std::move(notifier);
+    return tapId;
+}
+
+void ReceivePump::CloseTap(UINT tapId) {
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    taps_.erase(tapId);
+}
+
+size_t ReceivePump::TapCount() const {
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    return taps_.size();
+}
+
+template <typename Frame>
+UINT ReceivePump::PopTap(UINT tapId, std::deque<Frame> Tap::*ring, Frame* frames, UINT count) {
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    auto it = taps_.find(tapId);
+    if (it == taps_.end()) {
+        return 0;
+    }
+    std::deque<Frame>& frameRing = it->second.*ring;
+    const UINT n = static_cast<UINT>(std::min<size_t>(count, frameRing.size()));
+    std::copy(frameRing.begin(), frameRing.begin() + n, frames);
+    frameRing.erase(frameRing.begin(), frameRing.begin() + n);
+    return n;
+}
+
+UINT ReceivePump::PopTapCan(UINT tapId, ZCAN_Receive_Data* frames, UINT count) {
+    return PopTap(tapId, &Tap::canRing, frames, count);
+}
+
+UINT ReceivePump::PopTapCanFD(UINT tapId, ZCAN_ReceiveFD_Data* frames, UINT count) {
+    return PopTap(tapId, &Tap::fdRing, frames, count);
+}
+
+bool ReceivePump::ArmTap(UINT tapId) {
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    auto it = taps_.find(tapId);
+    if (it == taps_.end()) {
+        return false;
+    }
+    Tap& tap = it->second;
+    if (!tap.canRing.empty() || !tap.fdRing.empty()) {
+        return true;
+    }
+    tap.armed = true;
+    return false;
+}
+
+bool ReceivePump::TapStats(UINT tapId, ReceiveTapStats* stats) const {
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    auto it = taps_.find(tapId);
+    if (it == taps_.end()) {
+        return false;
+    }
+    stats->canDepth = it->second.canRing.size();
+    stats->fdDepth = it->second.fdRing.size();
+    stats->dropped = it->second.dropped;
+    return true;
+}
+
+void ReceivePump::ClearRing() {
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    canRing_.clear();
+    fdRing_.clear();
+}
+
+ReceivePumpStats ReceivePump::Stats() const {
+    ReceivePumpStats stats;
+    stats.framesReceived = framesReceived_.load();
+    stats.framesClaimed = framesClaimed_.load();
+    stats.framesDropped = framesDropped_.load();
+    stats.wakeups = wakeups_.load();
+    stats.mode = options_.mode;
+    stats.uptimeUs = uptimeNs_.load(std::memory_order_relaxed) / 1000;
+    stats.cpuTimeUs = cpuTimeNs_.load(std::memory_order_relaxed) / 1000;
+    uint64_t histogram[API_HIST_BUCKETS];
+    uint64_t total = 0;
+    for (int i = 0; i < API_HIST_BUCKETS; i++) {
+        histogram[i] = latencyHistogram_[i].load(std::memory_order_relaxed);
+        total += histogram[i];
+    }
+    stats.latencySamples = total;
+    stats.latencyMaxUs = static_cast<double>(latencyMaxNs_.load(std::memory_order_relaxed)) / 1000;
+    // 分位数按桶上界估算，不超过实测最大值
+    stats.latencyP50Us = std::min(ApiHistPercentile(histogram, total, 0.5, 1.0) / 1000, stats.latencyMaxUs);
+    stats.latencyP99Us = std::min(ApiHistPercentile(histogram, total, 0.99, 1.0) / 1000, stats.latencyMaxUs);
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    stats.canRingDepth = canRing_.size();
+    stats.fdRingDepth = fdRing_.size();
+    return stats;
+}
@@ -0,0 +1,210 @@
+#ifndef ZLGCAN_RECEIVE_PUMP_H_
+#define ZLGCAN_RECEIVE_PUMP_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "api_stats.h"
+#include "zlgcan.h"
+
+// 驱动读取方式，在延迟与CPU占用之间取舍
+enum class ReceiveMode : uint8_t {
+    Blocking,       // ZCAN_Receive带等待时间阻塞读取，CPU占用最低，延迟取决于驱动的唤醒
+    Adaptive,       // 按ZCAN_GetReceiveNum决定读取量，空闲时等待间隔指数退避
+    BusyPoll,       // 不休眠持续读取，延迟最低，独占一个CPU核（宜配合线程调度绑定CPU）
+};
+
+const char* ReceiveModeName(ReceiveMode mode);
+bool ParseReceiveMode(const std::string& name, ReceiveMode* mode);
+
+// 接收缓冲写满（取帧方跟不上）时丢弃哪些帧
+enum class RingDropPolicy : uint8_t {
+    DropOldest,     // 保留最新的帧，适合监视界面
+    DropNewest,     // 保留缓冲中较早的连续序列，适合记录与分析
+};
+
+const char* RingDropPolicyName(RingDropPolicy policy);
+bool ParseRingDropPolicy(const std::string& name, RingDropPolicy* policy);
+
+// 接收线程配置
+struct ReceivePumpOptions {
+    UINT ringCapacity = 65536;         // 未被协议引擎认领的帧缓存上限（CAN和CANFD各一份），满时按dropPolicy丢弃
+    RingDropPolicy dropPolicy = RingDropPolicy::DropOldest;
+    bool sharedRing = true;            // 未认领的帧是否放入上述缓冲；为false时（只有帧流消费）首次PopCan/PopCanFD后才开始放入
+    UINT batchSize = 256;              // 单次从驱动读取的最大帧数
+    ReceiveMode mode = ReceiveMode::Adaptive;
+    UINT idleSleepUs = 200;            // Adaptive：空闲等待间隔上限
+    UINT minIdleSleepUs = 50;          // Adaptive：收到帧后的等待间隔，空闲时逐轮加倍到idleSleepUs
+    UINT blockWaitMs = 10;             // Blocking：单次读取的最长等待，也是停止线程的最长响应时间
+};
+
+// 接收线程统计
+struct ReceivePumpStats {
+    uint64_t framesReceived = 0;       // 从驱动读取的帧数
+    uint64_t framesClaimed = 0;        // 被协议引擎认领的帧数
+    uint64_t framesDropped = 0;        // 环形缓冲满时丢弃的帧数
+    uint64_t wakeups = 0;              // 读取到数据的轮询次数
+    size_t canRingDepth = 0;
+    size_t fdRingDepth = 0;
+
+    ReceiveMode mode = ReceiveMode::Adaptive;
+    uint64_t uptimeUs = 0;             // 线程运行时长，与cpuTimeUs同时更新（约每10ms）
+    uint64_t cpuTimeUs = 0;            // 线程累计CPU时间，两次采样之差除以运行时长之差即CPU占用
+
+    // 取帧延迟：帧的设备时间戳到被接收线程读出的时间差。设备与主机时钟的偏差未知，
+    // 以最近1~2s内的最小偏差为基准，结果是相对最快一帧的延迟，不含驱动固有的传输时间
+    uint64_t latencySamples = 0;
+    double latencyP50Us = 0;
+    double latencyP99Us = 0;
+    double latencyMaxUs = 0;
+};
+
+// 帧流缓冲统计
+struct ReceiveTapStats {
+    size_t canDepth = 0;
+    size_t fdDepth = 0;
+    uint64_t dropped = 0;              // 该帧流缓冲满时丢弃的帧数
+};
+
+/**
+ * 帧监听者（协议引擎）
+ * 回调在接收线程中执行，不能在回调中调用ReceivePump::RemoveListener。
+ */
+class FrameListener {
+public:
+    virtual ~FrameListener() = default;
+
+    // 返回true表示帧已被处理，不再进入接收环形缓冲。CAN帧同样以ZCAN_ReceiveFD_Data传入，
+    // fd为false，TX_ECHO等标志位于frame.flags
+    virtual bool OnFrame(const ZCAN_ReceiveFD_Data& frame, bool fd) = 0;
+
+    // 每轮轮询调用一次，用于超时检查
+    virtual void OnTick(std::chrono::steady_clock::time_point now) {}
+};
+
+/**
+ * 通道接收线程
+ * 在独立线程中持续读取驱动缓冲区，先交给已注册的协议引擎处理，
+ * 未被认领的帧放入有界环形缓冲，由JS侧的receive/receiveFD取出；帧流另有各自的缓冲。
+ */
+class ReceivePump {
+public:
+    ReceivePump(CHANNEL_HANDLE channelHandle, const ReceivePumpOptions& options);
+    ~ReceivePump();
+
+    ReceivePump(const ReceivePump&) = delete;
+    ReceivePump& operator=(const ReceivePump&) = delete;
+
+    void Start();
+    void Stop();
+    bool IsRunning() const { return thread_.joinable(); }
+
+    // 通道句柄变化时更新（例如设备重连后）
+    void SetChannelHandle(CHANNEL_HANDLE channelHandle) { channelHandle_.store(channelHandle); }
+
+    void AddListener(FrameListener* listener);
+    // 返回后不会再有该监听者的回调
+    void RemoveListener(FrameListener* listener);
+    size_t ListenerCount() const;
+
+    /**
+     * 取出未被认领的帧
+     * @param waitMs 缓冲为空时的等待时间，0不等待，小于0一直等待到有数据或线程停止
+     */
+    UINT PopCan(ZCAN_Receive_Data* frames, UINT count, int waitMs);
+    UINT PopCanFD(ZCAN_ReceiveFD_Data* frames, UINT count, int waitMs);
+    // 等待未认领的帧进入缓冲，至多到deadline；缓冲中有帧时返回true
+    bool WaitUnclaimed(std::chrono::steady_clock::time_point deadline);
+
+    void ClearRing();
+    ReceivePumpStats Stats() const;
+    UINT RingCapacity() const { return options_.ringCapacity; }
+    RingDropPolicy DropPolicy() const { return options_.dropPolicy; }
+
+    /**
+     * 打开帧流缓冲，返回帧流ID
+     * 接收线程把每个未认领的帧复制到各帧流缓冲，帧流之间及与PopCan/PopCanFD互不分取；
+     * 容量与丢弃策略各帧流独立。通知在接收线程中持有缓冲锁调用，只能投递消息（如TSFN
+     * NonBlockingCall），不能取帧
+     */
+    UINT OpenTap(UINT capacity, RingDropPolicy policy, std::function<void()> notifier);
+    // 返回后不会再有该帧流的通知
+    void CloseTap(UINT tapId);
+    size_t TapCount() const;
+
+    // 取出帧流缓冲中的帧，不等待
+    UINT PopTapCan(UINT tapId, ZCAN_Receive_Data* frames, UINT count);
+    UINT PopTapCanFD(UINT tapId, ZCAN_ReceiveFD_Data* frames, UINT count);
+
+    // 帧流缓冲已有帧时返回true；否则登记一次通知，下一批帧进入该缓冲时调用
+    bool ArmTap(UINT tapId);
+    // 帧流不存在时返回false
+    bool TapStats(UINT tapId, ReceiveTapStats* stats) const;
+
+private:
+    void Run();
+    bool Dispatch(const ZCAN_ReceiveFD_Data& frame, bool fd);
+    void RecordPickup(uint64_t frameTimestampUs, int64_t hostUs);
+
+    template <typename Frame>
+    UINT Pop(std::deque<Frame>& ring, Frame* frames, UINT count, int waitMs);
+
+    struct Tap {
+        UINT capacity;
+        RingDropPolicy policy;
+        std::deque<ZCAN_Receive_Data> canRing;
+        std::deque<ZCAN_ReceiveFD_Data> fdRing;
+        uint64_t dropped = 0;
+        std::function<void()> notifier;
+        bool armed = false;
+    };
+
+    template <typename Frame>
+    UINT PopTap(UINT tapId, std::deque<Frame> Tap::*ring, Frame* frames, UINT count);
+
+    std::atomic<CHANNEL_HANDLE> channelHandle_;
+    const ReceivePumpOptions options_;
+
+    mutable std::mutex listenersMutex_;
+    std::vector<FrameListener*> listeners_;
+
+    mutable std::mutex ringMutex_;
+    std::condition_variable ringCv_;
+    std::deque<ZCAN_Receive_Data> canRing_;
+    std::deque<ZCAN_ReceiveFD_Data> fdRing_;
+    bool sharedRing_;                      // 未认领的帧是否放入canRing_/fdRing_
+    std::map<UINT, Tap> taps_;
+    UINT nextTapId_ = 1;
+
+    std::atomic<uint64_t> framesReceived_{0};
+    std::atomic<uint64_t> framesClaimed_{0};
+    std::atomic<uint64_t> framesDropped_{0};
+    std::atomic<uint64_t> wakeups_{0};
+    std::atomic<bool> running_{false};     // Pop等待期间判断线程是否仍在运行
+
+    std::atomic<uint64_t> uptimeNs_{0};
+    std::atomic<uint64_t> cpuTimeNs_{0};
+    std::atomic<uint64_t> latencyMaxNs_{0};
+    std::atomic<uint64_t> latencyHistogram_[API_HIST_BUCKETS] = {};   // 纳秒
+    // 偏差基准窗口，仅接收线程访问
+    int64_t offsetWindowStartUs_ = 0;
+    int64_t offsetMinUs_ = 0;
+    int64_t offsetPrevMinUs_ = 0;
+    bool offsetValid_ = false;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopRequested_ = false;
+    std::thread thread_;
+};
+
+#endif  // ZLGCAN_RECEIVE_PUMP_H_
@@ -0,0 +1,533 @@
+#include "rest_bus_engine.h"
+#include "zlgcan_api.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <set>
+
+#include "thread_scheduling.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 时间轮槽数；周期超过槽数的报文在槽中停留多轮
+constexpr size_t WHEEL_SLOTS = 1024;
+
+constexpr uint64_t NOT_ENCODED = ~0ULL;
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "signal table sequence must be a plain 32-bit word");
+
+uint64_t ElapsedUs(Clock::time_point from, Clock::time_point to) {
+    return to > from ? static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(to - from).count()) : 0;
+}
+
+bool IsFdLength(size_t len) {
+    static const size_t lengths[] = {12, 16, 20, 24, 32, 48, 64};
+    return len <= 8 || std::find(std::begin(lengths), std::end(lengths), len) != std::end(lengths);
+}
+
+std::string DefaultName(UINT id) {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "0x%X", id & CAN_EFF_MASK);
+    return buffer;
+}
+
+}  // namespace
+
+// 写入位段：值的[valueShift, valueShift+bits)位写到data[byte]的[shift, shift+bits)位
+struct RestBusEngine::Segment {
+    BYTE byte;
+    BYTE shift;
+    BYTE bits;
+    BYTE valueShift;
+};
+
+// 信号或计数器的写入计划
+struct RestBusEngine::Plan {
+    std::vector<Segment> segments;
+    BYTE bitLength = 0;
+    bool isSigned = false;
+    double factor = 1;
+    double offset = 0;
+    UINT slot = 0;                     // 信号表序号
+
+    bool Compile(UINT startBit, BYTE length, RestBusByteOrder byteOrder, size_t frameLength) {
+        segments.clear();
+        bitLength = length;
+        if (byteOrder == RestBusByteOrder::Intel) {
+            for (UINT i = 0; i < length;) {
+                const UINT pos = startBit + i;
+                if (pos / 8 >= frameLength) {
+                    return false;
+                }
+                const BYTE bits = static_cast<BYTE>(std::min<UINT>(8 - pos % 8, length - i));
+                segments.push_back({static_cast<BYTE>(pos / 8), static_cast<BYTE>(pos % 8), bits, static_cast<BYTE>(i)});
+                i += bits;
+            }
+        } else {
+            // 从最高位开始，每个字节内由高位向低位，之后进入下一字节的最高位
+            UINT pos = startBit;
+            UINT remaining = length;
+            while (remaining > 0) {
+                if (pos / 8 >= frameLength) {
+                    return false;
+                }
+                const UINT shiftTop = pos % 8;
+                const BYTE bits = static_cast<BYTE>(std::min<UINT>(shiftTop + 1, remaining));
+                remaining -= bits;
+                segments.push_back({static_cast<BYTE>(pos / 8), static_cast<BYTE>(shiftTop + 1 - bits), bits,
+                                    static_cast<BYTE>(remaining)});
+                pos = (pos / 8 + 1) * 8 + 7;
+            }
+        }
+        return true;
+    }
+
+    void Write(BYTE* data, uint64_t raw) const {
+        for (const Segment& s : segments) {
+            const BYTE mask = static_cast<BYTE>(((1u << s.bits) - 1) << s.shift);
+            const BYTE value = static_cast<BYTE>(((raw >> s.valueShift) << s.shift) & mask);
+            data[s.byte] = static_cast<BYTE>((data[s.byte] & ~mask) | value);
+        }
+    }
+
+    // 物理值转换为原始值，超出位宽时取边界值
+    uint64_t ToRaw(double physical) const {
+        const double scaled = std::round((physical - offset) / factor);
+        if (isSigned) {
+            const double lo = -std::ldexp(1.0, bitLength - 1);
+            const double hi = std::ldexp(1.0, bitLength - 1) - 1;
+            const double clamped = std::max(lo, std::min(hi, scaled));
+            return static_cast<uint64_t>(static_cast<int64_t>(clamped));
+        }
+        const double hi = std::ldexp(1.0, bitLength) - 1;
+        const double clamped = std::max(0.0, std::min(hi, scaled));
+        return clamped >= 18446744073709551615.0 ? ~0ULL : static_cast<uint64_t>(clamped);
+    }
+};
+
+struct RestBusEngine::Message {
+    std::string name;
+    UINT id = 0;
+    bool fd = false;
+    bool brs = false;
+    std::vector<BYTE> data;
+    std::atomic<bool> enabled{true};
+
+    std::vector<Plan> signals;
+    uint64_t encodedVersion = NOT_ENCODED;
+
+    Plan counter;
+    bool hasCounter = false;
+    UINT counterValue = 0;
+    UINT counterMin = 0;
+    UINT counterMax = 0;
+    UINT counterStep = 1;
+
+    RestBusChecksum checksum;
+
+    bool hasE2e = false;
+    E2eConfig e2e;
+    uint32_t e2eCounter = 0;
+
+    uint64_t periodTicks = 1;
+    uint64_t nextTick = 0;
+};
+
+RestBusEngine::RestBusEngine(CHANNEL_HANDLE channelHandle, const RestBusOptions& options)
+    : channelHandle_(channelHandle), options_(options), wheel_(WHEEL_SLOTS) {}
+
+RestBusEngine::~RestBusEngine() {
+    Stop();
+}
+
+bool RestBusEngine::Load(const std::vector<RestBusMessage>& messages, std::string* error) {
+    const UINT tickUs = std::max<UINT>(1, options_.tickUs);
+    std::vector<std::unique_ptr<Message>> compiled;
+    std::vector<std::string> names;
+    std::vector<double> initial;
+    std::set<std::string> messageNames;
+
+    for (const RestBusMessage& config : messages) {
+        auto message = std::make_unique<Message>();
+        message->name = config.name.empty() ? DefaultName(config.id) : config.name;
+        message->id = config.id;
+        message->fd = config.fd;
+        message->brs = config.fd && config.brs;
+        message->data = config.data;
+        message->enabled.store(config.enabled);
+        const std::string& name = message->name;
+
+        if (!messageNames.insert(name).second) {
+            *error = "报文名" + name + "重复";
+            return false;
+        }
+        if (config.periodUs == 0) {
+            *error = "报文" + name + "的周期必须大于0";
+            return false;
+        }
+        const size_t len = message->data.size();
+        if (len == 0 || (config.fd ? !IsFdLength(len) : len > 8)) {
+            *error = "报文" + name + "的数据长度无效";
+            return false;
+        }
+
+        for (const RestBusSignal& signal : config.signals) {
+            Plan plan;
+            plan.isSigned = signal.isSigned;
+            plan.factor = signal.factor;
+            plan.offset = signal.offset;
+            plan.slot = static_cast<UINT>(names.size());
+            if (signal.bitLength == 0 || signal.bitLength > 64 || signal.factor == 0) {
+                *error = "信号" + name + "." + signal.name + "的位长或系数无效";
+                return false;
+            }
+            if (!plan.Compile(signal.startBit, signal.bitLength, signal.byteOrder, len)) {
+                *error = "信号" + name + "." + signal.name + "超出报文长度";
+                return false;
+            }
+            const std::string key = name + "." + signal.name;
+            if (std::find(names.begin(), names.end(), key) != names.end()) {
+                *error = "信号" + key + "重复";
+                return false;
+            }
+            names.push_back(key);
+            initial.push_back(signal.initial);
+            message->signals.push_back(std::move(plan));
+        }
+
+        if (config.counter.bitLength > 0) {
+            const RestBusCounter& counter = config.counter;
+            const UINT limit = counter.bitLength >= 32 ? 0xFFFFFFFFu : (1u << counter.bitLength) - 1;
+            message->hasCounter = true;
+            message->counterMin = counter.min;
+            message->counterMax = counter.max == 0 ? limit : counter.max;
+            message->counterStep = std::max<UINT>(1, counter.step);
+            message->counterValue = counter.min;
+            if (counter.bitLength > 32 || message->counterMax > limit || counter.min > message->counterMax) {
+                *error = "报文" + name + "的计数器范围无效";
+                return false;
+            }
+            if (!message->counter.Compile(counter.startBit, counter.bitLength, counter.byteOrder, len)) {
+                *error = "报文" + name + "的计数器超出报文长度";
+                return false;
+            }
+        }
+
+        message->checksum = config.checksum;
+        if (config.checksum.type != RestBusChecksumType::None) {
+            const RestBusChecksum& checksum = config.checksum;
+            if (checksum.byte >= len || checksum.start >= len ||
+                (checksum.length > 0 && checksum.start + checksum.length > len)) {
+                *error = "报文" + name + "的校验和范围无效";
+                return false;
+            }
+            if (checksum.length == 0) {
+                message->checksum.length = static_cast<UINT>(len - checksum.start);
+            }
+        }
+
+        message->hasE2e = config.e2e;
+        message->e2e = config.e2eConfig;
+        if (config.e2e) {
+            std::vector<BYTE> probe(message->data);
+            if (!E2eProtect(config.e2eConfig, probe.data(), probe.size(), 0)) {
+                *error = "报文" + name + "的长度不足以容纳E2E头";
+                return false;
+            }
+        }
+
+        message->periodTicks = std::max<uint64_t>(1, (config.periodUs + tickUs / 2) / tickUs);
+        message->nextTick = (config.offsetUs + tickUs / 2) / tickUs;
+        compiled.push_back(std::move(message));
+    }
+
+    messages_ = std::move(compiled);
+    signalNames_ = std::move(names);
+    initialValues_ = std::move(initial);
+    return true;
+}
+
+void RestBusEngine::Start(void* table) {
+    if (thread_.joinable()) {
+        return;
+    }
+    table_ = static_cast<BYTE*>(table);
+    snapshot_ = initialValues_;
+    scratch_.resize(initialValues_.size());
+    snapshotSequence_ = 0;
+    snapshotVersion_ = 0;
+    for (auto& slot : wheel_) {
+        slot.clear();
+    }
+    for (UINT i = 0; i < messages_.size(); i++) {
+        messages_[i]->encodedVersion = NOT_ENCODED;
+        Schedule(i);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopRequested_ = false;
+        stats_ = RestBusStats();
+    }
+    thread_ = std::thread(&RestBusEngine::Run, this);
+}
+
+void RestBusEngine::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopRequested_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool RestBusEngine::SetEnabled(const std::string& name, bool enabled) {
+    for (auto& message : messages_) {
+        if (message->name == name) {
+            message->enabled.store(enabled);
+            return true;
+        }
+    }
+    return false;
+}
+
+RestBusStats RestBusEngine::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+BYTE RestBusEngine::Crc8(const BYTE* data, size_t length) {
+    return static_cast<BYTE>(E2eCrc8(data, length, 0xFF) ^ 0xFF);
+}
+
+void RestBusEngine::Schedule(UINT messageIndex) {
+    wheel_[messages_[messageIndex]->nextTick % WHEEL_SLOTS].push_back(messageIndex);
+}
+
+bool RestBusEngine::WaitUntil(Clock::time_point deadline) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // 系统睡眠的粒度较粗，最后spinUs改为让出时间片的自旋
+    const auto sleepUntil = deadline - std::chrono::microseconds(options_.spinUs);
+    if (cv_.wait_until(lock, sleepUntil, [this] { return stopRequested_; })) {
+        return false;
+    }
+    lock.unlock();
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    lock.lock();
+    return !stopRequested_;
+}
+
+uint64_t RestBusEngine::NextWakeTick(uint64_t tick) const {
+    // 找到下一个有报文到期的刻度；全部报文都在一轮之后时取最早的到期刻度
+    uint64_t earliest = ~0ULL;
+    for (uint64_t t = tick; t < tick + WHEEL_SLOTS; t++) {
+        for (UINT index : wheel_[t % WHEEL_SLOTS]) {
+            const uint64_t next = messages_[index]->nextTick;
+            if (next == t) {
+                return t;
+            }
+            earliest = std::min(earliest, next);
+        }
+    }
+    return earliest == ~0ULL ? tick + WHEEL_SLOTS : earliest;
+}
+
+void RestBusEngine::TakeSnapshot(RestBusStats* stats) {
+    if (snapshot_.empty()) {
+        return;
+    }
+    // 序号与JS侧Atomics对同一Int32写入，奇数表示写入未完成
+    auto* sequence = reinterpret_cast<std::atomic<uint32_t>*>(table_);
+    const uint32_t before = sequence->load(std::memory_order_acquire);
+    if (before == snapshotSequence_) {
+        return;
+    }
+    if (before & 1) {
+        stats->snapshotRetries++;
+        return;
+    }
+    std::memcpy(scratch_.data(), table_ + TABLE_HEADER_BYTES, scratch_.size() * sizeof(double));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence->load(std::memory_order_relaxed) != before) {
+        stats->snapshotRetries++;
+        return;
+    }
+    snapshot_.swap(scratch_);
+    snapshotSequence_ = before;
+    snapshotVersion_++;
+    stats->signalSnapshots++;
+}
+
+void RestBusEngine::Encode(Message& message) {
+    BYTE* data = message.data.data();
+
+    // 信号只在信号表更新后重新写入
+    if (message.encodedVersion != snapshotVersion_) {
+        for (const Plan& signal : message.signals) {
+            const double value = snapshot_[signal.slot];
+            if (!std::isnan(value)) {
+                signal.Write(data, signal.ToRaw(value));
+            }
+        }
+        message.encodedVersion = snapshotVersion_;
+    }
+
+    if (message.hasCounter) {
+        message.counter.Write(data, message.counterValue);
+        const uint64_t next = static_cast<uint64_t>(message.counterValue) + message.counterStep;
+        message.counterValue = next > message.counterMax
+            ? message.counterMin + static_cast<UINT>((next - message.counterMax - 1) %
+                                                     (static_cast<uint64_t>(message.counterMax) - message.counterMin + 1))
+            : static_cast<UINT>(next);
+    }
+
+    const RestBusChecksum& checksum = message.checksum;
+    if (checksum.type != RestBusChecksumType::None) {
+        BYTE value = 0;
+        const UINT end = checksum.start + checksum.length;
+        switch (checksum.type) {
+            case RestBusChecksumType::Sum8:
+                for (UINT i = checksum.start; i < end; i++) {
+                    value = static_cast<BYTE>(value + (i == checksum.byte ? 0 : data[i]));
+                }
+                break;
+            case RestBusChecksumType::Xor8:
+                for (UINT i = checksum.start; i < end; i++) {
+                    value ^= i == checksum.byte ? 0 : data[i];
+                }
+                break;
+            case RestBusChecksumType::Crc8: {
+                // 校验字节在范围内时分两段计算
+                uint8_t crc = 0xFF;
+                if (checksum.byte >= checksum.start && checksum.byte < end) {
+                    crc = E2eCrc8(data + checksum.start, checksum.byte - checksum.start, crc);
+                    crc = E2eCrc8(data + checksum.byte + 1, end - checksum.byte - 1, crc);
+                } else {
+                    crc = E2eCrc8(data + checksum.start, checksum.length, crc);
+                }
+                value = static_cast<BYTE>(crc ^ 0xFF);
+                break;
+            }
+            default:
+                break;
+        }
+        data[checksum.byte] = value;
+    }
+
+    // E2E头最后写入，CRC覆盖前面写入的信号、计数器和校验和
+    if (message.hasE2e) {
+        E2eProtect(message.e2e, data, message.data.size(), message.e2eCounter);
+        message.e2eCounter = static_cast<uint32_t>((uint64_t(message.e2eCounter) + 1) % E2eCounterModulo(message.e2e.profile));
+    }
+
+    if (message.fd) {
+        ZCAN_TransmitFD_Data frame;
+        std::memset(&frame, 0, sizeof(frame));
+        frame.frame.can_id = message.id;
+        frame.frame.len = static_cast<BYTE>(message.data.size());
+        frame.frame.flags = message.brs ? CANFD_BRS : 0;
+        std::memcpy(frame.frame.data, data, message.data.size());
+        fdBatch_.push_back(frame);
+    } else {
+        ZCAN_Transmit_Data frame;
+        std::memset(&frame, 0, sizeof(frame));
+        frame.frame.can_id = message.id;
+        frame.frame.can_dlc = static_cast<BYTE>(message.data.size());
+        std::memcpy(frame.frame.data, data, message.data.size());
+        canBatch_.push_back(frame);
+    }
+}
+
+void RestBusEngine::Transmit(RestBusStats* stats) {
+    const CHANNEL_HANDLE handle = channelHandle_.load();
+    if (!fdBatch_.empty()) {
+        const UINT total = static_cast<UINT>(fdBatch_.size());
+        const UINT sent = ZcanTransmitFD(handle, fdBatch_.data(), total);
+        stats->transmitCalls++;
+        stats->failedFrames += total - std::min(sent, total);
+    }
+    if (!canBatch_.empty()) {
+        const UINT total = static_cast<UINT>(canBatch_.size());
+        const UINT sent = ZcanTransmit(handle, canBatch_.data(), total);
+        stats->transmitCalls++;
+        stats->failedFrames += total - std::min(sent, total);
+    }
+    stats->frames += fdBatch_.size() + canBatch_.size();
+    stats->maxFramesPerTick = std::max<uint64_t>(stats->maxFramesPerTick, fdBatch_.size() + canBatch_.size());
+}
+
+void RestBusEngine::Run() {
+    ThreadSchedulingScope scheduling(ThreadRole::Transmit);
+    const auto tickDuration = std::chrono::microseconds(std::max<UINT>(1, options_.tickUs));
+    const Clock::time_point start = Clock::now();
+    std::vector<UINT> kept;
+    uint64_t tick = 0;
+
+    while (true) {
+        const uint64_t wake = NextWakeTick(tick);
+        const Clock::time_point deadline = start + tickDuration * wake;
+        if (!WaitUntil(deadline)) {
+            break;
+        }
+        ThreadSchedulingRecordWakeup(deadline);
+
+        const Clock::time_point now = Clock::now();
+        const uint64_t current = std::max<uint64_t>(wake, static_cast<uint64_t>((now - start) / tickDuration));
+        const uint64_t latenessUs = ElapsedUs(deadline, now);
+
+        // 取出[tick, current]内到期的报文；落后超过一轮时每个槽只需检查一次
+        due_.clear();
+        const uint64_t last = std::min(current, tick + WHEEL_SLOTS - 1);
+        for (uint64_t t = tick; t <= last; t++) {
+            std::vector<UINT>& slot = wheel_[t % WHEEL_SLOTS];
+            kept.clear();
+            for (UINT index : slot) {
+                (messages_[index]->nextTick <= current ? due_ : kept).push_back(index);
+            }
+            slot.swap(kept);
+        }
+        tick = current + 1;
+        if (due_.empty()) {
+            continue;
+        }
+
+        RestBusStats delta;
+        TakeSnapshot(&delta);
+
+        fdBatch_.clear();
+        canBatch_.clear();
+        for (UINT index : due_) {
+            Message& message = *messages_[index];
+            if (message.enabled.load(std::memory_order_relaxed)) {
+                Encode(message);
+            }
+            // 保持原相位；线程延迟超过一个周期时跳过错过的发送，不补发
+            const uint64_t behind = current - message.nextTick;
+            delta.skippedCycles += behind / message.periodTicks;
+            message.nextTick += (behind / message.periodTicks + 1) * message.periodTicks;
+            Schedule(index);
+        }
+        Transmit(&delta);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.ticks++;
+        stats_.frames += delta.frames;
+        stats_.transmitCalls += delta.transmitCalls;
+        stats_.failedFrames += delta.failedFrames;
+        stats_.skippedCycles += delta.skippedCycles;
+        stats_.maxFramesPerTick = std::max(stats_.maxFramesPerTick, delta.maxFramesPerTick);
+        stats_.signalSnapshots += delta.signalSnapshots;
+        stats_.snapshotRetries += delta.snapshotRetries;
+        stats_.maxLatenessUs = std::max(stats_.maxLatenessUs, latenessUs);
+        if (latenessUs > static_cast<uint64_t>(tickDuration.count())) {
+            stats_.lateTicks++;
+        }
+    }
+}
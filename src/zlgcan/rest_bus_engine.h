@@ -0,0 +1,175 @@
+#ifndef ZLGCAN_REST_BUS_ENGINE_H_
+#define ZLGCAN_REST_BUS_ENGINE_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "zlgcan.h"
+#include "e2e_protection.h"
+
+// 信号和计数器的字节序：Intel为小端，Motorola为大端（起始位为DBC约定的最高位）
+enum class RestBusByteOrder : uint8_t { Intel, Motorola };
+
+// 报文中的信号，物理值 = 原始值 * factor + offset
+struct RestBusSignal {
+    std::string name;
+    UINT startBit = 0;
+    BYTE bitLength = 0;                // 1~64
+    RestBusByteOrder byteOrder = RestBusByteOrder::Intel;
+    bool isSigned = false;
+    double factor = 1;
+    double offset = 0;
+    double initial = 0;                // 信号表中的初始物理值
+};
+
+// 循环计数器（alive counter），每次发送前加step，超过max后回到min
+struct RestBusCounter {
+    UINT startBit = 0;
+    BYTE bitLength = 0;                // 0表示报文没有计数器
+    RestBusByteOrder byteOrder = RestBusByteOrder::Intel;
+    UINT min = 0;
+    UINT max = 0;                      // 0表示位宽的最大值
+    UINT step = 1;
+};
+
+// 校验和类型
+enum class RestBusChecksumType : uint8_t {
+    None,
+    Sum8,                              // 字节和的低8位
+    Xor8,                              // 字节异或
+    Crc8,                              // SAE J1850（多项式0x1D，初值和结果异或值0xFF）
+};
+
+// 校验和，在信号和计数器写入后计算，覆盖[start, start+length)中除校验字节外的字节
+struct RestBusChecksum {
+    RestBusChecksumType type = RestBusChecksumType::None;
+    UINT byte = 0;                     // 校验和所在字节
+    UINT start = 0;
+    UINT length = 0;                   // 0表示到报文末尾
+};
+
+// 周期报文
+struct RestBusMessage {
+    std::string name;                  // 信号表键的前缀，默认为十六进制ID
+    UINT id = 0;                       // 带CAN_EFF_FLAG表示扩展帧
+    bool fd = false;
+    bool brs = false;
+    std::vector<BYTE> data;            // 初始数据，长度即报文长度
+    UINT periodUs = 0;
+    UINT offsetUs = 0;                 // 首次发送相对启动的偏移，用于错开同周期的报文
+    bool enabled = true;
+    std::vector<RestBusSignal> signals;
+    RestBusCounter counter;
+    RestBusChecksum checksum;
+    bool e2e = false;                  // 在校验和之后写入E2E头
+    E2eConfig e2eConfig;
+};
+
+// 引擎配置
+struct RestBusOptions {
+    UINT tickUs = 1000;                // 时间轮刻度，周期和偏移按刻度取整
+    UINT spinUs = 1000;                // 到期前最后这段时间自旋等待，0为只睡眠
+};
+
+// 统计
+struct RestBusStats {
+    uint64_t ticks = 0;                // 有报文到期的刻度数
+    uint64_t frames = 0;
+    uint64_t transmitCalls = 0;
+    uint64_t failedFrames = 0;         // 驱动未接受的帧
+    uint64_t skippedCycles = 0;        // 线程延迟超过一个周期而跳过的发送
+    uint64_t lateTicks = 0;            // 唤醒晚于到期时间一个刻度以上的次数
+    uint64_t maxLatenessUs = 0;
+    uint64_t maxFramesPerTick = 0;
+    uint64_t signalSnapshots = 0;      // 读取到的信号表更新次数
+    uint64_t snapshotRetries = 0;      // 读取时正在写入而沿用旧值的次数
+};
+
+/**
+ * 残余总线仿真引擎
+ * 单个线程按时间轮调度全部周期报文：同一刻度到期的报文写入信号值、更新计数器和校验和后，
+ * 以一次ZCAN_TransmitFD（经典帧为一次ZCAN_Transmit）批量发出。
+ * 信号值来自JS共享的信号表：头部为写入序号（奇数表示正在写入），之后为按信号序号排列的
+ * double物理值；引擎在序号为偶数且读取前后一致时取快照，保证一次更新的多个信号同时生效。
+ */
+class RestBusEngine {
+public:
+    // 信号表头部字节数，之后为double数组
+    static constexpr size_t TABLE_HEADER_BYTES = 8;
+
+    RestBusEngine(CHANNEL_HANDLE channelHandle, const RestBusOptions& options);
+    ~RestBusEngine();
+
+    RestBusEngine(const RestBusEngine&) = delete;
+    RestBusEngine& operator=(const RestBusEngine&) = delete;
+
+    /**
+     * 加载报文集并编译信号、计数器的写入计划
+     * @return 配置无效时返回false并设置error
+     */
+    bool Load(const std::vector<RestBusMessage>& messages, std::string* error);
+
+    // 信号表中的信号名（"报文名.信号名"）及初始值，按信号序号排列
+    const std::vector<std::string>& SignalNames() const { return signalNames_; }
+    const std::vector<double>& InitialValues() const { return initialValues_; }
+    static size_t TableBytes(size_t signalCount) { return TABLE_HEADER_BYTES + signalCount * sizeof(double); }
+
+    // table由调用方持有，须在Stop()之后释放
+    void Start(void* table);
+    void Stop();
+
+    // 按报文名启用或停用，返回是否找到
+    bool SetEnabled(const std::string& name, bool enabled);
+
+    RestBusStats Stats() const;
+
+    void SetChannelHandle(CHANNEL_HANDLE channelHandle) { channelHandle_.store(channelHandle); }
+
+    static BYTE Crc8(const BYTE* data, size_t length);
+
+private:
+    struct Segment;
+    struct Plan;
+    struct Message;
+
+    void Run();
+    bool WaitUntil(std::chrono::steady_clock::time_point deadline);
+    uint64_t NextWakeTick(uint64_t tick) const;
+    void Schedule(UINT messageIndex);
+    void TakeSnapshot(RestBusStats* stats);
+    void Encode(Message& message);
+    void Transmit(RestBusStats* stats);
+
+    std::atomic<CHANNEL_HANDLE> channelHandle_;
+    const RestBusOptions options_;
+
+    std::vector<std::unique_ptr<Message>> messages_;
+    std::vector<std::string> signalNames_;
+    std::vector<double> initialValues_;
+
+    // 时间轮和发送缓冲，仅引擎线程访问
+    std::vector<std::vector<UINT>> wheel_;
+    std::vector<UINT> due_;
+    std::vector<ZCAN_Transmit_Data> canBatch_;
+    std::vector<ZCAN_TransmitFD_Data> fdBatch_;
+    BYTE* table_ = nullptr;
+    std::vector<double> snapshot_;
+    std::vector<double> scratch_;
+    uint32_t snapshotSequence_ = 0;
+    uint64_t snapshotVersion_ = 0;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopRequested_ = false;
+    RestBusStats stats_;
+    std::thread thread_;
+};
+
+#endif  // ZLGCAN_REST_BUS_ENGINE_H_
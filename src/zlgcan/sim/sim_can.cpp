@@ -0,0 +1,1588 @@
+#include "sim_can.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int64_t NEVER = INT64_MAX;
+constexpr UINT DEFAULT_ABIT = 500000;
+constexpr UINT DEFAULT_DBIT = 2000000;
+constexpr size_t DEFAULT_RX_CAPACITY = 65536;
+constexpr size_t DEFAULT_TX_CAPACITY = 4096;
+constexpr UINT ERROR_WARNING_LIMIT = 96;
+constexpr UINT ERROR_PASSIVE_LIMIT = 128;
+constexpr UINT BUS_OFF_LIMIT = 256;
+constexpr int64_t ERROR_FRAME_BITS = 6 + 8 + 3;    // 错误标志 + 错误界定符 + 帧间隔
+constexpr int64_t FRAME_TAIL_BITS = 1 + 1 + 1 + 7 + 3;  // CRC界定符 + ACK + ACK界定符 + EOF + 帧间隔
+constexpr BYTE TX_ONLY_FLAGS = TX_DELAY_SEND_FLAG | TX_DELAY_SEND_TIME_UNIT_FLAG | TX_ECHO_FLAG;
+
+const BYTE FD_LENGTHS[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+
+int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+Clock::time_point ToTimePoint(int64_t ns) {
+    return Clock::time_point(std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(ns)));
+}
+
+BYTE FdDlc(BYTE length) {
+    for (BYTE dlc = 0; dlc < 16; dlc++) {
+        if (FD_LENGTHS[dlc] >= length) {
+            return dlc;
+        }
+    }
+    return 15;
+}
+
+// 带位填充的位计数，phase 0为仲裁段，1为数据段
+class BitCounter {
+public:
+    void Push(uint32_t value, int width) {
+        for (int i = width - 1; i >= 0; i--) {
+            PushBit(static_cast<int>((value >> i) & 1));
+        }
+    }
+
+    void PushBit(int bit) {
+        bits_[phase_]++;
+        if (crc15_) {
+            const int next = bit ^ ((crc_ >> 14) & 1);
+            crc_ = (crc_ << 1) & 0x7FFF;
+            if (next) {
+                crc_ ^= 0x4599;
+            }
+        }
+        if (bit == last_) {
+            if (++run_ == 5) {
+                bits_[phase_]++;
+                last_ = !bit;
+                run_ = 1;
+            }
+        } else {
+            last_ = bit;
+            run_ = 1;
+        }
+    }
+
+    // 不参与填充的位（FD的CRC段和帧尾）
+    void AddFixed(int64_t count) { bits_[phase_] += count; }
+
+    void EnableCrc15() { crc15_ = true; }
+    uint32_t Crc15() { crc15_ = false; return crc_; }
+    void SetPhase(int phase) { phase_ = phase; }
+    int64_t Bits(int phase) const { return bits_[phase]; }
+
+private:
+    int64_t bits_[2] = {0, 0};
+    int phase_ = 0;
+    int last_ = -1;
+    int run_ = 0;
+    bool crc15_ = false;
+    uint32_t crc_ = 0;
+};
+
+// 仲裁键，越小越优先；按线上位序排列：基本ID、RTR/SRR、IDE、扩展ID、RTR
+uint64_t ArbitrationKey(const canfd_frame& frame, bool fd) {
+    const UINT id = frame.can_id;
+    const bool rtr = !fd && (id & CAN_RTR_FLAG);
+    if (id & CAN_EFF_FLAG) {
+        const UINT ext = id & CAN_EFF_MASK;
+        return (static_cast<uint64_t>(ext >> 18) << 21) | (1ULL << 20) | (1ULL << 19) |
+               (static_cast<uint64_t>(ext & 0x3FFFF) << 1) | (rtr ? 1 : 0);
+    }
+    return (static_cast<uint64_t>(id & CAN_SFF_MASK) << 21) | (rtr ? (1ULL << 20) : 0);
+}
+
+bool ParseUint(const std::string& text, uint64_t* value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    *value = std::strtoull(text.c_str(), &end, 0);
+    return end != nullptr && *end == '\0';
+}
+
+bool ParseRate(const std::string& text, double* value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    *value = std::strtod(text.c_str(), &end);
+    return end != nullptr && *end == '\0' && *value >= 0 && *value <= 1;
+}
+
+// SJA1000风格的BTR0/BTR1换算为位速率（16MHz晶振）
+UINT TimingToBitrate(BYTE timing0, BYTE timing1) {
+    const UINT brp = (timing0 & 0x3F) + 1;
+    const UINT tseg1 = (timing1 & 0x0F) + 1;
+    const UINT tseg2 = ((timing1 >> 4) & 0x07) + 1;
+    return 8000000 / (brp * (1 + tseg1 + tseg2));
+}
+
+// "id=0x123;len=8;period_us=1000;count=0;fd=1;brs=1;pattern=counter;data=01 02"
+bool ParseGenerator(const std::string& spec, SimGenerator* generator) {
+    size_t pos = 0;
+    bool hasId = false;
+    bool ext = false;
+    while (pos <= spec.size()) {
+        size_t end = spec.find(';', pos);
+        if (end == std::string::npos) {
+            end = spec.size();
+        }
+        const std::string item = spec.substr(pos, end - pos);
+        pos = end + 1;
+        if (item.empty()) {
+            continue;
+        }
+        const size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            return false;
+        }
+        const std::string key = item.substr(0, eq);
+        const std::string value = item.substr(eq + 1);
+        uint64_t number = 0;
+        if (key == "pattern") {
+            if (value == "fixed") {
+                generator->pattern = SimGenerator::Pattern::Fixed;
+            } else if (value == "counter") {
+                generator->pattern = SimGenerator::Pattern::Counter;
+            } else if (value == "random") {
+                generator->pattern = SimGenerator::Pattern::Random;
+            } else {
+                return false;
+            }
+        } else if (key == "data") {
+            generator->data.clear();
+            const char* cursor = value.c_str();
+            while (*cursor != '\0') {
+                if (*cursor == ' ') {
+                    cursor++;
+                    continue;
+                }
+                char* next = nullptr;
+                const unsigned long byte = std::strtoul(cursor, &next, 16);
+                if (next == cursor || byte > 0xFF) {
+                    return false;
+                }
+                generator->data.push_back(static_cast<BYTE>(byte));
+                cursor = next;
+            }
+        } else if (!ParseUint(value, &number)) {
+            return false;
+        } else if (key == "id") {
+            generator->id = static_cast<UINT>(number);
+            hasId = true;
+        } else if (key == "len") {
+            generator->length = static_cast<BYTE>(std::min<uint64_t>(number, CANFD_MAX_DLEN));
+        } else if (key == "period_us") {
+            generator->periodNs = number * 1000;
+        } else if (key == "count") {
+            generator->count = number;
+        } else if (key == "fd") {
+            generator->fd = number != 0;
+        } else if (key == "brs") {
+            generator->brs = number != 0;
+        } else if (key == "ext") {
+            ext = number != 0;
+        } else {
+            return false;
+        }
+    }
+    if (!hasId || generator->periodNs == 0) {
+        return false;
+    }
+    if (ext || generator->id > CAN_SFF_MASK) {
+        generator->id = (generator->id & CAN_EFF_MASK) | CAN_EFF_FLAG;
+    }
+    if (!generator->fd) {
+        generator->brs = false;
+        generator->length = std::min<BYTE>(generator->length, CAN_MAX_DLEN);
+    } else {
+        generator->length = FD_LENGTHS[FdDlc(generator->length)];
+    }
+    return true;
+}
+
+}  // namespace
+
+// ==================== 内部结构 ====================
+
+struct SimCan::TxFrame {
+    canfd_frame frame{};
+    bool fd = false;
+    bool singleShot = false;
+    bool echo = false;
+    int64_t readyNs = 0;
+};
+
+struct SimCan::Channel {
+    Device* device = nullptr;
+    UINT index = 0;
+    uint64_t serial = 0;               // 每次StartCAN重新分配，总线线程据此判断通道是否仍有效
+    bool initialized = false;
+    bool started = false;
+    bool canfd = false;
+    bool listenOnly = false;
+    bool baudSet = false;
+    UINT abit = DEFAULT_ABIT;
+    UINT dbit = DEFAULT_DBIT;
+    UINT busId = 0;
+    Bus* bus = nullptr;
+
+    std::deque<TxFrame> tx;
+    int64_t lastDelayedNs = 0;
+    size_t txCapacity = DEFAULT_TX_CAPACITY;
+    std::deque<ZCAN_Receive_Data> rxCan;
+    std::deque<ZCAN_ReceiveFD_Data> rxFd;
+    size_t rxCapacity = DEFAULT_RX_CAPACITY;
+    std::condition_variable rxCv;
+
+    UINT tec = 0;
+    UINT rec = 0;
+    UINT errorCode = 0;
+    BYTE nodeState = ZCAN_NODE_STATE_ACTIVE;
+};
+
+struct SimCan::Device {
+    UINT type = 0;
+    UINT index = 0;
+    int64_t epochNs = 0;
+    double clockPpm = 0;
+    bool online = true;
+    bool closing = false;
+    int waiters = 0;
+    std::vector<std::unique_ptr<Channel>> channels;
+
+    bool merged = false;
+    std::deque<ZCANDataObj> mergedRx;
+    std::condition_variable mergedCv;
+
+    std::map<std::string, std::string> values;
+};
+
+struct SimCan::Bus {
+    UINT id = 0;
+    std::vector<Channel*> members;     // 已启动的通道
+    std::thread thread;
+    uint64_t generation = 0;
+    bool running = false;
+    std::condition_variable cv;
+    int64_t freeAt = 0;
+
+    bool realtime = true;
+    double load = 0;
+    int64_t nextLoadNs = NEVER;
+    SimErrorConfig errors;
+    std::mt19937_64 rng{0x5A1C};
+    std::vector<SimGenerator> generators;
+    SimBusStats stats;
+    std::map<std::string, std::string> values;
+};
+
+struct SimCan::Winner {
+    enum class Source { Channel, Generator, Load };
+
+    Source source = Source::Load;
+    Channel* channel = nullptr;
+    uint64_t serial = 0;
+    size_t generator = 0;
+    TxFrame tx;
+    UINT abit = DEFAULT_ABIT;
+    UINT dbit = DEFAULT_DBIT;
+    int64_t durationNs = 0;
+    BYTE error = ZCAN_BUS_ERR_NO_ERR;  // 非0表示该帧被错误帧破坏
+};
+
+// ==================== 设备 ====================
+
+SimCan& SimCan::Instance() {
+    // 不析构：进程退出时总线线程可能仍在运行
+    static SimCan* instance = new SimCan();
+    return *instance;
+}
+
+int64_t SimCan::FrameDurationNs(const canfd_frame& frame, bool fd, UINT abitBps, UINT dbitBps) {
+    const UINT id = frame.can_id;
+    const bool ext = (id & CAN_EFF_FLAG) != 0;
+    const bool brs = fd && (frame.flags & CANFD_BRS);
+    BitCounter counter;
+    if (!fd) {
+        counter.EnableCrc15();
+    }
+
+    counter.PushBit(0);  // SOF
+    if (ext) {
+        const UINT eid = id & CAN_EFF_MASK;
+        counter.Push(eid >> 18, 11);
+        counter.PushBit(1);  // SRR
+        counter.PushBit(1);  // IDE
+        counter.Push(eid & 0x3FFFF, 18);
+    } else {
+        counter.Push(id & CAN_SFF_MASK, 11);
+    }
+
+    BYTE length = 0;
+    if (fd) {
+        const BYTE dlc = FdDlc(frame.len);
+        length = FD_LENGTHS[dlc];
+        counter.PushBit(0);  // RRS
+        if (!ext) {
+            counter.PushBit(0);  // IDE
+        }
+        counter.PushBit(1);  // FDF
+        counter.PushBit(0);  // res
+        counter.PushBit(brs ? 1 : 0);
+        if (brs) {
+            counter.SetPhase(1);
+        }
+        counter.PushBit(0);  // ESI
+        counter.Push(dlc, 4);
+    } else {
+        const bool rtr = (id & CAN_RTR_FLAG) != 0;
+        const BYTE dlc = std::min<BYTE>(frame.len, 15);
+        length = rtr ? 0 : std::min<BYTE>(dlc, CAN_MAX_DLEN);
+        counter.PushBit(rtr ? 1 : 0);
+        if (ext) {
+            counter.PushBit(0);  // r1
+        } else {
+            counter.PushBit(0);  // IDE
+        }
+        counter.PushBit(0);  // r0
+        counter.Push(dlc, 4);
+    }
+
+    for (BYTE i = 0; i < length; i++) {
+        counter.Push(i < frame.len ? frame.data[i] : 0, 8);
+    }
+
+    if (fd) {
+        // 填充计数4位 + CRC17/21，固定填充位：段首1位，其后每4位1位
+        const int crcBits = length <= 16 ? 17 : 21;
+        counter.AddFixed(4 + crcBits + 1 + (4 + crcBits - 1) / 4);
+    } else {
+        counter.Push(counter.Crc15(), 15);
+    }
+    counter.SetPhase(0);
+    counter.AddFixed(FRAME_TAIL_BITS);
+
+    const int64_t abit = abitBps == 0 ? DEFAULT_ABIT : abitBps;
+    const int64_t dbit = dbitBps == 0 ? DEFAULT_DBIT : dbitBps;
+    return counter.Bits(0) * 1000000000LL / abit + counter.Bits(1) * 1000000000LL / dbit;
+}
+
+DEVICE_HANDLE SimCan::OpenDevice(UINT deviceType, UINT deviceIndex) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t key = (static_cast<uint64_t>(deviceType) << 32) | deviceIndex;
+    if (devices_.count(key) != 0) {
+        return INVALID_DEVICE_HANDLE;
+    }
+
+    UINT channelCount = 2;
+    switch (deviceType) {
+        case ZCAN_USBCANFD_100U:
+        case ZCAN_USBCANFD_MINI:
+            channelCount = 1;
+            break;
+        case ZCAN_USBCANFD_400U:
+            channelCount = 4;
+            break;
+        case ZCAN_USBCANFD_800U:
+        case ZCAN_USBCANFD_800H:
+            channelCount = 8;
+            break;
+        default:
+            break;
+    }
+
+    auto device = std::make_unique<Device>();
+    device->type = deviceType;
+    device->index = deviceIndex;
+    device->epochNs = NowNs();
+    for (UINT i = 0; i < channelCount; i++) {
+        auto channel = std::make_unique<Channel>();
+        channel->device = device.get();
+        channel->index = i;
+        channels_[channel.get()] = channel.get();
+        device->channels.push_back(std::move(channel));
+    }
+
+    Device* handle = device.get();
+    devices_[key] = std::move(device);
+    return handle;
+}
+
+UINT SimCan::CloseDevice(DEVICE_HANDLE deviceHandle) {
+    std::vector<std::thread> threads;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        Device* device = FindDevice(deviceHandle);
+        if (device == nullptr) {
+            return STATUS_ERR;
+        }
+
+        for (auto& channel : device->channels) {
+            std::thread thread = DetachChannel(channel.get());
+            if (thread.joinable()) {
+                threads.push_back(std::move(thread));
+            }
+            channel->rxCv.notify_all();
+        }
+        device->closing = true;
+        device->mergedCv.notify_all();
+        closeCv_.wait(lock, [device] { return device->waiters == 0; });
+
+        for (auto& channel : device->channels) {
+            channels_.erase(channel.get());
+        }
+        if (propertyDevice_ == deviceHandle) {
+            propertyDevice_ = nullptr;
+        }
+        devices_.erase((static_cast<uint64_t>(device->type) << 32) | device->index);
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return STATUS_OK;
+}
+
+UINT SimCan::GetDeviceInfo(DEVICE_HANDLE deviceHandle, ZCAN_DEVICE_INFO* info) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device* device = FindDevice(deviceHandle);
+    if (device == nullptr || info == nullptr) {
+        return STATUS_ERR;
+    }
+
+    std::memset(info, 0, sizeof(*info));
+    info->hw_Version = 0x0100;
+    info->fw_Version = 0x0100;
+    info->dr_Version = 0x0100;
+    info->in_Version = 0x0100;
+    info->can_Num = static_cast<BYTE>(device->channels.size());
+    std::snprintf(reinterpret_cast<char*>(info->str_Serial_Num), sizeof(info->str_Serial_Num), "SIM%02u%04u",
+                  device->type, device->index);
+    std::snprintf(reinterpret_cast<char*>(info->str_hw_Type), sizeof(info->str_hw_Type), "ZCAN-SIM-%u", device->type);
+    return STATUS_OK;
+}
+
+UINT SimCan::GetDeviceInfoEx(DEVICE_HANDLE deviceHandle, ZCAN_DEVICE_INFO_EX* info) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device* device = FindDevice(deviceHandle);
+    if (device == nullptr || info == nullptr) {
+        return STATUS_ERR;
+    }
+
+    std::memset(info, 0, sizeof(*info));
+    info->hardware_version.major_version = 1;
+    info->firmware_version.major_version = 1;
+    info->driver_version.major_version = 1;
+    info->library_version.major_version = 1;
+    info->device_info_version.major_version = 1;
+    std::snprintf(reinterpret_cast<char*>(info->device_name), sizeof(info->device_name), "ZCAN-SIM-%u-%u",
+                  device->type, device->index);
+    std::snprintf(reinterpret_cast<char*>(info->hardware_type), sizeof(info->hardware_type), "ZCAN-SIM-%u",
+                  device->type);
+    std::snprintf(reinterpret_cast<char*>(info->serial_number), sizeof(info->serial_number), "SIM%02u%04u",
+                  device->type, device->index);
+    info->can_channel_number = static_cast<BYTE>(device->channels.size());
+    return STATUS_OK;
+}
+
+UINT SimCan::IsDeviceOnline(DEVICE_HANDLE deviceHandle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device* device = FindDevice(deviceHandle);
+    if (device == nullptr) {
+        return STATUS_ERR;
+    }
+    return device->online ? STATUS_ONLINE : STATUS_OFFLINE;
+}
+
+// ==================== 通道 ====================
+
+CHANNEL_HANDLE SimCan::InitCan(DEVICE_HANDLE deviceHandle, UINT channelIndex, const ZCAN_CHANNEL_INIT_CONFIG* config) {
+    std::thread thread;
+    Channel* channel = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Device* device = FindDevice(deviceHandle);
+        if (device == nullptr || config == nullptr || !device->online || channelIndex >= device->channels.size()) {
+            return INVALID_CHANNEL_HANDLE;
+        }
+
+        channel = device->channels[channelIndex].get();
+        thread = DetachChannel(channel);
+        ResetChannelState(channel);
+        channel->canfd = config->can_type == TYPE_CANFD;
+        if (channel->canfd) {
+            channel->listenOnly = config->canfd.mode == 1;
+        } else {
+            channel->listenOnly = config->can.mode == 1;
+            if (!channel->baudSet && (config->can.timing0 != 0 || config->can.timing1 != 0)) {
+                channel->abit = TimingToBitrate(config->can.timing0, config->can.timing1);
+            }
+        }
+        channel->initialized = true;
+    }
+
+    if (thread.joinable()) {
+        thread.join();
+    }
+    return channel;
+}
+
+UINT SimCan::StartCan(CHANNEL_HANDLE channelHandle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Channel* channel = FindChannel(channelHandle);
+    if (channel == nullptr || !channel->initialized || !channel->device->online) {
+        return STATUS_ERR;
+    }
+    if (channel->started) {
+        return STATUS_OK;
+    }
+
+    Bus* bus = GetBus(channel->busId);
+    channel->bus = bus;
+    channel->started = true;
+    channel->serial = nextSerial_++;
+    bus->members.push_back(channel);
+
+    if (!bus->running) {
+        const int64_t now = NowNs();
+        bus->running = true;
+        bus->generation++;
+        bus->freeAt = std::max(bus->freeAt, now);
+        if (bus->load > 0) {
+            bus->nextLoadNs = now;
+        }
+        for (auto& generator : bus->generators) {
+            generator.nextNs = std::max(generator.nextNs, now);
+        }
+        bus->thread = std::thread(&SimCan::RunBus, this, bus, bus->generation);
+    }
+    bus->cv.notify_all();
+    return STATUS_OK;
+}
+
+UINT SimCan::ResetCan(CHANNEL_HANDLE channelHandle) {
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Channel* channel = FindChannel(channelHandle);
+        if (channel == nullptr) {
+            return STATUS_ERR;
+        }
+        thread = DetachChannel(channel);
+        ResetChannelState(channel);
+        channel->rxCv.notify_all();
+    }
+
+    if (thread.joinable()) {
+        thread.join();
+    }
+    return STATUS_OK;
+}
+
+UINT SimCan::ClearBuffer(CHANNEL_HANDLE channelHandle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Channel* channel = FindChannel(channelHandle);
+    if (channel == nullptr) {
+        return STATUS_ERR;
+    }
+
+    channel->rxCan.clear();
+    channel->rxFd.clear();
+    auto& merged = channel->device->mergedRx;
+    merged.erase(std::remove_if(merged.begin(), merged.end(),
+                                [channel](const ZCANDataObj& obj) { return obj.chnl == channel->index; }),
+                 merged.end());
+    return STATUS_OK;
+}
+
+UINT SimCan::ReadChannelErrInfo(CHANNEL_HANDLE channelHandle, ZCAN_CHANNEL_ERR_INFO* info) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Channel* channel = FindChannel(channelHandle);
+    if (channel == nullptr || info == nullptr) {
+        return STATUS_ERR;
+    }
+
+    std::memset(info, 0, sizeof(*info));
+    UINT code = channel->errorCode;
+    if (channel->nodeState == ZCAN_NODE_STATE_BUSOFF) {
+        code |= ZCAN_ERROR_CAN_BUSOFF;
+    } else if (channel->nodeState == ZCAN_NODE_STATE_PASSIVE) {
+        code |= ZCAN_ERROR_CAN_PASSIVE;
+    } else if (channel->nodeState == ZCAN_NODE_STATE_WARNNING) {
+        code |= ZCAN_ERROR_CAN_ERRALARM;
+    }
+    info->error_code = code;
+    info->passive_ErrData[1] = static_cast<BYTE>(std::min<UINT>(channel->rec, 255));
+    info->passive_ErrData[2] = static_cast<BYTE>(std::min<UINT>(channel->tec, 255));
+    channel->errorCode = 0;
+    return STATUS_OK;
+}
+
+UINT SimCan::ReadChannelStatus(CHANNEL_HANDLE channelHandle, ZCAN_CHANNEL_STATUS* status) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Channel* channel = FindChannel(channelHandle);
+    if (channel == nullptr || status == nullptr) {
+        return STATUS_ERR;
+    }
+
+    std::memset(status, 0, sizeof(*status));
+    status->regMode = channel->listenOnly ? 1 : 0;
+    if (channel->nodeState == ZCAN_NODE_STATE_BUSOFF) {
+        status->regStatus |= 0x80;
+    }
+    if (channel->tec >= ERROR_WARNING_LIMIT || channel->rec >= ERROR_WARNING_LIMIT) {
+        status->regStatus |= 0x40;
+    }
+    status->regEWLimit = ERROR_WARNING_LIMIT;
+    status->regRECounter = static_cast<BYTE>(std::min<UINT>(channel->rec, 255));
+    status->regTECounter = static_cast<BYTE>(std::min<UINT>(channel->tec, 255));
+    return STATUS_OK;
+}
+
+UINT SimCan::GetReceiveNum(CHANNEL_HANDLE channelHandle, BYTE type) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Channel* channel = FindChannel(channelHandle);
+    if (channel == nullptr) {
+        return 0;
+    }
+
+    switch (type) {
+        case TYPE_CAN:
+            return static_cast<UINT>(channel->rxCan.size());
+        case TYPE_CANFD:
+            return static_cast<UINT>(channel->rxFd.size());
+        case TYPE_ALL_DATA:
+            if (channel->device->merged) {
+                return static_cast<UINT>(channel->device->mergedRx.size());
+            }
+            return static_cast<UINT>(channel->rxCan.size() + channel->rxFd.size());
+        default:
+            return 0;
+    }
+}
+
+// ==================== 收发 ====================
+
+UINT SimCan::Transmit(CHANNEL_HANDLE channelHandle, const ZCAN_Transmit_Data* frames, UINT count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Channel* channel = FindChannel(channelHandle);
+    if (channel == nullptr || frames == nullptr || !CanTransmit(channel)) {
+        return 0;
+    }
+
+    UINT sent = 0;
+    for (; sent < count; sent++) {
+        const ZCAN_Transmit_Data& in = frames[sent];
+        TxFrame tx;
+        tx.frame.can_id = in.frame.can_id;
+        tx.frame.len = std::min<BYTE>(in.frame.can_dlc, CAN_MAX_DLEN);
+        tx.frame.flags = in.frame.__pad;
+        tx.frame.__res0 = in.frame.__res0;
+        tx.frame.__res1 = in.frame.__res1;
+        std::memcpy(tx.frame.data, in.frame.data, CAN_MAX_DLEN);
+        tx.singleShot = in.transmit_type == 1 || in.transmit_type == 3;
+        tx.echo = in.transmit_type >= 2 || (in.frame.__pad & TX_ECHO_FLAG);
+        if (!Enqueue(channel, std::move(tx))) {
+            break;
+        }
+    }
+    return sent;
+}
+
+UINT SimCan::TransmitFD(CHANNEL_HANDLE channelHandle, const ZCAN_TransmitFD_Data* frames, UINT count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Channel* channel = FindChannel(channelHandle);
+    if (channel == nullptr || frames == nullptr || !channel->canfd || !CanTransmit(channel)) {
+        return 0;
+    }
+
+    UINT sent = 0;
+    for (; sent < count; sent++) {
+        const ZCAN_TransmitFD_Data& in = frames[sent];
+        TxFrame tx;
+        tx.frame = in.frame;
+        tx.frame.len = std::min<BYTE>(in.frame.len, CANFD_MAX_DLEN);
+        tx.fd = true;
+        tx.singleShot = in.transmit_type == 1 || in.transmit_type == 3;
+        tx.echo = in.transmit_type >= 2 || (in.frame.flags & TX_ECHO_FLAG);
+        if (!Enqueue(channel, std::move(tx))) {
+            break;
+        }
+    }
+    return sent;
+}
+
+UINT SimCan::Receive(CHANNEL_HANDLE channelHandle, ZCAN_Receive_Data* frames, UINT count, int waitMs) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    Channel* channel = FindChannel(channelHandle);
+    if (channel == nullptr || frames == nullptr || count == 0) {
+        return 0;
+    }
+    if (!Wait(lock, channel->device, channel->rxCv, waitMs, [channel] { return !channel->rxCan.empty(); })) {
+        return 0;
+    }
+
+    UINT received = 0;
+    while (received < count && !channel->rxCan.empty()) {
+        frames[received++] = channel->rxCan.front();
+        channel->rxCan.pop_front();
+    }
+    return received;
+}
+
+UINT SimCan::ReceiveFD(CHANNEL_HANDLE channelHandle, ZCAN_ReceiveFD_Data* frames, UINT count, int waitMs) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    Channel* channel = FindChannel(channelHandle);
+    if (channel == nullptr || frames == nullptr || count == 0) {
+        return 0;
+    }
+    if (!Wait(lock, channel->device, channel->rxCv, waitMs, [channel] { return !channel->rxFd.empty(); })) {
+        return 0;
+    }
+
+    UINT received = 0;
+    while (received < count && !channel->rxFd.empty()) {
+        frames[received++] = channel->rxFd.front();
+        channel->rxFd.pop_front();
+    }
+    return received;
+}
+
+UINT SimCan::TransmitData(DEVICE_HANDLE deviceHandle, const ZCANDataObj* objs, UINT count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device* device = FindDevice(deviceHandle);
+    if (device == nullptr || objs == nullptr) {
+        return 0;
+    }
+
+    UINT sent = 0;
+    for (; sent < count; sent++) {
+        const ZCANDataObj& obj = objs[sent];
+        if (obj.dataType != ZCAN_DT_ZCAN_CAN_CANFD_DATA || obj.chnl >= device->channels.size()) {
+            break;
+        }
+        Channel* channel = device->channels[obj.chnl].get();
+        const ZCANCANFDData& data = obj.data.zcanCANFDData;
+        TxFrame tx;
+        tx.frame = data.frame;
+        tx.fd = data.flag.unionVal.frameType == 1;
+        tx.frame.len = std::min<BYTE>(data.frame.len, tx.fd ? CANFD_MAX_DLEN : CAN_MAX_DLEN);
+        tx.frame.flags &= ~TX_ONLY_FLAGS;
+        tx.singleShot = data.flag.unionVal.transmitType == 1 || data.flag.unionVal.transmitType == 3;
+        tx.echo = data.flag.unionVal.transmitType >= 2 || data.flag.unionVal.txEchoRequest;
+        if (data.flag.unionVal.txDelay != ZCAN_TX_DELAY_NO_DELAY) {
+            const bool unit100us = data.flag.unionVal.txDelay == ZCAN_TX_DELAY_UNIT_100US;
+            const uint64_t delay = std::min<uint64_t>(data.timeStamp, 0xFFFF);
+            tx.frame.flags |= TX_DELAY_SEND_FLAG | (unit100us ? TX_DELAY_SEND_TIME_UNIT_FLAG : 0);
+            tx.frame.__res0 = static_cast<BYTE>(delay & 0xFF);
+            tx.frame.__res1 = static_cast<BYTE>(delay >> 8);
+        }
+        if ((tx.fd && !channel->canfd) || !CanTransmit(channel) || !Enqueue(channel, std::move(tx))) {
+            break;
+        }
+    }
+    return sent;
+}
+
+UINT SimCan::ReceiveData(DEVICE_HANDLE deviceHandle, ZCANDataObj* objs, UINT count, int waitMs) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    Device* device = FindDevice(deviceHandle);
+    if (device == nullptr || objs == nullptr || count == 0) {
+        return 0;
+    }
+    if (!Wait(lock, device, device->mergedCv, waitMs, [device] { return !device->mergedRx.empty(); })) {
+        return 0;
+    }
+
+    UINT received = 0;
+    while (received < count && !device->mergedRx.empty()) {
+        objs[received++] = device->mergedRx.front();
+        device->mergedRx.pop_front();
+    }
+    return received;
+}
+
+// ==================== 属性 ====================
+
+UINT SimCan::SetValue(DEVICE_HANDLE deviceHandle, const char* path, const char* value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device* device = FindDevice(deviceHandle);
+    if (device == nullptr || path == nullptr || value == nullptr) {
+        return STATUS_ERR;
+    }
+
+    const std::string key(path);
+    const std::string text(value);
+    bool ok = true;
+    if (key.compare(0, 4, "sim/") == 0) {
+        ok = SetSimValue(device, key.substr(4), text);
+    } else {
+        const size_t slash = key.find('/');
+        uint64_t channelIndex = 0;
+        if (slash != std::string::npos && ParseUint(key.substr(0, slash), &channelIndex)) {
+            ok = SetChannelValue(device, static_cast<UINT>(channelIndex), key.substr(slash + 1), text);
+        }
+    }
+    if (!ok) {
+        return STATUS_ERR;
+    }
+    device->values[key] = text;
+    return STATUS_OK;
+}
+
+const char* SimCan::GetValue(DEVICE_HANDLE deviceHandle, const char* path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device* device = FindDevice(deviceHandle);
+    if (device == nullptr || path == nullptr) {
+        return nullptr;
+    }
+
+    const std::string key(path);
+    std::string& slot = device->values[key];
+
+    // "sim/[总线号/]stats"
+    if (key.compare(0, 4, "sim/") == 0) {
+        std::string rest = key.substr(4);
+        UINT busId = 0;
+        const size_t slash = rest.find('/');
+        uint64_t number = 0;
+        if (slash != std::string::npos && ParseUint(rest.substr(0, slash), &number)) {
+            busId = static_cast<UINT>(number);
+            rest = rest.substr(slash + 1);
+        }
+        Bus* bus = GetBus(busId);
+        auto it = bus->values.find(rest);
+        if (rest == "stats") {
+            slot = FormatStats(bus);
+        } else if (it != bus->values.end()) {
+            slot = it->second;
+        }
+        if (slot.empty()) {
+            device->values.erase(key);
+            return nullptr;
+        }
+        return slot.c_str();
+    }
+
+    // "N/get_device_available_tx_count/1"
+    const size_t slash = key.find('/');
+    uint64_t channelIndex = 0;
+    if (slash != std::string::npos && ParseUint(key.substr(0, slash), &channelIndex) &&
+        channelIndex < device->channels.size() &&
+        key.compare(slash + 1, std::string::npos, "get_device_available_tx_count/1") == 0) {
+        const Channel* channel = device->channels[channelIndex].get();
+        slot = std::to_string(channel->txCapacity - std::min(channel->txCapacity, channel->tx.size()));
+        return slot.c_str();
+    }
+
+    if (slot.empty()) {
+        device->values.erase(key);
+        return nullptr;
+    }
+    return slot.c_str();
+}
+
+void SimCan::SetPropertyDevice(DEVICE_HANDLE deviceHandle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    propertyDevice_ = deviceHandle;
+}
+
+DEVICE_HANDLE SimCan::PropertyDevice() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return propertyDevice_;
+}
+
+bool SimCan::SetChannelValue(Device* device, UINT channelIndex, const std::string& key, const std::string& value) {
+    if (key == "set_device_recv_merge") {
+        device->merged = value != "0";
+        return true;
+    }
+    if (channelIndex >= device->channels.size()) {
+        return false;
+    }
+
+    Channel* channel = device->channels[channelIndex].get();
+    uint64_t number = 0;
+    if (key == "canfd_abit_baud_rate" || key == "baud_rate") {
+        if (!ParseUint(value, &number) || number == 0) {
+            return false;
+        }
+        channel->abit = static_cast<UINT>(number);
+        channel->baudSet = true;
+    } else if (key == "canfd_dbit_baud_rate") {
+        if (!ParseUint(value, &number) || number == 0) {
+            return false;
+        }
+        channel->dbit = static_cast<UINT>(number);
+    } else if (key == "sim_bus") {
+        // 下次StartCAN生效
+        if (!ParseUint(value, &number)) {
+            return false;
+        }
+        channel->busId = static_cast<UINT>(number);
+    } else if (key == "sim_bus_off") {
+        if (!ParseUint(value, &number)) {
+            return false;
+        }
+        if (number != 0) {
+            channel->tec = BUS_OFF_LIMIT;
+        } else {
+            channel->tec = 0;
+            channel->rec = 0;
+        }
+        UpdateErrorState(channel);
+    } else if (key == "sim_tec" || key == "sim_rec") {
+        if (!ParseUint(value, &number)) {
+            return false;
+        }
+        (key == "sim_tec" ? channel->tec : channel->rec) = static_cast<UINT>(std::min<uint64_t>(number, BUS_OFF_LIMIT));
+        UpdateErrorState(channel);
+    } else if (key == "sim_rx_capacity" || key == "sim_tx_capacity") {
+        if (!ParseUint(value, &number) || number == 0) {
+            return false;
+        }
+        (key == "sim_rx_capacity" ? channel->rxCapacity : channel->txCapacity) = static_cast<size_t>(number);
+    } else if (key == "clear_delay_send_queue") {
+        channel->tx.clear();
+    }
+    return true;
+}
+
+bool SimCan::SetSimValue(Device* device, const std::string& key, const std::string& value) {
+    uint64_t number = 0;
+    double rate = 0;
+    if (key == "online") {
+        if (!ParseUint(value, &number)) {
+            return false;
+        }
+        device->online = number != 0;
+        for (auto& channel : device->channels) {
+            channel->rxCv.notify_all();
+        }
+        device->mergedCv.notify_all();
+        return true;
+    }
+    if (key == "clock_ppm") {
+        char* end = nullptr;
+        const double ppm = std::strtod(value.c_str(), &end);
+        if (value.empty() || *end != '\0') {
+            return false;
+        }
+        device->clockPpm = ppm;
+        return true;
+    }
+
+    // "[总线号/]参数"，省略总线号为总线0
+    std::string name = key;
+    UINT busId = 0;
+    const size_t slash = key.find('/');
+    if (slash != std::string::npos) {
+        if (!ParseUint(key.substr(0, slash), &number)) {
+            return false;
+        }
+        busId = static_cast<UINT>(number);
+        name = key.substr(slash + 1);
+    }
+
+    Bus* bus = GetBus(busId);
+    if (name == "realtime") {
+        if (!ParseUint(value, &number)) {
+            return false;
+        }
+        bus->realtime = number != 0;
+    } else if (name == "load") {
+        if (!ParseRate(value, &rate)) {
+            return false;
+        }
+        bus->load = std::min(rate, 0.95);
+        bus->nextLoadNs = bus->load > 0 ? NowNs() : NEVER;
+    } else if (name == "error_rate" || name == "drop_rate" || name == "tx_fail_rate") {
+        if (!ParseRate(value, &rate)) {
+            return false;
+        }
+        (name == "error_rate" ? bus->errors.errorRate
+                              : name == "drop_rate" ? bus->errors.dropRate : bus->errors.txFailRate) = rate;
+    } else if (name == "seed") {
+        if (!ParseUint(value, &number)) {
+            return false;
+        }
+        bus->rng.seed(number);
+    } else if (name == "stats_reset") {
+        bus->stats = SimBusStats();
+        bus->stats.sinceNs = NowNs();
+    } else if (name == "generator") {
+        SimGenerator generator;
+        if (!ParseGenerator(value, &generator)) {
+            return false;
+        }
+        generator.nextNs = NowNs();
+        bus->generators.push_back(std::move(generator));
+    } else if (name == "generator_clear") {
+        bus->generators.clear();
+    } else {
+        return false;
+    }
+    bus->values[name] = value;
+    bus->cv.notify_all();
+    return true;
+}
+
+std::string SimCan::FormatStats(Bus* bus) {
+    const SimBusStats& stats = bus->stats;
+    const int64_t elapsed = NowNs() - stats.sinceNs;
+    const double busLoad = elapsed > 0 ? std::min(1.0, static_cast<double>(stats.busyNs) / elapsed) : 0;
+    char text[320];
+    std::snprintf(text, sizeof(text),
+                  "frames=%llu;generator_frames=%llu;load_frames=%llu;error_frames=%llu;ack_errors=%llu;"
+                  "dropped=%llu;overflows=%llu;bus_load=%.4f",
+                  static_cast<unsigned long long>(stats.frames),
+                  static_cast<unsigned long long>(stats.generatorFrames),
+                  static_cast<unsigned long long>(stats.loadFrames),
+                  static_cast<unsigned long long>(stats.errorFrames),
+                  static_cast<unsigned long long>(stats.ackErrors),
+                  static_cast<unsigned long long>(stats.dropped),
+                  static_cast<unsigned long long>(stats.overflows), busLoad);
+    return text;
+}
+
+// ==================== 内部 ====================
+
+SimCan::Device* SimCan::FindDevice(DEVICE_HANDLE deviceHandle) {
+    for (auto& entry : devices_) {
+        if (entry.second.get() == deviceHandle) {
+            return entry.second->closing ? nullptr : entry.second.get();
+        }
+    }
+    return nullptr;
+}
+
+SimCan::Channel* SimCan::FindChannel(CHANNEL_HANDLE channelHandle) {
+    auto it = channels_.find(channelHandle);
+    if (it == channels_.end() || it->second->device->closing) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+SimCan::Bus* SimCan::GetBus(UINT busId) {
+    auto& bus = buses_[busId];
+    if (!bus) {
+        bus = std::make_unique<Bus>();
+        bus->id = busId;
+        bus->stats.sinceNs = NowNs();
+    }
+    return bus.get();
+}
+
+bool SimCan::IsLive(const Channel* channel, uint64_t serial) const {
+    auto it = channels_.find(channel);
+    return it != channels_.end() && it->second->started && it->second->serial == serial;
+}
+
+UINT64 SimCan::DeviceTimestamp(const Device* device, int64_t ns) {
+    // 设备时钟相对主机时钟的频偏由"sim/clock_ppm"设置
+    const double elapsed = static_cast<double>(ns - device->epochNs) * (1.0 + device->clockPpm * 1e-6);
+    return static_cast<UINT64>(std::max(0.0, elapsed) / 1000);
+}
+
+std::thread SimCan::DetachChannel(Channel* channel) {
+    if (!channel->started) {
+        return std::thread();
+    }
+
+    Bus* bus = channel->bus;
+    channel->started = false;
+    channel->tx.clear();
+    bus->members.erase(std::remove(bus->members.begin(), bus->members.end(), channel), bus->members.end());
+    if (!bus->members.empty()) {
+        return std::thread();
+    }
+
+    bus->running = false;
+    bus->generation++;
+    bus->cv.notify_all();
+    return std::move(bus->thread);
+}
+
+void SimCan::ResetChannelState(Channel* channel) {
+    channel->tx.clear();
+    channel->rxCan.clear();
+    channel->rxFd.clear();
+    channel->lastDelayedNs = 0;
+    channel->tec = 0;
+    channel->rec = 0;
+    channel->errorCode = 0;
+    channel->nodeState = ZCAN_NODE_STATE_ACTIVE;
+}
+
+bool SimCan::CanTransmit(const Channel* channel) const {
+    return channel->started && channel->device->online && !channel->listenOnly &&
+           channel->nodeState != ZCAN_NODE_STATE_BUSOFF;
+}
+
+bool SimCan::Enqueue(Channel* channel, TxFrame&& frame) {
+    Bus* bus = channel->bus;
+    if (channel->tx.size() >= channel->txCapacity) {
+        return false;
+    }
+    if (bus->errors.txFailRate > 0 &&
+        std::uniform_real_distribution<double>(0, 1)(bus->rng) < bus->errors.txFailRate) {
+        return false;
+    }
+
+    // 队列延时发送：与上一帧延时帧的间隔
+    const int64_t now = NowNs();
+    frame.readyNs = now;
+    if (frame.frame.flags & TX_DELAY_SEND_FLAG) {
+        const int64_t units = frame.frame.__res0 | (frame.frame.__res1 << 8);
+        const int64_t unitNs = (frame.frame.flags & TX_DELAY_SEND_TIME_UNIT_FLAG) ? 100000 : 1000000;
+        frame.readyNs = std::max(now, channel->lastDelayedNs) + units * unitNs;
+        channel->lastDelayedNs = frame.readyNs;
+    }
+    frame.frame.flags &= ~TX_ONLY_FLAGS;
+    frame.frame.__res0 = 0;
+    frame.frame.__res1 = 0;
+
+    channel->tx.push_back(std::move(frame));
+    bus->cv.notify_all();
+    return true;
+}
+
+bool SimCan::Wait(std::unique_lock<std::mutex>& lock, Device* device, std::condition_variable& cv, int waitMs,
+                  const std::function<bool()>& ready) {
+    if (!device->online) {
+        return false;
+    }
+    if (ready() || waitMs == 0) {
+        return ready();
+    }
+
+    // CloseDevice等待所有阻塞的接收调用返回后才释放设备
+    device->waiters++;
+    auto done = [device, &ready] { return device->closing || !device->online || ready(); };
+    if (waitMs < 0) {
+        cv.wait(lock, done);
+    } else {
+        cv.wait_for(lock, std::chrono::milliseconds(waitMs), done);
+    }
+    device->waiters--;
+    if (device->closing) {
+        closeCv_.notify_all();
+        return false;
+    }
+    return device->online && ready();
+}
+
+// ==================== 总线线程 ====================
+
+void SimCan::RunBus(Bus* bus, uint64_t generation) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (bus->generation == generation) {
+        const int64_t now = NowNs();
+        const int64_t nextReady = NextReady(bus);
+        if (nextReady == NEVER) {
+            bus->cv.wait(lock);
+            continue;
+        }
+        if (nextReady > now) {
+            bus->cv.wait_until(lock, ToTimePoint(nextReady));
+            continue;
+        }
+
+        // 线程晚醒时start早于now，帧按虚拟时间排队，时间戳不受调度抖动影响
+        const int64_t start = std::max(bus->freeAt, nextReady);
+        if (bus->realtime && start > now) {
+            bus->cv.wait_until(lock, ToTimePoint(start));
+            continue;
+        }
+
+        Winner winner;
+        if (!PickWinner(bus, bus->realtime ? start : now, &winner)) {
+            continue;
+        }
+
+        const int64_t end = start + winner.durationNs;
+        if (bus->realtime) {
+            while (bus->generation == generation && NowNs() < end) {
+                bus->cv.wait_until(lock, ToTimePoint(end));
+            }
+            if (bus->generation != generation) {
+                break;
+            }
+        }
+
+        bus->freeAt = end;
+        bus->stats.busyNs += static_cast<uint64_t>(winner.durationNs);
+        if (winner.error != ZCAN_BUS_ERR_NO_ERR) {
+            InjectError(bus, winner, end);
+        } else {
+            Deliver(bus, winner, end);
+        }
+    }
+}
+
+int64_t SimCan::NextReady(Bus* bus) {
+    int64_t next = bus->nextLoadNs;
+    for (Channel* channel : bus->members) {
+        if (!channel->tx.empty() && CanTransmit(channel)) {
+            next = std::min(next, channel->tx.front().readyNs);
+        }
+    }
+    for (const auto& generator : bus->generators) {
+        if (generator.count == 0 || generator.sent < generator.count) {
+            next = std::min(next, generator.nextNs);
+        }
+    }
+    return next;
+}
+
+bool SimCan::Compatible(const Channel* channel, const Winner& winner) const {
+    if (channel->abit != winner.abit) {
+        return false;
+    }
+    if (!winner.tx.fd) {
+        return true;
+    }
+    return channel->canfd && (!(winner.tx.frame.flags & CANFD_BRS) || channel->dbit == winner.dbit);
+}
+
+bool SimCan::Receiving(const Channel* channel) const {
+    return channel->device->online && channel->nodeState != ZCAN_NODE_STATE_BUSOFF;
+}
+
+bool SimCan::PickWinner(Bus* bus, int64_t horizon, Winner* winner) {
+    if (bus->members.empty()) {
+        return false;
+    }
+
+    // 仲裁：就绪候选中仲裁键最小者获得总线
+    uint64_t bestKey = UINT64_MAX;
+    bool found = false;
+    for (Channel* channel : bus->members) {
+        if (channel->tx.empty() || !CanTransmit(channel) || channel->tx.front().readyNs > horizon) {
+            continue;
+        }
+        const uint64_t key = ArbitrationKey(channel->tx.front().frame, channel->tx.front().fd);
+        if (key < bestKey) {
+            bestKey = key;
+            winner->source = Winner::Source::Channel;
+            winner->channel = channel;
+            found = true;
+        }
+    }
+    for (size_t i = 0; i < bus->generators.size(); i++) {
+        const SimGenerator& generator = bus->generators[i];
+        if ((generator.count != 0 && generator.sent >= generator.count) || generator.nextNs > horizon) {
+            continue;
+        }
+        canfd_frame frame{};
+        frame.can_id = generator.id;
+        const uint64_t key = ArbitrationKey(frame, generator.fd);
+        if (key < bestKey) {
+            bestKey = key;
+            winner->source = Winner::Source::Generator;
+            winner->generator = i;
+            found = true;
+        }
+    }
+    // 背景负载帧使用随机ID参与仲裁
+    const uint64_t loadKey = static_cast<uint64_t>(bus->rng() & CAN_SFF_MASK) << 21;
+    if (bus->nextLoadNs <= horizon && loadKey < bestKey) {
+        winner->source = Winner::Source::Load;
+        found = true;
+    }
+    if (!found) {
+        return false;
+    }
+
+    const Channel* nominal = bus->members.front();
+    winner->abit = nominal->abit;
+    winner->dbit = nominal->dbit;
+    std::uniform_real_distribution<double> uniform(0, 1);
+
+    switch (winner->source) {
+        case Winner::Source::Channel: {
+            Channel* channel = winner->channel;
+            winner->serial = channel->serial;
+            winner->tx = channel->tx.front();
+            winner->abit = channel->abit;
+            winner->dbit = channel->dbit;
+            channel->tx.pop_front();
+            break;
+        }
+        case Winner::Source::Generator: {
+            const SimGenerator& generator = bus->generators[winner->generator];
+            TxFrame& tx = winner->tx;
+            tx.fd = generator.fd;
+            tx.frame.can_id = generator.id;
+            tx.frame.len = generator.length;
+            tx.frame.flags = generator.brs ? CANFD_BRS : 0;
+            for (BYTE i = 0; i < generator.length; i++) {
+                switch (generator.pattern) {
+                    case SimGenerator::Pattern::Counter:
+                        tx.frame.data[i] = i < 4 ? static_cast<BYTE>(generator.sent >> (8 * i))
+                                                 : (i < generator.data.size() ? generator.data[i] : 0);
+                        break;
+                    case SimGenerator::Pattern::Random:
+                        tx.frame.data[i] = static_cast<BYTE>(bus->rng());
+                        break;
+                    case SimGenerator::Pattern::Fixed:
+                        tx.frame.data[i] = i < generator.data.size() ? generator.data[i] : 0;
+                        break;
+                }
+            }
+            break;
+        }
+        case Winner::Source::Load: {
+            TxFrame& tx = winner->tx;
+            tx.frame.can_id = static_cast<UINT>(loadKey >> 21);
+            tx.frame.len = CAN_MAX_DLEN;
+            for (BYTE i = 0; i < CAN_MAX_DLEN; i++) {
+                tx.frame.data[i] = static_cast<BYTE>(bus->rng());
+            }
+            winner->durationNs = FrameDurationNs(tx.frame, false, winner->abit, winner->dbit);
+            // 泊松到达，平均占用率为load
+            const double mean = static_cast<double>(winner->durationNs) / bus->load;
+            bus->nextLoadNs = std::max(bus->nextLoadNs, horizon - winner->durationNs) +
+                              static_cast<int64_t>(std::exponential_distribution<double>(1.0 / mean)(bus->rng));
+            return true;
+        }
+    }
+
+    winner->durationNs = FrameDurationNs(winner->tx.frame, winner->tx.fd, winner->abit, winner->dbit);
+
+    // 位速率不一致的主动错误节点会破坏该帧；随机错误注入
+    for (const Channel* channel : bus->members) {
+        if (channel != winner->channel && Receiving(channel) && !channel->listenOnly &&
+            channel->nodeState != ZCAN_NODE_STATE_PASSIVE && !Compatible(channel, *winner)) {
+            winner->error = ZCAN_BUS_ERR_STUFF_ERR;
+            break;
+        }
+    }
+    if (winner->error == ZCAN_BUS_ERR_NO_ERR && bus->errors.errorRate > 0 &&
+        uniform(bus->rng) < bus->errors.errorRate) {
+        static const BYTE SUB_TYPES[] = {ZCAN_BUS_ERR_BIT_ERR, ZCAN_BUS_ERR_CRC_ERR, ZCAN_BUS_ERR_FORM_ERR,
+                                         ZCAN_BUS_ERR_STUFF_ERR};
+        winner->error = SUB_TYPES[bus->rng() % 4];
+    }
+    if (winner->error != ZCAN_BUS_ERR_NO_ERR) {
+        // 错误在帧中途被检出，随后为错误帧
+        const int64_t abit = winner->abit == 0 ? DEFAULT_ABIT : winner->abit;
+        winner->durationNs = winner->durationNs / 2 + ERROR_FRAME_BITS * 1000000000LL / abit;
+    }
+    return true;
+}
+
+void SimCan::Deliver(Bus* bus, const Winner& winner, int64_t endNs) {
+    if (winner.source == Winner::Source::Load) {
+        bus->stats.loadFrames++;
+        return;
+    }
+
+    Channel* sender = winner.source == Winner::Source::Channel && IsLive(winner.channel, winner.serial)
+                          ? winner.channel
+                          : nullptr;
+
+    // 应答：除发送方外至少有一个兼容的非只听节点；发生器和背景负载代表总线上的其他节点
+    bool acked = winner.source != Winner::Source::Channel || !bus->generators.empty() || bus->load > 0;
+    for (const Channel* channel : bus->members) {
+        if (channel != winner.channel && Receiving(channel) && !channel->listenOnly && Compatible(channel, winner)) {
+            acked = true;
+            break;
+        }
+    }
+
+    if (!acked) {
+        // 没有应答时不重发，直接丢弃该帧
+        bus->stats.ackErrors++;
+        if (sender != nullptr) {
+            if (sender->tec < ERROR_PASSIVE_LIMIT) {
+                sender->tec += 8;
+            }
+            sender->errorCode |= ZCAN_ERROR_CAN_BUSERR;
+            PushError(sender, ZCAN_BUS_ERR_ACK_ERR, endNs);
+            UpdateErrorState(sender);
+        }
+        return;
+    }
+
+    bus->stats.frames++;
+    if (winner.source == Winner::Source::Generator) {
+        bus->stats.generatorFrames++;
+        SimGenerator& generator = bus->generators[winner.generator];
+        generator.sent++;
+        generator.nextNs += static_cast<int64_t>(generator.periodNs);
+        if (generator.nextNs + static_cast<int64_t>(generator.periodNs) < endNs) {
+            generator.nextNs = endNs;  // 总线拥塞时丢弃错过的周期
+        }
+    }
+
+    if (sender != nullptr) {
+        if (sender->tec > 0) {
+            sender->tec--;
+        }
+        UpdateErrorState(sender);
+        if (winner.tx.echo) {
+            PushFrame(sender, winner.tx.frame, winner.tx.fd, true, endNs);
+        }
+    }
+
+    std::uniform_real_distribution<double> uniform(0, 1);
+    for (Channel* channel : bus->members) {
+        if (channel == winner.channel || !Receiving(channel) || !Compatible(channel, winner)) {
+            continue;
+        }
+        if (channel->rec > 0) {
+            channel->rec = channel->rec >= ERROR_PASSIVE_LIMIT ? 120 : channel->rec - 1;
+            UpdateErrorState(channel);
+        }
+        if (bus->errors.dropRate > 0 && uniform(bus->rng) < bus->errors.dropRate) {
+            bus->stats.dropped++;
+            continue;
+        }
+        PushFrame(channel, winner.tx.frame, winner.tx.fd, false, endNs);
+    }
+}
+
+void SimCan::InjectError(Bus* bus, const Winner& winner, int64_t endNs) {
+    bus->stats.errorFrames++;
+
+    Channel* sender = winner.source == Winner::Source::Channel && IsLive(winner.channel, winner.serial)
+                          ? winner.channel
+                          : nullptr;
+    if (sender != nullptr) {
+        sender->tec += 8;
+        sender->errorCode |= ZCAN_ERROR_CAN_BUSERR;
+        PushError(sender, winner.error, endNs);
+        UpdateErrorState(sender);
+        // 自动重发，单次发送的帧丢弃
+        if (!winner.tx.singleShot && CanTransmit(sender)) {
+            sender->tx.push_front(winner.tx);
+        }
+    }
+
+    for (Channel* channel : bus->members) {
+        if (channel == winner.channel || !Receiving(channel) || channel->listenOnly) {
+            continue;
+        }
+        channel->rec = std::min<UINT>(channel->rec + 1, 255);
+        channel->errorCode |= ZCAN_ERROR_CAN_BUSERR;
+        PushError(channel, winner.error, endNs);
+        UpdateErrorState(channel);
+    }
+}
+
+void SimCan::PushFrame(Channel* channel, const canfd_frame& frame, bool fd, bool echo, int64_t endNs) {
+    Device* device = channel->device;
+    const UINT64 timestamp = DeviceTimestamp(device, endNs);
+
+    if (device->merged) {
+        if (device->mergedRx.size() >= channel->rxCapacity) {
+            channel->errorCode |= ZCAN_ERROR_CAN_BUFFER_OVERFLOW;
+            channel->bus->stats.overflows++;
+            return;
+        }
+        ZCANDataObj obj{};
+        obj.dataType = ZCAN_DT_ZCAN_CAN_CANFD_DATA;
+        obj.chnl = static_cast<BYTE>(channel->index);
+        ZCANCANFDData& data = obj.data.zcanCANFDData;
+        data.timeStamp = timestamp;
+        data.flag.unionVal.frameType = fd ? 1 : 0;
+        data.flag.unionVal.txEchoed = echo ? 1 : 0;
+        data.frame = frame;
+        device->mergedRx.push_back(obj);
+        device->mergedCv.notify_all();
+        return;
+    }
+
+    if (fd) {
+        if (channel->rxFd.size() >= channel->rxCapacity) {
+            channel->errorCode |= ZCAN_ERROR_CAN_BUFFER_OVERFLOW;
+            channel->bus->stats.overflows++;
+            return;
+        }
+        ZCAN_ReceiveFD_Data data{};
+        data.frame = frame;
+        data.frame.flags = static_cast<BYTE>((frame.flags & ~TX_ONLY_FLAGS) | (echo ? TX_ECHO_FLAG : 0));
+        data.timestamp = timestamp;
+        channel->rxFd.push_back(data);
+    } else {
+        if (channel->rxCan.size() >= channel->rxCapacity) {
+            channel->errorCode |= ZCAN_ERROR_CAN_BUFFER_OVERFLOW;
+            channel->bus->stats.overflows++;
+            return;
+        }
+        ZCAN_Receive_Data data{};
+        data.frame.can_id = frame.can_id;
+        data.frame.can_dlc = frame.len;
+        data.frame.__pad = echo ? TX_ECHO_FLAG : 0;
+        std::memcpy(data.frame.data, frame.data, CAN_MAX_DLEN);
+        data.timestamp = timestamp;
+        channel->rxCan.push_back(data);
+    }
+    channel->rxCv.notify_all();
+}
+
+void SimCan::PushError(Channel* channel, BYTE subType, int64_t endNs) {
+    Device* device = channel->device;
+    if (!device->merged || device->mergedRx.size() >= channel->rxCapacity) {
+        return;
+    }
+
+    ZCANDataObj obj{};
+    obj.dataType = ZCAN_DT_ZCAN_ERROR_DATA;
+    obj.chnl = static_cast<BYTE>(channel->index);
+    ZCANErrorData& data = obj.data.zcanErrData;
+    data.timeStamp = DeviceTimestamp(device, endNs);
+    data.errType = ZCAN_ERR_TYPE_BUS_ERR;
+    data.errSubType = subType;
+    data.nodeState = channel->nodeState;
+    data.rxErrCount = static_cast<BYTE>(std::min<UINT>(channel->rec, 255));
+    data.txErrCount = static_cast<BYTE>(std::min<UINT>(channel->tec, 255));
+    device->mergedRx.push_back(obj);
+    device->mergedCv.notify_all();
+}
+
+void SimCan::UpdateErrorState(Channel* channel) {
+    BYTE state = ZCAN_NODE_STATE_ACTIVE;
+    if (channel->tec >= BUS_OFF_LIMIT) {
+        state = ZCAN_NODE_STATE_BUSOFF;
+    } else if (channel->tec >= ERROR_PASSIVE_LIMIT || channel->rec >= ERROR_PASSIVE_LIMIT) {
+        state = ZCAN_NODE_STATE_PASSIVE;
+    } else if (channel->tec >= ERROR_WARNING_LIMIT || channel->rec >= ERROR_WARNING_LIMIT) {
+        state = ZCAN_NODE_STATE_WARNNING;
+    }
+    if (state == channel->nodeState) {
+        return;
+    }
+
+    channel->nodeState = state;
+    switch (state) {
+        case ZCAN_NODE_STATE_BUSOFF:
+            // 总线关闭：丢弃发送队列，需ResetCAN或"N/sim_bus_off"=0恢复
+            channel->tx.clear();
+            channel->errorCode |= ZCAN_ERROR_CAN_BUSOFF;
+            break;
+        case ZCAN_NODE_STATE_PASSIVE:
+            channel->errorCode |= ZCAN_ERROR_CAN_PASSIVE;
+            break;
+        case ZCAN_NODE_STATE_WARNNING:
+            channel->errorCode |= ZCAN_ERROR_CAN_ERRALARM;
+            break;
+        default:
+            break;
+    }
+    if (channel->bus != nullptr) {
+        PushError(channel, ZCAN_BUS_ERR_NODE_STATE_CHAGE, NowNs());
+        channel->bus->cv.notify_all();
+    }
+}
@@ -0,0 +1,151 @@
+#ifndef ZLGCAN_SIM_CAN_H_
+#define ZLGCAN_SIM_CAN_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "zlgcan.h"
+
+// 流量发生器：总线上的外部节点，按周期向同一总线上的全部通道发送报文
+struct SimGenerator {
+    enum class Pattern : uint8_t {
+        Fixed,                         // 始终发送data
+        Counter,                       // 前4字节为小端递增序号，其余为data
+        Random,                        // 随机数据
+    };
+
+    UINT id = 0;                       // 带CAN_EFF_FLAG表示扩展帧
+    bool fd = false;
+    bool brs = false;
+    BYTE length = 8;
+    uint64_t periodNs = 1000000;
+    uint64_t count = 0;                // 0表示不限次数
+    Pattern pattern = Pattern::Counter;
+    std::vector<BYTE> data;
+
+    uint64_t sent = 0;
+    int64_t nextNs = 0;
+};
+
+// 错误注入
+struct SimErrorConfig {
+    double errorRate = 0;              // 帧在总线上被错误帧破坏的概率，发送方重发（单次发送则丢弃）
+    double dropRate = 0;               // 单个接收通道丢失帧的概率
+    double txFailRate = 0;             // ZCAN_Transmit拒绝单帧的概率，拒绝后同批剩余帧不再接受
+};
+
+// 总线统计
+struct SimBusStats {
+    uint64_t frames = 0;               // 成功发送的帧（含发生器）
+    uint64_t generatorFrames = 0;
+    uint64_t loadFrames = 0;           // 背景负载占用总线的次数（不投递）
+    uint64_t errorFrames = 0;
+    uint64_t ackErrors = 0;            // 总线上没有其他节点应答
+    uint64_t dropped = 0;              // dropRate注入的丢帧
+    uint64_t overflows = 0;            // 接收缓冲满而丢弃的帧
+    uint64_t busyNs = 0;
+    int64_t sinceNs = 0;
+};
+
+/**
+ * ZCAN_* API的仿真实现
+ * 每条仿真总线一个线程，按仲裁ID、位速率和实际填充位计算帧时长，串行占用总线；
+ * 帧在结束时刻投递到同一总线上已启动的其他通道，时间戳为各设备打开以来的微秒数。
+ * 实时模式按墙钟节拍投递（线程晚醒时按虚拟时间补发，时间戳不受调度抖动影响），
+ * 非实时模式立即投递，时间戳仍按总线占用推算，用于压测收发路径。
+ * 仿真参数通过ZCAN_SetValue设置，见zlgcan_sim.cpp。
+ */
+class SimCan {
+public:
+    static SimCan& Instance();
+
+    SimCan(const SimCan&) = delete;
+    SimCan& operator=(const SimCan&) = delete;
+
+    DEVICE_HANDLE OpenDevice(UINT deviceType, UINT deviceIndex);
+    UINT CloseDevice(DEVICE_HANDLE deviceHandle);
+    UINT GetDeviceInfo(DEVICE_HANDLE deviceHandle, ZCAN_DEVICE_INFO* info);
+    UINT GetDeviceInfoEx(DEVICE_HANDLE deviceHandle, ZCAN_DEVICE_INFO_EX* info);
+    UINT IsDeviceOnline(DEVICE_HANDLE deviceHandle);
+
+    CHANNEL_HANDLE InitCan(DEVICE_HANDLE deviceHandle, UINT channelIndex, const ZCAN_CHANNEL_INIT_CONFIG* config);
+    UINT StartCan(CHANNEL_HANDLE channelHandle);
+    UINT ResetCan(CHANNEL_HANDLE channelHandle);
+    UINT ClearBuffer(CHANNEL_HANDLE channelHandle);
+    UINT ReadChannelErrInfo(CHANNEL_HANDLE channelHandle, ZCAN_CHANNEL_ERR_INFO* info);
+    UINT ReadChannelStatus(CHANNEL_HANDLE channelHandle, ZCAN_CHANNEL_STATUS* status);
+    UINT GetReceiveNum(CHANNEL_HANDLE channelHandle, BYTE type);
+
+    UINT Transmit(CHANNEL_HANDLE channelHandle, const ZCAN_Transmit_Data* frames, UINT count);
+    UINT TransmitFD(CHANNEL_HANDLE channelHandle, const ZCAN_TransmitFD_Data* frames, UINT count);
+    UINT Receive(CHANNEL_HANDLE channelHandle, ZCAN_Receive_Data* frames, UINT count, int waitMs);
+    UINT ReceiveFD(CHANNEL_HANDLE channelHandle, ZCAN_ReceiveFD_Data* frames, UINT count, int waitMs);
+    UINT TransmitData(DEVICE_HANDLE deviceHandle, const ZCANDataObj* objs, UINT count);
+    UINT ReceiveData(DEVICE_HANDLE deviceHandle, ZCANDataObj* objs, UINT count, int waitMs);
+
+    UINT SetValue(DEVICE_HANDLE deviceHandle, const char* path, const char* value);
+    const char* GetValue(DEVICE_HANDLE deviceHandle, const char* path);
+
+    // IProperty的函数指针不带设备句柄，作用于最近一次GetIProperty的设备
+    void SetPropertyDevice(DEVICE_HANDLE deviceHandle);
+    DEVICE_HANDLE PropertyDevice();
+
+    // 帧在总线上的时长（纳秒），仲裁段按abit，BRS帧的数据段按dbit
+    static int64_t FrameDurationNs(const canfd_frame& frame, bool fd, UINT abitBps, UINT dbitBps);
+
+private:
+    struct TxFrame;
+    struct Channel;
+    struct Device;
+    struct Bus;
+    struct Winner;
+
+    SimCan() = default;
+
+    Device* FindDevice(DEVICE_HANDLE deviceHandle);
+    Channel* FindChannel(CHANNEL_HANDLE channelHandle);
+    Bus* GetBus(UINT busId);
+    bool IsLive(const Channel* channel, uint64_t serial) const;
+    static UINT64 DeviceTimestamp(const Device* device, int64_t ns);
+    std::thread DetachChannel(Channel* channel);
+    void ResetChannelState(Channel* channel);
+    bool CanTransmit(const Channel* channel) const;
+    bool Enqueue(Channel* channel, TxFrame&& frame);
+    bool Wait(std::unique_lock<std::mutex>& lock, Device* device, std::condition_variable& cv, int waitMs,
+              const std::function<bool()>& ready);
+    bool SetChannelValue(Device* device, UINT channelIndex, const std::string& key, const std::string& value);
+    bool SetSimValue(Device* device, const std::string& key, const std::string& value);
+    std::string FormatStats(Bus* bus);
+
+    void RunBus(Bus* bus, uint64_t generation);
+    int64_t NextReady(Bus* bus);
+    bool PickWinner(Bus* bus, int64_t horizon, Winner* winner);
+    bool Compatible(const Channel* channel, const Winner& winner) const;
+    bool Receiving(const Channel* channel) const;
+    void Deliver(Bus* bus, const Winner& winner, int64_t endNs);
+    void InjectError(Bus* bus, const Winner& winner, int64_t endNs);
+    void PushFrame(Channel* channel, const canfd_frame& frame, bool fd, bool echo, int64_t endNs);
+    void PushError(Channel* channel, BYTE subType, int64_t endNs);
+    void UpdateErrorState(Channel* channel);
+
+    std::mutex mutex_;
+    std::condition_variable closeCv_;
+    std::map<uint64_t, std::unique_ptr<Device>> devices_;   // (类型 << 32 | 索引) -> 设备
+    std::unordered_map<const void*, Channel*> channels_;    // 通道句柄 -> 通道
+    std::map<UINT, std::unique_ptr<Bus>> buses_;            // 总线号 -> 总线，创建后不再删除
+    uint64_t nextSerial_ = 1;
+    DEVICE_HANDLE propertyDevice_ = nullptr;
+};
+
+#endif  // ZLGCAN_SIM_CAN_H_
@@ -0,0 +1,141 @@
+/**
+ * zlgcan.h的仿真实现，替代zlgcan.lib链接进zlgcan_sim目标
+ *
+ * CAN/CANFD收发、合并接收、错误信息和属性接口由SimCan实现；LIN、UDS和云接口不仿真（见zlgcan_unsupported.cpp），
+ * 返回STATUS_UNSUPPORTED（或无效句柄/0）。
+ *
+ * 仿真参数（ZCAN_SetValue）：
+ *   "N/canfd_abit_baud_rate" "N/canfd_dbit_baud_rate" "N/baud_rate"  通道位速率，默认500k/2M
+ *   "N/sim_bus"              通道所在的仿真总线号，默认0（所有设备的所有通道互连），下次StartCAN生效
+ *   "N/sim_bus_off"          1强制总线关闭，0恢复并清零错误计数
+ *   "N/sim_tec" "N/sim_rec"  直接设置发送/接收错误计数，节点状态随之变化
+ *   "N/sim_rx_capacity" "N/sim_tx_capacity"  接收/发送缓冲容量（帧）
+ *   "0/set_device_recv_merge"  1启用合并接收（ZCAN_ReceiveData，含错误数据）
+ *   "sim/online"             0模拟设备离线
+ *   "sim/clock_ppm"          设备时钟频偏，作用于接收时间戳
+ *   "sim/[总线号/]realtime"   1按墙钟节拍投递（默认），0不等待帧时长
+ *   "sim/[总线号/]load"       背景负载占用率0~0.95，只占用总线不投递
+ *   "sim/[总线号/]error_rate" "drop_rate" "tx_fail_rate"  错误注入概率
+ *   "sim/[总线号/]seed"       随机数种子
+ *   "sim/[总线号/]generator"  添加流量发生器，"id=0x123;len=8;period_us=1000;count=0;fd=1;brs=1;ext=0;
+ *                            pattern=counter|random|fixed;data=01 02"
+ *   "sim/[总线号/]generator_clear" "sim/[总线号/]stats_reset"
+ * ZCAN_GetValue("sim/[总线号/]stats")返回总线统计，"N/get_device_available_tx_count/1"返回剩余发送缓存。
+ */
+#include "sim_can.h"
+
+namespace {
+
+int PropertySetValue(const char* path, const char* value) {
+    SimCan& sim = SimCan::Instance();
+    return sim.SetValue(sim.PropertyDevice(), path, value) == STATUS_OK ? 1 : 0;
+}
+
+const char* PropertyGetValue(const char* path) {
+    SimCan& sim = SimCan::Instance();
+    return sim.GetValue(sim.PropertyDevice(), path);
+}
+
+const ConfigNode* PropertyGetPropertys() {
+    return nullptr;
+}
+
+IProperty g_property = {PropertySetValue, PropertyGetValue, PropertyGetPropertys};
+
+}  // namespace
+
+// ==================== 设备 ====================
+
+DEVICE_HANDLE FUNC_CALL ZCAN_OpenDevice(UINT device_type, UINT device_index, UINT reserved) {
+    (void)reserved;
+    return SimCan::Instance().OpenDevice(device_type, device_index);
+}
+
+UINT FUNC_CALL ZCAN_CloseDevice(DEVICE_HANDLE device_handle) {
+    return SimCan::Instance().CloseDevice(device_handle);
+}
+
+UINT FUNC_CALL ZCAN_GetDeviceInf(DEVICE_HANDLE device_handle, ZCAN_DEVICE_INFO* pInfo) {
+    return SimCan::Instance().GetDeviceInfo(device_handle, pInfo);
+}
+
+UINT FUNC_CALL ZCAN_GetDeviceInfoEx(DEVICE_HANDLE device_handle, ZCAN_DEVICE_INFO_EX* pInfo) {
+    return SimCan::Instance().GetDeviceInfoEx(device_handle, pInfo);
+}
+
+UINT FUNC_CALL ZCAN_IsDeviceOnLine(DEVICE_HANDLE device_handle) {
+    return SimCan::Instance().IsDeviceOnline(device_handle);
+}
+
+// ==================== CAN ====================
+
+CHANNEL_HANDLE FUNC_CALL ZCAN_InitCAN(DEVICE_HANDLE device_handle, UINT can_index,
+                                      ZCAN_CHANNEL_INIT_CONFIG* pInitConfig) {
+    return SimCan::Instance().InitCan(device_handle, can_index, pInitConfig);
+}
+
+UINT FUNC_CALL ZCAN_StartCAN(CHANNEL_HANDLE channel_handle) {
+    return SimCan::Instance().StartCan(channel_handle);
+}
+
+UINT FUNC_CALL ZCAN_ResetCAN(CHANNEL_HANDLE channel_handle) {
+    return SimCan::Instance().ResetCan(channel_handle);
+}
+
+UINT FUNC_CALL ZCAN_ClearBuffer(CHANNEL_HANDLE channel_handle) {
+    return SimCan::Instance().ClearBuffer(channel_handle);
+}
+
+UINT FUNC_CALL ZCAN_ReadChannelErrInfo(CHANNEL_HANDLE channel_handle, ZCAN_CHANNEL_ERR_INFO* pErrInfo) {
+    return SimCan::Instance().ReadChannelErrInfo(channel_handle, pErrInfo);
+}
+
+UINT FUNC_CALL ZCAN_ReadChannelStatus(CHANNEL_HANDLE channel_handle, ZCAN_CHANNEL_STATUS* pCANStatus) {
+    return SimCan::Instance().ReadChannelStatus(channel_handle, pCANStatus);
+}
+
+UINT FUNC_CALL ZCAN_GetReceiveNum(CHANNEL_HANDLE channel_handle, BYTE type) {
+    return SimCan::Instance().GetReceiveNum(channel_handle, type);
+}
+
+UINT FUNC_CALL ZCAN_Transmit(CHANNEL_HANDLE channel_handle, ZCAN_Transmit_Data* pTransmit, UINT len) {
+    return SimCan::Instance().Transmit(channel_handle, pTransmit, len);
+}
+
+UINT FUNC_CALL ZCAN_Receive(CHANNEL_HANDLE channel_handle, ZCAN_Receive_Data* pReceive, UINT len, int wait_time) {
+    return SimCan::Instance().Receive(channel_handle, pReceive, len, wait_time);
+}
+
+UINT FUNC_CALL ZCAN_TransmitFD(CHANNEL_HANDLE channel_handle, ZCAN_TransmitFD_Data* pTransmit, UINT len) {
+    return SimCan::Instance().TransmitFD(channel_handle, pTransmit, len);
+}
+
+UINT FUNC_CALL ZCAN_ReceiveFD(CHANNEL_HANDLE channel_handle, ZCAN_ReceiveFD_Data* pReceive, UINT len,
+                              int wait_time) {
+    return SimCan::Instance().ReceiveFD(channel_handle, pReceive, len, wait_time);
+}
+
+UINT FUNC_CALL ZCAN_TransmitData(DEVICE_HANDLE device_handle, ZCANDataObj* pTransmit, UINT len) {
+    return SimCan::Instance().TransmitData(device_handle, pTransmit, len);
+}
+
+UINT FUNC_CALL ZCAN_ReceiveData(DEVICE_HANDLE device_handle, ZCANDataObj* pReceive, UINT len, int wait_time) {
+    return SimCan::Instance().ReceiveData(device_handle, pReceive, len, wait_time);
+}
+
+UINT FUNC_CALL ZCAN_SetValue(DEVICE_HANDLE device_handle, const char* path, const void* value) {
+    return SimCan::Instance().SetValue(device_handle, path, static_cast<const char*>(value));
+}
+
+const void* FUNC_CALL ZCAN_GetValue(DEVICE_HANDLE device_handle, const char* path) {
+    return SimCan::Instance().GetValue(device_handle, path);
+}
+
+IProperty* FUNC_CALL GetIProperty(DEVICE_HANDLE device_handle) {
+    SimCan::Instance().SetPropertyDevice(device_handle);
+    return &g_property;
+}
+
+UINT FUNC_CALL ReleaseIProperty(IProperty* pIProperty) {
+    return pIProperty == &g_property ? STATUS_OK : STATUS_ERR;
+}
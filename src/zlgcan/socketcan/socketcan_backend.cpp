@@ -0,0 +1,1002 @@
+#include "socketcan_backend.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t DEFAULT_RX_CAPACITY = 65536;
+constexpr size_t ECHO_PENDING_LIMIT = 65536;
+constexpr int TX_WAIT_MS = 50;         // 网卡发送队列满时的最长等待
+constexpr unsigned RX_BATCH = 64;
+constexpr int RX_ROUNDS = 16;          // 每次唤醒单个socket最多读取的批数，避免饿死其他通道
+constexpr uint64_t WAKE_TOKEN = UINT64_MAX;
+constexpr BYTE FD_FLAGS = CANFD_BRS | CANFD_ESI;
+
+int64_t RealtimeNs() {
+    struct timespec now;
+    ::clock_gettime(CLOCK_REALTIME, &now);
+    return static_cast<int64_t>(now.tv_sec) * 1000000000LL + now.tv_nsec;
+}
+
+UINT ChannelCount(UINT deviceType) {
+    switch (deviceType) {
+        case ZCAN_USBCANFD_100U:
+        case ZCAN_USBCANFD_MINI:
+            return 1;
+        case ZCAN_USBCANFD_400U:
+            return 4;
+        case ZCAN_USBCANFD_800U:
+        case ZCAN_USBCANFD_800H:
+            return 8;
+        default:
+            return 2;
+    }
+}
+
+// 默认接口名：ZLGCAN_SOCKETCAN_INTERFACES="vcan0,vcan1"按(设备索引*通道数+通道号)取，未列出时为can<n>
+std::string DefaultInterface(UINT deviceIndex, UINT channelIndex, UINT channelCount) {
+    const UINT position = deviceIndex * channelCount + channelIndex;
+    const char* list = std::getenv("ZLGCAN_SOCKETCAN_INTERFACES");
+    if (list != nullptr) {
+        std::string names(list);
+        UINT current = 0;
+        size_t start = 0;
+        while (start <= names.size()) {
+            size_t end = names.find(',', start);
+            if (end == std::string::npos) {
+                end = names.size();
+            }
+            if (current == position && end > start) {
+                return names.substr(start, end - start);
+            }
+            current++;
+            start = end + 1;
+        }
+    }
+    return "can" + std::to_string(position);
+}
+
+bool ParseUint(const std::string& text, uint64_t* value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    *value = std::strtoull(text.c_str(), &end, 0);
+    return end != nullptr && *end == '\0';
+}
+
+}  // namespace
+
+// ==================== 内部结构 ====================
+
+struct SocketCanBackend::Channel {
+    Device* device = nullptr;
+    UINT index = 0;
+    std::string interfaceName;
+    SocketCanPort port;
+    bool initialized = false;
+    bool started = false;
+    bool canfd = false;
+    bool listenOnly = false;
+
+    std::mutex txMutex;                // 串行化sendmmsg与echoPending的追加
+    // 已发送帧的ID及是否需要回显，按发送顺序与回环的本socket帧（MSG_CONFIRM）配对；
+    // 被CAN_RAW_FILTER滤掉的回环帧不会返回，配对时跳过
+    std::deque<std::pair<UINT, bool>> echoPending;
+
+    std::vector<SocketCanRange> ranges;  // 已确认的验收范围，空为全部接收
+    SocketCanRange pendingRange;
+
+    std::deque<ZCAN_Receive_Data> rxCan;
+    std::deque<ZCAN_ReceiveFD_Data> rxFd;
+    size_t rxCapacity = DEFAULT_RX_CAPACITY;
+    std::condition_variable rxCv;
+
+    UINT tec = 0;
+    UINT rec = 0;
+    UINT errorCode = 0;
+    BYTE nodeState = ZCAN_NODE_STATE_ACTIVE;
+    uint32_t kernelDropped = 0;
+};
+
+struct SocketCanBackend::Device {
+    UINT type = 0;
+    UINT index = 0;
+    int64_t epochNs = 0;               // CLOCK_REALTIME，软件时间戳的零点
+    bool closing = false;
+    int users = 0;                     // 进行中的阻塞接收和发送调用
+    std::vector<std::unique_ptr<Channel>> channels;
+
+    bool merged = false;
+    std::deque<ZCANDataObj> mergedRx;
+    std::condition_variable mergedCv;
+
+    std::map<std::string, std::string> values;
+
+    std::mutex ioMutex;                // 接收线程读socket期间持有，InitCAN重开socket前获取
+    int epollFd = -1;
+    int wakeFd = -1;
+    std::thread thread;
+    std::atomic<bool> stop{false};
+
+    ~Device() {
+        if (epollFd >= 0) {
+            ::close(epollFd);
+        }
+        if (wakeFd >= 0) {
+            ::close(wakeFd);
+        }
+    }
+};
+
+// ==================== 设备 ====================
+
+SocketCanBackend& SocketCanBackend::Instance() {
+    // 不析构：进程退出时接收线程可能仍阻塞在epoll_wait
+    static SocketCanBackend* instance = new SocketCanBackend();
+    return *instance;
+}
+
+DEVICE_HANDLE SocketCanBackend::OpenDevice(UINT deviceType, UINT deviceIndex) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t key = (static_cast<uint64_t>(deviceType) << 32) | deviceIndex;
+    if (devices_.count(key) != 0) {
+        return INVALID_DEVICE_HANDLE;
+    }
+
+    auto device = std::make_unique<Device>();
+    device->type = deviceType;
+    device->index = deviceIndex;
+    device->epochNs = RealtimeNs();
+    device->epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    device->wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (device->epollFd < 0 || device->wakeFd < 0) {
+        return INVALID_DEVICE_HANDLE;
+    }
+    struct epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u64 = WAKE_TOKEN;
+    ::epoll_ctl(device->epollFd, EPOLL_CTL_ADD, device->wakeFd, &event);
+
+    const UINT channelCount = ChannelCount(deviceType);
+    for (UINT i = 0; i < channelCount; i++) {
+        auto channel = std::make_unique<Channel>();
+        channel->device = device.get();
+        channel->index = i;
+        channel->interfaceName = DefaultInterface(deviceIndex, i, channelCount);
+        channels_[channel.get()] = channel.get();
+        device->channels.push_back(std::move(channel));
+    }
+
+    Device* handle = device.get();
+    devices_[key] = std::move(device);
+    return handle;
+}
+
+UINT SocketCanBackend::CloseDevice(DEVICE_HANDLE deviceHandle) {
+    Device* device = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        device = FindDevice(deviceHandle);
+        if (device == nullptr) {
+            return STATUS_ERR;
+        }
+        device->closing = true;
+        for (auto& channel : device->channels) {
+            channel->rxCv.notify_all();
+        }
+        device->mergedCv.notify_all();
+    }
+
+    StopReceiveThread(device);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    closeCv_.wait(lock, [device] { return device->users == 0; });
+    for (auto& channel : device->channels) {
+        channel->port.Close();
+        channels_.erase(channel.get());
+    }
+    if (propertyDevice_ == deviceHandle) {
+        propertyDevice_ = nullptr;
+    }
+    devices_.erase((static_cast<uint64_t>(device->type) << 32) | device->index);
+    return STATUS_OK;
+}
+
+UINT SocketCanBackend::GetDeviceInfo(DEVICE_HANDLE deviceHandle, ZCAN_DEVICE_INFO* info) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device* device = FindDevice(deviceHandle);
+    if (device == nullptr || info == nullptr) {
+        return STATUS_ERR;
+    }
+
+    std::memset(info, 0, sizeof(*info));
+    info->hw_Version = 0x0100;
+    info->fw_Version = 0x0100;
+    info->dr_Version = 0x0100;
+    info->in_Version = 0x0100;
+    info->can_Num = static_cast<BYTE>(device->channels.size());
+    std::snprintf(reinterpret_cast<char*>(info->str_Serial_Num), sizeof(info->str_Serial_Num), "SOCKETCAN%u",
+                  device->index);
+    std::snprintf(reinterpret_cast<char*>(info->str_hw_Type), sizeof(info->str_hw_Type), "SocketCAN-%s",
+                  device->channels.front()->interfaceName.c_str());
+    return STATUS_OK;
+}
+
+UINT SocketCanBackend::GetDeviceInfoEx(DEVICE_HANDLE deviceHandle, ZCAN_DEVICE_INFO_EX* info) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device* device = FindDevice(deviceHandle);
+    if (device == nullptr || info == nullptr) {
+        return STATUS_ERR;
+    }
+
+    std::memset(info, 0, sizeof(*info));
+    info->hardware_version.major_version = 1;
+    info->firmware_version.major_version = 1;
+    info->driver_version.major_version = 1;
+    info->library_version.major_version = 1;
+    info->device_info_version.major_version = 1;
+    std::string names;
+    for (const auto& channel : device->channels) {
+        names += (names.empty() ? "" : ",") + channel->interfaceName;
+    }
+    std::snprintf(reinterpret_cast<char*>(info->device_name), sizeof(info->device_name), "SocketCAN(%s)",
+                  names.c_str());
+    std::snprintf(reinterpret_cast<char*>(info->hardware_type), sizeof(info->hardware_type), "SocketCAN");
+    std::snprintf(reinterpret_cast<char*>(info->serial_number), sizeof(info->serial_number), "SOCKETCAN%u",
+                  device->index);
+    info->can_channel_number = static_cast<BYTE>(device->channels.size());
+    return STATUS_OK;
+}
+
+UINT SocketCanBackend::IsDeviceOnline(DEVICE_HANDLE deviceHandle) {
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Device* device = FindDevice(deviceHandle);
+        if (device == nullptr) {
+            return STATUS_ERR;
+        }
+        for (const auto& channel : device->channels) {
+            if (channel->initialized) {
+                names.push_back(channel->interfaceName);
+            }
+        }
+        if (names.empty()) {
+            names.push_back(device->channels.front()->interfaceName);
+        }
+    }
+
+    for (const auto& name : names) {
+        if (!SocketCanInterfaceUp(name)) {
+            return STATUS_OFFLINE;
+        }
+    }
+    return STATUS_ONLINE;
+}
+
+// ==================== 通道 ====================
+
+CHANNEL_HANDLE SocketCanBackend::InitCan(DEVICE_HANDLE deviceHandle, UINT channelIndex,
+                                         const ZCAN_CHANNEL_INIT_CONFIG* config) {
+    Device* device = nullptr;
+    Channel* channel = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        device = FindDevice(deviceHandle);
+        if (device == nullptr || config == nullptr || channelIndex >= device->channels.size()) {
+            return INVALID_CHANNEL_HANDLE;
+        }
+        channel = device->channels[channelIndex].get();
+        device->users++;
+    }
+
+    // 重开socket：先停住接收线程对该socket的读取和并发发送
+    std::lock_guard<std::mutex> ioLock(device->ioMutex);
+    std::lock_guard<std::mutex> txLock(channel->txMutex);
+    std::lock_guard<std::mutex> lock(mutex_);
+    device->users--;
+    if (device->closing) {
+        closeCv_.notify_all();
+        return INVALID_CHANNEL_HANDLE;
+    }
+
+    if (channel->started) {
+        ::epoll_ctl(device->epollFd, EPOLL_CTL_DEL, channel->port.Fd(), nullptr);
+        channel->started = false;
+    }
+    bool fd = config->can_type == TYPE_CANFD;
+    if (!channel->port.Open(channel->interfaceName, fd)) {
+        // 接口MTU为CAN_MTU时退化为经典CAN
+        fd = false;
+        if (!channel->port.Open(channel->interfaceName, false)) {
+            channel->initialized = false;
+            return INVALID_CHANNEL_HANDLE;
+        }
+    }
+
+    channel->canfd = fd;
+    channel->listenOnly = (fd ? config->canfd.mode : config->can.mode) == 1;
+    channel->echoPending.clear();
+    channel->rxCan.clear();
+    channel->rxFd.clear();
+    channel->tec = 0;
+    channel->rec = 0;
+    channel->errorCode = 0;
+    channel->nodeState = ZCAN_NODE_STATE_ACTIVE;
+    channel->kernelDropped = 0;
+    channel->initialized = true;
+    ApplyFilters(channel);
+    return channel;
+}
+
+UINT SocketCanBackend::StartCan(CHANNEL_HANDLE channelHandle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Channel* channel = FindChannel(channelHandle);
+    if (channel == nullptr || !channel->initialized || !channel->port.IsOpen()) {
+        return STATUS_ERR;
+    }
+    if (channel->started) {
+        return STATUS_OK;
+    }
+
+    Device* device = channel->device;
+    struct epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u64 = channel->index;
+    if (::epoll_ctl(device->epollFd, EPOLL_CTL_ADD, channel->port.Fd(), &event) != 0) {
+        return STATUS_ERR;
+    }
+    channel->started = true;
+
+    if (!device->thread.joinable()) {
+        device->stop.store(false);
+        device->thread = std::thread(&SocketCanBackend::RunReceive, this, device);
+    }
+    return STATUS_OK;
+}
+
+UINT SocketCanBackend::ResetCan(CHANNEL_HANDLE channelHandle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Channel* channel = FindChannel(channelHandle);
+    if (channel == nullptr) {
+        return STATUS_ERR;
+    }
+
+    // socket保持打开（关闭在InitCAN/CloseDevice中进行），只停止接收并清空状态
+    if (channel->started) {
+        ::epoll_ctl(channel->device->epollFd, EPOLL_CTL_DEL, channel->port.Fd(), nullptr);
+        channel->started = false;
+    }
+    channel->echoPending.clear();
+    channel->rxCan.clear();
+    channel->rxFd.clear();
+    channel->errorCode = 0;
+    channel->rxCv.notify_all();
+    return STATUS_OK;
+}
+
+UINT SocketCanBackend::ClearBuffer(CHANNEL_HANDLE channelHandle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Channel* channel = FindChannel(channelHandle);
+    if (channel == nullptr) {
+        return STATUS_ERR;
+    }
+
+    channel->rxCan.clear();
+    channel->rxFd.clear();
+    auto& merged = channel->device->mergedRx;
+    merged.erase(std::remove_if(merged.begin(), merged.end(),
+                                [channel](const ZCANDataObj& obj) { return obj.chnl == channel->index; }),
+                 merged.end());
+    return STATUS_OK;
+}
+
+UINT SocketCanBackend::ReadChannelErrInfo(CHANNEL_HANDLE channelHandle, ZCAN_CHANNEL_ERR_INFO* info) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Channel* channel = FindChannel(channelHandle);
+    if (channel == nullptr || info == nullptr) {
+        return STATUS_ERR;
+    }
+
+    std::memset(info, 0, sizeof(*info));
+    UINT code = channel->errorCode;
+    if (channel->nodeState == ZCAN_NODE_STATE_BUSOFF) {
+        code |= ZCAN_ERROR_CAN_BUSOFF;
+    } else if (channel->nodeState == ZCAN_NODE_STATE_PASSIVE) {
+        code |= ZCAN_ERROR_CAN_PASSIVE;
+    } else if (channel->nodeState == ZCAN_NODE_STATE_WARNNING) {
+        code |= ZCAN_ERROR_CAN_ERRALARM;
+    }
+    info->error_code = code;
+    info->passive_ErrData[1] = static_cast<BYTE>(std::min<UINT>(channel->rec, 255));
+    info->passive_ErrData[2] = static_cast<BYTE>(std::min<UINT>(channel->tec, 255));
+    channel->errorCode = 0;
+    return STATUS_OK;
+}
+
+UINT SocketCanBackend::ReadChannelStatus(CHANNEL_HANDLE channelHandle, ZCAN_CHANNEL_STATUS* status) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Channel* channel = FindChannel(channelHandle);
+    if (channel == nullptr || status == nullptr) {
+        return STATUS_ERR;
+    }
+
+    std::memset(status, 0, sizeof(*status));
+    status->regMode = channel->listenOnly ? 1 : 0;
+    if (channel->nodeState == ZCAN_NODE_STATE_BUSOFF) {
+        status->regStatus |= 0x80;
+    }
+    if (channel->nodeState == ZCAN_NODE_STATE_WARNNING || channel->nodeState == ZCAN_NODE_STATE_PASSIVE) {
+        status->regStatus |= 0x40;
+    }
+    status->regEWLimit = 96;
+    status->regRECounter = static_cast<BYTE>(std::min<UINT>(channel->rec, 255));
+    status->regTECounter = static_cast<BYTE>(std::min<UINT>(channel->tec, 255));
+    return STATUS_OK;
+}
+
+UINT SocketCanBackend::GetReceiveNum(CHANNEL_HANDLE channelHandle, BYTE type) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Channel* channel = FindChannel(channelHandle);
+    if (channel == nullptr) {
+        return 0;
+    }
+
+    switch (type) {
+        case TYPE_CAN:
+            return static_cast<UINT>(channel->rxCan.size());
+        case TYPE_CANFD:
+            return static_cast<UINT>(channel->rxFd.size());
+        case TYPE_ALL_DATA:
+            if (channel->device->merged) {
+                return static_cast<UINT>(channel->device->mergedRx.size());
+            }
+            return static_cast<UINT>(channel->rxCan.size() + channel->rxFd.size());
+        default:
+            return 0;
+    }
+}
+
+// ==================== 收发 ====================
+
+UINT SocketCanBackend::Transmit(CHANNEL_HANDLE channelHandle, const ZCAN_Transmit_Data* frames, UINT count) {
+    Channel* channel = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        channel = FindChannel(channelHandle);
+        if (channel == nullptr || frames == nullptr || !channel->started || channel->listenOnly) {
+            return 0;
+        }
+        channel->device->users++;
+    }
+
+    std::vector<SocketCanFrame> raw(count);
+    std::vector<bool> fd(count, false);
+    std::vector<bool> echo(count, false);
+    for (UINT i = 0; i < count; i++) {
+        const can_frame& in = frames[i].frame;
+        SocketCanFrame& out = raw[i];
+        std::memset(&out, 0, sizeof(SocketCanFrame));
+        out.id = in.can_id;
+        out.len = std::min<BYTE>(in.can_dlc, CAN_MAX_DLEN);
+        std::memcpy(out.data, in.data, CAN_MAX_DLEN);
+        echo[i] = frames[i].transmit_type >= 2 || (in.__pad & TX_ECHO_FLAG);
+    }
+    return Send(channel, raw, fd, echo);
+}
+
+UINT SocketCanBackend::TransmitFD(CHANNEL_HANDLE channelHandle, const ZCAN_TransmitFD_Data* frames, UINT count) {
+    Channel* channel = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        channel = FindChannel(channelHandle);
+        if (channel == nullptr || frames == nullptr || !channel->started || channel->listenOnly ||
+            !channel->canfd) {
+            return 0;
+        }
+        channel->device->users++;
+    }
+
+    std::vector<SocketCanFrame> raw(count);
+    std::vector<bool> fd(count, true);
+    std::vector<bool> echo(count, false);
+    for (UINT i = 0; i < count; i++) {
+        const canfd_frame& in = frames[i].frame;
+        SocketCanFrame& out = raw[i];
+        std::memcpy(&out, &in, sizeof(SocketCanFrame));
+        out.len = std::min<BYTE>(in.len, CANFD_MAX_DLEN);
+        out.flags = in.flags & FD_FLAGS;
+        out.res0 = 0;
+        out.res1 = 0;
+        echo[i] = frames[i].transmit_type >= 2 || (in.flags & TX_ECHO_FLAG);
+    }
+    return Send(channel, raw, fd, echo);
+}
+
+UINT SocketCanBackend::Send(Channel* channel, std::vector<SocketCanFrame>& frames, std::vector<bool>& fd,
+                            std::vector<bool>& echo) {
+    Device* device = channel->device;
+    const UINT count = static_cast<UINT>(frames.size());
+    UINT sent = 0;
+    {
+        std::lock_guard<std::mutex> txLock(channel->txMutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (UINT i = 0; i < count; i++) {
+                channel->echoPending.emplace_back(frames[i].id, echo[i]);
+            }
+            while (channel->echoPending.size() > ECHO_PENDING_LIMIT) {
+                channel->echoPending.pop_front();
+            }
+        }
+
+        std::unique_ptr<bool[]> fdFlags(new bool[count]);
+        for (UINT i = 0; i < count; i++) {
+            fdFlags[i] = fd[i];
+        }
+        sent = channel->port.Send(frames.data(), fdFlags.get(), count, TX_WAIT_MS);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (UINT i = sent; i < count && !channel->echoPending.empty(); i++) {
+            channel->echoPending.pop_back();
+        }
+    }
+
+    Release(device);
+    return sent;
+}
+
+UINT SocketCanBackend::Receive(CHANNEL_HANDLE channelHandle, ZCAN_Receive_Data* frames, UINT count, int waitMs) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    Channel* channel = FindChannel(channelHandle);
+    if (channel == nullptr || frames == nullptr || count == 0) {
+        return 0;
+    }
+    if (!Wait(lock, channel->device, channel->rxCv, waitMs, [channel] { return !channel->rxCan.empty(); })) {
+        return 0;
+    }
+
+    UINT received = 0;
+    while (received < count && !channel->rxCan.empty()) {
+        frames[received++] = channel->rxCan.front();
+        channel->rxCan.pop_front();
+    }
+    return received;
+}
+
+UINT SocketCanBackend::ReceiveFD(CHANNEL_HANDLE channelHandle, ZCAN_ReceiveFD_Data* frames, UINT count,
+                                 int waitMs) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    Channel* channel = FindChannel(channelHandle);
+    if (channel == nullptr || frames == nullptr || count == 0) {
+        return 0;
+    }
+    if (!Wait(lock, channel->device, channel->rxCv, waitMs, [channel] { return !channel->rxFd.empty(); })) {
+        return 0;
+    }
+
+    UINT received = 0;
+    while (received < count && !channel->rxFd.empty()) {
+        frames[received++] = channel->rxFd.front();
+        channel->rxFd.pop_front();
+    }
+    return received;
+}
+
+UINT SocketCanBackend::TransmitData(DEVICE_HANDLE deviceHandle, const ZCANDataObj* objs, UINT count) {
+    // 按通道分段批量发送；队列延时发送不支持，按普通帧立即发送
+    UINT sent = 0;
+    while (sent < count) {
+        Channel* channel = nullptr;
+        UINT end = sent;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Device* device = FindDevice(deviceHandle);
+            if (device == nullptr || objs == nullptr) {
+                return sent;
+            }
+            const ZCANDataObj& first = objs[sent];
+            if (first.dataType != ZCAN_DT_ZCAN_CAN_CANFD_DATA || first.chnl >= device->channels.size()) {
+                return sent;
+            }
+            channel = device->channels[first.chnl].get();
+            if (!channel->started || channel->listenOnly) {
+                return sent;
+            }
+            while (end < count && objs[end].dataType == ZCAN_DT_ZCAN_CAN_CANFD_DATA &&
+                   objs[end].chnl == first.chnl) {
+                end++;
+            }
+            device->users++;
+        }
+
+        const UINT batch = end - sent;
+        std::vector<SocketCanFrame> raw(batch);
+        std::vector<bool> fd(batch, false);
+        std::vector<bool> echo(batch, false);
+        for (UINT i = 0; i < batch; i++) {
+            const ZCANCANFDData& data = objs[sent + i].data.zcanCANFDData;
+            fd[i] = data.flag.unionVal.frameType == 1 && channel->canfd;
+            std::memcpy(&raw[i], &data.frame, sizeof(SocketCanFrame));
+            raw[i].len = std::min<BYTE>(data.frame.len, fd[i] ? CANFD_MAX_DLEN : CAN_MAX_DLEN);
+            raw[i].flags = fd[i] ? (data.frame.flags & FD_FLAGS) : 0;
+            raw[i].res0 = 0;
+            raw[i].res1 = 0;
+            echo[i] = data.flag.unionVal.transmitType >= 2 || data.flag.unionVal.txEchoRequest;
+        }
+        const UINT accepted = Send(channel, raw, fd, echo);
+        sent += accepted;
+        if (accepted < batch) {
+            break;
+        }
+    }
+    return sent;
+}
+
+UINT SocketCanBackend::ReceiveData(DEVICE_HANDLE deviceHandle, ZCANDataObj* objs, UINT count, int waitMs) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    Device* device = FindDevice(deviceHandle);
+    if (device == nullptr || objs == nullptr || count == 0) {
+        return 0;
+    }
+    if (!Wait(lock, device, device->mergedCv, waitMs, [device] { return !device->mergedRx.empty(); })) {
+        return 0;
+    }
+
+    UINT received = 0;
+    while (received < count && !device->mergedRx.empty()) {
+        objs[received++] = device->mergedRx.front();
+        device->mergedRx.pop_front();
+    }
+    return received;
+}
+
+// ==================== 属性 ====================
+
+UINT SocketCanBackend::SetValue(DEVICE_HANDLE deviceHandle, const char* path, const char* value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device* device = FindDevice(deviceHandle);
+    if (device == nullptr || path == nullptr || value == nullptr) {
+        return STATUS_ERR;
+    }
+
+    const std::string key(path);
+    const std::string text(value);
+    const size_t slash = key.find('/');
+    uint64_t channelIndex = 0;
+    if (slash != std::string::npos && ParseUint(key.substr(0, slash), &channelIndex) &&
+        !SetChannelValue(device, static_cast<UINT>(channelIndex), key.substr(slash + 1), text)) {
+        return STATUS_ERR;
+    }
+    device->values[key] = text;
+    return STATUS_OK;
+}
+
+const char* SocketCanBackend::GetValue(DEVICE_HANDLE deviceHandle, const char* path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device* device = FindDevice(deviceHandle);
+    if (device == nullptr || path == nullptr) {
+        return nullptr;
+    }
+
+    auto it = device->values.find(path);
+    return it == device->values.end() ? nullptr : it->second.c_str();
+}
+
+void SocketCanBackend::SetPropertyDevice(DEVICE_HANDLE deviceHandle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    propertyDevice_ = deviceHandle;
+}
+
+DEVICE_HANDLE SocketCanBackend::PropertyDevice() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return propertyDevice_;
+}
+
+bool SocketCanBackend::SetChannelValue(Device* device, UINT channelIndex, const std::string& key,
+                                       const std::string& value) {
+    if (key == "set_device_recv_merge") {
+        device->merged = value != "0";
+        return true;
+    }
+    if (channelIndex >= device->channels.size()) {
+        return false;
+    }
+
+    Channel* channel = device->channels[channelIndex].get();
+    uint64_t number = 0;
+    if (key == "interface") {
+        // 下次InitCAN生效
+        if (value.empty()) {
+            return false;
+        }
+        channel->interfaceName = value;
+    } else if (key == "filter_mode") {
+        if (!ParseUint(value, &number)) {
+            return false;
+        }
+        channel->pendingRange.extended = number != 0;
+    } else if (key == "filter_start" || key == "filter_end") {
+        if (!ParseUint(value, &number)) {
+            return false;
+        }
+        (key == "filter_start" ? channel->pendingRange.start : channel->pendingRange.end) =
+            static_cast<uint32_t>(number);
+    } else if (key == "filter_ack") {
+        if (channel->pendingRange.start > channel->pendingRange.end) {
+            return false;
+        }
+        channel->ranges.push_back(channel->pendingRange);
+        ApplyFilters(channel);
+    } else if (key == "filter_clear") {
+        channel->ranges.clear();
+        ApplyFilters(channel);
+    } else if (key == "rx_capacity") {
+        if (!ParseUint(value, &number) || number == 0) {
+            return false;
+        }
+        channel->rxCapacity = static_cast<size_t>(number);
+    }
+    return true;
+}
+
+void SocketCanBackend::ApplyFilters(Channel* channel) {
+    if (channel->port.IsOpen()) {
+        channel->port.SetFilters(SocketCanFilters(channel->ranges));
+    }
+}
+
+// ==================== 内部 ====================
+
+SocketCanBackend::Device* SocketCanBackend::FindDevice(DEVICE_HANDLE deviceHandle) {
+    for (auto& entry : devices_) {
+        if (entry.second.get() == deviceHandle) {
+            return entry.second->closing ? nullptr : entry.second.get();
+        }
+    }
+    return nullptr;
+}
+
+SocketCanBackend::Channel* SocketCanBackend::FindChannel(CHANNEL_HANDLE channelHandle) {
+    auto it = channels_.find(channelHandle);
+    if (it == channels_.end() || it->second->device->closing) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+void SocketCanBackend::Release(Device* device) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--device->users == 0 && device->closing) {
+        closeCv_.notify_all();
+    }
+}
+
+bool SocketCanBackend::Wait(std::unique_lock<std::mutex>& lock, Device* device, std::condition_variable& cv,
+                            int waitMs, const std::function<bool()>& ready) {
+    if (ready() || waitMs == 0) {
+        return ready();
+    }
+
+    // CloseDevice等待所有阻塞的接收调用返回后才释放设备
+    device->users++;
+    auto done = [device, &ready] { return device->closing || ready(); };
+    if (waitMs < 0) {
+        cv.wait(lock, done);
+    } else {
+        cv.wait_for(lock, std::chrono::milliseconds(waitMs), done);
+    }
+    device->users--;
+    if (device->closing) {
+        closeCv_.notify_all();
+        return false;
+    }
+    return ready();
+}
+
+void SocketCanBackend::StopReceiveThread(Device* device) {
+    if (!device->thread.joinable()) {
+        return;
+    }
+    device->stop.store(true);
+    const uint64_t one = 1;
+    ssize_t written = ::write(device->wakeFd, &one, sizeof(one));
+    (void)written;
+    device->thread.join();
+}
+
+// ==================== 接收线程 ====================
+
+void SocketCanBackend::RunReceive(Device* device) {
+    std::vector<SocketCanRx> batch(RX_BATCH);
+    struct epoll_event events[16];
+
+    while (!device->stop.load()) {
+        const int ready = ::epoll_wait(device->epollFd, events, 16, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        std::lock_guard<std::mutex> ioLock(device->ioMutex);
+        for (int i = 0; i < ready && !device->stop.load(); i++) {
+            if (events[i].data.u64 == WAKE_TOKEN) {
+                uint64_t value = 0;
+                ssize_t readBytes = ::read(device->wakeFd, &value, sizeof(value));
+                (void)readBytes;
+                continue;
+            }
+
+            Channel* channel = device->channels[events[i].data.u64].get();
+            for (int round = 0; round < RX_ROUNDS; round++) {
+                const int count = channel->port.Receive(batch.data(), RX_BATCH);
+                if (count < 0) {
+                    // 接口被删除或关闭：停止监听该socket，IsDeviceOnLine随后报告离线
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    ::epoll_ctl(device->epollFd, EPOLL_CTL_DEL, channel->port.Fd(), nullptr);
+                    channel->started = false;
+                    channel->errorCode |= ZCAN_ERROR_CAN_LOSE;
+                    break;
+                }
+                if (count > 0) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    for (int j = 0; j < count; j++) {
+                        Dispatch(channel, batch[j]);
+                    }
+                }
+                if (count < static_cast<int>(RX_BATCH)) {
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void SocketCanBackend::Dispatch(Channel* channel, const SocketCanRx& rx) {
+    Device* device = channel->device;
+    if (rx.dropped != channel->kernelDropped) {
+        channel->kernelDropped = rx.dropped;
+        channel->errorCode |= ZCAN_ERROR_CAN_BUFFER_OVERFLOW;
+    }
+
+    const UINT64 timestamp = rx.hardwareTimestamp
+                                 ? static_cast<UINT64>(rx.timestampNs / 1000)
+                                 : static_cast<UINT64>(std::max<int64_t>(0, rx.timestampNs - device->epochNs) / 1000);
+
+    if (rx.isError) {
+        ApplyError(channel, rx.error, timestamp);
+        return;
+    }
+
+    if (rx.own) {
+        auto& pending = channel->echoPending;
+        while (!pending.empty() && pending.front().first != rx.frame.id) {
+            pending.pop_front();
+        }
+        if (pending.empty()) {
+            return;
+        }
+        const bool echo = pending.front().second;
+        pending.pop_front();
+        if (echo) {
+            PushFrame(channel, rx.frame, rx.fd, true, timestamp);
+        }
+        return;
+    }
+
+    PushFrame(channel, rx.frame, rx.fd, false, timestamp);
+}
+
+void SocketCanBackend::ApplyError(Channel* channel, const SocketCanError& error, UINT64 timestamp) {
+    if (error.hasCounters) {
+        channel->tec = error.tec;
+        channel->rec = error.rec;
+    }
+    if (error.busError) {
+        channel->errorCode |= ZCAN_ERROR_CAN_BUSERR;
+    }
+    if (error.rxOverflow) {
+        channel->errorCode |= ZCAN_ERROR_CAN_OVERFLOW;
+    }
+
+    BYTE state = channel->nodeState;
+    if (error.busOff) {
+        state = ZCAN_NODE_STATE_BUSOFF;
+        channel->errorCode |= ZCAN_ERROR_CAN_BUSOFF;
+    } else if (error.passive) {
+        state = ZCAN_NODE_STATE_PASSIVE;
+        channel->errorCode |= ZCAN_ERROR_CAN_PASSIVE;
+    } else if (error.warning) {
+        state = ZCAN_NODE_STATE_WARNNING;
+        channel->errorCode |= ZCAN_ERROR_CAN_ERRALARM;
+    } else if (error.active || error.restarted) {
+        state = ZCAN_NODE_STATE_ACTIVE;
+    }
+    channel->nodeState = state;
+
+    Device* device = channel->device;
+    if (!device->merged || device->mergedRx.size() >= channel->rxCapacity) {
+        return;
+    }
+    ZCANDataObj obj{};
+    obj.dataType = ZCAN_DT_ZCAN_ERROR_DATA;
+    obj.chnl = static_cast<BYTE>(channel->index);
+    ZCANErrorData& data = obj.data.zcanErrData;
+    data.timeStamp = timestamp;
+    if (error.busError) {
+        data.errType = ZCAN_ERR_TYPE_BUS_ERR;
+        data.errSubType = error.busErrorType;
+    } else if (error.rxOverflow) {
+        data.errType = ZCAN_ERR_TYPE_CONTROLLER_ERR;
+        data.errSubType = ZCAN_CONTROLLER_RX_FIFO_OVERFLOW;
+    } else {
+        data.errType = ZCAN_ERR_TYPE_BUS_ERR;
+        data.errSubType = ZCAN_BUS_ERR_NODE_STATE_CHAGE;
+    }
+    data.nodeState = state;
+    data.rxErrCount = static_cast<BYTE>(std::min<UINT>(channel->rec, 255));
+    data.txErrCount = static_cast<BYTE>(std::min<UINT>(channel->tec, 255));
+    device->mergedRx.push_back(obj);
+    device->mergedCv.notify_all();
+}
+
+void SocketCanBackend::PushFrame(Channel* channel, const SocketCanFrame& frame, bool fd, bool echo,
+                                 UINT64 timestamp) {
+    Device* device = channel->device;
+    if (device->merged) {
+        if (device->mergedRx.size() >= channel->rxCapacity) {
+            channel->errorCode |= ZCAN_ERROR_CAN_BUFFER_OVERFLOW;
+            return;
+        }
+        ZCANDataObj obj{};
+        obj.dataType = ZCAN_DT_ZCAN_CAN_CANFD_DATA;
+        obj.chnl = static_cast<BYTE>(channel->index);
+        ZCANCANFDData& data = obj.data.zcanCANFDData;
+        data.timeStamp = timestamp;
+        data.flag.unionVal.frameType = fd ? 1 : 0;
+        data.flag.unionVal.txEchoed = echo ? 1 : 0;
+        std::memcpy(&data.frame, &frame, sizeof(SocketCanFrame));
+        device->mergedRx.push_back(obj);
+        device->mergedCv.notify_all();
+        return;
+    }
+
+    if (fd) {
+        if (channel->rxFd.size() >= channel->rxCapacity) {
+            channel->errorCode |= ZCAN_ERROR_CAN_BUFFER_OVERFLOW;
+            return;
+        }
+        ZCAN_ReceiveFD_Data data{};
+        std::memcpy(&data.frame, &frame, sizeof(SocketCanFrame));
+        data.frame.flags = static_cast<BYTE>((frame.flags & FD_FLAGS) | (echo ? TX_ECHO_FLAG : 0));
+        data.timestamp = timestamp;
+        channel->rxFd.push_back(data);
+    } else {
+        if (channel->rxCan.size() >= channel->rxCapacity) {
+            channel->errorCode |= ZCAN_ERROR_CAN_BUFFER_OVERFLOW;
+            return;
+        }
+        ZCAN_Receive_Data data{};
+        data.frame.can_id = frame.id;
+        data.frame.can_dlc = frame.len;
+        data.frame.__pad = echo ? TX_ECHO_FLAG : 0;
+        std::memcpy(data.frame.data, frame.data, CAN_MAX_DLEN);
+        data.timestamp = timestamp;
+        channel->rxCan.push_back(data);
+    }
+    channel->rxCv.notify_all();
+}
@@ -0,0 +1,92 @@
+#ifndef ZLGCAN_SOCKETCAN_BACKEND_H_
+#define ZLGCAN_SOCKETCAN_BACKEND_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "zlgcan.h"
+#include "socketcan_port.h"
+
+/**
+ * ZCAN_* API的SocketCAN实现
+ * 设备的每个通道对应一个CAN网络接口（vcan0、can0等），通道打开一个CAN_RAW socket。
+ * 每个设备一个接收线程，epoll等待各通道socket，recvmmsg批量读入后分发到通道缓冲或合并接收缓冲；
+ * 发送用sendmmsg批量提交。时间戳优先取驱动硬件时间戳，否则为内核软件接收时间（相对设备打开时刻）。
+ * 接收滤波通过"N/filter_mode/start/end/ack/clear"设置，分解为内核CAN_RAW_FILTER。
+ * 位速率、只听等控制器参数需用ip link配置，InitCAN中的对应参数不下发。
+ */
+class SocketCanBackend {
+public:
+    static SocketCanBackend& Instance();
+
+    SocketCanBackend(const SocketCanBackend&) = delete;
+    SocketCanBackend& operator=(const SocketCanBackend&) = delete;
+
+    DEVICE_HANDLE OpenDevice(UINT deviceType, UINT deviceIndex);
+    UINT CloseDevice(DEVICE_HANDLE deviceHandle);
+    UINT GetDeviceInfo(DEVICE_HANDLE deviceHandle, ZCAN_DEVICE_INFO* info);
+    UINT GetDeviceInfoEx(DEVICE_HANDLE deviceHandle, ZCAN_DEVICE_INFO_EX* info);
+    UINT IsDeviceOnline(DEVICE_HANDLE deviceHandle);
+
+    CHANNEL_HANDLE InitCan(DEVICE_HANDLE deviceHandle, UINT channelIndex, const ZCAN_CHANNEL_INIT_CONFIG* config);
+    UINT StartCan(CHANNEL_HANDLE channelHandle);
+    UINT ResetCan(CHANNEL_HANDLE channelHandle);
+    UINT ClearBuffer(CHANNEL_HANDLE channelHandle);
+    UINT ReadChannelErrInfo(CHANNEL_HANDLE channelHandle, ZCAN_CHANNEL_ERR_INFO* info);
+    UINT ReadChannelStatus(CHANNEL_HANDLE channelHandle, ZCAN_CHANNEL_STATUS* status);
+    UINT GetReceiveNum(CHANNEL_HANDLE channelHandle, BYTE type);
+
+    UINT Transmit(CHANNEL_HANDLE channelHandle, const ZCAN_Transmit_Data* frames, UINT count);
+    UINT TransmitFD(CHANNEL_HANDLE channelHandle, const ZCAN_TransmitFD_Data* frames, UINT count);
+    UINT Receive(CHANNEL_HANDLE channelHandle, ZCAN_Receive_Data* frames, UINT count, int waitMs);
+    UINT ReceiveFD(CHANNEL_HANDLE channelHandle, ZCAN_ReceiveFD_Data* frames, UINT count, int waitMs);
+    UINT TransmitData(DEVICE_HANDLE deviceHandle, const ZCANDataObj* objs, UINT count);
+    UINT ReceiveData(DEVICE_HANDLE deviceHandle, ZCANDataObj* objs, UINT count, int waitMs);
+
+    UINT SetValue(DEVICE_HANDLE deviceHandle, const char* path, const char* value);
+    const char* GetValue(DEVICE_HANDLE deviceHandle, const char* path);
+
+    // IProperty的函数指针不带设备句柄，作用于最近一次GetIProperty的设备
+    void SetPropertyDevice(DEVICE_HANDLE deviceHandle);
+    DEVICE_HANDLE PropertyDevice();
+
+private:
+    struct Channel;
+    struct Device;
+
+    SocketCanBackend() = default;
+
+    Device* FindDevice(DEVICE_HANDLE deviceHandle);
+    Channel* FindChannel(CHANNEL_HANDLE channelHandle);
+    void Release(Device* device);
+    UINT Send(Channel* channel, std::vector<SocketCanFrame>& frames, std::vector<bool>& fd,
+              std::vector<bool>& echo);
+    bool Wait(std::unique_lock<std::mutex>& lock, Device* device, std::condition_variable& cv, int waitMs,
+              const std::function<bool()>& ready);
+    bool SetChannelValue(Device* device, UINT channelIndex, const std::string& key, const std::string& value);
+    void ApplyFilters(Channel* channel);
+    void StopReceiveThread(Device* device);
+
+    void RunReceive(Device* device);
+    void Dispatch(Channel* channel, const SocketCanRx& rx);
+    void ApplyError(Channel* channel, const SocketCanError& error, UINT64 timestamp);
+    void PushFrame(Channel* channel, const SocketCanFrame& frame, bool fd, bool echo, UINT64 timestamp);
+
+    std::mutex mutex_;
+    std::condition_variable closeCv_;
+    std::map<uint64_t, std::unique_ptr<Device>> devices_;   // (类型 << 32 | 索引) -> 设备
+    std::unordered_map<const void*, Channel*> channels_;    // 通道句柄 -> 通道
+    DEVICE_HANDLE propertyDevice_ = nullptr;
+};
+
+#endif  // ZLGCAN_SOCKETCAN_BACKEND_H_
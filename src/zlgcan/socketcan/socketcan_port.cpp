@@ -0,0 +1,323 @@
+#include "socketcan_port.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include <linux/can.h>
+#include <linux/can/error.h>
+#include <linux/can/raw.h>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static_assert(sizeof(SocketCanFrame) == sizeof(struct canfd_frame), "SocketCanFrame必须与canfd_frame布局一致");
+static_assert(CAN_MTU == 16 && CANFD_MTU == 72, "unexpected CAN MTU");
+
+namespace {
+
+constexpr uint32_t SFF_BITS = 11;
+constexpr uint32_t EFF_BITS = 29;
+constexpr size_t FILTER_MAX = 512;     // CAN_RAW_FILTER_MAX
+constexpr size_t CONTROL_SIZE = CMSG_SPACE(sizeof(struct scm_timestamping)) + CMSG_SPACE(sizeof(uint32_t));
+
+// ZCAN_BUS_ERR_*
+constexpr uint8_t BUS_ERR_BIT = 1;
+constexpr uint8_t BUS_ERR_ACK = 2;
+constexpr uint8_t BUS_ERR_CRC = 3;
+constexpr uint8_t BUS_ERR_FORM = 4;
+constexpr uint8_t BUS_ERR_STUFF = 5;
+
+int64_t ToNs(const timespec& ts) {
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+}  // namespace
+
+std::vector<std::pair<uint32_t, uint32_t>> SocketCanFilters(const std::vector<SocketCanRange>& ranges) {
+    std::vector<std::pair<uint32_t, uint32_t>> filters;
+    for (const auto& range : ranges) {
+        const uint32_t bits = range.extended ? EFF_BITS : SFF_BITS;
+        const uint64_t limit = (1ULL << bits) - 1;
+        uint64_t start = range.start;
+        const uint64_t end = std::min<uint64_t>(range.end, limit);
+        const uint32_t format = range.extended ? CAN_EFF_FLAG : 0;
+
+        // 每次取以start对齐且不超出end的最大2的幂块
+        while (start <= end) {
+            uint64_t size = start == 0 ? (1ULL << bits) : (start & (~start + 1));
+            while (start + size - 1 > end) {
+                size >>= 1;
+            }
+            const uint32_t mask = static_cast<uint32_t>(limit & ~(size - 1));
+            filters.emplace_back(static_cast<uint32_t>(start) | format, mask | CAN_EFF_FLAG);
+            start += size;
+        }
+    }
+    if (filters.size() > FILTER_MAX) {
+        filters.clear();               // 超过内核上限时退化为全部接收
+    }
+    return filters;
+}
+
+SocketCanError SocketCanDecodeError(const SocketCanFrame& frame) {
+    SocketCanError error;
+    const uint32_t id = frame.id;
+    if (id & CAN_ERR_BUSOFF) {
+        error.busOff = true;
+    }
+    if (id & CAN_ERR_RESTARTED) {
+        error.restarted = true;
+    }
+    if (id & CAN_ERR_CRTL) {
+        const uint8_t crtl = frame.data[1];
+        error.rxOverflow = (crtl & (CAN_ERR_CRTL_RX_OVERFLOW | CAN_ERR_CRTL_TX_OVERFLOW)) != 0;
+        error.warning = (crtl & (CAN_ERR_CRTL_RX_WARNING | CAN_ERR_CRTL_TX_WARNING)) != 0;
+        error.passive = (crtl & (CAN_ERR_CRTL_RX_PASSIVE | CAN_ERR_CRTL_TX_PASSIVE)) != 0;
+        error.active = (crtl & CAN_ERR_CRTL_ACTIVE) != 0;
+    }
+    if (id & CAN_ERR_ACK) {
+        error.busError = true;
+        error.busErrorType = BUS_ERR_ACK;
+    } else if (id & (CAN_ERR_PROT | CAN_ERR_BUSERROR)) {
+        error.busError = true;
+        const uint8_t type = frame.data[2];
+        const uint8_t location = frame.data[3];
+        if (location == CAN_ERR_PROT_LOC_ACK) {
+            error.busErrorType = BUS_ERR_ACK;
+        } else if (location == CAN_ERR_PROT_LOC_CRC_SEQ) {
+            error.busErrorType = BUS_ERR_CRC;
+        } else if (type & CAN_ERR_PROT_STUFF) {
+            error.busErrorType = BUS_ERR_STUFF;
+        } else if (type & CAN_ERR_PROT_FORM) {
+            error.busErrorType = BUS_ERR_FORM;
+        } else {
+            error.busErrorType = BUS_ERR_BIT;
+        }
+    }
+    if (id & CAN_ERR_CNT) {
+        error.hasCounters = true;
+        error.tec = frame.data[6];
+        error.rec = frame.data[7];
+    }
+    return error;
+}
+
+bool SocketCanInterfaceUp(const std::string& name) {
+    if (name.empty() || name.size() >= IFNAMSIZ) {
+        return false;
+    }
+    const int fd = ::socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if (fd < 0) {
+        return false;
+    }
+    struct ifreq ifr;
+    std::memset(&ifr, 0, sizeof(ifr));
+    std::strncpy(ifr.ifr_name, name.c_str(), IFNAMSIZ - 1);
+    const bool up = ::ioctl(fd, SIOCGIFFLAGS, &ifr) == 0 && (ifr.ifr_flags & IFF_UP);
+    ::close(fd);
+    return up;
+}
+
+SocketCanPort::~SocketCanPort() {
+    Close();
+}
+
+bool SocketCanPort::Open(const std::string& interfaceName, bool fd) {
+    Close();
+    if (interfaceName.empty() || interfaceName.size() >= IFNAMSIZ) {
+        return false;
+    }
+
+    const int sock = ::socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+    if (sock < 0) {
+        return false;
+    }
+
+    struct ifreq ifr;
+    std::memset(&ifr, 0, sizeof(ifr));
+    std::strncpy(ifr.ifr_name, interfaceName.c_str(), IFNAMSIZ - 1);
+    if (::ioctl(sock, SIOCGIFINDEX, &ifr) != 0) {
+        ::close(sock);
+        return false;
+    }
+    const int ifindex = ifr.ifr_ifindex;
+
+    const int on = 1;
+    if (fd) {
+        // 接口MTU不是CANFD_MTU时内核仍接受该选项，但发送FD帧会失败，这里提前拒绝
+        if (::ioctl(sock, SIOCGIFMTU, &ifr) != 0 || ifr.ifr_mtu != static_cast<int>(CANFD_MTU) ||
+            ::setsockopt(sock, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &on, sizeof(on)) != 0) {
+            ::close(sock);
+            return false;
+        }
+    }
+    ::setsockopt(sock, SOL_CAN_RAW, CAN_RAW_RECV_OWN_MSGS, &on, sizeof(on));
+
+    const can_err_mask_t errMask = CAN_ERR_TX_TIMEOUT | CAN_ERR_CRTL | CAN_ERR_PROT | CAN_ERR_ACK |
+                                   CAN_ERR_BUSOFF | CAN_ERR_BUSERROR | CAN_ERR_RESTARTED | CAN_ERR_CNT;
+    ::setsockopt(sock, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &errMask, sizeof(errMask));
+
+    // 优先硬件时间戳，驱动不支持时内核只填软件时间戳
+    const int stamping = SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE |
+                         SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    ::setsockopt(sock, SOL_SOCKET, SO_TIMESTAMPING, &stamping, sizeof(stamping));
+
+    // 加大接收缓冲，接收线程调度延迟时减少内核丢帧
+    const int rcvbuf = 4 * 1024 * 1024;
+    ::setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    const int rxqOverflow = 1;
+    ::setsockopt(sock, SOL_SOCKET, SO_RXQ_OVFL, &rxqOverflow, sizeof(rxqOverflow));
+
+    struct sockaddr_can addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifindex;
+    if (::bind(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(sock);
+        return false;
+    }
+
+    fd_ = sock;
+    canfd_ = fd;
+    control_.assign(CONTROL_SIZE * BATCH, 0);
+    return true;
+}
+
+void SocketCanPort::Close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool SocketCanPort::SetFilters(const std::vector<std::pair<uint32_t, uint32_t>>& filters) {
+    if (fd_ < 0) {
+        return false;
+    }
+    if (filters.empty()) {
+        struct can_filter all = {0, 0};
+        return ::setsockopt(fd_, SOL_CAN_RAW, CAN_RAW_FILTER, &all, sizeof(all)) == 0;
+    }
+
+    std::vector<struct can_filter> raw(filters.size());
+    for (size_t i = 0; i < filters.size(); i++) {
+        raw[i].can_id = filters[i].first;
+        raw[i].can_mask = filters[i].second;
+    }
+    return ::setsockopt(fd_, SOL_CAN_RAW, CAN_RAW_FILTER, raw.data(),
+                        static_cast<socklen_t>(raw.size() * sizeof(struct can_filter))) == 0;
+}
+
+unsigned SocketCanPort::Send(const SocketCanFrame* frames, const bool* fd, unsigned count, int waitMs) {
+    if (fd_ < 0 || count == 0) {
+        return 0;
+    }
+
+    struct mmsghdr msgs[BATCH];
+    struct iovec iovs[BATCH];
+    unsigned sent = 0;
+    int retries = waitMs > 0 ? waitMs : 0;
+    while (sent < count) {
+        const unsigned batch = std::min(count - sent, BATCH);
+        for (unsigned i = 0; i < batch; i++) {
+            const bool isFd = fd[sent + i] && canfd_;
+            iovs[i].iov_base = const_cast<SocketCanFrame*>(&frames[sent + i]);
+            iovs[i].iov_len = isFd ? CANFD_MTU : CAN_MTU;
+            std::memset(&msgs[i], 0, sizeof(msgs[i]));
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        const int result = ::sendmmsg(fd_, msgs, batch, MSG_DONTWAIT);
+        if (result > 0) {
+            sent += static_cast<unsigned>(result);
+            continue;
+        }
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        // 网卡队列满：ENOBUFS不会触发POLLOUT，按1ms间隔重试
+        if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) && retries-- > 0) {
+            struct pollfd pfd = {fd_, POLLOUT, 0};
+            ::poll(&pfd, 1, 1);
+            continue;
+        }
+        break;
+    }
+    return sent;
+}
+
+int SocketCanPort::Receive(SocketCanRx* out, unsigned count) {
+    if (fd_ < 0) {
+        return -1;
+    }
+
+    struct mmsghdr msgs[BATCH];
+    struct iovec iovs[BATCH];
+    const unsigned batch = std::min(count, BATCH);
+    for (unsigned i = 0; i < batch; i++) {
+        iovs[i].iov_base = &out[i].frame;
+        iovs[i].iov_len = sizeof(SocketCanFrame);
+        std::memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_control = control_.data() + i * CONTROL_SIZE;
+        msgs[i].msg_hdr.msg_controllen = CONTROL_SIZE;
+    }
+
+    int result;
+    do {
+        result = ::recvmmsg(fd_, msgs, batch, MSG_DONTWAIT, nullptr);
+    } while (result < 0 && errno == EINTR);
+    if (result < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+
+    for (int i = 0; i < result; i++) {
+        SocketCanRx& rx = out[i];
+        rx.fd = msgs[i].msg_len == CANFD_MTU;
+        rx.own = (msgs[i].msg_hdr.msg_flags & MSG_CONFIRM) != 0;
+        rx.isError = (rx.frame.id & CAN_ERR_FLAG) != 0;
+        rx.frame.flags &= static_cast<uint8_t>(CANFD_BRS | CANFD_ESI);
+        if (!rx.fd) {
+            std::memset(rx.frame.data + CAN_MAX_DLEN, 0, sizeof(rx.frame.data) - CAN_MAX_DLEN);
+        }
+        if (rx.isError) {
+            rx.error = SocketCanDecodeError(rx.frame);
+        }
+
+        rx.hardwareTimestamp = false;
+        rx.timestampNs = 0;
+        rx.dropped = 0;
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg != nullptr;
+             cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg)) {
+            if (cmsg->cmsg_level != SOL_SOCKET) {
+                continue;
+            }
+            if (cmsg->cmsg_type == SO_RXQ_OVFL) {
+                std::memcpy(&rx.dropped, CMSG_DATA(cmsg), sizeof(rx.dropped));
+                continue;
+            }
+            if (cmsg->cmsg_type != SCM_TIMESTAMPING) {
+                continue;
+            }
+            struct scm_timestamping stamps;
+            std::memcpy(&stamps, CMSG_DATA(cmsg), sizeof(stamps));
+            const int64_t hardware = ToNs(stamps.ts[2]);
+            rx.hardwareTimestamp = hardware != 0;
+            rx.timestampNs = hardware != 0 ? hardware : ToNs(stamps.ts[0]);
+        }
+        if (rx.timestampNs == 0) {
+            struct timespec now;
+            ::clock_gettime(CLOCK_REALTIME, &now);
+            rx.timestampNs = ToNs(now);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,99 @@
+#ifndef ZLGCAN_SOCKETCAN_PORT_H_
+#define ZLGCAN_SOCKETCAN_PORT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 本文件不包含zlgcan.h：linux/can.h与canframe.h的can_frame/canfd_frame定义冲突，
+// 内核接口集中在socketcan_port.cpp，对外只使用下面与struct canfd_frame布局一致的结构
+
+// 与struct canfd_frame（及canframe.h中的canfd_frame）布局一致；经典帧只使用前16字节
+struct SocketCanFrame {
+    uint32_t id;
+    uint8_t len;
+    uint8_t flags;
+    uint8_t res0;
+    uint8_t res1;
+    uint8_t data[64];
+};
+
+// 内核错误帧解析结果
+struct SocketCanError {
+    bool busOff = false;
+    bool restarted = false;
+    bool passive = false;
+    bool warning = false;
+    bool active = false;               // 控制器回到主动错误状态
+    bool rxOverflow = false;
+    bool busError = false;
+    uint8_t busErrorType = 0;          // ZCAN_BUS_ERR_*
+    bool hasCounters = false;
+    uint8_t tec = 0;
+    uint8_t rec = 0;
+};
+
+struct SocketCanRx {
+    SocketCanFrame frame;
+    bool fd = false;
+    bool own = false;                  // 本socket发送的帧（CAN_RAW_RECV_OWN_MSGS回环）
+    bool isError = false;
+    SocketCanError error;
+    bool hardwareTimestamp = false;
+    int64_t timestampNs = 0;           // 硬件时间戳为设备时钟，软件时间戳为CLOCK_REALTIME
+    uint32_t dropped = 0;              // socket接收队列满被内核丢弃的累计帧数（SO_RXQ_OVFL）
+};
+
+// 验收ID范围（闭区间）
+struct SocketCanRange {
+    bool extended = false;
+    uint32_t start = 0;
+    uint32_t end = 0;
+};
+
+// 将ID范围分解为最少的前缀块(id, mask)，供CAN_RAW_FILTER使用
+std::vector<std::pair<uint32_t, uint32_t>> SocketCanFilters(const std::vector<SocketCanRange>& ranges);
+
+// 按错误帧的can_id和data解析
+SocketCanError SocketCanDecodeError(const SocketCanFrame& frame);
+
+// 接口存在且处于UP状态
+bool SocketCanInterfaceUp(const std::string& name);
+
+/**
+ * 单个CAN_RAW socket
+ * 非阻塞；开启CAN_RAW_RECV_OWN_MSGS（回显依据MSG_CONFIRM识别）、错误帧和SO_TIMESTAMPING，
+ * 收发分别用recvmmsg/sendmmsg批量进行。
+ */
+class SocketCanPort {
+public:
+    SocketCanPort() = default;
+    ~SocketCanPort();
+
+    SocketCanPort(const SocketCanPort&) = delete;
+    SocketCanPort& operator=(const SocketCanPort&) = delete;
+
+    // fd为true时开启CAN_RAW_FD_FRAMES（接口MTU不支持时失败）
+    bool Open(const std::string& interfaceName, bool fd);
+    void Close();
+    bool IsOpen() const { return fd_ >= 0; }
+    int Fd() const { return fd_; }
+
+    // 空列表表示接收全部
+    bool SetFilters(const std::vector<std::pair<uint32_t, uint32_t>>& filters);
+
+    // 批量发送，返回内核接受的帧数；发送队列满时最多等待waitMs
+    unsigned Send(const SocketCanFrame* frames, const bool* fd, unsigned count, int waitMs);
+
+    // 批量接收，无数据返回0，socket出错返回-1
+    int Receive(SocketCanRx* out, unsigned count);
+
+private:
+    static constexpr unsigned BATCH = 64;
+
+    int fd_ = -1;
+    bool canfd_ = false;
+    std::vector<uint8_t> control_;     // recvmmsg的控制消息缓冲，BATCH份
+};
+
+#endif  // ZLGCAN_SOCKETCAN_PORT_H_
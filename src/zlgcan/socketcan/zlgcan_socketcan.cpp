@@ -0,0 +1,133 @@
+/**
+ * zlgcan.h的SocketCAN实现，替代zlgcan.lib链接进zlgcan_socketcan目标（Linux）
+ *
+ * CAN/CANFD收发、合并接收、错误信息和属性接口由SocketCanBackend实现，通道映射到CAN网络接口；
+ * LIN、UDS和云接口见zlgcan_unsupported.cpp。位速率等需预先用ip link配置，例如
+ *   ip link set can0 type can bitrate 500000 dbitrate 2000000 fd on && ip link set can0 up
+ *
+ * 后端参数（ZCAN_SetValue）：
+ *   "N/interface"            通道对应的网络接口名，下次InitCAN生效；默认取环境变量
+ *                            ZLGCAN_SOCKETCAN_INTERFACES（逗号分隔，按设备索引*通道数+通道号）或can<n>
+ *   "N/filter_mode" "N/filter_start" "N/filter_end" "N/filter_ack"  追加验收范围（0标准帧/1扩展帧）
+ *   "N/filter_clear"         清除验收范围，接收全部
+ *   "N/rx_capacity"          接收缓冲容量（帧）
+ *   "0/set_device_recv_merge"  1启用合并接收（ZCAN_ReceiveData，含错误数据）
+ * 队列延时发送不支持，带延时标志的帧立即发送；"N/get_device_available_tx_count/1"无返回值。
+ */
+#include "socketcan_backend.h"
+
+namespace {
+
+int PropertySetValue(const char* path, const char* value) {
+    SocketCanBackend& backend = SocketCanBackend::Instance();
+    return backend.SetValue(backend.PropertyDevice(), path, value) == STATUS_OK ? 1 : 0;
+}
+
+const char* PropertyGetValue(const char* path) {
+    SocketCanBackend& backend = SocketCanBackend::Instance();
+    return backend.GetValue(backend.PropertyDevice(), path);
+}
+
+const ConfigNode* PropertyGetPropertys() {
+    return nullptr;
+}
+
+IProperty g_property = {PropertySetValue, PropertyGetValue, PropertyGetPropertys};
+
+}  // namespace
+
+// ==================== 设备 ====================
+
+DEVICE_HANDLE FUNC_CALL ZCAN_OpenDevice(UINT device_type, UINT device_index, UINT reserved) {
+    (void)reserved;
+    return SocketCanBackend::Instance().OpenDevice(device_type, device_index);
+}
+
+UINT FUNC_CALL ZCAN_CloseDevice(DEVICE_HANDLE device_handle) {
+    return SocketCanBackend::Instance().CloseDevice(device_handle);
+}
+
+UINT FUNC_CALL ZCAN_GetDeviceInf(DEVICE_HANDLE device_handle, ZCAN_DEVICE_INFO* pInfo) {
+    return SocketCanBackend::Instance().GetDeviceInfo(device_handle, pInfo);
+}
+
+UINT FUNC_CALL ZCAN_GetDeviceInfoEx(DEVICE_HANDLE device_handle, ZCAN_DEVICE_INFO_EX* pInfo) {
+    return SocketCanBackend::Instance().GetDeviceInfoEx(device_handle, pInfo);
+}
+
+UINT FUNC_CALL ZCAN_IsDeviceOnLine(DEVICE_HANDLE device_handle) {
+    return SocketCanBackend::Instance().IsDeviceOnline(device_handle);
+}
+
+// ==================== CAN ====================
+
+CHANNEL_HANDLE FUNC_CALL ZCAN_InitCAN(DEVICE_HANDLE device_handle, UINT can_index,
+                                      ZCAN_CHANNEL_INIT_CONFIG* pInitConfig) {
+    return SocketCanBackend::Instance().InitCan(device_handle, can_index, pInitConfig);
+}
+
+UINT FUNC_CALL ZCAN_StartCAN(CHANNEL_HANDLE channel_handle) {
+    return SocketCanBackend::Instance().StartCan(channel_handle);
+}
+
+UINT FUNC_CALL ZCAN_ResetCAN(CHANNEL_HANDLE channel_handle) {
+    return SocketCanBackend::Instance().ResetCan(channel_handle);
+}
+
+UINT FUNC_CALL ZCAN_ClearBuffer(CHANNEL_HANDLE channel_handle) {
+    return SocketCanBackend::Instance().ClearBuffer(channel_handle);
+}
+
+UINT FUNC_CALL ZCAN_ReadChannelErrInfo(CHANNEL_HANDLE channel_handle, ZCAN_CHANNEL_ERR_INFO* pErrInfo) {
+    return SocketCanBackend::Instance().ReadChannelErrInfo(channel_handle, pErrInfo);
+}
+
+UINT FUNC_CALL ZCAN_ReadChannelStatus(CHANNEL_HANDLE channel_handle, ZCAN_CHANNEL_STATUS* pCANStatus) {
+    return SocketCanBackend::Instance().ReadChannelStatus(channel_handle, pCANStatus);
+}
+
+UINT FUNC_CALL ZCAN_GetReceiveNum(CHANNEL_HANDLE channel_handle, BYTE type) {
+    return SocketCanBackend::Instance().GetReceiveNum(channel_handle, type);
+}
+
+UINT FUNC_CALL ZCAN_Transmit(CHANNEL_HANDLE channel_handle, ZCAN_Transmit_Data* pTransmit, UINT len) {
+    return SocketCanBackend::Instance().Transmit(channel_handle, pTransmit, len);
+}
+
+UINT FUNC_CALL ZCAN_Receive(CHANNEL_HANDLE channel_handle, ZCAN_Receive_Data* pReceive, UINT len, int wait_time) {
+    return SocketCanBackend::Instance().Receive(channel_handle, pReceive, len, wait_time);
+}
+
+UINT FUNC_CALL ZCAN_TransmitFD(CHANNEL_HANDLE channel_handle, ZCAN_TransmitFD_Data* pTransmit, UINT len) {
+    return SocketCanBackend::Instance().TransmitFD(channel_handle, pTransmit, len);
+}
+
+UINT FUNC_CALL ZCAN_ReceiveFD(CHANNEL_HANDLE channel_handle, ZCAN_ReceiveFD_Data* pReceive, UINT len,
+                              int wait_time) {
+    return SocketCanBackend::Instance().ReceiveFD(channel_handle, pReceive, len, wait_time);
+}
+
+UINT FUNC_CALL ZCAN_TransmitData(DEVICE_HANDLE device_handle, ZCANDataObj* pTransmit, UINT len) {
+    return SocketCanBackend::Instance().TransmitData(device_handle, pTransmit, len);
+}
+
+UINT FUNC_CALL ZCAN_ReceiveData(DEVICE_HANDLE device_handle, ZCANDataObj* pReceive, UINT len, int wait_time) {
+    return SocketCanBackend::Instance().ReceiveData(device_handle, pReceive, len, wait_time);
+}
+
+UINT FUNC_CALL ZCAN_SetValue(DEVICE_HANDLE device_handle, const char* path, const void* value) {
+    return SocketCanBackend::Instance().SetValue(device_handle, path, static_cast<const char*>(value));
+}
+
+const void* FUNC_CALL ZCAN_GetValue(DEVICE_HANDLE device_handle, const char* path) {
+    return SocketCanBackend::Instance().GetValue(device_handle, path);
+}
+
+IProperty* FUNC_CALL GetIProperty(DEVICE_HANDLE device_handle) {
+    SocketCanBackend::Instance().SetPropertyDevice(device_handle);
+    return &g_property;
+}
+
+UINT FUNC_CALL ReleaseIProperty(IProperty* pIProperty) {
+    return pIProperty == &g_property ? STATUS_OK : STATUS_ERR;
+}
@@ -0,0 +1,399 @@
+#include "thread_scheduling.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+
+#include "api_stats.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <timeapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "winmm.lib")
+#endif
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif
+
+struct ThreadRegistration {
+    ThreadRole role = ThreadRole::Receive;
+#ifdef _WIN32
+    HANDLE handle = nullptr;
+    int originalPriority = THREAD_PRIORITY_NORMAL;
+#else
+    pthread_t thread;
+    int originalPolicy = SCHED_OTHER;
+    sched_param originalParam;
+#ifdef __linux__
+    pid_t tid = 0;
+    cpu_set_t originalAffinity;
+    bool originalAffinityValid = false;
+    int originalNice = 0;
+#endif
+#endif
+    bool applied = false;              // 曾修改过线程属性，注销时恢复构造时的设置
+    bool realtimeApplied = false;
+    bool affinityApplied = false;
+};
+
+namespace {
+
+constexpr int DEFAULT_FIFO_PRIORITY = 50;
+constexpr int FALLBACK_NICE = -10;      // 无实时调度权限时的降级优先级
+
+const char* ROLE_NAMES[] = { "receive", "transmit", "monitor" };
+static_assert(sizeof(ROLE_NAMES) / sizeof(ROLE_NAMES[0]) == static_cast<size_t>(ThreadRole::Count),
+              "ROLE_NAMES与ThreadRole不一致");
+
+// 同一角色的多个线程并发写入，relaxed原子累加
+struct LatencyStats {
+    std::atomic<uint64_t> wakeups{0};
+    std::atomic<uint64_t> totalNs{0};
+    std::atomic<uint64_t> maxNs{0};
+    std::atomic<uint64_t> histogram[API_HIST_BUCKETS] = {};
+};
+
+struct RoleState {
+    ThreadSchedulingPolicy policy;
+    std::vector<ThreadRegistration*> threads;
+    std::string fallback;
+    std::string error;
+    LatencyStats latency;
+};
+
+struct Registry {
+    std::mutex mutex;
+    RoleState roles[static_cast<size_t>(ThreadRole::Count)];
+    bool timerResolutionRaised = false;
+};
+
+// 故意不释放：退出阶段的线程仍可能注销
+Registry& GetRegistry() {
+    static Registry* registry = new Registry();
+    return *registry;
+}
+
+thread_local LatencyStats* t_latency = nullptr;
+
+RoleState& Role(Registry& registry, ThreadRole role) {
+    return registry.roles[static_cast<size_t>(role)];
+}
+
+#ifdef _WIN32
+
+void Apply(ThreadRegistration* thread, RoleState& role) {
+    const ThreadSchedulingPolicy& policy = role.policy;
+    thread->applied = true;
+
+    DWORD_PTR processMask = 0;
+    DWORD_PTR systemMask = 0;
+    GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask);
+    DWORD_PTR mask = 0;
+    for (UINT cpu : policy.cpus) {
+        if (cpu < sizeof(DWORD_PTR) * 8) {
+            mask |= static_cast<DWORD_PTR>(1) << cpu;
+        }
+    }
+    mask = policy.cpus.empty() ? processMask : (mask & processMask);
+    if (mask == 0) {
+        role.error = "指定的CPU不在进程可用范围内";
+        thread->affinityApplied = false;
+    } else if (SetThreadAffinityMask(thread->handle, mask) == 0) {
+        role.error = "CPU亲和性设置失败，错误码 " + std::to_string(GetLastError());
+        thread->affinityApplied = false;
+    } else {
+        thread->affinityApplied = !policy.cpus.empty();
+    }
+
+    thread->realtimeApplied = false;
+    if (!policy.realtime) {
+        SetThreadPriority(thread->handle, THREAD_PRIORITY_NORMAL);
+        return;
+    }
+    if (SetThreadPriority(thread->handle, THREAD_PRIORITY_TIME_CRITICAL)) {
+        thread->realtimeApplied = true;
+        return;
+    }
+    role.error = "THREAD_PRIORITY_TIME_CRITICAL设置失败，错误码 " + std::to_string(GetLastError());
+    role.fallback = SetThreadPriority(thread->handle, THREAD_PRIORITY_HIGHEST) ? "THREAD_PRIORITY_HIGHEST" : "普通优先级";
+}
+
+void SaveOriginal(ThreadRegistration* thread) {
+    const int priority = GetThreadPriority(thread->handle);
+    thread->originalPriority = priority == THREAD_PRIORITY_ERROR_RETURN ? THREAD_PRIORITY_NORMAL : priority;
+}
+
+// 线程默认继承进程的亲和性掩码
+void RestoreOriginal(ThreadRegistration* thread) {
+    DWORD_PTR processMask = 0;
+    DWORD_PTR systemMask = 0;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask) && processMask != 0) {
+        SetThreadAffinityMask(thread->handle, processMask);
+    }
+    SetThreadPriority(thread->handle, thread->originalPriority);
+}
+
+// 任一角色请求实时调度时把系统定时器精度提高到1ms，睡眠唤醒才能跟上毫秒级周期
+void UpdateTimerResolution(Registry& registry) {
+    bool realtime = false;
+    for (const RoleState& role : registry.roles) {
+        realtime = realtime || role.policy.realtime;
+    }
+    if (realtime && !registry.timerResolutionRaised) {
+        registry.timerResolutionRaised = timeBeginPeriod(1) == TIMERR_NOERROR;
+    } else if (!realtime && registry.timerResolutionRaised) {
+        timeEndPeriod(1);
+        registry.timerResolutionRaised = false;
+    }
+}
+
+#else
+
+void Apply(ThreadRegistration* thread, RoleState& role) {
+    const ThreadSchedulingPolicy& policy = role.policy;
+    thread->applied = true;
+
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (policy.cpus.empty()) {
+        const long count = sysconf(_SC_NPROCESSORS_CONF);
+        for (long cpu = 0; cpu < count && cpu < CPU_SETSIZE; cpu++) {
+            CPU_SET(cpu, &set);
+        }
+    } else {
+        for (UINT cpu : policy.cpus) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &set);
+            }
+        }
+    }
+    const int affinityResult = pthread_setaffinity_np(thread->thread, sizeof(set), &set);
+    if (affinityResult != 0) {
+        role.error = std::string("CPU亲和性设置失败: ") + strerror(affinityResult);
+    }
+    thread->affinityApplied = affinityResult == 0 && !policy.cpus.empty();
+#else
+    if (!policy.cpus.empty()) {
+        role.error = "当前平台不支持设置CPU亲和性";
+    }
+    thread->affinityApplied = false;
+#endif
+
+    thread->realtimeApplied = false;
+    sched_param param;
+    memset(&param, 0, sizeof(param));
+    if (!policy.realtime) {
+        pthread_setschedparam(thread->thread, SCHED_OTHER, &param);
+#ifdef __linux__
+        setpriority(PRIO_PROCESS, static_cast<id_t>(thread->tid), 0);
+#endif
+        return;
+    }
+
+    const int priority = policy.priority > 0 ? policy.priority : DEFAULT_FIFO_PRIORITY;
+    param.sched_priority = std::min(std::max(priority, sched_get_priority_min(SCHED_FIFO)),
+                                    sched_get_priority_max(SCHED_FIFO));
+    const int result = pthread_setschedparam(thread->thread, SCHED_FIFO, &param);
+    if (result == 0) {
+        thread->realtimeApplied = true;
+        return;
+    }
+    // 通常是缺少CAP_SYS_NICE或RLIMIT_RTPRIO为0
+    role.error = std::string("SCHED_FIFO设置失败: ") + strerror(result);
+#ifdef __linux__
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(thread->tid), FALLBACK_NICE) == 0) {
+        role.fallback = "nice " + std::to_string(FALLBACK_NICE);
+        return;
+    }
+#endif
+    role.fallback = "普通优先级";
+}
+
+void SaveOriginal(ThreadRegistration* thread) {
+    memset(&thread->originalParam, 0, sizeof(thread->originalParam));
+    if (pthread_getschedparam(thread->thread, &thread->originalPolicy, &thread->originalParam) != 0) {
+        thread->originalPolicy = SCHED_OTHER;
+    }
+#ifdef __linux__
+    CPU_ZERO(&thread->originalAffinity);
+    thread->originalAffinityValid =
+        pthread_getaffinity_np(thread->thread, sizeof(thread->originalAffinity), &thread->originalAffinity) == 0;
+    errno = 0;
+    const int nice = getpriority(PRIO_PROCESS, static_cast<id_t>(thread->tid));
+    thread->originalNice = errno == 0 ? nice : 0;
+#endif
+}
+
+void RestoreOriginal(ThreadRegistration* thread) {
+    pthread_setschedparam(thread->thread, thread->originalPolicy, &thread->originalParam);
+#ifdef __linux__
+    if (thread->originalAffinityValid) {
+        pthread_setaffinity_np(thread->thread, sizeof(thread->originalAffinity), &thread->originalAffinity);
+    }
+    setpriority(PRIO_PROCESS, static_cast<id_t>(thread->tid), thread->originalNice);
+#endif
+}
+
+void UpdateTimerResolution(Registry&) {
+}
+
+#endif
+
+}  // namespace
+
+const char* ThreadRoleName(ThreadRole role) {
+    const size_t index = static_cast<size_t>(role);
+    return index < static_cast<size_t>(ThreadRole::Count) ? ROLE_NAMES[index] : "unknown";
+}
+
+void ThreadSchedulingConfigure(ThreadRole role, const ThreadSchedulingPolicy& policy) {
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    RoleState& state = Role(registry, role);
+    state.policy = policy;
+    state.error.clear();
+    state.fallback.clear();
+    for (ThreadRegistration* thread : state.threads) {
+        Apply(thread, state);
+    }
+    UpdateTimerResolution(registry);
+}
+
+ThreadSchedulingState ThreadSchedulingQuery(ThreadRole role) {
+    ThreadSchedulingState result;
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    const RoleState& state = Role(registry, role);
+    result.policy = state.policy;
+    result.threads = static_cast<UINT>(state.threads.size());
+    result.realtimeApplied = state.policy.realtime && !state.threads.empty();
+    result.affinityApplied = !state.policy.cpus.empty() && !state.threads.empty();
+    for (const ThreadRegistration* thread : state.threads) {
+        result.realtimeApplied = result.realtimeApplied && thread->realtimeApplied;
+        result.affinityApplied = result.affinityApplied && thread->affinityApplied;
+    }
+    result.fallback = state.fallback;
+    result.error = state.error;
+
+    const LatencyStats& latency = state.latency;
+    uint64_t histogram[API_HIST_BUCKETS];
+    uint64_t recorded = 0;
+    for (int b = 0; b < API_HIST_BUCKETS; b++) {
+        histogram[b] = latency.histogram[b].load(std::memory_order_relaxed);
+        recorded += histogram[b];
+    }
+    result.wakeups = latency.wakeups.load(std::memory_order_relaxed);
+    result.maxNs = latency.maxNs.load(std::memory_order_relaxed);
+    if (result.wakeups > 0) {
+        result.meanNs = static_cast<double>(latency.totalNs.load(std::memory_order_relaxed)) /
+                        static_cast<double>(result.wakeups);
+    }
+    result.p50Ns = ApiHistPercentile(histogram, recorded, 0.50, 1.0);
+    result.p99Ns = ApiHistPercentile(histogram, recorded, 0.99, 1.0);
+    result.p999Ns = ApiHistPercentile(histogram, recorded, 0.999, 1.0);
+    return result;
+}
+
+void ThreadSchedulingResetLatency() {
+    Registry& registry = GetRegistry();
+    for (RoleState& state : registry.roles) {
+        LatencyStats& latency = state.latency;
+        latency.wakeups.store(0, std::memory_order_relaxed);
+        latency.totalNs.store(0, std::memory_order_relaxed);
+        latency.maxNs.store(0, std::memory_order_relaxed);
+        for (auto& bucket : latency.histogram) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+ThreadSchedulingScope::ThreadSchedulingScope(ThreadRole role) : registration_(new ThreadRegistration()) {
+    registration_->role = role;
+#ifdef _WIN32
+    registration_->handle = OpenThread(THREAD_SET_INFORMATION | THREAD_QUERY_INFORMATION, FALSE,
+                                       GetCurrentThreadId());
+#else
+    registration_->thread = pthread_self();
+#ifdef __linux__
+    registration_->tid = static_cast<pid_t>(syscall(SYS_gettid));
+#endif
+#endif
+    SaveOriginal(registration_);
+
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    RoleState& state = Role(registry, role);
+    // 默认策略无需改动线程属性
+    if (state.policy.realtime || !state.policy.cpus.empty()) {
+        Apply(registration_, state);
+    }
+    state.threads.push_back(registration_);
+    t_latency = &state.latency;
+}
+
+ThreadSchedulingScope::~ThreadSchedulingScope() {
+    t_latency = nullptr;
+    {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        std::vector<ThreadRegistration*>& threads = Role(registry, registration_->role).threads;
+        threads.erase(std::remove(threads.begin(), threads.end(), registration_), threads.end());
+    }
+    if (registration_->applied) {
+        RestoreOriginal(registration_);
+    }
+#ifdef _WIN32
+    if (registration_->handle != nullptr) {
+        CloseHandle(registration_->handle);
+    }
+#endif
+    delete registration_;
+}
+
+void ThreadSchedulingRecordWakeup(std::chrono::steady_clock::time_point deadline) {
+    LatencyStats* latency = t_latency;
+    if (latency == nullptr) {
+        return;
+    }
+    const auto late = std::chrono::steady_clock::now() - deadline;
+    const uint64_t lateNs = late.count() > 0 ?
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(late).count()) : 0;
+    latency->wakeups.fetch_add(1, std::memory_order_relaxed);
+    latency->totalNs.fetch_add(lateNs, std::memory_order_relaxed);
+    latency->histogram[ApiHistBucket(lateNs)].fetch_add(1, std::memory_order_relaxed);
+    uint64_t max = latency->maxNs.load(std::memory_order_relaxed);
+    while (lateNs > max && !latency->maxNs.compare_exchange_weak(max, lateNs, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t ThreadCpuTimeNs() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        return 0;
+    }
+    const uint64_t kernel100ns = (static_cast<uint64_t>(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+    const uint64_t user100ns = (static_cast<uint64_t>(user.dwHighDateTime) << 32) | user.dwLowDateTime;
+    return (kernel100ns + user100ns) * 100;
+#else
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+#endif
+}
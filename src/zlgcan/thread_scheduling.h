@@ -0,0 +1,83 @@
+#ifndef ZLGCAN_THREAD_SCHEDULING_H_
+#define ZLGCAN_THREAD_SCHEDULING_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "zlgcan.h"
+
+// 原生线程按角色配置调度策略。日志写入在JS线程完成，没有独立的日志线程，各监视线程归入Monitor
+enum class ThreadRole : uint8_t {
+    Receive,        // CAN/LIN接收线程
+    Transmit,       // 剩余总线周期发送线程
+    Monitor,        // 健康监视、热插拔监视、接收链路监视线程
+    Count
+};
+
+const char* ThreadRoleName(ThreadRole role);
+
+struct ThreadRegistration;
+
+// 调度策略
+struct ThreadSchedulingPolicy {
+    bool realtime = false;             // Linux为SCHED_FIFO，Windows为THREAD_PRIORITY_TIME_CRITICAL
+    int priority = 0;                  // SCHED_FIFO优先级(1~99)，0取50；Windows忽略
+    std::vector<UINT> cpus;            // 绑定的CPU编号，空表示不限制
+};
+
+// 策略生效情况与唤醒延迟
+struct ThreadSchedulingState {
+    ThreadSchedulingPolicy policy;
+    UINT threads = 0;                  // 当前运行中的线程数
+    bool realtimeApplied = false;      // 所有线程均已获得实时优先级（未请求时为false）
+    bool affinityApplied = false;      // 所有线程均已绑定（未请求时为false）
+    std::string fallback;              // 降级说明，例如无实时调度权限时改用的优先级
+    std::string error;                 // 最近一次设置失败的原因
+
+    // 唤醒延迟：期望唤醒时刻到线程实际运行的时间差
+    uint64_t wakeups = 0;
+    double meanNs = 0;
+    double p50Ns = 0;
+    double p99Ns = 0;
+    double p999Ns = 0;
+    uint64_t maxNs = 0;
+};
+
+/**
+ * 设置角色的调度策略
+ * 立即作用于该角色运行中的线程，之后启动的线程在启动时应用。
+ * 权限不足时按 实时 -> 提高nice/HIGHEST -> 不变 逐级降级，结果记录在状态中，不报错。
+ */
+void ThreadSchedulingConfigure(ThreadRole role, const ThreadSchedulingPolicy& policy);
+
+ThreadSchedulingState ThreadSchedulingQuery(ThreadRole role);
+
+// 清零所有角色的唤醒延迟统计
+void ThreadSchedulingResetLatency();
+
+/**
+ * 线程登记
+ * 在线程函数开头构造：应用角色当前的策略，并登记线程以便策略变化时重新应用；
+ * 析构时注销，若曾修改过线程的优先级或亲和性则恢复为构造时的设置。
+ */
+class ThreadSchedulingScope {
+public:
+    explicit ThreadSchedulingScope(ThreadRole role);
+    ~ThreadSchedulingScope();
+
+    ThreadSchedulingScope(const ThreadSchedulingScope&) = delete;
+    ThreadSchedulingScope& operator=(const ThreadSchedulingScope&) = delete;
+
+private:
+    ThreadRegistration* registration_;
+};
+
+// 记录当前线程的一次定时唤醒，deadline为期望唤醒时刻；未登记的线程忽略
+void ThreadSchedulingRecordWakeup(std::chrono::steady_clock::time_point deadline);
+
+// 当前线程的累计CPU时间（用户态+内核态），Windows精度约为一个时钟中断周期
+uint64_t ThreadCpuTimeNs();
+
+#endif  // ZLGCAN_THREAD_SCHEDULING_H_
@@ -0,0 +1,168 @@
+#include "trace_buffer.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "api_stats.h"
+
+std::atomic<bool> g_traceEnabled{false};
+
+namespace {
+
+constexpr size_t MIN_CAPACITY = 1024;
+
+// 字段均为relaxed原子量：读取方与覆盖同一槽位的写入方并发时不构成数据竞争，由序号判定是否完整
+struct TraceSlot {
+    std::atomic<uint64_t> sequence{0};   // 写入完成后为位置+1，写入过程中为0
+    std::atomic<const char*> name{nullptr};
+    std::atomic<const char*> category{nullptr};
+    std::atomic<uint64_t> start{0};
+    std::atomic<uint64_t> duration{0};
+    std::atomic<uint64_t> arg{0};
+    std::atomic<uint32_t> tid{0};
+    std::atomic<char> phase{0};
+};
+
+struct TraceRing {
+    explicit TraceRing(size_t capacity) : mask(capacity - 1), slots(new TraceSlot[capacity]) {}
+
+    const size_t mask;
+    std::atomic<uint64_t> head{0};
+    std::unique_ptr<TraceSlot[]> slots;
+};
+
+struct TraceState {
+    std::mutex mutex;
+    std::atomic<TraceRing*> ring{nullptr};
+    std::vector<std::unique_ptr<TraceRing>> rings;   // 被替换的缓冲区可能仍有写入方持有，保留到进程结束
+    uint64_t startPosition = 0;
+    std::map<uint32_t, std::string> threadNames;
+};
+
+// 故意不释放：退出阶段的线程仍可能写入
+TraceState& State() {
+    static TraceState* state = new TraceState();
+    return *state;
+}
+
+std::atomic<uint32_t> g_nextTid{1};
+thread_local uint32_t t_tid = 0;
+
+uint32_t CurrentTid() {
+    if (t_tid == 0) {
+        t_tid = g_nextTid.fetch_add(1, std::memory_order_relaxed);
+    }
+    return t_tid;
+}
+
+size_t RoundUpPowerOfTwo(size_t value) {
+    size_t capacity = MIN_CAPACITY;
+    while (capacity < value) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+void Write(const char* name, const char* category, char phase, uint64_t start, uint64_t duration, uint64_t arg) {
+    TraceRing* ring = State().ring.load(std::memory_order_acquire);
+    if (ring == nullptr) {
+        return;
+    }
+    const uint64_t position = ring->head.fetch_add(1, std::memory_order_relaxed);
+    TraceSlot& slot = ring->slots[position & ring->mask];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.category.store(category, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.duration.store(duration, std::memory_order_relaxed);
+    slot.arg.store(arg, std::memory_order_relaxed);
+    slot.tid.store(CurrentTid(), std::memory_order_relaxed);
+    slot.phase.store(phase, std::memory_order_relaxed);
+    slot.sequence.store(position + 1, std::memory_order_release);
+}
+
+}  // namespace
+
+void TraceComplete(const char* name, const char* category, uint64_t start, uint64_t end, uint64_t arg) {
+    Write(name, category, 'X', start, end - start, arg);
+}
+
+void TraceInstant(const char* name, const char* category, uint64_t at, uint64_t arg) {
+    Write(name, category, 'i', at, 0, arg);
+}
+
+void TraceSetThreadName(const std::string& name) {
+    const uint32_t tid = CurrentTid();
+    TraceState& state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.threadNames[tid] = name;
+}
+
+void TraceStart(size_t capacity) {
+    TraceState& state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    capacity = RoundUpPowerOfTwo(capacity);
+    TraceRing* ring = state.ring.load(std::memory_order_relaxed);
+    if (ring == nullptr || ring->mask + 1 < capacity) {
+        state.rings.emplace_back(new TraceRing(capacity));
+        ring = state.rings.back().get();
+        state.ring.store(ring, std::memory_order_release);
+    }
+    state.startPosition = ring->head.load(std::memory_order_relaxed);
+    g_traceEnabled.store(true, std::memory_order_relaxed);
+}
+
+void TraceStop() {
+    g_traceEnabled.store(false, std::memory_order_relaxed);
+}
+
+TraceSnapshot TraceCollect() {
+    TraceSnapshot snapshot;
+    snapshot.callerTid = CurrentTid();
+    const ApiClockMapping clock = ApiStatsClock();
+
+    TraceState& state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    for (const auto& thread : state.threadNames) {
+        snapshot.threads.emplace_back(thread.first, thread.second);
+    }
+
+    TraceRing* ring = state.ring.load(std::memory_order_relaxed);
+    if (ring == nullptr) {
+        return snapshot;
+    }
+    const uint64_t capacity = ring->mask + 1;
+    const uint64_t head = ring->head.load(std::memory_order_acquire);
+    uint64_t from = state.startPosition;
+    if (head - from > capacity) {
+        snapshot.overwritten = head - from - capacity;
+        from = head - capacity;
+    }
+
+    snapshot.events.reserve(static_cast<size_t>(head - from));
+    for (uint64_t position = from; position < head; position++) {
+        const TraceSlot& slot = ring->slots[position & ring->mask];
+        const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != position + 1) {
+            continue;   // 尚未写完或已被覆盖
+        }
+        TraceEventRecord record;
+        record.name = slot.name.load(std::memory_order_relaxed);
+        record.category = slot.category.load(std::memory_order_relaxed);
+        record.phase = slot.phase.load(std::memory_order_relaxed);
+        record.tid = slot.tid.load(std::memory_order_relaxed);
+        const uint64_t start = slot.start.load(std::memory_order_relaxed);
+        const uint64_t duration = slot.duration.load(std::memory_order_relaxed);
+        record.arg = slot.arg.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+        record.startNs = clock.ToSteadyNs(start);
+        record.durationNs = static_cast<int64_t>(static_cast<double>(duration) * clock.nsPerTick);
+        snapshot.events.push_back(record);
+    }
+    return snapshot;
+}
@@ -0,0 +1,59 @@
+#ifndef ZLGCAN_TRACE_BUFFER_H_
+#define ZLGCAN_TRACE_BUFFER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 时间线记录：驱动调用、接收线程唤醒、环形缓存交接等事件写入进程级环形缓冲区，导出为Chrome trace事件。
+// 写入方多线程并发，只占用一次fetch_add取得槽位，各槽位以序号做seqlock校验；缓冲区写满后覆盖最旧的事件。
+// 时间戳与ApiStatsNow()同源（滴答），导出时换算为steady_clock纳秒。
+// 事件名和类别只保存指针，必须是静态字符串。
+
+extern std::atomic<bool> g_traceEnabled;
+
+inline bool TraceEnabled() {
+    return g_traceEnabled.load(std::memory_order_relaxed);
+}
+
+// 持续事件（Chrome trace的'X'），arg为帧数等附加值
+void TraceComplete(const char* name, const char* category, uint64_t start, uint64_t end, uint64_t arg);
+
+// 瞬时事件（Chrome trace的'i'）
+void TraceInstant(const char* name, const char* category, uint64_t at, uint64_t arg);
+
+// 为当前线程命名（导出为thread_name元数据），未命名线程显示为编号
+void TraceSetThreadName(const std::string& name);
+
+/**
+ * 开始记录
+ * capacity为缓冲区事件数（向上取整为2的幂）；大于当前容量时重新分配，此前的事件丢弃
+ */
+void TraceStart(size_t capacity);
+
+void TraceStop();
+
+struct TraceEventRecord {
+    const char* name = nullptr;
+    const char* category = nullptr;
+    char phase = 'X';
+    uint32_t tid = 0;
+    int64_t startNs = 0;      // steady_clock纳秒
+    int64_t durationNs = 0;
+    uint64_t arg = 0;
+};
+
+struct TraceSnapshot {
+    std::vector<TraceEventRecord> events;                    // 按写入顺序
+    std::vector<std::pair<uint32_t, std::string>> threads;   // 线程编号 -> 名称
+    uint32_t callerTid = 0;      // 调用线程（JS主线程）的编号，供JS侧事件使用同一条时间线
+    uint64_t overwritten = 0;    // 自TraceStart以来被覆盖的事件数
+};
+
+// 读取自最近一次TraceStart以来仍在缓冲区中的事件，不影响记录
+TraceSnapshot TraceCollect();
+
+#endif  // ZLGCAN_TRACE_BUFFER_H_
@@ -0,0 +1,264 @@
+#include "uds_client.h"
+#include "zlgcan_api.h"
+
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+uint64_t ElapsedUs(std::chrono::steady_clock::time_point since) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - since).count());
+}
+
+bool StopRequest(DEVICE_HANDLE deviceHandle, ZCAN_UDS_DATA_DEF dataType, UINT reqId) {
+    ZCAN_UDS_CTRL_REQ ctrl;
+    memset(&ctrl, 0, sizeof(ctrl));
+    ctrl.reqID = reqId;
+    ctrl.cmd = ZCAN_UDS_CTRL_STOP_REQ;
+
+    ZCAN_UDS_CTRL_RESP resp;
+    memset(&resp, 0, sizeof(resp));
+    const ZCAN_RET_STATUS ret = dataType == DEF_CAN_UDS_DATA
+        ? ZcanUdsControl(deviceHandle, &ctrl, &resp)
+        : ZcanUdsControlEx(deviceHandle, dataType, &ctrl, &resp);
+    return ret == STATUS_OK && resp.result == ZCAN_UDS_CTRL_RESULT_OK;
+}
+
+UINT AddressValue(const BYTE address[2]) {
+    return (static_cast<UINT>(address[0]) << 8) | address[1];
+}
+
+// 连接级错误：出现后驱动需要重新建立连接或重新路由激活
+bool IsDoipConnectionError(ZCAN_UDS_ERROR status) {
+    switch (status) {
+        case ZCAN_UDS_ERROR_TRANSPORT:
+        case ZCAN_UDS_ERROR_DOIP_FAILED_TO_CREATE_SOCKET:
+        case ZCAN_UDS_ERROR_DOIP_FAILED_TO_CONNECT:
+        case ZCAN_UDS_ERROR_DOIP_ROUTING_NOT_ACTIVE:
+        case ZCAN_UDS_ERROR_DOIP_INVALID_HANDLE:
+        case ZCAN_UDS_ERROR_DOIP_UNKNOWN_HANDLE:
+        case ZCAN_UDS_ERROR_DOIP_ROUTING_ACTIVE_FAIL:
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::string DoipConnectionKey(const ZDOIP_REQUEST& request) {
+    std::string server(request.serverAddress, strnlen(request.serverAddress, sizeof(request.serverAddress)));
+    return server + "|" + std::to_string(AddressValue(request.sourceAddress)) + "|" +
+        std::to_string(request.doipVersion) + "|" + std::to_string(request.rcType);
+}
+
+}  // namespace
+
+UINT UdsClient::AllocateRequestId(ZCAN_UDS_DATA_DEF dataType) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 在途请求远少于65536个，循环中总能找到空闲ID
+    UINT reqId = nextReqId_;
+    while (pending_.count(reqId) != 0) {
+        reqId = (reqId + 1) & 0xFFFF;
+    }
+    nextReqId_ = (reqId + 1) & 0xFFFF;
+    pending_[reqId] = PendingRequest{dataType, false};
+    return reqId;
+}
+
+std::mutex* UdsClient::ChannelMutex(BYTE channel) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = channelMutexes_[channel];
+    if (!entry) {
+        entry.reset(new std::mutex());
+    }
+    return entry.get();
+}
+
+std::mutex* UdsClient::DoipLaneMutex(const std::string& lane) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = doipLanes_[lane];
+    if (!entry) {
+        entry.reset(new std::mutex());
+    }
+    return entry.get();
+}
+
+
+bool UdsClient::IsCancelled(UINT reqId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pending_.find(reqId);
+    return it != pending_.end() && it->second.cancelled;
+}
+
+void UdsClient::EndRequest(UINT reqId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.erase(reqId);
+}
+
+UdsResult UdsClient::Request(DEVICE_HANDLE deviceHandle, ZCAN_UDS_REQUEST request,
+                             std::vector<BYTE> payload, UINT maxResponseLength) {
+    UdsResult result;
+    result.reqId = request.req_id;
+
+    const auto queuedAt = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> channelLock(*ChannelMutex(request.channel));
+    result.queuedUs = ElapsedUs(queuedAt);
+
+    if (IsCancelled(request.req_id)) {
+        result.response.status = ZCAN_UDS_ERROR_CANCEL;
+        result.response.type = ZCAN_UDS_RT_NONE;
+    } else {
+        request.data = payload.empty() ? nullptr : payload.data();
+        request.data_len = static_cast<UINT>(payload.size());
+        result.data.resize(maxResponseLength);
+
+        const auto requestAt = std::chrono::steady_clock::now();
+        result.callStatus = ZcanUdsRequest(deviceHandle, &request, &result.response,
+                                           result.data.empty() ? nullptr : result.data.data(),
+                                           static_cast<UINT>(result.data.size()));
+        result.requestUs = ElapsedUs(requestAt);
+
+        const bool positive = result.callStatus == STATUS_OK &&
+            result.response.status == ZCAN_UDS_ERROR_OK &&
+            result.response.type == ZCAN_UDS_RT_POSITIVE;
+        result.data.resize(positive ? std::min<UINT>(result.response.positive.data_len, maxResponseLength) : 0);
+    }
+
+    EndRequest(request.req_id);
+    return result;
+}
+
+UdsResult UdsClient::DoipRequest(DEVICE_HANDLE deviceHandle, ZDOIP_REQUEST request,
+                                 std::vector<BYTE> payload, UINT maxResponseLength) {
+    UdsResult result;
+    result.reqId = request.req_id;
+
+    const std::string connectionKey = DoipConnectionKey(request);
+    const std::string lane = connectionKey + "|" + std::to_string(AddressValue(request.targetAddress));
+
+    const auto queuedAt = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> laneLock(*DoipLaneMutex(lane));
+    result.queuedUs = ElapsedUs(queuedAt);
+
+    if (IsCancelled(request.req_id)) {
+        result.response.status = ZCAN_UDS_ERROR_CANCEL;
+        result.response.type = ZCAN_UDS_RT_NONE;
+        EndRequest(request.req_id);
+        return result;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        DoipConnectionStats& stats = doipConnections_[connectionKey];
+        if (stats.requests == 0 && stats.serverAddress.empty()) {
+            stats.serverAddress.assign(request.serverAddress, strnlen(request.serverAddress, sizeof(request.serverAddress)));
+            stats.sourceAddress = AddressValue(request.sourceAddress);
+            stats.doipVersion = request.doipVersion;
+            stats.activationType = request.rcType;
+        }
+        result.connectionReused = stats.established;
+        stats.requests++;
+        stats.inFlight++;
+        stats.maxInFlight = std::max(stats.maxInFlight, stats.inFlight);
+        stats.bytesSent += payload.size() + 1;
+    }
+
+    request.data = payload.empty() ? nullptr : payload.data();
+    request.dataLength = static_cast<UINT>(payload.size());
+    result.data.resize(maxResponseLength);
+
+    ZCANUdsRequestDataObj requestData;
+    memset(&requestData, 0, sizeof(requestData));
+    requestData.dataType = DEF_DOIP_UDS_DATA;
+    requestData.data.zcanDoIPUdsData.req = &request;
+
+    const auto requestAt = std::chrono::steady_clock::now();
+    result.callStatus = ZcanUdsRequestEx(deviceHandle, &requestData, &result.response,
+                                         result.data.empty() ? nullptr : result.data.data(),
+                                         static_cast<UINT>(result.data.size()));
+    result.requestUs = ElapsedUs(requestAt);
+
+    const bool positive = result.callStatus == STATUS_OK &&
+        result.response.status == ZCAN_UDS_ERROR_OK &&
+        result.response.type == ZCAN_UDS_RT_POSITIVE;
+    result.data.resize(positive ? std::min<UINT>(result.response.positive.data_len, maxResponseLength) : 0);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        DoipConnectionStats& stats = doipConnections_[connectionKey];
+        stats.inFlight--;
+        stats.totalRequestUs += result.requestUs;
+        stats.bytesReceived += positive ? result.data.size() + 1 : 0;
+
+        const bool failed = result.callStatus != STATUS_OK ||
+            (result.response.status != ZCAN_UDS_ERROR_OK && result.response.status != ZCAN_UDS_ERROR_TIMEOUT &&
+             result.response.status != ZCAN_UDS_ERROR_CANCEL && result.response.status != ZCAN_UDS_ERROR_SUPPRESS_RESPONSE);
+        if (failed) {
+            stats.failures++;
+        }
+        if (result.callStatus != STATUS_OK || IsDoipConnectionError(result.response.status)) {
+            stats.established = false;
+        } else if (!failed) {
+            if (!result.connectionReused && !stats.established) {
+                stats.connects++;
+                stats.lastConnectRequestUs = result.requestUs;
+            }
+            stats.established = true;
+        }
+    }
+
+    EndRequest(request.req_id);
+    return result;
+}
+
+std::vector<DoipConnectionStats> UdsClient::DoipConnections() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<DoipConnectionStats> connections;
+    for (const auto& entry : doipConnections_) {
+        connections.push_back(entry.second);
+    }
+    return connections;
+}
+
+void UdsClient::ResetDoipConnections() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : doipConnections_) {
+        entry.second.established = false;
+    }
+}
+
+bool UdsClient::Cancel(DEVICE_HANDLE deviceHandle, UINT reqId) {
+    ZCAN_UDS_DATA_DEF dataType;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = pending_.find(reqId);
+        if (it == pending_.end()) {
+            return false;
+        }
+        it->second.cancelled = true;
+        dataType = it->second.dataType;
+    }
+    // 尚在排队的请求不会发出；已发出的请求由驱动停止，未执行时驱动返回失败可忽略
+    StopRequest(deviceHandle, dataType, reqId);
+    return true;
+}
+
+void UdsClient::CancelAll(DEVICE_HANDLE deviceHandle) {
+    std::vector<std::pair<UINT, ZCAN_UDS_DATA_DEF>> requests;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& entry : pending_) {
+            entry.second.cancelled = true;
+            requests.emplace_back(entry.first, entry.second.dataType);
+        }
+    }
+    for (const auto& request : requests) {
+        StopRequest(deviceHandle, request.second, request.first);
+    }
+}
+
+size_t UdsClient::PendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
@@ -0,0 +1,112 @@
+#ifndef ZLGCAN_UDS_CLIENT_H_
+#define ZLGCAN_UDS_CLIENT_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "zlgcan.h"
+
+// UDS请求结果
+struct UdsResult {
+    UINT reqId = 0;
+    ZCAN_RET_STATUS callStatus = STATUS_ERR;  // ZCAN_UDS_Request 返回值
+    ZCAN_UDS_RESPONSE response{};
+    std::vector<BYTE> data;                   // 积极响应数据（不含SID）
+    uint64_t queuedUs = 0;                    // 等待同通道前序请求完成的时间
+    uint64_t requestUs = 0;                   // ZCAN_UDS_Request 耗时（含P2/P2*等待）
+    bool connectionReused = false;            // DoIP: 请求发出前连接已建立并完成路由激活
+};
+
+// DoIP连接统计，按服务器地址、源地址、协议版本和路由激活类型区分
+struct DoipConnectionStats {
+    std::string serverAddress;
+    UINT sourceAddress = 0;
+    BYTE doipVersion = 0;
+    BYTE activationType = 0;
+    bool established = false;                 // 最近一次请求后连接可复用
+    UINT connects = 0;                        // 建立连接的请求数（首个请求及断开后的重连）
+    UINT requests = 0;
+    UINT failures = 0;                        // 调用失败或返回DoIP错误的请求数
+    UINT inFlight = 0;
+    UINT maxInFlight = 0;                     // 同时执行的请求数峰值
+    uint64_t bytesSent = 0;                   // 诊断数据字节数（含SID）
+    uint64_t bytesReceived = 0;
+    uint64_t lastConnectRequestUs = 0;        // 最近一次建立连接的请求耗时（含TCP连接与路由激活）
+    uint64_t totalRequestUs = 0;
+};
+/**
+ * CAN UDS诊断客户端
+ * ZCAN_UDS_Request为阻塞调用，同一通道同时只能有一个请求；
+ * 本类按通道串行化请求，不同通道的请求可在各自线程中并发执行，
+ * 并跟踪执行中的请求ID以便取消。请求ID由本类分配（AllocateRequestId），
+ * 保证与在途请求不冲突；Request在工作线程中调用。
+ *
+ * DoIP请求经ZCAN_UDS_RequestEX发出，驱动按服务器参数复用TCP连接。
+ * 同一连接上发往同一目标地址的请求依次执行，发往不同目标地址的请求
+ * 可同时在途（DoIP允许一个连接上多个诊断报文并行）。
+ */
+class UdsClient {
+public:
+    UdsClient() = default;
+
+    UdsClient(const UdsClient&) = delete;
+    UdsClient& operator=(const UdsClient&) = delete;
+
+    /**
+     * 分配请求事务ID（0~65535循环，跳过在途ID）并登记为在途，此后即可取消
+     * 分配的ID须随后交给Request/DoipRequest执行，执行结束时释放
+     */
+    UINT AllocateRequestId(ZCAN_UDS_DATA_DEF dataType);
+
+    /**
+     * 执行请求（阻塞）
+     * @param request 请求参数，req_id须由AllocateRequestId分配，data/data_len由payload填充
+     * @param maxResponseLength 响应数据缓冲区大小
+     */
+    UdsResult Request(DEVICE_HANDLE deviceHandle, ZCAN_UDS_REQUEST request,
+                      std::vector<BYTE> payload, UINT maxResponseLength);
+
+    /**
+     * 执行DoIP请求（阻塞）
+     * @param request 请求参数，req_id须由AllocateRequestId分配，data/dataLength由payload填充
+     * @param maxResponseLength 响应数据缓冲区大小
+     */
+    UdsResult DoipRequest(DEVICE_HANDLE deviceHandle, ZDOIP_REQUEST request,
+                          std::vector<BYTE> payload, UINT maxResponseLength);
+
+    std::vector<DoipConnectionStats> DoipConnections() const;
+
+    // 设备关闭后驱动持有的连接随之断开
+    void ResetDoipConnections();
+
+    // 停止执行中或排队中的请求，请求ID未知时返回false
+    bool Cancel(DEVICE_HANDLE deviceHandle, UINT reqId);
+    void CancelAll(DEVICE_HANDLE deviceHandle);
+
+    size_t PendingCount() const;
+
+private:
+    struct PendingRequest {
+        ZCAN_UDS_DATA_DEF dataType;
+        bool cancelled;
+    };
+
+    std::mutex* ChannelMutex(BYTE channel);
+    std::mutex* DoipLaneMutex(const std::string& lane);
+    bool IsCancelled(UINT reqId);
+    void EndRequest(UINT reqId);
+
+    UINT nextReqId_ = 0;
+
+    mutable std::mutex mutex_;
+    std::map<BYTE, std::unique_ptr<std::mutex>> channelMutexes_;
+    std::map<std::string, std::unique_ptr<std::mutex>> doipLanes_;  // 连接+目标地址 -> 串行锁
+    std::map<std::string, DoipConnectionStats> doipConnections_;
+    std::map<UINT, PendingRequest> pending_;
+};
+
+#endif  // ZLGCAN_UDS_CLIENT_H_
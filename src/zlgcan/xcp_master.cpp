@@ -0,0 +1,801 @@
+#include "xcp_master.h"
+#include "zlgcan_api.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// 命令码
+constexpr BYTE CMD_CONNECT = 0xFF;
+constexpr BYTE CMD_DISCONNECT = 0xFE;
+constexpr BYTE CMD_GET_STATUS = 0xFD;
+constexpr BYTE CMD_SYNCH = 0xFC;
+constexpr BYTE CMD_SET_MTA = 0xF6;
+constexpr BYTE CMD_SHORT_UPLOAD = 0xF4;
+constexpr BYTE CMD_DOWNLOAD = 0xF0;
+constexpr BYTE CMD_SET_DAQ_PTR = 0xE2;
+constexpr BYTE CMD_WRITE_DAQ = 0xE1;
+constexpr BYTE CMD_SET_DAQ_LIST_MODE = 0xE0;
+constexpr BYTE CMD_START_STOP_DAQ_LIST = 0xDE;
+constexpr BYTE CMD_START_STOP_SYNCH = 0xDD;
+constexpr BYTE CMD_GET_DAQ_PROCESSOR_INFO = 0xDA;
+constexpr BYTE CMD_GET_DAQ_RESOLUTION_INFO = 0xD9;
+constexpr BYTE CMD_FREE_DAQ = 0xD6;
+constexpr BYTE CMD_ALLOC_DAQ = 0xD5;
+constexpr BYTE CMD_ALLOC_ODT = 0xD4;
+constexpr BYTE CMD_ALLOC_ODT_ENTRY = 0xD3;
+
+// 从机到主机的包标识
+constexpr BYTE PID_RES = 0xFF;
+constexpr BYTE PID_ERR = 0xFE;
+constexpr BYTE PID_EV = 0xFD;
+constexpr BYTE PID_SERV = 0xFC;
+constexpr BYTE PID_MAX_DTO = 0xFB;
+
+constexpr BYTE ERR_CMD_BUSY = 0x10;
+constexpr BYTE RESOURCE_DAQ = 0x04;
+constexpr BYTE DAQ_PROPERTY_DYNAMIC = 0x01;
+constexpr BYTE DAQ_PROPERTY_TIMESTAMP = 0x10;
+constexpr BYTE DAQ_MODE_TIMESTAMP = 0x10;
+
+constexpr BYTE SYNCH_STOP_ALL = 0;
+constexpr BYTE SYNCH_START_SELECTED = 1;
+constexpr BYTE DAQ_LIST_SELECT = 2;
+
+constexpr double CLOCK_WINDOW_US = 1000000.0;  // 时钟偏移的估计窗口（从机时间）
+constexpr size_t BATCH_RESERVE = 64;
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t ElapsedUs(Clock::time_point from, Clock::time_point to) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+}
+
+UINT NormalizeId(UINT id) {
+    return id & (CAN_EFF_FLAG | CAN_EFF_MASK);
+}
+
+BYTE FdFrameLength(size_t len) {
+    static const BYTE lengths[] = {8, 12, 16, 20, 24, 32, 48, 64};
+    if (len <= 8) {
+        return static_cast<BYTE>(len);
+    }
+    for (BYTE l : lengths) {
+        if (len <= l) {
+            return l;
+        }
+    }
+    return CANFD_MAX_DLEN;
+}
+
+const char* ErrorName(BYTE code) {
+    switch (code) {
+        case 0x00: return "ERR_CMD_SYNCH";
+        case 0x10: return "ERR_CMD_BUSY";
+        case 0x11: return "ERR_DAQ_ACTIVE";
+        case 0x12: return "ERR_PGM_ACTIVE";
+        case 0x20: return "ERR_CMD_UNKNOWN";
+        case 0x21: return "ERR_CMD_SYNTAX";
+        case 0x22: return "ERR_OUT_OF_RANGE";
+        case 0x23: return "ERR_WRITE_PROTECTED";
+        case 0x24: return "ERR_ACCESS_DENIED";
+        case 0x25: return "ERR_ACCESS_LOCKED";
+        case 0x26: return "ERR_PAGE_NOT_VALID";
+        case 0x27: return "ERR_MODE_NOT_VALID";
+        case 0x28: return "ERR_SEGMENT_NOT_VALID";
+        case 0x29: return "ERR_SEQUENCE";
+        case 0x2A: return "ERR_DAQ_CONFIG";
+        case 0x30: return "ERR_MEMORY_OVERFLOW";
+        case 0x31: return "ERR_GENERIC";
+        case 0x32: return "ERR_VERIFY";
+        case 0x33: return "ERR_RESOURCE_TEMPORARY_NOT_ACCESSIBLE";
+        default: return "unknown error";
+    }
+}
+
+// 时间戳单位（TIMESTAMP_MODE位4-7）换算为微秒
+double TimestampUnitUs(BYTE mode, UINT ticks) {
+    const int unit = mode >> 4;
+    const double scale = unit <= 9 ? std::pow(10.0, unit - 3) : std::pow(10.0, unit - 10) * 1e-6;
+    return scale * std::max<UINT>(ticks, 1);
+}
+
+XcpCommandResult Fail(const std::string& error) {
+    XcpCommandResult result;
+    result.error = error;
+    return result;
+}
+
+// 给命令序列中的失败加上命令名
+XcpCommandResult Prefixed(XcpCommandResult result, const char* command) {
+    result.error = std::string(command) + ": " + result.error;
+    return result;
+}
+
+}  // namespace
+
+// 一个DAQ列表的解码表和未完成的样本行
+struct XcpMaster::ListState {
+    struct Entry {
+        size_t dtoOffset;
+        size_t size;
+        size_t rowOffset;
+    };
+
+    std::vector<std::vector<Entry>> odts;
+    std::vector<size_t> sizes;         // 各信号的字节数
+    std::vector<size_t> rowOffsets;
+    std::vector<BYTE> row;
+    std::shared_ptr<const XcpDaqListConfig> config;
+    bool timestamps = false;
+    size_t nextOdt = 0;
+    double rowTimestamp = 0;
+    XcpDaqBatch batch;
+
+    void ResetBatch(UINT listIndex, size_t reserve) {
+        batch = XcpDaqBatch();
+        batch.listIndex = listIndex;
+        batch.config = config;
+        batch.timestamps.reserve(reserve);
+        batch.columns.resize(sizes.size());
+        for (size_t i = 0; i < sizes.size(); i++) {
+            batch.columns[i].reserve(reserve * sizes[i]);
+        }
+    }
+};
+
+XcpMaster::XcpMaster(CHANNEL_HANDLE channelHandle, const XcpOptions& options, BatchCallback callback)
+    : channelHandle_(channelHandle), options_(options), callback_(std::move(callback)) {
+    pidOwner_.fill(-1);
+    lastFlush_ = Clock::now();
+}
+
+XcpMaster::~XcpMaster() {
+    Close();
+}
+
+size_t XcpMaster::TypeSize(XcpDataType type) {
+    switch (type) {
+        case XcpDataType::U8:
+        case XcpDataType::I8: return 1;
+        case XcpDataType::U16:
+        case XcpDataType::I16: return 2;
+        case XcpDataType::U32:
+        case XcpDataType::I32:
+        case XcpDataType::F32: return 4;
+        default: return 8;
+    }
+}
+
+void XcpMaster::Close() {
+    {
+        std::lock_guard<std::mutex> lock(responseMutex_);
+        closed_ = true;
+    }
+    responseCv_.notify_all();
+}
+
+XcpStats XcpMaster::Stats() const {
+    std::lock_guard<std::mutex> lock(daqMutex_);
+    XcpStats stats = stats_;
+    stats.clockOffsetUs = clockOffsetUs_;
+    return stats;
+}
+
+void XcpMaster::PutWord(std::vector<BYTE>& buf, UINT value) const {
+    const BYTE lo = static_cast<BYTE>(value);
+    const BYTE hi = static_cast<BYTE>(value >> 8);
+    if (bigEndian_.load()) {
+        buf.push_back(hi);
+        buf.push_back(lo);
+    } else {
+        buf.push_back(lo);
+        buf.push_back(hi);
+    }
+}
+
+void XcpMaster::PutDword(std::vector<BYTE>& buf, uint32_t value) const {
+    for (int i = 0; i < 4; i++) {
+        const int shift = bigEndian_.load() ? (3 - i) * 8 : i * 8;
+        buf.push_back(static_cast<BYTE>(value >> shift));
+    }
+}
+
+UINT XcpMaster::GetWord(const BYTE* data) const {
+    return bigEndian_.load() ? (static_cast<UINT>(data[0]) << 8) | data[1]
+                             : (static_cast<UINT>(data[1]) << 8) | data[0];
+}
+
+bool XcpMaster::TransmitCommand(const std::vector<BYTE>& request) {
+    const CHANNEL_HANDLE handle = channelHandle_.load();
+    const BYTE filler = options_.padding >= 0 ? static_cast<BYTE>(options_.padding) : 0;
+
+    if (options_.fd) {
+        ZCAN_TransmitFD_Data frame;
+        memset(&frame, 0, sizeof(frame));
+        frame.frame.can_id = options_.masterId;
+        BYTE frameLen = FdFrameLength(request.size());
+        if (options_.padding >= 0 && frameLen < 8) {
+            frameLen = 8;
+        }
+        frame.frame.len = frameLen;
+        frame.frame.flags = options_.brs ? CANFD_BRS : 0;
+        memcpy(frame.frame.data, request.data(), request.size());
+        memset(frame.frame.data + request.size(), filler, frameLen - request.size());
+        return ZcanTransmitFD(handle, &frame, 1) == 1;
+    }
+
+    ZCAN_Transmit_Data frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.frame.can_id = options_.masterId;
+    const BYTE frameLen = options_.padding >= 0 ? CAN_MAX_DLEN : static_cast<BYTE>(request.size());
+    frame.frame.can_dlc = frameLen;
+    memcpy(frame.frame.data, request.data(), request.size());
+    memset(frame.frame.data + request.size(), filler, frameLen - request.size());
+    return ZcanTransmit(handle, &frame, 1) == 1;
+}
+
+XcpCommandResult XcpMaster::Exchange(const std::vector<BYTE>& request) {
+    XcpCommandResult result;
+    {
+        std::lock_guard<std::mutex> lock(responseMutex_);
+        if (closed_) {
+            result.error = "master closed";
+            return result;
+        }
+        awaiting_ = true;
+        responseReady_ = false;
+    }
+
+    if (!TransmitCommand(request)) {
+        std::lock_guard<std::mutex> lock(responseMutex_);
+        awaiting_ = false;
+        result.error = "transmit failed";
+        return result;
+    }
+
+    std::unique_lock<std::mutex> lock(responseMutex_);
+    responseCv_.wait_for(lock, std::chrono::milliseconds(options_.timeoutMs),
+                         [this] { return responseReady_ || closed_; });
+    awaiting_ = false;
+    if (!responseReady_) {
+        result.error = closed_ ? "master closed" : "timeout";
+        result.timeout = !closed_;
+        return result;
+    }
+
+    if (response_[0] == PID_ERR) {
+        result.errorCode = response_.size() > 1 ? response_[1] : 0;
+        result.error = ErrorName(result.errorCode);
+        return result;
+    }
+    result.success = true;
+    result.response = std::move(response_);
+    return result;
+}
+
+XcpCommandResult XcpMaster::Command(const std::vector<BYTE>& request) {
+    const auto startedAt = Clock::now();
+    XcpCommandResult result;
+    for (UINT attempt = 0; attempt <= options_.maxRetries; attempt++) {
+        result = Exchange(request);
+        const bool busy = !result.success && result.errorCode == ERR_CMD_BUSY;
+        if (!result.timeout && !busy) {
+            break;
+        }
+        // 超时后先以SYNCH重新同步（期望ERR_CMD_SYNCH），CONNECT直接重发
+        if (result.timeout && request[0] != CMD_CONNECT && attempt < options_.maxRetries) {
+            Exchange({CMD_SYNCH});
+        }
+    }
+    result.durationUs = ElapsedUs(startedAt, Clock::now());
+    RecordCommand(result);
+    return result;
+}
+
+void XcpMaster::RecordCommand(const XcpCommandResult& result) {
+    std::lock_guard<std::mutex> lock(daqMutex_);
+    stats_.commands++;
+    if (result.timeout) {
+        stats_.timeouts++;
+    } else if (!result.success) {
+        stats_.commandErrors++;
+    }
+    stats_.lastCommandUs = result.durationUs;
+    stats_.maxCommandUs = std::max(stats_.maxCommandUs, result.durationUs);
+}
+
+XcpCommandResult XcpMaster::Connect(XcpSlaveInfo* info) {
+    std::lock_guard<std::mutex> operationLock(operationMutex_);
+
+    XcpCommandResult result = Command({CMD_CONNECT, 0x00});
+    if (!result.success) {
+        return result;
+    }
+    const std::vector<BYTE>& res = result.response;
+    if (res.size() < 8) {
+        return Fail("invalid CONNECT response");
+    }
+
+    XcpSlaveInfo slave;
+    slave.resource = res[1];
+    slave.commModeBasic = res[2];
+    slave.maxCto = res[3];
+    slave.bigEndian = (slave.commModeBasic & 0x01) != 0;
+    bigEndian_.store(slave.bigEndian);
+    slave.maxDto = GetWord(&res[4]);
+    slave.protocolVersion = res[6];
+    slave.transportVersion = res[7];
+    if (((slave.commModeBasic >> 1) & 0x03) != 0) {
+        return Fail("only BYTE address granularity is supported");
+    }
+
+    XcpCommandResult status = Command({CMD_GET_STATUS});
+    if (status.success && status.response.size() >= 2) {
+        slave.sessionStatus = status.response[1];
+    }
+
+    if (slave.resource & RESOURCE_DAQ) {
+        XcpCommandResult processor = Command({CMD_GET_DAQ_PROCESSOR_INFO});
+        if (!processor.success) {
+            return Prefixed(processor, "GET_DAQ_PROCESSOR_INFO");
+        }
+        if (processor.response.size() >= 8) {
+            const BYTE* r = processor.response.data();
+            slave.daqProperties = r[1];
+            slave.maxDaq = GetWord(r + 2);
+            slave.maxEventChannel = GetWord(r + 4);
+            slave.minDaq = r[6];
+            slave.daqKeyByte = r[7];
+        }
+        XcpCommandResult resolution = Command({CMD_GET_DAQ_RESOLUTION_INFO});
+        if (!resolution.success) {
+            return Prefixed(resolution, "GET_DAQ_RESOLUTION_INFO");
+        }
+        if (resolution.response.size() >= 8) {
+            const BYTE* r = resolution.response.data();
+            slave.maxOdtEntrySize = r[2];
+            slave.timestampMode = r[5];
+            slave.timestampTicks = GetWord(r + 6);
+        }
+    }
+
+    slave_ = slave;
+    if (info) {
+        *info = slave;
+    }
+    return result;
+}
+
+XcpCommandResult XcpMaster::Disconnect() {
+    std::lock_guard<std::mutex> operationLock(operationMutex_);
+    XcpCommandResult result = Command({CMD_DISCONNECT});
+    slave_ = XcpSlaveInfo();
+    std::lock_guard<std::mutex> lock(daqMutex_);
+    ResetDaq();
+    return result;
+}
+
+XcpCommandResult XcpMaster::ShortUpload(uint32_t address, BYTE extension, BYTE length) {
+    std::lock_guard<std::mutex> operationLock(operationMutex_);
+    if (slave_.maxCto == 0) {
+        return Fail("not connected");
+    }
+    if (length == 0 || length > slave_.maxCto - 1) {
+        return Fail("length exceeds MAX_CTO");
+    }
+    std::vector<BYTE> request = {CMD_SHORT_UPLOAD, length, 0x00, extension};
+    PutDword(request, address);
+    XcpCommandResult result = Command(request);
+    if (result.success && result.response.size() < static_cast<size_t>(length) + 1) {
+        return Fail("short SHORT_UPLOAD response");
+    }
+    return result;
+}
+
+XcpCommandResult XcpMaster::Download(uint32_t address, BYTE extension, const std::vector<BYTE>& data) {
+    std::lock_guard<std::mutex> operationLock(operationMutex_);
+    if (slave_.maxCto < 3) {
+        return Fail("not connected");
+    }
+
+    const auto startedAt = Clock::now();
+    std::vector<BYTE> setMta = {CMD_SET_MTA, 0x00, 0x00, extension};
+    PutDword(setMta, address);
+    XcpCommandResult result = Command(setMta);
+    if (!result.success) {
+        return Prefixed(result, "SET_MTA");
+    }
+
+    // MTA随DOWNLOAD自动递增
+    const size_t chunk = slave_.maxCto - 2;
+    for (size_t offset = 0; offset < data.size(); offset += chunk) {
+        const size_t n = std::min(chunk, data.size() - offset);
+        std::vector<BYTE> request = {CMD_DOWNLOAD, static_cast<BYTE>(n)};
+        request.insert(request.end(), data.begin() + offset, data.begin() + offset + n);
+        result = Command(request);
+        if (!result.success) {
+            return Prefixed(result, "DOWNLOAD");
+        }
+    }
+    result.durationUs = ElapsedUs(startedAt, Clock::now());
+    return result;
+}
+
+XcpCommandResult XcpMaster::StartDaq(const std::vector<XcpDaqListConfig>& lists, bool timestamps,
+                                     std::vector<XcpDaqListLayout>* layout) {
+    std::lock_guard<std::mutex> operationLock(operationMutex_);
+    const auto startedAt = Clock::now();
+
+    if (slave_.maxDto == 0) {
+        return Fail("not connected");
+    }
+    if (!(slave_.resource & RESOURCE_DAQ) || !(slave_.daqProperties & DAQ_PROPERTY_DYNAMIC)) {
+        return Fail("slave does not support dynamic DAQ configuration");
+    }
+    if (((slave_.daqKeyByte >> 6) & 0x03) != 0) {
+        return Fail("only absolute ODT number identification is supported");
+    }
+    if (lists.empty()) {
+        return Fail("no DAQ lists");
+    }
+    size_t timestampSize = 0;
+    if (timestamps) {
+        timestampSize = slave_.timestampMode & 0x07;
+        if (!(slave_.daqProperties & DAQ_PROPERTY_TIMESTAMP) ||
+            (timestampSize != 1 && timestampSize != 2 && timestampSize != 4)) {
+            return Fail("slave does not support DAQ timestamps");
+        }
+    }
+
+    // 按顺序装入ODT：首个ODT在PID后还要容纳时间戳
+    const size_t capacity = std::min<size_t>(slave_.maxDto, options_.fd ? CANFD_MAX_DLEN : CAN_MAX_DLEN) - 1;
+    std::vector<std::unique_ptr<ListState>> states;
+    size_t totalOdts = 0;
+    for (size_t i = 0; i < lists.size(); i++) {
+        if (lists[i].signals.empty()) {
+            return Fail("DAQ list " + std::to_string(i) + " has no signals");
+        }
+        auto state = std::unique_ptr<ListState>(new ListState());
+        state->config = std::make_shared<XcpDaqListConfig>(lists[i]);
+        state->timestamps = timestampSize > 0;
+        size_t used = timestampSize;
+        size_t rowSize = 0;
+        state->odts.emplace_back();
+        for (const XcpSignal& signal : lists[i].signals) {
+            const size_t size = TypeSize(signal.type);
+            if ((slave_.maxOdtEntrySize != 0 && size > slave_.maxOdtEntrySize) || size > capacity) {
+                return Fail("signal " + signal.name + " exceeds MAX_ODT_ENTRY_SIZE_DAQ");
+            }
+            if (used + size > capacity || state->odts.back().size() == 0xFF) {
+                state->odts.emplace_back();
+                used = 0;
+            }
+            state->odts.back().push_back({1 + used, size, rowSize});
+            state->sizes.push_back(size);
+            state->rowOffsets.push_back(rowSize);
+            used += size;
+            rowSize += size;
+        }
+        state->row.resize(rowSize);
+        state->ResetBatch(static_cast<UINT>(i), BATCH_RESERVE);
+        totalOdts += state->odts.size();
+        states.push_back(std::move(state));
+    }
+    if (totalOdts > static_cast<size_t>(PID_MAX_DTO) + 1) {
+        return Fail("too many ODTs");
+    }
+
+    // 停止并释放旧配置
+    Command({CMD_START_STOP_SYNCH, SYNCH_STOP_ALL});
+    {
+        std::lock_guard<std::mutex> lock(daqMutex_);
+        ResetDaq();
+    }
+    XcpCommandResult result = Command({CMD_FREE_DAQ});
+    if (!result.success) {
+        return Prefixed(result, "FREE_DAQ");
+    }
+
+    std::vector<BYTE> request = {CMD_ALLOC_DAQ, 0x00};
+    PutWord(request, static_cast<UINT>(lists.size()));
+    result = Command(request);
+    if (!result.success) {
+        return Prefixed(result, "ALLOC_DAQ");
+    }
+
+    // 动态DAQ列表紧跟在预定义列表之后编号
+    auto daqNumber = [this](size_t i) { return static_cast<UINT>(slave_.minDaq + i); };
+    for (size_t i = 0; i < states.size(); i++) {
+        request = {CMD_ALLOC_ODT, 0x00};
+        PutWord(request, daqNumber(i));
+        request.push_back(static_cast<BYTE>(states[i]->odts.size()));
+        result = Command(request);
+        if (!result.success) {
+            return Prefixed(result, "ALLOC_ODT");
+        }
+    }
+    for (size_t i = 0; i < states.size(); i++) {
+        for (size_t odt = 0; odt < states[i]->odts.size(); odt++) {
+            request = {CMD_ALLOC_ODT_ENTRY, 0x00};
+            PutWord(request, daqNumber(i));
+            request.push_back(static_cast<BYTE>(odt));
+            request.push_back(static_cast<BYTE>(states[i]->odts[odt].size()));
+            result = Command(request);
+            if (!result.success) {
+                return Prefixed(result, "ALLOC_ODT_ENTRY");
+            }
+        }
+    }
+
+    // 写入ODT项，WRITE_DAQ后指针自动指向下一项
+    for (size_t i = 0; i < states.size(); i++) {
+        size_t signalIndex = 0;
+        for (size_t odt = 0; odt < states[i]->odts.size(); odt++) {
+            request = {CMD_SET_DAQ_PTR, 0x00};
+            PutWord(request, daqNumber(i));
+            request.push_back(static_cast<BYTE>(odt));
+            request.push_back(0x00);
+            result = Command(request);
+            if (!result.success) {
+                return Prefixed(result, "SET_DAQ_PTR");
+            }
+            for (size_t entry = 0; entry < states[i]->odts[odt].size(); entry++, signalIndex++) {
+                const XcpSignal& signal = lists[i].signals[signalIndex];
+                request = {CMD_WRITE_DAQ, 0xFF, static_cast<BYTE>(TypeSize(signal.type)), signal.extension};
+                PutDword(request, signal.address);
+                result = Command(request);
+                if (!result.success) {
+                    return Prefixed(result, "WRITE_DAQ");
+                }
+            }
+        }
+    }
+
+    std::vector<XcpDaqListLayout> allocated;
+    for (size_t i = 0; i < states.size(); i++) {
+        request = {CMD_SET_DAQ_LIST_MODE, static_cast<BYTE>(timestampSize > 0 ? DAQ_MODE_TIMESTAMP : 0)};
+        PutWord(request, daqNumber(i));
+        PutWord(request, lists[i].eventChannel);
+        request.push_back(std::max<BYTE>(lists[i].prescaler, 1));
+        request.push_back(lists[i].priority);
+        result = Command(request);
+        if (!result.success) {
+            return Prefixed(result, "SET_DAQ_LIST_MODE");
+        }
+
+        request = {CMD_START_STOP_DAQ_LIST, DAQ_LIST_SELECT};
+        PutWord(request, daqNumber(i));
+        result = Command(request);
+        if (!result.success) {
+            return Prefixed(result, "START_STOP_DAQ_LIST");
+        }
+        if (result.response.size() < 2) {
+            return Fail("invalid START_STOP_DAQ_LIST response");
+        }
+        const BYTE firstPid = result.response[1];
+        if (firstPid + states[i]->odts.size() - 1 > PID_MAX_DTO) {
+            return Fail("FIRST_PID out of range");
+        }
+        allocated.push_back({daqNumber(i), firstPid, static_cast<UINT>(states[i]->odts.size())});
+    }
+
+    // 先装好解码表再同步启动，首批DTO不会被当作未知PID
+    {
+        std::lock_guard<std::mutex> lock(daqMutex_);
+        for (size_t i = 0; i < states.size(); i++) {
+            for (size_t odt = 0; odt < states[i]->odts.size(); odt++) {
+                pidOwner_[allocated[i].firstPid + odt] = static_cast<int32_t>((i << 8) | odt);
+            }
+        }
+        lists_ = std::move(states);
+        timestampSize_ = timestampSize;
+        timestampUnitUs_ = TimestampUnitUs(slave_.timestampMode, slave_.timestampTicks);
+        tsValid_ = false;
+        lastFlush_ = Clock::now();
+    }
+
+    result = Command({CMD_START_STOP_SYNCH, SYNCH_START_SELECTED});
+    if (!result.success) {
+        std::lock_guard<std::mutex> lock(daqMutex_);
+        ResetDaq();
+        return Prefixed(result, "START_STOP_SYNCH");
+    }
+
+    if (layout) {
+        *layout = std::move(allocated);
+    }
+    result.durationUs = ElapsedUs(startedAt, Clock::now());
+    return result;
+}
+
+XcpCommandResult XcpMaster::StopDaq() {
+    std::lock_guard<std::mutex> operationLock(operationMutex_);
+    XcpCommandResult result = Command({CMD_START_STOP_SYNCH, SYNCH_STOP_ALL});
+    std::lock_guard<std::mutex> lock(daqMutex_);
+    ResetDaq();
+    return result;
+}
+
+void XcpMaster::ResetDaq() {
+    // 已解码的样本保留到下一次上报
+    for (auto& state : lists_) {
+        if (state->batch.count > 0) {
+            pending_.push_back(std::move(state->batch));
+        }
+    }
+    lists_.clear();
+    pidOwner_.fill(-1);
+}
+
+double XcpMaster::CorrectTimestamp(uint32_t raw, uint64_t rxTimestamp) {
+    const uint64_t range = 1ULL << (timestampSize_ * 8);
+    if (!tsValid_) {
+        tsBase_ = raw;
+    } else {
+        // 展开回绕；小幅回退（DAQ列表间乱序）按负增量处理
+        const uint64_t delta = (static_cast<uint64_t>(raw) - tsLast_) & (range - 1);
+        if (delta > range / 2) {
+            tsBase_ -= range - delta;
+        } else {
+            tsBase_ += delta;
+        }
+    }
+    tsLast_ = raw;
+
+    const double slaveUs = static_cast<double>(tsBase_) * timestampUnitUs_;
+    const double diff = static_cast<double>(rxTimestamp) - slaveUs;
+    if (!tsValid_) {
+        tsValid_ = true;
+        clockOffsetUs_ = diff;
+        windowMinUs_ = diff;
+        windowStartUs_ = slaveUs;
+    } else {
+        // 接收延迟只会使差值变大：窗口内取最小值，窗口结束时用它跟踪两个时钟的漂移
+        windowMinUs_ = std::min(windowMinUs_, diff);
+        clockOffsetUs_ = std::min(clockOffsetUs_, diff);
+        if (slaveUs - windowStartUs_ >= CLOCK_WINDOW_US) {
+            clockOffsetUs_ = windowMinUs_;
+            windowMinUs_ = diff;
+            windowStartUs_ = slaveUs;
+        }
+    }
+    return slaveUs + clockOffsetUs_;
+}
+
+void XcpMaster::HandleDto(const ZCAN_ReceiveFD_Data& frame) {
+    const BYTE* data = frame.frame.data;
+    const size_t len = frame.frame.len;
+    stats_.dtos++;
+
+    const int32_t owner = pidOwner_[data[0]];
+    if (owner < 0) {
+        stats_.unknownPids++;
+        return;
+    }
+    ListState& state = *lists_[owner >> 8];
+    const size_t odt = owner & 0xFF;
+
+    if (odt != state.nextOdt) {
+        // ODT缺失或乱序：丢弃未完成的行，等待下一个ODT 0
+        if (state.nextOdt != 0) {
+            stats_.lostSamples++;
+        }
+        state.nextOdt = 0;
+        if (odt != 0) {
+            return;
+        }
+    }
+
+    if (odt == 0) {
+        if (state.timestamps) {
+            if (len < 1 + timestampSize_) {
+                stats_.lostSamples++;
+                return;
+            }
+            uint32_t raw = 0;
+            for (size_t i = 0; i < timestampSize_; i++) {
+                const size_t shift = bigEndian_.load() ? (timestampSize_ - 1 - i) * 8 : i * 8;
+                raw |= static_cast<uint32_t>(data[1 + i]) << shift;
+            }
+            state.rowTimestamp = CorrectTimestamp(raw, frame.timestamp);
+        } else {
+            state.rowTimestamp = static_cast<double>(frame.timestamp);
+        }
+    }
+
+    const bool swap = bigEndian_.load();
+    for (const ListState::Entry& entry : state.odts[odt]) {
+        if (entry.dtoOffset + entry.size > len) {
+            stats_.lostSamples++;
+            state.nextOdt = 0;
+            return;
+        }
+        BYTE* dst = state.row.data() + entry.rowOffset;
+        const BYTE* src = data + entry.dtoOffset;
+        if (swap) {
+            std::reverse_copy(src, src + entry.size, dst);
+        } else {
+            memcpy(dst, src, entry.size);
+        }
+    }
+
+    if (++state.nextOdt < state.odts.size()) {
+        return;
+    }
+    state.nextOdt = 0;
+
+    XcpDaqBatch& batch = state.batch;
+    batch.timestamps.push_back(state.rowTimestamp);
+    for (size_t i = 0; i < state.sizes.size(); i++) {
+        const BYTE* value = state.row.data() + state.rowOffsets[i];
+        batch.columns[i].insert(batch.columns[i].end(), value, value + state.sizes[i]);
+    }
+    batch.count++;
+    stats_.samples++;
+
+    if (batch.count >= options_.maxBatch) {
+        const UINT listIndex = batch.listIndex;
+        pending_.push_back(std::move(batch));
+        state.ResetBatch(listIndex, BATCH_RESERVE);
+    }
+}
+
+bool XcpMaster::OnFrame(const ZCAN_ReceiveFD_Data& frame, bool fd) {
+    if ((frame.frame.flags & TX_ECHO_FLAG) || (frame.frame.can_id & (CAN_RTR_FLAG | CAN_ERR_FLAG))) {
+        return false;
+    }
+    if (NormalizeId(frame.frame.can_id) != NormalizeId(options_.slaveId)) {
+        return false;
+    }
+    if (frame.frame.len == 0) {
+        return true;
+    }
+
+    const BYTE pid = frame.frame.data[0];
+    if (pid == PID_RES || pid == PID_ERR) {
+        {
+            std::lock_guard<std::mutex> lock(responseMutex_);
+            if (!awaiting_) {
+                return true;  // 超时后迟到的响应
+            }
+            response_.assign(frame.frame.data, frame.frame.data + frame.frame.len);
+            responseReady_ = true;
+        }
+        responseCv_.notify_all();
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(daqMutex_);
+    if (pid == PID_EV) {
+        stats_.events++;
+    } else if (pid != PID_SERV) {
+        HandleDto(frame);
+    }
+    return true;
+}
+
+void XcpMaster::OnTick(std::chrono::steady_clock::time_point now) {
+    std::vector<XcpDaqBatch> ready;
+    {
+        std::lock_guard<std::mutex> lock(daqMutex_);
+        if (now - lastFlush_ >= std::chrono::milliseconds(options_.batchIntervalMs)) {
+            lastFlush_ = now;
+            for (auto& state : lists_) {
+                if (state->batch.count > 0) {
+                    const UINT listIndex = state->batch.listIndex;
+                    pending_.push_back(std::move(state->batch));
+                    state->ResetBatch(listIndex, BATCH_RESERVE);
+                }
+            }
+        }
+        if (pending_.empty()) {
+            return;
+        }
+        ready.swap(pending_);
+        stats_.batches += ready.size();
+    }
+    callback_(std::move(ready));
+}
@@ -0,0 +1,204 @@
+#ifndef ZLGCAN_XCP_MASTER_H_
+#define ZLGCAN_XCP_MASTER_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "zlgcan.h"
+#include "receive_pump.h"
+
+// XCP-on-CAN配置
+struct XcpOptions {
+    UINT masterId = 0;                 // CRO（主->从）CAN ID，含扩展帧标志
+    UINT slaveId = 0;                  // CRM/DTO（从->主）CAN ID
+    bool fd = false;
+    bool brs = false;
+    int padding = -1;                  // 命令帧填充到8字节（MAX_DLC_REQUIRED），-1不填充
+    UINT timeoutMs = 100;              // 命令超时T1
+    UINT maxRetries = 2;               // 超时或ERR_CMD_BUSY后的重发次数
+    UINT batchIntervalMs = 20;         // DAQ批次上报间隔
+    UINT maxBatch = 1024;              // 单个DAQ列表单批最多的样本数，达到时立即上报
+};
+
+// CONNECT及DAQ处理器信息
+struct XcpSlaveInfo {
+    BYTE resource = 0;
+    BYTE commModeBasic = 0;
+    BYTE maxCto = 0;
+    UINT maxDto = 0;
+    BYTE protocolVersion = 0;
+    BYTE transportVersion = 0;
+    bool bigEndian = false;
+    BYTE sessionStatus = 0;
+    BYTE daqProperties = 0;
+    UINT maxDaq = 0;
+    UINT minDaq = 0;
+    UINT maxEventChannel = 0;
+    BYTE daqKeyByte = 0;
+    BYTE maxOdtEntrySize = 0;
+    BYTE timestampMode = 0;            // 位0-2: 时间戳字节数，位4-7: 单位
+    UINT timestampTicks = 0;
+};
+
+// 测量变量的数据类型
+enum class XcpDataType : uint8_t { U8, I8, U16, I16, U32, I32, U64, I64, F32, F64 };
+
+struct XcpSignal {
+    std::string name;
+    uint32_t address = 0;
+    BYTE extension = 0;
+    XcpDataType type = XcpDataType::U8;
+};
+
+struct XcpDaqListConfig {
+    UINT eventChannel = 0;
+    BYTE prescaler = 1;
+    BYTE priority = 0;
+    std::vector<XcpSignal> signals;
+};
+
+// 分配结果
+struct XcpDaqListLayout {
+    UINT daqList = 0;                  // 从机中的DAQ列表号
+    BYTE firstPid = 0;
+    UINT odts = 0;
+};
+
+/**
+ * 一个DAQ列表的列式批次
+ * columns[i]为第i个信号的值，按类型紧密排列，已转换为主机字节序
+ */
+struct XcpDaqBatch {
+    UINT listIndex = 0;                // 配置中的列表序号
+    std::shared_ptr<const XcpDaqListConfig> config;  // 信号名称和类型
+    UINT count = 0;
+    std::vector<double> timestamps;    // 校正到设备时间轴的时间戳(us)
+    std::vector<std::vector<BYTE>> columns;
+};
+
+// 命令结果，errorCode为从机的错误码（ERR_*），0表示无错误响应
+struct XcpCommandResult {
+    bool success = false;
+    std::string error;
+    BYTE errorCode = 0;
+    bool timeout = false;
+    std::vector<BYTE> response;        // 正响应（含PID）
+    uint64_t durationUs = 0;
+};
+
+// XCP统计
+struct XcpStats {
+    uint64_t commands = 0;
+    uint64_t commandErrors = 0;        // 错误响应
+    uint64_t timeouts = 0;
+    uint64_t events = 0;               // EV包
+    uint64_t dtos = 0;
+    uint64_t samples = 0;
+    uint64_t lostSamples = 0;          // ODT缺失或乱序而丢弃的样本
+    uint64_t unknownPids = 0;
+    uint64_t batches = 0;
+    uint64_t lastCommandUs = 0;
+    uint64_t maxCommandUs = 0;
+    double clockOffsetUs = 0;          // 从机时钟到设备时间轴的当前偏移
+};
+
+/**
+ * XCP-on-CAN主站
+ * 命令在调用线程中阻塞执行（同一主站依次执行），CRM在接收线程中交给等待者；
+ * DTO在接收线程中按ODT的解码表直接写入各信号的列，时间戳先展开回绕，
+ * 再以滑动窗口内的最小(接收时间-从机时间)对齐到设备时间轴，消除总线和驱动的延迟抖动。
+ * 动态DAQ配置要求从机支持ALLOC_DAQ，且识别字段为绝对ODT号。
+ */
+class XcpMaster : public FrameListener {
+public:
+    using BatchCallback = std::function<void(std::vector<XcpDaqBatch>&& batches)>;
+
+    XcpMaster(CHANNEL_HANDLE channelHandle, const XcpOptions& options, BatchCallback callback);
+    ~XcpMaster() override;
+
+    XcpMaster(const XcpMaster&) = delete;
+    XcpMaster& operator=(const XcpMaster&) = delete;
+
+    // CONNECT、GET_STATUS，并读取DAQ处理器和分辨率信息
+    XcpCommandResult Connect(XcpSlaveInfo* info);
+    XcpCommandResult Disconnect();
+    XcpCommandResult ShortUpload(uint32_t address, BYTE extension, BYTE length);
+    XcpCommandResult Download(uint32_t address, BYTE extension, const std::vector<BYTE>& data);
+
+    /**
+     * 配置并启动DAQ
+     * 停止并释放从机中已有的动态DAQ列表，按顺序把信号装入ODT后写入从机，
+     * 选中全部列表并以START_STOP_SYNCH同步启动
+     */
+    XcpCommandResult StartDaq(const std::vector<XcpDaqListConfig>& lists, bool timestamps,
+                              std::vector<XcpDaqListLayout>* layout);
+    XcpCommandResult StopDaq();
+
+    // 结束等待中的命令，之后的命令直接返回失败
+    void Close();
+
+    XcpStats Stats() const;
+
+    void SetChannelHandle(CHANNEL_HANDLE channelHandle) { channelHandle_.store(channelHandle); }
+
+    bool OnFrame(const ZCAN_ReceiveFD_Data& frame, bool fd) override;
+    void OnTick(std::chrono::steady_clock::time_point now) override;
+
+    static size_t TypeSize(XcpDataType type);
+
+private:
+    struct ListState;
+
+    XcpCommandResult Command(const std::vector<BYTE>& request);
+    XcpCommandResult Exchange(const std::vector<BYTE>& request);
+    void RecordCommand(const XcpCommandResult& result);
+    bool TransmitCommand(const std::vector<BYTE>& request);
+    void PutWord(std::vector<BYTE>& buf, UINT value) const;
+    void PutDword(std::vector<BYTE>& buf, uint32_t value) const;
+    UINT GetWord(const BYTE* data) const;
+
+    void HandleDto(const ZCAN_ReceiveFD_Data& frame);
+    double CorrectTimestamp(uint32_t raw, uint64_t rxTimestamp);
+    void ResetDaq();
+
+    std::atomic<CHANNEL_HANDLE> channelHandle_;
+    const XcpOptions options_;
+    const BatchCallback callback_;
+
+    // 命令序列串行执行；响应由接收线程放入response_
+    std::mutex operationMutex_;
+    std::mutex responseMutex_;
+    std::condition_variable responseCv_;
+    bool awaiting_ = false;
+    bool responseReady_ = false;
+    bool closed_ = false;
+    std::vector<BYTE> response_;
+    std::atomic<bool> bigEndian_{false};
+    XcpSlaveInfo slave_;                        // operationMutex_保护
+
+    // DAQ解码状态，接收线程持有
+    mutable std::mutex daqMutex_;
+    std::vector<std::unique_ptr<ListState>> lists_;
+    std::array<int32_t, 256> pidOwner_;         // 绝对ODT号 -> (列表序号 << 8 | ODT序号)，-1未使用
+    size_t timestampSize_ = 0;
+    double timestampUnitUs_ = 0;
+    uint64_t tsBase_ = 0;                       // 展开回绕后的从机时间（tick）
+    uint32_t tsLast_ = 0;
+    bool tsValid_ = false;
+    double clockOffsetUs_ = 0;
+    double windowMinUs_ = 0;
+    double windowStartUs_ = 0;
+    std::chrono::steady_clock::time_point lastFlush_;
+    std::vector<XcpDaqBatch> pending_;
+    XcpStats stats_;
+};
+
+#endif  // ZLGCAN_XCP_MASTER_H_
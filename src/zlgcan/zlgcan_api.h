@@ -0,0 +1,561 @@
+#ifndef ZLGCAN_API_H_
+#define ZLGCAN_API_H_
+
+#include "zlgcan.h"
+#include "api_stats.h"
+#include "device_gate.h"
+
+// ZCAN_*接口的计量封装：参数与返回值和原接口一致，额外记录调用次数、失败次数、搬运帧数和耗时分布。
+// 失败的判定：状态类接口返回值不为STATUS_OK，句柄类接口返回无效句柄，取值类接口返回空指针，
+// 批量发送实际发出数少于请求数；接收与查询类接口不计失败。
+// 以句柄为参数的接口在调用期间持有句柄所属设备的闸门（device_gate.h，未登记的句柄不经过闸门），
+// 句柄已随设备掉线关闭时直接返回失败值，不进入驱动也不计量；分配句柄的接口在返回前解除同值旧句柄的失效登记。
+
+// ==================== 设备 ====================
+
+inline DEVICE_HANDLE ZcanOpenDevice(UINT deviceType, UINT deviceIndex, UINT reserved) {
+    const uint64_t start = ApiStatsNow();
+    const DEVICE_HANDLE handle = ZCAN_OpenDevice(deviceType, deviceIndex, reserved);
+    ApiStatsRecord(ApiId::OpenDevice, start, 0, 0, handle == INVALID_DEVICE_HANDLE);
+    DeviceGateAdopt(handle);
+    return handle;
+}
+
+inline UINT ZcanCloseDevice(DEVICE_HANDLE deviceHandle) {
+    DeviceGateScope gate(deviceHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT result = ZCAN_CloseDevice(deviceHandle);
+    ApiStatsRecord(ApiId::CloseDevice, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline UINT ZcanGetDeviceInf(DEVICE_HANDLE deviceHandle, ZCAN_DEVICE_INFO* info) {
+    DeviceGateScope gate(deviceHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT result = ZCAN_GetDeviceInf(deviceHandle, info);
+    ApiStatsRecord(ApiId::GetDeviceInf, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline UINT ZcanGetDeviceInfoEx(DEVICE_HANDLE deviceHandle, ZCAN_DEVICE_INFO_EX* info) {
+    DeviceGateScope gate(deviceHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT result = ZCAN_GetDeviceInfoEx(deviceHandle, info);
+    ApiStatsRecord(ApiId::GetDeviceInfoEx, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline UINT ZcanIsDeviceOnLine(DEVICE_HANDLE deviceHandle) {
+    DeviceGateScope gate(deviceHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT result = ZCAN_IsDeviceOnLine(deviceHandle);
+    ApiStatsRecord(ApiId::IsDeviceOnLine, start, 0, 0, result != STATUS_ONLINE && result != STATUS_OFFLINE);
+    return result;
+}
+
+// ==================== CAN通道 ====================
+
+inline CHANNEL_HANDLE ZcanInitCAN(DEVICE_HANDLE deviceHandle, UINT channelIndex, ZCAN_CHANNEL_INIT_CONFIG* config) {
+    CHANNEL_HANDLE handle = INVALID_CHANNEL_HANDLE;
+    {
+        DeviceGateScope gate(deviceHandle);
+        if (!gate) {
+            return INVALID_CHANNEL_HANDLE;
+        }
+        const uint64_t start = ApiStatsNow();
+        handle = ZCAN_InitCAN(deviceHandle, channelIndex, config);
+        ApiStatsRecord(ApiId::InitCAN, start, 0, 0, handle == INVALID_CHANNEL_HANDLE);
+    }
+    DeviceGateAdopt(handle);
+    return handle;
+}
+
+inline UINT ZcanStartCAN(CHANNEL_HANDLE channelHandle) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT result = ZCAN_StartCAN(channelHandle);
+    ApiStatsRecord(ApiId::StartCAN, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline UINT ZcanResetCAN(CHANNEL_HANDLE channelHandle) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT result = ZCAN_ResetCAN(channelHandle);
+    ApiStatsRecord(ApiId::ResetCAN, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline UINT ZcanClearBuffer(CHANNEL_HANDLE channelHandle) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT result = ZCAN_ClearBuffer(channelHandle);
+    ApiStatsRecord(ApiId::ClearBuffer, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline UINT ZcanReadChannelErrInfo(CHANNEL_HANDLE channelHandle, ZCAN_CHANNEL_ERR_INFO* errInfo) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT result = ZCAN_ReadChannelErrInfo(channelHandle, errInfo);
+    ApiStatsRecord(ApiId::ReadChannelErrInfo, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline UINT ZcanReadChannelStatus(CHANNEL_HANDLE channelHandle, ZCAN_CHANNEL_STATUS* status) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT result = ZCAN_ReadChannelStatus(channelHandle, status);
+    ApiStatsRecord(ApiId::ReadChannelStatus, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline UINT ZcanGetReceiveNum(CHANNEL_HANDLE channelHandle, BYTE type) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return 0;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT count = ZCAN_GetReceiveNum(channelHandle, type);
+    ApiStatsRecord(ApiId::GetReceiveNum, start, 0, 0, false);
+    return count;
+}
+
+// ==================== 收发 ====================
+
+inline UINT ZcanTransmit(CHANNEL_HANDLE channelHandle, ZCAN_Transmit_Data* frames, UINT len) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return 0;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT sent = ZCAN_Transmit(channelHandle, frames, len);
+    ApiStatsRecord(ApiId::Transmit, start, sent, sent * sizeof(ZCAN_Transmit_Data), sent < len);
+    return sent;
+}
+
+inline UINT ZcanTransmitFD(CHANNEL_HANDLE channelHandle, ZCAN_TransmitFD_Data* frames, UINT len) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return 0;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT sent = ZCAN_TransmitFD(channelHandle, frames, len);
+    ApiStatsRecord(ApiId::TransmitFD, start, sent, sent * sizeof(ZCAN_TransmitFD_Data), sent < len);
+    return sent;
+}
+
+inline UINT ZcanReceive(CHANNEL_HANDLE channelHandle, ZCAN_Receive_Data* frames, UINT len, int waitTime) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return 0;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT received = ZCAN_Receive(channelHandle, frames, len, waitTime);
+    ApiStatsRecord(ApiId::Receive, start, received, received * sizeof(ZCAN_Receive_Data), false);
+    return received;
+}
+
+inline UINT ZcanReceiveFD(CHANNEL_HANDLE channelHandle, ZCAN_ReceiveFD_Data* frames, UINT len, int waitTime) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return 0;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT received = ZCAN_ReceiveFD(channelHandle, frames, len, waitTime);
+    ApiStatsRecord(ApiId::ReceiveFD, start, received, received * sizeof(ZCAN_ReceiveFD_Data), false);
+    return received;
+}
+
+inline UINT ZcanTransmitData(DEVICE_HANDLE deviceHandle, ZCANDataObj* objs, UINT len) {
+    DeviceGateScope gate(deviceHandle);
+    if (!gate) {
+        return 0;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT sent = ZCAN_TransmitData(deviceHandle, objs, len);
+    ApiStatsRecord(ApiId::TransmitData, start, sent, sent * sizeof(ZCANDataObj), sent < len);
+    return sent;
+}
+
+inline UINT ZcanReceiveData(DEVICE_HANDLE deviceHandle, ZCANDataObj* objs, UINT len, int waitTime) {
+    DeviceGateScope gate(deviceHandle);
+    if (!gate) {
+        return 0;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT received = ZCAN_ReceiveData(deviceHandle, objs, len, waitTime);
+    ApiStatsRecord(ApiId::ReceiveData, start, received, received * sizeof(ZCANDataObj), false);
+    return received;
+}
+
+// ==================== 属性 ====================
+
+inline UINT ZcanSetValue(DEVICE_HANDLE deviceHandle, const char* path, const void* value) {
+    DeviceGateScope gate(deviceHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT result = ZCAN_SetValue(deviceHandle, path, value);
+    ApiStatsRecord(ApiId::SetValue, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline const void* ZcanGetValue(DEVICE_HANDLE deviceHandle, const char* path) {
+    DeviceGateScope gate(deviceHandle);
+    if (!gate) {
+        return nullptr;
+    }
+    const uint64_t start = ApiStatsNow();
+    const void* value = ZCAN_GetValue(deviceHandle, path);
+    ApiStatsRecord(ApiId::GetValue, start, 0, 0, value == nullptr);
+    return value;
+}
+
+inline IProperty* ZcanGetIProperty(DEVICE_HANDLE deviceHandle) {
+    IProperty* property = nullptr;
+    {
+        DeviceGateScope gate(deviceHandle);
+        if (!gate) {
+            return nullptr;
+        }
+        const uint64_t start = ApiStatsNow();
+        property = GetIProperty(deviceHandle);
+        ApiStatsRecord(ApiId::GetIProperty, start, 0, 0, property == nullptr);
+    }
+    DeviceGateAdopt(property);
+    return property;
+}
+
+inline UINT ZcanReleaseIProperty(IProperty* property) {
+    DeviceGateScope gate(property);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT result = ReleaseIProperty(property);
+    ApiStatsRecord(ApiId::ReleaseIProperty, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline int ZcanPropertySetValue(IProperty* property, const char* path, const char* value) {
+    DeviceGateScope gate(property);
+    if (!gate) {
+        return 0;
+    }
+    const uint64_t start = ApiStatsNow();
+    const int result = property->SetValue(path, value);
+    ApiStatsRecord(ApiId::PropertySetValue, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline const char* ZcanPropertyGetValue(IProperty* property, const char* path) {
+    DeviceGateScope gate(property);
+    if (!gate) {
+        return nullptr;
+    }
+    const uint64_t start = ApiStatsNow();
+    const char* value = property->GetValue(path);
+    ApiStatsRecord(ApiId::PropertyGetValue, start, 0, 0, value == nullptr);
+    return value;
+}
+
+// ==================== LIN ====================
+
+inline CHANNEL_HANDLE ZcanInitLIN(DEVICE_HANDLE deviceHandle, UINT linIndex, PZCAN_LIN_INIT_CONFIG config) {
+    CHANNEL_HANDLE handle = INVALID_CHANNEL_HANDLE;
+    {
+        DeviceGateScope gate(deviceHandle);
+        if (!gate) {
+            return INVALID_CHANNEL_HANDLE;
+        }
+        const uint64_t start = ApiStatsNow();
+        handle = ZCAN_InitLIN(deviceHandle, linIndex, config);
+        ApiStatsRecord(ApiId::InitLIN, start, 0, 0, handle == INVALID_CHANNEL_HANDLE);
+    }
+    DeviceGateAdopt(handle);
+    return handle;
+}
+
+inline UINT ZcanStartLIN(CHANNEL_HANDLE channelHandle) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT result = ZCAN_StartLIN(channelHandle);
+    ApiStatsRecord(ApiId::StartLIN, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline UINT ZcanResetLIN(CHANNEL_HANDLE channelHandle) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT result = ZCAN_ResetLIN(channelHandle);
+    ApiStatsRecord(ApiId::ResetLIN, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline UINT ZcanTransmitLIN(CHANNEL_HANDLE channelHandle, PZCAN_LIN_MSG messages, UINT len) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return 0;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT sent = ZCAN_TransmitLIN(channelHandle, messages, len);
+    ApiStatsRecord(ApiId::TransmitLIN, start, sent, sent * sizeof(ZCAN_LIN_MSG), sent < len);
+    return sent;
+}
+
+inline UINT ZcanReceiveLIN(CHANNEL_HANDLE channelHandle, PZCAN_LIN_MSG messages, UINT len, int waitTime) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return 0;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT received = ZCAN_ReceiveLIN(channelHandle, messages, len, waitTime);
+    ApiStatsRecord(ApiId::ReceiveLIN, start, received, received * sizeof(ZCAN_LIN_MSG), false);
+    return received;
+}
+
+inline UINT ZcanGetLINReceiveNum(CHANNEL_HANDLE channelHandle) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return 0;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT count = ZCAN_GetLINReceiveNum(channelHandle);
+    ApiStatsRecord(ApiId::GetLINReceiveNum, start, 0, 0, false);
+    return count;
+}
+
+inline UINT ZcanSetLINPublish(CHANNEL_HANDLE channelHandle, PZCAN_LIN_PUBLISH_CFG configs, UINT count) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT result = ZCAN_SetLINPublish(channelHandle, configs, count);
+    ApiStatsRecord(ApiId::SetLINPublish, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline UINT ZcanSetLINPublishEx(CHANNEL_HANDLE channelHandle, PZCAN_LIN_PUBLISH_CFG_EX configs, UINT count) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT result = ZCAN_SetLINPublishEx(channelHandle, configs, count);
+    ApiStatsRecord(ApiId::SetLINPublishEx, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline UINT ZcanSetLINSubscribe(CHANNEL_HANDLE channelHandle, PZCAN_LIN_SUBSCIBE_CFG configs, UINT count) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT result = ZCAN_SetLINSubscribe(channelHandle, configs, count);
+    ApiStatsRecord(ApiId::SetLINSubscribe, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline UINT ZcanWakeUpLIN(CHANNEL_HANDLE channelHandle) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const UINT result = ZCAN_WakeUpLIN(channelHandle);
+    ApiStatsRecord(ApiId::WakeUpLIN, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+// ==================== LIN调度表 ====================
+
+inline ZCAN_LIN_SCHED_HANDLE ZcanCreateLINSchedule(DEVICE_HANDLE deviceHandle, ZCAN_LIN_SCHED_ITEM* items, UINT count) {
+    DeviceGateScope gate(deviceHandle);
+    if (!gate) {
+        return INVALID_LIN_SCHED_HANDLE;
+    }
+    const uint64_t start = ApiStatsNow();
+    const ZCAN_LIN_SCHED_HANDLE schedule = ZCAN_CreateLINSchedule(deviceHandle, items, count);
+    ApiStatsRecord(ApiId::CreateLINSchedule, start, 0, 0, schedule == INVALID_LIN_SCHED_HANDLE);
+    return schedule;
+}
+
+inline ZCAN_RET_STATUS ZcanDestroyLINSchedule(DEVICE_HANDLE deviceHandle, ZCAN_LIN_SCHED_HANDLE schedule) {
+    DeviceGateScope gate(deviceHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const ZCAN_RET_STATUS result = ZCAN_DestroyLINSchedule(deviceHandle, schedule);
+    ApiStatsRecord(ApiId::DestroyLINSchedule, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline ZCAN_RET_STATUS ZcanAddLINSchedule(CHANNEL_HANDLE channelHandle, ZCAN_LIN_SCHED_HANDLE schedule, UINT runCount) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const ZCAN_RET_STATUS result = ZCAN_AddLINSchedule(channelHandle, schedule, runCount);
+    ApiStatsRecord(ApiId::AddLINSchedule, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline ZCAN_RET_STATUS ZcanClrLINSchedule(CHANNEL_HANDLE channelHandle) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const ZCAN_RET_STATUS result = ZCAN_ClrLINSchedule(channelHandle);
+    ApiStatsRecord(ApiId::ClrLINSchedule, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline ZCAN_RET_STATUS ZcanStartLINSchedule(CHANNEL_HANDLE channelHandle) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const ZCAN_RET_STATUS result = ZCAN_StartLINSchedule(channelHandle);
+    ApiStatsRecord(ApiId::StartLINSchedule, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline ZCAN_RET_STATUS ZcanStopLINSchedule(CHANNEL_HANDLE channelHandle) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const ZCAN_RET_STATUS result = ZCAN_StopLINSchedule(channelHandle);
+    ApiStatsRecord(ApiId::StopLINSchedule, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline ZCAN_RET_STATUS ZcanSetLINScheduleEnabled(CHANNEL_HANDLE channelHandle, ZCAN_LIN_SCHED_HANDLE schedule,
+                                                 UINT enabled) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const ZCAN_RET_STATUS result = ZCAN_SetLINScheduleEnabled(channelHandle, schedule, enabled);
+    ApiStatsRecord(ApiId::SetLINScheduleEnabled, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline ZCAN_RET_STATUS ZcanSetLINScheduleItemEnabled(CHANNEL_HANDLE channelHandle, ZCAN_LIN_SCHED_HANDLE schedule,
+                                                     UINT index, UINT enabled) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const ZCAN_RET_STATUS result = ZCAN_SetLINScheduleItemEnabled(channelHandle, schedule, index, enabled);
+    ApiStatsRecord(ApiId::SetLINScheduleItemEnabled, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline ZCAN_RET_STATUS ZcanGetLINScheduleStatus(CHANNEL_HANDLE channelHandle, ZCAN_LIN_SCHED_HANDLE schedule,
+                                                ZCAN_LIN_SCHED_STATUS* status) {
+    DeviceGateScope gate(channelHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const ZCAN_RET_STATUS result = ZCAN_GetLINScheduleStatus(channelHandle, schedule, status);
+    ApiStatsRecord(ApiId::GetLINScheduleStatus, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+// ==================== UDS ====================
+
+inline ZCAN_RET_STATUS ZcanUdsRequest(DEVICE_HANDLE deviceHandle, const ZCAN_UDS_REQUEST* request,
+                                      ZCAN_UDS_RESPONSE* response, BYTE* dataBuf, UINT dataBufSize) {
+    DeviceGateScope gate(deviceHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const ZCAN_RET_STATUS result = ZCAN_UDS_Request(deviceHandle, request, response, dataBuf, dataBufSize);
+    ApiStatsRecord(ApiId::UdsRequest, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline ZCAN_RET_STATUS ZcanUdsControl(DEVICE_HANDLE deviceHandle, const ZCAN_UDS_CTRL_REQ* ctrl,
+                                      ZCAN_UDS_CTRL_RESP* response) {
+    DeviceGateScope gate(deviceHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const ZCAN_RET_STATUS result = ZCAN_UDS_Control(deviceHandle, ctrl, response);
+    ApiStatsRecord(ApiId::UdsControl, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline ZCAN_RET_STATUS ZcanUdsRequestEx(DEVICE_HANDLE deviceHandle, const ZCANUdsRequestDataObj* request,
+                                        ZCAN_UDS_RESPONSE* response, BYTE* dataBuf, UINT dataBufSize) {
+    DeviceGateScope gate(deviceHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const ZCAN_RET_STATUS result = ZCAN_UDS_RequestEX(deviceHandle, request, response, dataBuf, dataBufSize);
+    ApiStatsRecord(ApiId::UdsRequestEx, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+inline ZCAN_RET_STATUS ZcanUdsControlEx(DEVICE_HANDLE deviceHandle, ZCAN_UDS_DATA_DEF dataType,
+                                        const ZCAN_UDS_CTRL_REQ* ctrl, ZCAN_UDS_CTRL_RESP* response) {
+    DeviceGateScope gate(deviceHandle);
+    if (!gate) {
+        return STATUS_ERR;
+    }
+    const uint64_t start = ApiStatsNow();
+    const ZCAN_RET_STATUS result = ZCAN_UDS_ControlEX(deviceHandle, dataType, ctrl, response);
+    ApiStatsRecord(ApiId::UdsControlEx, start, 0, 0, result != STATUS_OK);
+    return result;
+}
+
+#endif  // ZLGCAN_API_H_
@@ -0,0 +1,225 @@
+/**
+ * 仿真与SocketCAN后端共用的zlgcan.h剩余接口
+ * LIN、UDS和云接口没有对应实现，返回STATUS_UNSUPPORTED（或无效句柄/0），保证两个目标都能完整替代zlgcan.lib。
+ */
+#include "zlgcan.h"
+
+// ==================== 云（不支持） ====================
+
+void FUNC_CALL ZCLOUD_SetServerInfo(const char* httpSvr, unsigned short httpPort, const char* authSvr,
+                                    unsigned short authPort) {
+    (void)httpSvr;
+    (void)httpPort;
+    (void)authSvr;
+    (void)authPort;
+}
+
+UINT FUNC_CALL ZCLOUD_ConnectServer(const char* username, const char* password) {
+    (void)username;
+    (void)password;
+    return 1;
+}
+
+UINT FUNC_CALL ZCLOUD_IsConnected() {
+    return 0;
+}
+
+UINT FUNC_CALL ZCLOUD_DisconnectServer() {
+    return 0;
+}
+
+const ZCLOUD_USER_DATA* FUNC_CALL ZCLOUD_GetUserData(int update) {
+    (void)update;
+    return nullptr;
+}
+
+UINT FUNC_CALL ZCLOUD_ReceiveGPS(DEVICE_HANDLE device_handle, ZCLOUD_GPS_FRAME* pReceive, UINT len, int wait_time) {
+    (void)device_handle;
+    (void)pReceive;
+    (void)len;
+    (void)wait_time;
+    return 0;
+}
+
+// ==================== LIN（不支持） ====================
+
+CHANNEL_HANDLE FUNC_CALL ZCAN_InitLIN(DEVICE_HANDLE device_handle, UINT lin_index,
+                                      PZCAN_LIN_INIT_CONFIG pLINInitConfig) {
+    (void)device_handle;
+    (void)lin_index;
+    (void)pLINInitConfig;
+    return INVALID_CHANNEL_HANDLE;
+}
+
+UINT FUNC_CALL ZCAN_StartLIN(CHANNEL_HANDLE channel_handle) {
+    (void)channel_handle;
+    return STATUS_UNSUPPORTED;
+}
+
+UINT FUNC_CALL ZCAN_ResetLIN(CHANNEL_HANDLE channel_handle) {
+    (void)channel_handle;
+    return STATUS_UNSUPPORTED;
+}
+
+UINT FUNC_CALL ZCAN_TransmitLIN(CHANNEL_HANDLE channel_handle, PZCAN_LIN_MSG pSend, UINT Len) {
+    (void)channel_handle;
+    (void)pSend;
+    (void)Len;
+    return 0;
+}
+
+UINT FUNC_CALL ZCAN_GetLINReceiveNum(CHANNEL_HANDLE channel_handle) {
+    (void)channel_handle;
+    return 0;
+}
+
+UINT FUNC_CALL ZCAN_ReceiveLIN(CHANNEL_HANDLE channel_handle, PZCAN_LIN_MSG pReceive, UINT Len, int WaitTime) {
+    (void)channel_handle;
+    (void)pReceive;
+    (void)Len;
+    (void)WaitTime;
+    return 0;
+}
+
+UINT FUNC_CALL ZCAN_SetLINSubscribe(CHANNEL_HANDLE channel_handle, PZCAN_LIN_SUBSCIBE_CFG pSend,
+                                    UINT nSubscribeCount) {
+    (void)channel_handle;
+    (void)pSend;
+    (void)nSubscribeCount;
+    return STATUS_UNSUPPORTED;
+}
+
+UINT FUNC_CALL ZCAN_SetLINPublish(CHANNEL_HANDLE channel_handle, PZCAN_LIN_PUBLISH_CFG pSend, UINT nPublishCount) {
+    (void)channel_handle;
+    (void)pSend;
+    (void)nPublishCount;
+    return STATUS_UNSUPPORTED;
+}
+
+UINT FUNC_CALL ZCAN_SetLINPublishEx(CHANNEL_HANDLE channel_handle, PZCAN_LIN_PUBLISH_CFG_EX pSend,
+                                    UINT nPublishCount) {
+    (void)channel_handle;
+    (void)pSend;
+    (void)nPublishCount;
+    return STATUS_UNSUPPORTED;
+}
+
+UINT FUNC_CALL ZCAN_WakeUpLIN(CHANNEL_HANDLE channel_handle) {
+    (void)channel_handle;
+    return STATUS_UNSUPPORTED;
+}
+
+UINT FUNC_CALL ZCAN_SetLINSlaveMsg(CHANNEL_HANDLE channel_handle, PZCAN_LIN_MSG pSend, UINT nMsgCount) {
+    (void)channel_handle;
+    (void)pSend;
+    (void)nMsgCount;
+    return STATUS_UNSUPPORTED;
+}
+
+UINT FUNC_CALL ZCAN_ClearLINSlaveMsg(CHANNEL_HANDLE channel_handle, BYTE* pLINID, UINT nIDCount) {
+    (void)channel_handle;
+    (void)pLINID;
+    (void)nIDCount;
+    return STATUS_UNSUPPORTED;
+}
+
+ZCAN_LIN_SCHED_HANDLE FUNC_CALL ZCAN_CreateLINSchedule(DEVICE_HANDLE device_handle, ZCAN_LIN_SCHED_ITEM* items,
+                                                       UINT count) {
+    (void)device_handle;
+    (void)items;
+    (void)count;
+    return INVALID_LIN_SCHED_HANDLE;
+}
+
+ZCAN_RET_STATUS FUNC_CALL ZCAN_DestroyLINSchedule(DEVICE_HANDLE device_handle, ZCAN_LIN_SCHED_HANDLE sched_handle) {
+    (void)device_handle;
+    (void)sched_handle;
+    return STATUS_UNSUPPORTED;
+}
+
+ZCAN_RET_STATUS FUNC_CALL ZCAN_AddLINSchedule(CHANNEL_HANDLE channel_handle, ZCAN_LIN_SCHED_HANDLE sched_handle,
+                                              UINT running_cnt) {
+    (void)channel_handle;
+    (void)sched_handle;
+    (void)running_cnt;
+    return STATUS_UNSUPPORTED;
+}
+
+ZCAN_RET_STATUS FUNC_CALL ZCAN_ClrLINSchedule(CHANNEL_HANDLE channel_handle) {
+    (void)channel_handle;
+    return STATUS_UNSUPPORTED;
+}
+
+ZCAN_RET_STATUS FUNC_CALL ZCAN_SetLINScheduleEnabled(CHANNEL_HANDLE channel_handle, ZCAN_LIN_SCHED_HANDLE sched_handle,
+                                                     UINT enabled) {
+    (void)channel_handle;
+    (void)sched_handle;
+    (void)enabled;
+    return STATUS_UNSUPPORTED;
+}
+
+ZCAN_RET_STATUS FUNC_CALL ZCAN_SetLINScheduleItemEnabled(CHANNEL_HANDLE channel_handle,
+                                                         ZCAN_LIN_SCHED_HANDLE sched_handle, UINT idx, UINT enabled) {
+    (void)channel_handle;
+    (void)sched_handle;
+    (void)idx;
+    (void)enabled;
+    return STATUS_UNSUPPORTED;
+}
+
+ZCAN_RET_STATUS FUNC_CALL ZCAN_GetLINScheduleStatus(CHANNEL_HANDLE channel_handle, ZCAN_LIN_SCHED_HANDLE sched_handle,
+                                                    ZCAN_LIN_SCHED_STATUS* status) {
+    (void)channel_handle;
+    (void)sched_handle;
+    (void)status;
+    return STATUS_UNSUPPORTED;
+}
+
+ZCAN_RET_STATUS FUNC_CALL ZCAN_StartLINSchedule(CHANNEL_HANDLE channel_handle) {
+    (void)channel_handle;
+    return STATUS_UNSUPPORTED;
+}
+
+ZCAN_RET_STATUS FUNC_CALL ZCAN_StopLINSchedule(CHANNEL_HANDLE channel_handle) {
+    (void)channel_handle;
+    return STATUS_UNSUPPORTED;
+}
+
+// ==================== UDS（不支持） ====================
+
+ZCAN_RET_STATUS FUNC_CALL ZCAN_UDS_Request(DEVICE_HANDLE device_handle, const ZCAN_UDS_REQUEST* req,
+                                           ZCAN_UDS_RESPONSE* resp, BYTE* dataBuf, UINT dataBufSize) {
+    (void)device_handle;
+    (void)req;
+    (void)resp;
+    (void)dataBuf;
+    (void)dataBufSize;
+    return STATUS_UNSUPPORTED;
+}
+
+ZCAN_RET_STATUS FUNC_CALL ZCAN_UDS_Control(DEVICE_HANDLE device_handle, const ZCAN_UDS_CTRL_REQ* ctrl,
+                                           ZCAN_UDS_CTRL_RESP* resp) {
+    (void)device_handle;
+    (void)ctrl;
+    (void)resp;
+    return STATUS_UNSUPPORTED;
+}
+
+ZCAN_RET_STATUS FUNC_CALL ZCAN_UDS_RequestEX(DEVICE_HANDLE device_handle, const ZCANUdsRequestDataObj* requestData,
+                                             ZCAN_UDS_RESPONSE* resp, BYTE* dataBuf, UINT dataBufSize) {
+    (void)device_handle;
+    (void)requestData;
+    (void)resp;
+    (void)dataBuf;
+    (void)dataBufSize;
+    return STATUS_UNSUPPORTED;
+}
+
+ZCAN_RET_STATUS FUNC_CALL ZCAN_UDS_ControlEX(DEVICE_HANDLE device_handle, ZCAN_UDS_DATA_DEF dataType,
+                                             const ZCAN_UDS_CTRL_REQ* ctrl, ZCAN_UDS_CTRL_RESP* resp) {
+    (void)device_handle;
+    (void)dataType;
+    (void)ctrl;
+    (void)resp;
+    return STATUS_UNSUPPORTED;
+}
@@ -1,9 +1,36 @@
 #include <napi.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <string>
+#include <thread>
 #include <vector>
 #include <cstring>
 
 #include "zlgcan.h"
+#include "zlgcan_api.h"
+#include "device_gate.h"
+#include "channel_health.h"
+#include "pipeline_watchdog.h"
+#include "device_monitor.h"
+#include "channel_quiesce.h"
+#include "uds_client.h"
+#include "receive_pump.h"
+#include "isotp_engine.h"
+#include "j1939_engine.h"
+#include "xcp_master.h"
+#include "canopen_client.h"
+#include "rest_bus_engine.h"
+#include "e2e_protection.h"
+#include "flash_pipeline.h"
+#include "lin_receive_pump.h"
+#include "thread_scheduling.h"
 
 // 辅助函数：从Napi::Value获取通道句柄（支持BigInt和Number）
 inline CHANNEL_HANDLE GetChannelHandleFromValue(Napi::Env env, Napi::Value value) {
@@ -20,6 +47,145 @@ inline CHANNEL_HANDLE GetChannelHandleFromValue(Napi::Env env, Napi::Value value
     return nullptr;
 }
 
+// 辅助函数：从JS配置对象解析通道初始化参数
+inline void ParseChannelInitConfig(Napi::Object config, ZCAN_CHANNEL_INIT_CONFIG* initConfig) {
+    initConfig->can_type = config.Get("canType").As<Napi::Number>().Uint32Value();
+
+    if (initConfig->can_type == TYPE_CAN) {
+        // CAN模式
+        initConfig->can.acc_code = config.Has("accCode") ?
+            config.Get("accCode").As<Napi::Number>().Uint32Value() : 0;
+        initConfig->can.acc_mask = config.Has("accMask") ?
+            config.Get("accMask").As<Napi::Number>().Uint32Value() : 0xFFFFFFFF;
+        initConfig->can.reserved = config.Has("reserved") ?
+            config.Get("reserved").As<Napi::Number>().Uint32Value() : 0;
+        initConfig->can.filter = config.Has("filter") ?
+            static_cast<BYTE>(config.Get("filter").As<Napi::Number>().Uint32Value()) : 0;
+        initConfig->can.timing0 = config.Has("timing0") ?
+            static_cast<BYTE>(config.Get("timing0").As<Napi::Number>().Uint32Value()) : 0;
+        initConfig->can.timing1 = config.Has("timing1") ?
+            static_cast<BYTE>(config.Get("timing1").As<Napi::Number>().Uint32Value()) : 0x1C;
+        initConfig->can.mode = config.Has("mode") ?
+            static_cast<BYTE>(config.Get("mode").As<Napi::Number>().Uint32Value()) : 0;
+    } else {
+        // CANFD模式
+        initConfig->canfd.acc_code = config.Has("accCode") ?
+            config.Get("accCode").As<Napi::Number>().Uint32Value() : 0;
+        initConfig->canfd.acc_mask = config.Has("accMask") ?
+            config.Get("accMask").As<Napi::Number>().Uint32Value() : 0xFFFFFFFF;
+        initConfig->canfd.abit_timing = config.Has("abitTiming") ?
+            config.Get("abitTiming").As<Napi::Number>().Uint32Value() : 0;
+        initConfig->canfd.dbit_timing = config.Has("dbitTiming") ?
+            config.Get("dbitTiming").As<Napi::Number>().Uint32Value() : 0;
+        initConfig->canfd.brp = config.Has("brp") ?
+            config.Get("brp").As<Napi::Number>().Uint32Value() : 0;
+        initConfig->canfd.filter = config.Has("filter") ?
+            static_cast<BYTE>(config.Get("filter").As<Napi::Number>().Uint32Value()) : 0;
+        initConfig->canfd.mode = config.Has("mode") ?
+            static_cast<BYTE>(config.Get("mode").As<Napi::Number>().Uint32Value()) : 0;
+        initConfig->canfd.pad = config.Has("pad") ?
+            static_cast<USHORT>(config.Get("pad").As<Napi::Number>().Uint32Value()) : 0;
+        initConfig->canfd.reserved = config.Has("reserved") ?
+            config.Get("reserved").As<Napi::Number>().Uint32Value() : 0;
+    }
+}
+
+// 辅助函数：LIN数据转换为JS对象
+inline Napi::Object LinDataToObject(Napi::Env env, const ZCANLINData& lin) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("id", Napi::Number::New(env, lin.PID.unionVal.ID));
+    obj.Set("pid", Napi::Number::New(env, lin.PID.rawVal));
+    obj.Set("timestamp", Napi::Number::New(env, static_cast<double>(lin.RxData.timeStamp)));
+    obj.Set("dir", Napi::Number::New(env, lin.RxData.dir));
+    obj.Set("chkSum", Napi::Number::New(env, lin.RxData.chkSum));
+
+    const BYTE dataLen = std::min<BYTE>(lin.RxData.dataLen, sizeof(lin.RxData.data));
+    Napi::Array dataArr = Napi::Array::New(env, dataLen);
+    for (BYTE j = 0; j < dataLen; j++) {
+        dataArr[j] = Napi::Number::New(env, lin.RxData.data[j]);
+    }
+    obj.Set("data", dataArr);
+    return obj;
+}
+
+inline Napi::Object LinErrDataToObject(Napi::Env env, const ZCANLINErrData& err) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("id", Napi::Number::New(env, err.PID.unionVal.ID));
+    obj.Set("pid", Napi::Number::New(env, err.PID.rawVal));
+    obj.Set("timestamp", Napi::Number::New(env, static_cast<double>(err.timeStamp)));
+    obj.Set("dir", Napi::Number::New(env, err.dir));
+    obj.Set("chkSum", Napi::Number::New(env, err.chkSum));
+    obj.Set("errStage", Napi::Number::New(env, err.errData.errStage));
+    obj.Set("errReason", Napi::Number::New(env, err.errData.errReason));
+
+    const BYTE dataLen = std::min<BYTE>(err.dataLen, sizeof(err.data));
+    Napi::Array dataArr = Napi::Array::New(env, dataLen);
+    for (BYTE j = 0; j < dataLen; j++) {
+        dataArr[j] = Napi::Number::New(env, err.data[j]);
+    }
+    obj.Set("data", dataArr);
+    return obj;
+}
+
+inline Napi::Object LinEventToObject(Napi::Env env, const ZCANLINEventData& event) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("timestamp", Napi::Number::New(env, static_cast<double>(event.timeStamp)));
+    obj.Set("eventType", Napi::Number::New(env, event.type));
+    return obj;
+}
+
+// 辅助函数：ZCAN_ReceiveLIN收到的消息转换为JS对象，type区分数据、错误和事件
+inline Napi::Object LinMessageToObject(Napi::Env env, const ZCAN_LIN_MSG& msg) {
+    Napi::Object obj;
+    const char* type = "unknown";
+    switch (msg.dataType) {
+        case 0:
+            obj = LinDataToObject(env, msg.data.zcanLINData);
+            type = "data";
+            break;
+        case 1:
+            obj = LinErrDataToObject(env, msg.data.zcanLINErrData);
+            type = "error";
+            break;
+        case 2:
+            obj = LinEventToObject(env, msg.data.zcanLINEventData);
+            type = "event";
+            break;
+        default:
+            obj = Napi::Object::New(env);
+            break;
+    }
+    obj.Set("type", Napi::String::New(env, type));
+    obj.Set("chnl", Napi::Number::New(env, msg.chnl));
+    return obj;
+}
+
+// 异步阻塞调用的共享状态
+struct AsyncCallState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;     // 阻塞调用已返回
+    bool settled = false;  // Promise的结果已确定（完成或超时）
+};
+
+// 一次设备打开期间的状态，供超时后才返回的异步调用在工作线程上判断如何清理
+struct DeviceSession {
+    std::mutex mutex;
+    bool open = true;                        // 设备关闭前置为false，此后不再调用该设备的ZCAN_*
+    std::set<CHANNEL_HANDLE> trackedChannels;  // 已由JS侧接管且未复位的通道句柄
+};
+
+// 复位无人跟踪也无人关闭的通道；设备已关闭，或同一句柄已被之后的初始化接管时保持不动
+inline void ReleaseOrphanChannel(const std::shared_ptr<DeviceSession>& session, CHANNEL_HANDLE channelHandle) {
+    if (channelHandle == INVALID_CHANNEL_HANDLE || !session) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(session->mutex);
+    if (session->open && session->trackedChannels.count(channelHandle) == 0) {
+        ZcanResetCAN(channelHandle);
+    }
+}
+
 // ZlgCanDevice 类定义
 class ZlgCanDevice : public Napi::ObjectWrap<ZlgCanDevice> {
 public:
@@ -28,12 +194,28 @@ public:
     ~ZlgCanDevice();
 
 private:
+    // 接口调用统计（进程级，与实例无关）
+    static Napi::Value GetStats(const Napi::CallbackInfo& info);
+    static Napi::Value ResetStats(const Napi::CallbackInfo& info);
+
+    // 时间线记录（进程级）
+    static Napi::Value TraceStartMethod(const Napi::CallbackInfo& info);
+    static Napi::Value TraceStopMethod(const Napi::CallbackInfo& info);
+    static Napi::Value TraceDump(const Napi::CallbackInfo& info);
+
+    // 原生线程调度（进程级）
+    static Napi::Value SetThreadScheduling(const Napi::CallbackInfo& info);
+    static Napi::Value GetThreadScheduling(const Napi::CallbackInfo& info);
+    static Napi::Value ResetThreadLatency(const Napi::CallbackInfo& info);
+
     // 设备操作
     Napi::Value OpenDevice(const Napi::CallbackInfo& info);
     Napi::Value CloseDevice(const Napi::CallbackInfo& info);
     Napi::Value GetDeviceInfo(const Napi::CallbackInfo& info);
     Napi::Value GetDeviceInfoEx(const Napi::CallbackInfo& info);
     Napi::Value IsDeviceOnLine(const Napi::CallbackInfo& info);
+    Napi::Value OpenDeviceAsync(const Napi::CallbackInfo& info);
+    Napi::Value CloseDeviceAsync(const Napi::CallbackInfo& info);
 
     // CAN通道操作
     Napi::Value InitCanChannel(const Napi::CallbackInfo& info);
@@ -43,6 +225,9 @@ private:
     Napi::Value ReadChannelErrInfo(const Napi::CallbackInfo& info);
     Napi::Value ReadChannelStatus(const Napi::CallbackInfo& info);
     Napi::Value GetReceiveNum(const Napi::CallbackInfo& info);
+    Napi::Value InitCanChannelAsync(const Napi::CallbackInfo& info);
+    Napi::Value StartCanChannelAsync(const Napi::CallbackInfo& info);
+    Napi::Value QuiesceAsync(const Napi::CallbackInfo& info);
 
     // 数据收发
     Napi::Value Transmit(const Napi::CallbackInfo& info);
@@ -62,19 +247,248 @@ private:
     Napi::Value GetPropertyValue(const Napi::CallbackInfo& info);
     Napi::Value ReleaseIProperty(const Napi::CallbackInfo& info);
 
+    // 通道健康监视
+    Napi::Value StartHealthMonitor(const Napi::CallbackInfo& info);
+    Napi::Value StopHealthMonitor(const Napi::CallbackInfo& info);
+    Napi::Value GetHealthState(const Napi::CallbackInfo& info);
+
+    // 接收链路监视（事件循环延迟与缓冲积压）
+    Napi::Value StartPipelineWatchdog(const Napi::CallbackInfo& info);
+    Napi::Value StopPipelineWatchdog(const Napi::CallbackInfo& info);
+    Napi::Value GetPipelineHistory(const Napi::CallbackInfo& info);
+
+    // 设备热插拔监视
+    Napi::Value StartDeviceMonitor(const Napi::CallbackInfo& info);
+    Napi::Value StopDeviceMonitor(const Napi::CallbackInfo& info);
+    Napi::Value GetDeviceMonitorState(const Napi::CallbackInfo& info);
+
+    // UDS诊断
+    Napi::Value UdsRequestAsync(const Napi::CallbackInfo& info);
+    Napi::Value UdsCancel(const Napi::CallbackInfo& info);
+
+    // DoIP诊断
+    Napi::Value DoipRequestAsync(const Napi::CallbackInfo& info);
+    Napi::Value GetDoipConnections(const Napi::CallbackInfo& info);
+
+    // 接收线程
+    Napi::Value StartReceiveThread(const Napi::CallbackInfo& info);
+    Napi::Value StopReceiveThread(const Napi::CallbackInfo& info);
+    Napi::Value GetReceiveThreadStats(const Napi::CallbackInfo& info);
+    Napi::Value OpenReceiveStream(const Napi::CallbackInfo& info);
+    Napi::Value ReadReceiveStream(const Napi::CallbackInfo& info);
+    Napi::Value ArmReceiveStream(const Napi::CallbackInfo& info);
+    Napi::Value CloseReceiveStream(const Napi::CallbackInfo& info);
+
+    // ISO-TP传输层
+    Napi::Value IsoTpOpen(const Napi::CallbackInfo& info);
+    Napi::Value IsoTpClose(const Napi::CallbackInfo& info);
+    Napi::Value IsoTpSendAsync(const Napi::CallbackInfo& info);
+    Napi::Value IsoTpGetStats(const Napi::CallbackInfo& info);
+
+    // J1939传输协议
+    Napi::Value StartJ1939(const Napi::CallbackInfo& info);
+    Napi::Value StopJ1939(const Napi::CallbackInfo& info);
+    Napi::Value J1939SendAsync(const Napi::CallbackInfo& info);
+    Napi::Value GetJ1939Stats(const Napi::CallbackInfo& info);
+
+    // XCP测量
+    Napi::Value StartXcp(const Napi::CallbackInfo& info);
+    Napi::Value StopXcp(const Napi::CallbackInfo& info);
+    Napi::Value XcpConnectAsync(const Napi::CallbackInfo& info);
+    Napi::Value XcpDisconnectAsync(const Napi::CallbackInfo& info);
+    Napi::Value XcpShortUploadAsync(const Napi::CallbackInfo& info);
+    Napi::Value XcpDownloadAsync(const Napi::CallbackInfo& info);
+    Napi::Value XcpStartDaqAsync(const Napi::CallbackInfo& info);
+    Napi::Value XcpStopDaqAsync(const Napi::CallbackInfo& info);
+    Napi::Value GetXcpStats(const Napi::CallbackInfo& info);
+
+    // CANopen
+    Napi::Value StartCanOpen(const Napi::CallbackInfo& info);
+    Napi::Value StopCanOpen(const Napi::CallbackInfo& info);
+    Napi::Value CanOpenConfigurePdo(const Napi::CallbackInfo& info);
+    Napi::Value CanOpenSdoUploadAsync(const Napi::CallbackInfo& info);
+    Napi::Value CanOpenSdoDownloadAsync(const Napi::CallbackInfo& info);
+    Napi::Value CanOpenNmt(const Napi::CallbackInfo& info);
+    Napi::Value GetCanOpenStats(const Napi::CallbackInfo& info);
+
+    // E2E保护
+    Napi::Value SetE2eProtection(const Napi::CallbackInfo& info);
+    Napi::Value StartE2eCheck(const Napi::CallbackInfo& info);
+    Napi::Value StopE2eCheck(const Napi::CallbackInfo& info);
+    Napi::Value GetE2eStats(const Napi::CallbackInfo& info);
+
+    // 残余总线仿真
+    Napi::Value StartRestBus(const Napi::CallbackInfo& info);
+    Napi::Value StopRestBus(const Napi::CallbackInfo& info);
+    Napi::Value RestBusSetEnabled(const Napi::CallbackInfo& info);
+    Napi::Value GetRestBusStats(const Napi::CallbackInfo& info);
+
+    // 在线烧写
+    Napi::Value FlashAsync(const Napi::CallbackInfo& info);
+    Napi::Value FlashCancel(const Napi::CallbackInfo& info);
+
+    // LIN通道
+    Napi::Value InitLinChannel(const Napi::CallbackInfo& info);
+    Napi::Value StartLinChannel(const Napi::CallbackInfo& info);
+    Napi::Value ResetLinChannel(const Napi::CallbackInfo& info);
+    Napi::Value TransmitLin(const Napi::CallbackInfo& info);
+    Napi::Value ReceiveLin(const Napi::CallbackInfo& info);
+    Napi::Value GetLinReceiveNum(const Napi::CallbackInfo& info);
+    Napi::Value SetLinPublish(const Napi::CallbackInfo& info);
+    Napi::Value SetLinSubscribe(const Napi::CallbackInfo& info);
+    Napi::Value WakeUpLin(const Napi::CallbackInfo& info);
+    Napi::Value StartLinReceiveThread(const Napi::CallbackInfo& info);
+    Napi::Value StopLinReceiveThread(const Napi::CallbackInfo& info);
+    Napi::Value GetLinReceiveThreadStats(const Napi::CallbackInfo& info);
+
+    // LIN调度表
+    Napi::Value AddLinSchedule(const Napi::CallbackInfo& info);
+    Napi::Value StartLinSchedule(const Napi::CallbackInfo& info);
+    Napi::Value StopLinSchedule(const Napi::CallbackInfo& info);
+    Napi::Value ClearLinSchedules(const Napi::CallbackInfo& info);
+    Napi::Value SetLinScheduleEnabled(const Napi::CallbackInfo& info);
+    Napi::Value GetLinScheduleStatus(const Napi::CallbackInfo& info);
+
+    struct HealthMonitorEntry {
+        std::unique_ptr<ChannelHealthMonitor> monitor;
+        Napi::ThreadSafeFunction tsfn;
+    };
+
+    struct ReceiveChannelEntry {
+        std::unique_ptr<ReceivePump> pump;
+        std::shared_ptr<IsoTpEngine> isotp;  // 发送中的请求持有引擎，关闭通道后仍可安全返回
+        std::shared_ptr<J1939Engine> j1939;
+        Napi::ThreadSafeFunction j1939Tsfn;
+        std::shared_ptr<XcpMaster> xcp;
+        Napi::ThreadSafeFunction xcpTsfn;
+        std::shared_ptr<CanOpenClient> canopen;
+        Napi::ThreadSafeFunction canopenTsfn;
+        std::shared_ptr<E2eMonitor> e2e;
+        Napi::ThreadSafeFunction e2eTsfn;                // 未设置回调时为空
+        std::map<UINT, Napi::ThreadSafeFunction> streamTsfns;   // 帧流ID到其缓冲就绪通知
+    };
+
+    struct RestBusEntry {
+        std::unique_ptr<RestBusEngine> engine;
+        Napi::Reference<Napi::ArrayBuffer> table;    // 引擎线程读取的信号表，停止引擎后释放
+    };
+
+    struct IsoTpSessionEntry {
+        UINT channelIndex;
+        Napi::ThreadSafeFunction tsfn;
+    };
+
+    struct FlashJobEntry {
+        std::shared_ptr<FlashPipeline> pipeline;
+        std::shared_ptr<IsoTpEngine> engine;
+        UINT sessionId;
+    };
+
+    struct LinChannelEntry {
+        CHANNEL_HANDLE handle = INVALID_CHANNEL_HANDLE;
+        std::unique_ptr<LinReceivePump> pump;
+        Napi::ThreadSafeFunction tsfn;                   // 接收线程的批回调，未设置回调时为空
+        std::vector<ZCAN_LIN_SCHED_HANDLE> schedules;    // 已添加到通道的调度表，释放通道时销毁
+    };
+
+    template <typename Result>
+    Napi::Value RunBlockingAsync(Napi::Env env, const char* name, UINT timeoutMs,
+                                 std::function<Result()> call,
+                                 std::function<Napi::Value(Napi::Env, Result)> onComplete,
+                                 std::function<void(Result)> onOrphan);
+
+    void AttachDevice(DEVICE_HANDLE deviceHandle, UINT deviceType, UINT deviceIndex, UINT reserved);
+    DEVICE_HANDLE DetachDevice();
+    void CloseDeviceSession();
+    void OnChannelInitialized(UINT channelIndex, const ZCAN_CHANNEL_INIT_CONFIG& initConfig,
+                              CHANNEL_HANDLE channelHandle);
+    void OnChannelStarted(CHANNEL_HANDLE channelHandle);
+
+    bool FindChannelIndex(CHANNEL_HANDLE channelHandle, UINT* channelIndex) const;
+    CHANNEL_HANDLE ResolveChannelHandle(CHANNEL_HANDLE channelHandle) const;
+    CHANNEL_HANDLE ResolveLinHandle(CHANNEL_HANDLE channelHandle) const;
+    void StopHealthMonitorAt(UINT channelIndex);
+    void StopAllHealthMonitors();
+    void StopPipelineWatchdogThread();
+    // retiring为即将销毁的接收线程，不再提供给监视器
+    void RefreshPipelineSources(const ReceivePump* retiring = nullptr);
+    void StopDeviceMonitorThread();
+    void SwapDeviceHandles(const DeviceEvent& event);
+    void ApplyReconnect(const DeviceEvent& event);
+    ReceivePump* FindReceivePump(CHANNEL_HANDLE channelHandle);
+    UINT PopPumpedData(ZCANDataObj* dataObjs, UINT count);
+    ReceiveChannelEntry& EnsureReceiveChannel(UINT channelIndex, CHANNEL_HANDLE channelHandle,
+                                              const ReceivePumpOptions& options);
+    std::shared_ptr<IsoTpEngine> EnsureIsoTpEngine(UINT channelIndex, CHANNEL_HANDLE channelHandle);
+    void CloseIsoTpSession(UINT sessionId);
+    void StopJ1939Engine(ReceiveChannelEntry& entry);
+    void StopXcpMaster(ReceiveChannelEntry& entry);
+    std::shared_ptr<XcpMaster> FindXcpMaster(CHANNEL_HANDLE channelHandle);
+    void StopCanOpenClient(ReceiveChannelEntry& entry);
+    std::shared_ptr<CanOpenClient> FindCanOpenClient(CHANNEL_HANDLE channelHandle);
+    void StopE2eMonitor(ReceiveChannelEntry& entry);
+    void CloseReceiveStreams(ReceiveChannelEntry& entry);
+    void CancelFlashJob(UINT channelIndex);
+    void StopReceiveChannelAt(UINT channelIndex);
+    void StopAllReceiveChannels();
+    bool FindLinIndex(CHANNEL_HANDLE channelHandle, UINT* linIndex) const;
+    LinChannelEntry* FindLinChannel(CHANNEL_HANDLE channelHandle);
+    void StopLinReceivePump(LinChannelEntry& entry);
+    void DestroyLinSchedules(LinChannelEntry& entry);
+    void ReleaseAllLinChannels();
+    void StopRestBusAt(UINT channelIndex);
+    void StopAllRestBuses();
+
     DEVICE_HANDLE deviceHandle_;
     IProperty* pProperty_;
+    // 设备监视线程重连时遍历下列句柄表和线程对象并替换句柄；JS线程增删条目、写入句柄表和
+    // 读取句柄表时持有此锁。持锁期间不得停止线程或调用ZCAN_*（监视线程持有设备句柄闸门后才取锁）
+    mutable std::mutex handlesMutex_;
+    std::map<UINT, CHANNEL_HANDLE> channelHandles_;     // 通道索引 -> 当前句柄（InitCanChannel时记录）
+    std::map<CHANNEL_HANDLE, UINT> handleIndex_;        // 曾分配的句柄 -> 通道索引（重连后旧句柄仍可用）
+    std::map<CHANNEL_HANDLE, UINT> linHandleIndex_;     // 曾分配的LIN句柄 -> LIN通道索引
+    std::shared_ptr<DeviceSession> session_;            // 当前打开的设备会话，异步调用的超时清理共享
+    std::map<UINT, uint64_t> channelEpochs_;            // 通道索引 -> 初始化/复位代次，异步初始化据此丢弃过期结果
+    std::map<UINT, HealthMonitorEntry> healthMonitors_; // 通道索引 -> 健康监视器
+    std::unique_ptr<PipelineWatchdog> pipelineWatchdog_;
+    Napi::ThreadSafeFunction pipelineWatchdogTsfn_;     // 告警回调，同时承载事件循环探测
+    std::unique_ptr<DeviceMonitor> deviceMonitor_;      // 打开设备时创建，记录需要回放的操作
+    Napi::ThreadSafeFunction deviceMonitorTsfn_;
+    UdsClient udsClient_;
+    std::map<UINT, ReceiveChannelEntry> receiveChannels_; // 通道索引 -> 接收线程与协议引擎
+    std::map<UINT, IsoTpSessionEntry> isotpSessions_;     // 会话ID -> ISO-TP会话
+    UINT nextIsoTpSessionId_ = 1;
+    std::map<UINT, FlashJobEntry> flashJobs_;             // 通道索引 -> 进行中的烧写
+    std::map<UINT, LinChannelEntry> linChannels_;         // LIN通道索引 -> 句柄、接收线程与调度表
+    std::map<UINT, RestBusEntry> restBuses_;              // 通道索引 -> 残余总线仿真引擎
+    std::map<UINT, E2eTransmitProtector> e2eProtectors_;  // 通道索引 -> transmit/transmitFD的E2E保护
 };
 
 // 类初始化
 Napi::Object ZlgCanDevice::Init(Napi::Env env, Napi::Object exports) {
     Napi::Function func = DefineClass(env, "ZlgCanDevice", {
+        // 接口调用统计
+        StaticMethod("getStats", &ZlgCanDevice::GetStats),
+        StaticMethod("resetStats", &ZlgCanDevice::ResetStats),
+
+        // 时间线记录
+        StaticMethod("traceStart", &ZlgCanDevice::TraceStartMethod),
+        StaticMethod("traceStop", &ZlgCanDevice::TraceStopMethod),
+        StaticMethod("traceDump", &ZlgCanDevice::TraceDump),
+
+        // 原生线程调度
+        StaticMethod("setThreadScheduling", &ZlgCanDevice::SetThreadScheduling),
+        StaticMethod("getThreadScheduling", &ZlgCanDevice::GetThreadScheduling),
+        StaticMethod("resetThreadLatency", &ZlgCanDevice::ResetThreadLatency),
+
         // 设备操作
         InstanceMethod("openDevice", &ZlgCanDevice::OpenDevice),
         InstanceMethod("closeDevice", &ZlgCanDevice::CloseDevice),
         InstanceMethod("getDeviceInfo", &ZlgCanDevice::GetDeviceInfo),
         InstanceMethod("getDeviceInfoEx", &ZlgCanDevice::GetDeviceInfoEx),
         InstanceMethod("isDeviceOnLine", &ZlgCanDevice::IsDeviceOnLine),
+        InstanceMethod("openDeviceAsync", &ZlgCanDevice::OpenDeviceAsync),
+        InstanceMethod("closeDeviceAsync", &ZlgCanDevice::CloseDeviceAsync),
 
         // CAN通道操作
         InstanceMethod("initCanChannel", &ZlgCanDevice::InitCanChannel),
@@ -84,6 +498,9 @@ Napi::Object ZlgCanDevice::Init(Napi::Env env, Napi::Object exports) {
         InstanceMethod("readChannelErrInfo", &ZlgCanDevice::ReadChannelErrInfo),
         InstanceMethod("readChannelStatus", &ZlgCanDevice::ReadChannelStatus),
         InstanceMethod("getReceiveNum", &ZlgCanDevice::GetReceiveNum),
+        InstanceMethod("initCanChannelAsync", &ZlgCanDevice::InitCanChannelAsync),
+        InstanceMethod("startCanChannelAsync", &ZlgCanDevice::StartCanChannelAsync),
+        InstanceMethod("quiesceAsync", &ZlgCanDevice::QuiesceAsync),
 
         // 数据收发
         InstanceMethod("transmit", &ZlgCanDevice::Transmit),
@@ -102,6 +519,102 @@ Napi::Object ZlgCanDevice::Init(Napi::Env env, Napi::Object exports) {
         InstanceMethod("setPropertyValue", &ZlgCanDevice::SetPropertyValue),
         InstanceMethod("getPropertyValue", &ZlgCanDevice::GetPropertyValue),
         InstanceMethod("releaseIProperty", &ZlgCanDevice::ReleaseIProperty),
+
+        // 通道健康监视
+        InstanceMethod("startHealthMonitor", &ZlgCanDevice::StartHealthMonitor),
+        InstanceMethod("stopHealthMonitor", &ZlgCanDevice::StopHealthMonitor),
+        InstanceMethod("getHealthState", &ZlgCanDevice::GetHealthState),
+
+        // 接收链路监视
+        InstanceMethod("startPipelineWatchdog", &ZlgCanDevice::StartPipelineWatchdog),
+        InstanceMethod("stopPipelineWatchdog", &ZlgCanDevice::StopPipelineWatchdog),
+        InstanceMethod("getPipelineHistory", &ZlgCanDevice::GetPipelineHistory),
+
+        // 设备热插拔监视
+        InstanceMethod("startDeviceMonitor", &ZlgCanDevice::StartDeviceMonitor),
+        InstanceMethod("stopDeviceMonitor", &ZlgCanDevice::StopDeviceMonitor),
+        InstanceMethod("getDeviceMonitorState", &ZlgCanDevice::GetDeviceMonitorState),
+
+        // UDS诊断
+        InstanceMethod("udsRequestAsync", &ZlgCanDevice::UdsRequestAsync),
+        InstanceMethod("udsCancel", &ZlgCanDevice::UdsCancel),
+
+        // DoIP诊断
+        InstanceMethod("doipRequestAsync", &ZlgCanDevice::DoipRequestAsync),
+        InstanceMethod("getDoipConnections", &ZlgCanDevice::GetDoipConnections),
+
+        // 接收线程
+        InstanceMethod("startReceiveThread", &ZlgCanDevice::StartReceiveThread),
+        InstanceMethod("stopReceiveThread", &ZlgCanDevice::StopReceiveThread),
+        InstanceMethod("getReceiveThreadStats", &ZlgCanDevice::GetReceiveThreadStats),
+        InstanceMethod("openReceiveStream", &ZlgCanDevice::OpenReceiveStream),
+        InstanceMethod("readReceiveStream", &ZlgCanDevice::ReadReceiveStream),
+        InstanceMethod("armReceiveStream", &ZlgCanDevice::ArmReceiveStream),
+        InstanceMethod("closeReceiveStream", &ZlgCanDevice::CloseReceiveStream),
+
+        // ISO-TP传输层
+        InstanceMethod("isotpOpen", &ZlgCanDevice::IsoTpOpen),
+        InstanceMethod("isotpClose", &ZlgCanDevice::IsoTpClose),
+        InstanceMethod("isotpSendAsync", &ZlgCanDevice::IsoTpSendAsync),
+        InstanceMethod("isotpGetStats", &ZlgCanDevice::IsoTpGetStats),
+        InstanceMethod("startJ1939", &ZlgCanDevice::StartJ1939),
+        InstanceMethod("stopJ1939", &ZlgCanDevice::StopJ1939),
+        InstanceMethod("j1939SendAsync", &ZlgCanDevice::J1939SendAsync),
+        InstanceMethod("getJ1939Stats", &ZlgCanDevice::GetJ1939Stats),
+        InstanceMethod("startXcp", &ZlgCanDevice::StartXcp),
+        InstanceMethod("stopXcp", &ZlgCanDevice::StopXcp),
+        InstanceMethod("xcpConnectAsync", &ZlgCanDevice::XcpConnectAsync),
+        InstanceMethod("xcpDisconnectAsync", &ZlgCanDevice::XcpDisconnectAsync),
+        InstanceMethod("xcpShortUploadAsync", &ZlgCanDevice::XcpShortUploadAsync),
+        InstanceMethod("xcpDownloadAsync", &ZlgCanDevice::XcpDownloadAsync),
+        InstanceMethod("xcpStartDaqAsync", &ZlgCanDevice::XcpStartDaqAsync),
+        InstanceMethod("xcpStopDaqAsync", &ZlgCanDevice::XcpStopDaqAsync),
+        InstanceMethod("getXcpStats", &ZlgCanDevice::GetXcpStats),
+        InstanceMethod("startCanOpen", &ZlgCanDevice::StartCanOpen),
+        InstanceMethod("stopCanOpen", &ZlgCanDevice::StopCanOpen),
+        InstanceMethod("canopenConfigurePdo", &ZlgCanDevice::CanOpenConfigurePdo),
+        InstanceMethod("canopenSdoUploadAsync", &ZlgCanDevice::CanOpenSdoUploadAsync),
+        InstanceMethod("canopenSdoDownloadAsync", &ZlgCanDevice::CanOpenSdoDownloadAsync),
+        InstanceMethod("canopenNmt", &ZlgCanDevice::CanOpenNmt),
+        InstanceMethod("getCanOpenStats", &ZlgCanDevice::GetCanOpenStats),
+
+        // E2E保护
+        InstanceMethod("setE2eProtection", &ZlgCanDevice::SetE2eProtection),
+        InstanceMethod("startE2eCheck", &ZlgCanDevice::StartE2eCheck),
+        InstanceMethod("stopE2eCheck", &ZlgCanDevice::StopE2eCheck),
+        InstanceMethod("getE2eStats", &ZlgCanDevice::GetE2eStats),
+
+        // 残余总线仿真
+        InstanceMethod("startRestBus", &ZlgCanDevice::StartRestBus),
+        InstanceMethod("stopRestBus", &ZlgCanDevice::StopRestBus),
+        InstanceMethod("restBusSetEnabled", &ZlgCanDevice::RestBusSetEnabled),
+        InstanceMethod("getRestBusStats", &ZlgCanDevice::GetRestBusStats),
+
+        // 在线烧写
+        InstanceMethod("flashAsync", &ZlgCanDevice::FlashAsync),
+        InstanceMethod("flashCancel", &ZlgCanDevice::FlashCancel),
+
+        // LIN通道
+        InstanceMethod("initLinChannel", &ZlgCanDevice::InitLinChannel),
+        InstanceMethod("startLinChannel", &ZlgCanDevice::StartLinChannel),
+        InstanceMethod("resetLinChannel", &ZlgCanDevice::ResetLinChannel),
+        InstanceMethod("transmitLin", &ZlgCanDevice::TransmitLin),
+        InstanceMethod("receiveLin", &ZlgCanDevice::ReceiveLin),
+        InstanceMethod("getLinReceiveNum", &ZlgCanDevice::GetLinReceiveNum),
+        InstanceMethod("setLinPublish", &ZlgCanDevice::SetLinPublish),
+        InstanceMethod("setLinSubscribe", &ZlgCanDevice::SetLinSubscribe),
+        InstanceMethod("wakeUpLin", &ZlgCanDevice::WakeUpLin),
+        InstanceMethod("startLinReceiveThread", &ZlgCanDevice::StartLinReceiveThread),
+        InstanceMethod("stopLinReceiveThread", &ZlgCanDevice::StopLinReceiveThread),
+        InstanceMethod("getLinReceiveThreadStats", &ZlgCanDevice::GetLinReceiveThreadStats),
+
+        // LIN调度表
+        InstanceMethod("addLinSchedule", &ZlgCanDevice::AddLinSchedule),
+        InstanceMethod("startLinSchedule", &ZlgCanDevice::StartLinSchedule),
+        InstanceMethod("stopLinSchedule", &ZlgCanDevice::StopLinSchedule),
+        InstanceMethod("clearLinSchedules", &ZlgCanDevice::ClearLinSchedules),
+        InstanceMethod("setLinScheduleEnabled", &ZlgCanDevice::SetLinScheduleEnabled),
+        InstanceMethod("getLinScheduleStatus", &ZlgCanDevice::GetLinScheduleStatus),
     });
 
     Napi::FunctionReference* constructor = new Napi::FunctionReference();
@@ -117,12 +630,28 @@ ZlgCanDevice::ZlgCanDevice(const Napi::CallbackInfo& info)
 }
 
 ZlgCanDevice::~ZlgCanDevice() {
+    StopPipelineWatchdogThread();
+    StopAllRestBuses();
+    StopAllReceiveChannels();
+    ReleaseAllLinChannels();
+    StopAllHealthMonitors();
+    if (deviceMonitor_) {
+        deviceMonitor_->Stop();
+        deviceHandle_ = deviceMonitor_->Handle();
+        deviceMonitor_.reset();
+    }
+    if (deviceMonitorTsfn_) {
+        // 队列中尚未投递的事件引用本对象，销毁时丢弃
+        deviceMonitorTsfn_.Abort();
+    }
     if (pProperty_ != nullptr) {
-        ::ReleaseIProperty(pProperty_);
+        ZcanReleaseIProperty(pProperty_);
+        std::lock_guard<std::mutex> lock(handlesMutex_);
         pProperty_ = nullptr;
     }
+    CloseDeviceSession();
     if (deviceHandle_ != INVALID_DEVICE_HANDLE) {
-        ZCAN_CloseDevice(deviceHandle_);
+        ZcanCloseDevice(deviceHandle_);
         deviceHandle_ = INVALID_DEVICE_HANDLE;
     }
 }
@@ -141,7 +670,7 @@ Napi::Value ZlgCanDevice::OpenDevice(const Napi::CallbackInfo& info) {
     UINT deviceIndex = info[1].As<Napi::Number>().Uint32Value();
     UINT reserved = info.Length() > 2 ? info[2].As<Napi::Number>().Uint32Value() : 0;
 
-    deviceHandle_ = ZCAN_OpenDevice(deviceType, deviceIndex, reserved);
+    AttachDevice(ZcanOpenDevice(deviceType, deviceIndex, reserved), deviceType, deviceIndex, reserved);
 
     return Napi::Boolean::New(env, deviceHandle_ != INVALID_DEVICE_HANDLE);
 }
@@ -149,19 +678,77 @@ Napi::Value ZlgCanDevice::OpenDevice(const Napi::CallbackInfo& info) {
 Napi::Value ZlgCanDevice::CloseDevice(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
+    DEVICE_HANDLE deviceHandle = DetachDevice();
+    if (deviceHandle == INVALID_DEVICE_HANDLE) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    UINT result = ZcanCloseDevice(deviceHandle);
+    return Napi::Boolean::New(env, result == STATUS_OK);
+}
+
+void ZlgCanDevice::AttachDevice(DEVICE_HANDLE deviceHandle, UINT deviceType, UINT deviceIndex, UINT reserved) {
+    StopDeviceMonitorThread();
+    deviceMonitor_.reset();
+
+    deviceHandle_ = deviceHandle;
+    CloseDeviceSession();
+    if (deviceHandle_ != INVALID_DEVICE_HANDLE) {
+        session_ = std::make_shared<DeviceSession>();
+        deviceMonitor_.reset(new DeviceMonitor(deviceType, deviceIndex, reserved, deviceHandle_));
+    }
+}
+
+DEVICE_HANDLE ZlgCanDevice::DetachDevice() {
+    // 执行中的诊断请求在设备关闭前停止
+    if (deviceHandle_ != INVALID_DEVICE_HANDLE) {
+        udsClient_.CancelAll(deviceHandle_);
+        udsClient_.ResetDoipConnections();
+    }
+
+    // 监视线程和接收线程会访问设备和通道句柄，必须先于设备关闭停止
+    StopPipelineWatchdogThread();
+    StopAllRestBuses();
+    StopAllReceiveChannels();
+    ReleaseAllLinChannels();
+    StopAllHealthMonitors();
+    StopDeviceMonitorThread();
+    if (deviceMonitor_) {
+        // 离线期间监视线程已关闭旧句柄；重连后以监视器持有的句柄为准
+        deviceHandle_ = deviceMonitor_->Handle();
+        deviceMonitor_.reset();
+    }
+    {
+        std::lock_guard<std::mutex> lock(handlesMutex_);
+        channelHandles_.clear();
+        handleIndex_.clear();
+        linHandleIndex_.clear();
+    }
+    e2eProtectors_.clear();
+
     if (pProperty_ != nullptr) {
-        ::ReleaseIProperty(pProperty_);
+        ZcanReleaseIProperty(pProperty_);
+        std::lock_guard<std::mutex> lock(handlesMutex_);
         pProperty_ = nullptr;
     }
 
-    if (deviceHandle_ == INVALID_DEVICE_HANDLE) {
-        return Napi::Boolean::New(env, false);
-    }
+    CloseDeviceSession();
 
-    UINT result = ZCAN_CloseDevice(deviceHandle_);
+    DEVICE_HANDLE deviceHandle = deviceHandle_;
     deviceHandle_ = INVALID_DEVICE_HANDLE;
+    return deviceHandle;
+}
 
-    return Napi::Boolean::New(env, result == STATUS_OK);
+void ZlgCanDevice::CloseDeviceSession() {
+    if (!session_) {
+        return;
+    }
+    // 超时后仍在运行的工作线程可能正在清理孤立通道，等其完成后再关闭设备
+    {
+        std::lock_guard<std::mutex> lock(session_->mutex);
+        session_->open = false;
+    }
+    session_.reset();
 }
 
 Napi::Value ZlgCanDevice::GetDeviceInfo(const Napi::CallbackInfo& info) {
@@ -175,7 +762,7 @@ Napi::Value ZlgCanDevice::GetDeviceInfo(const Napi::CallbackInfo& info) {
     ZCAN_DEVICE_INFO deviceInfo;
     memset(&deviceInfo, 0, sizeof(deviceInfo));
 
-    UINT result = ZCAN_GetDeviceInf(deviceHandle_, &deviceInfo);
+    UINT result = ZcanGetDeviceInf(deviceHandle_, &deviceInfo);
     if (result != STATUS_OK) {
         return env.Null();
     }
@@ -204,7 +791,7 @@ Napi::Value ZlgCanDevice::GetDeviceInfoEx(const Napi::CallbackInfo& info) {
     ZCAN_DEVICE_INFO_EX deviceInfoEx;
     memset(&deviceInfoEx, 0, sizeof(deviceInfoEx));
 
-    UINT result = ZCAN_GetDeviceInfoEx(deviceHandle_, &deviceInfoEx);
+    UINT result = ZcanGetDeviceInfoEx(deviceHandle_, &deviceInfoEx);
     if (result != STATUS_OK) {
         return env.Null();
     }
@@ -255,7 +842,7 @@ Napi::Value ZlgCanDevice::IsDeviceOnLine(const Napi::CallbackInfo& info) {
         return Napi::Boolean::New(env, false);
     }
 
-    UINT result = ZCAN_IsDeviceOnLine(deviceHandle_);
+    UINT result = ZcanIsDeviceOnLine(deviceHandle_);
     return Napi::Boolean::New(env, result == STATUS_ONLINE);
 }
 
@@ -280,47 +867,11 @@ Napi::Value ZlgCanDevice::InitCanChannel(const Napi::CallbackInfo& info) {
     ZCAN_CHANNEL_INIT_CONFIG initConfig;
     memset(&initConfig, 0, sizeof(initConfig));
 
-    initConfig.can_type = config.Get("canType").As<Napi::Number>().Uint32Value();
-
-    if (initConfig.can_type == TYPE_CAN) {
-        // CAN模式
-        initConfig.can.acc_code = config.Has("accCode") ?
-            config.Get("accCode").As<Napi::Number>().Uint32Value() : 0;
-        initConfig.can.acc_mask = config.Has("accMask") ?
-            config.Get("accMask").As<Napi::Number>().Uint32Value() : 0xFFFFFFFF;
-        initConfig.can.reserved = config.Has("reserved") ?
-            config.Get("reserved").As<Napi::Number>().Uint32Value() : 0;
-        initConfig.can.filter = config.Has("filter") ?
-            static_cast<BYTE>(config.Get("filter").As<Napi::Number>().Uint32Value()) : 0;
-        initConfig.can.timing0 = config.Has("timing0") ?
-            static_cast<BYTE>(config.Get("timing0").As<Napi::Number>().Uint32Value()) : 0;
-        initConfig.can.timing1 = config.Has("timing1") ?
-            static_cast<BYTE>(config.Get("timing1").As<Napi::Number>().Uint32Value()) : 0x1C;
-        initConfig.can.mode = config.Has("mode") ?
-            static_cast<BYTE>(config.Get("mode").As<Napi::Number>().Uint32Value()) : 0;
-    } else {
-        // CANFD模式
-        initConfig.canfd.acc_code = config.Has("accCode") ?
-            config.Get("accCode").As<Napi::Number>().Uint32Value() : 0;
-        initConfig.canfd.acc_mask = config.Has("accMask") ?
-            config.Get("accMask").As<Napi::Number>().Uint32Value() : 0xFFFFFFFF;
-        initConfig.canfd.abit_timing = config.Has("abitTiming") ?
-            config.Get("abitTiming").As<Napi::Number>().Uint32Value() : 0;
-        initConfig.canfd.dbit_timing = config.Has("dbitTiming") ?
-            config.Get("dbitTiming").As<Napi::Number>().Uint32Value() : 0;
-        initConfig.canfd.brp = config.Has("brp") ?
-            config.Get("brp").As<Napi::Number>().Uint32Value() : 0;
-        initConfig.canfd.filter = config.Has("filter") ?
-            static_cast<BYTE>(config.Get("filter").As<Napi::Number>().Uint32Value()) : 0;
-        initConfig.canfd.mode = config.Has("mode") ?
-            static_cast<BYTE>(config.Get("mode").As<Napi::Number>().Uint32Value()) : 0;
-        initConfig.canfd.pad = config.Has("pad") ?
-            static_cast<USHORT>(config.Get("pad").As<Napi::Number>().Uint32Value()) : 0;
-        initConfig.canfd.reserved = config.Has("reserved") ?
-            config.Get("reserved").As<Napi::Number>().Uint32Value() : 0;
-    }
+    ParseChannelInitConfig(config, &initConfig);
 
-    CHANNEL_HANDLE channelHandle = ZCAN_InitCAN(deviceHandle_, channelIndex, &initConfig);
+    channelEpochs_[channelIndex]++;
+    CHANNEL_HANDLE channelHandle = ZcanInitCAN(deviceHandle_, channelIndex, &initConfig);
+    OnChannelInitialized(channelIndex, initConfig, channelHandle);
 
     // 返回通道句柄(使用BigInt确保64位指针精度)
     return Napi::BigInt::New(env, reinterpret_cast<uint64_t>(channelHandle));
@@ -334,10 +885,13 @@ Napi::Value ZlgCanDevice::StartCanChannel(const Napi::CallbackInfo& info) {
         return env.Null();
     }
 
-    CHANNEL_HANDLE channelHandle = GetChannelHandleFromValue(env, info[0]);
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
     if (env.IsExceptionPending()) return env.Null();
 
-    UINT result = ZCAN_StartCAN(channelHandle);
+    UINT result = ZcanStartCAN(channelHandle);
+    if (result == STATUS_OK) {
+        OnChannelStarted(channelHandle);
+    }
     return Napi::Boolean::New(env, result == STATUS_OK);
 }
 
@@ -349,10 +903,22 @@ Napi::Value ZlgCanDevice::ResetCanChannel(const Napi::CallbackInfo& info) {
         return env.Null();
     }
 
-    CHANNEL_HANDLE channelHandle = GetChannelHandleFromValue(env, info[0]);
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
     if (env.IsExceptionPending()) return env.Null();
 
-    UINT result = ZCAN_ResetCAN(channelHandle);
+    UINT result = ZcanResetCAN(channelHandle);
+    UINT channelIndex = 0;
+    if (FindChannelIndex(channelHandle, &channelIndex)) {
+        // 复位前发起、尚未完成的异步初始化不再接管该通道，其完成后按孤立通道复位
+        channelEpochs_[channelIndex]++;
+        if (result == STATUS_OK && session_) {
+            std::lock_guard<std::mutex> lock(session_->mutex);
+            session_->trackedChannels.erase(channelHandle);
+        }
+        if (result == STATUS_OK && deviceMonitor_) {
+            deviceMonitor_->RecordResetCan(channelIndex);
+        }
+    }
     return Napi::Boolean::New(env, result == STATUS_OK);
 }
 
@@ -364,10 +930,13 @@ Napi::Value ZlgCanDevice::ClearBuffer(const Napi::CallbackInfo& info) {
         return env.Null();
     }
 
-    CHANNEL_HANDLE channelHandle = GetChannelHandleFromValue(env, info[0]);
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
     if (env.IsExceptionPending()) return env.Null();
 
-    UINT result = ZCAN_ClearBuffer(channelHandle);
+    UINT result = ZcanClearBuffer(channelHandle);
+    if (ReceivePump* pump = FindReceivePump(channelHandle)) {
+        pump->ClearRing();
+    }
     return Napi::Boolean::New(env, result == STATUS_OK);
 }
 
@@ -379,13 +948,18 @@ Napi::Value ZlgCanDevice::ReadChannelErrInfo(const Napi::CallbackInfo& info) {
         return env.Null();
     }
 
-    CHANNEL_HANDLE channelHandle = GetChannelHandleFromValue(env, info[0]);
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
     if (env.IsExceptionPending()) return env.Null();
 
     ZCAN_CHANNEL_ERR_INFO errInfo;
     memset(&errInfo, 0, sizeof(errInfo));
 
-    UINT result = ZCAN_ReadChannelErrInfo(channelHandle, &errInfo);
+    // 驱动读取即清除错误信息，健康监视运行时经监视器读取，合并其采样时读走的错误
+    UINT channelIndex = 0;
+    auto monitor = FindChannelIndex(channelHandle, &channelIndex) ? healthMonitors_.find(channelIndex)
+                                                                  : healthMonitors_.end();
+    UINT result = monitor != healthMonitors_.end() ? monitor->second.monitor->ReadErrInfo(&errInfo)
+                                                   : ZcanReadChannelErrInfo(channelHandle, &errInfo);
     if (result != STATUS_OK) {
         return env.Null();
     }
@@ -411,13 +985,13 @@ Napi::Value ZlgCanDevice::ReadChannelStatus(const Napi::CallbackInfo& info) {
         return env.Null();
     }
 
-    CHANNEL_HANDLE channelHandle = GetChannelHandleFromValue(env, info[0]);
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
     if (env.IsExceptionPending()) return env.Null();
 
     ZCAN_CHANNEL_STATUS status;
     memset(&status, 0, sizeof(status));
 
-    UINT result = ZCAN_ReadChannelStatus(channelHandle, &status);
+    UINT result = ZcanReadChannelStatus(channelHandle, &status);
     if (result != STATUS_OK) {
         return env.Null();
     }
@@ -443,13 +1017,21 @@ Napi::Value ZlgCanDevice::GetReceiveNum(const Napi::CallbackInfo& info) {
         return env.Null();
     }
 
-    CHANNEL_HANDLE channelHandle = GetChannelHandleFromValue(env, info[0]);
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
     if (env.IsExceptionPending()) return env.Null();
 
     BYTE type = info.Length() > 1 ?
         static_cast<BYTE>(info[1].As<Napi::Number>().Uint32Value()) : TYPE_CAN;
 
-    UINT count = ZCAN_GetReceiveNum(channelHandle, type);
+    // 接收线程运行时驱动缓冲区随时被取空，返回尚未取出的帧数
+    if (ReceivePump* pump = FindReceivePump(channelHandle)) {
+        ReceivePumpStats stats = pump->Stats();
+        size_t pending = type == TYPE_CAN ? stats.canRingDepth :
+                         type == TYPE_CANFD ? stats.fdRingDepth : stats.canRingDepth + stats.fdRingDepth;
+        return Napi::Number::New(env, static_cast<double>(pending));
+    }
+
+    UINT count = ZcanGetReceiveNum(channelHandle, type);
     return Napi::Number::New(env, count);
 }
 
@@ -463,9 +1045,10 @@ Napi::Value ZlgCanDevice::Transmit(const Napi::CallbackInfo& info) {
         return env.Null();
     }
 
-    CHANNEL_HANDLE channelHandle = GetChannelHandleFromValue(env, info[0]);
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
     if (env.IsExceptionPending()) return env.Null();
 
+    ApiScope scope(ApiId::JsTransmit);
     std::vector<ZCAN_Transmit_Data> frames;
 
     if (info[1].IsArray()) {
@@ -505,10 +1088,90 @@ Napi::Value ZlgCanDevice::Transmit(const Napi::CallbackInfo& info) {
         }
     }
 
-    UINT sentCount = ZCAN_Transmit(channelHandle, frames.data(), static_cast<UINT>(frames.size()));
+    UINT channelIndex = 0;
+    auto protector = FindChannelIndex(channelHandle, &channelIndex) ? e2eProtectors_.find(channelIndex) : e2eProtectors_.end();
+    if (protector != e2eProtectors_.end()) {
+        for (ZCAN_Transmit_Data& frame : frames) {
+            protector->second.Apply(frame.frame.can_id, frame.frame.data, std::min<BYTE>(frame.frame.can_dlc, CAN_MAX_DLEN));
+        }
+    }
+
+    UINT sentCount = ZcanTransmit(channelHandle, frames.data(), static_cast<UINT>(frames.size()));
+    scope.SetFrames(sentCount, sizeof(ZCAN_Transmit_Data));
+    scope.SetError(sentCount < frames.size());
     return Napi::Number::New(env, sentCount);
 }
 
+namespace {
+
+// 接收线程运行时receiveData单次等待的上限：驱动直接读取的错误、LIN等数据没有通知，按此间隔补查
+constexpr auto RECEIVE_DATA_WAIT_SLICE = std::chrono::milliseconds(5);
+// 接收线程运行时receiveData在JS线程中的最长等待，waitTime小于0时使用
+constexpr int RECEIVE_DATA_MAX_WAIT_MS = 1000;
+
+// 合并接收记录的设备时间戳；GPS数据没有微秒时间戳，返回fallback
+uint64_t DataObjTimestamp(const ZCANDataObj& obj, uint64_t fallback) {
+    switch (obj.dataType) {
+    case ZCAN_DT_ZCAN_CAN_CANFD_DATA: return obj.data.zcanCANFDData.timeStamp;
+    case ZCAN_DT_ZCAN_ERROR_DATA: return obj.data.zcanErrData.timeStamp;
+    case ZCAN_DT_ZCAN_LIN_DATA: return obj.data.zcanLINData.RxData.timeStamp;
+    case ZCAN_DT_ZCAN_BUSUSAGE_DATA: return obj.data.busUsage.nTimeStampEnd;
+    case ZCAN_DT_ZCAN_LIN_ERROR_DATA: return obj.data.zcanLINErrData.timeStamp;
+    case ZCAN_DT_ZCAN_LIN_EX_DATA: return obj.data.zcanLINExData.RxData.timeStamp;
+    case ZCAN_DT_ZCAN_LIN_EVENT_DATA: return obj.data.zcanLINEventData.timeStamp;
+    default: return fallback;
+    }
+}
+
+// 按设备时间戳稳定排序，没有时间戳的记录沿用前一条的时间戳，保持在原位置之后
+void SortDataObjsByTimestamp(ZCANDataObj* objs, UINT count) {
+    std::vector<std::pair<uint64_t, UINT>> keys(count);
+    uint64_t previous = 0;
+    for (UINT i = 0; i < count; i++) {
+        previous = DataObjTimestamp(objs[i], previous);
+        keys[i] = {previous, i};
+    }
+    std::stable_sort(keys.begin(), keys.end(), [](const std::pair<uint64_t, UINT>& a, const std::pair<uint64_t, UINT>& b) {
+        return a.first < b.first;
+    });
+    std::vector<ZCANDataObj> sorted(count);
+    for (UINT i = 0; i < count; i++) {
+        sorted[i] = objs[keys[i].second];
+    }
+    std::copy(sorted.begin(), sorted.end(), objs);
+}
+
+Napi::Object ReceivedCanToObject(Napi::Env env, const ZCAN_Receive_Data& frame) {
+    Napi::Object frameObj = Napi::Object::New(env);
+    frameObj.Set("id", Napi::Number::New(env, frame.frame.can_id));
+    frameObj.Set("dlc", Napi::Number::New(env, frame.frame.can_dlc));
+    frameObj.Set("timestamp", Napi::Number::New(env, static_cast<double>(frame.timestamp)));
+
+    Napi::Array dataArr = Napi::Array::New(env, frame.frame.can_dlc);
+    for (BYTE j = 0; j < frame.frame.can_dlc; j++) {
+        dataArr[j] = Napi::Number::New(env, frame.frame.data[j]);
+    }
+    frameObj.Set("data", dataArr);
+    return frameObj;
+}
+
+Napi::Object ReceivedFdToObject(Napi::Env env, const ZCAN_ReceiveFD_Data& frame) {
+    Napi::Object frameObj = Napi::Object::New(env);
+    frameObj.Set("id", Napi::Number::New(env, frame.frame.can_id));
+    frameObj.Set("len", Napi::Number::New(env, frame.frame.len));
+    frameObj.Set("flags", Napi::Number::New(env, frame.frame.flags));
+    frameObj.Set("timestamp", Napi::Number::New(env, static_cast<double>(frame.timestamp)));
+
+    Napi::Array dataArr = Napi::Array::New(env, frame.frame.len);
+    for (BYTE j = 0; j < frame.frame.len; j++) {
+        dataArr[j] = Napi::Number::New(env, frame.frame.data[j]);
+    }
+    frameObj.Set("data", dataArr);
+    return frameObj;
+}
+
+}  // namespace
+
 Napi::Value ZlgCanDevice::Receive(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
@@ -517,29 +1180,22 @@ Napi::Value ZlgCanDevice::Receive(const Napi::CallbackInfo& info) {
         return env.Null();
     }
 
-    CHANNEL_HANDLE channelHandle = GetChannelHandleFromValue(env, info[0]);
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
     if (env.IsExceptionPending()) return env.Null();
 
     UINT count = info[1].As<Napi::Number>().Uint32Value();
     int waitTime = info.Length() > 2 ? info[2].As<Napi::Number>().Int32Value() : -1;
 
+    ApiScope scope(ApiId::JsReceive);
     std::vector<ZCAN_Receive_Data> frames(count);
-    UINT receivedCount = ZCAN_Receive(channelHandle, frames.data(), count, waitTime);
+    ReceivePump* pump = FindReceivePump(channelHandle);
+    UINT receivedCount = pump ? pump->PopCan(frames.data(), count, waitTime)
+                              : ZcanReceive(channelHandle, frames.data(), count, waitTime);
+    scope.SetFrames(receivedCount, sizeof(ZCAN_Receive_Data));
 
     Napi::Array result = Napi::Array::New(env, receivedCount);
     for (UINT i = 0; i < receivedCount; i++) {
-        Napi::Object frameObj = Napi::Object::New(env);
-        frameObj.Set("id", Napi::Number::New(env, frames[i].frame.can_id));
-        frameObj.Set("dlc", Napi::Number::New(env, frames[i].frame.can_dlc));
-        frameObj.Set("timestamp", Napi::Number::New(env, static_cast<double>(frames[i].timestamp)));
-
-        Napi::Array dataArr = Napi::Array::New(env, frames[i].frame.can_dlc);
-        for (BYTE j = 0; j < frames[i].frame.can_dlc; j++) {
-            dataArr[j] = Napi::Number::New(env, frames[i].frame.data[j]);
-        }
-        frameObj.Set("data", dataArr);
-
-        result[i] = frameObj;
+        result[i] = ReceivedCanToObject(env, frames[i]);
     }
 
     return result;
@@ -553,9 +1209,10 @@ Napi::Value ZlgCanDevice::TransmitFD(const Napi::CallbackInfo& info) {
         return env.Null();
     }
 
-    CHANNEL_HANDLE channelHandle = GetChannelHandleFromValue(env, info[0]);
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
     if (env.IsExceptionPending()) return env.Null();
 
+    ApiScope scope(ApiId::JsTransmitFD);
     std::vector<ZCAN_TransmitFD_Data> frames;
 
     if (info[1].IsArray()) {
@@ -599,7 +1256,17 @@ Napi::Value ZlgCanDevice::TransmitFD(const Napi::CallbackInfo& info) {
         }
     }
 
-    UINT sentCount = ZCAN_TransmitFD(channelHandle, frames.data(), static_cast<UINT>(frames.size()));
+    UINT channelIndex = 0;
+    auto protector = FindChannelIndex(channelHandle, &channelIndex) ? e2eProtectors_.find(channelIndex) : e2eProtectors_.end();
+    if (protector != e2eProtectors_.end()) {
+        for (ZCAN_TransmitFD_Data& frame : frames) {
+            protector->second.Apply(frame.frame.can_id, frame.frame.data, std::min<BYTE>(frame.frame.len, CANFD_MAX_DLEN));
+        }
+    }
+
+    UINT sentCount = ZcanTransmitFD(channelHandle, frames.data(), static_cast<UINT>(frames.size()));
+    scope.SetFrames(sentCount, sizeof(ZCAN_TransmitFD_Data));
+    scope.SetError(sentCount < frames.size());
     return Napi::Number::New(env, sentCount);
 }
 
@@ -611,30 +1278,22 @@ Napi::Value ZlgCanDevice::ReceiveFD(const Napi::CallbackInfo& info) {
         return env.Null();
     }
 
-    CHANNEL_HANDLE channelHandle = GetChannelHandleFromValue(env, info[0]);
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
     if (env.IsExceptionPending()) return env.Null();
 
     UINT count = info[1].As<Napi::Number>().Uint32Value();
     int waitTime = info.Length() > 2 ? info[2].As<Napi::Number>().Int32Value() : -1;
 
+    ApiScope scope(ApiId::JsReceiveFD);
     std::vector<ZCAN_ReceiveFD_Data> frames(count);
-    UINT receivedCount = ZCAN_ReceiveFD(channelHandle, frames.data(), count, waitTime);
+    ReceivePump* pump = FindReceivePump(channelHandle);
+    UINT receivedCount = pump ? pump->PopCanFD(frames.data(), count, waitTime)
+                              : ZcanReceiveFD(channelHandle, frames.data(), count, waitTime);
+    scope.SetFrames(receivedCount, sizeof(ZCAN_ReceiveFD_Data));
 
     Napi::Array result = Napi::Array::New(env, receivedCount);
     for (UINT i = 0; i < receivedCount; i++) {
-        Napi::Object frameObj = Napi::Object::New(env);
-        frameObj.Set("id", Napi::Number::New(env, frames[i].frame.can_id));
-        frameObj.Set("len", Napi::Number::New(env, frames[i].frame.len));
-        frameObj.Set("flags", Napi::Number::New(env, frames[i].frame.flags));
-        frameObj.Set("timestamp", Napi::Number::New(env, static_cast<double>(frames[i].timestamp)));
-
-        Napi::Array dataArr = Napi::Array::New(env, frames[i].frame.len);
-        for (BYTE j = 0; j < frames[i].frame.len; j++) {
-            dataArr[j] = Napi::Number::New(env, frames[i].frame.data[j]);
-        }
-        frameObj.Set("data", dataArr);
-
-        result[i] = frameObj;
+        result[i] = ReceivedFdToObject(env, frames[i]);
     }
 
     return result;
@@ -653,6 +1312,7 @@ Napi::Value ZlgCanDevice::TransmitData(const Napi::CallbackInfo& info) {
         return env.Null();
     }
 
+    ApiScope scope(ApiId::JsTransmitData);
     std::vector<ZCANDataObj> dataObjs;
 
     if (info[0].IsArray()) {
@@ -718,7 +1378,9 @@ Napi::Value ZlgCanDevice::TransmitData(const Napi::CallbackInfo& info) {
         }
     }
 
-    UINT sentCount = ZCAN_TransmitData(deviceHandle_, dataObjs.data(), static_cast<UINT>(dataObjs.size()));
+    UINT sentCount = ZcanTransmitData(deviceHandle_, dataObjs.data(), static_cast<UINT>(dataObjs.size()));
+    scope.SetFrames(sentCount, sizeof(ZCANDataObj));
+    scope.SetError(sentCount < dataObjs.size());
     return Napi::Number::New(env, sentCount);
 }
 
@@ -738,8 +1400,39 @@ Napi::Value ZlgCanDevice::ReceiveData(const Napi::CallbackInfo& info) {
     UINT count = info[0].As<Napi::Number>().Uint32Value();
     int waitTime = info.Length() > 1 ? info[1].As<Napi::Number>().Int32Value() : -1;
 
+    ApiScope scope(ApiId::JsReceiveData);
     std::vector<ZCANDataObj> dataObjs(count);
-    UINT receivedCount = ZCAN_ReceiveData(deviceHandle_, dataObjs.data(), count, waitTime);
+    std::vector<ReceivePump*> pumps;
+    for (const auto& entry : receiveChannels_) {
+        if (entry.second.pump && entry.second.pump->IsRunning()) {
+            pumps.push_back(entry.second.pump.get());
+        }
+    }
+    UINT receivedCount = 0;
+    if (pumps.empty()) {
+        receivedCount = ZcanReceiveData(deviceHandle_, dataObjs.data(), count, waitTime);
+    } else {
+        // 接收线程运行时CAN/CANFD帧已由其读出并经协议引擎过滤，从各通道的接收缓冲取出；
+        // 错误、总线利用率、LIN等其他数据仍直接向驱动读取。两者都为空时在接收缓冲上等待，
+        // 每次至多RECEIVE_DATA_WAIT_SLICE后补查驱动；JS线程不无限阻塞，waitTime小于0按RECEIVE_DATA_MAX_WAIT_MS等待
+        const auto deadline = std::chrono::steady_clock::now() +
+            std::chrono::milliseconds(waitTime < 0 ? RECEIVE_DATA_MAX_WAIT_MS : waitTime);
+        for (size_t round = 0;; round++) {
+            receivedCount = PopPumpedData(dataObjs.data(), count);
+            if (receivedCount < count) {
+                receivedCount += ZcanReceiveData(deviceHandle_, dataObjs.data() + receivedCount,
+                                                 count - receivedCount, 0);
+            }
+            const auto now = std::chrono::steady_clock::now();
+            if (receivedCount > 0 || now >= deadline) {
+                break;
+            }
+            pumps[round % pumps.size()]->WaitUnclaimed(std::min(deadline, now + RECEIVE_DATA_WAIT_SLICE));
+        }
+        // 各通道、CAN与CANFD以及驱动直接读取的记录按时间戳合并为与驱动合并接收相同的顺序
+        SortDataObjsByTimestamp(dataObjs.data(), receivedCount);
+    }
+    scope.SetFrames(receivedCount, sizeof(ZCANDataObj));
 
     Napi::Array result = Napi::Array::New(env, receivedCount);
     for (UINT i = 0; i < receivedCount; i++) {
@@ -773,6 +1466,12 @@ Napi::Value ZlgCanDevice::ReceiveData(const Napi::CallbackInfo& info) {
             errData.Set("txErrCount", Napi::Number::New(env, dataObjs[i].data.zcanErrData.txErrCount));
             errData.Set("errData", Napi::Number::New(env, dataObjs[i].data.zcanErrData.errData));
             obj.Set("errData", errData);
+
+            // 转交给对应通道的健康监视器
+            auto it = healthMonitors_.find(dataObjs[i].chnl);
+            if (it != healthMonitors_.end()) {
+                it->second.monitor->OnErrorRecord(dataObjs[i].data.zcanErrData);
+            }
         } else if (dataObjs[i].dataType == ZCAN_DT_ZCAN_BUSUSAGE_DATA) {
             Napi::Object busUsage = Napi::Object::New(env);
             busUsage.Set("timestampBegin", Napi::Number::New(env,
@@ -783,6 +1482,12 @@ Napi::Value ZlgCanDevice::ReceiveData(const Napi::CallbackInfo& info) {
             busUsage.Set("busUsage", Napi::Number::New(env, dataObjs[i].data.busUsage.nBusUsage));
             busUsage.Set("frameCount", Napi::Number::New(env, dataObjs[i].data.busUsage.nFrameCount));
             obj.Set("busUsage", busUsage);
+        } else if (dataObjs[i].dataType == ZCAN_DT_ZCAN_LIN_DATA) {
+            obj.Set("linData", LinDataToObject(env, dataObjs[i].data.zcanLINData));
+        } else if (dataObjs[i].dataType == ZCAN_DT_ZCAN_LIN_ERROR_DATA) {
+            obj.Set("linErrData", LinErrDataToObject(env, dataObjs[i].data.zcanLINErrData));
+        } else if (dataObjs[i].dataType == ZCAN_DT_ZCAN_LIN_EVENT_DATA) {
+            obj.Set("linEvent", LinEventToObject(env, dataObjs[i].data.zcanLINEventData));
         }
 
         result[i] = obj;
@@ -791,6 +1496,310 @@ Napi::Value ZlgCanDevice::ReceiveData(const Napi::CallbackInfo& info) {
     return result;
 }
 
+// ==================== 异步设备与通道操作 ====================
+
+/**
+ * 在独立线程中执行阻塞的ZCAN调用并返回Promise
+ * timeoutMs为0时不限时；超时后Promise以错误拒绝，之后才返回的结果交给onOrphan在工作线程中清理。
+ * onComplete在JS线程中执行，负责更新对象状态并生成Promise的值。
+ */
+template <typename Result>
+Napi::Value ZlgCanDevice::RunBlockingAsync(Napi::Env env, const char* name, UINT timeoutMs,
+                                           std::function<Result()> call,
+                                           std::function<Napi::Value(Napi::Env, Result)> onComplete,
+                                           std::function<void(Result)> onOrphan) {
+    Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+    auto state = std::make_shared<AsyncCallState>();
+    const std::string opName(name);
+
+    Napi::ThreadSafeFunction tsfn = Napi::ThreadSafeFunction::New(
+        env, Napi::Function::New(env, [](const Napi::CallbackInfo&) {}), name, 0, timeoutMs > 0 ? 2 : 1);
+
+    // 调用期间保持JS对象存活，Promise确定后释放
+    Ref();
+    ZlgCanDevice* self = this;
+
+    std::thread([=]() {
+        Result result = call();
+        bool orphaned = false;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->done = true;
+            orphaned = state->settled;
+            state->settled = true;
+        }
+        state->cv.notify_all();
+
+        if (orphaned) {
+            if (onOrphan) {
+                onOrphan(result);
+            }
+        } else {
+            tsfn.BlockingCall([=](Napi::Env env, Napi::Function) {
+                self->Unref();
+                deferred.Resolve(onComplete(env, result));
+            });
+        }
+        tsfn.Release();
+    }).detach();
+
+    if (timeoutMs > 0) {
+        std::thread([=]() {
+            bool timedOut = false;
+            {
+                std::unique_lock<std::mutex> lock(state->mutex);
+                state->cv.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&state] { return state->done; });
+                timedOut = !state->settled;
+                state->settled = true;
+            }
+
+            if (timedOut) {
+                tsfn.BlockingCall([=](Napi::Env env, Napi::Function) {
+                    self->Unref();
+                    deferred.Reject(Napi::Error::New(env,
+                        opName + " 超时 (" + std::to_string(timeoutMs) + "ms)").Value());
+                });
+            }
+            tsfn.Release();
+        }).detach();
+    }
+
+    return deferred.Promise();
+}
+
+void ZlgCanDevice::OnChannelInitialized(UINT channelIndex, const ZCAN_CHANNEL_INIT_CONFIG& initConfig,
+                                        CHANNEL_HANDLE channelHandle) {
+    if (channelHandle == INVALID_CHANNEL_HANDLE) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(handlesMutex_);
+        channelHandles_[channelIndex] = channelHandle;
+        handleIndex_[channelHandle] = channelIndex;
+    }
+    if (session_) {
+        std::lock_guard<std::mutex> lock(session_->mutex);
+        session_->trackedChannels.insert(channelHandle);
+    }
+    if (deviceMonitor_) {
+        deviceMonitor_->RecordInitCan(channelIndex, initConfig, channelHandle);
+    }
+    RefreshPipelineSources();
+
+    auto it = receiveChannels_.find(channelIndex);
+    if (it != receiveChannels_.end()) {
+        it->second.pump->SetChannelHandle(channelHandle);
+        if (it->second.isotp) {
+            it->second.isotp->SetChannelHandle(channelHandle);
+        }
+        if (it->second.j1939) {
+            it->second.j1939->SetChannelHandle(channelHandle);
+        }
+        if (it->second.xcp) {
+            it->second.xcp->SetChannelHandle(channelHandle);
+        }
+        if (it->second.canopen) {
+            it->second.canopen->SetChannelHandle(channelHandle);
+        }
+    }
+
+    auto restBusIt = restBuses_.find(channelIndex);
+    if (restBusIt != restBuses_.end()) {
+        restBusIt->second.engine->SetChannelHandle(channelHandle);
+    }
+}
+
+void ZlgCanDevice::OnChannelStarted(CHANNEL_HANDLE channelHandle) {
+    UINT channelIndex = 0;
+    if (deviceMonitor_ && FindChannelIndex(channelHandle, &channelIndex)) {
+        deviceMonitor_->RecordStartCan(channelIndex);
+    }
+}
+
+Napi::Value ZlgCanDevice::OpenDeviceAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2) {
+        Napi::TypeError::New(env, "需要至少2个参数: deviceType, deviceIndex").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    UINT deviceType = info[0].As<Napi::Number>().Uint32Value();
+    UINT deviceIndex = info[1].As<Napi::Number>().Uint32Value();
+    UINT reserved = info.Length() > 2 ? info[2].As<Napi::Number>().Uint32Value() : 0;
+    UINT timeoutMs = info.Length() > 3 ? info[3].As<Napi::Number>().Uint32Value() : 0;
+
+    return RunBlockingAsync<DEVICE_HANDLE>(env, "openDevice", timeoutMs,
+        [deviceType, deviceIndex, reserved]() {
+            return ZcanOpenDevice(deviceType, deviceIndex, reserved);
+        },
+        [this, deviceType, deviceIndex, reserved](Napi::Env env, DEVICE_HANDLE deviceHandle) -> Napi::Value {
+            if (deviceHandle != INVALID_DEVICE_HANDLE) {
+                AttachDevice(deviceHandle, deviceType, deviceIndex, reserved);
+            }
+            return Napi::Boolean::New(env, deviceHandle != INVALID_DEVICE_HANDLE);
+        },
+        [](DEVICE_HANDLE deviceHandle) {
+            // 超时后才打开成功的设备无人使用，直接关闭
+            if (deviceHandle != INVALID_DEVICE_HANDLE) {
+                ZcanCloseDevice(deviceHandle);
+            }
+        });
+}
+
+Napi::Value ZlgCanDevice::CloseDeviceAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    UINT timeoutMs = info.Length() > 0 ? info[0].As<Napi::Number>().Uint32Value() : 0;
+
+    DEVICE_HANDLE deviceHandle = DetachDevice();
+    if (deviceHandle == INVALID_DEVICE_HANDLE) {
+        Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+        deferred.Resolve(Napi::Boolean::New(env, false));
+        return deferred.Promise();
+    }
+
+    return RunBlockingAsync<UINT>(env, "closeDevice", timeoutMs,
+        [deviceHandle]() {
+            return ZcanCloseDevice(deviceHandle);
+        },
+        [](Napi::Env env, UINT result) -> Napi::Value {
+            return Napi::Boolean::New(env, result == STATUS_OK);
+        },
+        nullptr);
+}
+
+Napi::Value ZlgCanDevice::InitCanChannelAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (deviceHandle_ == INVALID_DEVICE_HANDLE) {
+        Napi::Error::New(env, "设备未打开").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() < 2) {
+        Napi::TypeError::New(env, "需要2个参数: channelIndex, config").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    UINT channelIndex = info[0].As<Napi::Number>().Uint32Value();
+    Napi::Object config = info[1].As<Napi::Object>();
+    UINT timeoutMs = info.Length() > 2 ? info[2].As<Napi::Number>().Uint32Value() : 0;
+
+    ZCAN_CHANNEL_INIT_CONFIG initConfig;
+    memset(&initConfig, 0, sizeof(initConfig));
+    ParseChannelInitConfig(config, &initConfig);
+
+    DEVICE_HANDLE deviceHandle = deviceHandle_;
+    std::shared_ptr<DeviceSession> session = session_;
+    const uint64_t epoch = ++channelEpochs_[channelIndex];
+    return RunBlockingAsync<CHANNEL_HANDLE>(env, "initCanChannel", timeoutMs,
+        [deviceHandle, channelIndex, initConfig]() mutable {
+            return ZcanInitCAN(deviceHandle, channelIndex, &initConfig);
+        },
+        [this, channelIndex, initConfig, session, epoch](Napi::Env env, CHANNEL_HANDLE channelHandle) -> Napi::Value {
+            // 完成前设备已关闭重开，或该通道已被复位、重新初始化：结果作废，按孤立通道处理并返回失败
+            if (session != session_ || channelEpochs_[channelIndex] != epoch) {
+                ReleaseOrphanChannel(session, channelHandle);
+                return Napi::BigInt::New(env, static_cast<uint64_t>(INVALID_CHANNEL_HANDLE));
+            }
+            OnChannelInitialized(channelIndex, initConfig, channelHandle);
+            return Napi::BigInt::New(env, reinterpret_cast<uint64_t>(channelHandle));
+        },
+        [session](CHANNEL_HANDLE channelHandle) {
+            // 超时后才初始化成功的通道无人跟踪也无人关闭，在工作线程上复位释放
+            ReleaseOrphanChannel(session, channelHandle);
+        });
+}
+
+Napi::Value ZlgCanDevice::StartCanChannelAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT timeoutMs = info.Length() > 1 ? info[1].As<Napi::Number>().Uint32Value() : 0;
+
+    return RunBlockingAsync<UINT>(env, "startCanChannel", timeoutMs,
+        [channelHandle]() {
+            return ZcanStartCAN(channelHandle);
+        },
+        [this, channelHandle](Napi::Env env, UINT result) -> Napi::Value {
+            if (result == STATUS_OK) {
+                OnChannelStarted(channelHandle);
+            }
+            return Napi::Boolean::New(env, result == STATUS_OK);
+        },
+        nullptr);
+}
+
+Napi::Value ZlgCanDevice::QuiesceAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (deviceHandle_ == INVALID_DEVICE_HANDLE) {
+        Napi::Error::New(env, "设备未打开").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() < 1 || !info[0].IsArray()) {
+        Napi::TypeError::New(env, "需要参数: channelHandles数组").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Array handles = info[0].As<Napi::Array>();
+    std::vector<std::pair<UINT, CHANNEL_HANDLE>> channels;
+    for (uint32_t i = 0; i < handles.Length(); i++) {
+        CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, handles.Get(i)));
+        if (env.IsExceptionPending()) return env.Null();
+
+        UINT channelIndex = 0;
+        if (!FindChannelIndex(channelHandle, &channelIndex)) {
+            Napi::Error::New(env, "未知的通道句柄").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        channels.emplace_back(channelIndex, channelHandle);
+    }
+
+    QuiesceOptions options;
+    if (info.Length() > 1 && info[1].IsObject()) {
+        Napi::Object opts = info[1].As<Napi::Object>();
+        if (opts.Has("timeoutMs")) options.timeoutMs = opts.Get("timeoutMs").As<Napi::Number>().Uint32Value();
+        if (opts.Has("settleMs")) options.settleMs = opts.Get("settleMs").As<Napi::Number>().Uint32Value();
+        if (opts.Has("txCapacity")) options.txCapacity = opts.Get("txCapacity").As<Napi::Number>().Uint32Value();
+    }
+
+    DEVICE_HANDLE deviceHandle = deviceHandle_;
+    return RunBlockingAsync<QuiesceResult>(env, "quiesce", 0,
+        [deviceHandle, channels, options]() {
+            return QuiesceChannels(deviceHandle, channels, options);
+        },
+        [this, channels](Napi::Env env, QuiesceResult result) -> Napi::Value {
+            for (const auto& channel : channels) {
+                // 已取消的定时发送在设备重连后不应再回放
+                if (deviceMonitor_) {
+                    deviceMonitor_->RecordSetValue(std::to_string(channel.first) + "/clear_auto_send", "0");
+                }
+                // 接收线程在清空期间取走的帧同样丢弃
+                auto it = receiveChannels_.find(channel.first);
+                if (it != receiveChannels_.end()) {
+                    it->second.pump->ClearRing();
+                }
+            }
+
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("clean", Napi::Boolean::New(env, result.clean));
+            obj.Set("discardedFrames", Napi::Number::New(env, result.discardedFrames));
+            obj.Set("elapsedUs", Napi::Number::New(env, static_cast<double>(result.elapsedUs)));
+            return obj;
+        },
+        nullptr);
+}
+
 // ==================== 属性操作 ====================
 
 Napi::Value ZlgCanDevice::SetValue(const Napi::CallbackInfo& info) {
@@ -809,7 +1818,10 @@ Napi::Value ZlgCanDevice::SetValue(const Napi::CallbackInfo& info) {
     std::string path = info[0].As<Napi::String>().Utf8Value();
     std::string value = info[1].As<Napi::String>().Utf8Value();
 
-    UINT result = ZCAN_SetValue(deviceHandle_, path.c_str(), value.c_str());
+    UINT result = ZcanSetValue(deviceHandle_, path.c_str(), value.c_str());
+    if (result == STATUS_OK && deviceMonitor_) {
+        deviceMonitor_->RecordSetValue(path, value);
+    }
     return Napi::Number::New(env, result);
 }
 
@@ -828,7 +1840,7 @@ Napi::Value ZlgCanDevice::GetValue(const Napi::CallbackInfo& info) {
 
     std::string path = info[0].As<Napi::String>().Utf8Value();
 
-    const void* result = ZCAN_GetValue(deviceHandle_, path.c_str());
+    const void* result = ZcanGetValue(deviceHandle_, path.c_str());
     if (result == nullptr) {
         return env.Null();
     }
@@ -847,10 +1859,15 @@ Napi::Value ZlgCanDevice::GetIProperty(const Napi::CallbackInfo& info) {
     }
 
     if (pProperty_ != nullptr) {
-        ::ReleaseIProperty(pProperty_);
+        ZcanReleaseIProperty(pProperty_);
     }
 
-    pProperty_ = ::GetIProperty(deviceHandle_);
+    IProperty* property = ZcanGetIProperty(deviceHandle_);
+    if (deviceMonitor_) {
+        deviceMonitor_->RecordProperty(property);
+    }
+    std::lock_guard<std::mutex> lock(handlesMutex_);
+    pProperty_ = property;
     return Napi::Boolean::New(env, pProperty_ != nullptr);
 }
 
@@ -870,7 +1887,10 @@ Napi::Value ZlgCanDevice::SetPropertyValue(const Napi::CallbackInfo& info) {
     std::string path = info[0].As<Napi::String>().Utf8Value();
     std::string value = info[1].As<Napi::String>().Utf8Value();
 
-    int result = pProperty_->SetValue(path.c_str(), value.c_str());
+    int result = ZcanPropertySetValue(pProperty_, path.c_str(), value.c_str());
+    if (result == STATUS_OK && deviceMonitor_) {
+        deviceMonitor_->RecordSetValue(path, value);
+    }
     return Napi::Number::New(env, result);
 }
 
@@ -889,7 +1909,7 @@ Napi::Value ZlgCanDevice::GetPropertyValue(const Napi::CallbackInfo& info) {
 
     std::string path = info[0].As<Napi::String>().Utf8Value();
 
-    const char* result = pProperty_->GetValue(path.c_str());
+    const char* result = ZcanPropertyGetValue(pProperty_, path.c_str());
     if (result == nullptr) {
         return env.Null();
     }
@@ -904,14 +1924,4217 @@ Napi::Value ZlgCanDevice::ReleaseIProperty(const Napi::CallbackInfo& info) {
         return Napi::Boolean::New(env, false);
     }
 
-    UINT result = ::ReleaseIProperty(pProperty_);
-    pProperty_ = nullptr;
+    UINT result = ZcanReleaseIProperty(pProperty_);
+    {
+        std::lock_guard<std::mutex> lock(handlesMutex_);
+        pProperty_ = nullptr;
+    }
+
+    return Napi::Boolean::New(env, result == STATUS_OK);
+}
+
+// ==================== 通道健康监视 ====================
+
+namespace {
+
+const char* HealthEventTypeName(HealthEvent::Type type) {
+    switch (type) {
+        case HealthEvent::Type::RecoveryAttempt: return "recoveryAttempt";
+        case HealthEvent::Type::Recovered: return "recovered";
+        default: return "stateChange";
+    }
+}
+
+void CallHealthCallback(Napi::Env env, Napi::Function callback, HealthEvent* event) {
+    if (env != nullptr && callback != nullptr) {
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("type", Napi::String::New(env, HealthEventTypeName(event->type)));
+        obj.Set("channelIndex", Napi::Number::New(env, event->channelIndex));
+        obj.Set("state", Napi::Number::New(env, static_cast<uint32_t>(event->state)));
+        obj.Set("previousState", Napi::Number::New(env, static_cast<uint32_t>(event->previousState)));
+        obj.Set("timestamp", Napi::Number::New(env, static_cast<double>(event->timestampMs)));
+        obj.Set("rxErrCount", Napi::Number::New(env, event->rxErrCount));
+        obj.Set("txErrCount", Napi::Number::New(env, event->txErrCount));
+        obj.Set("errorCode", Napi::Number::New(env, event->errorCode));
+        obj.Set("attempt", Napi::Number::New(env, event->attempt));
+        obj.Set("success", Napi::Boolean::New(env, event->success));
+        obj.Set("latencyUs", Napi::Number::New(env, static_cast<double>(event->latencyUs)));
+        callback.Call({obj});
+    }
+    delete event;
+}
+
+}  // namespace
+
+bool ZlgCanDevice::FindChannelIndex(CHANNEL_HANDLE channelHandle, UINT* channelIndex) const {
+    std::lock_guard<std::mutex> lock(handlesMutex_);
+    auto it = handleIndex_.find(channelHandle);
+    if (it == handleIndex_.end()) {
+        return false;
+    }
+    *channelIndex = it->second;
+    return true;
+}
+
+CHANNEL_HANDLE ZlgCanDevice::ResolveChannelHandle(CHANNEL_HANDLE channelHandle) const {
+    std::lock_guard<std::mutex> lock(handlesMutex_);
+    auto indexIt = handleIndex_.find(channelHandle);
+    if (indexIt == handleIndex_.end()) {
+        return channelHandle;
+    }
+    auto it = channelHandles_.find(indexIt->second);
+    return it == channelHandles_.end() ? channelHandle : it->second;
+}
+
+CHANNEL_HANDLE ZlgCanDevice::ResolveLinHandle(CHANNEL_HANDLE channelHandle) const {
+    std::lock_guard<std::mutex> lock(handlesMutex_);
+    auto indexIt = linHandleIndex_.find(channelHandle);
+    if (indexIt == linHandleIndex_.end()) {
+        return channelHandle;
+    }
+    auto it = linChannels_.find(indexIt->second);
+    return it == linChannels_.end() ? channelHandle : it->second.handle;
+}
+
+void ZlgCanDevice::StopHealthMonitorAt(UINT channelIndex) {
+    auto it = healthMonitors_.find(channelIndex);
+    if (it == healthMonitors_.end()) {
+        return;
+    }
+    // 先停止线程再释放TSFN，保证不会再有回调入队
+    it->second.monitor->Stop();
+    it->second.tsfn.Release();
+    std::lock_guard<std::mutex> lock(handlesMutex_);
+    healthMonitors_.erase(it);
+}
+
+void ZlgCanDevice::StopAllHealthMonitors() {
+    while (!healthMonitors_.empty()) {
+        StopHealthMonitorAt(healthMonitors_.begin()->first);
+    }
+}
+
+Napi::Value ZlgCanDevice::StartHealthMonitor(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (deviceHandle_ == INVALID_DEVICE_HANDLE) {
+        Napi::Error::New(env, "设备未打开").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() < 3 || !info[2].IsFunction()) {
+        Napi::TypeError::New(env, "需要3个参数: channelHandle, options, callback").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        Napi::Error::New(env, "通道未初始化").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HealthMonitorOptions options;
+    if (info[1].IsObject()) {
+        Napi::Object opts = info[1].As<Napi::Object>();
+        if (opts.Has("pollIntervalMs")) {
+            options.pollIntervalMs = opts.Get("pollIntervalMs").As<Napi::Number>().Uint32Value();
+        }
+        if (opts.Has("autoRecover")) {
+            options.autoRecover = opts.Get("autoRecover").ToBoolean().Value();
+        }
+        if (opts.Has("recoveryDelayMs")) {
+            options.recoveryDelayMs = opts.Get("recoveryDelayMs").As<Napi::Number>().Uint32Value();
+        }
+        if (opts.Has("maxRecoveryDelayMs")) {
+            options.maxRecoveryDelayMs = opts.Get("maxRecoveryDelayMs").As<Napi::Number>().Uint32Value();
+        }
+        if (opts.Has("maxRecoveryAttempts")) {
+            options.maxRecoveryAttempts = opts.Get("maxRecoveryAttempts").As<Napi::Number>().Uint32Value();
+        }
+        if (opts.Has("settlePolls")) {
+            options.settlePolls = opts.Get("settlePolls").As<Napi::Number>().Uint32Value();
+        }
+    }
+
+    StopHealthMonitorAt(channelIndex);
+
+    HealthMonitorEntry entry;
+    entry.tsfn = Napi::ThreadSafeFunction::New(env, info[2].As<Napi::Function>(), "ZlgCanHealthMonitor", 0, 1);
+    // 监视器不应阻止进程退出
+    entry.tsfn.Unref(env);
+
+    Napi::ThreadSafeFunction tsfn = entry.tsfn;
+    entry.monitor.reset(new ChannelHealthMonitor(channelHandle, channelIndex, options,
+        [tsfn](const HealthEvent& event) {
+            HealthEvent* copy = new HealthEvent(event);
+            if (tsfn.NonBlockingCall(copy, CallHealthCallback) != napi_ok) {
+                delete copy;
+            }
+        }));
+    entry.monitor->Start();
+
+    std::lock_guard<std::mutex> lock(handlesMutex_);
+    healthMonitors_[channelIndex] = std::move(entry);
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::StopHealthMonitor(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex) ||
+        healthMonitors_.find(channelIndex) == healthMonitors_.end()) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    StopHealthMonitorAt(channelIndex);
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::GetHealthState(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        return env.Null();
+    }
+    auto it = healthMonitors_.find(channelIndex);
+    if (it == healthMonitors_.end()) {
+        return env.Null();
+    }
+
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("channelIndex", Napi::Number::New(env, channelIndex));
+    obj.Set("state", Napi::Number::New(env, static_cast<uint32_t>(it->second.monitor->State())));
+    obj.Set("recoveryCount", Napi::Number::New(env, it->second.monitor->RecoveryCount()));
+    return obj;
+}
+
+// ==================== 接收链路监视 ====================
+
+namespace {
+
+const char* PipelineWarningTypeName(PipelineWarning::Type type) {
+    switch (type) {
+        case PipelineWarning::Type::RingFilling: return "ringFilling";
+        case PipelineWarning::Type::VendorQueue: return "vendorQueue";
+        case PipelineWarning::Type::FramesDropped: return "framesDropped";
+        default: return "eventLoopLag";
+    }
+}
+
+void CallPipelineWarningCallback(Napi::Env env, Napi::Function callback, PipelineWarning* warning) {
+    if (env != nullptr && callback != nullptr) {
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("type", Napi::String::New(env, PipelineWarningTypeName(warning->type)));
+        if (warning->type != PipelineWarning::Type::EventLoopLag) {
+            obj.Set("channelIndex", Napi::Number::New(env, warning->channelIndex));
+        }
+        obj.Set("timestamp", Napi::Number::New(env, static_cast<double>(warning->timestampMs)));
+        obj.Set("value", Napi::Number::New(env, warning->value));
+        obj.Set("threshold", Napi::Number::New(env, warning->threshold));
+        obj.Set("lagMs", Napi::Number::New(env, warning->lagMs));
+        obj.Set("etaMs", Napi::Number::New(env, warning->etaMs));
+        callback.Call({obj});
+    }
+    delete warning;
+}
+
+// 探测应答只需在JS线程执行，不调用JS回调
+void CallPipelinePong(Napi::Env env, Napi::Function callback, PipelineWatchdog::PongFn* pong) {
+    if (env != nullptr) {
+        (*pong)();
+    }
+    delete pong;
+}
+
+}  // namespace
+
+void ZlgCanDevice::StopPipelineWatchdogThread() {
+    if (pipelineWatchdog_) {
+        pipelineWatchdog_->Stop();
+        pipelineWatchdog_.reset();
+    }
+    if (pipelineWatchdogTsfn_) {
+        pipelineWatchdogTsfn_.Release();
+        pipelineWatchdogTsfn_ = Napi::ThreadSafeFunction();
+    }
+}
+
+void ZlgCanDevice::RefreshPipelineSources(const ReceivePump* retiring) {
+    if (!pipelineWatchdog_) {
+        return;
+    }
+    // 监视器采样时持有自身的锁调用ZCAN_*，可能在设备句柄闸门入口等待，SetSources不能在持有句柄表锁时调用
+    std::vector<PipelineSource> sources;
+    std::unique_lock<std::mutex> lock(handlesMutex_);
+    for (const auto& channel : channelHandles_) {
+        PipelineSource source;
+        source.channelIndex = channel.first;
+        source.channelHandle = channel.second;
+        auto it = receiveChannels_.find(channel.first);
+        if (it != receiveChannels_.end() && it->second.pump.get() != retiring) {
+            source.receivePump = it->second.pump.get();
+        }
+        sources.push_back(source);
+    }
+    lock.unlock();
+    pipelineWatchdog_->SetSources(std::move(sources));
+}
+
+Napi::Value ZlgCanDevice::StartPipelineWatchdog(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (deviceHandle_ == INVALID_DEVICE_HANDLE) {
+        Napi::Error::New(env, "设备未打开").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() < 2 || !info[1].IsFunction()) {
+        Napi::TypeError::New(env, "需要2个参数: options, callback").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    PipelineWatchdogOptions options;
+    if (info[0].IsObject()) {
+        Napi::Object opts = info[0].As<Napi::Object>();
+        if (opts.Has("intervalMs")) {
+            options.intervalMs = opts.Get("intervalMs").As<Napi::Number>().Uint32Value();
+        }
+        if (opts.Has("lagWarnMs")) {
+            options.lagWarnMs = opts.Get("lagWarnMs").As<Napi::Number>().Uint32Value();
+        }
+        if (opts.Has("ringWarnRatio")) {
+            options.ringWarnRatio = opts.Get("ringWarnRatio").As<Napi::Number>().DoubleValue();
+        }
+        if (opts.Has("vendorWarnFrames")) {
+            options.vendorWarnFrames = opts.Get("vendorWarnFrames").As<Napi::Number>().Uint32Value();
+        }
+        if (opts.Has("historySize")) {
+            options.historySize = opts.Get("historySize").As<Napi::Number>().Uint32Value();
+        }
+    }
+
+    StopPipelineWatchdogThread();
+
+    pipelineWatchdogTsfn_ = Napi::ThreadSafeFunction::New(env, info[1].As<Napi::Function>(),
+                                                          "ZlgCanPipelineWatchdog", 0, 1);
+    // 监视器不应阻止进程退出
+    pipelineWatchdogTsfn_.Unref(env);
+
+    Napi::ThreadSafeFunction tsfn = pipelineWatchdogTsfn_;
+    pipelineWatchdog_.reset(new PipelineWatchdog(options,
+        [tsfn](const PipelineWatchdog::PongFn& pong) {
+            PipelineWatchdog::PongFn* copy = new PipelineWatchdog::PongFn(pong);
+            if (tsfn.NonBlockingCall(copy, CallPipelinePong) != napi_ok) {
+                delete copy;
+                return false;
+            }
+            return true;
+        },
+        [tsfn](const PipelineWarning& warning) {
+            PipelineWarning* copy = new PipelineWarning(warning);
+            if (tsfn.NonBlockingCall(copy, CallPipelineWarningCallback) != napi_ok) {
+                delete copy;
+            }
+        }));
+    RefreshPipelineSources();
+    pipelineWatchdog_->Start();
+
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::StopPipelineWatchdog(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    const bool running = static_cast<bool>(pipelineWatchdog_);
+    StopPipelineWatchdogThread();
+    return Napi::Boolean::New(env, running);
+}
+
+Napi::Value ZlgCanDevice::GetPipelineHistory(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (!pipelineWatchdog_) {
+        return env.Null();
+    }
+
+    uint64_t sinceMs = 0;
+    if (info.Length() > 0 && info[0].IsNumber()) {
+        sinceMs = static_cast<uint64_t>(std::max(0.0, info[0].As<Napi::Number>().DoubleValue()));
+    }
+
+    const std::vector<PipelineSample> history = pipelineWatchdog_->History(sinceMs);
+    Napi::Array samples = Napi::Array::New(env, history.size());
+    for (size_t i = 0; i < history.size(); i++) {
+        const PipelineSample& sample = history[i];
+        Napi::Array channels = Napi::Array::New(env, sample.channels.size());
+        for (size_t j = 0; j < sample.channels.size(); j++) {
+            const PipelineChannelSample& channel = sample.channels[j];
+            Napi::Object channelObj = Napi::Object::New(env);
+            channelObj.Set("channelIndex", Napi::Number::New(env, channel.channelIndex));
+            channelObj.Set("ringDepth", Napi::Number::New(env, static_cast<double>(channel.ringDepth)));
+            channelObj.Set("ringCapacity", Napi::Number::New(env, static_cast<double>(channel.ringCapacity)));
+            channelObj.Set("vendorDepth", Napi::Number::New(env, static_cast<double>(channel.vendorDepth)));
+            channelObj.Set("framesReceived", Napi::Number::New(env, static_cast<double>(channel.framesReceived)));
+            channelObj.Set("framesDropped", Napi::Number::New(env, static_cast<double>(channel.framesDropped)));
+            channels.Set(static_cast<uint32_t>(j), channelObj);
+        }
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("timestamp", Napi::Number::New(env, static_cast<double>(sample.timestampMs)));
+        obj.Set("lagMs", Napi::Number::New(env, sample.lagMs));
+        obj.Set("stalled", Napi::Boolean::New(env, sample.stalled));
+        obj.Set("channels", channels);
+        samples.Set(static_cast<uint32_t>(i), obj);
+    }
+    return samples;
+}
+
+// ==================== 设备热插拔监视 ====================
+
+void ZlgCanDevice::StopDeviceMonitorThread() {
+    if (deviceMonitor_) {
+        deviceMonitor_->Stop();
+    }
+    if (deviceMonitorTsfn_) {
+        deviceMonitorTsfn_.Release();
+        deviceMonitorTsfn_ = Napi::ThreadSafeFunction();
+    }
+}
+
+void ZlgCanDevice::SwapDeviceHandles(const DeviceEvent& event) {
+    // 在设备监视线程中执行，此时持有本设备的独占闸门：其他线程在本设备上的ZCAN_*调用均已返回并在入口等待
+    std::lock_guard<std::mutex> lock(handlesMutex_);
+    if (event.type == DeviceEvent::Type::Offline) {
+        // IProperty随设备关闭失效，重连后由JS线程重新获取
+        DeviceGateRetire(pProperty_);
+        return;
+    }
+
+    // 旧句柄保留在handleIndex_中，JS侧持有的句柄继续解析到新通道
+    for (const auto& channel : event.channels) {
+        channelHandles_[channel.first] = channel.second;
+        handleIndex_[channel.second] = channel.first;
+
+        auto it = healthMonitors_.find(channel.first);
+        if (it != healthMonitors_.end()) {
+            it->second.monitor->SetChannelHandle(channel.second);
+        }
+
+        auto receiveIt = receiveChannels_.find(channel.first);
+        if (receiveIt != receiveChannels_.end()) {
+            receiveIt->second.pump->SetChannelHandle(channel.second);
+            if (receiveIt->second.isotp) {
+                receiveIt->second.isotp->SetChannelHandle(channel.second);
+            }
+            if (receiveIt->second.j1939) {
+                receiveIt->second.j1939->SetChannelHandle(channel.second);
+            }
+            if (receiveIt->second.xcp) {
+                receiveIt->second.xcp->SetChannelHandle(channel.second);
+            }
+            if (receiveIt->second.canopen) {
+                receiveIt->second.canopen->SetChannelHandle(channel.second);
+            }
+        }
+
+        auto restBusIt = restBuses_.find(channel.first);
+        if (restBusIt != restBuses_.end()) {
+            restBusIt->second.engine->SetChannelHandle(channel.second);
+        }
+    }
+
+    for (const auto& channel : event.linChannels) {
+        auto it = linChannels_.find(channel.first);
+        if (it == linChannels_.end()) {
+            continue;
+        }
+        it->second.handle = channel.second;
+        // 调度表随旧设备关闭失效，不再在新设备上销毁
+        it->second.schedules.clear();
+        linHandleIndex_[channel.second] = channel.first;
+        if (it->second.pump) {
+            it->second.pump->SetChannelHandle(channel.second);
+        }
+    }
+}
+
+void ZlgCanDevice::ApplyReconnect(const DeviceEvent& event) {
+    // 通道句柄已由监视线程替换；设备句柄、IProperty和接收链路监视器只在JS线程使用，在此更新。
+    // 此前监视器在旧句柄上的驱动队列采样直接失败（计为0）
+    deviceHandle_ = event.deviceHandle;
+    RefreshPipelineSources();
+
+    if (pProperty_ != nullptr) {
+        ZcanReleaseIProperty(pProperty_);
+        IProperty* property = ZcanGetIProperty(deviceHandle_);
+        if (deviceMonitor_) {
+            deviceMonitor_->RecordProperty(property);
+        }
+        std::lock_guard<std::mutex> lock(handlesMutex_);
+        pProperty_ = property;
+    }
+}
+
+Napi::Value ZlgCanDevice::StartDeviceMonitor(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (deviceHandle_ == INVALID_DEVICE_HANDLE || !deviceMonitor_) {
+        Napi::Error::New(env, "设备未打开").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() < 2 || !info[1].IsFunction()) {
+        Napi::TypeError::New(env, "需要2个参数: options, callback").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    DeviceMonitorOptions options;
+    if (info[0].IsObject()) {
+        Napi::Object opts = info[0].As<Napi::Object>();
+        if (opts.Has("pollIntervalMs")) {
+            options.pollIntervalMs = opts.Get("pollIntervalMs").As<Napi::Number>().Uint32Value();
+        }
+        if (opts.Has("retryIntervalMs")) {
+            options.retryIntervalMs = opts.Get("retryIntervalMs").As<Napi::Number>().Uint32Value();
+        }
+    }
+
+    StopDeviceMonitorThread();
+
+    deviceMonitorTsfn_ = Napi::ThreadSafeFunction::New(
+        env, info[1].As<Napi::Function>(), "ZlgCanDeviceMonitor", 0, 1);
+    // 监视器不应阻止进程退出
+    deviceMonitorTsfn_.Unref(env);
+
+    Napi::ThreadSafeFunction tsfn = deviceMonitorTsfn_;
+    ZlgCanDevice* self = this;
+    deviceMonitor_->Start(options, [tsfn, self](const DeviceEvent& event) {
+        DeviceEvent* copy = new DeviceEvent(event);
+        napi_status status = tsfn.NonBlockingCall(copy,
+            [self](Napi::Env env, Napi::Function callback, DeviceEvent* event) {
+                // env为空表示TSFN正在销毁（设备对象可能已释放），只释放数据
+                if (env != nullptr) {
+                    if (event->type == DeviceEvent::Type::Reconnected) {
+                        self->ApplyReconnect(*event);
+                    }
+
+                    Napi::Object obj = Napi::Object::New(env);
+                    obj.Set("type", Napi::String::New(env,
+                        event->type == DeviceEvent::Type::Reconnected ? "reconnected" : "offline"));
+                    obj.Set("timestamp", Napi::Number::New(env, static_cast<double>(event->timestampMs)));
+                    obj.Set("attempts", Napi::Number::New(env, event->attempts));
+                    obj.Set("replayFailures", Napi::Number::New(env, event->replayFailures));
+                    obj.Set("reconnectUs", Napi::Number::New(env, static_cast<double>(event->reconnectUs)));
+
+                    Napi::Array channels = Napi::Array::New(env, event->channels.size());
+                    for (size_t i = 0; i < event->channels.size(); i++) {
+                        Napi::Object channel = Napi::Object::New(env);
+                        channel.Set("channelIndex", Napi::Number::New(env, event->channels[i].first));
+                        channel.Set("channelHandle", Napi::BigInt::New(env,
+                            reinterpret_cast<uint64_t>(event->channels[i].second)));
+                        channels[static_cast<uint32_t>(i)] = channel;
+                    }
+                    obj.Set("channels", channels);
+
+                    Napi::Array linChannels = Napi::Array::New(env, event->linChannels.size());
+                    for (size_t i = 0; i < event->linChannels.size(); i++) {
+                        Napi::Object channel = Napi::Object::New(env);
+                        channel.Set("linIndex", Napi::Number::New(env, event->linChannels[i].first));
+                        channel.Set("channelHandle", Napi::BigInt::New(env,
+                            reinterpret_cast<uint64_t>(event->linChannels[i].second)));
+                        linChannels[static_cast<uint32_t>(i)] = channel;
+                    }
+                    obj.Set("linChannels", linChannels);
+
+                    if (callback != nullptr) {
+                        callback.Call({obj});
+                    }
+                }
+                delete event;
+            });
+        if (status != napi_ok) {
+            delete copy;
+        }
+    }, [self](const DeviceEvent& event) {
+        self->SwapDeviceHandles(event);
+    });
+
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::StopDeviceMonitor(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (!deviceMonitor_ || !deviceMonitor_->IsRunning()) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    StopDeviceMonitorThread();
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::GetDeviceMonitorState(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (!deviceMonitor_) {
+        return env.Null();
+    }
+
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("running", Napi::Boolean::New(env, deviceMonitor_->IsRunning()));
+    obj.Set("online", Napi::Boolean::New(env, deviceMonitor_->IsOnline()));
+    obj.Set("reconnectCount", Napi::Number::New(env, deviceMonitor_->ReconnectCount()));
+    obj.Set("lastReconnectUs", Napi::Number::New(env, static_cast<double>(deviceMonitor_->LastReconnectUs())));
+    return obj;
+}
+
+// ==================== UDS诊断 ====================
+
+namespace {
+
+Napi::Object UdsResultToObject(Napi::Env env, const UdsResult& result, bool doip) {
+    const ZCAN_UDS_RESPONSE& resp = result.response;
+
+    // 调用本身失败时驱动未填写响应
+    ZCAN_UDS_ERROR status = resp.status;
+    if (result.callStatus != STATUS_OK && status == ZCAN_UDS_ERROR_OK) {
+        status = ZCAN_UDS_ERROR_OTHTER;
+    }
+    const ZCAN_UDS_RESPONSE_TYPE type = status == ZCAN_UDS_ERROR_OK ? resp.type : ZCAN_UDS_RT_NONE;
+
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("reqId", Napi::Number::New(env, result.reqId));
+    obj.Set("status", Napi::Number::New(env, status));
+    obj.Set("type", Napi::Number::New(env, type));
+    if (type == ZCAN_UDS_RT_POSITIVE) {
+        obj.Set("sid", Napi::Number::New(env, resp.positive.sid));
+    } else if (type == ZCAN_UDS_RT_NEGATIVE) {
+        obj.Set("sid", Napi::Number::New(env, resp.negative.sid));
+        obj.Set("negativeCode", Napi::Number::New(env, resp.negative.error_code));
+    }
+
+    Napi::Array data = Napi::Array::New(env, result.data.size());
+    for (size_t i = 0; i < result.data.size(); i++) {
+        data[i] = Napi::Number::New(env, result.data[i]);
+    }
+    obj.Set("data", data);
+
+    Napi::Object timing = Napi::Object::New(env);
+    timing.Set("queuedUs", Napi::Number::New(env, static_cast<double>(result.queuedUs)));
+    timing.Set("requestUs", Napi::Number::New(env, static_cast<double>(result.requestUs)));
+    timing.Set("totalUs", Napi::Number::New(env, static_cast<double>(result.queuedUs + result.requestUs)));
+    if (doip) {
+        timing.Set("connectionReused", Napi::Boolean::New(env, result.connectionReused));
+    }
+    obj.Set("timing", timing);
+    return obj;
+}
+
+}  // namespace
+
+Napi::Value ZlgCanDevice::UdsRequestAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (deviceHandle_ == INVALID_DEVICE_HANDLE) {
+        Napi::Error::New(env, "设备未打开").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        Napi::TypeError::New(env, "需要1个参数: request").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Object req = info[0].As<Napi::Object>();
+    if (!req.Has("channel") || !req.Has("srcAddr") || !req.Has("dstAddr") || !req.Has("sid")) {
+        Napi::TypeError::New(env, "request需要channel, srcAddr, dstAddr, sid").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    ZCAN_UDS_REQUEST request;
+    memset(&request, 0, sizeof(request));
+    request.channel = static_cast<BYTE>(req.Get("channel").As<Napi::Number>().Uint32Value());
+    request.frame_type = req.Has("frameType")
+        ? static_cast<BYTE>(req.Get("frameType").As<Napi::Number>().Uint32Value()) : ZCAN_UDS_FRAME_CAN;
+    request.src_addr = req.Get("srcAddr").As<Napi::Number>().Uint32Value();
+    request.dst_addr = req.Get("dstAddr").As<Napi::Number>().Uint32Value();
+    request.suppress_response = req.Has("suppressResponse") && req.Get("suppressResponse").ToBoolean() ? 1 : 0;
+    request.sid = static_cast<BYTE>(req.Get("sid").As<Napi::Number>().Uint32Value());
+
+    // 会话层参数
+    request.session_param.timeout = req.Has("timeoutMs")
+        ? req.Get("timeoutMs").As<Napi::Number>().Uint32Value() : 1000;
+    request.session_param.enhanced_timeout = req.Has("enhancedTimeoutMs")
+        ? req.Get("enhancedTimeoutMs").As<Napi::Number>().Uint32Value() : 5000;
+    request.session_param.check_any_negative_response =
+        req.Has("checkAnyNegativeResponse") && req.Get("checkAnyNegativeResponse").ToBoolean() ? 1 : 0;
+    request.session_param.wait_if_suppress_response =
+        req.Has("waitIfSuppressResponse") && req.Get("waitIfSuppressResponse").ToBoolean() ? 1 : 0;
+
+    // 传输层参数
+    const bool isFD = request.frame_type != ZCAN_UDS_FRAME_CAN;
+    request.trans_param.version = ZCAN_UDS_TRANS_VER_0;
+    request.trans_param.max_data_len = isFD ? 64 : 8;
+    request.trans_param.fill_byte = 0xCC;
+    request.trans_param.fc_timeout = 1000;
+    request.trans_param.fill_mode = ZCAN_UDS_FILL_MODE_SHORT;
+    if (req.Has("transport") && req.Get("transport").IsObject()) {
+        Napi::Object tp = req.Get("transport").As<Napi::Object>();
+        if (tp.Has("version")) request.trans_param.version = static_cast<BYTE>(tp.Get("version").As<Napi::Number>().Uint32Value());
+        if (tp.Has("maxDataLen")) request.trans_param.max_data_len = static_cast<BYTE>(tp.Get("maxDataLen").As<Napi::Number>().Uint32Value());
+        if (tp.Has("localStMin")) request.trans_param.local_st_min = static_cast<BYTE>(tp.Get("localStMin").As<Napi::Number>().Uint32Value());
+        if (tp.Has("blockSize")) request.trans_param.block_size = static_cast<BYTE>(tp.Get("blockSize").As<Napi::Number>().Uint32Value());
+        if (tp.Has("fillByte")) request.trans_param.fill_byte = static_cast<BYTE>(tp.Get("fillByte").As<Napi::Number>().Uint32Value());
+        if (tp.Has("extFrame")) request.trans_param.ext_frame = tp.Get("extFrame").ToBoolean() ? 1 : 0;
+        if (tp.Has("remoteStMin")) {
+            request.trans_param.is_modify_ecu_st_min = 1;
+            request.trans_param.remote_st_min = static_cast<BYTE>(tp.Get("remoteStMin").As<Napi::Number>().Uint32Value());
+        }
+        if (tp.Has("fcTimeoutMs")) request.trans_param.fc_timeout = tp.Get("fcTimeoutMs").As<Napi::Number>().Uint32Value();
+        if (tp.Has("fillMode")) request.trans_param.fill_mode = static_cast<BYTE>(tp.Get("fillMode").As<Napi::Number>().Uint32Value());
+    }
+
+    std::vector<BYTE> payload;
+    if (req.Has("data") && req.Get("data").IsArray()) {
+        Napi::Array data = req.Get("data").As<Napi::Array>();
+        payload.resize(data.Length());
+        for (uint32_t i = 0; i < data.Length(); i++) {
+            payload[i] = static_cast<BYTE>(data.Get(i).As<Napi::Number>().Uint32Value());
+        }
+    }
+
+    UINT maxResponseLength = req.Has("maxResponseLength")
+        ? req.Get("maxResponseLength").As<Napi::Number>().Uint32Value() : 4095;
+
+    // 参数校验完成后才分配ID，分配后请求登记为在途，Promise上的reqId可立即用于取消
+    request.req_id = udsClient_.AllocateRequestId(DEF_CAN_UDS_DATA);
+
+    DEVICE_HANDLE deviceHandle = deviceHandle_;
+    UdsClient* client = &udsClient_;
+    Napi::Value promise = RunBlockingAsync<std::shared_ptr<UdsResult>>(env, "udsRequest", 0,
+        [client, deviceHandle, request, payload, maxResponseLength]() {
+            return std::make_shared<UdsResult>(client->Request(deviceHandle, request, payload, maxResponseLength));
+        },
+        [](Napi::Env env, std::shared_ptr<UdsResult> result) -> Napi::Value {
+            return UdsResultToObject(env, *result, false);
+        },
+        nullptr);
+    promise.As<Napi::Object>().Set("reqId", Napi::Number::New(env, request.req_id));
+    return promise;
+}
+
+Napi::Value ZlgCanDevice::UdsCancel(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: reqId").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (deviceHandle_ == INVALID_DEVICE_HANDLE) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    UINT reqId = info[0].As<Napi::Number>().Uint32Value();
+    return Napi::Boolean::New(env, udsClient_.Cancel(deviceHandle_, reqId));
+}
+
+// ==================== DoIP诊断 ====================
+
+Napi::Value ZlgCanDevice::DoipRequestAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (deviceHandle_ == INVALID_DEVICE_HANDLE) {
+        Napi::Error::New(env, "设备未打开").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        Napi::TypeError::New(env, "需要1个参数: request").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Object req = info[0].As<Napi::Object>();
+    if (!req.Has("serverAddress") || !req.Has("sourceAddress") || !req.Has("targetAddress") || !req.Has("sid")) {
+        Napi::TypeError::New(env, "request需要serverAddress, sourceAddress, targetAddress, sid").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    ZDOIP_REQUEST request;
+    memset(&request, 0, sizeof(request));
+
+    std::string serverAddress = req.Get("serverAddress").As<Napi::String>().Utf8Value();
+    if (serverAddress.empty() || serverAddress.size() >= sizeof(request.serverAddress)) {
+        Napi::TypeError::New(env, "serverAddress长度需为1~31").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    memcpy(request.serverAddress, serverAddress.c_str(), serverAddress.size());
+
+    request.doipVersion = req.Has("doipVersion")
+        ? static_cast<BYTE>(req.Get("doipVersion").As<Napi::Number>().Uint32Value())
+        : static_cast<BYTE>(ZCAN_DOIP_AUTO_DETECTED_VERSION);
+    request.rcType = req.Has("activationType")
+        ? static_cast<BYTE>(req.Get("activationType").As<Napi::Number>().Uint32Value())
+        : static_cast<BYTE>(ZCAN_DOIP_ACTIVATION_DEFAULT);
+
+    // 逻辑地址按DoIP报文字节序（大端）存放
+    UINT sourceAddress = req.Get("sourceAddress").As<Napi::Number>().Uint32Value();
+    UINT targetAddress = req.Get("targetAddress").As<Napi::Number>().Uint32Value();
+    request.sourceAddress[0] = static_cast<BYTE>(sourceAddress >> 8);
+    request.sourceAddress[1] = static_cast<BYTE>(sourceAddress);
+    request.targetAddress[0] = static_cast<BYTE>(targetAddress >> 8);
+    request.targetAddress[1] = static_cast<BYTE>(targetAddress);
+
+    request.connectTimeoutMs = static_cast<USHORT>(req.Has("connectTimeoutMs")
+        ? req.Get("connectTimeoutMs").As<Napi::Number>().Uint32Value() : 2000);
+    request.routingTimeoutMs = static_cast<USHORT>(req.Has("routingTimeoutMs")
+        ? req.Get("routingTimeoutMs").As<Napi::Number>().Uint32Value() : 2000);
+    request.requestTimeoutMs = req.Has("requestTimeoutMs")
+        ? req.Get("requestTimeoutMs").As<Napi::Number>().Uint32Value() : 5000;
+    request.sid = static_cast<BYTE>(req.Get("sid").As<Napi::Number>().Uint32Value());
+    request.suppressPosResp = req.Has("suppressResponse") && req.Get("suppressResponse").ToBoolean() ? 1 : 0;
+    request.waitForNegResp = req.Has("waitIfSuppressResponse") && req.Get("waitIfSuppressResponse").ToBoolean() ? 1 : 0;
+
+    std::vector<BYTE> payload;
+    if (req.Has("data") && req.Get("data").IsArray()) {
+        Napi::Array data = req.Get("data").As<Napi::Array>();
+        payload.resize(data.Length());
+        for (uint32_t i = 0; i < data.Length(); i++) {
+            payload[i] = static_cast<BYTE>(data.Get(i).As<Napi::Number>().Uint32Value());
+        }
+    }
+
+    // DoIP没有ISO-TP的4095字节限制，大DID读取需要更大的缓冲区
+    UINT maxResponseLength = req.Has("maxResponseLength")
+        ? req.Get("maxResponseLength").As<Napi::Number>().Uint32Value() : 65535;
+
+    // 参数校验完成后才分配ID，分配后请求登记为在途，Promise上的reqId可立即用于取消
+    request.req_id = udsClient_.AllocateRequestId(DEF_DOIP_UDS_DATA);
+
+    DEVICE_HANDLE deviceHandle = deviceHandle_;
+    UdsClient* client = &udsClient_;
+    Napi::Value promise = RunBlockingAsync<std::shared_ptr<UdsResult>>(env, "doipRequest", 0,
+        [client, deviceHandle, request, payload, maxResponseLength]() {
+            return std::make_shared<UdsResult>(client->DoipRequest(deviceHandle, request, payload, maxResponseLength));
+        },
+        [](Napi::Env env, std::shared_ptr<UdsResult> result) -> Napi::Value {
+            return UdsResultToObject(env, *result, true);
+        },
+        nullptr);
+    promise.As<Napi::Object>().Set("reqId", Napi::Number::New(env, request.req_id));
+    return promise;
+}
+
+Napi::Value ZlgCanDevice::GetDoipConnections(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    std::vector<DoipConnectionStats> connections = udsClient_.DoipConnections();
+    Napi::Array arr = Napi::Array::New(env, connections.size());
+    for (size_t i = 0; i < connections.size(); i++) {
+        const DoipConnectionStats& stats = connections[i];
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("serverAddress", Napi::String::New(env, stats.serverAddress));
+        obj.Set("sourceAddress", Napi::Number::New(env, stats.sourceAddress));
+        obj.Set("doipVersion", Napi::Number::New(env, stats.doipVersion));
+        obj.Set("activationType", Napi::Number::New(env, stats.activationType));
+        obj.Set("established", Napi::Boolean::New(env, stats.established));
+        obj.Set("connects", Napi::Number::New(env, stats.connects));
+        obj.Set("requests", Napi::Number::New(env, stats.requests));
+        obj.Set("failures", Napi::Number::New(env, stats.failures));
+        obj.Set("inFlight", Napi::Number::New(env, stats.inFlight));
+        obj.Set("maxInFlight", Napi::Number::New(env, stats.maxInFlight));
+        obj.Set("bytesSent", Napi::Number::New(env, static_cast<double>(stats.bytesSent)));
+        obj.Set("bytesReceived", Napi::Number::New(env, static_cast<double>(stats.bytesReceived)));
+        obj.Set("lastConnectRequestUs", Napi::Number::New(env, static_cast<double>(stats.lastConnectRequestUs)));
+        obj.Set("totalRequestUs", Napi::Number::New(env, static_cast<double>(stats.totalRequestUs)));
+        arr[static_cast<uint32_t>(i)] = obj;
+    }
+    return arr;
+}
+
+// ==================== 接收线程 ====================
+
+ReceivePump* ZlgCanDevice::FindReceivePump(CHANNEL_HANDLE channelHandle) {
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        return nullptr;
+    }
+    auto it = receiveChannels_.find(channelIndex);
+    return it == receiveChannels_.end() ? nullptr : it->second.pump.get();
+}
+
+UINT ZlgCanDevice::PopPumpedData(ZCANDataObj* dataObjs, UINT count) {
+    UINT popped = 0;
+    std::vector<ZCAN_ReceiveFD_Data> fdFrames;
+    std::vector<ZCAN_Receive_Data> canFrames;
+    for (auto& entry : receiveChannels_) {
+        ReceivePump* pump = entry.second.pump.get();
+        if (pump == nullptr || !pump->IsRunning() || popped >= count) {
+            continue;
+        }
+        const BYTE chnl = static_cast<BYTE>(entry.first);
+
+        fdFrames.resize(count - popped);
+        const UINT fdCount = pump->PopCanFD(fdFrames.data(), count - popped, 0);
+        for (UINT i = 0; i < fdCount; i++) {
+            ZCANDataObj& obj = dataObjs[popped++];
+            memset(&obj, 0, sizeof(obj));
+            obj.dataType = ZCAN_DT_ZCAN_CAN_CANFD_DATA;
+            obj.chnl = chnl;
+            obj.data.zcanCANFDData.timeStamp = fdFrames[i].timestamp;
+            obj.data.zcanCANFDData.flag.unionVal.frameType = 1;
+            obj.data.zcanCANFDData.flag.unionVal.txEchoed = IS_TX_ECHO(fdFrames[i].frame.flags) ? 1 : 0;
+            obj.data.zcanCANFDData.frame = fdFrames[i].frame;
+        }
+
+        canFrames.resize(count - popped);
+        const UINT canCount = popped < count ? pump->PopCan(canFrames.data(), count - popped, 0) : 0;
+        for (UINT i = 0; i < canCount; i++) {
+            ZCANDataObj& obj = dataObjs[popped++];
+            memset(&obj, 0, sizeof(obj));
+            obj.dataType = ZCAN_DT_ZCAN_CAN_CANFD_DATA;
+            obj.chnl = chnl;
+            obj.data.zcanCANFDData.timeStamp = canFrames[i].timestamp;
+            obj.data.zcanCANFDData.flag.unionVal.txEchoed = IS_TX_ECHO(canFrames[i].frame.__pad) ? 1 : 0;
+            obj.data.zcanCANFDData.frame.can_id = canFrames[i].frame.can_id;
+            obj.data.zcanCANFDData.frame.len = canFrames[i].frame.can_dlc;
+            obj.data.zcanCANFDData.frame.flags = canFrames[i].frame.__pad;
+            memcpy(obj.data.zcanCANFDData.frame.data, canFrames[i].frame.data, CAN_MAX_DLEN);
+        }
+    }
+    return popped;
+}
+
+ZlgCanDevice::ReceiveChannelEntry& ZlgCanDevice::EnsureReceiveChannel(UINT channelIndex, CHANNEL_HANDLE channelHandle,
+                                                                      const ReceivePumpOptions& options) {
+    ReceiveChannelEntry* entry = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(handlesMutex_);
+        entry = &receiveChannels_[channelIndex];
+        if (entry->pump) {
+            return *entry;
+        }
+        entry->pump.reset(new ReceivePump(channelHandle, options));
+    }
+    entry->pump->Start();
+    RefreshPipelineSources();
+    return *entry;
+}
+
+std::shared_ptr<IsoTpEngine> ZlgCanDevice::EnsureIsoTpEngine(UINT channelIndex, CHANNEL_HANDLE channelHandle) {
+    // 流控须在接收线程中应答，未启动时以默认参数启动
+    ReceiveChannelEntry& entry = EnsureReceiveChannel(channelIndex, channelHandle, ReceivePumpOptions());
+    if (!entry.isotp) {
+        {
+            std::lock_guard<std::mutex> lock(handlesMutex_);
+            entry.isotp = std::make_shared<IsoTpEngine>(channelHandle);
+        }
+        entry.pump->AddListener(entry.isotp.get());
+    }
+    return entry.isotp;
+}
+
+void ZlgCanDevice::CloseIsoTpSession(UINT sessionId) {
+    auto it = isotpSessions_.find(sessionId);
+    if (it == isotpSessions_.end()) {
+        return;
+    }
+    auto channelIt = receiveChannels_.find(it->second.channelIndex);
+    if (channelIt != receiveChannels_.end() && channelIt->second.isotp) {
+        // 返回后接收线程不会再为该会话入队事件
+        channelIt->second.isotp->RemoveSession(sessionId);
+    }
+    it->second.tsfn.Release();
+    isotpSessions_.erase(it);
+}
+
+void ZlgCanDevice::StopJ1939Engine(ReceiveChannelEntry& entry) {
+    if (!entry.j1939) {
+        return;
+    }
+    // RemoveListener返回后接收线程不会再上报批次，之后才能释放回调
+    entry.j1939->Close();
+    entry.pump->RemoveListener(entry.j1939.get());
+    entry.j1939Tsfn.Release();
+    // 引擎在锁外析构
+    std::shared_ptr<J1939Engine> retired;
+    {
+        std::lock_guard<std::mutex> lock(handlesMutex_);
+        retired = std::move(entry.j1939);
+    }
+}
+
+void ZlgCanDevice::StopXcpMaster(ReceiveChannelEntry& entry) {
+    if (!entry.xcp) {
+        return;
+    }
+    entry.xcp->Close();
+    entry.pump->RemoveListener(entry.xcp.get());
+    entry.xcpTsfn.Release();
+    // 引擎在锁外析构
+    std::shared_ptr<XcpMaster> retired;
+    {
+        std::lock_guard<std::mutex> lock(handlesMutex_);
+        retired = std::move(entry.xcp);
+    }
+}
+
+std::shared_ptr<XcpMaster> ZlgCanDevice::FindXcpMaster(CHANNEL_HANDLE channelHandle) {
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        return nullptr;
+    }
+    auto it = receiveChannels_.find(channelIndex);
+    return it == receiveChannels_.end() ? nullptr : it->second.xcp;
+}
+
+void ZlgCanDevice::StopCanOpenClient(ReceiveChannelEntry& entry) {
+    if (!entry.canopen) {
+        return;
+    }
+    entry.canopen->Close();
+    entry.pump->RemoveListener(entry.canopen.get());
+    entry.canopenTsfn.Release();
+    // 引擎在锁外析构
+    std::shared_ptr<CanOpenClient> retired;
+    {
+        std::lock_guard<std::mutex> lock(handlesMutex_);
+        retired = std::move(entry.canopen);
+    }
+}
+
+std::shared_ptr<CanOpenClient> ZlgCanDevice::FindCanOpenClient(CHANNEL_HANDLE channelHandle) {
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        return nullptr;
+    }
+    auto it = receiveChannels_.find(channelIndex);
+    return it == receiveChannels_.end() ? nullptr : it->second.canopen;
+}
+
+void ZlgCanDevice::StopE2eMonitor(ReceiveChannelEntry& entry) {
+    if (!entry.e2e) {
+        return;
+    }
+    entry.pump->RemoveListener(entry.e2e.get());
+    entry.e2e.reset();
+    if (entry.e2eTsfn) {
+        entry.e2eTsfn.Release();
+        entry.e2eTsfn = Napi::ThreadSafeFunction();
+    }
+}
+
+void ZlgCanDevice::CloseReceiveStreams(ReceiveChannelEntry& entry) {
+    for (auto& stream : entry.streamTsfns) {
+        entry.pump->CloseTap(stream.first);
+        // 线程停止时再通知一次，帧流据此发现缓冲已不存在并结束
+        stream.second.NonBlockingCall();
+        stream.second.Release();
+    }
+    entry.streamTsfns.clear();
+}
+
+void ZlgCanDevice::StopReceiveChannelAt(UINT channelIndex) {
+    auto it = receiveChannels_.find(channelIndex);
+    if (it == receiveChannels_.end()) {
+        return;
+    }
+
+    std::vector<UINT> sessionIds;
+    for (const auto& session : isotpSessions_) {
+        if (session.second.channelIndex == channelIndex) {
+            sessionIds.push_back(session.first);
+        }
+    }
+    for (UINT sessionId : sessionIds) {
+        CloseIsoTpSession(sessionId);
+    }
+    CancelFlashJob(channelIndex);
+
+    // 先移除监听者并停止线程，引擎可能仍被发送中的请求持有
+    if (it->second.isotp) {
+        it->second.pump->RemoveListener(it->second.isotp.get());
+    }
+    StopJ1939Engine(it->second);
+    StopXcpMaster(it->second);
+    StopCanOpenClient(it->second);
+    StopE2eMonitor(it->second);
+    CloseReceiveStreams(it->second);
+    RefreshPipelineSources(it->second.pump.get());
+    it->second.pump->Stop();
+    // 条目移出后在锁外析构，仍被发送中的请求持有的引擎不在持锁期间释放
+    ReceiveChannelEntry retired;
+    {
+        std::lock_guard<std::mutex> lock(handlesMutex_);
+        retired = std::move(it->second);
+        receiveChannels_.erase(it);
+    }
+}
+
+void ZlgCanDevice::StopAllReceiveChannels() {
+    while (!receiveChannels_.empty()) {
+        StopReceiveChannelAt(receiveChannels_.begin()->first);
+    }
+}
+
+Napi::Value ZlgCanDevice::StartReceiveThread(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (deviceHandle_ == INVALID_DEVICE_HANDLE) {
+        Napi::Error::New(env, "设备未打开").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要至少1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        Napi::Error::New(env, "通道未初始化").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (receiveChannels_.find(channelIndex) != receiveChannels_.end()) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    ReceivePumpOptions options;
+    if (info.Length() > 1 && info[1].IsObject()) {
+        Napi::Object opts = info[1].As<Napi::Object>();
+        if (opts.Has("ringCapacity")) options.ringCapacity = opts.Get("ringCapacity").As<Napi::Number>().Uint32Value();
+        if (opts.Has("batchSize")) options.batchSize = opts.Get("batchSize").As<Napi::Number>().Uint32Value();
+        if (opts.Has("idleSleepUs")) options.idleSleepUs = opts.Get("idleSleepUs").As<Napi::Number>().Uint32Value();
+        if (opts.Has("minIdleSleepUs")) options.minIdleSleepUs = opts.Get("minIdleSleepUs").As<Napi::Number>().Uint32Value();
+        if (opts.Has("blockWaitMs")) options.blockWaitMs = opts.Get("blockWaitMs").As<Napi::Number>().Uint32Value();
+        if (opts.Has("sharedRing")) options.sharedRing = opts.Get("sharedRing").As<Napi::Boolean>().Value();
+        if (opts.Has("mode") && !ParseReceiveMode(opts.Get("mode").As<Napi::String>().Utf8Value(), &options.mode)) {
+            Napi::TypeError::New(env, "mode必须为blocking、adaptive或busyPoll").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        if (opts.Has("dropPolicy") &&
+            !ParseRingDropPolicy(opts.Get("dropPolicy").As<Napi::String>().Utf8Value(), &options.dropPolicy)) {
+            Napi::TypeError::New(env, "dropPolicy必须为dropOldest或dropNewest").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+    }
+
+    EnsureReceiveChannel(channelIndex, channelHandle, options);
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::StopReceiveThread(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex) ||
+        receiveChannels_.find(channelIndex) == receiveChannels_.end()) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    StopReceiveChannelAt(channelIndex);
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::GetReceiveThreadStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    ReceivePump* pump = FindReceivePump(channelHandle);
+    if (pump == nullptr) {
+        return env.Null();
+    }
+
+    ReceivePumpStats stats = pump->Stats();
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("framesReceived", Napi::Number::New(env, static_cast<double>(stats.framesReceived)));
+    obj.Set("framesClaimed", Napi::Number::New(env, static_cast<double>(stats.framesClaimed)));
+    obj.Set("framesDropped", Napi::Number::New(env, static_cast<double>(stats.framesDropped)));
+    obj.Set("wakeups", Napi::Number::New(env, static_cast<double>(stats.wakeups)));
+    obj.Set("canRingDepth", Napi::Number::New(env, static_cast<double>(stats.canRingDepth)));
+    obj.Set("fdRingDepth", Napi::Number::New(env, static_cast<double>(stats.fdRingDepth)));
+    obj.Set("ringCapacity", Napi::Number::New(env, pump->RingCapacity()));
+    obj.Set("dropPolicy", Napi::String::New(env, RingDropPolicyName(pump->DropPolicy())));
+    obj.Set("mode", Napi::String::New(env, ReceiveModeName(stats.mode)));
+    obj.Set("uptimeUs", Napi::Number::New(env, static_cast<double>(stats.uptimeUs)));
+    obj.Set("cpuTimeUs", Napi::Number::New(env, static_cast<double>(stats.cpuTimeUs)));
+    Napi::Object latency = Napi::Object::New(env);
+    latency.Set("samples", Napi::Number::New(env, static_cast<double>(stats.latencySamples)));
+    latency.Set("p50Us", Napi::Number::New(env, stats.latencyP50Us));
+    latency.Set("p99Us", Napi::Number::New(env, stats.latencyP99Us));
+    latency.Set("maxUs", Napi::Number::New(env, stats.latencyMaxUs));
+    obj.Set("pickupLatency", latency);
+    return obj;
+}
+
+Napi::Value ZlgCanDevice::OpenReceiveStream(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 3 || !info[2].IsFunction()) {
+        Napi::TypeError::New(env, "需要3个参数: channelHandle, options, callback").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT capacity = ReceivePumpOptions().ringCapacity;
+    RingDropPolicy dropPolicy = RingDropPolicy::DropOldest;
+    if (info[1].IsObject()) {
+        Napi::Object opts = info[1].As<Napi::Object>();
+        if (opts.Has("capacity")) capacity = opts.Get("capacity").As<Napi::Number>().Uint32Value();
+        if (opts.Has("dropPolicy") &&
+            !ParseRingDropPolicy(opts.Get("dropPolicy").As<Napi::String>().Utf8Value(), &dropPolicy)) {
+            Napi::TypeError::New(env, "dropPolicy必须为dropOldest或dropNewest").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+    }
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        return env.Null();
+    }
+    auto it = receiveChannels_.find(channelIndex);
+    if (it == receiveChannels_.end()) {
+        return env.Null();
+    }
+    ReceiveChannelEntry& entry = it->second;
+
+    Napi::ThreadSafeFunction tsfn = Napi::ThreadSafeFunction::New(
+        env, info[2].As<Napi::Function>(), "ZlgCanReceiveStream", 0, 1);
+    tsfn.Unref(env);
+    const UINT streamId = entry.pump->OpenTap(capacity, dropPolicy, [tsfn]() {
+        tsfn.NonBlockingCall();
+    });
+    entry.streamTsfns[streamId] = tsfn;
+    return Napi::Number::New(env, streamId);
+}
+
+Napi::Value ZlgCanDevice::ReadReceiveStream(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 3) {
+        Napi::TypeError::New(env, "需要3个参数: channelHandle, streamId, count").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    const UINT streamId = info[1].As<Napi::Number>().Uint32Value();
+    const UINT count = info[2].As<Napi::Number>().Uint32Value();
+
+    ReceivePump* pump = FindReceivePump(channelHandle);
+    ReceiveTapStats tapStats;
+    if (pump == nullptr || !pump->TapStats(streamId, &tapStats)) {
+        return env.Null();
+    }
+
+    std::vector<ZCAN_Receive_Data> canFrames(count);
+    std::vector<ZCAN_ReceiveFD_Data> fdFrames(count);
+    const UINT canCount = pump->PopTapCan(streamId, canFrames.data(), count);
+    const UINT fdCount = pump->PopTapCanFD(streamId, fdFrames.data(), count);
+
+    Napi::Array frames = Napi::Array::New(env, canCount);
+    for (UINT i = 0; i < canCount; i++) {
+        frames[i] = ReceivedCanToObject(env, canFrames[i]);
+    }
+    Napi::Array fdArr = Napi::Array::New(env, fdCount);
+    for (UINT i = 0; i < fdCount; i++) {
+        fdArr[i] = ReceivedFdToObject(env, fdFrames[i]);
+    }
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("frames", frames);
+    result.Set("fdFrames", fdArr);
+    result.Set("dropped", Napi::Number::New(env, static_cast<double>(tapStats.dropped)));
+    return result;
+}
+
+Napi::Value ZlgCanDevice::ArmReceiveStream(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2) {
+        Napi::TypeError::New(env, "需要2个参数: channelHandle, streamId").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    ReceivePump* pump = FindReceivePump(channelHandle);
+    if (pump == nullptr) {
+        return Napi::Boolean::New(env, false);
+    }
+    return Napi::Boolean::New(env, pump->ArmTap(info[1].As<Napi::Number>().Uint32Value()));
+}
+
+Napi::Value ZlgCanDevice::CloseReceiveStream(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2) {
+        Napi::TypeError::New(env, "需要2个参数: channelHandle, streamId").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        return Napi::Boolean::New(env, false);
+    }
+    auto it = receiveChannels_.find(channelIndex);
+    if (it == receiveChannels_.end()) {
+        return Napi::Boolean::New(env, false);
+    }
+    ReceiveChannelEntry& entry = it->second;
+    auto stream = entry.streamTsfns.find(info[1].As<Napi::Number>().Uint32Value());
+    if (stream == entry.streamTsfns.end()) {
+        return Napi::Boolean::New(env, false);
+    }
+    entry.pump->CloseTap(stream->first);
+    stream->second.Release();
+    entry.streamTsfns.erase(stream);
+    return Napi::Boolean::New(env, true);
+}
+
+// ==================== ISO-TP传输层 ====================
+
+namespace {
+
+void CallIsoTpCallback(Napi::Env env, Napi::Function callback, IsoTpEvent* event) {
+    if (env != nullptr && callback != nullptr) {
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("type", Napi::String::New(env, event->type == IsoTpEvent::Type::Message ? "message" : "error"));
+        obj.Set("sessionId", Napi::Number::New(env, event->sessionId));
+        Napi::Array data = Napi::Array::New(env, event->data.size());
+        for (size_t i = 0; i < event->data.size(); i++) {
+            data[static_cast<uint32_t>(i)] = Napi::Number::New(env, event->data[i]);
+        }
+        obj.Set("data", data);
+        obj.Set("timestamp", Napi::Number::New(env, static_cast<double>(event->timestamp)));
+        obj.Set("durationUs", Napi::Number::New(env, static_cast<double>(event->durationUs)));
+        if (!event->error.empty()) {
+            obj.Set("error", Napi::String::New(env, event->error));
+        }
+        callback.Call({obj});
+    }
+    delete event;
+}
+
+// options需已包含txId, rxId
+void ParseIsoTpOptions(const Napi::Object& opts, IsoTpOptions* options) {
+    options->txId = opts.Get("txId").As<Napi::Number>().Uint32Value();
+    options->rxId = opts.Get("rxId").As<Napi::Number>().Uint32Value();
+    if (opts.Has("fd")) options->fd = opts.Get("fd").ToBoolean();
+    if (opts.Has("brs")) options->brs = opts.Get("brs").ToBoolean();
+    if (opts.Has("txDataLength")) options->txDataLength = static_cast<BYTE>(opts.Get("txDataLength").As<Napi::Number>().Uint32Value());
+    if (opts.Has("padding")) {
+        Napi::Value padding = opts.Get("padding");
+        options->padding = padding.IsNumber() ? static_cast<int>(padding.As<Napi::Number>().Uint32Value() & 0xFF) : -1;
+    }
+    if (opts.Has("blockSize")) options->blockSize = static_cast<BYTE>(opts.Get("blockSize").As<Napi::Number>().Uint32Value());
+    if (opts.Has("stMinUs")) options->stMinUs = opts.Get("stMinUs").As<Napi::Number>().Uint32Value();
+    if (opts.Has("stMinOverrideUs")) options->stMinOverrideUs = opts.Get("stMinOverrideUs").As<Napi::Number>().Int32Value();
+    if (opts.Has("nBsTimeoutMs")) options->nBsTimeoutMs = opts.Get("nBsTimeoutMs").As<Napi::Number>().Uint32Value();
+    if (opts.Has("nCrTimeoutMs")) options->nCrTimeoutMs = opts.Get("nCrTimeoutMs").As<Napi::Number>().Uint32Value();
+    if (opts.Has("maxWaitFrames")) options->maxWaitFrames = opts.Get("maxWaitFrames").As<Napi::Number>().Uint32Value();
+    if (opts.Has("maxMessageLength")) options->maxMessageLength = opts.Get("maxMessageLength").As<Napi::Number>().Uint32Value();
+}
+
+}  // namespace
+
+Napi::Value ZlgCanDevice::IsoTpOpen(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (deviceHandle_ == INVALID_DEVICE_HANDLE) {
+        Napi::Error::New(env, "设备未打开").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() < 3 || !info[1].IsObject() || !info[2].IsFunction()) {
+        Napi::TypeError::New(env, "需要3个参数: channelHandle, options, callback").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        Napi::Error::New(env, "通道未初始化").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Object opts = info[1].As<Napi::Object>();
+    if (!opts.Has("txId") || !opts.Has("rxId")) {
+        Napi::TypeError::New(env, "options需要txId, rxId").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    IsoTpOptions options;
+    ParseIsoTpOptions(opts, &options);
+
+    std::shared_ptr<IsoTpEngine> engine = EnsureIsoTpEngine(channelIndex, channelHandle);
+
+    const UINT sessionId = nextIsoTpSessionId_++;
+    Napi::ThreadSafeFunction tsfn = Napi::ThreadSafeFunction::New(
+        env, info[2].As<Napi::Function>(), "ZlgCanIsoTp", 0, 1);
+    // 会话不应阻止进程退出
+    tsfn.Unref(env);
+
+    bool added = engine->AddSession(sessionId, options, [tsfn](const IsoTpEvent& event) {
+        IsoTpEvent* copy = new IsoTpEvent(event);
+        if (tsfn.NonBlockingCall(copy, CallIsoTpCallback) != napi_ok) {
+            delete copy;
+        }
+    });
+    if (!added) {
+        tsfn.Release();
+        Napi::Error::New(env, "接收ID已被该通道的其他ISO-TP会话使用").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    isotpSessions_[sessionId] = {channelIndex, tsfn};
+    return Napi::Number::New(env, sessionId);
+}
+
+Napi::Value ZlgCanDevice::IsoTpClose(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: sessionId").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    UINT sessionId = info[0].As<Napi::Number>().Uint32Value();
+    if (isotpSessions_.find(sessionId) == isotpSessions_.end()) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    CloseIsoTpSession(sessionId);
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::IsoTpSendAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[1].IsArray()) {
+        Napi::TypeError::New(env, "需要2个参数: sessionId, data").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    UINT sessionId = info[0].As<Napi::Number>().Uint32Value();
+    auto it = isotpSessions_.find(sessionId);
+    if (it == isotpSessions_.end()) {
+        Napi::Error::New(env, "ISO-TP会话不存在").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    std::shared_ptr<IsoTpEngine> engine = receiveChannels_[it->second.channelIndex].isotp;
+
+    Napi::Array data = info[1].As<Napi::Array>();
+    std::vector<BYTE> payload(data.Length());
+    for (uint32_t i = 0; i < data.Length(); i++) {
+        payload[i] = static_cast<BYTE>(data.Get(i).As<Napi::Number>().Uint32Value());
+    }
+
+    return RunBlockingAsync<IsoTpSendResult>(env, "isotpSend", 0,
+        [engine, sessionId, payload]() {
+            return engine->Send(sessionId, payload);
+        },
+        [payload](Napi::Env env, IsoTpSendResult result) -> Napi::Value {
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("success", Napi::Boolean::New(env, result.success));
+            if (!result.success) {
+                obj.Set("error", Napi::String::New(env, result.error));
+            }
+            obj.Set("frames", Napi::Number::New(env, result.frames));
+            obj.Set("durationUs", Napi::Number::New(env, static_cast<double>(result.durationUs)));
+            obj.Set("fcWaitUs", Napi::Number::New(env, static_cast<double>(result.fcWaitUs)));
+            obj.Set("remoteBlockSize", Napi::Number::New(env, result.remoteBlockSize));
+            obj.Set("remoteStMinUs", Napi::Number::New(env, static_cast<double>(result.remoteStMinUs)));
+            obj.Set("bytesPerSec", Napi::Number::New(env, result.durationUs > 0
+                ? static_cast<double>(payload.size()) * 1000000.0 / static_cast<double>(result.durationUs) : 0));
+            return obj;
+        },
+        nullptr);
+}
+
+Napi::Value ZlgCanDevice::IsoTpGetStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: sessionId").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    UINT sessionId = info[0].As<Napi::Number>().Uint32Value();
+    auto it = isotpSessions_.find(sessionId);
+    if (it == isotpSessions_.end()) {
+        return env.Null();
+    }
+
+    IsoTpStats stats;
+    if (!receiveChannels_[it->second.channelIndex].isotp->GetStats(sessionId, &stats)) {
+        return env.Null();
+    }
+
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("txMessages", Napi::Number::New(env, static_cast<double>(stats.txMessages)));
+    obj.Set("rxMessages", Napi::Number::New(env, static_cast<double>(stats.rxMessages)));
+    obj.Set("txBytes", Napi::Number::New(env, static_cast<double>(stats.txBytes)));
+    obj.Set("rxBytes", Napi::Number::New(env, static_cast<double>(stats.rxBytes)));
+    obj.Set("txErrors", Napi::Number::New(env, static_cast<double>(stats.txErrors)));
+    obj.Set("rxErrors", Napi::Number::New(env, static_cast<double>(stats.rxErrors)));
+    obj.Set("lastTxUs", Napi::Number::New(env, static_cast<double>(stats.lastTxUs)));
+    obj.Set("lastRxUs", Napi::Number::New(env, static_cast<double>(stats.lastRxUs)));
+    obj.Set("lastTxBytesPerSec", Napi::Number::New(env, stats.lastTxBytesPerSec));
+    obj.Set("lastRxBytesPerSec", Napi::Number::New(env, stats.lastRxBytesPerSec));
+    obj.Set("lastFcResponseUs", Napi::Number::New(env, static_cast<double>(stats.lastFcResponseUs)));
+    obj.Set("maxFcResponseUs", Napi::Number::New(env, static_cast<double>(stats.maxFcResponseUs)));
+    obj.Set("lastFcWaitUs", Napi::Number::New(env, static_cast<double>(stats.lastFcWaitUs)));
+    return obj;
+}
+
+// ==================== 在线烧写 ====================
+
+namespace {
+
+void CallFlashProgressCallback(Napi::Env env, Napi::Function callback, FlashProgress* progress) {
+    if (env != nullptr && callback != nullptr) {
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("segmentIndex", Napi::Number::New(env, progress->segmentIndex));
+        obj.Set("segmentCount", Napi::Number::New(env, progress->segmentCount));
+        obj.Set("bytesSent", Napi::Number::New(env, static_cast<double>(progress->bytesSent)));
+        obj.Set("totalBytes", Napi::Number::New(env, static_cast<double>(progress->totalBytes)));
+        obj.Set("bytesPerSec", Napi::Number::New(env, progress->bytesPerSec));
+        obj.Set("blockLength", Napi::Number::New(env, progress->blockLength));
+        obj.Set("stMinUs", Napi::Number::New(env, progress->stMinUs));
+        obj.Set("retries", Napi::Number::New(env, progress->retries));
+        obj.Set("elapsedUs", Napi::Number::New(env, static_cast<double>(progress->elapsedUs)));
+        callback.Call({obj});
+    }
+    delete progress;
+}
+
+bool ParseFirmwareFormat(const std::string& name, FirmwareFormat* format) {
+    if (name == "auto") {
+        *format = FirmwareFormat::Auto;
+    } else if (name == "hex") {
+        *format = FirmwareFormat::IntelHex;
+    } else if (name == "srec") {
+        *format = FirmwareFormat::SRecord;
+    } else if (name == "bin") {
+        *format = FirmwareFormat::Binary;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+void ZlgCanDevice::CancelFlashJob(UINT channelIndex) {
+    auto it = flashJobs_.find(channelIndex);
+    if (it == flashJobs_.end()) {
+        return;
+    }
+    // 移除会话使进行中的发送立即返回，烧写线程随后以"已取消"结束
+    it->second.pipeline->Cancel();
+    it->second.engine->RemoveSession(it->second.sessionId);
+    flashJobs_.erase(it);
+}
+
+Napi::Value ZlgCanDevice::FlashAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (deviceHandle_ == INVALID_DEVICE_HANDLE) {
+        Napi::Error::New(env, "设备未打开").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() < 2 || !info[1].IsObject()) {
+        Napi::TypeError::New(env, "需要至少2个参数: channelHandle, options").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        Napi::Error::New(env, "通道未初始化").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (flashJobs_.find(channelIndex) != flashJobs_.end()) {
+        Napi::Error::New(env, "该通道正在烧写").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Object opts = info[1].As<Napi::Object>();
+    if (!opts.Has("file") || !opts.Has("txId") || !opts.Has("rxId")) {
+        Napi::TypeError::New(env, "options需要file, txId, rxId").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    const std::string path = opts.Get("file").As<Napi::String>().Utf8Value();
+    FirmwareFormat format = FirmwareFormat::Auto;
+    if (opts.Has("format") &&
+        !ParseFirmwareFormat(opts.Get("format").As<Napi::String>().Utf8Value(), &format)) {
+        Napi::TypeError::New(env, "format须为auto, hex, srec或bin").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    const uint32_t baseAddress = opts.Has("baseAddress") ? opts.Get("baseAddress").As<Napi::Number>().Uint32Value() : 0;
+
+    IsoTpOptions transport;
+    ParseIsoTpOptions(opts, &transport);
+
+    FlashOptions options;
+    if (opts.Has("dataFormatIdentifier")) options.dataFormatIdentifier = static_cast<BYTE>(opts.Get("dataFormatIdentifier").As<Napi::Number>().Uint32Value());
+    if (opts.Has("addressAndLengthFormat")) options.addressAndLengthFormat = static_cast<BYTE>(opts.Get("addressAndLengthFormat").As<Napi::Number>().Uint32Value());
+    if (opts.Has("maxBlockLength")) options.maxBlockLength = opts.Get("maxBlockLength").As<Napi::Number>().Uint32Value();
+    if (opts.Has("p2TimeoutMs")) options.p2TimeoutMs = opts.Get("p2TimeoutMs").As<Napi::Number>().Uint32Value();
+    if (opts.Has("p2StarTimeoutMs")) options.p2StarTimeoutMs = opts.Get("p2StarTimeoutMs").As<Napi::Number>().Uint32Value();
+    if (opts.Has("autoTuneStMin")) options.autoTuneStMin = opts.Get("autoTuneStMin").ToBoolean();
+    if (opts.Has("maxRetries")) options.maxRetries = opts.Get("maxRetries").As<Napi::Number>().Uint32Value();
+    if (opts.Has("pipelineDepth")) options.pipelineDepth = opts.Get("pipelineDepth").As<Napi::Number>().Uint32Value();
+    if (opts.Has("progressIntervalMs")) options.progressIntervalMs = opts.Get("progressIntervalMs").As<Napi::Number>().Uint32Value();
+    if (opts.Has("checkMemoryRoutineId")) options.checkMemoryRoutineId = opts.Get("checkMemoryRoutineId").As<Napi::Number>().Uint32Value() & 0xFFFF;
+
+    Napi::ThreadSafeFunction progressTsfn;
+    FlashPipeline::ProgressCallback progress;
+    if (info.Length() > 2 && info[2].IsFunction()) {
+        progressTsfn = Napi::ThreadSafeFunction::New(env, info[2].As<Napi::Function>(), "ZlgCanFlashProgress", 0, 1);
+        progressTsfn.Unref(env);
+        progress = [progressTsfn](const FlashProgress& p) {
+            FlashProgress* copy = new FlashProgress(p);
+            if (progressTsfn.NonBlockingCall(copy, CallFlashProgressCallback) != napi_ok) {
+                delete copy;
+            }
+        };
+    }
+
+    std::shared_ptr<IsoTpEngine> engine = EnsureIsoTpEngine(channelIndex, channelHandle);
+    const UINT sessionId = nextIsoTpSessionId_++;
+    auto pipeline = std::make_shared<FlashPipeline>(engine, sessionId, path, format, baseAddress, options, progress);
+
+    std::weak_ptr<FlashPipeline> weak = pipeline;
+    bool added = engine->AddSession(sessionId, transport, [weak](const IsoTpEvent& event) {
+        if (auto target = weak.lock()) {
+            target->OnIsoTpEvent(event);
+        }
+    });
+    if (!added) {
+        if (progressTsfn) progressTsfn.Release();
+        Napi::Error::New(env, "接收ID已被该通道的其他ISO-TP会话使用").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    flashJobs_[channelIndex] = {pipeline, engine, sessionId};
+
+    return RunBlockingAsync<FlashResult>(env, "flash", 0,
+        [pipeline]() {
+            return pipeline->Run();
+        },
+        [this, channelIndex, pipeline, engine, sessionId, progressTsfn](Napi::Env env, FlashResult result) -> Napi::Value {
+            engine->RemoveSession(sessionId);
+            auto it = flashJobs_.find(channelIndex);
+            if (it != flashJobs_.end() && it->second.pipeline == pipeline) {
+                flashJobs_.erase(it);
+            }
+            if (progressTsfn) progressTsfn.Release();
+
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("success", Napi::Boolean::New(env, result.success));
+            if (!result.success) {
+                obj.Set("error", Napi::String::New(env, result.error));
+            }
+            if (result.negativeCode != 0) {
+                obj.Set("negativeCode", Napi::Number::New(env, result.negativeCode));
+            }
+            obj.Set("bytesSent", Napi::Number::New(env, static_cast<double>(result.bytesSent)));
+            obj.Set("totalBytes", Napi::Number::New(env, static_cast<double>(result.totalBytes)));
+            obj.Set("elapsedUs", Napi::Number::New(env, static_cast<double>(result.elapsedUs)));
+            obj.Set("bytesPerSec", Napi::Number::New(env, result.bytesPerSec));
+            obj.Set("blockLength", Napi::Number::New(env, result.blockLength));
+            obj.Set("stMinUs", Napi::Number::New(env, result.stMinUs));
+            obj.Set("remoteStMinUs", Napi::Number::New(env, static_cast<double>(result.remoteStMinUs)));
+            obj.Set("retries", Napi::Number::New(env, result.retries));
+            obj.Set("imageCrc32", Napi::Number::New(env, result.imageCrc32));
+            Napi::Array segments = Napi::Array::New(env, result.segments.size());
+            for (size_t i = 0; i < result.segments.size(); i++) {
+                Napi::Object segment = Napi::Object::New(env);
+                segment.Set("address", Napi::Number::New(env, result.segments[i].address));
+                segment.Set("size", Napi::Number::New(env, static_cast<double>(result.segments[i].size)));
+                segment.Set("crc32", Napi::Number::New(env, result.segments[i].crc32));
+                segment.Set("blocks", Napi::Number::New(env, result.segments[i].blocks));
+                segment.Set("crcVerified", Napi::Boolean::New(env, result.segments[i].crcVerified));
+                segments[static_cast<uint32_t>(i)] = segment;
+            }
+            obj.Set("segments", segments);
+            return obj;
+        },
+        nullptr);
+}
+
+Napi::Value ZlgCanDevice::FlashCancel(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex) || flashJobs_.find(channelIndex) == flashJobs_.end()) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    CancelFlashJob(channelIndex);
+    return Napi::Boolean::New(env, true);
+}
+
+// ==================== J1939传输协议 ====================
+
+namespace {
+
+const char* J1939TransportName(J1939Message::Transport transport) {
+    switch (transport) {
+        case J1939Message::Transport::Bam: return "bam";
+        case J1939Message::Transport::Cmdt: return "cmdt";
+        default: return "single";
+    }
+}
+
+void CallJ1939BatchCallback(Napi::Env env, Napi::Function callback, std::vector<J1939Message>* batch) {
+    if (env != nullptr && callback != nullptr) {
+        Napi::Array messages = Napi::Array::New(env, batch->size());
+        for (size_t i = 0; i < batch->size(); i++) {
+            const J1939Message& message = (*batch)[i];
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("pgn", Napi::Number::New(env, message.pgn));
+            obj.Set("priority", Napi::Number::New(env, message.priority));
+            obj.Set("sa", Napi::Number::New(env, message.sa));
+            obj.Set("da", Napi::Number::New(env, message.da));
+            obj.Set("transport", Napi::String::New(env, J1939TransportName(message.transport)));
+            Napi::Array data = Napi::Array::New(env, message.data.size());
+            for (size_t j = 0; j < message.data.size(); j++) {
+                data[static_cast<uint32_t>(j)] = Napi::Number::New(env, message.data[j]);
+            }
+            obj.Set("data", data);
+            obj.Set("timestamp", Napi::Number::New(env, static_cast<double>(message.timestamp)));
+            obj.Set("durationUs", Napi::Number::New(env, static_cast<double>(message.durationUs)));
+            messages[static_cast<uint32_t>(i)] = obj;
+        }
+        callback.Call({messages});
+    }
+    delete batch;
+}
+
+void ParseJ1939Options(const Napi::Object& opts, J1939Options* options) {
+    if (opts.Has("addresses")) {
+        Napi::Array arr = opts.Get("addresses").As<Napi::Array>();
+        for (uint32_t i = 0; i < arr.Length(); i++) {
+            options->addresses.push_back(static_cast<BYTE>(arr.Get(i).As<Napi::Number>().Uint32Value()));
+        }
+    }
+    if (opts.Has("singleFrames")) options->singleFrames = opts.Get("singleFrames").ToBoolean();
+    if (opts.Has("monitorSessions")) options->monitorSessions = opts.Get("monitorSessions").ToBoolean();
+    if (opts.Has("maxPacketsPerCts")) options->maxPacketsPerCts = static_cast<BYTE>(std::max<uint32_t>(1, std::min<uint32_t>(255, opts.Get("maxPacketsPerCts").As<Napi::Number>().Uint32Value())));
+    if (opts.Has("maxBatch")) options->maxBatch = std::max<uint32_t>(1, opts.Get("maxBatch").As<Napi::Number>().Uint32Value());
+    if (opts.Has("bamIntervalMs")) options->bamIntervalMs = opts.Get("bamIntervalMs").As<Napi::Number>().Uint32Value();
+    if (opts.Has("t1Ms")) options->t1Ms = opts.Get("t1Ms").As<Napi::Number>().Uint32Value();
+    if (opts.Has("t2Ms")) options->t2Ms = opts.Get("t2Ms").As<Napi::Number>().Uint32Value();
+    if (opts.Has("t3Ms")) options->t3Ms = opts.Get("t3Ms").As<Napi::Number>().Uint32Value();
+    if (opts.Has("t4Ms")) options->t4Ms = opts.Get("t4Ms").As<Napi::Number>().Uint32Value();
+}
+
+}  // namespace
+
+Napi::Value ZlgCanDevice::StartJ1939(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (deviceHandle_ == INVALID_DEVICE_HANDLE) {
+        Napi::Error::New(env, "设备未打开").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() < 3 || !info[1].IsObject() || !info[2].IsFunction()) {
+        Napi::TypeError::New(env, "需要3个参数: channelHandle, options, callback").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        Napi::Error::New(env, "通道未初始化").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    auto existing = receiveChannels_.find(channelIndex);
+    if (existing != receiveChannels_.end() && existing->second.j1939) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    J1939Options options;
+    ParseJ1939Options(info[1].As<Napi::Object>(), &options);
+
+    // CTS须在接收线程中应答，未启动时以默认参数启动
+    ReceiveChannelEntry& entry = EnsureReceiveChannel(channelIndex, channelHandle, ReceivePumpOptions());
+    Napi::ThreadSafeFunction tsfn = Napi::ThreadSafeFunction::New(
+        env, info[2].As<Napi::Function>(), "ZlgCanJ1939", 0, 1);
+    tsfn.Unref(env);
+
+    {
+        std::lock_guard<std::mutex> lock(handlesMutex_);
+        entry.j1939 = std::make_shared<J1939Engine>(channelHandle, options, [tsfn](std::vector<J1939Message>&& messages) {
+            auto* batch = new std::vector<J1939Message>(std::move(messages));
+            if (tsfn.NonBlockingCall(batch, CallJ1939BatchCallback) != napi_ok) {
+                delete batch;
+            }
+        });
+    }
+    entry.j1939Tsfn = tsfn;
+    entry.pump->AddListener(entry.j1939.get());
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::StopJ1939(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        return Napi::Boolean::New(env, false);
+    }
+    auto it = receiveChannels_.find(channelIndex);
+    if (it == receiveChannels_.end() || !it->second.j1939) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    StopJ1939Engine(it->second);
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::J1939SendAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[1].IsObject()) {
+        Napi::TypeError::New(env, "需要2个参数: channelHandle, message").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    auto it = FindChannelIndex(channelHandle, &channelIndex) ? receiveChannels_.find(channelIndex) : receiveChannels_.end();
+    if (it == receiveChannels_.end() || !it->second.j1939) {
+        Napi::Error::New(env, "J1939未启动").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    std::shared_ptr<J1939Engine> engine = it->second.j1939;
+
+    Napi::Object msg = info[1].As<Napi::Object>();
+    if (!msg.Has("pgn") || !msg.Has("sa") || !msg.Has("data") || !msg.Get("data").IsArray()) {
+        Napi::TypeError::New(env, "message需要pgn, sa, data").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    const uint32_t pgn = msg.Get("pgn").As<Napi::Number>().Uint32Value() & 0x3FFFF;
+    const BYTE priority = msg.Has("priority") ? static_cast<BYTE>(msg.Get("priority").As<Napi::Number>().Uint32Value()) : 6;
+    const BYTE sa = static_cast<BYTE>(msg.Get("sa").As<Napi::Number>().Uint32Value());
+    const BYTE da = msg.Has("da") ? static_cast<BYTE>(msg.Get("da").As<Napi::Number>().Uint32Value()) : 0xFF;
+    Napi::Array data = msg.Get("data").As<Napi::Array>();
+    std::vector<BYTE> payload(data.Length());
+    for (uint32_t i = 0; i < data.Length(); i++) {
+        payload[i] = static_cast<BYTE>(data.Get(i).As<Napi::Number>().Uint32Value());
+    }
+
+    return RunBlockingAsync<J1939SendResult>(env, "j1939Send", 0,
+        [engine, pgn, priority, sa, da, payload]() {
+            return engine->Send(pgn, priority, sa, da, payload);
+        },
+        [](Napi::Env env, J1939SendResult result) -> Napi::Value {
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("success", Napi::Boolean::New(env, result.success));
+            if (!result.success) {
+                obj.Set("error", Napi::String::New(env, result.error));
+            }
+            obj.Set("packets", Napi::Number::New(env, result.packets));
+            obj.Set("durationUs", Napi::Number::New(env, static_cast<double>(result.durationUs)));
+            return obj;
+        },
+        nullptr);
+}
+
+Napi::Value ZlgCanDevice::GetJ1939Stats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        return env.Null();
+    }
+    auto it = receiveChannels_.find(channelIndex);
+    if (it == receiveChannels_.end() || !it->second.j1939) {
+        return env.Null();
+    }
+
+    J1939Stats stats = it->second.j1939->Stats();
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("framesReceived", Napi::Number::New(env, static_cast<double>(stats.framesReceived)));
+    obj.Set("messages", Napi::Number::New(env, static_cast<double>(stats.messages)));
+    obj.Set("batches", Napi::Number::New(env, static_cast<double>(stats.batches)));
+    obj.Set("bamSessions", Napi::Number::New(env, static_cast<double>(stats.bamSessions)));
+    obj.Set("cmdtSessions", Napi::Number::New(env, static_cast<double>(stats.cmdtSessions)));
+    obj.Set("ctsSent", Napi::Number::New(env, static_cast<double>(stats.ctsSent)));
+    obj.Set("aborts", Napi::Number::New(env, static_cast<double>(stats.aborts)));
+    obj.Set("timeouts", Napi::Number::New(env, static_cast<double>(stats.timeouts)));
+    obj.Set("sequenceErrors", Napi::Number::New(env, static_cast<double>(stats.sequenceErrors)));
+    obj.Set("maxCtsResponseUs", Napi::Number::New(env, static_cast<double>(stats.maxCtsResponseUs)));
+    obj.Set("activeSessions", Napi::Number::New(env, static_cast<double>(stats.activeSessions)));
+    return obj;
+}
+
+// ==================== XCP测量 ====================
+
+namespace {
+
+bool ParseXcpDataType(const std::string& name, XcpDataType* type) {
+    static const std::map<std::string, XcpDataType> types = {
+        {"uint8", XcpDataType::U8}, {"int8", XcpDataType::I8},
+        {"uint16", XcpDataType::U16}, {"int16", XcpDataType::I16},
+        {"uint32", XcpDataType::U32}, {"int32", XcpDataType::I32},
+        {"uint64", XcpDataType::U64}, {"int64", XcpDataType::I64},
+        {"float32", XcpDataType::F32}, {"float64", XcpDataType::F64},
+    };
+    auto it = types.find(name);
+    if (it == types.end()) {
+        return false;
+    }
+    *type = it->second;
+    return true;
+}
+
+template <typename T>
+Napi::Value MakeTypedColumn(Napi::Env env, const std::vector<BYTE>& bytes) {
+    Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(env, bytes.size());
+    if (!bytes.empty()) {
+        memcpy(buffer.Data(), bytes.data(), bytes.size());
+    }
+    return Napi::TypedArrayOf<T>::New(env, bytes.size() / sizeof(T), buffer, 0);
+}
+
+Napi::Value XcpColumnToValue(Napi::Env env, XcpDataType type, const std::vector<BYTE>& bytes) {
+    switch (type) {
+        case XcpDataType::U8: return MakeTypedColumn<uint8_t>(env, bytes);
+        case XcpDataType::I8: return MakeTypedColumn<int8_t>(env, bytes);
+        case XcpDataType::U16: return MakeTypedColumn<uint16_t>(env, bytes);
+        case XcpDataType::I16: return MakeTypedColumn<int16_t>(env, bytes);
+        case XcpDataType::U32: return MakeTypedColumn<uint32_t>(env, bytes);
+        case XcpDataType::I32: return MakeTypedColumn<int32_t>(env, bytes);
+        case XcpDataType::U64: return MakeTypedColumn<uint64_t>(env, bytes);
+        case XcpDataType::I64: return MakeTypedColumn<int64_t>(env, bytes);
+        case XcpDataType::F32: return MakeTypedColumn<float>(env, bytes);
+        default: return MakeTypedColumn<double>(env, bytes);
+    }
+}
+
+void CallXcpBatchCallback(Napi::Env env, Napi::Function callback, std::vector<XcpDaqBatch>* batches) {
+    if (env != nullptr && callback != nullptr) {
+        Napi::Array result = Napi::Array::New(env, batches->size());
+        for (size_t i = 0; i < batches->size(); i++) {
+            const XcpDaqBatch& batch = (*batches)[i];
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("listIndex", Napi::Number::New(env, batch.listIndex));
+            obj.Set("count", Napi::Number::New(env, batch.count));
+            Napi::Float64Array timestamps = Napi::Float64Array::New(env, batch.timestamps.size());
+            if (!batch.timestamps.empty()) {
+                memcpy(timestamps.Data(), batch.timestamps.data(), batch.timestamps.size() * sizeof(double));
+            }
+            obj.Set("timestamps", timestamps);
+            Napi::Object signals = Napi::Object::New(env);
+            for (size_t j = 0; j < batch.columns.size() && j < batch.config->signals.size(); j++) {
+                const XcpSignal& signal = batch.config->signals[j];
+                signals.Set(signal.name, XcpColumnToValue(env, signal.type, batch.columns[j]));
+            }
+            obj.Set("signals", signals);
+            result[static_cast<uint32_t>(i)] = obj;
+        }
+        callback.Call({result});
+    }
+    delete batches;
+}
+
+Napi::Object XcpResultToObject(Napi::Env env, const XcpCommandResult& result) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("success", Napi::Boolean::New(env, result.success));
+    if (!result.success) {
+        obj.Set("error", Napi::String::New(env, result.error));
+        obj.Set("timeout", Napi::Boolean::New(env, result.timeout));
+        if (!result.timeout) {
+            obj.Set("errorCode", Napi::Number::New(env, result.errorCode));
+        }
+    }
+    obj.Set("durationUs", Napi::Number::New(env, static_cast<double>(result.durationUs)));
+    return obj;
+}
+
+void ParseXcpOptions(const Napi::Object& opts, XcpOptions* options) {
+    options->masterId = opts.Get("masterId").As<Napi::Number>().Uint32Value();
+    options->slaveId = opts.Get("slaveId").As<Napi::Number>().Uint32Value();
+    if (opts.Has("fd")) options->fd = opts.Get("fd").ToBoolean();
+    if (opts.Has("brs")) options->brs = opts.Get("brs").ToBoolean();
+    if (opts.Has("padding")) {
+        Napi::Value padding = opts.Get("padding");
+        options->padding = padding.IsNumber() ? static_cast<int>(padding.As<Napi::Number>().Uint32Value() & 0xFF) : -1;
+    }
+    if (opts.Has("timeoutMs")) options->timeoutMs = opts.Get("timeoutMs").As<Napi::Number>().Uint32Value();
+    if (opts.Has("maxRetries")) options->maxRetries = opts.Get("maxRetries").As<Napi::Number>().Uint32Value();
+    if (opts.Has("batchIntervalMs")) options->batchIntervalMs = opts.Get("batchIntervalMs").As<Napi::Number>().Uint32Value();
+    if (opts.Has("maxBatch")) options->maxBatch = std::max<uint32_t>(1, opts.Get("maxBatch").As<Napi::Number>().Uint32Value());
+}
+
+// 列表: { eventChannel, prescaler?, priority?, signals: [{ name, address, extension?, type }] }
+bool ParseXcpDaqList(const Napi::Object& obj, XcpDaqListConfig* list, std::string* error) {
+    if (!obj.Has("eventChannel") || !obj.Has("signals") || !obj.Get("signals").IsArray()) {
+        *error = "DAQ列表需要eventChannel, signals";
+        return false;
+    }
+    list->eventChannel = obj.Get("eventChannel").As<Napi::Number>().Uint32Value();
+    if (obj.Has("prescaler")) list->prescaler = static_cast<BYTE>(obj.Get("prescaler").As<Napi::Number>().Uint32Value());
+    if (obj.Has("priority")) list->priority = static_cast<BYTE>(obj.Get("priority").As<Napi::Number>().Uint32Value());
+
+    Napi::Array signals = obj.Get("signals").As<Napi::Array>();
+    for (uint32_t i = 0; i < signals.Length(); i++) {
+        Napi::Object item = signals.Get(i).As<Napi::Object>();
+        if (!item.Has("name") || !item.Has("address") || !item.Has("type")) {
+            *error = "信号需要name, address, type";
+            return false;
+        }
+        XcpSignal signal;
+        signal.name = item.Get("name").As<Napi::String>().Utf8Value();
+        signal.address = item.Get("address").As<Napi::Number>().Uint32Value();
+        if (item.Has("extension")) signal.extension = static_cast<BYTE>(item.Get("extension").As<Napi::Number>().Uint32Value());
+        if (!ParseXcpDataType(item.Get("type").As<Napi::String>().Utf8Value(), &signal.type)) {
+            *error = "type须为uint8, int8, uint16, int16, uint32, int32, uint64, int64, float32或float64";
+            return false;
+        }
+        list->signals.push_back(signal);
+    }
+    return true;
+}
+
+}  // namespace
+
+Napi::Value ZlgCanDevice::StartXcp(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (deviceHandle_ == INVALID_DEVICE_HANDLE) {
+        Napi::Error::New(env, "设备未打开").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() < 3 || !info[1].IsObject() || !info[2].IsFunction()) {
+        Napi::TypeError::New(env, "需要3个参数: channelHandle, options, callback").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        Napi::Error::New(env, "通道未初始化").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Object opts = info[1].As<Napi::Object>();
+    if (!opts.Has("masterId") || !opts.Has("slaveId")) {
+        Napi::TypeError::New(env, "options需要masterId, slaveId").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    auto existing = receiveChannels_.find(channelIndex);
+    if (existing != receiveChannels_.end() && existing->second.xcp) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    XcpOptions options;
+    ParseXcpOptions(opts, &options);
+
+    // CRM和DTO在接收线程中处理，未启动时以默认参数启动
+    ReceiveChannelEntry& entry = EnsureReceiveChannel(channelIndex, channelHandle, ReceivePumpOptions());
+    Napi::ThreadSafeFunction tsfn = Napi::ThreadSafeFunction::New(
+        env, info[2].As<Napi::Function>(), "ZlgCanXcp", 0, 1);
+    tsfn.Unref(env);
+
+    {
+        std::lock_guard<std::mutex> lock(handlesMutex_);
+        entry.xcp = std::make_shared<XcpMaster>(channelHandle, options, [tsfn](std::vector<XcpDaqBatch>&& batches) {
+            auto* copy = new std::vector<XcpDaqBatch>(std::move(batches));
+            if (tsfn.NonBlockingCall(copy, CallXcpBatchCallback) != napi_ok) {
+                delete copy;
+            }
+        });
+    }
+    entry.xcpTsfn = tsfn;
+    entry.pump->AddListener(entry.xcp.get());
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::StopXcp(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        return Napi::Boolean::New(env, false);
+    }
+    auto it = receiveChannels_.find(channelIndex);
+    if (it == receiveChannels_.end() || !it->second.xcp) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    StopXcpMaster(it->second);
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::XcpConnectAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    std::shared_ptr<XcpMaster> master = FindXcpMaster(channelHandle);
+    if (!master) {
+        Napi::Error::New(env, "XCP未启动").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    struct ConnectOutcome {
+        XcpCommandResult result;
+        XcpSlaveInfo slave;
+    };
+    return RunBlockingAsync<ConnectOutcome>(env, "xcpConnect", 0,
+        [master]() {
+            ConnectOutcome outcome;
+            outcome.result = master->Connect(&outcome.slave);
+            return outcome;
+        },
+        [](Napi::Env env, ConnectOutcome outcome) -> Napi::Value {
+            Napi::Object obj = XcpResultToObject(env, outcome.result);
+            if (outcome.result.success) {
+                const XcpSlaveInfo& slave = outcome.slave;
+                obj.Set("resource", Napi::Number::New(env, slave.resource));
+                obj.Set("commModeBasic", Napi::Number::New(env, slave.commModeBasic));
+                obj.Set("byteOrder", Napi::String::New(env, slave.bigEndian ? "motorola" : "intel"));
+                obj.Set("maxCto", Napi::Number::New(env, slave.maxCto));
+                obj.Set("maxDto", Napi::Number::New(env, slave.maxDto));
+                obj.Set("protocolVersion", Napi::Number::New(env, slave.protocolVersion));
+                obj.Set("transportVersion", Napi::Number::New(env, slave.transportVersion));
+                obj.Set("sessionStatus", Napi::Number::New(env, slave.sessionStatus));
+                obj.Set("daqProperties", Napi::Number::New(env, slave.daqProperties));
+                obj.Set("maxDaq", Napi::Number::New(env, slave.maxDaq));
+                obj.Set("minDaq", Napi::Number::New(env, slave.minDaq));
+                obj.Set("maxEventChannel", Napi::Number::New(env, slave.maxEventChannel));
+                obj.Set("daqKeyByte", Napi::Number::New(env, slave.daqKeyByte));
+                obj.Set("maxOdtEntrySize", Napi::Number::New(env, slave.maxOdtEntrySize));
+                obj.Set("timestampMode", Napi::Number::New(env, slave.timestampMode));
+                obj.Set("timestampTicks", Napi::Number::New(env, slave.timestampTicks));
+            }
+            return obj;
+        },
+        nullptr);
+}
+
+Napi::Value ZlgCanDevice::XcpDisconnectAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    std::shared_ptr<XcpMaster> master = FindXcpMaster(channelHandle);
+    if (!master) {
+        Napi::Error::New(env, "XCP未启动").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    return RunBlockingAsync<XcpCommandResult>(env, "xcpDisconnect", 0,
+        [master]() {
+            return master->Disconnect();
+        },
+        [](Napi::Env env, XcpCommandResult result) -> Napi::Value {
+            return XcpResultToObject(env, result);
+        },
+        nullptr);
+}
+
+Napi::Value ZlgCanDevice::XcpShortUploadAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[1].IsObject()) {
+        Napi::TypeError::New(env, "需要2个参数: channelHandle, request").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    std::shared_ptr<XcpMaster> master = FindXcpMaster(channelHandle);
+    if (!master) {
+        Napi::Error::New(env, "XCP未启动").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Object req = info[1].As<Napi::Object>();
+    if (!req.Has("address") || !req.Has("length")) {
+        Napi::TypeError::New(env, "request需要address, length").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    const uint32_t address = req.Get("address").As<Napi::Number>().Uint32Value();
+    const BYTE extension = req.Has("extension") ? static_cast<BYTE>(req.Get("extension").As<Napi::Number>().Uint32Value()) : 0;
+    const BYTE length = static_cast<BYTE>(std::min<uint32_t>(req.Get("length").As<Napi::Number>().Uint32Value(), 0xFF));
+
+    return RunBlockingAsync<XcpCommandResult>(env, "xcpShortUpload", 0,
+        [master, address, extension, length]() {
+            return master->ShortUpload(address, extension, length);
+        },
+        [length](Napi::Env env, XcpCommandResult result) -> Napi::Value {
+            Napi::Object obj = XcpResultToObject(env, result);
+            if (result.success) {
+                Napi::Array data = Napi::Array::New(env, length);
+                for (uint32_t i = 0; i < length; i++) {
+                    data[i] = Napi::Number::New(env, result.response[i + 1]);
+                }
+                obj.Set("data", data);
+            }
+            return obj;
+        },
+        nullptr);
+}
+
+Napi::Value ZlgCanDevice::XcpDownloadAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[1].IsObject()) {
+        Napi::TypeError::New(env, "需要2个参数: channelHandle, request").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    std::shared_ptr<XcpMaster> master = FindXcpMaster(channelHandle);
+    if (!master) {
+        Napi::Error::New(env, "XCP未启动").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Object req = info[1].As<Napi::Object>();
+    if (!req.Has("address") || !req.Has("data") || !req.Get("data").IsArray()) {
+        Napi::TypeError::New(env, "request需要address, data").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    const uint32_t address = req.Get("address").As<Napi::Number>().Uint32Value();
+    const BYTE extension = req.Has("extension") ? static_cast<BYTE>(req.Get("extension").As<Napi::Number>().Uint32Value()) : 0;
+    Napi::Array data = req.Get("data").As<Napi::Array>();
+    std::vector<BYTE> payload(data.Length());
+    for (uint32_t i = 0; i < data.Length(); i++) {
+        payload[i] = static_cast<BYTE>(data.Get(i).As<Napi::Number>().Uint32Value());
+    }
+
+    return RunBlockingAsync<XcpCommandResult>(env, "xcpDownload", 0,
+        [master, address, extension, payload]() {
+            return master->Download(address, extension, payload);
+        },
+        [](Napi::Env env, XcpCommandResult result) -> Napi::Value {
+            return XcpResultToObject(env, result);
+        },
+        nullptr);
+}
+
+Napi::Value ZlgCanDevice::XcpStartDaqAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[1].IsObject()) {
+        Napi::TypeError::New(env, "需要2个参数: channelHandle, config").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    std::shared_ptr<XcpMaster> master = FindXcpMaster(channelHandle);
+    if (!master) {
+        Napi::Error::New(env, "XCP未启动").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Object config = info[1].As<Napi::Object>();
+    if (!config.Has("lists") || !config.Get("lists").IsArray()) {
+        Napi::TypeError::New(env, "config需要lists").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    Napi::Array arr = config.Get("lists").As<Napi::Array>();
+    std::vector<XcpDaqListConfig> lists(arr.Length());
+    for (uint32_t i = 0; i < arr.Length(); i++) {
+        std::string error;
+        if (!ParseXcpDaqList(arr.Get(i).As<Napi::Object>(), &lists[i], &error)) {
+            Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+    }
+    const bool timestamps = config.Has("timestamps") ? config.Get("timestamps").ToBoolean().Value() : true;
+
+    struct DaqOutcome {
+        XcpCommandResult result;
+        std::vector<XcpDaqListLayout> layout;
+    };
+    return RunBlockingAsync<DaqOutcome>(env, "xcpStartDaq", 0,
+        [master, lists, timestamps]() {
+            DaqOutcome outcome;
+            outcome.result = master->StartDaq(lists, timestamps, &outcome.layout);
+            return outcome;
+        },
+        [](Napi::Env env, DaqOutcome outcome) -> Napi::Value {
+            Napi::Object obj = XcpResultToObject(env, outcome.result);
+            Napi::Array layout = Napi::Array::New(env, outcome.layout.size());
+            for (size_t i = 0; i < outcome.layout.size(); i++) {
+                Napi::Object list = Napi::Object::New(env);
+                list.Set("daqList", Napi::Number::New(env, outcome.layout[i].daqList));
+                list.Set("firstPid", Napi::Number::New(env, outcome.layout[i].firstPid));
+                list.Set("odts", Napi::Number::New(env, outcome.layout[i].odts));
+                layout[static_cast<uint32_t>(i)] = list;
+            }
+            obj.Set("lists", layout);
+            return obj;
+        },
+        nullptr);
+}
+
+Napi::Value ZlgCanDevice::XcpStopDaqAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    std::shared_ptr<XcpMaster> master = FindXcpMaster(channelHandle);
+    if (!master) {
+        Napi::Error::New(env, "XCP未启动").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    return RunBlockingAsync<XcpCommandResult>(env, "xcpStopDaq", 0,
+        [master]() {
+            return master->StopDaq();
+        },
+        [](Napi::Env env, XcpCommandResult result) -> Napi::Value {
+            return XcpResultToObject(env, result);
+        },
+        nullptr);
+}
+
+Napi::Value ZlgCanDevice::GetXcpStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    std::shared_ptr<XcpMaster> master = FindXcpMaster(channelHandle);
+    if (!master) {
+        return env.Null();
+    }
+
+    XcpStats stats = master->Stats();
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("commands", Napi::Number::New(env, static_cast<double>(stats.commands)));
+    obj.Set("commandErrors", Napi::Number::New(env, static_cast<double>(stats.commandErrors)));
+    obj.Set("timeouts", Napi::Number::New(env, static_cast<double>(stats.timeouts)));
+    obj.Set("events", Napi::Number::New(env, static_cast<double>(stats.events)));
+    obj.Set("dtos", Napi::Number::New(env, static_cast<double>(stats.dtos)));
+    obj.Set("samples", Napi::Number::New(env, static_cast<double>(stats.samples)));
+    obj.Set("lostSamples", Napi::Number::New(env, static_cast<double>(stats.lostSamples)));
+    obj.Set("unknownPids", Napi::Number::New(env, static_cast<double>(stats.unknownPids)));
+    obj.Set("batches", Napi::Number::New(env, static_cast<double>(stats.batches)));
+    obj.Set("lastCommandUs", Napi::Number::New(env, static_cast<double>(stats.lastCommandUs)));
+    obj.Set("maxCommandUs", Napi::Number::New(env, static_cast<double>(stats.maxCommandUs)));
+    obj.Set("clockOffsetUs", Napi::Number::New(env, stats.clockOffsetUs));
+    return obj;
+}
+
+// ==================== CANopen ====================
+
+namespace {
+
+bool ParseCanOpenDataType(const std::string& name, CanOpenDataType* type) {
+    static const std::map<std::string, CanOpenDataType> types = {
+        {"uint8", CanOpenDataType::U8}, {"int8", CanOpenDataType::I8},
+        {"uint16", CanOpenDataType::U16}, {"int16", CanOpenDataType::I16},
+        {"uint32", CanOpenDataType::U32}, {"int32", CanOpenDataType::I32},
+        {"uint64", CanOpenDataType::U64}, {"int64", CanOpenDataType::I64},
+        {"float32", CanOpenDataType::F32}, {"float64", CanOpenDataType::F64},
+    };
+    auto it = types.find(name);
+    if (it == types.end()) {
+        return false;
+    }
+    *type = it->second;
+    return true;
+}
+
+bool ParseCanOpenSdoMode(const Napi::Object& req, CanOpenSdoMode* mode) {
+    if (!req.Has("mode")) {
+        *mode = CanOpenSdoMode::Auto;
+        return true;
+    }
+    const std::string name = req.Get("mode").As<Napi::String>().Utf8Value();
+    if (name == "auto") {
+        *mode = CanOpenSdoMode::Auto;
+    } else if (name == "segmented") {
+        *mode = CanOpenSdoMode::Segmented;
+    } else if (name == "block") {
+        *mode = CanOpenSdoMode::Block;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+Napi::Value CanOpenStateToValue(Napi::Env env, BYTE state) {
+    return state == 0xFF ? env.Null() : Napi::Number::New(env, state);
+}
+
+Napi::Object CanOpenEventToObject(Napi::Env env, const CanOpenEvent& event) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("nodeId", Napi::Number::New(env, event.nodeId));
+    obj.Set("timestamp", Napi::Number::New(env, static_cast<double>(event.timestamp)));
+    switch (event.type) {
+        case CanOpenEvent::Type::Pdo: {
+            obj.Set("type", Napi::String::New(env, "pdo"));
+            obj.Set("cobId", Napi::Number::New(env, event.pdo->cobId));
+            obj.Set("pdoIndex", Napi::Number::New(env, event.pdoIndex));
+            Napi::Object values = Napi::Object::New(env);
+            for (const auto& value : event.values) {
+                values.Set(event.pdo->entries[value.first].name, Napi::Number::New(env, value.second));
+            }
+            obj.Set("values", values);
+            break;
+        }
+        case CanOpenEvent::Type::NodeState:
+            obj.Set("type", Napi::String::New(env, "nodeState"));
+            obj.Set("state", Napi::Number::New(env, event.state));
+            obj.Set("previousState", CanOpenStateToValue(env, event.previousState));
+            break;
+        case CanOpenEvent::Type::HeartbeatLost:
+            obj.Set("type", Napi::String::New(env, "heartbeatLost"));
+            obj.Set("previousState", CanOpenStateToValue(env, event.previousState));
+            break;
+        case CanOpenEvent::Type::Emergency: {
+            obj.Set("type", Napi::String::New(env, "emergency"));
+            obj.Set("errorCode", Napi::Number::New(env, event.errorCode));
+            obj.Set("errorRegister", Napi::Number::New(env, event.errorRegister));
+            Napi::Array data = Napi::Array::New(env, event.data.size());
+            for (size_t i = 0; i < event.data.size(); i++) {
+                data[static_cast<uint32_t>(i)] = Napi::Number::New(env, event.data[i]);
+            }
+            obj.Set("data", data);
+            break;
+        }
+    }
+    return obj;
+}
+
+void CallCanOpenBatchCallback(Napi::Env env, Napi::Function callback, std::vector<CanOpenEvent>* events) {
+    if (env != nullptr && callback != nullptr) {
+        Napi::Array result = Napi::Array::New(env, events->size());
+        for (size_t i = 0; i < events->size(); i++) {
+            result[static_cast<uint32_t>(i)] = CanOpenEventToObject(env, (*events)[i]);
+        }
+        callback.Call({result});
+    }
+    delete events;
+}
+
+Napi::Object CanOpenSdoResultToObject(Napi::Env env, const CanOpenSdoResult& result, bool upload) {
+    static const char* const transfers[] = {"expedited", "segmented", "block"};
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("success", Napi::Boolean::New(env, result.success));
+    if (!result.success) {
+        obj.Set("error", Napi::String::New(env, result.error));
+        obj.Set("timeout", Napi::Boolean::New(env, result.timeout));
+        if (result.abortCode != 0) {
+            obj.Set("abortCode", Napi::Number::New(env, result.abortCode));
+        }
+    }
+    obj.Set("transfer", Napi::String::New(env, transfers[static_cast<size_t>(result.transfer)]));
+    if (upload && result.success) {
+        Napi::Array data = Napi::Array::New(env, result.data.size());
+        for (size_t i = 0; i < result.data.size(); i++) {
+            data[static_cast<uint32_t>(i)] = Napi::Number::New(env, result.data[i]);
+        }
+        obj.Set("data", data);
+    }
+    obj.Set("durationUs", Napi::Number::New(env, static_cast<double>(result.durationUs)));
+    return obj;
+}
+
+void ParseCanOpenOptions(const Napi::Object& opts, CanOpenOptions* options) {
+    if (opts.Has("sdoTimeoutMs")) options->sdoTimeoutMs = opts.Get("sdoTimeoutMs").As<Napi::Number>().Uint32Value();
+    if (opts.Has("blockSize")) {
+        options->blockSize = static_cast<BYTE>(std::min<uint32_t>(std::max<uint32_t>(
+            opts.Get("blockSize").As<Napi::Number>().Uint32Value(), 1), 127));
+    }
+    if (opts.Has("blockThreshold")) options->blockThreshold = opts.Get("blockThreshold").As<Napi::Number>().Uint32Value();
+    if (opts.Has("maxUploadSize")) options->maxUploadSize = opts.Get("maxUploadSize").As<Napi::Number>().Uint32Value();
+    if (opts.Has("changesOnly")) options->changesOnly = opts.Get("changesOnly").ToBoolean();
+    if (opts.Has("maxBatch")) options->maxBatch = std::max<uint32_t>(1, opts.Get("maxBatch").As<Napi::Number>().Uint32Value());
+    if (opts.Has("heartbeats") && opts.Get("heartbeats").IsArray()) {
+        Napi::Array heartbeats = opts.Get("heartbeats").As<Napi::Array>();
+        for (uint32_t i = 0; i < heartbeats.Length(); i++) {
+            Napi::Object item = heartbeats.Get(i).As<Napi::Object>();
+            CanOpenHeartbeatConsumer consumer;
+            consumer.nodeId = static_cast<BYTE>(item.Get("nodeId").As<Napi::Number>().Uint32Value());
+            consumer.timeoutMs = item.Get("timeoutMs").As<Napi::Number>().Uint32Value();
+            options->heartbeats.push_back(consumer);
+        }
+    }
+}
+
+// PDO: { cobId, entries: [{ name, type, bitLength? }] }
+bool ParseCanOpenPdo(const Napi::Object& obj, CanOpenPdoConfig* pdo, std::string* error) {
+    if (!obj.Has("cobId") || !obj.Has("entries") || !obj.Get("entries").IsArray()) {
+        *error = "PDO需要cobId, entries";
+        return false;
+    }
+    pdo->cobId = obj.Get("cobId").As<Napi::Number>().Uint32Value();
+
+    Napi::Array entries = obj.Get("entries").As<Napi::Array>();
+    for (uint32_t i = 0; i < entries.Length(); i++) {
+        Napi::Object item = entries.Get(i).As<Napi::Object>();
+        if (!item.Has("name") || !item.Has("type")) {
+            *error = "映射项需要name, type";
+            return false;
+        }
+        CanOpenPdoEntry entry;
+        entry.name = item.Get("name").As<Napi::String>().Utf8Value();
+        if (!ParseCanOpenDataType(item.Get("type").As<Napi::String>().Utf8Value(), &entry.type)) {
+            *error = "映射项" + entry.name + "的type无效";
+            return false;
+        }
+        if (item.Has("bitLength")) {
+            entry.bitLength = static_cast<BYTE>(std::min<uint32_t>(item.Get("bitLength").As<Napi::Number>().Uint32Value(), 0xFF));
+        }
+        pdo->entries.push_back(entry);
+    }
+    return true;
+}
+
+}  // namespace
+
+Napi::Value ZlgCanDevice::StartCanOpen(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (deviceHandle_ == INVALID_DEVICE_HANDLE) {
+        Napi::Error::New(env, "设备未打开").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() < 3 || !info[1].IsObject() || !info[2].IsFunction()) {
+        Napi::TypeError::New(env, "需要3个参数: channelHandle, options, callback").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        Napi::Error::New(env, "通道未初始化").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    auto existing = receiveChannels_.find(channelIndex);
+    if (existing != receiveChannels_.end() && existing->second.canopen) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    CanOpenOptions options;
+    ParseCanOpenOptions(info[1].As<Napi::Object>(), &options);
+
+    // SDO响应、心跳和PDO在接收线程中处理，未启动时以默认参数启动
+    ReceiveChannelEntry& entry = EnsureReceiveChannel(channelIndex, channelHandle, ReceivePumpOptions());
+    Napi::ThreadSafeFunction tsfn = Napi::ThreadSafeFunction::New(
+        env, info[2].As<Napi::Function>(), "ZlgCanCanOpen", 0, 1);
+    tsfn.Unref(env);
+
+    {
+        std::lock_guard<std::mutex> lock(handlesMutex_);
+        entry.canopen = std::make_shared<CanOpenClient>(channelHandle, options, [tsfn](std::vector<CanOpenEvent>&& events) {
+            auto* copy = new std::vector<CanOpenEvent>(std::move(events));
+            if (tsfn.NonBlockingCall(copy, CallCanOpenBatchCallback) != napi_ok) {
+                delete copy;
+            }
+        });
+    }
+    entry.canopenTsfn = tsfn;
+    entry.pump->AddListener(entry.canopen.get());
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::StopCanOpen(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        return Napi::Boolean::New(env, false);
+    }
+    auto it = receiveChannels_.find(channelIndex);
+    if (it == receiveChannels_.end() || !it->second.canopen) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    StopCanOpenClient(it->second);
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::CanOpenConfigurePdo(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[1].IsArray()) {
+        Napi::TypeError::New(env, "需要2个参数: channelHandle, pdos").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    std::shared_ptr<CanOpenClient> client = FindCanOpenClient(channelHandle);
+    if (!client) {
+        Napi::Error::New(env, "CANopen未启动").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Array arr = info[1].As<Napi::Array>();
+    std::vector<CanOpenPdoConfig> pdos(arr.Length());
+    std::string error;
+    for (uint32_t i = 0; i < arr.Length(); i++) {
+        if (!ParseCanOpenPdo(arr.Get(i).As<Napi::Object>(), &pdos[i], &error)) {
+            Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+    }
+    if (!client->SetPdoMappings(pdos, &error)) {
+        Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::CanOpenSdoUploadAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[1].IsObject()) {
+        Napi::TypeError::New(env, "需要2个参数: channelHandle, request").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    std::shared_ptr<CanOpenClient> client = FindCanOpenClient(channelHandle);
+    if (!client) {
+        Napi::Error::New(env, "CANopen未启动").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Object req = info[1].As<Napi::Object>();
+    CanOpenSdoMode mode;
+    if (!req.Has("nodeId") || !req.Has("index") || !ParseCanOpenSdoMode(req, &mode)) {
+        Napi::TypeError::New(env, "request需要nodeId, index，mode为auto/segmented/block").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    const BYTE nodeId = static_cast<BYTE>(req.Get("nodeId").As<Napi::Number>().Uint32Value());
+    const UINT index = req.Get("index").As<Napi::Number>().Uint32Value() & 0xFFFF;
+    const BYTE subIndex = req.Has("subIndex") ? static_cast<BYTE>(req.Get("subIndex").As<Napi::Number>().Uint32Value()) : 0;
+
+    return RunBlockingAsync<CanOpenSdoResult>(env, "canopenSdoUpload", 0,
+        [client, nodeId, index, subIndex, mode]() {
+            return client->SdoUpload(nodeId, index, subIndex, mode);
+        },
+        [](Napi::Env env, CanOpenSdoResult result) -> Napi::Value {
+            return CanOpenSdoResultToObject(env, result, true);
+        },
+        nullptr);
+}
+
+Napi::Value ZlgCanDevice::CanOpenSdoDownloadAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[1].IsObject()) {
+        Napi::TypeError::New(env, "需要2个参数: channelHandle, request").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    std::shared_ptr<CanOpenClient> client = FindCanOpenClient(channelHandle);
+    if (!client) {
+        Napi::Error::New(env, "CANopen未启动").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Object req = info[1].As<Napi::Object>();
+    CanOpenSdoMode mode;
+    if (!req.Has("nodeId") || !req.Has("index") || !req.Has("data") || !req.Get("data").IsArray() ||
+        !ParseCanOpenSdoMode(req, &mode)) {
+        Napi::TypeError::New(env, "request需要nodeId, index, data，mode为auto/segmented/block").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    const BYTE nodeId = static_cast<BYTE>(req.Get("nodeId").As<Napi::Number>().Uint32Value());
+    const UINT index = req.Get("index").As<Napi::Number>().Uint32Value() & 0xFFFF;
+    const BYTE subIndex = req.Has("subIndex") ? static_cast<BYTE>(req.Get("subIndex").As<Napi::Number>().Uint32Value()) : 0;
+    Napi::Array data = req.Get("data").As<Napi::Array>();
+    std::vector<BYTE> payload(data.Length());
+    for (uint32_t i = 0; i < data.Length(); i++) {
+        payload[i] = static_cast<BYTE>(data.Get(i).As<Napi::Number>().Uint32Value());
+    }
+
+    return RunBlockingAsync<CanOpenSdoResult>(env, "canopenSdoDownload", 0,
+        [client, nodeId, index, subIndex, payload, mode]() {
+            return client->SdoDownload(nodeId, index, subIndex, payload, mode);
+        },
+        [](Napi::Env env, CanOpenSdoResult result) -> Napi::Value {
+            return CanOpenSdoResultToObject(env, result, false);
+        },
+        nullptr);
+}
+
+Napi::Value ZlgCanDevice::CanOpenNmt(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[1].IsString()) {
+        Napi::TypeError::New(env, "需要2个参数: channelHandle, command").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    std::shared_ptr<CanOpenClient> client = FindCanOpenClient(channelHandle);
+    if (!client) {
+        Napi::Error::New(env, "CANopen未启动").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    static const std::map<std::string, BYTE> commands = {
+        {"start", 0x01}, {"stop", 0x02}, {"preOperational", 0x80},
+        {"resetNode", 0x81}, {"resetCommunication", 0x82},
+    };
+    auto command = commands.find(info[1].As<Napi::String>().Utf8Value());
+    if (command == commands.end()) {
+        Napi::TypeError::New(env, "command为start/stop/preOperational/resetNode/resetCommunication").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    const BYTE nodeId = info.Length() > 2 ? static_cast<BYTE>(info[2].As<Napi::Number>().Uint32Value()) : 0;
+    return Napi::Boolean::New(env, client->SendNmt(command->second, nodeId));
+}
+
+Napi::Value ZlgCanDevice::GetCanOpenStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    std::shared_ptr<CanOpenClient> client = FindCanOpenClient(channelHandle);
+    if (!client) {
+        return env.Null();
+    }
+
+    CanOpenStats stats = client->Stats();
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("sdoTransfers", Napi::Number::New(env, static_cast<double>(stats.sdoTransfers)));
+    obj.Set("sdoErrors", Napi::Number::New(env, static_cast<double>(stats.sdoErrors)));
+    obj.Set("sdoTimeouts", Napi::Number::New(env, static_cast<double>(stats.sdoTimeouts)));
+    obj.Set("sdoAborts", Napi::Number::New(env, static_cast<double>(stats.sdoAborts)));
+    obj.Set("sdoBytes", Napi::Number::New(env, static_cast<double>(stats.sdoBytes)));
+    obj.Set("blockRetransmits", Napi::Number::New(env, static_cast<double>(stats.blockRetransmits)));
+    obj.Set("crcErrors", Napi::Number::New(env, static_cast<double>(stats.crcErrors)));
+    obj.Set("lastSdoUs", Napi::Number::New(env, static_cast<double>(stats.lastSdoUs)));
+    obj.Set("lastSdoBytesPerSec", Napi::Number::New(env, stats.lastSdoBytesPerSec));
+    obj.Set("pdoFrames", Napi::Number::New(env, static_cast<double>(stats.pdoFrames)));
+    obj.Set("pdoValues", Napi::Number::New(env, static_cast<double>(stats.pdoValues)));
+    obj.Set("pdoUnchanged", Napi::Number::New(env, static_cast<double>(stats.pdoUnchanged)));
+    obj.Set("pdoLengthErrors", Napi::Number::New(env, static_cast<double>(stats.pdoLengthErrors)));
+    obj.Set("heartbeats", Napi::Number::New(env, static_cast<double>(stats.heartbeats)));
+    obj.Set("heartbeatsLost", Napi::Number::New(env, static_cast<double>(stats.heartbeatsLost)));
+    obj.Set("emergencies", Napi::Number::New(env, static_cast<double>(stats.emergencies)));
+    obj.Set("events", Napi::Number::New(env, static_cast<double>(stats.events)));
+    obj.Set("batches", Napi::Number::New(env, static_cast<double>(stats.batches)));
+    return obj;
+}
+
+// ==================== E2E保护 ====================
+
+namespace {
+
+// { profile, dataId?, dataIdList?, offset?, maxDeltaCounter? }
+bool ParseE2eConfig(const Napi::Object& obj, E2eConfig* config, std::string* error) {
+    static const std::map<std::string, E2eProfile> profiles = {
+        {"p01", E2eProfile::P01}, {"p02", E2eProfile::P02}, {"p04", E2eProfile::P04},
+        {"p05", E2eProfile::P05}, {"p07", E2eProfile::P07}, {"p11", E2eProfile::P11},
+    };
+    auto profile = obj.Has("profile") ? profiles.find(obj.Get("profile").As<Napi::String>().Utf8Value()) : profiles.end();
+    if (profile == profiles.end()) {
+        *error = "E2E配置需要profile(p01/p02/p04/p05/p07/p11)";
+        return false;
+    }
+    config->profile = profile->second;
+    if (obj.Has("dataId")) config->dataId = obj.Get("dataId").As<Napi::Number>().Uint32Value();
+    if (obj.Has("offset")) config->offset = std::min<uint32_t>(obj.Get("offset").As<Napi::Number>().Uint32Value(), CANFD_MAX_DLEN);
+    if (obj.Has("maxDeltaCounter")) {
+        config->maxDeltaCounter = std::max<uint32_t>(1, obj.Get("maxDeltaCounter").As<Napi::Number>().Uint32Value());
+    }
+    if (config->profile == E2eProfile::P02) {
+        if (!obj.Has("dataIdList") || !obj.Get("dataIdList").IsArray() ||
+            obj.Get("dataIdList").As<Napi::Array>().Length() != config->dataIdList.size()) {
+            *error = "P02需要16个元素的dataIdList";
+            return false;
+        }
+        Napi::Array list = obj.Get("dataIdList").As<Napi::Array>();
+        for (uint32_t i = 0; i < list.Length(); i++) {
+            config->dataIdList[i] = static_cast<BYTE>(list.Get(i).As<Napi::Number>().Uint32Value());
+        }
+    }
+    return true;
+}
+
+// [{ id, profile, ... }]
+bool ParseE2eEntries(const Napi::Array& arr, std::vector<std::pair<UINT, E2eConfig>>* entries, std::string* error) {
+    for (uint32_t i = 0; i < arr.Length(); i++) {
+        Napi::Object item = arr.Get(i).As<Napi::Object>();
+        if (!item.Has("id")) {
+            *error = "E2E配置需要id";
+            return false;
+        }
+        E2eConfig config;
+        if (!ParseE2eConfig(item, &config, error)) {
+            return false;
+        }
+        entries->emplace_back(item.Get("id").As<Napi::Number>().Uint32Value(), config);
+    }
+    return true;
+}
+
+const char* E2eStatusName(E2eStatus status) {
+    switch (status) {
+        case E2eStatus::Ok: return "ok";
+        case E2eStatus::Repeated: return "repeated";
+        case E2eStatus::WrongSequence: return "wrongSequence";
+        case E2eStatus::WrongCrc: return "wrongCrc";
+        case E2eStatus::WrongDataId: return "wrongDataId";
+        case E2eStatus::BadLength: return "badLength";
+    }
+    return "ok";
+}
+
+void CallE2eBatchCallback(Napi::Env env, Napi::Function callback, std::vector<E2eFailure>* failures) {
+    if (env != nullptr && callback != nullptr) {
+        Napi::Array result = Napi::Array::New(env, failures->size());
+        for (size_t i = 0; i < failures->size(); i++) {
+            const E2eFailure& failure = (*failures)[i];
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("id", Napi::Number::New(env, failure.id));
+            obj.Set("status", Napi::String::New(env, E2eStatusName(failure.status)));
+            obj.Set("counter", Napi::Number::New(env, failure.counter));
+            obj.Set("timestamp", Napi::Number::New(env, static_cast<double>(failure.timestamp)));
+            result[static_cast<uint32_t>(i)] = obj;
+        }
+        callback.Call({result});
+    }
+    delete failures;
+}
+
+}  // namespace
+
+Napi::Value ZlgCanDevice::SetE2eProtection(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2) {
+        Napi::TypeError::New(env, "需要2个参数: channelHandle, entries").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        Napi::Error::New(env, "通道未初始化").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    // 传入null或空数组时取消保护；重新设置会清零发送计数器
+    std::vector<std::pair<UINT, E2eConfig>> entries;
+    std::string error;
+    if (info[1].IsArray() && !ParseE2eEntries(info[1].As<Napi::Array>(), &entries, &error)) {
+        Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    if (entries.empty()) {
+        e2eProtectors_.erase(channelIndex);
+        return Napi::Boolean::New(env, true);
+    }
+
+    E2eTransmitProtector protector;
+    for (const auto& entry : entries) {
+        protector.Set(entry.first, entry.second);
+    }
+    e2eProtectors_[channelIndex] = std::move(protector);
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::StartE2eCheck(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (deviceHandle_ == INVALID_DEVICE_HANDLE) {
+        Napi::Error::New(env, "设备未打开").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() < 2 || !info[1].IsArray()) {
+        Napi::TypeError::New(env, "需要2个参数: channelHandle, entries").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        Napi::Error::New(env, "通道未初始化").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    auto existing = receiveChannels_.find(channelIndex);
+    if (existing != receiveChannels_.end() && existing->second.e2e) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    std::vector<std::pair<UINT, E2eConfig>> entries;
+    std::string error;
+    if (!ParseE2eEntries(info[1].As<Napi::Array>(), &entries, &error)) {
+        Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    UINT maxBatch = 256;
+    if (info.Length() > 3 && info[3].IsObject()) {
+        Napi::Object opts = info[3].As<Napi::Object>();
+        if (opts.Has("maxBatch")) maxBatch = opts.Get("maxBatch").As<Napi::Number>().Uint32Value();
+    }
+
+    // 检查在接收线程中随每批帧进行，未启动时以默认参数启动
+    ReceiveChannelEntry& entry = EnsureReceiveChannel(channelIndex, channelHandle, ReceivePumpOptions());
+    E2eMonitor::BatchCallback callback;
+    if (info.Length() > 2 && info[2].IsFunction()) {
+        Napi::ThreadSafeFunction tsfn = Napi::ThreadSafeFunction::New(
+            env, info[2].As<Napi::Function>(), "ZlgCanE2e", 0, 1);
+        tsfn.Unref(env);
+        callback = [tsfn](std::vector<E2eFailure>&& failures) {
+            auto* copy = new std::vector<E2eFailure>(std::move(failures));
+            if (tsfn.NonBlockingCall(copy, CallE2eBatchCallback) != napi_ok) {
+                delete copy;
+            }
+        };
+        entry.e2eTsfn = tsfn;
+    }
+
+    entry.e2e = std::make_shared<E2eMonitor>(entries, maxBatch, std::move(callback));
+    entry.pump->AddListener(entry.e2e.get());
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::StopE2eCheck(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        return Napi::Boolean::New(env, false);
+    }
+    auto it = receiveChannels_.find(channelIndex);
+    if (it == receiveChannels_.end() || !it->second.e2e) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    StopE2eMonitor(it->second);
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::GetE2eStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    auto it = FindChannelIndex(channelHandle, &channelIndex) ? receiveChannels_.find(channelIndex) : receiveChannels_.end();
+    if (it == receiveChannels_.end() || !it->second.e2e) {
+        return env.Null();
+    }
+
+    std::vector<E2eIdStats> stats = it->second.e2e->Stats();
+    Napi::Array result = Napi::Array::New(env, stats.size());
+    for (size_t i = 0; i < stats.size(); i++) {
+        const E2eIdStats& item = stats[i];
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("id", Napi::Number::New(env, item.id));
+        obj.Set("ok", Napi::Number::New(env, static_cast<double>(item.ok)));
+        obj.Set("repeated", Napi::Number::New(env, static_cast<double>(item.repeated)));
+        obj.Set("wrongSequence", Napi::Number::New(env, static_cast<double>(item.wrongSequence)));
+        obj.Set("wrongCrc", Napi::Number::New(env, static_cast<double>(item.wrongCrc)));
+        obj.Set("wrongDataId", Napi::Number::New(env, static_cast<double>(item.wrongDataId)));
+        obj.Set("badLength", Napi::Number::New(env, static_cast<double>(item.badLength)));
+        obj.Set("lastStatus", Napi::String::New(env, E2eStatusName(item.lastStatus)));
+        obj.Set("lastCounter", Napi::Number::New(env, item.lastCounter));
+        result[static_cast<uint32_t>(i)] = obj;
+    }
+    return result;
+}
+
+// ==================== 残余总线仿真 ====================
+
+namespace {
+
+bool ParseRestBusByteOrder(const Napi::Object& obj, RestBusByteOrder* byteOrder) {
+    if (!obj.Has("byteOrder")) {
+        *byteOrder = RestBusByteOrder::Intel;
+        return true;
+    }
+    const std::string name = obj.Get("byteOrder").As<Napi::String>().Utf8Value();
+    if (name == "intel") {
+        *byteOrder = RestBusByteOrder::Intel;
+    } else if (name == "motorola") {
+        *byteOrder = RestBusByteOrder::Motorola;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+UINT MsToUs(const Napi::Value& value) {
+    return static_cast<UINT>(std::max(0.0, std::round(value.As<Napi::Number>().DoubleValue() * 1000.0)));
+}
+
+// 报文: { name?, id, fd?, brs?, data?, length?, periodMs, offsetMs?, enabled?, signals?, counter?, checksum?, e2e? }
+bool ParseRestBusMessage(const Napi::Object& obj, RestBusMessage* message, std::string* error) {
+    if (!obj.Has("id") || !obj.Has("periodMs")) {
+        *error = "报文需要id, periodMs";
+        return false;
+    }
+    message->id = obj.Get("id").As<Napi::Number>().Uint32Value();
+    if (obj.Has("name")) message->name = obj.Get("name").As<Napi::String>().Utf8Value();
+    if (obj.Has("fd")) message->fd = obj.Get("fd").ToBoolean();
+    if (obj.Has("brs")) message->brs = obj.Get("brs").ToBoolean();
+    if (obj.Has("enabled")) message->enabled = obj.Get("enabled").ToBoolean();
+    message->periodUs = MsToUs(obj.Get("periodMs"));
+    if (obj.Has("offsetMs")) message->offsetUs = MsToUs(obj.Get("offsetMs"));
+
+    // 长度默认为初始数据长度，都未给出时为8字节
+    Napi::Array data = obj.Has("data") ? obj.Get("data").As<Napi::Array>() : Napi::Array::New(obj.Env());
+    const uint32_t length = obj.Has("length") ? obj.Get("length").As<Napi::Number>().Uint32Value()
+                                              : (data.Length() > 0 ? data.Length() : 8);
+    message->data.assign(std::min<uint32_t>(length, CANFD_MAX_DLEN + 1), 0);
+    for (uint32_t i = 0; i < data.Length() && i < message->data.size(); i++) {
+        message->data[i] = static_cast<BYTE>(data.Get(i).As<Napi::Number>().Uint32Value());
+    }
+
+    if (obj.Has("signals") && obj.Get("signals").IsArray()) {
+        Napi::Array signals = obj.Get("signals").As<Napi::Array>();
+        for (uint32_t i = 0; i < signals.Length(); i++) {
+            Napi::Object item = signals.Get(i).As<Napi::Object>();
+            if (!item.Has("name") || !item.Has("startBit") || !item.Has("bitLength")) {
+                *error = "信号需要name, startBit, bitLength";
+                return false;
+            }
+            RestBusSignal signal;
+            signal.name = item.Get("name").As<Napi::String>().Utf8Value();
+            signal.startBit = item.Get("startBit").As<Napi::Number>().Uint32Value();
+            signal.bitLength = static_cast<BYTE>(std::min<uint32_t>(item.Get("bitLength").As<Napi::Number>().Uint32Value(), 0xFF));
+            if (!ParseRestBusByteOrder(item, &signal.byteOrder)) {
+                *error = "信号" + signal.name + "的byteOrder无效";
+                return false;
+            }
+            if (item.Has("signed")) signal.isSigned = item.Get("signed").ToBoolean();
+            if (item.Has("factor")) signal.factor = item.Get("factor").As<Napi::Number>().DoubleValue();
+            if (item.Has("offset")) signal.offset = item.Get("offset").As<Napi::Number>().DoubleValue();
+            if (item.Has("initial")) signal.initial = item.Get("initial").As<Napi::Number>().DoubleValue();
+            message->signals.push_back(signal);
+        }
+    }
+
+    if (obj.Has("counter") && obj.Get("counter").IsObject()) {
+        Napi::Object item = obj.Get("counter").As<Napi::Object>();
+        if (!item.Has("startBit") || !item.Has("bitLength")) {
+            *error = "计数器需要startBit, bitLength";
+            return false;
+        }
+        RestBusCounter& counter = message->counter;
+        counter.startBit = item.Get("startBit").As<Napi::Number>().Uint32Value();
+        counter.bitLength = static_cast<BYTE>(std::min<uint32_t>(item.Get("bitLength").As<Napi::Number>().Uint32Value(), 0xFF));
+        if (!ParseRestBusByteOrder(item, &counter.byteOrder)) {
+            *error = "计数器的byteOrder无效";
+            return false;
+        }
+        if (item.Has("min")) counter.min = item.Get("min").As<Napi::Number>().Uint32Value();
+        if (item.Has("max")) counter.max = item.Get("max").As<Napi::Number>().Uint32Value();
+        if (item.Has("step")) counter.step = item.Get("step").As<Napi::Number>().Uint32Value();
+    }
+
+    if (obj.Has("checksum") && obj.Get("checksum").IsObject()) {
+        static const std::map<std::string, RestBusChecksumType> types = {
+            {"sum8", RestBusChecksumType::Sum8}, {"xor8", RestBusChecksumType::Xor8}, {"crc8", RestBusChecksumType::Crc8},
+        };
+        Napi::Object item = obj.Get("checksum").As<Napi::Object>();
+        auto type = item.Has("type") ? types.find(item.Get("type").As<Napi::String>().Utf8Value()) : types.end();
+        if (type == types.end() || !item.Has("byte")) {
+            *error = "校验和需要type(sum8/xor8/crc8), byte";
+            return false;
+        }
+        RestBusChecksum& checksum = message->checksum;
+        checksum.type = type->second;
+        checksum.byte = item.Get("byte").As<Napi::Number>().Uint32Value();
+        if (item.Has("start")) checksum.start = item.Get("start").As<Napi::Number>().Uint32Value();
+        if (item.Has("length")) checksum.length = item.Get("length").As<Napi::Number>().Uint32Value();
+    }
+
+    if (obj.Has("e2e") && obj.Get("e2e").IsObject()) {
+        message->e2e = true;
+        if (!ParseE2eConfig(obj.Get("e2e").As<Napi::Object>(), &message->e2eConfig, error)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+void ZlgCanDevice::StopRestBusAt(UINT channelIndex) {
+    auto it = restBuses_.find(channelIndex);
+    if (it == restBuses_.end()) {
+        return;
+    }
+    // 引擎线程直接读取信号表内存，必须先停止线程再释放引用
+    it->second.engine->Stop();
+    it->second.table.Reset();
+    std::lock_guard<std::mutex> lock(handlesMutex_);
+    restBuses_.erase(it);
+}
+
+void ZlgCanDevice::StopAllRestBuses() {
+    while (!restBuses_.empty()) {
+        StopRestBusAt(restBuses_.begin()->first);
+    }
+}
+
+Napi::Value ZlgCanDevice::StartRestBus(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (deviceHandle_ == INVALID_DEVICE_HANDLE) {
+        Napi::Error::New(env, "设备未打开").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() < 2 || !info[1].IsArray()) {
+        Napi::TypeError::New(env, "需要2个参数: channelHandle, messages").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex)) {
+        Napi::Error::New(env, "通道未初始化").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    if (restBuses_.find(channelIndex) != restBuses_.end()) {
+        return env.Null();
+    }
+
+    RestBusOptions options;
+    if (info.Length() > 2 && info[2].IsObject()) {
+        Napi::Object opts = info[2].As<Napi::Object>();
+        if (opts.Has("tickUs")) options.tickUs = std::max<uint32_t>(1, opts.Get("tickUs").As<Napi::Number>().Uint32Value());
+        if (opts.Has("spinUs")) options.spinUs = opts.Get("spinUs").As<Napi::Number>().Uint32Value();
+    }
+
+    Napi::Array arr = info[1].As<Napi::Array>();
+    std::vector<RestBusMessage> messages(arr.Length());
+    std::string error;
+    for (uint32_t i = 0; i < arr.Length(); i++) {
+        if (!ParseRestBusMessage(arr.Get(i).As<Napi::Object>(), &messages[i], &error)) {
+            Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+            return env.Null();
+        }
+    }
+
+    RestBusEntry entry;
+    entry.engine.reset(new RestBusEngine(channelHandle, options));
+    if (!entry.engine->Load(messages, &error)) {
+        Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    // 信号表由V8分配，引擎持有引用期间不会被回收或移动
+    const std::vector<std::string>& names = entry.engine->SignalNames();
+    const std::vector<double>& initial = entry.engine->InitialValues();
+    Napi::ArrayBuffer table = Napi::ArrayBuffer::New(env, RestBusEngine::TableBytes(names.size()));
+    BYTE* tableData = static_cast<BYTE*>(table.Data());
+    memset(tableData, 0, RestBusEngine::TABLE_HEADER_BYTES);
+    if (!initial.empty()) {
+        memcpy(tableData + RestBusEngine::TABLE_HEADER_BYTES, initial.data(), initial.size() * sizeof(double));
+    }
+    entry.table = Napi::Persistent(table);
+    entry.engine->Start(tableData);
+
+    Napi::Array signalNames = Napi::Array::New(env, names.size());
+    for (size_t i = 0; i < names.size(); i++) {
+        signalNames[static_cast<uint32_t>(i)] = Napi::String::New(env, names[i]);
+    }
+    std::lock_guard<std::mutex> lock(handlesMutex_);
+    restBuses_[channelIndex] = std::move(entry);
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("table", table);
+    result.Set("signals", signalNames);
+    return result;
+}
+
+Napi::Value ZlgCanDevice::StopRestBus(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    if (!FindChannelIndex(channelHandle, &channelIndex) || restBuses_.find(channelIndex) == restBuses_.end()) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    StopRestBusAt(channelIndex);
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::RestBusSetEnabled(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 3) {
+        Napi::TypeError::New(env, "需要3个参数: channelHandle, name, enabled").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    auto it = FindChannelIndex(channelHandle, &channelIndex) ? restBuses_.find(channelIndex) : restBuses_.end();
+    if (it == restBuses_.end()) {
+        Napi::Error::New(env, "残余总线仿真未启动").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    return Napi::Boolean::New(env, it->second.engine->SetEnabled(
+        info[1].As<Napi::String>().Utf8Value(), info[2].ToBoolean()));
+}
+
+Napi::Value ZlgCanDevice::GetRestBusStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveChannelHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT channelIndex = 0;
+    auto it = FindChannelIndex(channelHandle, &channelIndex) ? restBuses_.find(channelIndex) : restBuses_.end();
+    if (it == restBuses_.end()) {
+        return env.Null();
+    }
+
+    RestBusStats stats = it->second.engine->Stats();
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("ticks", Napi::Number::New(env, static_cast<double>(stats.ticks)));
+    obj.Set("frames", Napi::Number::New(env, static_cast<double>(stats.frames)));
+    obj.Set("transmitCalls", Napi::Number::New(env, static_cast<double>(stats.transmitCalls)));
+    obj.Set("failedFrames", Napi::Number::New(env, static_cast<double>(stats.failedFrames)));
+    obj.Set("skippedCycles", Napi::Number::New(env, static_cast<double>(stats.skippedCycles)));
+    obj.Set("lateTicks", Napi::Number::New(env, static_cast<double>(stats.lateTicks)));
+    obj.Set("maxLatenessUs", Napi::Number::New(env, static_cast<double>(stats.maxLatenessUs)));
+    obj.Set("maxFramesPerTick", Napi::Number::New(env, static_cast<double>(stats.maxFramesPerTick)));
+    obj.Set("signalSnapshots", Napi::Number::New(env, static_cast<double>(stats.signalSnapshots)));
+    obj.Set("snapshotRetries", Napi::Number::New(env, static_cast<double>(stats.snapshotRetries)));
+    return obj;
+}
+
+// ==================== LIN通道 ====================
+
+namespace {
+
+void CallLinBatchCallback(Napi::Env env, Napi::Function callback, std::vector<ZCAN_LIN_MSG>* batch) {
+    if (env != nullptr && callback != nullptr) {
+        Napi::Array messages = Napi::Array::New(env, batch->size());
+        for (size_t i = 0; i < batch->size(); i++) {
+            messages[static_cast<uint32_t>(i)] = LinMessageToObject(env, (*batch)[i]);
+        }
+        callback.Call({messages});
+    }
+    delete batch;
+}
+
+void ParseLinData(const Napi::Value& value, BYTE* data, size_t capacity, BYTE* dataLen) {
+    Napi::Array arr = value.As<Napi::Array>();
+    const uint32_t length = std::min<uint32_t>(arr.Length(), static_cast<uint32_t>(capacity));
+    for (uint32_t i = 0; i < length; i++) {
+        data[i] = static_cast<BYTE>(arr.Get(i).As<Napi::Number>().Uint32Value());
+    }
+    *dataLen = static_cast<BYTE>(length);
+}
+
+bool ParseLinFrameType(const std::string& name, ZCAN_LIN_FRAME_TYPE* type) {
+    static const std::map<std::string, ZCAN_LIN_FRAME_TYPE> types = {
+        {"unconditional", ZCAN_LIN_FRAME_UNCONDITIONAL},
+        {"event", ZCAN_LIN_FRAME_EVENT},
+        {"sporadic", ZCAN_LIN_FRAME_SPORADIC},
+        {"masterRequest", ZCAN_LIN_FRAME_MST_REQ},
+        {"slaveResponse", ZCAN_LIN_FRAME_SLV_RESP},
+        {"reserved", ZCAN_LIN_FRAME_RESERVED},
+    };
+    auto it = types.find(name);
+    if (it == types.end()) {
+        return false;
+    }
+    *type = it->second;
+    return true;
+}
+
+// 调度表项: { id, slotMs, type?, relatedIds?, resolveSchedule? }
+bool ParseLinScheduleItem(const Napi::Object& item, ZCAN_LIN_SCHED_ITEM* out) {
+    memset(out, 0, sizeof(*out));
+    out->type = ZCAN_LIN_FRAME_UNCONDITIONAL;
+    if (item.Has("type") && !ParseLinFrameType(item.Get("type").As<Napi::String>().Utf8Value(), &out->type)) {
+        return false;
+    }
+    out->slot = item.Has("slotMs") ? item.Get("slotMs").As<Napi::Number>().Uint32Value() : 10;
+    out->resolve_handle = item.Has("resolveSchedule") ?
+        item.Get("resolveSchedule").As<Napi::Number>().Uint32Value() : INVALID_LIN_SCHED_HANDLE;
+
+    std::vector<BYTE> related;
+    if (item.Has("relatedIds")) {
+        Napi::Array arr = item.Get("relatedIds").As<Napi::Array>();
+        for (uint32_t i = 0; i < arr.Length() && i < 16; i++) {
+            related.push_back(static_cast<BYTE>(arr.Get(i).As<Napi::Number>().Uint32Value()));
+        }
+    }
+    const BYTE id = item.Has("id") ? static_cast<BYTE>(item.Get("id").As<Napi::Number>().Uint32Value()) : 0;
+
+    switch (out->type) {
+        case ZCAN_LIN_FRAME_EVENT:
+            out->ids.event_id.event_id = id;
+            std::copy(related.begin(), related.end(), out->ids.event_id.event_related_id);
+            out->ids.event_id.event_count = static_cast<BYTE>(related.size());
+            break;
+        case ZCAN_LIN_FRAME_SPORADIC:
+            std::copy(related.begin(), related.end(), out->ids.sporadic_id.spor_related_id);
+            out->ids.sporadic_id.spor_count = static_cast<BYTE>(related.size());
+            break;
+        default:
+            out->ids.id = id;
+            break;
+    }
+    return true;
+}
+
+}  // namespace
+
+bool ZlgCanDevice::FindLinIndex(CHANNEL_HANDLE channelHandle, UINT* linIndex) const {
+    std::lock_guard<std::mutex> lock(handlesMutex_);
+    auto it = linHandleIndex_.find(channelHandle);
+    if (it == linHandleIndex_.end()) {
+        return false;
+    }
+    *linIndex = it->second;
+    return true;
+}
+
+ZlgCanDevice::LinChannelEntry* ZlgCanDevice::FindLinChannel(CHANNEL_HANDLE channelHandle) {
+    std::lock_guard<std::mutex> lock(handlesMutex_);
+    for (auto& channel : linChannels_) {
+        if (channel.second.handle == channelHandle) {
+            return &channel.second;
+        }
+    }
+    return nullptr;
+}
+
+void ZlgCanDevice::StopLinReceivePump(LinChannelEntry& entry) {
+    if (entry.pump) {
+        entry.pump->Stop();
+        std::lock_guard<std::mutex> lock(handlesMutex_);
+        entry.pump.reset();
+    }
+    if (entry.tsfn) {
+        entry.tsfn.Release();
+        entry.tsfn = Napi::ThreadSafeFunction();
+    }
+}
+
+void ZlgCanDevice::DestroyLinSchedules(LinChannelEntry& entry) {
+    // 设备重连时监视线程会替换句柄并清空旧设备上的调度表，先在锁内取出
+    CHANNEL_HANDLE handle = INVALID_CHANNEL_HANDLE;
+    std::vector<ZCAN_LIN_SCHED_HANDLE> schedules;
+    {
+        std::lock_guard<std::mutex> lock(handlesMutex_);
+        handle = entry.handle;
+        schedules.swap(entry.schedules);
+    }
+    if (schedules.empty()) {
+        return;
+    }
+    ZcanStopLINSchedule(handle);
+    ZcanClrLINSchedule(handle);
+    for (ZCAN_LIN_SCHED_HANDLE schedule : schedules) {
+        ZcanDestroyLINSchedule(deviceHandle_, schedule);
+    }
+}
+
+void ZlgCanDevice::ReleaseAllLinChannels() {
+    for (auto& channel : linChannels_) {
+        StopLinReceivePump(channel.second);
+        DestroyLinSchedules(channel.second);
+    }
+    std::lock_guard<std::mutex> lock(handlesMutex_);
+    linChannels_.clear();
+}
+
+Napi::Value ZlgCanDevice::InitLinChannel(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (deviceHandle_ == INVALID_DEVICE_HANDLE) {
+        Napi::Error::New(env, "设备未打开").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() < 2 || !info[1].IsObject()) {
+        Napi::TypeError::New(env, "需要2个参数: linIndex, config").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    UINT linIndex = info[0].As<Napi::Number>().Uint32Value();
+    Napi::Object config = info[1].As<Napi::Object>();
+
+    ZCAN_LIN_INIT_CONFIG initConfig;
+    memset(&initConfig, 0, sizeof(initConfig));
+    initConfig.linMode = config.Has("linMode") ?
+        static_cast<BYTE>(config.Get("linMode").As<Napi::Number>().Uint32Value()) : 1;
+    initConfig.chkSumMode = config.Has("chkSumMode") ?
+        static_cast<BYTE>(config.Get("chkSumMode").As<Napi::Number>().Uint32Value()) : static_cast<BYTE>(ENHANCE_CHKSUM);
+    initConfig.maxLength = config.Has("maxLength") ?
+        static_cast<BYTE>(config.Get("maxLength").As<Napi::Number>().Uint32Value()) : 8;
+    initConfig.linBaud = config.Has("linBaud") ?
+        config.Get("linBaud").As<Napi::Number>().Uint32Value() : 19200;
+
+    // 重新初始化时旧句柄上的接收线程和调度表失效
+    auto it = linChannels_.find(linIndex);
+    if (it != linChannels_.end()) {
+        StopLinReceivePump(it->second);
+        DestroyLinSchedules(it->second);
+        std::lock_guard<std::mutex> lock(handlesMutex_);
+        linChannels_.erase(it);
+    }
+
+    CHANNEL_HANDLE channelHandle = ZcanInitLIN(deviceHandle_, linIndex, &initConfig);
+    if (channelHandle != INVALID_CHANNEL_HANDLE) {
+        {
+            std::lock_guard<std::mutex> lock(handlesMutex_);
+            linChannels_[linIndex].handle = channelHandle;
+            linHandleIndex_[channelHandle] = linIndex;
+        }
+        if (deviceMonitor_) {
+            deviceMonitor_->RecordInitLin(linIndex, initConfig, channelHandle);
+        }
+    }
+
+    return Napi::BigInt::New(env, reinterpret_cast<uint64_t>(channelHandle));
+}
+
+Napi::Value ZlgCanDevice::StartLinChannel(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveLinHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    const bool started = ZcanStartLIN(channelHandle) == STATUS_OK;
+    UINT linIndex = 0;
+    if (started && deviceMonitor_ && FindLinIndex(channelHandle, &linIndex)) {
+        deviceMonitor_->RecordStartLin(linIndex);
+    }
+    return Napi::Boolean::New(env, started);
+}
+
+Napi::Value ZlgCanDevice::ResetLinChannel(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveLinHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    LinChannelEntry* entry = FindLinChannel(channelHandle);
+    if (entry != nullptr) {
+        StopLinReceivePump(*entry);
+    }
+    const bool reset = ZcanResetLIN(channelHandle) == STATUS_OK;
+    UINT linIndex = 0;
+    if (reset && deviceMonitor_ && FindLinIndex(channelHandle, &linIndex)) {
+        deviceMonitor_->RecordResetLin(linIndex);
+    }
+    return Napi::Boolean::New(env, reset);
+}
+
+Napi::Value ZlgCanDevice::TransmitLin(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2) {
+        Napi::TypeError::New(env, "需要2个参数: channelHandle, frame/frames").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveLinHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT linIndex = 0;
+    FindLinIndex(channelHandle, &linIndex);
+    const BYTE chnl = static_cast<BYTE>(linIndex);
+
+    std::vector<Napi::Object> frameObjs;
+    if (info[1].IsArray()) {
+        Napi::Array arr = info[1].As<Napi::Array>();
+        for (uint32_t i = 0; i < arr.Length(); i++) {
+            frameObjs.push_back(arr.Get(i).As<Napi::Object>());
+        }
+    } else {
+        frameObjs.push_back(info[1].As<Napi::Object>());
+    }
+
+    std::vector<ZCAN_LIN_MSG> messages(frameObjs.size());
+    for (size_t i = 0; i < frameObjs.size(); i++) {
+        memset(&messages[i], 0, sizeof(ZCAN_LIN_MSG));
+        messages[i].chnl = chnl;
+        messages[i].dataType = 0;
+        ZCANLINData& lin = messages[i].data.zcanLINData;
+        lin.PID.unionVal.ID = frameObjs[i].Get("id").As<Napi::Number>().Uint32Value() & 0x3F;
+        if (frameObjs[i].Has("data")) {
+            ParseLinData(frameObjs[i].Get("data"), lin.RxData.data, sizeof(lin.RxData.data), &lin.RxData.dataLen);
+        }
+    }
+
+    UINT sentCount = ZcanTransmitLIN(channelHandle, messages.data(), static_cast<UINT>(messages.size()));
+    return Napi::Number::New(env, sentCount);
+}
+
+Napi::Value ZlgCanDevice::ReceiveLin(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2) {
+        Napi::TypeError::New(env, "需要至少2个参数: channelHandle, count").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveLinHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    UINT count = info[1].As<Napi::Number>().Uint32Value();
+    int waitTime = info.Length() > 2 ? info[2].As<Napi::Number>().Int32Value() : -1;
+
+    std::vector<ZCAN_LIN_MSG> messages(count);
+    LinChannelEntry* entry = FindLinChannel(channelHandle);
+    UINT receivedCount = entry != nullptr && entry->pump
+        ? entry->pump->Pop(messages.data(), count, waitTime)
+        : ZcanReceiveLIN(channelHandle, messages.data(), count, waitTime);
+
+    Napi::Array result = Napi::Array::New(env, receivedCount);
+    for (UINT i = 0; i < receivedCount; i++) {
+        result[i] = LinMessageToObject(env, messages[i]);
+    }
+    return result;
+}
+
+Napi::Value ZlgCanDevice::GetLinReceiveNum(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveLinHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    LinChannelEntry* entry = FindLinChannel(channelHandle);
+    if (entry != nullptr && entry->pump) {
+        return Napi::Number::New(env, static_cast<double>(entry->pump->Stats().ringDepth));
+    }
+    return Napi::Number::New(env, ZcanGetLINReceiveNum(channelHandle));
+}
+
+Napi::Value ZlgCanDevice::SetLinPublish(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[1].IsArray()) {
+        Napi::TypeError::New(env, "需要2个参数: channelHandle, configs").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveLinHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    Napi::Array arr = info[1].As<Napi::Array>();
+    std::vector<ZCAN_LIN_PUBLISH_CFG_EX> configs(arr.Length());
+    bool extended = false;
+    for (uint32_t i = 0; i < arr.Length(); i++) {
+        Napi::Object cfg = arr.Get(i).As<Napi::Object>();
+        memset(&configs[i], 0, sizeof(ZCAN_LIN_PUBLISH_CFG_EX));
+        configs[i].ID = static_cast<BYTE>(cfg.Get("id").As<Napi::Number>().Uint32Value() & 0x3F);
+        ParseLinData(cfg.Get("data"), configs[i].data, sizeof(configs[i].data), &configs[i].dataLen);
+        configs[i].chkSumMode = cfg.Has("chkSumMode") ?
+            static_cast<BYTE>(cfg.Get("chkSumMode").As<Napi::Number>().Uint32Value()) : static_cast<BYTE>(DEFAULT);
+        extended = extended || configs[i].dataLen > 8;
+    }
+
+    UINT result;
+    if (extended) {
+        result = ZcanSetLINPublishEx(channelHandle, configs.data(), static_cast<UINT>(configs.size()));
+    } else {
+        std::vector<ZCAN_LIN_PUBLISH_CFG> classic(configs.size());
+        for (size_t i = 0; i < configs.size(); i++) {
+            memset(&classic[i], 0, sizeof(ZCAN_LIN_PUBLISH_CFG));
+            classic[i].ID = configs[i].ID;
+            classic[i].dataLen = configs[i].dataLen;
+            memcpy(classic[i].data, configs[i].data, sizeof(classic[i].data));
+            classic[i].chkSumMode = configs[i].chkSumMode;
+        }
+        result = ZcanSetLINPublish(channelHandle, classic.data(), static_cast<UINT>(classic.size()));
+    }
+    UINT linIndex = 0;
+    if (result == STATUS_OK && deviceMonitor_ && FindLinIndex(channelHandle, &linIndex)) {
+        deviceMonitor_->RecordLinPublish(linIndex, configs, extended);
+    }
+    return Napi::Boolean::New(env, result == STATUS_OK);
+}
+
+Napi::Value ZlgCanDevice::SetLinSubscribe(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[1].IsArray()) {
+        Napi::TypeError::New(env, "需要2个参数: channelHandle, configs").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveLinHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    Napi::Array arr = info[1].As<Napi::Array>();
+    std::vector<ZCAN_LIN_SUBSCIBE_CFG> configs(arr.Length());
+    for (uint32_t i = 0; i < arr.Length(); i++) {
+        Napi::Object cfg = arr.Get(i).As<Napi::Object>();
+        memset(&configs[i], 0, sizeof(ZCAN_LIN_SUBSCIBE_CFG));
+        configs[i].ID = static_cast<BYTE>(cfg.Get("id").As<Napi::Number>().Uint32Value() & 0x3F);
+        configs[i].dataLen = cfg.Has("dataLen") ?
+            static_cast<BYTE>(cfg.Get("dataLen").As<Napi::Number>().Uint32Value()) : 0xFF;
+        configs[i].chkSumMode = cfg.Has("chkSumMode") ?
+            static_cast<BYTE>(cfg.Get("chkSumMode").As<Napi::Number>().Uint32Value()) : static_cast<BYTE>(DEFAULT);
+    }
+
+    UINT result = ZcanSetLINSubscribe(channelHandle, configs.data(), static_cast<UINT>(configs.size()));
+    UINT linIndex = 0;
+    if (result == STATUS_OK && deviceMonitor_ && FindLinIndex(channelHandle, &linIndex)) {
+        deviceMonitor_->RecordLinSubscribe(linIndex, configs);
+    }
+    return Napi::Boolean::New(env, result == STATUS_OK);
+}
+
+Napi::Value ZlgCanDevice::WakeUpLin(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveLinHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    return Napi::Boolean::New(env, ZcanWakeUpLIN(channelHandle) == STATUS_OK);
+}
+
+Napi::Value ZlgCanDevice::StartLinReceiveThread(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要至少1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveLinHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    LinChannelEntry* entry = FindLinChannel(channelHandle);
+    if (entry == nullptr) {
+        Napi::Error::New(env, "LIN通道未初始化").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    if (entry->pump) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    ReceivePumpOptions options;
+    if (info.Length() > 1 && info[1].IsObject()) {
+        Napi::Object opts = info[1].As<Napi::Object>();
+        if (opts.Has("ringCapacity")) options.ringCapacity = opts.Get("ringCapacity").As<Napi::Number>().Uint32Value();
+        if (opts.Has("batchSize")) options.batchSize = opts.Get("batchSize").As<Napi::Number>().Uint32Value();
+        if (opts.Has("idleSleepUs")) options.idleSleepUs = opts.Get("idleSleepUs").As<Napi::Number>().Uint32Value();
+        if (opts.Has("blockWaitMs")) options.blockWaitMs = opts.Get("blockWaitMs").As<Napi::Number>().Uint32Value();
+    }
+
+    LinReceivePump::BatchCallback callback;
+    if (info.Length() > 2 && info[2].IsFunction()) {
+        // 回调队列按批计，与缓存方式相同地以ringCapacity限制待交付的消息数；JS处理跟不上时丢弃并计数
+        const size_t queueSize = std::max<size_t>(options.ringCapacity / std::max<UINT>(options.batchSize, 1), 1);
+        entry->tsfn = Napi::ThreadSafeFunction::New(env, info[2].As<Napi::Function>(), "ZlgCanLinReceive", queueSize, 1);
+        // 接收回调不应阻止进程退出
+        entry->tsfn.Unref(env);
+        Napi::ThreadSafeFunction tsfn = entry->tsfn;
+        callback = [tsfn](std::vector<ZCAN_LIN_MSG>&& messages) {
+            auto* batch = new std::vector<ZCAN_LIN_MSG>(std::move(messages));
+            if (tsfn.NonBlockingCall(batch, CallLinBatchCallback) != napi_ok) {
+                delete batch;
+                return false;
+            }
+            return true;
+        };
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(handlesMutex_);
+        entry->pump.reset(new LinReceivePump(channelHandle, options, std::move(callback)));
+    }
+    entry->pump->Start();
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::StopLinReceiveThread(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveLinHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    LinChannelEntry* entry = FindLinChannel(channelHandle);
+    if (entry == nullptr || !entry->pump) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    StopLinReceivePump(*entry);
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::GetLinReceiveThreadStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveLinHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    LinChannelEntry* entry = FindLinChannel(channelHandle);
+    if (entry == nullptr || !entry->pump) {
+        return env.Null();
+    }
+
+    LinReceivePumpStats stats = entry->pump->Stats();
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("framesReceived", Napi::Number::New(env, static_cast<double>(stats.framesReceived)));
+    obj.Set("framesDropped", Napi::Number::New(env, static_cast<double>(stats.framesDropped)));
+    obj.Set("wakeups", Napi::Number::New(env, static_cast<double>(stats.wakeups)));
+    obj.Set("ringDepth", Napi::Number::New(env, static_cast<double>(stats.ringDepth)));
+    return obj;
+}
+
+// ==================== 接口调用统计 ====================
+
+Napi::Value ZlgCanDevice::GetStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    const ApiStatsSnapshot snapshot = ApiStatsTake();
+
+    Napi::Object apis = Napi::Object::New(env);
+    for (const ApiStatsEntry& entry : snapshot.entries) {
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("calls", Napi::Number::New(env, static_cast<double>(entry.calls)));
+        obj.Set("errors", Napi::Number::New(env, static_cast<double>(entry.errors)));
+        obj.Set("frames", Napi::Number::New(env, static_cast<double>(entry.frames)));
+        obj.Set("bytes", Napi::Number::New(env, static_cast<double>(entry.bytes)));
+        obj.Set("totalUs", Napi::Number::New(env, entry.totalNs / 1000.0));
+        obj.Set("meanUs", Napi::Number::New(env, entry.totalNs / 1000.0 / static_cast<double>(entry.calls)));
+        obj.Set("p50Us", Napi::Number::New(env, entry.p50Ns / 1000.0));
+        obj.Set("p90Us", Napi::Number::New(env, entry.p90Ns / 1000.0));
+        obj.Set("p99Us", Napi::Number::New(env, entry.p99Ns / 1000.0));
+        obj.Set("p999Us", Napi::Number::New(env, entry.p999Ns / 1000.0));
+        obj.Set("maxUs", Napi::Number::New(env, entry.maxNs / 1000.0));
+
+        Napi::Array histogram = Napi::Array::New(env, entry.histogram.size());
+        for (size_t i = 0; i < entry.histogram.size(); i++) {
+            Napi::Array bucket = Napi::Array::New(env, 2);
+            bucket[0u] = Napi::Number::New(env, entry.histogram[i].first / 1000.0);
+            bucket[1u] = Napi::Number::New(env, static_cast<double>(entry.histogram[i].second));
+            histogram[static_cast<uint32_t>(i)] = bucket;
+        }
+        obj.Set("histogram", histogram);
+        apis.Set(entry.name, obj);
+    }
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("nsPerTick", Napi::Number::New(env, snapshot.nsPerTick));
+    result.Set("threads", Napi::Number::New(env, static_cast<double>(snapshot.threads)));
+    result.Set("apis", apis);
+    return result;
+}
+
+Napi::Value ZlgCanDevice::ResetStats(const Napi::CallbackInfo& info) {
+    ApiStatsReset();
+    return info.Env().Undefined();
+}
+
+// ==================== 时间线记录 ====================
+
+Napi::Value ZlgCanDevice::TraceStartMethod(const Napi::CallbackInfo& info) {
+    constexpr uint32_t DEFAULT_TRACE_CAPACITY = 1 << 18;
+    const uint32_t capacity = info.Length() > 0 && info[0].IsNumber()
+        ? info[0].As<Napi::Number>().Uint32Value() : DEFAULT_TRACE_CAPACITY;
+    TraceSetThreadName("js-main");
+    TraceStart(capacity);
+    return info.Env().Undefined();
+}
+
+Napi::Value ZlgCanDevice::TraceStopMethod(const Napi::CallbackInfo& info) {
+    TraceStop();
+    return info.Env().Undefined();
+}
+
+Napi::Value ZlgCanDevice::TraceDump(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    const TraceSnapshot snapshot = TraceCollect();
+
+    // 时间单位为us，与Chrome trace事件格式一致
+    Napi::Array events = Napi::Array::New(env, snapshot.events.size());
+    for (size_t i = 0; i < snapshot.events.size(); i++) {
+        const TraceEventRecord& record = snapshot.events[i];
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("name", Napi::String::New(env, record.name));
+        obj.Set("cat", Napi::String::New(env, record.category));
+        obj.Set("ph", Napi::String::New(env, std::string(1, record.phase)));
+        obj.Set("tid", Napi::Number::New(env, record.tid));
+        obj.Set("ts", Napi::Number::New(env, static_cast<double>(record.startNs) / 1000.0));
+        obj.Set("dur", Napi::Number::New(env, static_cast<double>(record.durationNs) / 1000.0));
+        obj.Set("arg", Napi::Number::New(env, static_cast<double>(record.arg)));
+        events[static_cast<uint32_t>(i)] = obj;
+    }
+
+    Napi::Object threads = Napi::Object::New(env);
+    for (const auto& thread : snapshot.threads) {
+        threads.Set(std::to_string(thread.first), Napi::String::New(env, thread.second));
+    }
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("events", events);
+    result.Set("threads", threads);
+    result.Set("callerTid", Napi::Number::New(env, snapshot.callerTid));
+    result.Set("overwritten", Napi::Number::New(env, static_cast<double>(snapshot.overwritten)));
+    return result;
+}
+
+// ==================== 原生线程调度 ====================
+
+namespace {
+
+bool ParseThreadRole(const std::string& name, ThreadRole* role) {
+    for (size_t i = 0; i < static_cast<size_t>(ThreadRole::Count); i++) {
+        if (name == ThreadRoleName(static_cast<ThreadRole>(i))) {
+            *role = static_cast<ThreadRole>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+Napi::Object ThreadSchedulingToObject(Napi::Env env, const ThreadSchedulingState& state) {
+    Napi::Array cpus = Napi::Array::New(env, state.policy.cpus.size());
+    for (size_t i = 0; i < state.policy.cpus.size(); i++) {
+        cpus.Set(static_cast<uint32_t>(i), Napi::Number::New(env, state.policy.cpus[i]));
+    }
+    Napi::Object latency = Napi::Object::New(env);
+    latency.Set("wakeups", Napi::Number::New(env, static_cast<double>(state.wakeups)));
+    latency.Set("meanUs", Napi::Number::New(env, state.meanNs / 1000.0));
+    latency.Set("p50Us", Napi::Number::New(env, state.p50Ns / 1000.0));
+    latency.Set("p99Us", Napi::Number::New(env, state.p99Ns / 1000.0));
+    latency.Set("p999Us", Napi::Number::New(env, state.p999Ns / 1000.0));
+    latency.Set("maxUs", Napi::Number::New(env, static_cast<double>(state.maxNs) / 1000.0));
+
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("realtime", Napi::Boolean::New(env, state.policy.realtime));
+    obj.Set("priority", Napi::Number::New(env, state.policy.priority));
+    obj.Set("cpus", cpus);
+    obj.Set("threads", Napi::Number::New(env, state.threads));
+    obj.Set("realtimeApplied", Napi::Boolean::New(env, state.realtimeApplied));
+    obj.Set("affinityApplied", Napi::Boolean::New(env, state.affinityApplied));
+    if (!state.fallback.empty()) {
+        obj.Set("fallback", Napi::String::New(env, state.fallback));
+    }
+    if (!state.error.empty()) {
+        obj.Set("error", Napi::String::New(env, state.error));
+    }
+    obj.Set("wakeupLatency", latency);
+    return obj;
+}
+
+}  // namespace
+
+Napi::Value ZlgCanDevice::SetThreadScheduling(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsString() || !info[1].IsObject()) {
+        Napi::TypeError::New(env, "需要2个参数: role, policy").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    ThreadRole role;
+    if (!ParseThreadRole(info[0].As<Napi::String>().Utf8Value(), &role)) {
+        Napi::TypeError::New(env, "role必须是receive、transmit或monitor").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    ThreadSchedulingPolicy policy;
+    Napi::Object opts = info[1].As<Napi::Object>();
+    if (opts.Has("realtime")) {
+        policy.realtime = opts.Get("realtime").ToBoolean().Value();
+    }
+    if (opts.Has("priority")) {
+        policy.priority = opts.Get("priority").As<Napi::Number>().Int32Value();
+    }
+    if (opts.Has("cpus") && opts.Get("cpus").IsArray()) {
+        Napi::Array cpus = opts.Get("cpus").As<Napi::Array>();
+        for (uint32_t i = 0; i < cpus.Length(); i++) {
+            policy.cpus.push_back(cpus.Get(i).As<Napi::Number>().Uint32Value());
+        }
+    }
+
+    ThreadSchedulingConfigure(role, policy);
+    return ThreadSchedulingToObject(env, ThreadSchedulingQuery(role));
+}
+
+Napi::Value ZlgCanDevice::GetThreadScheduling(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Napi::Object result = Napi::Object::New(env);
+    for (size_t i = 0; i < static_cast<size_t>(ThreadRole::Count); i++) {
+        const ThreadRole role = static_cast<ThreadRole>(i);
+        result.Set(ThreadRoleName(role), ThreadSchedulingToObject(env, ThreadSchedulingQuery(role)));
+    }
+    return result;
+}
+
+Napi::Value ZlgCanDevice::ResetThreadLatency(const Napi::CallbackInfo& info) {
+    ThreadSchedulingResetLatency();
+    return info.Env().Undefined();
+}
+
+// ==================== LIN调度表 ====================
+
+Napi::Value ZlgCanDevice::AddLinSchedule(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (deviceHandle_ == INVALID_DEVICE_HANDLE) {
+        Napi::Error::New(env, "设备未打开").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() < 2 || !info[1].IsArray()) {
+        Napi::TypeError::New(env, "需要至少2个参数: channelHandle, items").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveLinHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    LinChannelEntry* entry = FindLinChannel(channelHandle);
+    if (entry == nullptr) {
+        Napi::Error::New(env, "LIN通道未初始化").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Array arr = info[1].As<Napi::Array>();
+    std::vector<ZCAN_LIN_SCHED_ITEM> items(arr.Length());
+    for (uint32_t i = 0; i < arr.Length(); i++) {
+        if (!ParseLinScheduleItem(arr.Get(i).As<Napi::Object>(), &items[i])) {
+            Napi::TypeError::New(env, "调度表项" + std::to_string(i) + "的type无效").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+    }
+    UINT runCount = info.Length() > 2 ? info[2].As<Napi::Number>().Uint32Value() : 0;
+
+    ZCAN_LIN_SCHED_HANDLE schedule = ZcanCreateLINSchedule(deviceHandle_, items.data(), static_cast<UINT>(items.size()));
+    if (schedule == INVALID_LIN_SCHED_HANDLE) {
+        return env.Null();
+    }
+    if (ZcanAddLINSchedule(channelHandle, schedule, runCount) != STATUS_OK) {
+        ZcanDestroyLINSchedule(deviceHandle_, schedule);
+        return env.Null();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(handlesMutex_);
+        entry->schedules.push_back(schedule);
+    }
+    return Napi::Number::New(env, schedule);
+}
+
+Napi::Value ZlgCanDevice::StartLinSchedule(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveLinHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    return Napi::Boolean::New(env, ZcanStartLINSchedule(channelHandle) == STATUS_OK);
+}
+
+Napi::Value ZlgCanDevice::StopLinSchedule(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveLinHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    return Napi::Boolean::New(env, ZcanStopLINSchedule(channelHandle) == STATUS_OK);
+}
+
+Napi::Value ZlgCanDevice::ClearLinSchedules(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "需要1个参数: channelHandle").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveLinHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    LinChannelEntry* entry = FindLinChannel(channelHandle);
+    if (entry == nullptr) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    DestroyLinSchedules(*entry);
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value ZlgCanDevice::SetLinScheduleEnabled(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 3) {
+        Napi::TypeError::New(env, "需要至少3个参数: channelHandle, schedule, enabled").ThrowAsJavaScriptException();
+        return env.Null();
+    }
 
+    CHANNEL_HANDLE channelHandle = ResolveLinHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    ZCAN_LIN_SCHED_HANDLE schedule = info[1].As<Napi::Number>().Uint32Value();
+    UINT enabled = info[2].ToBoolean() ? 1 : 0;
+
+    // 指定表项索引时只切换该表项
+    UINT result = info.Length() > 3 && info[3].IsNumber()
+        ? ZcanSetLINScheduleItemEnabled(channelHandle, schedule, info[3].As<Napi::Number>().Uint32Value(), enabled)
+        : ZcanSetLINScheduleEnabled(channelHandle, schedule, enabled);
     return Napi::Boolean::New(env, result == STATUS_OK);
 }
 
+Napi::Value ZlgCanDevice::GetLinScheduleStatus(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2) {
+        Napi::TypeError::New(env, "需要2个参数: channelHandle, schedule").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    CHANNEL_HANDLE channelHandle = ResolveLinHandle(GetChannelHandleFromValue(env, info[0]));
+    if (env.IsExceptionPending()) return env.Null();
+
+    ZCAN_LIN_SCHED_HANDLE schedule = info[1].As<Napi::Number>().Uint32Value();
+    ZCAN_LIN_SCHED_STATUS status = ZCAN_LIN_SCHED_STATUS_IDLE;
+    if (ZcanGetLINScheduleStatus(channelHandle, schedule, &status) != STATUS_OK) {
+        return env.Null();
+    }
+    return Napi::Number::New(env, status);
+}
+
 // 模块初始化
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
+    ApiStatsInit();
+
     // 导出常量
     // 设备类型
     exports.Set("ZCAN_PCI5121", Napi::Number::New(env, ZCAN_PCI5121));
@@ -0,0 +1,516 @@
+/**
+ * CANopen节点模拟器
+ * 在设备的一个CAN通道上实现CiA 301从站：SDO服务器（加速、分段和带CRC的块传输）、
+ * NMT状态机、心跳生产者、周期TPDO和紧急报文，用于无真实节点时测试CANopen客户端。
+ * 默认运行在虚拟设备上，也可挂在与客户端通道物理相连的另一通道。
+ *
+ * 单独运行: npx ts-node test/canopen-node-simulator.ts [设备类型] [设备索引] [通道] [节点号]
+ */
+
+import { ZlgCanDevice, ChannelHandle, CanType, DeviceType, DeviceTypeValue, CanOpenNmtState } from '../src/zlgcan';
+
+// ============== 协议常量 ==============
+
+const COB_SDO_TX = 0x580;
+const COB_SDO_RX = 0x600;
+const COB_HEARTBEAT = 0x700;
+const COB_EMCY = 0x080;
+
+const Abort = {
+    TOGGLE: 0x05030000,
+    COMMAND: 0x05040001,
+    BLOCK_SIZE: 0x05040002,
+    SEQUENCE: 0x05040003,
+    CRC: 0x05040004,
+    NOT_EXIST: 0x06020000,
+    READ_ONLY: 0x06010002,
+    LENGTH: 0x06070010,
+} as const;
+
+/** 模拟对象（索引 << 8 | 子索引） */
+export const CanOpenSimulatedObjects = {
+    /** uint32 设备类型 */
+    DEVICE_TYPE: 0x100000,
+    /** 字符串 设备名称（21字节） */
+    DEVICE_NAME: 0x100800,
+    /** uint16 心跳生产时间（毫秒），可写 */
+    HEARTBEAT_TIME: 0x101700,
+    /** 4096字节只读数据块，内容为(i * 31 + 7) & 0xFF */
+    LARGE_DOMAIN: 0x200000,
+    /** 可写数据块，保存下载的数据 */
+    WRITABLE_DOMAIN: 0x200100,
+    /** uint16 状态字，TPDO1 */
+    STATUSWORD: 0x604100,
+    /** int32 实际速度，TPDO1，每100ms加1 */
+    VELOCITY: 0x606C00,
+} as const;
+
+/** 模拟器配置 */
+export interface CanOpenNodeSimulatorOptions {
+    /** 节点号，默认5 */
+    nodeId?: number;
+    /** 心跳周期（毫秒），默认100，0不发送 */
+    heartbeatMs?: number;
+    /** TPDO周期（毫秒），默认10 */
+    pdoPeriodMs?: number;
+    /** 块下载时本端的块大小，默认32 */
+    blockSize?: number;
+    /** 不支持块传输，以中止码0x05040001拒绝 */
+    disableBlock?: boolean;
+    /** 命令轮询间隔（毫秒），默认1 */
+    pollIntervalMs?: number;
+}
+
+/** 模拟器统计 */
+export interface CanOpenNodeSimulatorStats {
+    sdoRequests: number;
+    aborts: number;
+    blocks: number;
+    heartbeats: number;
+    pdos: number;
+}
+
+/** CRC-16-CCITT（多项式0x1021，初值0） */
+export function canopenCrc16(data: Uint8Array): number {
+    let crc = 0;
+    for (const byte of data) {
+        crc ^= byte << 8;
+        for (let bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) & 0xFFFF : (crc << 1) & 0xFFFF;
+        }
+    }
+    return crc;
+}
+
+type SdoState =
+    | { kind: 'idle' }
+    | { kind: 'uploadSegment'; data: Buffer; offset: number; toggle: number }
+    | { kind: 'downloadSegment'; key: number; chunks: Buffer[]; toggle: number }
+    | { kind: 'blockUploadInitiated'; data: Buffer; blockSize: number }
+    | { kind: 'blockUpload'; data: Buffer; offset: number; blockStart: number; blockSize: number; crc: boolean }
+    | { kind: 'blockUploadEnd' }
+    | { kind: 'blockDownload'; key: number; size: number; chunks: Buffer[]; sequence: number; crc: boolean }
+    | { kind: 'blockDownloadEnd'; key: number; size: number; data: Buffer; crc: boolean };
+
+export class CanOpenNodeSimulator {
+    private options: Required<CanOpenNodeSimulatorOptions>;
+    private objects = new Map<number, Buffer>();
+    private writable = new Set<number>([CanOpenSimulatedObjects.HEARTBEAT_TIME, CanOpenSimulatedObjects.WRITABLE_DOMAIN]);
+    private state: number = CanOpenNmtState.PRE_OPERATIONAL;
+    private sdo: SdoState = { kind: 'idle' };
+    private velocity = 0;
+    private pollTimer: NodeJS.Timeout | null = null;
+    private heartbeatTimer: NodeJS.Timeout | null = null;
+    private pdoTimer: NodeJS.Timeout | null = null;
+    private velocityTimer: NodeJS.Timeout | null = null;
+
+    readonly stats: CanOpenNodeSimulatorStats = { sdoRequests: 0, aborts: 0, blocks: 0, heartbeats: 0, pdos: 0 };
+
+    constructor(private device: ZlgCanDevice, private channelHandle: ChannelHandle, options: CanOpenNodeSimulatorOptions = {}) {
+        this.options = {
+            nodeId: options.nodeId ?? 5,
+            heartbeatMs: options.heartbeatMs ?? 100,
+            pdoPeriodMs: options.pdoPeriodMs ?? 10,
+            blockSize: options.blockSize ?? 32,
+            disableBlock: options.disableBlock ?? false,
+            pollIntervalMs: options.pollIntervalMs ?? 1,
+        };
+
+        const u32 = (value: number) => { const b = Buffer.alloc(4); b.writeUInt32LE(value >>> 0); return b; };
+        const u16 = (value: number) => { const b = Buffer.alloc(2); b.writeUInt16LE(value); return b; };
+        this.objects.set(CanOpenSimulatedObjects.DEVICE_TYPE, u32(0x00020192));
+        this.objects.set(CanOpenSimulatedObjects.DEVICE_NAME, Buffer.from('ZLG CANopen simulator'));
+        this.objects.set(CanOpenSimulatedObjects.HEARTBEAT_TIME, u16(this.options.heartbeatMs));
+        this.objects.set(CanOpenSimulatedObjects.LARGE_DOMAIN, Buffer.from(Array.from({ length: 4096 }, (_, i) => (i * 31 + 7) & 0xFF)));
+        this.objects.set(CanOpenSimulatedObjects.WRITABLE_DOMAIN, Buffer.alloc(0));
+        this.objects.set(CanOpenSimulatedObjects.STATUSWORD, u16(0x0237));
+        this.objects.set(CanOpenSimulatedObjects.VELOCITY, u32(0));
+    }
+
+    /** 发送启动报文并开始运行，进入预运行状态 */
+    start(): void {
+        if (this.pollTimer) {
+            return;
+        }
+        this.pollTimer = setInterval(() => this.poll(), this.options.pollIntervalMs);
+        this.pdoTimer = setInterval(() => this.sendPdos(), this.options.pdoPeriodMs);
+        this.velocityTimer = setInterval(() => {
+            this.velocity++;
+            this.objects.get(CanOpenSimulatedObjects.VELOCITY)!.writeInt32LE(this.velocity);
+        }, 100);
+        this.bootup();
+    }
+
+    stop(): void {
+        for (const timer of [this.pollTimer, this.heartbeatTimer, this.pdoTimer, this.velocityTimer]) {
+            if (timer) {
+                clearInterval(timer);
+            }
+        }
+        this.pollTimer = this.heartbeatTimer = this.pdoTimer = this.velocityTimer = null;
+    }
+
+    /** 暂停发送心跳（模拟节点掉线），paused为false时恢复 */
+    setHeartbeatPaused(paused: boolean): void {
+        if (paused) {
+            if (this.heartbeatTimer) {
+                clearInterval(this.heartbeatTimer);
+                this.heartbeatTimer = null;
+            }
+        } else {
+            this.restartHeartbeat();
+        }
+    }
+
+    /** 发送紧急报文 */
+    emergency(errorCode: number, errorRegister: number, data: number[] = []): void {
+        const payload = [errorCode & 0xFF, (errorCode >> 8) & 0xFF, errorRegister, ...data, 0, 0, 0, 0, 0].slice(0, 8);
+        this.send(COB_EMCY + this.options.nodeId, [Buffer.from(payload)]);
+    }
+
+    /** 读取对象，供测试核对下载 */
+    readObject(key: number): Buffer | undefined {
+        return this.objects.get(key);
+    }
+
+    get nmtState(): number {
+        return this.state;
+    }
+
+    // ============== NMT/心跳/PDO ==============
+
+    private bootup(): void {
+        this.state = CanOpenNmtState.PRE_OPERATIONAL;
+        this.sdo = { kind: 'idle' };
+        this.send(COB_HEARTBEAT + this.options.nodeId, [Buffer.from([CanOpenNmtState.BOOTUP])]);
+        this.restartHeartbeat();
+    }
+
+    private restartHeartbeat(): void {
+        if (this.heartbeatTimer) {
+            clearInterval(this.heartbeatTimer);
+            this.heartbeatTimer = null;
+        }
+        const period = this.objects.get(CanOpenSimulatedObjects.HEARTBEAT_TIME)!.readUInt16LE(0);
+        if (period > 0 && this.pollTimer) {
+            this.heartbeatTimer = setInterval(() => {
+                this.stats.heartbeats++;
+                this.send(COB_HEARTBEAT + this.options.nodeId, [Buffer.from([this.state])]);
+            }, period);
+        }
+    }
+
+    private handleNmt(data: number[]): void {
+        if (data.length < 2 || (data[1] !== 0 && data[1] !== this.options.nodeId)) {
+            return;
+        }
+        switch (data[0]) {
+            case 0x01: this.state = CanOpenNmtState.OPERATIONAL; break;
+            case 0x02: this.state = CanOpenNmtState.STOPPED; break;
+            case 0x80: this.state = CanOpenNmtState.PRE_OPERATIONAL; break;
+            case 0x81:
+            case 0x82: this.bootup(); break;
+        }
+    }
+
+    private sendPdos(): void {
+        if (this.state !== CanOpenNmtState.OPERATIONAL) {
+            return;
+        }
+        // TPDO1: 状态字(16) + 实际速度(32)
+        const tpdo1 = Buffer.concat([this.objects.get(CanOpenSimulatedObjects.STATUSWORD)!, this.objects.get(CanOpenSimulatedObjects.VELOCITY)!]);
+        this.stats.pdos++;
+        this.send(0x180 + this.options.nodeId, [tpdo1]);
+    }
+
+    // ============== SDO服务器 ==============
+
+    private poll(): void {
+        const frames = this.device.receive(this.channelHandle, 256, 0);
+        for (const frame of frames) {
+            const id = frame.id & 0x1FFFFFFF;
+            if (id === 0) {
+                this.handleNmt(frame.data);
+            } else if (id === COB_SDO_RX + this.options.nodeId && frame.data.length === 8 &&
+                       this.state !== CanOpenNmtState.STOPPED) {
+                this.stats.sdoRequests++;
+                this.handleSdo(Buffer.from(frame.data));
+            }
+        }
+    }
+
+    private handleSdo(request: Buffer): void {
+        const command = request[0];
+        const key = (request.readUInt16LE(1) << 8) | request[3];
+
+        if (command === 0x80) {
+            this.sdo = { kind: 'idle' };
+            return;
+        }
+
+        const state = this.sdo;
+        switch (state.kind) {
+            case 'blockDownload': {
+                // 块下载数据段：序号在低7位，最高位表示最后一段
+                const sequence = command & 0x7F;
+                const last = (command & 0x80) !== 0;
+                if (sequence === state.sequence + 1) {
+                    state.sequence = sequence;
+                    state.chunks.push(request.subarray(1, 8));
+                }
+                if (last || sequence >= this.options.blockSize) {
+                    const acknowledged = state.sequence;
+                    this.respond([0xA2, acknowledged, this.options.blockSize]);
+                    state.sequence = 0;
+                    if (last && acknowledged === sequence) {
+                        this.sdo = { kind: 'blockDownloadEnd', key: state.key, size: state.size, data: Buffer.concat(state.chunks), crc: state.crc };
+                    }
+                }
+                return;
+            }
+            case 'blockDownloadEnd': {
+                if ((command & 0xE3) !== 0xC1) {
+                    return this.abort(request, Abort.COMMAND);
+                }
+                const data = state.data.subarray(0, state.data.length - ((command >> 2) & 0x07));
+                if (data.length !== state.size) {
+                    return this.abort(request, Abort.LENGTH);
+                }
+                if (state.crc && canopenCrc16(data) !== request.readUInt16LE(1)) {
+                    return this.abort(request, Abort.CRC);
+                }
+                this.objects.set(state.key, Buffer.from(data));
+                this.stats.blocks++;
+                this.sdo = { kind: 'idle' };
+                this.respond([0xA1]);
+                return;
+            }
+            case 'blockUploadInitiated':
+                if (command === 0xA3) {
+                    this.sdo = { kind: 'blockUpload', data: state.data, offset: 0, blockStart: 0, blockSize: state.blockSize, crc: true };
+                    this.sendUploadBlock();
+                    return;
+                }
+                break;
+            case 'blockUpload':
+                if ((command & 0xE3) === 0xA2) {
+                    const acknowledged = request[1];
+                    state.offset = Math.min(state.data.length, state.blockStart + acknowledged * 7);
+                    state.blockSize = request[2];
+                    if (state.offset < state.data.length) {
+                        this.sendUploadBlock();
+                    } else {
+                        const tail = state.data.length % 7;
+                        const unused = tail === 0 ? 0 : 7 - tail;
+                        const crc = canopenCrc16(state.data);
+                        this.stats.blocks++;
+                        this.sdo = { kind: 'blockUploadEnd' };
+                        this.respond([0xC1 | (unused << 2), crc & 0xFF, crc >> 8]);
+                    }
+                    return;
+                }
+                break;
+            case 'blockUploadEnd':
+                if (command === 0xA1) {
+                    this.sdo = { kind: 'idle' };
+                    return;
+                }
+                break;
+            case 'uploadSegment':
+                if ((command & 0xE0) === 0x60) {
+                    const toggle = (command >> 4) & 0x01;
+                    if (toggle !== state.toggle) {
+                        return this.abort(request, Abort.TOGGLE);
+                    }
+                    const chunk = state.data.subarray(state.offset, state.offset + 7);
+                    state.offset += chunk.length;
+                    state.toggle ^= 1;
+                    const last = state.offset >= state.data.length;
+                    if (last) {
+                        this.sdo = { kind: 'idle' };
+                    }
+                    this.respond([(toggle << 4) | ((7 - chunk.length) << 1) | (last ? 1 : 0), ...chunk]);
+                    return;
+                }
+                break;
+            case 'downloadSegment':
+                if ((command & 0xE0) === 0x00) {
+                    const toggle = (command >> 4) & 0x01;
+                    if (toggle !== state.toggle) {
+                        return this.abort(request, Abort.TOGGLE);
+                    }
+                    state.chunks.push(request.subarray(1, 8 - ((command >> 1) & 0x07)));
+                    state.toggle ^= 1;
+                    if (command & 0x01) {
+                        this.store(state.key, Buffer.concat(state.chunks));
+                        this.sdo = { kind: 'idle' };
+                    }
+                    this.respond([0x20 | (toggle << 4)]);
+                    return;
+                }
+                break;
+            case 'idle':
+                break;
+        }
+
+        // 新的请求（或未处于匹配的传输中）
+        const object = this.objects.get(key);
+        switch (command & 0xE0) {
+            case 0x40: {
+                if (!object) {
+                    return this.abort(request, Abort.NOT_EXIST);
+                }
+                this.initiateUpload(request, object);
+                return;
+            }
+            case 0x20: {
+                if (!object) {
+                    return this.abort(request, Abort.NOT_EXIST);
+                }
+                if (!this.writable.has(key)) {
+                    return this.abort(request, Abort.READ_ONLY);
+                }
+                if (command & 0x02) {
+                    const size = (command & 0x01) ? 4 - ((command >> 2) & 0x03) : 4;
+                    this.store(key, request.subarray(4, 4 + size));
+                } else {
+                    this.sdo = { kind: 'downloadSegment', key, chunks: [], toggle: 0 };
+                }
+                this.respond([0x60, request[1], request[2], request[3]]);
+                return;
+            }
+            case 0xA0: {
+                // 块上传发起
+                if (this.options.disableBlock) {
+                    return this.abort(request, Abort.COMMAND);
+                }
+                if (!object) {
+                    return this.abort(request, Abort.NOT_EXIST);
+                }
+                const blockSize = request[4];
+                const threshold = request[5];
+                if (blockSize === 0 || blockSize > 127) {
+                    return this.abort(request, Abort.BLOCK_SIZE);
+                }
+                if (threshold > 0 && object.length <= threshold) {
+                    // 协议切换：按普通上传响应
+                    this.initiateUpload(request, object);
+                    return;
+                }
+                this.sdo = { kind: 'blockUploadInitiated', data: object, blockSize };
+                this.respond([0xC6, request[1], request[2], request[3], ...this.dword(object.length)]);
+                return;
+            }
+            case 0xC0: {
+                // 块下载发起
+                if (this.options.disableBlock) {
+                    return this.abort(request, Abort.COMMAND);
+                }
+                if (!object) {
+                    return this.abort(request, Abort.NOT_EXIST);
+                }
+                if (!this.writable.has(key)) {
+                    return this.abort(request, Abort.READ_ONLY);
+                }
+                const size = (command & 0x02) ? request.readUInt32LE(4) : 0;
+                this.sdo = { kind: 'blockDownload', key, size, chunks: [], sequence: 0, crc: (command & 0x04) !== 0 };
+                this.respond([0xA4, request[1], request[2], request[3], this.options.blockSize]);
+                return;
+            }
+            default:
+                return this.abort(request, Abort.COMMAND);
+        }
+    }
+
+    private initiateUpload(request: Buffer, object: Buffer): void {
+        if (object.length <= 4) {
+            this.respond([0x43 | ((4 - object.length) << 2), request[1], request[2], request[3], ...object]);
+            return;
+        }
+        this.sdo = { kind: 'uploadSegment', data: object, offset: 0, toggle: 0 };
+        this.respond([0x41, request[1], request[2], request[3], ...this.dword(object.length)]);
+    }
+
+    private sendUploadBlock(): void {
+        const state = this.sdo;
+        if (state.kind !== 'blockUpload') {
+            return;
+        }
+        state.blockStart = state.offset;
+        const frames: Buffer[] = [];
+        let offset = state.offset;
+        for (let sequence = 1; sequence <= state.blockSize && offset < state.data.length; sequence++) {
+            const chunk = state.data.subarray(offset, offset + 7);
+            offset += chunk.length;
+            const segment = Buffer.alloc(8);
+            segment[0] = sequence | (offset >= state.data.length ? 0x80 : 0);
+            chunk.copy(segment, 1);
+            frames.push(segment);
+        }
+        this.send(COB_SDO_TX + this.options.nodeId, frames);
+    }
+
+    private store(key: number, data: Buffer): void {
+        this.objects.set(key, Buffer.from(data));
+        if (key === CanOpenSimulatedObjects.HEARTBEAT_TIME) {
+            this.restartHeartbeat();
+        }
+    }
+
+    private abort(request: Buffer, code: number): void {
+        this.stats.aborts++;
+        this.sdo = { kind: 'idle' };
+        this.respond([0x80, request[1], request[2], request[3], ...this.dword(code)]);
+    }
+
+    // ============== 编码 ==============
+
+    private dword(value: number): number[] {
+        return [value & 0xFF, (value >>> 8) & 0xFF, (value >>> 16) & 0xFF, (value >>> 24) & 0xFF];
+    }
+
+    private respond(bytes: number[]): void {
+        const frame = Buffer.alloc(8);
+        Buffer.from(bytes.slice(0, 8)).copy(frame);
+        this.send(COB_SDO_TX + this.options.nodeId, [frame]);
+    }
+
+    private send(id: number, payloads: Buffer[]): void {
+        this.device.transmit(this.channelHandle, payloads.map(p => ({ id, dlc: p.length, data: Array.from(p) })));
+    }
+}
+
+if (require.main === module) {
+    const deviceType = Number(process.argv[2] ?? DeviceType.ZCAN_VIRTUAL_DEVICE) as DeviceTypeValue;
+    const deviceIndex = Number(process.argv[3] ?? 0);
+    const channelIndex = Number(process.argv[4] ?? 0);
+    const nodeId = Number(process.argv[5] ?? 5);
+
+    const device = new ZlgCanDevice();
+    if (!device.openDevice(deviceType, deviceIndex, 0)) {
+        console.error('设备打开失败');
+        process.exit(1);
+    }
+    const channel = device.initCanChannel(channelIndex, {
+        canType: CanType.TYPE_CANFD,
+        accCode: 0,
+        accMask: 0xFFFFFFFF,
+        abitTiming: 0x00016D01,
+        dbitTiming: 0x00016D01,
+        brp: 0,
+        filter: 0,
+        mode: 0,
+    });
+    device.startCanChannel(channel);
+
+    const simulator = new CanOpenNodeSimulator(device, channel, { nodeId });
+    simulator.start();
+    console.log(`CANopen节点模拟器已启动: 设备类型${deviceType}, 通道${channelIndex}, 节点${nodeId}`);
+    setInterval(() => console.log(JSON.stringify({ state: simulator.nmtState, ...simulator.stats })), 5000).unref();
+
+    process.on('SIGINT', () => {
+        simulator.stop();
+        device.closeDevice();
+        process.exit(0);
+    });
+}
@@ -0,0 +1,404 @@
+/**
+ * DoIP ECU模拟器
+ * 在本机TCP端口上实现ISO 13400-2的路由激活、在线检查和诊断报文，
+ * 网关后挂多个逻辑地址的ECU，各ECU实现常用UDS服务（会话控制、读写DID、
+ * 例程控制、下载），用于无硬件时测试和测量doipRequestAsync。
+ *
+ * 单独运行: npx ts-node test/doip-ecu-simulator.ts [端口] [地址]
+ */
+
+import * as net from 'net';
+
+// ============== DoIP报文类型 ==============
+
+const PayloadType = {
+    GENERIC_NACK: 0x0000,
+    ROUTING_ACTIVATION_REQUEST: 0x0005,
+    ROUTING_ACTIVATION_RESPONSE: 0x0006,
+    ALIVE_CHECK_REQUEST: 0x0007,
+    ALIVE_CHECK_RESPONSE: 0x0008,
+    DIAGNOSTIC_MESSAGE: 0x8001,
+    DIAGNOSTIC_ACK: 0x8002,
+    DIAGNOSTIC_NACK: 0x8003,
+} as const;
+
+const HEADER_LENGTH = 8;
+
+/** 模拟器配置 */
+export interface DoipEcuSimulatorOptions {
+    /** DoIP实体（网关）逻辑地址，默认0x1000 */
+    entityAddress?: number;
+    /** 网关后的ECU逻辑地址，默认[0x1001, 0x1002] */
+    ecuAddresses?: number[];
+    /** 大DID(0xF1A0)的数据长度，默认16384 */
+    largeDidLength?: number;
+    /** RequestDownload返回的最大块长度（含SID和序号），默认4098 */
+    maxBlockLength?: number;
+    /** 诊断请求的响应延时（毫秒），默认0 */
+    responseDelayMs?: number;
+    /** 最终响应前发送的0x78消极响应个数，默认0 */
+    pendingResponses?: number;
+    /** 诊断报文的最大长度，超过时回复NACK，默认0x10000 */
+    maxDiagnosticLength?: number;
+}
+
+/** 模拟器统计 */
+export interface DoipEcuSimulatorStats {
+    /** 接受的TCP连接数 */
+    connections: number;
+    /** 路由激活次数 */
+    routingActivations: number;
+    /** 诊断请求数 */
+    diagnosticRequests: number;
+    /** 同时处理中的诊断请求峰值 */
+    maxConcurrentRequests: number;
+    /** TransferData接收的数据字节数 */
+    downloadedBytes: number;
+}
+
+interface EcuState {
+    session: number;
+    dids: Map<number, Buffer>;
+    download: { expectedSeq: number; remaining: number } | null;
+}
+
+interface ConnectionState {
+    socket: net.Socket;
+    buffer: Buffer;
+    testerAddress: number | null;
+}
+
+function encodeMessage(version: number, type: number, payload: Buffer): Buffer {
+    const header = Buffer.alloc(HEADER_LENGTH);
+    header[0] = version;
+    header[1] = ~version & 0xFF;
+    header.writeUInt16BE(type, 2);
+    header.writeUInt32BE(payload.length, 4);
+    return Buffer.concat([header, payload]);
+}
+
+function negative(sid: number, code: number): Buffer {
+    return Buffer.from([0x7F, sid, code]);
+}
+
+export class DoipEcuSimulator {
+    private server: net.Server | null = null;
+    private connections = new Set<ConnectionState>();
+    private ecus = new Map<number, EcuState>();
+    private concurrent = 0;
+    private options: Required<DoipEcuSimulatorOptions>;
+
+    readonly stats: DoipEcuSimulatorStats = {
+        connections: 0,
+        routingActivations: 0,
+        diagnosticRequests: 0,
+        maxConcurrentRequests: 0,
+        downloadedBytes: 0,
+    };
+
+    constructor(options: DoipEcuSimulatorOptions = {}) {
+        this.options = {
+            entityAddress: options.entityAddress ?? 0x1000,
+            ecuAddresses: options.ecuAddresses ?? [0x1001, 0x1002],
+            largeDidLength: options.largeDidLength ?? 16384,
+            maxBlockLength: options.maxBlockLength ?? 4098,
+            responseDelayMs: options.responseDelayMs ?? 0,
+            pendingResponses: options.pendingResponses ?? 0,
+            maxDiagnosticLength: options.maxDiagnosticLength ?? 0x10000,
+        };
+
+        for (const address of this.options.ecuAddresses) {
+            const large = Buffer.alloc(this.options.largeDidLength);
+            for (let i = 0; i < large.length; i++) {
+                large[i] = i & 0xFF;
+            }
+            const vin = Buffer.from(`LZLGDOIP${address.toString(16).toUpperCase().padStart(4, '0')}SIM0`.slice(0, 17), 'ascii');
+            this.ecus.set(address, {
+                session: 0x01,
+                dids: new Map([[0xF190, vin], [0xF1A0, large]]),
+                download: null,
+            });
+        }
+    }
+
+    /** 修改响应延时和0x78个数，用于测试流水线和P2*等待 */
+    setTiming(responseDelayMs: number, pendingResponses: number = 0): void {
+        this.options.responseDelayMs = responseDelayMs;
+        this.options.pendingResponses = pendingResponses;
+    }
+
+    /**
+     * 开始监听
+     * @param port TCP端口，默认13400
+     * @param host 监听地址，默认127.0.0.1
+     */
+    start(port: number = 13400, host: string = '127.0.0.1'): Promise<void> {
+        return new Promise((resolve, reject) => {
+            const server = net.createServer(socket => this.accept(socket));
+            server.once('error', reject);
+            server.listen(port, host, () => {
+                server.off('error', reject);
+                this.server = server;
+                resolve();
+            });
+        });
+    }
+
+    stop(): Promise<void> {
+        for (const conn of this.connections) {
+            conn.socket.destroy();
+        }
+        this.connections.clear();
+        return new Promise(resolve => {
+            if (!this.server) {
+                resolve();
+                return;
+            }
+            this.server.close(() => resolve());
+            this.server = null;
+        });
+    }
+
+    private accept(socket: net.Socket): void {
+        socket.setNoDelay(true);
+        const conn: ConnectionState = { socket, buffer: Buffer.alloc(0), testerAddress: null };
+        this.connections.add(conn);
+        this.stats.connections++;
+
+        socket.on('data', chunk => {
+            conn.buffer = conn.buffer.length === 0 ? chunk : Buffer.concat([conn.buffer, chunk]);
+            this.parse(conn);
+        });
+        socket.on('close', () => this.connections.delete(conn));
+        socket.on('error', () => socket.destroy());
+    }
+
+    private parse(conn: ConnectionState): void {
+        while (conn.buffer.length >= HEADER_LENGTH) {
+            const version = conn.buffer[0];
+            if ((conn.buffer[1] ^ 0xFF) !== version) {
+                // 同步模式错误，关闭连接
+                this.send(conn, 0x02, PayloadType.GENERIC_NACK, Buffer.from([0x00]));
+                conn.socket.end();
+                return;
+            }
+            const type = conn.buffer.readUInt16BE(2);
+            const length = conn.buffer.readUInt32BE(4);
+            if (length > this.options.maxDiagnosticLength + 4) {
+                this.send(conn, version, PayloadType.GENERIC_NACK, Buffer.from([0x02]));
+                conn.socket.end();
+                return;
+            }
+            if (conn.buffer.length < HEADER_LENGTH + length) {
+                return;
+            }
+            const payload = conn.buffer.subarray(HEADER_LENGTH, HEADER_LENGTH + length);
+            conn.buffer = conn.buffer.subarray(HEADER_LENGTH + length);
+            this.handle(conn, version === 0xFF ? 0x02 : version, type, Buffer.from(payload));
+        }
+    }
+
+    private send(conn: ConnectionState, version: number, type: number, payload: Buffer): void {
+        if (!conn.socket.destroyed) {
+            conn.socket.write(encodeMessage(version, type, payload));
+        }
+    }
+
+    private handle(conn: ConnectionState, version: number, type: number, payload: Buffer): void {
+        switch (type) {
+            case PayloadType.ROUTING_ACTIVATION_REQUEST: {
+                if (payload.length !== 7 && payload.length !== 11) {
+                    this.send(conn, version, PayloadType.GENERIC_NACK, Buffer.from([0x04]));
+                    return;
+                }
+                const tester = payload.readUInt16BE(0);
+                conn.testerAddress = tester;
+                this.stats.routingActivations++;
+
+                const response = Buffer.alloc(9);
+                response.writeUInt16BE(tester, 0);
+                response.writeUInt16BE(this.options.entityAddress, 2);
+                response[4] = 0x10;  // 路由激活成功
+                this.send(conn, version, PayloadType.ROUTING_ACTIVATION_RESPONSE, response);
+                return;
+            }
+            case PayloadType.ALIVE_CHECK_REQUEST: {
+                const response = Buffer.alloc(2);
+                response.writeUInt16BE(conn.testerAddress ?? 0, 0);
+                this.send(conn, version, PayloadType.ALIVE_CHECK_RESPONSE, response);
+                return;
+            }
+            case PayloadType.DIAGNOSTIC_MESSAGE:
+                this.handleDiagnostic(conn, version, payload);
+                return;
+            default:
+                this.send(conn, version, PayloadType.GENERIC_NACK, Buffer.from([0x01]));
+        }
+    }
+
+    private handleDiagnostic(conn: ConnectionState, version: number, payload: Buffer): void {
+        if (payload.length < 5) {
+            this.send(conn, version, PayloadType.GENERIC_NACK, Buffer.from([0x04]));
+            return;
+        }
+        const source = payload.readUInt16BE(0);
+        const target = payload.readUInt16BE(2);
+        const ack = Buffer.alloc(5);
+        ack.writeUInt16BE(target, 0);
+        ack.writeUInt16BE(source, 2);
+
+        if (conn.testerAddress !== source) {
+            ack[4] = 0x02;  // 无效的源地址（未路由激活）
+            this.send(conn, version, PayloadType.DIAGNOSTIC_NACK, ack);
+            return;
+        }
+        const ecu = this.ecus.get(target);
+        if (!ecu) {
+            ack[4] = 0x03;  // 未知的目标地址
+            this.send(conn, version, PayloadType.DIAGNOSTIC_NACK, ack);
+            return;
+        }
+        this.send(conn, version, PayloadType.DIAGNOSTIC_ACK, ack);
+
+        this.stats.diagnosticRequests++;
+        this.concurrent++;
+        this.stats.maxConcurrentRequests = Math.max(this.stats.maxConcurrentRequests, this.concurrent);
+
+        const request = payload.subarray(4);
+        const respond = (data: Buffer) => {
+            const message = Buffer.alloc(4 + data.length);
+            message.writeUInt16BE(target, 0);
+            message.writeUInt16BE(source, 2);
+            data.copy(message, 4);
+            this.send(conn, version, PayloadType.DIAGNOSTIC_MESSAGE, message);
+        };
+
+        const finish = () => {
+            this.concurrent--;
+            const response = this.service(ecu, request);
+            if (response) {
+                respond(response);
+            }
+        };
+
+        const { responseDelayMs, pendingResponses } = this.options;
+        for (let i = 0; i < pendingResponses; i++) {
+            setTimeout(() => respond(negative(request[0], 0x78)), (responseDelayMs * i) / Math.max(pendingResponses, 1));
+        }
+        if (responseDelayMs > 0 || pendingResponses > 0) {
+            setTimeout(finish, responseDelayMs);
+        } else {
+            finish();
+        }
+    }
+
+    /** UDS服务处理，返回null表示抑制响应 */
+    private service(ecu: EcuState, request: Buffer): Buffer | null {
+        const sid = request[0];
+        switch (sid) {
+            case 0x10: {
+                if (request.length !== 2) {
+                    return negative(sid, 0x13);
+                }
+                ecu.session = request[1] & 0x7F;
+                return (request[1] & 0x80) ? null : Buffer.from([0x50, ecu.session, 0x00, 0x32, 0x01, 0xF4]);
+            }
+            case 0x3E:
+                return (request[1] & 0x80) ? null : Buffer.from([0x7E, 0x00]);
+            case 0x22: {
+                if (request.length < 3 || (request.length - 1) % 2 !== 0) {
+                    return negative(sid, 0x13);
+                }
+                const parts: Buffer[] = [Buffer.from([0x62])];
+                for (let i = 1; i < request.length; i += 2) {
+                    const did = request.readUInt16BE(i);
+                    const value = ecu.dids.get(did);
+                    if (!value) {
+                        return negative(sid, 0x31);
+                    }
+                    parts.push(request.subarray(i, i + 2), value);
+                }
+                return Buffer.concat(parts);
+            }
+            case 0x2E: {
+                if (request.length < 4) {
+                    return negative(sid, 0x13);
+                }
+                const did = request.readUInt16BE(1);
+                ecu.dids.set(did, Buffer.from(request.subarray(3)));
+                return Buffer.from([0x6E, request[1], request[2]]);
+            }
+            case 0x31:
+                if (request.length < 4) {
+                    return negative(sid, 0x13);
+                }
+                return Buffer.from([0x71, request[1], request[2], request[3], 0x00]);
+            case 0x34: {
+                if (request.length < 3) {
+                    return negative(sid, 0x13);
+                }
+                const alfid = request[2];
+                const addressLength = alfid & 0x0F;
+                const sizeLength = alfid >> 4;
+                if (request.length !== 3 + addressLength + sizeLength || sizeLength === 0) {
+                    return negative(sid, 0x13);
+                }
+                const size = request.readUIntBE(3 + addressLength, Math.min(sizeLength, 6));
+                ecu.download = { expectedSeq: 1, remaining: size };
+                const response = Buffer.alloc(4);
+                response[0] = 0x74;
+                response[1] = 0x20;
+                response.writeUInt16BE(this.options.maxBlockLength, 2);
+                return response;
+            }
+            case 0x36: {
+                if (!ecu.download) {
+                    return negative(sid, 0x24);
+                }
+                if (request.length < 2 || request.length > this.options.maxBlockLength) {
+                    return negative(sid, 0x13);
+                }
+                const seq = request[1];
+                if (seq === ((ecu.download.expectedSeq - 1) & 0xFF)) {
+                    return Buffer.from([0x76, seq]);  // 重传的块
+                }
+                if (seq !== ecu.download.expectedSeq) {
+                    return negative(sid, 0x73);
+                }
+                const length = request.length - 2;
+                if (length > ecu.download.remaining) {
+                    return negative(sid, 0x71);
+                }
+                ecu.download.remaining -= length;
+                ecu.download.expectedSeq = (seq + 1) & 0xFF;
+                this.stats.downloadedBytes += length;
+                return Buffer.from([0x76, seq]);
+            }
+            case 0x37: {
+                if (!ecu.download) {
+                    return negative(sid, 0x24);
+                }
+                ecu.download = null;
+                return Buffer.from([0x77]);
+            }
+            default:
+                return negative(sid, 0x11);
+        }
+    }
+}
+
+if (require.main === module) {
+    const port = Number(process.argv[2] ?? 13400);
+    const host = process.argv[3] ?? '127.0.0.1';
+    const simulator = new DoipEcuSimulator();
+    simulator.start(port, host).then(() => {
+        console.log(`DoIP ECU模拟器已启动: ${host}:${port}`);
+        setInterval(() => console.log(JSON.stringify(simulator.stats)), 5000).unref();
+    }).catch(err => {
+        console.error(`启动失败: ${err.message}`);
+        process.exit(1);
+    });
+    process.on('SIGINT', () => {
+        simulator.stop().then(() => process.exit(0));
+    });
+}
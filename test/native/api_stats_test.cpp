@@ -0,0 +1,101 @@
+#include "native_test.h"
+
+#include <cstring>
+
+#include "api_stats.h"
+
+/**
+ * 接口调用统计测试
+ * 覆盖直方图分桶、分位数、计数汇总（含已退出线程）、重置零点和TSC标定不阻塞
+ */
+
+namespace {
+
+const ApiStatsEntry* FindEntry(const ApiStatsSnapshot& snapshot, ApiId api) {
+    for (const ApiStatsEntry& entry : snapshot.entries) {
+        if (std::strcmp(entry.name, ApiName(api)) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+NATIVE_TEST("接口调用统计", "分桶上界覆盖取值且相对误差不超过25%") {
+    int violations = 0;
+    for (uint64_t ticks = 0; ticks < (1u << 16); ticks++) {
+        const int bucket = ApiHistBucket(ticks);
+        const uint64_t upper = ApiHistBucketUpper(bucket);
+        if (upper < ticks || (bucket > 0 && ApiHistBucketUpper(bucket - 1) >= ticks) ||
+            static_cast<double>(upper) > 1.25 * static_cast<double>(ticks) + 1) {
+            violations++;
+        }
+    }
+    EXPECT_EQ(violations, 0);
+    EXPECT_EQ(ApiHistBucket(~0ull), API_HIST_BUCKETS - 1);
+}
+
+NATIVE_TEST("接口调用统计", "分位数按桶上界取值") {
+    uint64_t histogram[API_HIST_BUCKETS] = {};
+    histogram[ApiHistBucket(100)] = 90;
+    histogram[ApiHistBucket(1000)] = 10;
+    EXPECT_EQ(ApiHistPercentile(histogram, 100, 0.5, 1.0), static_cast<double>(ApiHistBucketUpper(ApiHistBucket(100))));
+    EXPECT_EQ(ApiHistPercentile(histogram, 100, 0.99, 2.0),
+              2.0 * static_cast<double>(ApiHistBucketUpper(ApiHistBucket(1000))));
+    EXPECT_EQ(ApiHistPercentile(histogram, 0, 0.5, 1.0), 0.0);
+}
+
+NATIVE_TEST("接口调用统计", "计数汇总各线程并在重置后从零开始") {
+    ApiStatsReset();
+    for (int i = 0; i < 3; i++) {
+        ApiStatsRecord(ApiId::TransmitLIN, ApiStatsNow(), 5, 5 * 16, false);
+    }
+    ApiStatsRecord(ApiId::TransmitLIN, ApiStatsNow(), 0, 0, true);
+    // 已退出线程的计数并入全局累计
+    std::thread([] { ApiStatsRecord(ApiId::TransmitLIN, ApiStatsNow(), 2, 2 * 16, false); }).join();
+
+    const ApiStatsSnapshot snapshot = ApiStatsTake();
+    const ApiStatsEntry* entry = FindEntry(snapshot, ApiId::TransmitLIN);
+    EXPECT_TRUE(entry != nullptr);
+    if (entry != nullptr) {
+        EXPECT_EQ(entry->calls, 5u);
+        EXPECT_EQ(entry->errors, 1u);
+        EXPECT_EQ(entry->frames, 17u);
+        EXPECT_EQ(entry->bytes, 17u * 16);
+        uint64_t histogramCalls = 0;
+        for (const auto& bucket : entry->histogram) {
+            histogramCalls += bucket.second;
+        }
+        EXPECT_EQ(histogramCalls, 5u);
+        EXPECT_TRUE(entry->p50Ns <= entry->p99Ns && entry->p99Ns <= entry->maxNs);
+    }
+    EXPECT_TRUE(FindEntry(snapshot, ApiId::ReceiveLIN) == nullptr);
+
+    ApiStatsReset();
+    EXPECT_TRUE(FindEntry(ApiStatsTake(), ApiId::TransmitLIN) == nullptr);
+    {
+        ApiScope scope(ApiId::TransmitLIN);
+        scope.SetFrames(1, 16);
+    }
+    const ApiStatsSnapshot after = ApiStatsTake();
+    const ApiStatsEntry* again = FindEntry(after, ApiId::TransmitLIN);
+    EXPECT_TRUE(again != nullptr && again->calls == 1 && again->frames == 1);
+}
+
+NATIVE_TEST("接口调用统计", "标定不阻塞且滴答换算与steady_clock一致") {
+    ApiStatsInit();
+    const auto start = std::chrono::steady_clock::now();
+    const ApiStatsSnapshot snapshot = ApiStatsTake();
+    const ApiClockMapping clock = ApiStatsClock();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_TRUE(elapsed < std::chrono::milliseconds(5));
+    EXPECT_TRUE(snapshot.nsPerTick > 0.01 && snapshot.nsPerTick < 100);
+    EXPECT_TRUE(clock.nsPerTick > 0.01 && clock.nsPerTick < 100);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const int64_t mapped = ApiStatsClock().ToSteadyNs(ApiStatsNow());
+    const int64_t steady = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    EXPECT_TRUE(mapped - steady < 1000000 && steady - mapped < 1000000);
+}
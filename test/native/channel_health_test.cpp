@@ -0,0 +1,129 @@
+#include "native_test.h"
+#include "sim_fixture.h"
+
+#include <mutex>
+
+#include "channel_health.h"
+
+/**
+ * 通道健康监视测试
+ * 以"N/sim_tec"、"N/sim_bus_off"注入错误计数，监视器依次报告被动错误、总线关闭，
+ * 自动复位通道后恢复为主动错误；计数在门限附近抖动时不反复报告；
+ * 监视器采样读走的错误信息仍可由ReadErrInfo读取
+ */
+
+namespace {
+
+struct HealthHarness {
+    explicit HealthHarness(CHANNEL_HANDLE channel, const HealthMonitorOptions& options)
+        : monitor(channel, 0, options, [this](const HealthEvent& event) {
+              std::lock_guard<std::mutex> lock(mutex);
+              events.push_back(event);
+          }) {}
+
+    std::vector<HealthEvent> Events() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return events;
+    }
+
+    std::vector<BusState> StateChanges() {
+        std::vector<BusState> states;
+        for (const HealthEvent& event : Events()) {
+            if (event.type == HealthEvent::Type::StateChange) {
+                states.push_back(event.state);
+            }
+        }
+        return states;
+    }
+
+    bool Has(HealthEvent::Type type) {
+        for (const HealthEvent& event : Events()) {
+            if (event.type == type) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::mutex mutex;
+    std::vector<HealthEvent> events;
+    ChannelHealthMonitor monitor;
+};
+
+}  // namespace
+
+NATIVE_TEST("通道健康监视", "被动错误、总线关闭后自动恢复为主动错误") {
+    SimDeviceFixture sim(51, false);
+    EXPECT_TRUE(sim.Ready());
+    HealthMonitorOptions options;
+    options.pollIntervalMs = 10;
+    options.autoRecover = true;
+    options.recoveryDelayMs = 20;
+    HealthHarness harness(sim.channels[0], options);
+    harness.monitor.Start();
+    EXPECT_TRUE(WaitUntil([&] { return harness.monitor.State() == BusState::Active; }, 1000));
+
+    EXPECT_EQ(ZcanSetValue(sim.device, "0/sim_tec", "130"), static_cast<UINT>(STATUS_OK));
+    EXPECT_TRUE(WaitUntil([&] { return harness.monitor.State() == BusState::Passive; }, 1000));
+    EXPECT_EQ(ZcanSetValue(sim.device, "0/sim_bus_off", "1"), static_cast<UINT>(STATUS_OK));
+    EXPECT_TRUE(WaitUntil([&] { return harness.Has(HealthEvent::Type::Recovered); }, 2000));
+    harness.monitor.Stop();
+
+    const std::vector<BusState> expected = {BusState::Active, BusState::Passive, BusState::BusOff, BusState::Active};
+    EXPECT_TRUE(harness.StateChanges() == expected);
+    EXPECT_EQ(harness.monitor.RecoveryCount(), 1u);
+    for (const HealthEvent& event : harness.Events()) {
+        if (event.type == HealthEvent::Type::StateChange && event.state == BusState::Passive) {
+            EXPECT_EQ(event.txErrCount, 130);
+        } else if (event.type == HealthEvent::Type::RecoveryAttempt) {
+            EXPECT_EQ(event.attempt, 1u);
+            EXPECT_TRUE(event.success);
+        }
+    }
+}
+
+NATIVE_TEST("通道健康监视", "错误计数在被动门限附近抖动时只报告一次") {
+    SimDeviceFixture sim(52, false);
+    EXPECT_TRUE(sim.Ready());
+    HealthMonitorOptions options;
+    options.pollIntervalMs = 10;
+    options.settlePolls = 2;
+    HealthHarness harness(sim.channels[0], options);
+    harness.monitor.Start();
+    EXPECT_TRUE(WaitUntil([&] { return harness.monitor.State() == BusState::Active; }, 1000));
+
+    // 每20ms中只有5ms低于门限，不足两次采样
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(ZcanSetValue(sim.device, "0/sim_tec", "130"), static_cast<UINT>(STATUS_OK));
+        std::this_thread::sleep_for(std::chrono::milliseconds(15));
+        EXPECT_EQ(ZcanSetValue(sim.device, "0/sim_tec", "127"), static_cast<UINT>(STATUS_OK));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(ZcanSetValue(sim.device, "0/sim_tec", "130"), static_cast<UINT>(STATUS_OK));
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    harness.monitor.Stop();
+
+    const std::vector<BusState> expected = {BusState::Active, BusState::Passive};
+    EXPECT_TRUE(harness.StateChanges() == expected);
+}
+
+NATIVE_TEST("通道健康监视", "监视器采样读走的错误信息由ReadErrInfo交付一次") {
+    SimDeviceFixture sim(53, false);
+    EXPECT_TRUE(sim.Ready());
+    HealthMonitorOptions options;
+    options.pollIntervalMs = 10;
+    HealthHarness harness(sim.channels[0], options);
+    harness.monitor.Start();
+    EXPECT_EQ(ZcanSetValue(sim.device, "0/sim_tec", "130"), static_cast<UINT>(STATUS_OK));
+    EXPECT_TRUE(WaitUntil([&] { return harness.monitor.State() == BusState::Passive; }, 1000));
+    // 回到主动错误后驱动不再报告被动错误，只有监视器读走的那次记录
+    EXPECT_EQ(ZcanSetValue(sim.device, "0/sim_tec", "0"), static_cast<UINT>(STATUS_OK));
+    EXPECT_TRUE(WaitUntil([&] { return harness.monitor.State() == BusState::Active; }, 1000));
+
+    ZCAN_CHANNEL_ERR_INFO errInfo;
+    EXPECT_EQ(harness.monitor.ReadErrInfo(&errInfo), static_cast<UINT>(STATUS_OK));
+    EXPECT_TRUE((errInfo.error_code & ZCAN_ERROR_CAN_PASSIVE) != 0);
+    EXPECT_EQ(harness.monitor.ReadErrInfo(&errInfo), static_cast<UINT>(STATUS_OK));
+    EXPECT_EQ(errInfo.error_code, 0u);
+    harness.monitor.Stop();
+}
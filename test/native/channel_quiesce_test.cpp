@@ -0,0 +1,39 @@
+#include "native_test.h"
+#include "sim_fixture.h"
+
+#include "channel_quiesce.h"
+
+#include <atomic>
+#include <thread>
+
+/**
+ * 通道静默测试
+ * 仿真通道0代表不受本方控制的其他节点持续发送，只对通道1静默：
+ * 本方发送队列排空即返回，截止点之前收到的报文被丢弃，不等待总线静默
+ */
+
+NATIVE_TEST("通道静默", "其他节点持续发送时排空本方发送队列后立即返回") {
+    SimDeviceFixture sim(50, true);
+    EXPECT_TRUE(sim.Ready());
+
+    std::atomic<bool> running{true};
+    std::thread foreign([&] {
+        BYTE seed = 0;
+        while (running.load()) {
+            ZCAN_Transmit_Data frame = SimCanFrame(0x7A0, 8, seed++);
+            ZcanTransmit(sim.channels[0], &frame, 1);
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+    });
+    EXPECT_TRUE(WaitUntil([&] { return ZcanGetReceiveNum(sim.channels[1], TYPE_ALL_DATA) > 0; }, 1000));
+
+    QuiesceOptions options;
+    options.timeoutMs = 100;
+    const QuiesceResult result = QuiesceChannels(sim.device, {{1, sim.channels[1]}}, options);
+    running.store(false);
+    foreign.join();
+
+    EXPECT_TRUE(result.clean);
+    EXPECT_TRUE(result.discardedFrames > 0);
+    EXPECT_TRUE(result.elapsedUs < 50000);
+}
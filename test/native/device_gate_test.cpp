@@ -0,0 +1,88 @@
+#include "native_test.h"
+
+#include <atomic>
+
+#include "device_gate.h"
+
+/**
+ * 设备句柄闸门测试
+ * 句柄只作为登记表的键，不进入驱动，以任意地址代替；设备类型取驱动中不存在的值
+ */
+
+namespace {
+
+constexpr uint32_t GATE_TEST_DEVICE_TYPE = 9990;
+
+int handleA = 0;
+int handleB = 0;
+int unregistered = 0;
+
+// 在另一线程中进入共享闸门，进入后置位entered
+std::thread EnterLater(const void* handle, std::atomic<bool>* entered) {
+    return std::thread([handle, entered] {
+        DeviceGateScope scope(handle);
+        entered->store(true);
+    });
+}
+
+}  // namespace
+
+NATIVE_TEST("设备句柄闸门", "独占一个设备时其他设备和未登记句柄的调用不等待") {
+    DeviceGateState& gateA = DeviceGateFor(GATE_TEST_DEVICE_TYPE, 0);
+    DeviceGateState& gateB = DeviceGateFor(GATE_TEST_DEVICE_TYPE, 1);
+    EXPECT_TRUE(&gateA != &gateB);
+    EXPECT_TRUE(&gateA == &DeviceGateFor(GATE_TEST_DEVICE_TYPE, 0));
+    DeviceGateRegister(gateA, &handleA);
+    DeviceGateRegister(gateB, &handleB);
+    EXPECT_TRUE(DeviceGateLookup(&handleA) == &gateA);
+    EXPECT_TRUE(DeviceGateLookup(&unregistered) == nullptr);
+
+    std::atomic<bool> enteredA{false};
+    std::atomic<bool> enteredB{false};
+    std::atomic<bool> enteredFree{false};
+    std::thread waiterA;
+    std::thread waiterB;
+    std::thread waiterFree;
+    {
+        DeviceGateExclusive exclusive(gateA);
+        waiterA = EnterLater(&handleA, &enteredA);
+        waiterB = EnterLater(&handleB, &enteredB);
+        waiterFree = EnterLater(&unregistered, &enteredFree);
+        EXPECT_TRUE(WaitUntil([&] { return enteredB.load() && enteredFree.load(); }, 1000));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        EXPECT_TRUE(!enteredA.load());
+        // 持有方在该设备句柄上的调用不经过闸门
+        DeviceGateScope own(&handleA);
+        EXPECT_TRUE(static_cast<bool>(own));
+    }
+    EXPECT_TRUE(WaitUntil([&] { return enteredA.load(); }, 1000));
+    waiterA.join();
+    waiterB.join();
+    waiterFree.join();
+
+    DeviceGateUnregister(gateA, false);
+    DeviceGateUnregister(gateB, false);
+    EXPECT_TRUE(DeviceGateLookup(&handleA) == nullptr);
+}
+
+NATIVE_TEST("设备句柄闸门", "失效句柄直接失败，驱动复用地址后解除登记") {
+    DeviceGateState& gate = DeviceGateFor(GATE_TEST_DEVICE_TYPE, 2);
+    DeviceGateRegister(gate, &handleA);
+    DeviceGateRegister(gate, &handleB);
+    {
+        DeviceGateExclusive exclusive(gate);
+        DeviceGateRetire(&handleA);
+    }
+    EXPECT_TRUE(!DeviceGateScope(&handleA));
+    EXPECT_TRUE(static_cast<bool>(DeviceGateScope(&handleB)));
+
+    // 停止监视时保留失效登记
+    DeviceGateUnregister(gate, true);
+    EXPECT_TRUE(DeviceGateLookup(&handleB) == nullptr);
+    EXPECT_TRUE(!DeviceGateScope(&handleA));
+
+    DeviceGateAdopt(&handleA);
+    EXPECT_TRUE(DeviceGateLookup(&handleA) == nullptr);
+    EXPECT_TRUE(static_cast<bool>(DeviceGateScope(&handleA)));
+    DeviceGateUnregister(gate, false);
+}
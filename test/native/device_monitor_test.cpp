@@ -0,0 +1,115 @@
+#include "native_test.h"
+#include "sim_fixture.h"
+
+#include <mutex>
+
+#include "device_monitor.h"
+
+/**
+ * 设备热插拔监视测试
+ * 以"sim/online"使仿真设备离线，监视线程关闭并重新打开设备后按记录回放；
+ * 对端设备的通道与被监视设备的通道0在同一仿真总线上，用于确认回放后的通道可收发
+ */
+
+namespace {
+
+constexpr UINT MONITORED_INDEX = 41;
+
+struct MonitorHarness {
+    MonitorHarness() : handle(ZcanOpenDevice(SIM_DEVICE_TYPE, MONITORED_INDEX, 0)),
+                       monitor(SIM_DEVICE_TYPE, MONITORED_INDEX, 0, handle) {}
+
+    ~MonitorHarness() {
+        monitor.Stop();
+        if (monitor.Handle() != INVALID_DEVICE_HANDLE) {
+            ZcanCloseDevice(monitor.Handle());
+        }
+    }
+
+    // 与JS层setValue相同：调用成功后记录
+    void SetValue(const char* path, const char* value) {
+        EXPECT_EQ(ZcanSetValue(handle, path, value), static_cast<UINT>(STATUS_OK));
+        monitor.RecordSetValue(path, value);
+    }
+
+    void Start() {
+        DeviceMonitorOptions options;
+        options.pollIntervalMs = 10;
+        options.retryIntervalMs = 10;
+        monitor.Start(options, [this](const DeviceEvent& event) {
+            std::lock_guard<std::mutex> lock(mutex);
+            events.push_back(event);
+        }, nullptr);
+    }
+
+    size_t EventCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return events.size();
+    }
+
+    DEVICE_HANDLE handle;
+    DeviceMonitor monitor;
+    std::mutex mutex;
+    std::vector<DeviceEvent> events;
+};
+
+std::string ValueOf(DEVICE_HANDLE device, const char* path) {
+    const char* value = static_cast<const char*>(ZcanGetValue(device, path));
+    return value == nullptr ? std::string() : std::string(value);
+}
+
+}  // namespace
+
+NATIVE_TEST("设备监视", "离线后重新打开设备并按原顺序回放设置和通道") {
+    SimDeviceFixture peer(40, false);
+    EXPECT_TRUE(peer.Ready());
+    MonitorHarness harness;
+    EXPECT_TRUE(harness.handle != INVALID_DEVICE_HANDLE);
+
+    // 总线号在StartCAN时生效，须在初始化前回放
+    harness.SetValue("0/sim_bus", "140");
+    harness.SetValue("0/replay_order", "beforeInit");
+    ZCAN_CHANNEL_INIT_CONFIG config;
+    std::memset(&config, 0, sizeof(config));
+    config.can_type = TYPE_CANFD;
+    CHANNEL_HANDLE channel = ZcanInitCAN(harness.handle, 0, &config);
+    EXPECT_TRUE(channel != INVALID_CHANNEL_HANDLE);
+    harness.monitor.RecordInitCan(0, config, channel);
+    EXPECT_EQ(ZcanStartCAN(channel), static_cast<UINT>(STATUS_OK));
+    harness.monitor.RecordStartCan(0);
+    harness.SetValue("0/replay_order", "afterStart");
+    harness.SetValue("0/toggle", "1");
+    harness.SetValue("0/toggle", "0");
+    harness.SetValue("0/toggle", "1");
+
+    harness.Start();
+    EXPECT_EQ(ZcanSetValue(harness.handle, "sim/online", "0"), static_cast<UINT>(STATUS_OK));
+    EXPECT_TRUE(WaitUntil([&] { return harness.EventCount() >= 2; }, 2000));
+    EXPECT_TRUE(harness.monitor.IsOnline());
+    EXPECT_EQ(harness.monitor.ReconnectCount(), 1u);
+
+    std::lock_guard<std::mutex> lock(harness.mutex);
+    if (harness.events.size() < 2) {
+        return;
+    }
+    const DeviceEvent& reconnected = harness.events[1];
+    EXPECT_TRUE(harness.events[0].type == DeviceEvent::Type::Offline);
+    EXPECT_TRUE(reconnected.type == DeviceEvent::Type::Reconnected);
+    EXPECT_EQ(reconnected.replayFailures, 0u);
+    EXPECT_EQ(reconnected.channels.size(), 1u);
+
+    const DEVICE_HANDLE device = harness.monitor.Handle();
+    EXPECT_TRUE(device == reconnected.deviceHandle);
+    EXPECT_TRUE(ValueOf(device, "0/toggle") == "1");
+    EXPECT_TRUE(ValueOf(device, "0/replay_order") == "afterStart");
+
+    // 回放的通道在原总线上收发
+    if (reconnected.channels.size() == 1) {
+        const CHANNEL_HANDLE replayed = reconnected.channels[0].second;
+        ZCAN_Transmit_Data frame = SimCanFrame(0x321, 8, 7);
+        EXPECT_EQ(ZcanTransmit(peer.channels[0], &frame, 1), 1u);
+        ZCAN_Receive_Data received;
+        EXPECT_EQ(ZcanReceive(replayed, &received, 1, 500), 1u);
+        EXPECT_EQ(received.frame.can_id, 0x321u);
+    }
+}
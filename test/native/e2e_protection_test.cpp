@@ -0,0 +1,97 @@
+#include "native_test.h"
+
+#include "e2e_protection.h"
+
+/**
+ * E2E CRC与配置文件已知答案测试
+ * CRC8/CRC8H2F校验值取自AUTOSAR CRC库规范（SWS_CRCLibrary）的校验表；
+ * P01/P11向量按E2E库规范中Crc_CalculateCRC8的调用顺序（起始值0xFF、IsFirstCall=FALSE、
+ * 先DataID低字节再高字节、最后异或0xFF）逐步计算，用于发现与合规ECU不一致的初值或结果异或
+ */
+
+namespace {
+
+struct CrcVector {
+    std::vector<BYTE> data;
+    uint8_t crc8;
+    uint8_t crc8H2F;
+};
+
+const std::vector<CrcVector>& CrcVectors() {
+    static const std::vector<CrcVector> vectors = {
+        {{0x00, 0x00, 0x00, 0x00}, 0x59, 0x12},
+        {{0xF2, 0x01, 0x83}, 0x37, 0xC2},
+        {{0x0F, 0xAA, 0x00, 0x55}, 0x79, 0xC6},
+        {{0x00, 0xFF, 0x55, 0x11}, 0xB8, 0x77},
+        {{0x33, 0x22, 0x55, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF}, 0xCB, 0x11},
+        {{0x92, 0x6B, 0x55}, 0x8C, 0x33},
+        {{0xFF, 0xFF, 0xFF, 0xFF}, 0x74, 0x6C},
+    };
+    return vectors;
+}
+
+E2eConfig MakeConfig(E2eProfile profile, uint32_t dataId) {
+    E2eConfig config;
+    config.profile = profile;
+    config.dataId = dataId;
+    return config;
+}
+
+}  // namespace
+
+NATIVE_TEST("E2E CRC", "CRC8 SAE J1850与AUTOSAR校验表一致") {
+    for (const CrcVector& v : CrcVectors()) {
+        EXPECT_EQ(static_cast<uint8_t>(E2eCrc8(v.data.data(), v.data.size(), 0xFF) ^ 0xFF), v.crc8);
+    }
+    const char* check = "123456789";
+    EXPECT_EQ(static_cast<uint8_t>(E2eCrc8(reinterpret_cast<const BYTE*>(check), 9, 0xFF) ^ 0xFF), 0x4B);
+}
+
+NATIVE_TEST("E2E CRC", "CRC8H2F与AUTOSAR校验表一致") {
+    for (const CrcVector& v : CrcVectors()) {
+        EXPECT_EQ(static_cast<uint8_t>(E2eCrc8H2F(v.data.data(), v.data.size(), 0xFF) ^ 0xFF), v.crc8H2F);
+    }
+}
+
+NATIVE_TEST("E2E CRC", "分段计算与整段计算结果相同") {
+    const std::vector<BYTE>& data = CrcVectors()[4].data;
+    for (size_t split = 0; split <= data.size(); split++) {
+        const uint8_t head = E2eCrc8(data.data(), split, 0xFF);
+        EXPECT_EQ(E2eCrc8(data.data() + split, data.size() - split, head), E2eCrc8(data.data(), data.size(), 0xFF));
+    }
+}
+
+NATIVE_TEST("E2E P01/P11", "P01全零数据与DataID 0的CRC为0x00") {
+    BYTE data[8] = {};
+    EXPECT_TRUE(E2eProtect(MakeConfig(E2eProfile::P01, 0), data, sizeof(data), 0));
+    EXPECT_EQ(data[0], 0x00);
+    EXPECT_EQ(data[1], 0x00);
+}
+
+NATIVE_TEST("E2E P01/P11", "P01按库调用顺序计算的已知答案") {
+    BYTE data[8] = {0x00, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
+    const E2eConfig config = MakeConfig(E2eProfile::P01, 0x0123);
+    EXPECT_TRUE(E2eProtect(config, data, sizeof(data), 3));
+    EXPECT_EQ(data[1], 0x03);
+    EXPECT_EQ(data[0], 0x3A);
+
+    E2eCheckState state;
+    uint32_t counter = 0;
+    EXPECT_TRUE(E2eCheck(config, data, sizeof(data), &state, &counter) == E2eStatus::Ok);
+    EXPECT_EQ(counter, 3u);
+}
+
+NATIVE_TEST("E2E P01/P11", "P11使用0xFF初值和结果异或") {
+    BYTE data[8] = {0x00, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
+    EXPECT_TRUE(E2eProtect(MakeConfig(E2eProfile::P11, 0x0123), data, sizeof(data), 3));
+    EXPECT_EQ(data[0], 0x46);
+}
+
+NATIVE_TEST("E2E P01/P11", "P01报文按P11检查时CRC错误") {
+    BYTE data[8] = {0x00, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
+    EXPECT_TRUE(E2eProtect(MakeConfig(E2eProfile::P01, 0x0123), data, sizeof(data), 3));
+    E2eCheckState state;
+    uint32_t counter = 0;
+    EXPECT_TRUE(E2eCheck(MakeConfig(E2eProfile::P11, 0x0123), data, sizeof(data), &state, &counter) ==
+                E2eStatus::WrongCrc);
+}
@@ -0,0 +1,76 @@
+#ifndef ZLGCAN_NATIVE_TEST_H_
+#define ZLGCAN_NATIVE_TEST_H_
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * 原生引擎测试
+ * 引擎源文件不依赖napi，与仿真后端链接为独立可执行文件（binding.gyp中的zlgcan_native_tests），
+ * 覆盖JS层测试无法精确驱动的路径：CRC已知答案、监视器Tick、线程调度设置等。
+ * 每个测试以NATIVE_TEST注册，EXPECT_*失败时记录位置并继续执行，全部结束后以非零退出码报告失败。
+ */
+
+struct NativeTestCase {
+    const char* suite;
+    const char* name;
+    std::function<void()> body;
+};
+
+std::vector<NativeTestCase>& NativeTestRegistry();
+
+// 记录当前测试的一次断言失败
+void NativeTestFail(const char* file, int line, const std::string& message);
+
+struct NativeTestRegistrar {
+    NativeTestRegistrar(const char* suite, const char* name, std::function<void()> body) {
+        NativeTestRegistry().push_back({suite, name, std::move(body)});
+    }
+};
+
+// 在timeoutMs内轮询直到条件成立
+inline bool WaitUntil(const std::function<bool()>& ready, int timeoutMs) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!ready()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+#define NATIVE_TEST_CONCAT_INNER(a, b) a##b
+#define NATIVE_TEST_CONCAT(a, b) NATIVE_TEST_CONCAT_INNER(a, b)
+
+#define NATIVE_TEST(suite, name)                                                           \
+    static void NATIVE_TEST_CONCAT(NativeTest_, __LINE__)();                               \
+    static NativeTestRegistrar NATIVE_TEST_CONCAT(nativeTestRegistrar_, __LINE__)(         \
+        suite, name, NATIVE_TEST_CONCAT(NativeTest_, __LINE__));                           \
+    static void NATIVE_TEST_CONCAT(NativeTest_, __LINE__)()
+
+#define EXPECT_TRUE(cond)                                                                  \
+    do {                                                                                   \
+        if (!(cond)) {                                                                     \
+            NativeTestFail(__FILE__, __LINE__, "期望为真: " #cond);                        \
+        }                                                                                  \
+    } while (0)
+
+#define EXPECT_EQ(actual, expected)                                                        \
+    do {                                                                                   \
+        const auto nativeTestActual = (actual);                                            \
+        const auto nativeTestExpected = (expected);                                        \
+        if (!(nativeTestActual == nativeTestExpected)) {                                   \
+            std::ostringstream nativeTestMessage;                                          \
+            nativeTestMessage << #actual << " = " << +nativeTestActual << ", 期望 "        \
+                              << +nativeTestExpected;                                      \
+            NativeTestFail(__FILE__, __LINE__, nativeTestMessage.str());                   \
+        }                                                                                  \
+    } while (0)
+
+#endif  // ZLGCAN_NATIVE_TEST_H_
@@ -0,0 +1,57 @@
+#include "native_test.h"
+
+#include <chrono>
+
+namespace {
+
+std::vector<std::string>* g_currentFailures = nullptr;
+
+}  // namespace
+
+std::vector<NativeTestCase>& NativeTestRegistry() {
+    static std::vector<NativeTestCase> registry;
+    return registry;
+}
+
+void NativeTestFail(const char* file, int line, const std::string& message) {
+    std::ostringstream entry;
+    entry << file << ":" << line << " " << message;
+    if (g_currentFailures != nullptr) {
+        g_currentFailures->push_back(entry.str());
+    }
+}
+
+int main() {
+    int passed = 0;
+    int failed = 0;
+    const char* suite = "";
+    for (const NativeTestCase& test : NativeTestRegistry()) {
+        if (std::string(suite) != test.suite) {
+            suite = test.suite;
+            std::printf("\n%s\n", suite);
+        }
+        std::vector<std::string> failures;
+        g_currentFailures = &failures;
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            test.body();
+        } catch (const std::exception& e) {
+            failures.push_back(std::string("未捕获异常: ") + e.what());
+        }
+        g_currentFailures = nullptr;
+        const long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        if (failures.empty()) {
+            passed++;
+            std::printf("  \x1b[32m✓\x1b[0m %s (%lldms)\n", test.name, ms);
+        } else {
+            failed++;
+            std::printf("  \x1b[31m✗\x1b[0m %s\n", test.name);
+            for (const std::string& failure : failures) {
+                std::printf("      %s\n", failure.c_str());
+            }
+        }
+    }
+    std::printf("\n%d通过, %d失败\n", passed, failed);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+#include "native_test.h"
+#include "sim_fixture.h"
+
+#include "pipeline_watchdog.h"
+
+/**
+ * 接收链路监视器测试
+ * 不启动监视线程，直接调用Tick；ping回调和通道读数由测试提供
+ */
+
+namespace {
+
+struct WatchdogHarness {
+    explicit WatchdogHarness(const PipelineWatchdogOptions& options)
+        : watchdog(options,
+                   [this](const PipelineWatchdog::PongFn& pong) {
+                       if (answerImmediately) {
+                           pong();
+                       } else {
+                           pending = pong;
+                       }
+                       return true;
+                   },
+                   [this](const PipelineWarning& warning) { warnings.push_back(warning); }) {
+        PipelineSource source;
+        source.channelIndex = 3;
+        source.read = [this] { return reading; };
+        watchdog.SetSources({source});
+    }
+
+    // 取走本次Tick产生的指定类型告警数
+    size_t Take(PipelineWarning::Type type) {
+        size_t count = 0;
+        for (auto it = warnings.begin(); it != warnings.end();) {
+            if (it->type == type) {
+                last = *it;
+                count++;
+                it = warnings.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return count;
+    }
+
+    bool answerImmediately = true;
+    PipelineWatchdog::PongFn pending;
+    PipelineSourceReading reading;
+    std::vector<PipelineWarning> warnings;
+    PipelineWarning last;
+    PipelineWatchdog watchdog;
+};
+
+PipelineWatchdogOptions QuietOptions() {
+    PipelineWatchdogOptions options;
+    options.lagWarnMs = 1000000;
+    options.vendorWarnFrames = 1000000;
+    return options;
+}
+
+}  // namespace
+
+NATIVE_TEST("接收链路监视", "事件循环未应答时告警一次，应答回落后重新启用") {
+    PipelineWatchdogOptions options = QuietOptions();
+    options.lagWarnMs = 10;
+    WatchdogHarness harness(options);
+
+    harness.answerImmediately = false;
+    harness.watchdog.Tick();                       // 发出探测
+    EXPECT_EQ(harness.Take(PipelineWarning::Type::EventLoopLag), 0u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(15));
+    harness.watchdog.Tick();                       // 探测未应答，已等待超过阈值
+    EXPECT_EQ(harness.Take(PipelineWarning::Type::EventLoopLag), 1u);
+    EXPECT_TRUE(harness.last.value >= 10);
+    harness.watchdog.Tick();                       // 仍未应答，不重复告警
+    EXPECT_EQ(harness.Take(PipelineWarning::Type::EventLoopLag), 0u);
+
+    std::vector<PipelineSample> history = harness.watchdog.History(0);
+    EXPECT_EQ(history.size(), 3u);
+    EXPECT_TRUE(history.size() == 3 && !history[0].stalled && history[1].stalled && history[2].stalled);
+
+    harness.answerImmediately = true;
+    harness.pending();                             // JS线程终于执行应答
+    harness.watchdog.Tick();                       // 取走迟到的延迟，仍高于阈值一半，不解除
+    EXPECT_EQ(harness.Take(PipelineWarning::Type::EventLoopLag), 0u);
+    harness.watchdog.Tick();                       // 立即应答，延迟回落，解除
+    harness.watchdog.Tick();
+    EXPECT_EQ(harness.Take(PipelineWarning::Type::EventLoopLag), 0u);
+
+    harness.answerImmediately = false;
+    harness.watchdog.Tick();
+    std::this_thread::sleep_for(std::chrono::milliseconds(15));
+    harness.watchdog.Tick();
+    EXPECT_EQ(harness.Take(PipelineWarning::Type::EventLoopLag), 1u);
+}
+
+NATIVE_TEST("接收链路监视", "环形缓冲占用率告警带迟滞和写满估计") {
+    PipelineWatchdogOptions options = QuietOptions();
+    options.ringWarnRatio = 0.5;
+    WatchdogHarness harness(options);
+    harness.reading.ringCapacity = 100;
+
+    const uint64_t depths[] = {40, 60, 70, 30, 60, 20, 55};
+    const size_t expected[] = {0, 1, 0, 0, 0, 0, 1};
+    for (size_t i = 0; i < sizeof(depths) / sizeof(depths[0]); i++) {
+        harness.reading.ringDepth = depths[i];
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        harness.watchdog.Tick();
+        EXPECT_EQ(harness.Take(PipelineWarning::Type::RingFilling), expected[i]);
+        if (i == 1) {
+            EXPECT_EQ(harness.last.channelIndex, 3u);
+            EXPECT_TRUE(harness.last.value == 0.6 && harness.last.threshold == 0.5);
+            // 一个周期增长20帧，剩余40帧约两个周期写满
+            EXPECT_TRUE(harness.last.etaMs > 0);
+        }
+    }
+    const std::vector<PipelineSample> history = harness.watchdog.History(0);
+    EXPECT_TRUE(!history.empty() && history.back().channels.size() == 1 &&
+                history.back().channels[0].ringDepth == 55 && history.back().channels[0].ringCapacity == 100);
+}
+
+NATIVE_TEST("接收链路监视", "驱动缓冲深度告警带迟滞") {
+    PipelineWatchdogOptions options = QuietOptions();
+    options.vendorWarnFrames = 100;
+    WatchdogHarness harness(options);
+
+    const uint64_t depths[] = {99, 100, 150, 60, 120, 40, 100};
+    const size_t expected[] = {0, 1, 0, 0, 0, 0, 1};
+    for (size_t i = 0; i < sizeof(depths) / sizeof(depths[0]); i++) {
+        harness.reading.vendorDepth = depths[i];
+        harness.watchdog.Tick();
+        EXPECT_EQ(harness.Take(PipelineWarning::Type::VendorQueue), expected[i]);
+    }
+    // 未启动接收线程的通道不做环形缓冲告警
+    EXPECT_EQ(harness.Take(PipelineWarning::Type::RingFilling), 0u);
+}
+
+NATIVE_TEST("接收链路监视", "丢帧按周期增量告警，首次采样只取基准") {
+    WatchdogHarness harness(QuietOptions());
+    harness.reading.ringCapacity = 1000;
+    harness.reading.framesDropped = 40;            // 监视开始前的丢帧不告警
+    harness.watchdog.Tick();
+    EXPECT_EQ(harness.Take(PipelineWarning::Type::FramesDropped), 0u);
+
+    harness.reading.framesDropped = 45;
+    harness.reading.framesReceived = 500;
+    harness.watchdog.Tick();
+    EXPECT_EQ(harness.Take(PipelineWarning::Type::FramesDropped), 1u);
+    EXPECT_EQ(harness.last.value, 5.0);
+
+    harness.watchdog.Tick();
+    EXPECT_EQ(harness.Take(PipelineWarning::Type::FramesDropped), 0u);
+    const std::vector<PipelineSample> history = harness.watchdog.History(0);
+    EXPECT_TRUE(history.size() == 3 && history[1].channels[0].framesDropped == 5 &&
+                history[1].channels[0].framesReceived == 500 && history[2].channels[0].framesDropped == 0);
+}
+
+NATIVE_TEST("接收链路监视", "仿真通道积压时报告驱动缓冲告警") {
+    SimDeviceFixture sim(11, false);
+    EXPECT_TRUE(sim.Ready());
+
+    PipelineWatchdogOptions options = QuietOptions();
+    options.vendorWarnFrames = 20;
+    std::vector<PipelineWarning> warnings;
+    PipelineWatchdog watchdog(options, [](const PipelineWatchdog::PongFn& pong) { pong(); return true; },
+                              [&warnings](const PipelineWarning& warning) { warnings.push_back(warning); });
+    PipelineSource source;
+    source.channelIndex = 1;
+    source.channelHandle = sim.channels[1];
+    watchdog.SetSources({source});
+
+    std::vector<ZCAN_Transmit_Data> frames;
+    for (BYTE i = 0; i < 30; i++) {
+        frames.push_back(SimCanFrame(0x200 + i, 8, i));
+    }
+    EXPECT_EQ(ZcanTransmit(sim.channels[0], frames.data(), static_cast<UINT>(frames.size())), 30u);
+    EXPECT_TRUE(WaitUntil([&] { return ZcanGetReceiveNum(sim.channels[1], TYPE_CAN) == 30; }, 500));
+
+    watchdog.Tick();
+    EXPECT_EQ(warnings.size(), 1u);
+    EXPECT_TRUE(!warnings.empty() && warnings[0].type == PipelineWarning::Type::VendorQueue &&
+                warnings[0].channelIndex == 1 && warnings[0].value == 30);
+}
@@ -0,0 +1,278 @@
+#include "native_test.h"
+#include "sim_fixture.h"
+
+#include "receive_pump.h"
+
+#include <atomic>
+
+/**
+ * 通道接收线程测试
+ * 仿真通道0发送、通道1由接收线程读取，三种驱动读取方式均应完整、有序地交付帧；
+ * 帧流缓冲各自收到全部帧，按各自的容量和丢弃策略丢帧；只有帧流取帧时不写默认缓冲；
+ * 等待未认领帧在帧到达时即返回
+ */
+
+namespace {
+
+constexpr UINT CAN_FRAMES = 50;
+constexpr UINT FD_FRAMES = 5;
+
+// 发送CAN_FRAMES个经典帧和FD_FRAMES个FD帧
+void SendBurst(const SimDeviceFixture& sim) {
+    std::vector<ZCAN_Transmit_Data> frames;
+    for (UINT i = 0; i < CAN_FRAMES; i++) {
+        frames.push_back(SimCanFrame(0x100 + i, 8, static_cast<BYTE>(i)));
+    }
+    EXPECT_EQ(ZcanTransmit(sim.channels[0], frames.data(), CAN_FRAMES), CAN_FRAMES);
+
+    std::vector<ZCAN_TransmitFD_Data> fdFrames(FD_FRAMES);
+    for (UINT i = 0; i < FD_FRAMES; i++) {
+        std::memset(&fdFrames[i], 0, sizeof(fdFrames[i]));
+        fdFrames[i].frame.can_id = 0x500 + i;
+        fdFrames[i].frame.len = 32;
+    }
+    EXPECT_EQ(ZcanTransmitFD(sim.channels[0], fdFrames.data(), FD_FRAMES), FD_FRAMES);
+}
+
+// 按指定方式启动接收线程，检查帧完整有序、统计一致、停止及时
+void CheckMode(UINT deviceIndex, ReceiveMode mode) {
+    SimDeviceFixture sim(deviceIndex, false);
+    EXPECT_TRUE(sim.Ready());
+
+    ReceivePumpOptions options;
+    options.mode = mode;
+    options.blockWaitMs = 20;
+    ReceivePump pump(sim.channels[1], options);
+    pump.Start();
+    EXPECT_TRUE(pump.IsRunning());
+    SendBurst(sim);
+
+    std::vector<ZCAN_Receive_Data> frames(CAN_FRAMES + 1);
+    UINT count = 0;
+    EXPECT_TRUE(WaitUntil([&] {
+        count += pump.PopCan(frames.data() + count, CAN_FRAMES + 1 - count, 10);
+        return count >= CAN_FRAMES;
+    }, 1000));
+    EXPECT_EQ(count, CAN_FRAMES);
+    bool ordered = true;
+    for (UINT i = 0; i < count; i++) {
+        ordered = ordered && frames[i].frame.can_id == 0x100 + i && frames[i].frame.data[0] == static_cast<BYTE>(i);
+    }
+    EXPECT_TRUE(ordered);
+
+    ZCAN_ReceiveFD_Data fdFrames[FD_FRAMES + 1];
+    UINT fdCount = 0;
+    EXPECT_TRUE(WaitUntil([&] {
+        fdCount += pump.PopCanFD(fdFrames + fdCount, FD_FRAMES + 1 - fdCount, 10);
+        return fdCount >= FD_FRAMES;
+    }, 1000));
+    EXPECT_EQ(fdCount, FD_FRAMES);
+    EXPECT_TRUE(fdCount == 0 || (fdFrames[0].frame.can_id == 0x500 && fdFrames[0].frame.len == 32));
+
+    const ReceivePumpStats stats = pump.Stats();
+    EXPECT_TRUE(stats.mode == mode);
+    EXPECT_EQ(stats.framesReceived, static_cast<uint64_t>(CAN_FRAMES + FD_FRAMES));
+    EXPECT_EQ(stats.framesDropped, 0u);
+    EXPECT_TRUE(stats.wakeups > 0);
+    EXPECT_TRUE(stats.canRingDepth == 0 && stats.fdRingDepth == 0);
+
+    // 阻塞方式最长在一次blockWaitMs后响应停止
+    const auto stopAt = std::chrono::steady_clock::now();
+    pump.Stop();
+    EXPECT_TRUE(std::chrono::steady_clock::now() - stopAt < std::chrono::milliseconds(options.blockWaitMs + 50));
+    EXPECT_TRUE(!pump.IsRunning());
+}
+
+// 空闲总线上接收线程在windowMs内的CPU占用率
+double IdleCpuShare(UINT deviceIndex, ReceiveMode mode, int windowMs) {
+    SimDeviceFixture sim(deviceIndex, false);
+    ReceivePumpOptions options;
+    options.mode = mode;
+    ReceivePump pump(sim.channels[1], options);
+    pump.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    const ReceivePumpStats before = pump.Stats();
+    std::this_thread::sleep_for(std::chrono::milliseconds(windowMs));
+    const ReceivePumpStats after = pump.Stats();
+    pump.Stop();
+    const double uptime = static_cast<double>(after.uptimeUs - before.uptimeUs);
+    return uptime > 0 ? static_cast<double>(after.cpuTimeUs - before.cpuTimeUs) / uptime : 0;
+}
+
+// 等待接收线程读出SendBurst发送的全部帧
+bool WaitBurstReceived(const ReceivePump& pump) {
+    return WaitUntil([&] { return pump.Stats().framesReceived >= CAN_FRAMES + FD_FRAMES; }, 1000);
+}
+
+// 取出帧流缓冲中的全部CAN帧
+std::vector<ZCAN_Receive_Data> DrainTapCan(ReceivePump& pump, UINT tapId) {
+    std::vector<ZCAN_Receive_Data> frames(CAN_FRAMES + 1);
+    frames.resize(pump.PopTapCan(tapId, frames.data(), CAN_FRAMES + 1));
+    return frames;
+}
+
+}  // namespace
+
+NATIVE_TEST("接收线程", "blocking方式完整有序交付CAN和CANFD帧") {
+    CheckMode(20, ReceiveMode::Blocking);
+}
+
+NATIVE_TEST("接收线程", "adaptive方式完整有序交付CAN和CANFD帧") {
+    CheckMode(21, ReceiveMode::Adaptive);
+}
+
+NATIVE_TEST("接收线程", "busyPoll方式完整有序交付CAN和CANFD帧") {
+    CheckMode(22, ReceiveMode::BusyPoll);
+}
+
+NATIVE_TEST("接收线程", "空闲时blocking几乎不占CPU，busyPoll持续占用") {
+    const double blocking = IdleCpuShare(23, ReceiveMode::Blocking, 200);
+    const double busyPoll = IdleCpuShare(24, ReceiveMode::BusyPoll, 200);
+    EXPECT_TRUE(blocking < 0.2);
+    EXPECT_TRUE(busyPoll > blocking);
+}
+
+NATIVE_TEST("接收线程", "读取方式名称可往返解析") {
+    const ReceiveMode modes[] = {ReceiveMode::Blocking, ReceiveMode::Adaptive, ReceiveMode::BusyPoll};
+    for (ReceiveMode mode : modes) {
+        ReceiveMode parsed = ReceiveMode::Adaptive;
+        EXPECT_TRUE(ParseReceiveMode(ReceiveModeName(mode), &parsed) && parsed == mode);
+    }
+    ReceiveMode unused;
+    EXPECT_TRUE(!ParseReceiveMode("polling", &unused));
+}
+
+NATIVE_TEST("接收线程", "各帧流与receive互不分取，均收到全部帧") {
+    SimDeviceFixture sim(25, false);
+    EXPECT_TRUE(sim.Ready());
+    ReceivePump pump(sim.channels[1], ReceivePumpOptions());
+    const UINT first = pump.OpenTap(1000, RingDropPolicy::DropOldest, nullptr);
+    const UINT second = pump.OpenTap(1000, RingDropPolicy::DropNewest, nullptr);
+    EXPECT_TRUE(first != second);
+    EXPECT_EQ(pump.TapCount(), 2u);
+    pump.Start();
+    SendBurst(sim);
+    EXPECT_TRUE(WaitBurstReceived(pump));
+
+    std::vector<ZCAN_Receive_Data> frames(CAN_FRAMES + 1);
+    EXPECT_EQ(pump.PopCan(frames.data(), CAN_FRAMES + 1, 0), CAN_FRAMES);
+    for (UINT tapId : {first, second}) {
+        const std::vector<ZCAN_Receive_Data> tapFrames = DrainTapCan(pump, tapId);
+        EXPECT_EQ(tapFrames.size(), static_cast<size_t>(CAN_FRAMES));
+        EXPECT_TRUE(!tapFrames.empty() && tapFrames.front().frame.can_id == 0x100 &&
+                    tapFrames.back().frame.can_id == 0x100 + CAN_FRAMES - 1);
+        ZCAN_ReceiveFD_Data fdFrames[FD_FRAMES + 1];
+        EXPECT_EQ(pump.PopTapCanFD(tapId, fdFrames, FD_FRAMES + 1), FD_FRAMES);
+        ReceiveTapStats stats;
+        EXPECT_TRUE(pump.TapStats(tapId, &stats));
+        EXPECT_TRUE(stats.canDepth == 0 && stats.fdDepth == 0 && stats.dropped == 0);
+    }
+    pump.Stop();
+}
+
+NATIVE_TEST("接收线程", "帧流按各自的容量和丢弃策略丢帧并分别计数") {
+    SimDeviceFixture sim(26, false);
+    EXPECT_TRUE(sim.Ready());
+    ReceivePump pump(sim.channels[1], ReceivePumpOptions());
+    const UINT oldest = pump.OpenTap(10, RingDropPolicy::DropOldest, nullptr);
+    const UINT newest = pump.OpenTap(10, RingDropPolicy::DropNewest, nullptr);
+    pump.Start();
+    SendBurst(sim);
+    EXPECT_TRUE(WaitBurstReceived(pump));
+
+    // 保留最新的10帧
+    const std::vector<ZCAN_Receive_Data> kept = DrainTapCan(pump, oldest);
+    EXPECT_EQ(kept.size(), 10u);
+    EXPECT_TRUE(!kept.empty() && kept.front().frame.can_id == 0x100 + CAN_FRAMES - 10);
+    // 保留最早的10帧
+    const std::vector<ZCAN_Receive_Data> early = DrainTapCan(pump, newest);
+    EXPECT_EQ(early.size(), 10u);
+    EXPECT_TRUE(!early.empty() && early.front().frame.can_id == 0x100 && early.back().frame.can_id == 0x109);
+
+    ReceiveTapStats stats;
+    EXPECT_TRUE(pump.TapStats(oldest, &stats));
+    EXPECT_EQ(stats.dropped, static_cast<uint64_t>(CAN_FRAMES - 10));
+    EXPECT_TRUE(pump.TapStats(newest, &stats));
+    EXPECT_EQ(stats.dropped, static_cast<uint64_t>(CAN_FRAMES - 10));
+    // 帧流丢帧不计入默认缓冲
+    EXPECT_EQ(pump.Stats().framesDropped, 0u);
+    pump.Stop();
+}
+
+NATIVE_TEST("接收线程", "帧流就绪通知登记一次触发一次，关闭后不再通知") {
+    SimDeviceFixture sim(27, false);
+    EXPECT_TRUE(sim.Ready());
+    ReceivePump pump(sim.channels[1], ReceivePumpOptions());
+    std::atomic<int> notified{0};
+    const UINT tapId = pump.OpenTap(100, RingDropPolicy::DropOldest, [&notified] { notified++; });
+    pump.Start();
+    EXPECT_TRUE(!pump.ArmTap(tapId));
+
+    ZCAN_Transmit_Data frame = SimCanFrame(0x123, 8, 0);
+    EXPECT_EQ(ZcanTransmit(sim.channels[0], &frame, 1), 1u);
+    EXPECT_TRUE(WaitUntil([&] { return notified.load() == 1; }, 1000));
+    // 未重新登记时不再通知
+    EXPECT_EQ(ZcanTransmit(sim.channels[0], &frame, 1), 1u);
+    EXPECT_TRUE(WaitUntil([&] { return pump.Stats().framesReceived >= 2; }, 1000));
+    EXPECT_EQ(notified.load(), 1);
+    // 缓冲有帧时不登记
+    EXPECT_TRUE(pump.ArmTap(tapId));
+    EXPECT_EQ(DrainTapCan(pump, tapId).size(), 2u);
+
+    EXPECT_TRUE(!pump.ArmTap(tapId));
+    pump.CloseTap(tapId);
+    EXPECT_EQ(pump.TapCount(), 0u);
+    EXPECT_EQ(ZcanTransmit(sim.channels[0], &frame, 1), 1u);
+    EXPECT_TRUE(WaitUntil([&] { return pump.Stats().framesReceived >= 3; }, 1000));
+    EXPECT_EQ(notified.load(), 1);
+    ReceiveTapStats stats;
+    EXPECT_TRUE(!pump.TapStats(tapId, &stats));
+    EXPECT_EQ(DrainTapCan(pump, tapId).size(), 0u);
+    pump.Stop();
+}
+
+NATIVE_TEST("接收线程", "只有帧流取帧时不写默认缓冲，首次取帧后开始写入") {
+    SimDeviceFixture sim(28, false);
+    EXPECT_TRUE(sim.Ready());
+    ReceivePumpOptions options;
+    options.ringCapacity = 10;
+    options.sharedRing = false;
+    ReceivePump pump(sim.channels[1], options);
+    const UINT tapId = pump.OpenTap(1000, RingDropPolicy::DropOldest, nullptr);
+    pump.Start();
+    SendBurst(sim);
+    EXPECT_TRUE(WaitBurstReceived(pump));
+
+    EXPECT_EQ(DrainTapCan(pump, tapId).size(), static_cast<size_t>(CAN_FRAMES));
+    ReceivePumpStats stats = pump.Stats();
+    EXPECT_TRUE(stats.canRingDepth == 0 && stats.fdRingDepth == 0);
+    EXPECT_EQ(stats.framesDropped, 0u);
+
+    // 首次取帧之后到达的帧进入默认缓冲
+    ZCAN_Receive_Data received;
+    EXPECT_EQ(pump.PopCan(&received, 1, 0), 0u);
+    ZCAN_Transmit_Data frame = SimCanFrame(0x234, 8, 0);
+    EXPECT_EQ(ZcanTransmit(sim.channels[0], &frame, 1), 1u);
+    EXPECT_EQ(pump.PopCan(&received, 1, 500), 1u);
+    EXPECT_EQ(received.frame.can_id, 0x234u);
+    pump.Stop();
+}
+
+NATIVE_TEST("接收线程", "等待未认领帧在帧到达时返回，超时返回false") {
+    SimDeviceFixture sim(52, false);
+    EXPECT_TRUE(sim.Ready());
+    ReceivePump pump(sim.channels[1], ReceivePumpOptions());
+    pump.Start();
+    EXPECT_TRUE(!pump.WaitUnclaimed(std::chrono::steady_clock::now() + std::chrono::milliseconds(20)));
+
+    std::thread sender([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        ZCAN_Transmit_Data frame = SimCanFrame(0x345, 8, 0);
+        ZcanTransmit(sim.channels[0], &frame, 1);
+    });
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(pump.WaitUnclaimed(start + std::chrono::milliseconds(2000)));
+    EXPECT_TRUE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1000));
+    sender.join();
+    pump.Stop();
+}
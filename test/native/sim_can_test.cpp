@@ -0,0 +1,133 @@
+#include "native_test.h"
+#include "sim_fixture.h"
+
+#include "sim/sim_can.h"
+
+/**
+ * 仿真后端测试
+ * 同一仿真总线上的两个通道互发，覆盖经典帧、CANFD/BRS、发送回显、帧时长计算和错误计数注入
+ */
+
+NATIVE_TEST("仿真后端", "经典帧按发送顺序投递到对端通道") {
+    SimDeviceFixture sim(0);
+    EXPECT_TRUE(sim.Ready());
+
+    ZCAN_Transmit_Data frames[3] = {SimCanFrame(0x123, 8, 0x10), SimCanFrame(0x7FF, 2, 0x20),
+                                    SimCanFrame(0x1ABCDE | CAN_EFF_FLAG, 5, 0x30)};
+    EXPECT_EQ(ZcanTransmit(sim.channels[0], frames, 3), 3u);
+
+    ZCAN_Receive_Data received[4];
+    UINT count = 0;
+    EXPECT_TRUE(WaitUntil([&] {
+        count += ZcanReceive(sim.channels[1], received + count, 4 - count, 0);
+        return count >= 3;
+    }, 500));
+    EXPECT_EQ(count, 3u);
+    for (UINT i = 0; i < count && i < 3; i++) {
+        EXPECT_EQ(received[i].frame.can_id, frames[i].frame.can_id);
+        EXPECT_EQ(received[i].frame.can_dlc, frames[i].frame.can_dlc);
+        EXPECT_TRUE(std::memcmp(received[i].frame.data, frames[i].frame.data, frames[i].frame.can_dlc) == 0);
+        EXPECT_EQ(received[i].frame.__pad & TX_ECHO_FLAG, 0);
+    }
+    EXPECT_TRUE(count < 2 || received[1].timestamp > received[0].timestamp);
+    // 未请求回显时发送方不收到自己的帧
+    EXPECT_EQ(ZcanGetReceiveNum(sim.channels[0], TYPE_CAN), 0u);
+}
+
+NATIVE_TEST("仿真后端", "CANFD 64字节BRS帧保留长度和标志") {
+    SimDeviceFixture sim(1);
+    EXPECT_TRUE(sim.Ready());
+
+    ZCAN_TransmitFD_Data frame;
+    std::memset(&frame, 0, sizeof(frame));
+    frame.frame.can_id = 0x456;
+    frame.frame.len = 64;
+    frame.frame.flags = CANFD_BRS;
+    for (BYTE i = 0; i < 64; i++) {
+        frame.frame.data[i] = static_cast<BYTE>(0xA0 ^ i);
+    }
+    EXPECT_EQ(ZcanTransmitFD(sim.channels[0], &frame, 1), 1u);
+
+    ZCAN_ReceiveFD_Data received;
+    UINT count = 0;
+    EXPECT_TRUE(WaitUntil([&] {
+        count += ZcanReceiveFD(sim.channels[1], &received, 1, 0);
+        return count == 1;
+    }, 500));
+    if (count == 1) {
+        EXPECT_EQ(received.frame.can_id, 0x456u);
+        EXPECT_EQ(received.frame.len, 64);
+        EXPECT_TRUE((received.frame.flags & CANFD_BRS) != 0);
+        EXPECT_TRUE(std::memcmp(received.frame.data, frame.frame.data, 64) == 0);
+    }
+    // FD帧不进入经典帧缓冲
+    EXPECT_EQ(ZcanGetReceiveNum(sim.channels[1], TYPE_CAN), 0u);
+}
+
+NATIVE_TEST("仿真后端", "请求回显的帧带TX_ECHO_FLAG返回发送通道") {
+    SimDeviceFixture sim(2);
+    EXPECT_TRUE(sim.Ready());
+
+    ZCAN_Transmit_Data frame = SimCanFrame(0x321, 4, 0x01);
+    frame.frame.__pad = TX_ECHO_FLAG;
+    EXPECT_EQ(ZcanTransmit(sim.channels[0], &frame, 1), 1u);
+
+    ZCAN_Receive_Data echo;
+    UINT count = 0;
+    EXPECT_TRUE(WaitUntil([&] {
+        count += ZcanReceive(sim.channels[0], &echo, 1, 0);
+        return count == 1;
+    }, 500));
+    if (count == 1) {
+        EXPECT_EQ(echo.frame.can_id, 0x321u);
+        EXPECT_TRUE((echo.frame.__pad & TX_ECHO_FLAG) != 0);
+    }
+    EXPECT_TRUE(WaitUntil([&] { return ZcanGetReceiveNum(sim.channels[1], TYPE_CAN) == 1; }, 500));
+}
+
+NATIVE_TEST("仿真后端", "帧时长随长度、填充位和BRS变化") {
+    canfd_frame zeros;
+    std::memset(&zeros, 0, sizeof(zeros));
+    zeros.can_id = 0x100;
+    zeros.len = 8;
+    canfd_frame alternating = zeros;
+    std::memset(alternating.data, 0x55, 8);
+
+    // 标准帧8字节无填充为111位（含3位帧间隔），500k下222us；全零数据插入填充位
+    const int64_t plain = SimCan::FrameDurationNs(alternating, false, 500000, 2000000);
+    const int64_t stuffed = SimCan::FrameDurationNs(zeros, false, 500000, 2000000);
+    EXPECT_TRUE(plain >= 216000 && plain <= 230000);
+    EXPECT_TRUE(stuffed > plain);
+
+    canfd_frame fd = alternating;
+    fd.len = 64;
+    const int64_t slow = SimCan::FrameDurationNs(fd, true, 500000, 2000000);
+    fd.flags = CANFD_BRS;
+    const int64_t fast = SimCan::FrameDurationNs(fd, true, 500000, 2000000);
+    EXPECT_TRUE(fast < slow);
+    EXPECT_TRUE(slow > 4 * plain);
+}
+
+NATIVE_TEST("仿真后端", "注入错误计数后节点状态依次为被动错误和总线关闭") {
+    SimDeviceFixture sim(3);
+    EXPECT_TRUE(sim.Ready());
+
+    EXPECT_EQ(ZcanSetValue(sim.device, "0/sim_tec", "130"), static_cast<UINT>(STATUS_OK));
+    ZCAN_CHANNEL_STATUS status;
+    EXPECT_EQ(ZcanReadChannelStatus(sim.channels[0], &status), static_cast<UINT>(STATUS_OK));
+    EXPECT_EQ(status.regTECounter, 130);
+    ZCAN_CHANNEL_ERR_INFO errInfo;
+    EXPECT_EQ(ZcanReadChannelErrInfo(sim.channels[0], &errInfo), static_cast<UINT>(STATUS_OK));
+    EXPECT_TRUE((errInfo.error_code & ZCAN_ERROR_CAN_PASSIVE) != 0);
+
+    EXPECT_EQ(ZcanSetValue(sim.device, "0/sim_tec", "256"), static_cast<UINT>(STATUS_OK));
+    EXPECT_EQ(ZcanReadChannelStatus(sim.channels[0], &status), static_cast<UINT>(STATUS_OK));
+    EXPECT_TRUE((status.regStatus & 0x80) != 0);
+
+    // 复位后恢复主动错误
+    EXPECT_EQ(ZcanResetCAN(sim.channels[0]), static_cast<UINT>(STATUS_OK));
+    EXPECT_EQ(ZcanStartCAN(sim.channels[0]), static_cast<UINT>(STATUS_OK));
+    EXPECT_EQ(ZcanReadChannelStatus(sim.channels[0], &status), static_cast<UINT>(STATUS_OK));
+    EXPECT_EQ(status.regTECounter, 0);
+    EXPECT_EQ(status.regStatus & 0x80, 0);
+}
@@ -0,0 +1,70 @@
+#ifndef ZLGCAN_NATIVE_SIM_FIXTURE_H_
+#define ZLGCAN_NATIVE_SIM_FIXTURE_H_
+
+#include <cstring>
+#include <string>
+
+#include "native_test.h"
+#include "zlgcan_api.h"
+
+// 仿真设备类型（与JS层ZCAN_DEVICE_TYPE中的USBCANFD_200U一致）
+constexpr UINT SIM_DEVICE_TYPE = 41;
+
+/**
+ * 仿真设备夹具
+ * 打开仿真设备并启动同一仿真总线上的通道0和通道1，析构时关闭设备；
+ * 每个测试使用不同的设备索引和总线号，避免上一测试残留的帧或统计相互影响
+ */
+class SimDeviceFixture {
+public:
+    explicit SimDeviceFixture(UINT deviceIndex, bool realtime = true) {
+        device = ZcanOpenDevice(SIM_DEVICE_TYPE, deviceIndex, 0);
+        if (device == INVALID_DEVICE_HANDLE) {
+            return;
+        }
+        const std::string bus = std::to_string(100 + deviceIndex);
+        ZcanSetValue(device, "0/sim_bus", bus.c_str());
+        ZcanSetValue(device, "1/sim_bus", bus.c_str());
+        ZcanSetValue(device, ("sim/" + bus + "/realtime").c_str(), realtime ? "1" : "0");
+        ZCAN_CHANNEL_INIT_CONFIG config;
+        std::memset(&config, 0, sizeof(config));
+        config.can_type = TYPE_CANFD;
+        for (UINT i = 0; i < 2; i++) {
+            channels[i] = ZcanInitCAN(device, i, &config);
+            if (channels[i] != INVALID_CHANNEL_HANDLE) {
+                ZcanStartCAN(channels[i]);
+            }
+        }
+    }
+
+    ~SimDeviceFixture() {
+        if (device != INVALID_DEVICE_HANDLE) {
+            ZcanCloseDevice(device);
+        }
+    }
+
+    SimDeviceFixture(const SimDeviceFixture&) = delete;
+    SimDeviceFixture& operator=(const SimDeviceFixture&) = delete;
+
+    bool Ready() const {
+        return device != INVALID_DEVICE_HANDLE && channels[0] != INVALID_CHANNEL_HANDLE &&
+               channels[1] != INVALID_CHANNEL_HANDLE;
+    }
+
+    DEVICE_HANDLE device = INVALID_DEVICE_HANDLE;
+    CHANNEL_HANDLE channels[2] = {INVALID_CHANNEL_HANDLE, INVALID_CHANNEL_HANDLE};
+};
+
+// 经典帧
+inline ZCAN_Transmit_Data SimCanFrame(canid_t id, BYTE dlc, BYTE seed) {
+    ZCAN_Transmit_Data frame;
+    std::memset(&frame, 0, sizeof(frame));
+    frame.frame.can_id = id;
+    frame.frame.can_dlc = dlc;
+    for (BYTE i = 0; i < dlc; i++) {
+        frame.frame.data[i] = static_cast<BYTE>(seed + i);
+    }
+    return frame;
+}
+
+#endif  // ZLGCAN_NATIVE_SIM_FIXTURE_H_
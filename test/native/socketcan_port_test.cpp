@@ -0,0 +1,147 @@
+#include "native_test.h"
+
+#include <cstring>
+
+#include <linux/can.h>
+#include <linux/can/error.h>
+
+#include "socketcan/socketcan_port.h"
+
+/**
+ * SocketCAN后端测试（仅Linux）
+ * 滤波分解和错误帧解析不依赖内核接口；收发测试需要已UP的vcan0，不存在时跳过：
+ *   sudo ip link add dev vcan0 type vcan && sudo ip link set vcan0 mtu 72 up
+ */
+
+namespace {
+
+// 按内核CAN_RAW_FILTER的匹配规则判断帧ID是否被接收
+bool Accepted(const std::vector<std::pair<uint32_t, uint32_t>>& filters, uint32_t id) {
+    for (const auto& filter : filters) {
+        if (((id ^ filter.first) & filter.second) == 0) {
+            return true;
+        }
+    }
+    return filters.empty();
+}
+
+SocketCanFrame ErrorFrame(uint32_t id) {
+    SocketCanFrame frame;
+    std::memset(&frame, 0, sizeof(frame));
+    frame.id = id | CAN_ERR_FLAG;
+    frame.len = CAN_ERR_DLC;
+    return frame;
+}
+
+}  // namespace
+
+NATIVE_TEST("SocketCAN", "对齐的ID范围分解为单个前缀块") {
+    const auto filters = SocketCanFilters({{false, 0x100, 0x1FF}});
+    EXPECT_EQ(filters.size(), 1u);
+    if (filters.size() == 1) {
+        EXPECT_EQ(filters[0].first, 0x100u);
+        EXPECT_EQ(filters[0].second, 0x700u | CAN_EFF_FLAG);
+    }
+
+    const auto extended = SocketCanFilters({{true, 0x18DA0000, 0x18DAFFFF}});
+    EXPECT_EQ(extended.size(), 1u);
+    if (extended.size() == 1) {
+        EXPECT_EQ(extended[0].first, 0x18DA0000u | CAN_EFF_FLAG);
+        EXPECT_EQ(extended[0].second, 0x1FFF0000u | CAN_EFF_FLAG);
+    }
+}
+
+NATIVE_TEST("SocketCAN", "任意标准帧范围的滤波结果与范围完全一致") {
+    const uint32_t start = 0x123;
+    const uint32_t end = 0x456;
+    const auto filters = SocketCanFilters({{false, start, end}});
+    EXPECT_TRUE(!filters.empty());
+    int mismatches = 0;
+    for (uint32_t id = 0; id <= CAN_SFF_MASK; id++) {
+        if (Accepted(filters, id) != (id >= start && id <= end)) {
+            mismatches++;
+        }
+        // 同值的扩展帧不应被标准帧滤波接收
+        if (Accepted(filters, id | CAN_EFF_FLAG)) {
+            mismatches++;
+        }
+    }
+    EXPECT_EQ(mismatches, 0);
+}
+
+NATIVE_TEST("SocketCAN", "滤波块超过内核上限时退化为全部接收") {
+    std::vector<SocketCanRange> ranges;
+    for (uint32_t id = 1; id < 2 * 600; id += 2) {
+        ranges.push_back({true, id, id});
+    }
+    EXPECT_TRUE(SocketCanFilters(ranges).empty());
+}
+
+NATIVE_TEST("SocketCAN", "错误帧解析总线关闭、被动错误、总线错误类型和计数器") {
+    EXPECT_TRUE(SocketCanDecodeError(ErrorFrame(CAN_ERR_BUSOFF)).busOff);
+
+    SocketCanFrame crtl = ErrorFrame(CAN_ERR_CRTL | CAN_ERR_CNT);
+    crtl.data[1] = CAN_ERR_CRTL_TX_PASSIVE;
+    crtl.data[6] = 130;
+    crtl.data[7] = 7;
+    const SocketCanError passive = SocketCanDecodeError(crtl);
+    EXPECT_TRUE(passive.passive && !passive.warning && !passive.busOff);
+    EXPECT_TRUE(passive.hasCounters);
+    EXPECT_EQ(passive.tec, 130);
+    EXPECT_EQ(passive.rec, 7);
+
+    EXPECT_EQ(SocketCanDecodeError(ErrorFrame(CAN_ERR_ACK)).busErrorType, 2);
+    SocketCanFrame prot = ErrorFrame(CAN_ERR_PROT);
+    prot.data[3] = CAN_ERR_PROT_LOC_CRC_SEQ;
+    EXPECT_EQ(SocketCanDecodeError(prot).busErrorType, 3);
+    prot.data[3] = CAN_ERR_PROT_LOC_DATA;
+    prot.data[2] = CAN_ERR_PROT_STUFF;
+    EXPECT_EQ(SocketCanDecodeError(prot).busErrorType, 5);
+    prot.data[2] = CAN_ERR_PROT_FORM;
+    EXPECT_EQ(SocketCanDecodeError(prot).busErrorType, 4);
+}
+
+NATIVE_TEST("SocketCAN", "vcan0上两个socket互发经典帧和FD帧") {
+    if (!SocketCanInterfaceUp("vcan0")) {
+        std::printf("      vcan0不可用，跳过\n");
+        return;
+    }
+    SocketCanPort tx;
+    SocketCanPort rx;
+    EXPECT_TRUE(tx.Open("vcan0", true));
+    EXPECT_TRUE(rx.Open("vcan0", true));
+    EXPECT_TRUE(rx.SetFilters(SocketCanFilters({{false, 0x5A0, 0x5A1}})));
+
+    SocketCanFrame frames[3];
+    std::memset(frames, 0, sizeof(frames));
+    frames[0].id = 0x5A0;
+    frames[0].len = 8;
+    frames[1].id = 0x7FF;                  // 被滤波
+    frames[1].len = 1;
+    frames[2].id = 0x5A1;
+    frames[2].len = 64;
+    frames[2].flags = CANFD_BRS;
+    for (uint8_t i = 0; i < 64; i++) {
+        frames[0].data[i % 8] = i;
+        frames[2].data[i] = static_cast<uint8_t>(0xFF - i);
+    }
+    const bool fd[3] = {false, false, true};
+    EXPECT_EQ(tx.Send(frames, fd, 3, 100), 3u);
+
+    SocketCanRx received[4];
+    int count = 0;
+    EXPECT_TRUE(WaitUntil([&] {
+        const int n = rx.Receive(received + count, 4 - count);
+        count += n > 0 ? n : 0;
+        return count >= 2;
+    }, 500));
+    EXPECT_EQ(count, 2);
+    if (count == 2) {
+        EXPECT_EQ(received[0].frame.id, 0x5A0u);
+        EXPECT_TRUE(!received[0].fd && !received[0].own);
+        EXPECT_EQ(received[1].frame.id, 0x5A1u);
+        EXPECT_TRUE(received[1].fd);
+        EXPECT_EQ(received[1].frame.len, 64);
+        EXPECT_TRUE(std::memcmp(received[1].frame.data, frames[2].data, 64) == 0);
+    }
+}
@@ -0,0 +1,183 @@
+#include "native_test.h"
+
+#include "thread_scheduling.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * 线程调度测试
+ * 在独立线程中构造ThreadSchedulingScope，检查策略生效、运行中重新配置、析构后恢复原设置，
+ * 以及操作系统拒绝设置时的错误报告。使用Transmit角色，其余原生测试不启动该角色的线程
+ */
+
+namespace {
+
+// 在新线程中执行body，返回前join
+void RunOnThread(const std::function<void()>& body) {
+    std::thread(body).join();
+}
+
+// 恢复角色的默认策略，避免影响后续测试
+struct RolePolicyGuard {
+    ~RolePolicyGuard() { ThreadSchedulingConfigure(ThreadRole::Transmit, ThreadSchedulingPolicy()); }
+};
+
+#ifdef __linux__
+cpu_set_t CurrentAffinity() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+    return set;
+}
+
+int FirstCpu(const cpu_set_t& set) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &set)) {
+            return cpu;
+        }
+    }
+    return -1;
+}
+
+int LastCpu(const cpu_set_t& set) {
+    for (int cpu = CPU_SETSIZE - 1; cpu >= 0; cpu--) {
+        if (CPU_ISSET(cpu, &set)) {
+            return cpu;
+        }
+    }
+    return -1;
+}
+
+bool AffinityIs(const cpu_set_t& expected) {
+    cpu_set_t current = CurrentAffinity();
+    return CPU_EQUAL(&expected, &current) != 0;
+}
+
+bool OnlyCpu(const cpu_set_t& set, int cpu) {
+    return CPU_COUNT(&set) == 1 && CPU_ISSET(cpu, &set);
+}
+#endif
+
+}  // namespace
+
+#ifdef __linux__
+NATIVE_TEST("线程调度", "亲和性在构造时生效、运行中可重新配置、析构后恢复") {
+    RolePolicyGuard guard;
+    RunOnThread([] {
+        const cpu_set_t original = CurrentAffinity();
+        const int first = FirstCpu(original);
+        const int last = LastCpu(original);
+
+        ThreadSchedulingPolicy policy;
+        policy.cpus = {static_cast<UINT>(first)};
+        ThreadSchedulingConfigure(ThreadRole::Transmit, policy);
+        {
+            ThreadSchedulingScope scope(ThreadRole::Transmit);
+            EXPECT_TRUE(OnlyCpu(CurrentAffinity(), first));
+            ThreadSchedulingState state = ThreadSchedulingQuery(ThreadRole::Transmit);
+            EXPECT_EQ(state.threads, 1u);
+            EXPECT_TRUE(state.affinityApplied);
+            EXPECT_TRUE(state.error.empty());
+
+            // 运行中的线程立即应用新策略
+            policy.cpus = {static_cast<UINT>(last)};
+            ThreadSchedulingConfigure(ThreadRole::Transmit, policy);
+            EXPECT_TRUE(OnlyCpu(CurrentAffinity(), last));
+            EXPECT_TRUE(ThreadSchedulingQuery(ThreadRole::Transmit).affinityApplied);
+        }
+        EXPECT_TRUE(AffinityIs(original));
+        EXPECT_EQ(ThreadSchedulingQuery(ThreadRole::Transmit).threads, 0u);
+    });
+}
+
+NATIVE_TEST("线程调度", "实时优先级生效或按权限降级，析构后恢复调度策略和nice") {
+    RolePolicyGuard guard;
+    RunOnThread([] {
+        const pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+        int originalPolicy = -1;
+        sched_param originalParam;
+        pthread_getschedparam(pthread_self(), &originalPolicy, &originalParam);
+        const int originalNice = getpriority(PRIO_PROCESS, static_cast<id_t>(tid));
+
+        ThreadSchedulingPolicy policy;
+        policy.realtime = true;
+        policy.priority = 10;
+        ThreadSchedulingConfigure(ThreadRole::Transmit, policy);
+        {
+            ThreadSchedulingScope scope(ThreadRole::Transmit);
+            int current = -1;
+            sched_param param;
+            pthread_getschedparam(pthread_self(), &current, &param);
+            const ThreadSchedulingState state = ThreadSchedulingQuery(ThreadRole::Transmit);
+            if (state.realtimeApplied) {
+                EXPECT_EQ(current, SCHED_FIFO);
+                EXPECT_EQ(param.sched_priority, 10);
+                EXPECT_TRUE(state.error.empty());
+            } else {
+                // 无CAP_SYS_NICE：报告SCHED_FIFO失败原因和降级结果
+                EXPECT_EQ(current, originalPolicy);
+                EXPECT_TRUE(state.error.find("SCHED_FIFO") != std::string::npos);
+                EXPECT_TRUE(!state.fallback.empty());
+            }
+        }
+        int restored = -1;
+        sched_param param;
+        pthread_getschedparam(pthread_self(), &restored, &param);
+        EXPECT_EQ(restored, originalPolicy);
+        EXPECT_EQ(param.sched_priority, originalParam.sched_priority);
+        EXPECT_EQ(getpriority(PRIO_PROCESS, static_cast<id_t>(tid)), originalNice);
+    });
+}
+#endif
+
+NATIVE_TEST("线程调度", "操作系统拒绝亲和性设置时报告错误且线程设置不变") {
+    RolePolicyGuard guard;
+    RunOnThread([] {
+#ifdef __linux__
+        const cpu_set_t original = CurrentAffinity();
+        const UINT unavailable = CPU_SETSIZE - 1;
+#else
+        const UINT unavailable = 63;
+#endif
+        ThreadSchedulingPolicy policy;
+        policy.cpus = {unavailable};
+        ThreadSchedulingConfigure(ThreadRole::Transmit, policy);
+        {
+            ThreadSchedulingScope scope(ThreadRole::Transmit);
+            const ThreadSchedulingState state = ThreadSchedulingQuery(ThreadRole::Transmit);
+            EXPECT_EQ(state.threads, 1u);
+            EXPECT_TRUE(!state.affinityApplied);
+            EXPECT_TRUE(!state.error.empty());
+#ifdef __linux__
+            EXPECT_TRUE(AffinityIs(original));
+#endif
+        }
+#ifdef __linux__
+        EXPECT_TRUE(AffinityIs(original));
+#endif
+        // 重新配置清除上次的错误
+        ThreadSchedulingConfigure(ThreadRole::Transmit, ThreadSchedulingPolicy());
+        EXPECT_TRUE(ThreadSchedulingQuery(ThreadRole::Transmit).error.empty());
+    });
+}
+
+NATIVE_TEST("线程调度", "登记线程的定时唤醒计入延迟统计") {
+    ThreadSchedulingResetLatency();
+    RunOnThread([] {
+        // 未登记的线程不计入
+        ThreadSchedulingRecordWakeup(std::chrono::steady_clock::now());
+        ThreadSchedulingScope scope(ThreadRole::Transmit);
+        for (int i = 0; i < 5; i++) {
+            ThreadSchedulingRecordWakeup(std::chrono::steady_clock::now() - std::chrono::microseconds(200));
+        }
+    });
+    const ThreadSchedulingState state = ThreadSchedulingQuery(ThreadRole::Transmit);
+    EXPECT_EQ(state.wakeups, 5u);
+    EXPECT_TRUE(state.meanNs >= 200000 && state.maxNs >= 200000 && state.p50Ns >= 150000);
+}
@@ -0,0 +1,90 @@
+#include "native_test.h"
+#include "sim_fixture.h"
+
+#include "api_stats.h"
+#include "trace_buffer.h"
+
+/**
+ * 时间线记录测试
+ * 驱动调用经ApiStatsRecord写入时间线，TraceCollect按写入顺序读出并换算为steady_clock纳秒
+ */
+
+namespace {
+
+size_t CountNamed(const TraceSnapshot& snapshot, const char* name, char phase) {
+    size_t count = 0;
+    for (const TraceEventRecord& event : snapshot.events) {
+        if (std::strcmp(event.name, name) == 0 && event.phase == phase) {
+            count++;
+        }
+    }
+    return count;
+}
+
+int64_t SteadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+NATIVE_TEST("时间线记录", "驱动调用记录为持续事件并落在调用区间内") {
+    SimDeviceFixture sim(10);
+    EXPECT_TRUE(sim.Ready());
+
+    TraceSetThreadName("native-test");
+    TraceStart(0);
+    const int64_t before = SteadyNs();
+    ZCAN_Transmit_Data frames[2] = {SimCanFrame(0x100, 8, 0), SimCanFrame(0x101, 8, 8)};
+    EXPECT_EQ(ZcanTransmit(sim.channels[0], frames, 2), 2u);
+    EXPECT_EQ(ZcanTransmit(sim.channels[0], frames, 1), 1u);
+    // 未取到帧的接收是轮询常态，只计入统计不写入时间线
+    ZCAN_Receive_Data received[4];
+    ZcanReceive(sim.channels[0], received, 4, 0);
+    const int64_t after = SteadyNs();
+    TraceStop();
+    // 停止后不再记录
+    ZcanTransmit(sim.channels[0], frames, 1);
+
+    const TraceSnapshot snapshot = TraceCollect();
+    EXPECT_EQ(CountNamed(snapshot, "ZCAN_Transmit", 'X'), 2u);
+    EXPECT_EQ(CountNamed(snapshot, "ZCAN_Receive", 'X'), 0u);
+    EXPECT_EQ(snapshot.overwritten, 0u);
+    int64_t previous = before;
+    for (const TraceEventRecord& event : snapshot.events) {
+        if (std::strcmp(event.name, "ZCAN_Transmit") != 0) {
+            continue;
+        }
+        EXPECT_TRUE(std::strcmp(event.category, "zcan") == 0);
+        EXPECT_EQ(event.tid, snapshot.callerTid);
+        EXPECT_TRUE(event.durationNs >= 0);
+        // 滴答换算误差留1us余量
+        EXPECT_TRUE(event.startNs >= previous - 1000);
+        EXPECT_TRUE(event.startNs + event.durationNs <= after + 1000);
+        previous = event.startNs;
+    }
+
+    bool named = false;
+    for (const auto& thread : snapshot.threads) {
+        named = named || (thread.first == snapshot.callerTid && thread.second == "native-test");
+    }
+    EXPECT_TRUE(named);
+}
+
+NATIVE_TEST("时间线记录", "写满后覆盖最旧的事件并报告覆盖数") {
+    TraceStart(0);
+    const size_t capacity = 1024;
+    for (size_t i = 0; i < capacity + 10; i++) {
+        TraceInstant("tick", "test", ApiStatsNow(), i);
+    }
+    TraceStop();
+
+    const TraceSnapshot snapshot = TraceCollect();
+    EXPECT_EQ(snapshot.events.size(), capacity);
+    EXPECT_EQ(snapshot.overwritten, 10u);
+    if (!snapshot.events.empty()) {
+        EXPECT_EQ(snapshot.events.front().arg, 10u);
+        EXPECT_EQ(snapshot.events.back().arg, capacity + 9);
+        EXPECT_EQ(snapshot.events.front().phase, 'i');
+    }
+}
@@ -0,0 +1,465 @@
+/**
+ * XCP-on-CAN从站模拟器
+ * 在设备的一个CAN通道上实现XCP 1.x的CONNECT/状态查询、SHORT_UPLOAD/DOWNLOAD
+ * 和动态DAQ配置（FREE_DAQ/ALLOC_*/SET_DAQ_PTR/WRITE_DAQ/START_STOP_*），
+ * 按事件通道周期采样模拟变量并发送DTO，用于无ECU时测试XCP测量。
+ * 默认运行在虚拟设备上，也可挂在与主站通道物理相连的另一通道。
+ *
+ * 单独运行: npx ts-node test/xcp-slave-simulator.ts [设备类型] [设备索引] [通道]
+ */
+
+import { ZlgCanDevice, ChannelHandle, CanType, DeviceType, DeviceTypeValue } from '../src/zlgcan';
+
+// ============== XCP命令码 ==============
+
+const Cmd = {
+    CONNECT: 0xFF,
+    DISCONNECT: 0xFE,
+    GET_STATUS: 0xFD,
+    SYNCH: 0xFC,
+    SET_MTA: 0xF6,
+    SHORT_UPLOAD: 0xF4,
+    DOWNLOAD: 0xF0,
+    SET_DAQ_PTR: 0xE2,
+    WRITE_DAQ: 0xE1,
+    SET_DAQ_LIST_MODE: 0xE0,
+    START_STOP_DAQ_LIST: 0xDE,
+    START_STOP_SYNCH: 0xDD,
+    GET_DAQ_PROCESSOR_INFO: 0xDA,
+    GET_DAQ_RESOLUTION_INFO: 0xD9,
+    FREE_DAQ: 0xD6,
+    ALLOC_DAQ: 0xD5,
+    ALLOC_ODT: 0xD4,
+    ALLOC_ODT_ENTRY: 0xD3,
+} as const;
+
+const Err = {
+    CMD_SYNCH: 0x00,
+    DAQ_ACTIVE: 0x11,
+    CMD_UNKNOWN: 0x20,
+    CMD_SYNTAX: 0x21,
+    OUT_OF_RANGE: 0x22,
+    SEQUENCE: 0x29,
+    MEMORY_OVERFLOW: 0x30,
+} as const;
+
+/** 模拟变量地址，每次事件通道0触发时更新 */
+export const XcpSimulatedVariables = {
+    /** uint32 采样计数 */
+    COUNTER: 0x1000,
+    /** float32 sin(COUNTER * 0.01) */
+    SINE: 0x1004,
+    /** int16 COUNTER * 7（回绕） */
+    RAMP: 0x1008,
+    /** uint8 COUNTER低字节 */
+    TOGGLE: 0x100C,
+    /** float64 COUNTER * 0.5 */
+    DOUBLE: 0x1010,
+} as const;
+
+/** 模拟器配置 */
+export interface XcpSlaveSimulatorOptions {
+    /** 主站命令CAN ID，默认0x700 */
+    masterId?: number;
+    /** 从站响应/DTO CAN ID，默认0x701 */
+    slaveId?: number;
+    /** 字节序，默认intel */
+    byteOrder?: 'intel' | 'motorola';
+    /** 最大DTO长度，8为经典CAN，大于8时以CANFD发送，默认8 */
+    maxDto?: number;
+    /** 事件通道周期（毫秒），默认[10, 100] */
+    eventPeriodsMs?: number[];
+    /** 模拟内存大小，默认0x10000 */
+    memorySize?: number;
+    /** 命令轮询间隔（毫秒），默认1 */
+    pollIntervalMs?: number;
+}
+
+/** 模拟器统计 */
+export interface XcpSlaveSimulatorStats {
+    commands: number;
+    errors: number;
+    /** 发送的DTO数 */
+    dtos: number;
+    /** 各事件通道的触发次数 */
+    events: number[];
+}
+
+interface OdtEntry {
+    address: number;
+    extension: number;
+    size: number;
+}
+
+interface DaqList {
+    odts: OdtEntry[][];
+    mode: number;
+    eventChannel: number;
+    prescaler: number;
+    prescalerCount: number;
+    firstPid: number;
+    selected: boolean;
+    running: boolean;
+}
+
+const MAX_CTO = 8;
+const MAX_ODT_ENTRY_SIZE = 8;
+const TIMESTAMP_SIZE = 4;
+const DAQ_MODE_TIMESTAMP = 0x10;
+
+export class XcpSlaveSimulator {
+    private options: Required<XcpSlaveSimulatorOptions>;
+    private memory: Buffer;
+    private connected = false;
+    private mta = 0;
+    private daqLists: DaqList[] = [];
+    private daqPtr: { list: number; odt: number; entry: number } | null = null;
+    private nextPid = 0;
+    private counter = 0;
+    private startedAt = process.hrtime.bigint();
+    private pollTimer: NodeJS.Timeout | null = null;
+    private eventTimers: NodeJS.Timeout[] = [];
+
+    readonly stats: XcpSlaveSimulatorStats;
+
+    constructor(private device: ZlgCanDevice, private channelHandle: ChannelHandle, options: XcpSlaveSimulatorOptions = {}) {
+        this.options = {
+            masterId: options.masterId ?? 0x700,
+            slaveId: options.slaveId ?? 0x701,
+            byteOrder: options.byteOrder ?? 'intel',
+            maxDto: options.maxDto ?? 8,
+            eventPeriodsMs: options.eventPeriodsMs ?? [10, 100],
+            memorySize: options.memorySize ?? 0x10000,
+            pollIntervalMs: options.pollIntervalMs ?? 1,
+        };
+        this.memory = Buffer.alloc(this.options.memorySize);
+        this.stats = { commands: 0, errors: 0, dtos: 0, events: this.options.eventPeriodsMs.map(() => 0) };
+        this.updateVariables();
+    }
+
+    /** 开始处理命令并运行事件通道 */
+    start(): void {
+        if (this.pollTimer) {
+            return;
+        }
+        this.startedAt = process.hrtime.bigint();
+        this.pollTimer = setInterval(() => this.poll(), this.options.pollIntervalMs);
+        this.eventTimers = this.options.eventPeriodsMs.map((period, channel) =>
+            setInterval(() => this.onEvent(channel), period));
+    }
+
+    stop(): void {
+        if (this.pollTimer) {
+            clearInterval(this.pollTimer);
+            this.pollTimer = null;
+        }
+        this.eventTimers.forEach(timer => clearInterval(timer));
+        this.eventTimers = [];
+        this.daqLists.forEach(list => { list.running = false; });
+    }
+
+    /** 读取模拟内存，供测试核对DOWNLOAD */
+    readMemory(address: number, length: number): number[] {
+        return Array.from(this.memory.subarray(address, address + length));
+    }
+
+    // ============== 命令处理 ==============
+
+    private poll(): void {
+        const frames = this.options.maxDto > 8
+            ? this.device.receiveFD(this.channelHandle, 64, 0)
+            : this.device.receive(this.channelHandle, 64, 0);
+        for (const frame of frames) {
+            if ((frame.id & 0x9FFFFFFF) !== this.options.masterId || frame.data.length === 0) {
+                continue;
+            }
+            const response = this.handle(Buffer.from(frame.data));
+            if (response) {
+                this.send([response]);
+            }
+        }
+    }
+
+    private handle(request: Buffer): Buffer | null {
+        const cmd = request[0];
+        // 未连接时只响应CONNECT
+        if (!this.connected && cmd !== Cmd.CONNECT) {
+            return null;
+        }
+        this.stats.commands++;
+
+        const ok = (...bytes: number[]) => Buffer.from([0xFF, ...bytes]);
+        const error = (code: number) => {
+            this.stats.errors++;
+            return Buffer.from([0xFE, code]);
+        };
+
+        switch (cmd) {
+            case Cmd.CONNECT: {
+                this.connected = true;
+                const resource = 0x04;  // DAQ
+                const commModeBasic = this.bigEndian ? 0x01 : 0x00;
+                return Buffer.concat([ok(resource, commModeBasic, MAX_CTO), this.word(this.options.maxDto), Buffer.from([0x01, 0x01])]);
+            }
+            case Cmd.DISCONNECT:
+                this.connected = false;
+                this.daqLists.forEach(list => { list.running = false; });
+                return ok();
+            case Cmd.GET_STATUS: {
+                const running = this.daqLists.some(list => list.running) ? 0x40 : 0x00;
+                return Buffer.concat([ok(running, 0x00, 0x00), this.word(0)]);
+            }
+            case Cmd.SYNCH:
+                return error(Err.CMD_SYNCH);
+            case Cmd.SET_MTA:
+                this.mta = this.dword(request, 4);
+                return ok();
+            case Cmd.SHORT_UPLOAD: {
+                const length = request[1];
+                const address = this.dword(request, 4);
+                if (length > MAX_CTO - 1 || address + length > this.memory.length) {
+                    return error(Err.OUT_OF_RANGE);
+                }
+                return Buffer.concat([ok(), this.memory.subarray(address, address + length)]);
+            }
+            case Cmd.DOWNLOAD: {
+                const length = request[1];
+                if (length > MAX_CTO - 2 || this.mta + length > this.memory.length) {
+                    return error(Err.OUT_OF_RANGE);
+                }
+                request.copy(this.memory, this.mta, 2, 2 + length);
+                this.mta += length;
+                return ok();
+            }
+            case Cmd.GET_DAQ_PROCESSOR_INFO:
+                // 动态DAQ、支持时间戳、识别字段为绝对ODT号
+                return Buffer.concat([ok(0x11), this.word(0), this.word(this.options.eventPeriodsMs.length), Buffer.from([0x00, 0x00])]);
+            case Cmd.GET_DAQ_RESOLUTION_INFO:
+                // 4字节时间戳，单位1us
+                return Buffer.concat([ok(0x01, MAX_ODT_ENTRY_SIZE, 0x01, MAX_ODT_ENTRY_SIZE, 0x30 | TIMESTAMP_SIZE), this.word(1)]);
+            case Cmd.FREE_DAQ:
+                this.daqLists = [];
+                this.daqPtr = null;
+                this.nextPid = 0;
+                return ok();
+            case Cmd.ALLOC_DAQ: {
+                if (this.daqLists.length > 0) {
+                    return error(Err.SEQUENCE);
+                }
+                const count = this.word16(request, 2);
+                for (let i = 0; i < count; i++) {
+                    this.daqLists.push({
+                        odts: [], mode: 0, eventChannel: 0, prescaler: 1, prescalerCount: 0,
+                        firstPid: 0, selected: false, running: false,
+                    });
+                }
+                return ok();
+            }
+            case Cmd.ALLOC_ODT: {
+                const list = this.daqLists[this.word16(request, 2)];
+                if (!list) {
+                    return error(Err.OUT_OF_RANGE);
+                }
+                // 绝对ODT号按分配顺序连续编号
+                list.odts = Array.from({ length: request[4] }, () => []);
+                list.firstPid = this.nextPid;
+                this.nextPid += list.odts.length;
+                return ok();
+            }
+            case Cmd.ALLOC_ODT_ENTRY: {
+                const odt = this.daqLists[this.word16(request, 2)]?.odts[request[4]];
+                if (!odt) {
+                    return error(Err.OUT_OF_RANGE);
+                }
+                for (let i = 0; i < request[5]; i++) {
+                    odt.push({ address: 0, extension: 0, size: 0 });
+                }
+                return ok();
+            }
+            case Cmd.SET_DAQ_PTR: {
+                const list = this.word16(request, 2);
+                if (!this.daqLists[list]?.odts[request[4]]) {
+                    return error(Err.OUT_OF_RANGE);
+                }
+                this.daqPtr = { list, odt: request[4], entry: request[5] };
+                return ok();
+            }
+            case Cmd.WRITE_DAQ: {
+                const ptr = this.daqPtr;
+                const entry = ptr ? this.daqLists[ptr.list].odts[ptr.odt][ptr.entry] : undefined;
+                if (!ptr || !entry) {
+                    return error(Err.OUT_OF_RANGE);
+                }
+                if (request[2] > MAX_ODT_ENTRY_SIZE) {
+                    return error(Err.OUT_OF_RANGE);
+                }
+                entry.size = request[2];
+                entry.extension = request[3];
+                entry.address = this.dword(request, 4);
+                ptr.entry++;
+                return ok();
+            }
+            case Cmd.SET_DAQ_LIST_MODE: {
+                const list = this.daqLists[this.word16(request, 2)];
+                if (!list) {
+                    return error(Err.OUT_OF_RANGE);
+                }
+                if (list.running) {
+                    return error(Err.DAQ_ACTIVE);
+                }
+                list.mode = request[1];
+                list.eventChannel = this.word16(request, 4);
+                list.prescaler = Math.max(request[6], 1);
+                return ok();
+            }
+            case Cmd.START_STOP_DAQ_LIST: {
+                const list = this.daqLists[this.word16(request, 2)];
+                if (!list) {
+                    return error(Err.OUT_OF_RANGE);
+                }
+                if (list.odts.length === 0) {
+                    return error(Err.SEQUENCE);
+                }
+                if (request[1] === 0) list.running = false;
+                if (request[1] === 1) list.running = true;
+                if (request[1] === 2) list.selected = true;
+                return ok(list.firstPid);
+            }
+            case Cmd.START_STOP_SYNCH: {
+                const mode = request[1];
+                for (const list of this.daqLists) {
+                    if (mode === 0) {
+                        list.running = false;
+                    } else if (list.selected) {
+                        list.running = mode === 1;
+                        list.selected = false;
+                    }
+                }
+                return ok();
+            }
+            default:
+                return error(Err.CMD_UNKNOWN);
+        }
+    }
+
+    // ============== DAQ ==============
+
+    private onEvent(channel: number): void {
+        this.stats.events[channel]++;
+        if (channel === 0) {
+            this.counter = (this.counter + 1) >>> 0;
+            this.updateVariables();
+        }
+
+        const timestamp = Number((process.hrtime.bigint() - this.startedAt) / 1000n) >>> 0;
+        const frames: Buffer[] = [];
+        for (const list of this.daqLists) {
+            if (!list.running || list.eventChannel !== channel) {
+                continue;
+            }
+            list.prescalerCount = (list.prescalerCount + 1) % list.prescaler;
+            if (list.prescalerCount !== 0) {
+                continue;
+            }
+            list.odts.forEach((odt, index) => {
+                const parts: Buffer[] = [Buffer.from([list.firstPid + index])];
+                if (index === 0 && (list.mode & DAQ_MODE_TIMESTAMP)) {
+                    parts.push(this.dwordBuffer(timestamp));
+                }
+                for (const entry of odt) {
+                    parts.push(this.memory.subarray(entry.address, entry.address + entry.size));
+                }
+                frames.push(Buffer.concat(parts));
+            });
+        }
+        if (frames.length > 0) {
+            this.stats.dtos += frames.length;
+            this.send(frames);
+        }
+    }
+
+    private updateVariables(): void {
+        const n = this.counter;
+        const write = (address: number, size: number, fill: (buf: Buffer) => void) => {
+            const buf = Buffer.alloc(size);
+            fill(buf);
+            if (this.bigEndian) {
+                buf.reverse();
+            }
+            buf.copy(this.memory, address);
+        };
+        write(XcpSimulatedVariables.COUNTER, 4, buf => buf.writeUInt32LE(n));
+        write(XcpSimulatedVariables.SINE, 4, buf => buf.writeFloatLE(Math.sin(n * 0.01)));
+        write(XcpSimulatedVariables.RAMP, 2, buf => buf.writeInt16LE(((n * 7) << 16) >> 16));
+        write(XcpSimulatedVariables.TOGGLE, 1, buf => buf.writeUInt8(n & 0xFF));
+        write(XcpSimulatedVariables.DOUBLE, 8, buf => buf.writeDoubleLE(n * 0.5));
+    }
+
+    // ============== 编码 ==============
+
+    private get bigEndian(): boolean {
+        return this.options.byteOrder === 'motorola';
+    }
+
+    private word(value: number): Buffer {
+        const buf = Buffer.alloc(2);
+        this.bigEndian ? buf.writeUInt16BE(value) : buf.writeUInt16LE(value);
+        return buf;
+    }
+
+    private word16(buf: Buffer, offset: number): number {
+        return this.bigEndian ? buf.readUInt16BE(offset) : buf.readUInt16LE(offset);
+    }
+
+    private dword(buf: Buffer, offset: number): number {
+        return this.bigEndian ? buf.readUInt32BE(offset) : buf.readUInt32LE(offset);
+    }
+
+    private dwordBuffer(value: number): Buffer {
+        const buf = Buffer.alloc(4);
+        this.bigEndian ? buf.writeUInt32BE(value) : buf.writeUInt32LE(value);
+        return buf;
+    }
+
+    private send(payloads: Buffer[]): void {
+        if (this.options.maxDto > 8) {
+            this.device.transmitFD(this.channelHandle, payloads.map(p => ({ id: this.options.slaveId, len: p.length, data: Array.from(p) })));
+        } else {
+            this.device.transmit(this.channelHandle, payloads.map(p => ({ id: this.options.slaveId, dlc: p.length, data: Array.from(p) })));
+        }
+    }
+}
+
+if (require.main === module) {
+    const deviceType = Number(process.argv[2] ?? DeviceType.ZCAN_VIRTUAL_DEVICE) as DeviceTypeValue;
+    const deviceIndex = Number(process.argv[3] ?? 0);
+    const channelIndex = Number(process.argv[4] ?? 0);
+
+    const device = new ZlgCanDevice();
+    if (!device.openDevice(deviceType, deviceIndex, 0)) {
+        console.error('设备打开失败');
+        process.exit(1);
+    }
+    const channel = device.initCanChannel(channelIndex, {
+        canType: CanType.TYPE_CANFD,
+        accCode: 0,
+        accMask: 0xFFFFFFFF,
+        abitTiming: 0x00016D01,
+        dbitTiming: 0x00016D01,
+        brp: 0,
+        filter: 0,
+        mode: 0,
+    });
+    device.startCanChannel(channel);
+
+    const simulator = new XcpSlaveSimulator(device, channel);
+    simulator.start();
+    console.log(`XCP从站模拟器已启动: 设备类型${deviceType}, 通道${channelIndex}, CRO 0x700, DTO 0x701`);
+    setInterval(() => console.log(JSON.stringify(simulator.stats)), 5000).unref();
+
+    process.on('SIGINT', () => {
+        simulator.stop();
+        device.closeDevice();
+        process.exit(0);
+    });
+}
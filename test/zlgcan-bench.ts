@@ -0,0 +1,579 @@
+/**
+ * ZLG CAN 原生接口封送基准测试
+ * 后端: 仿真后端zlgcan_sim.node（ZLGCAN_BACKEND=sim，非实时模式，不受帧时长限制）
+ * 连接拓扑: 通道0 -> 通道1（同一仿真总线）
+ * 测量内容: ZlgCanDevice收发与查询接口在不同批量下的ns/帧、JS堆分配字节/帧和GC压力
+ *
+ * 运行: npm run bench:zlgcan -- [选项]
+ *   --batch 1,10,100,1000   批量大小
+ *   --filter <正则>          只运行名称匹配的用例
+ *   --frames <n>            每个用例每个批量的目标帧数，默认20000
+ *   --json <文件|->          输出JSON结果（-为标准输出）
+ *   --baseline <文件>        与之前的JSON结果比较，ns/帧或分配字节/帧超出阈值时以退出码1结束
+ *   --threshold <比例>       回归阈值，默认0.15
+ *
+ * 同一group的用例互为对照（如receive/receiveFD/receiveData），报告中给出相对于组内第一个用例的倍率；
+ * 新增的二进制或零拷贝接口在对应group中注册用例即可与现有接口比较。
+ * 分配字节由v8堆用量差得到，需以--expose-gc运行以便每个用例开始前整理堆。
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as v8 from 'v8';
+import { PerformanceObserver } from 'perf_hooks';
+import type {
+    ZlgCanDevice as ZlgCanDeviceType,
+    CanTypeValue,
+    CanFrame,
+    CanFDFrame,
+    CanChannelConfig,
+    DataObj,
+    ChannelHandle,
+} from '../src/zlgcan';
+
+// 默认使用仿真后端；模块加载时即按ZLGCAN_BACKEND选择原生模块，须在require之前设置
+process.env.ZLGCAN_BACKEND = process.env.ZLGCAN_BACKEND || 'sim';
+// eslint-disable-next-line @typescript-eslint/no-require-imports
+const { ZlgCanDevice, DeviceType, CanType, DataType } = require('../src/zlgcan') as typeof import('../src/zlgcan');
+
+// ==================== 配置 ====================
+
+interface BenchOptions {
+    batches: number[];
+    filter: RegExp | null;
+    framesPerCase: number;
+    json: string | null;
+    baseline: string | null;
+    threshold: number;
+}
+
+function parseArgs(argv: string[]): BenchOptions {
+    const options: BenchOptions = {
+        batches: [1, 10, 100, 1000],
+        filter: null,
+        framesPerCase: 20000,
+        json: null,
+        baseline: null,
+        threshold: 0.15,
+    };
+    for (let i = 0; i < argv.length; i++) {
+        const value = argv[i + 1];
+        switch (argv[i]) {
+            case '--batch':
+                options.batches = value.split(',').map(Number).filter(n => n > 0);
+                i++;
+                break;
+            case '--filter':
+                options.filter = new RegExp(value);
+                i++;
+                break;
+            case '--frames':
+                options.framesPerCase = Math.max(1, Number(value));
+                i++;
+                break;
+            case '--json':
+                options.json = value;
+                i++;
+                break;
+            case '--baseline':
+                options.baseline = value;
+                i++;
+                break;
+            case '--threshold':
+                options.threshold = Number(value);
+                i++;
+                break;
+            default:
+                throw new Error(`未知参数: ${argv[i]}`);
+        }
+    }
+    return options;
+}
+
+const CHANNEL_CONFIG: CanChannelConfig = {
+    canType: CanType.TYPE_CANFD,
+    accCode: 0,
+    accMask: 0xFFFFFFFF,
+    abitTiming: 0x00016D01,
+    dbitTiming: 0x00016D01,
+    brp: 0,
+    filter: 0,
+    mode: 0,
+    pad: 0,
+    reserved: 0,
+};
+
+// 单个用例最多等待仿真总线投递的时间
+const DELIVERY_TIMEOUT_MS = 2000;
+
+// ==================== 用例定义 ====================
+
+interface BenchContext {
+    device: ZlgCanDeviceType;
+    tx: ChannelHandle;
+    rx: ChannelHandle;
+}
+
+/**
+ * 基准用例
+ * prepare在计时之外执行（如向接收通道灌入batch帧），run为被测调用，返回处理的帧数
+ */
+interface BenchCase {
+    name: string;
+    group: string;
+    /** 与批量无关的查询接口只以批量1运行 */
+    perCall?: boolean;
+    /** 需要合并接收模式 */
+    merged?: boolean;
+    setup?(ctx: BenchContext): void;
+    teardown?(ctx: BenchContext): void;
+    prepare?(ctx: BenchContext, batch: number): void;
+    run(ctx: BenchContext, batch: number): number;
+}
+
+function makeCanFrames(batch: number): CanFrame[] {
+    const frames: CanFrame[] = [];
+    for (let i = 0; i < batch; i++) {
+        frames.push({ id: 0x100 + (i & 0xFF), dlc: 8, data: [i & 0xFF, 1, 2, 3, 4, 5, 6, 7] });
+    }
+    return frames;
+}
+
+function makeFdFrames(batch: number, len: number): CanFDFrame[] {
+    const frames: CanFDFrame[] = [];
+    for (let i = 0; i < batch; i++) {
+        const data = new Array<number>(len);
+        for (let j = 0; j < len; j++) {
+            data[j] = (i + j) & 0xFF;
+        }
+        frames.push({ id: 0x200 + (i & 0xFF), len, data, flags: 0x01 });
+    }
+    return frames;
+}
+
+function makeDataObjs(batch: number, len: number): DataObj[] {
+    return makeFdFrames(batch, len).map(frame => ({
+        dataType: DataType.ZCAN_DT_ZCAN_CAN_CANFD_DATA,
+        chnl: 0,
+        canfdData: { timestamp: 0, flag: 1, id: frame.id, len: frame.len, flags: frame.flags, data: frame.data },
+    }));
+}
+
+/** 单次调用计为1帧 */
+function once(call: () => unknown): number {
+    call();
+    return 1;
+}
+
+function sleepMs(ms: number): void {
+    Atomics.wait(new Int32Array(new SharedArrayBuffer(4)), 0, 0, ms);
+}
+
+/** 轮询直到depth()达到count，超时抛出 */
+function waitDepth(depth: () => number, count: number, what: string): void {
+    const deadline = Date.now() + DELIVERY_TIMEOUT_MS;
+    while (depth() < count) {
+        if (Date.now() > deadline) {
+            throw new Error(`${what}: 等待${count}帧超时（当前${depth()}）`);
+        }
+        sleepMs(0.05);
+    }
+}
+
+/** 发送batch帧并等待接收通道缓冲达到batch（计时之外） */
+function fill(ctx: BenchContext, batch: number, fd: boolean, depth: () => number): void {
+    let sent = 0;
+    while (sent < batch) {
+        const chunk = Math.min(batch - sent, 1000);
+        const n = fd ? ctx.device.transmitFD(ctx.tx, makeFdFrames(chunk, 8)) : ctx.device.transmit(ctx.tx, makeCanFrames(chunk));
+        if (n === 0) {
+            sleepMs(1);
+        }
+        sent += n;
+    }
+    waitDepth(depth, batch, fd ? 'CANFD' : 'CAN');
+}
+
+function rxNum(ctx: BenchContext, type: CanTypeValue): () => number {
+    return () => ctx.device.getReceiveNum(ctx.rx, type);
+}
+
+function ringDepth(ctx: BenchContext, fd: boolean): () => number {
+    return () => {
+        const stats = ctx.device.getReceiveThreadStats(ctx.rx);
+        return stats ? (fd ? stats.fdRingDepth : stats.canRingDepth) : 0;
+    };
+}
+
+/** 发送类用例在每个批量前按批量构造帧，计时只包含接口调用 */
+function transmitCase(name: string, group: string, build: (batch: number) => unknown,
+    send: (ctx: BenchContext, frames: unknown) => number, merged = false): BenchCase {
+    let frames: unknown = null;
+    let built = -1;
+    return {
+        name,
+        group,
+        merged,
+        prepare(ctx, batch) {
+            if (built !== batch) {
+                frames = build(batch);
+                built = batch;
+            }
+            // 不让接收端溢出
+            if (ctx.device.getReceiveNum(ctx.rx, CanType.TYPE_ALL_DATA) > 100000) {
+                ctx.device.clearBuffer(ctx.rx);
+            }
+        },
+        run(ctx) {
+            return send(ctx, frames);
+        },
+    };
+}
+
+const CASES: BenchCase[] = [
+    // ---------- 发送 ----------
+    transmitCase('transmit', 'transmit', makeCanFrames, (ctx, f) => ctx.device.transmit(ctx.tx, f as CanFrame[])),
+    transmitCase('transmitFD/8', 'transmit', b => makeFdFrames(b, 8), (ctx, f) => ctx.device.transmitFD(ctx.tx, f as CanFDFrame[])),
+    transmitCase('transmitFD/64', 'transmit-fd64', b => makeFdFrames(b, 64), (ctx, f) => ctx.device.transmitFD(ctx.tx, f as CanFDFrame[])),
+    transmitCase('transmitData/8', 'transmit', b => makeDataObjs(b, 8), (ctx, f) => ctx.device.transmitData(f as DataObj[]), true),
+    transmitCase('transmitData/64', 'transmit-fd64', b => makeDataObjs(b, 64), (ctx, f) => ctx.device.transmitData(f as DataObj[]), true),
+
+    // ---------- 接收 ----------
+    {
+        name: 'receive',
+        group: 'receive',
+        prepare: (ctx, batch) => fill(ctx, batch, false, rxNum(ctx, CanType.TYPE_CAN)),
+        run: (ctx, batch) => ctx.device.receive(ctx.rx, batch, 0).length,
+    },
+    {
+        name: 'receiveFD',
+        group: 'receive',
+        prepare: (ctx, batch) => fill(ctx, batch, true, rxNum(ctx, CanType.TYPE_CANFD)),
+        run: (ctx, batch) => ctx.device.receiveFD(ctx.rx, batch, 0).length,
+    },
+    {
+        name: 'receiveData',
+        group: 'receive',
+        merged: true,
+        prepare: (ctx, batch) => fill(ctx, batch, true, rxNum(ctx, CanType.TYPE_ALL_DATA)),
+        run: (ctx, batch) => ctx.device.receiveData(batch, 0).length,
+    },
+    {
+        name: 'receive/thread',
+        group: 'receive',
+        setup: ctx => { ctx.device.startReceiveThread(ctx.rx, { idleSleepUs: 50 }); },
+        teardown: ctx => { ctx.device.stopReceiveThread(ctx.rx); },
+        prepare: (ctx, batch) => fill(ctx, batch, false, ringDepth(ctx, false)),
+        run: (ctx, batch) => ctx.device.receive(ctx.rx, batch, 0).length,
+    },
+    {
+        name: 'receiveFD/thread',
+        group: 'receive',
+        setup: ctx => { ctx.device.startReceiveThread(ctx.rx, { idleSleepUs: 50 }); },
+        teardown: ctx => { ctx.device.stopReceiveThread(ctx.rx); },
+        prepare: (ctx, batch) => fill(ctx, batch, true, ringDepth(ctx, true)),
+        run: (ctx, batch) => ctx.device.receiveFD(ctx.rx, batch, 0).length,
+    },
+
+    // ---------- 查询（与批量无关） ----------
+    { name: 'getReceiveNum', group: 'query', perCall: true, run: ctx => once(() => ctx.device.getReceiveNum(ctx.rx, CanType.TYPE_CAN)) },
+    { name: 'readChannelErrInfo', group: 'query', perCall: true, run: ctx => once(() => ctx.device.readChannelErrInfo(ctx.rx)) },
+    { name: 'readChannelStatus', group: 'query', perCall: true, run: ctx => once(() => ctx.device.readChannelStatus(ctx.rx)) },
+    { name: 'getDeviceInfo', group: 'query', perCall: true, run: ctx => once(() => ctx.device.getDeviceInfo()) },
+    { name: 'getDeviceInfoEx', group: 'query', perCall: true, run: ctx => once(() => ctx.device.getDeviceInfoEx()) },
+    { name: 'isDeviceOnLine', group: 'query', perCall: true, run: ctx => once(() => ctx.device.isDeviceOnLine()) },
+    { name: 'setValue', group: 'property', perCall: true, run: ctx => once(() => ctx.device.setValue('0/bench_key', '1')) },
+    { name: 'getValue', group: 'property', perCall: true, run: ctx => once(() => ctx.device.getValue('0/bench_key')) },
+    {
+        name: 'getPropertyValue',
+        group: 'property',
+        perCall: true,
+        setup: ctx => { ctx.device.getIProperty(); },
+        teardown: ctx => { ctx.device.releaseIProperty(); },
+        run: ctx => once(() => ctx.device.getPropertyValue('0/bench_key')),
+    },
+    {
+        name: 'getReceiveThreadStats',
+        group: 'query',
+        perCall: true,
+        setup: ctx => { ctx.device.startReceiveThread(ctx.rx); },
+        teardown: ctx => { ctx.device.stopReceiveThread(ctx.rx); },
+        run: ctx => once(() => ctx.device.getReceiveThreadStats(ctx.rx)),
+    },
+];
+
+// ==================== 测量 ====================
+
+interface BenchResult {
+    name: string;
+    group: string;
+    batch: number;
+    calls: number;
+    frames: number;
+    nsPerFrame: number;
+    nsPerCall: number;
+    /** 每帧JS堆分配字节（发生GC的调用不计入） */
+    heapBytesPerFrame: number;
+    /** 计时阶段的GC次数与耗时 */
+    gcCount: number;
+    gcMs: number;
+    /** GC耗时占计时阶段墙钟时间的比例 */
+    gcRatio: number;
+    /** 相对于组内第一个用例同批量结果的ns/帧倍率 */
+    relative?: number;
+}
+
+const gcHook = (globalThis as unknown as { gc?: () => void }).gc;
+
+function collect(): void {
+    if (gcHook) {
+        gcHook();
+    }
+}
+
+function heapUsed(): number {
+    return v8.getHeapStatistics().used_heap_size;
+}
+
+async function drainMicrotasks(): Promise<void> {
+    await new Promise(resolve => setImmediate(resolve));
+}
+
+async function measure(ctx: BenchContext, bench: BenchCase, batch: number, framesPerCase: number): Promise<BenchResult> {
+    const calls = Math.max(20, Math.ceil(framesPerCase / batch));
+
+    // 预热
+    for (let i = 0; i < Math.min(calls, 50); i++) {
+        bench.prepare?.(ctx, batch);
+        bench.run(ctx, batch);
+    }
+
+    // 计时阶段：只累计run本身的耗时，同时统计GC
+    let gcCount = 0;
+    let gcMs = 0;
+    const observer = new PerformanceObserver(list => {
+        for (const entry of list.getEntries()) {
+            gcCount++;
+            gcMs += entry.duration;
+        }
+    });
+    collect();
+    observer.observe({ entryTypes: ['gc'] });
+    let elapsed = 0n;
+    let frames = 0;
+    const wallStart = process.hrtime.bigint();
+    for (let i = 0; i < calls; i++) {
+        bench.prepare?.(ctx, batch);
+        const start = process.hrtime.bigint();
+        frames += bench.run(ctx, batch);
+        elapsed += process.hrtime.bigint() - start;
+    }
+    const wallNs = Number(process.hrtime.bigint() - wallStart);
+    await drainMicrotasks();
+    observer.disconnect();
+
+    // 分配阶段：逐次测量堆用量差，堆用量下降说明期间发生了GC，该次不计入
+    collect();
+    let allocated = 0;
+    let allocatedFrames = 0;
+    const allocCalls = Math.min(calls, 200);
+    for (let i = 0; i < allocCalls; i++) {
+        bench.prepare?.(ctx, batch);
+        const before = heapUsed();
+        const n = bench.run(ctx, batch);
+        const delta = heapUsed() - before;
+        if (delta >= 0) {
+            allocated += delta;
+            allocatedFrames += n;
+        }
+    }
+
+    const totalNs = Number(elapsed);
+    return {
+        name: bench.name,
+        group: bench.group,
+        batch,
+        calls,
+        frames,
+        nsPerFrame: frames > 0 ? totalNs / frames : NaN,
+        nsPerCall: totalNs / calls,
+        heapBytesPerFrame: allocatedFrames > 0 ? allocated / allocatedFrames : NaN,
+        gcCount,
+        gcMs,
+        gcRatio: wallNs > 0 ? gcMs * 1e6 / wallNs : 0,
+    };
+}
+
+// ==================== 设备 ====================
+
+function openBench(): BenchContext {
+    const device = new ZlgCanDevice();
+    if (!device.openDevice(DeviceType.ZCAN_USBCANFD_200U, 0, 0)) {
+        throw new Error('打开仿真设备失败（需先npm run build:native:sim）');
+    }
+    device.setValue('sim/realtime', '0');
+    for (const channel of [0, 1]) {
+        device.setValue(`${channel}/sim_rx_capacity`, '1000000');
+        device.setValue(`${channel}/sim_tx_capacity`, '1000000');
+    }
+    const tx = device.initCanChannel(0, CHANNEL_CONFIG);
+    const rx = device.initCanChannel(1, CHANNEL_CONFIG);
+    if (!device.startCanChannel(tx) || !device.startCanChannel(rx)) {
+        throw new Error('启动通道失败');
+    }
+    return { device, tx, rx };
+}
+
+function setMerged(ctx: BenchContext, merged: boolean): void {
+    ctx.device.setValue('0/set_device_recv_merge', merged ? '1' : '0');
+    ctx.device.clearBuffer(ctx.rx);
+    ctx.device.receiveData(100000, 0);
+}
+
+// ==================== 报告 ====================
+
+function fixed(value: number, digits: number): string {
+    return Number.isFinite(value) ? value.toFixed(digits) : '-';
+}
+
+function printTable(results: BenchResult[]): void {
+    console.log(
+        '用例'.padEnd(24) + '批量'.padStart(6) + 'ns/帧'.padStart(12) + 'ns/次'.padStart(12) +
+        '堆字节/帧'.padStart(12) + 'GC次数'.padStart(8) + 'GC%'.padStart(8) + '组内倍率'.padStart(10));
+    for (const r of results) {
+        console.log(
+            r.name.padEnd(24) + String(r.batch).padStart(8) + fixed(r.nsPerFrame, 1).padStart(13) +
+            fixed(r.nsPerCall, 1).padStart(13) + fixed(r.heapBytesPerFrame, 1).padStart(14) +
+            String(r.gcCount).padStart(10) + fixed(r.gcRatio * 100, 2).padStart(9) +
+            (r.relative === undefined ? '' : `x${r.relative.toFixed(2)}`).padStart(12));
+    }
+}
+
+function annotateRelative(results: BenchResult[]): void {
+    const reference = new Map<string, BenchResult>();
+    for (const r of results) {
+        const key = `${r.group}@${r.batch}`;
+        const ref = reference.get(key);
+        if (!ref) {
+            reference.set(key, r);
+        } else if (ref.nsPerFrame > 0) {
+            r.relative = r.nsPerFrame / ref.nsPerFrame;
+        }
+    }
+}
+
+interface Regression {
+    name: string;
+    batch: number;
+    metric: string;
+    baseline: number;
+    current: number;
+}
+
+function compareBaseline(results: BenchResult[], file: string, threshold: number): Regression[] {
+    const baseline = JSON.parse(fs.readFileSync(file, 'utf8')) as { results: BenchResult[] };
+    const previous = new Map(baseline.results.map(r => [`${r.name}@${r.batch}`, r]));
+    const regressions: Regression[] = [];
+    for (const r of results) {
+        const prev = previous.get(`${r.name}@${r.batch}`);
+        if (!prev) {
+            continue;
+        }
+        if (prev.nsPerFrame > 0 && r.nsPerFrame > prev.nsPerFrame * (1 + threshold)) {
+            regressions.push({ name: r.name, batch: r.batch, metric: 'nsPerFrame', baseline: prev.nsPerFrame, current: r.nsPerFrame });
+        }
+        // 分配量受GC时机影响小，允许额外8字节/帧的抖动
+        if (r.heapBytesPerFrame > prev.heapBytesPerFrame * (1 + threshold) + 8) {
+            regressions.push({
+                name: r.name, batch: r.batch, metric: 'heapBytesPerFrame',
+                baseline: prev.heapBytesPerFrame, current: r.heapBytesPerFrame,
+            });
+        }
+    }
+    return regressions;
+}
+
+// ==================== 主流程 ====================
+
+async function main(): Promise<number> {
+    const options = parseArgs(process.argv.slice(2));
+    const jsonToStdout = options.json === '-';
+    const log = jsonToStdout ? console.error : console.log;
+    if (!gcHook) {
+        log('提示: 未以--expose-gc运行，分配字节可能偏大');
+    }
+
+    const ctx = openBench();
+    const results: BenchResult[] = [];
+    try {
+        // 非合并模式的用例先运行，合并接收开启后receive/receiveFD不再有数据
+        const cases = CASES
+            .filter(c => !options.filter || options.filter.test(c.name))
+            .sort((a, b) => Number(!!a.merged) - Number(!!b.merged));
+        let merged = false;
+        for (const bench of cases) {
+            if (!!bench.merged !== merged) {
+                merged = !!bench.merged;
+                setMerged(ctx, merged);
+            }
+            bench.setup?.(ctx);
+            try {
+                for (const batch of bench.perCall ? [1] : options.batches) {
+                    ctx.device.clearBuffer(ctx.rx);
+                    const result = await measure(ctx, bench, batch, options.framesPerCase);
+                    results.push(result);
+                    log(`${bench.name} x${batch}: ${fixed(result.nsPerFrame, 1)} ns/帧, ${fixed(result.heapBytesPerFrame, 1)} B/帧`);
+                }
+            } finally {
+                bench.teardown?.(ctx);
+            }
+        }
+    } finally {
+        ctx.device.closeDevice();
+    }
+
+    // 报告顺序按用例注册顺序，便于组内对照
+    const order = new Map(CASES.map((c, i) => [c.name, i]));
+    results.sort((a, b) => (order.get(a.name)! - order.get(b.name)!) || a.batch - b.batch);
+    annotateRelative(results);
+    if (!jsonToStdout) {
+        console.log('');
+        printTable(results);
+    }
+
+    const report = {
+        timestamp: new Date().toISOString(),
+        node: process.version,
+        platform: `${os.platform()}-${os.arch()}`,
+        cpu: os.cpus()[0]?.model ?? '',
+        backend: process.env.ZLGCAN_BACKEND,
+        exposeGc: !!gcHook,
+        framesPerCase: options.framesPerCase,
+        results,
+    };
+    if (jsonToStdout) {
+        process.stdout.write(JSON.stringify(report, null, 2) + '\n');
+    } else if (options.json) {
+        fs.writeFileSync(options.json, JSON.stringify(report, null, 2));
+        log(`JSON结果已写入 ${options.json}`);
+    }
+
+    if (options.baseline) {
+        const regressions = compareBaseline(results, options.baseline, options.threshold);
+        for (const r of regressions) {
+            log(`[REGRESSION] ${r.name} x${r.batch} ${r.metric}: ${fixed(r.baseline, 1)} -> ${fixed(r.current, 1)}`);
+        }
+        if (regressions.length > 0) {
+            return 1;
+        }
+        log(`与基线 ${options.baseline} 比较无回归（阈值${(options.threshold * 100).toFixed(0)}%）`);
+    }
+    return 0;
+}
+
+main().then(code => {
+    process.exitCode = code;
+}).catch(error => {
+    console.error(error);
+    process.exitCode = 2;
+});
@@ -5,11 +5,15 @@
  * 测试内容: 覆盖zlgcan_wrapper.cpp和index.ts中的所有接口
  */
 
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
 import {
     ZlgCanDevice,
     DeviceType,
     CanType,
     DataType,
+    ErrorCode,
     CanFrame,
     CanFDFrame,
     ReceivedFrame,
@@ -21,6 +25,21 @@ import {
     ChannelStatus,
     DataObj,
     ChannelHandle,
+    ChannelHealthEvent,
+    DeviceMonitorEvent,
+    IsoTpEvent,
+    J1939Message,
+    XcpDaqBatch,
+    CanOpenEvent,
+    CanOpenNmtState,
+    E2eFailure,
+    FlashProgress,
+    LinMessage,
+    LinScheduleStatus,
+    UdsError,
+    UdsResponseType,
+    DoipResponse,
+    NodeState,
     INVALID_CHANNEL_HANDLE,
     // 辅助函数
     isValidChannelHandle,
@@ -33,6 +52,10 @@ import {
     CanFrameFlags,
     CanFDFrameFlags,
 } from '../src/zlgcan';
+import { TraceRecorder } from '../src/traceRecorder';
+import { DoipEcuSimulator } from './doip-ecu-simulator';
+import { XcpSlaveSimulator, XcpSimulatedVariables } from './xcp-slave-simulator';
+import { CanOpenNodeSimulator, CanOpenSimulatedObjects } from './canopen-node-simulator';
 
 // ============== 测试配置 ==============
 
@@ -110,6 +133,30 @@ function sleep(ms: number): Promise<void> {
     return new Promise(resolve => setTimeout(resolve, ms));
 }
 
+// 轮询等待条件成立，超时返回false
+async function waitUntil(condition: () => boolean, timeoutMs: number): Promise<boolean> {
+    const deadline = Date.now() + timeoutMs;
+    while (!condition()) {
+        if (Date.now() >= deadline) {
+            return false;
+        }
+        await sleep(10);
+    }
+    return true;
+}
+
+// CRC-32（IEEE 802.3），与原生层烧写流水线的算法相同
+function crc32(data: number[]): number {
+    let crc = 0xFFFFFFFF;
+    for (const byte of data) {
+        crc ^= byte;
+        for (let k = 0; k < 8; k++) {
+            crc = (crc & 1) ? (0xEDB88320 ^ (crc >>> 1)) : (crc >>> 1);
+        }
+    }
+    return (crc ^ 0xFFFFFFFF) >>> 0;
+}
+
 // ============== 辅助函数测试 ==============
 
 function testHelperFunctions(): boolean {
@@ -2262,150 +2309,1710 @@ async function testAsyncConcurrentDualChannel(
     return allPassed;
 }
 
-// ============== 设备关闭测试 ==============
+// ============== 通道健康监视测试 ==============
 
-function testCloseDevice(device: ZlgCanDevice): boolean {
-    startGroup('设备关闭测试');
+async function testHealthMonitor(device: ZlgCanDevice, ch0: ChannelHandle, ch1: ChannelHandle): Promise<boolean> {
+    startGroup('通道健康监视测试');
     let allPassed = true;
 
-    const closeResult = device.closeDevice();
-    allPassed = assert(closeResult, 'closeDevice()', '设备关闭成功', '设备关闭失败') && allPassed;
+    const events: ChannelHealthEvent[] = [];
+    const started = device.startHealthMonitor(ch0, { pollIntervalMs: 20, autoRecover: true }, (event) => {
+        events.push(event);
+    });
+    allPassed = assert(started, 'startHealthMonitor(ch0)', '启动成功', '启动失败') && allPassed;
 
-    // 验证关闭后isDeviceOnLine返回false
-    const onlineAfterClose = device.isDeviceOnLine();
-    allPassed = assert(!onlineAfterClose, 'closeDevice后isDeviceOnLine', '返回false', '应返回false') && allPassed;
+    await sleep(200);
+
+    const firstEvent = events.find(e => e.type === 'stateChange');
+    allPassed = assert(
+        firstEvent !== undefined && firstEvent.previousState === 0 && firstEvent.state === NodeState.ZCAN_NODE_STATE_ACTIVE,
+        '初始状态事件',
+        `状态=${firstEvent?.state}, 时间=${firstEvent?.timestamp}`,
+        `未收到主动错误状态事件 (共${events.length}个事件)`
+    ) && allPassed;
+
+    allPassed = assert(
+        firstEvent !== undefined && Math.abs(firstEvent.timestamp - Date.now()) < 5000,
+        '事件时间戳',
+        '与Date.now()同基准',
+        `时间戳偏差过大: ${firstEvent?.timestamp}`
+    ) && allPassed;
+
+    const state = device.getHealthState(ch0);
+    allPassed = assert(
+        state !== null && state.state === NodeState.ZCAN_NODE_STATE_ACTIVE && state.recoveryCount === 0,
+        'getHealthState(ch0)',
+        `state=${state?.state}, recoveryCount=${state?.recoveryCount}`,
+        `状态异常: ${JSON.stringify(state)}`
+    ) && allPassed;
+
+    // 监视期间通信不受影响
+    device.clearBuffer(ch1);
+    device.transmitFD(ch0, { id: 0xB00, len: 8, data: [1, 2, 3, 4, 5, 6, 7, 8], flags: 0, transmitType: 0 });
+    await sleep(50);
+    const received = device.receiveFD(ch1, 10, 100);
+    allPassed = assert(received.length > 0, '监视期间通信', `接收${received.length}帧`, '通信失败') && allPassed;
+
+    // 仿真后端以"N/sim_tec"、"N/sim_bus_off"注入错误计数，硬件不支持这些路径
+    if (device.setValue('sim/online', '1') === 1) {
+        allPassed = await testHealthRecovery(device, ch0, events) && allPassed;
+    } else {
+        logTest('错误状态与自动恢复', true, '非仿真后端，跳过', 0);
+    }
+
+    const stopped = device.stopHealthMonitor(ch0);
+    allPassed = assert(stopped, 'stopHealthMonitor(ch0)', '停止成功', '停止失败') && allPassed;
+
+    const stateAfterStop = device.getHealthState(ch0);
+    allPassed = assert(stateAfterStop === null, '停止后getHealthState', '返回null', '应返回null') && allPassed;
+
+    const stoppedAgain = device.stopHealthMonitor(ch0);
+    allPassed = assert(!stoppedAgain, '重复stopHealthMonitor', '返回false', '应返回false') && allPassed;
+
+    let threw = false;
+    try {
+        device.startHealthMonitor(INVALID_CHANNEL_HANDLE, {}, () => {});
+    } catch {
+        threw = true;
+    }
+    allPassed = assert(threw, '无效句柄startHealthMonitor', '抛出异常', '应抛出异常') && allPassed;
 
     return allPassed;
 }
 
-// ============== 打印测试摘要 ==============
+// 注入错误计数使通道依次进入被动错误和总线关闭，监视器自动复位通道后恢复为主动错误
+async function testHealthRecovery(device: ZlgCanDevice, ch0: ChannelHandle, events: ChannelHealthEvent[]): Promise<boolean> {
+    let allPassed = true;
+    const stateChanges = () => events.filter(e => e.type === 'stateChange').map(e => e.state);
+    events.length = 0;
 
-function printSummary(): void {
-    console.log('\n' + '='.repeat(60));
-    console.log('                    测试摘要');
-    console.log('='.repeat(60));
+    device.setValue('0/sim_tec', '130');
+    const passive = await waitUntil(() => stateChanges().includes(NodeState.ZCAN_NODE_STATE_PASSIVE), 1000);
+    const passiveEvent = events.find(e => e.state === NodeState.ZCAN_NODE_STATE_PASSIVE);
+    allPassed = assert(
+        passive && passiveEvent?.txErrCount === 130,
+        '被动错误状态事件',
+        `txErrCount=${passiveEvent?.txErrCount}`,
+        `状态事件: ${stateChanges().join(',')}`
+    ) && allPassed;
 
-    let totalPassed = 0;
-    let totalFailed = 0;
+    device.setValue('0/sim_bus_off', '1');
+    const recovered = await waitUntil(() => events.some(e => e.type === 'recovered'), 2000);
 
-    for (const group of testGroups) {
-        const passed = group.results.filter(r => r.passed).length;
-        const failed = group.results.filter(r => !r.passed).length;
-        totalPassed += passed;
-        totalFailed += failed;
+    const expected = [
+        NodeState.ZCAN_NODE_STATE_PASSIVE,
+        NodeState.ZCAN_NODE_STATE_BUSOFF,
+        NodeState.ZCAN_NODE_STATE_ACTIVE,
+    ];
+    allPassed = assert(
+        stateChanges().join(',') === expected.join(','),
+        '状态事件顺序',
+        '被动错误 -> 总线关闭 -> 主动错误',
+        `状态事件: ${stateChanges().join(',')}`
+    ) && allPassed;
 
-        const status = failed === 0 ? '\x1b[32m✓\x1b[0m' : '\x1b[31m✗\x1b[0m';
-        console.log(`  ${status} ${group.name}: ${passed}/${group.results.length} 通过`);
+    const attempt = events.find(e => e.type === 'recoveryAttempt');
+    allPassed = assert(
+        attempt !== undefined && attempt.attempt === 1 && attempt.success,
+        '自动恢复尝试',
+        `第${attempt?.attempt}次, ResetCAN+StartCAN成功`,
+        `恢复尝试: ${JSON.stringify(attempt)}`
+    ) && allPassed;
 
-        if (failed > 0) {
-            for (const result of group.results) {
-                if (!result.passed) {
-                    console.log(`      \x1b[31m✗\x1b[0m ${result.name}: ${result.message}`);
-                }
-            }
-        }
-    }
+    const recoveredEvent = events.find(e => e.type === 'recovered');
+    allPassed = assert(
+        recovered && recoveredEvent?.attempt === 1,
+        '总线关闭后恢复',
+        `耗时${((recoveredEvent?.latencyUs ?? 0) / 1000).toFixed(1)}ms`,
+        '未收到恢复事件'
+    ) && allPassed;
 
-    console.log('-'.repeat(60));
-    const allPassed = totalFailed === 0;
-    const summaryColor = allPassed ? '\x1b[32m' : '\x1b[31m';
-    console.log(`  ${summaryColor}总计: ${totalPassed} 通过, ${totalFailed} 失败, 共 ${totalPassed + totalFailed} 项测试\x1b[0m`);
-    console.log('='.repeat(60));
+    const state = device.getHealthState(ch0);
+    allPassed = assert(
+        state !== null && state.state === NodeState.ZCAN_NODE_STATE_ACTIVE && state.recoveryCount === 1,
+        '恢复后getHealthState(ch0)',
+        `state=${state?.state}, recoveryCount=${state?.recoveryCount}`,
+        `状态异常: ${JSON.stringify(state)}`
+    ) && allPassed;
 
-    if (!allPassed) {
-        process.exit(1);
+    // 监视器采样时读走的总线关闭仍交给readChannelErrInfo，且只交付一次
+    const errInfo = device.readChannelErrInfo(ch0);
+    const again = device.readChannelErrInfo(ch0);
+    allPassed = assert(
+        errInfo !== null && (errInfo.errorCode & ErrorCode.ZCAN_ERROR_CAN_BUSOFF) !== 0 && again?.errorCode === 0,
+        '监视运行时readChannelErrInfo(ch0)',
+        `errorCode=0x${errInfo?.errorCode.toString(16)}, 再次读取0x${again?.errorCode.toString(16)}`,
+        `错误信息: ${JSON.stringify(errInfo)}, ${JSON.stringify(again)}`
+    ) && allPassed;
+
+    return allPassed;
+}
+
+// ============== 设备热插拔监视测试 ==============
+
+async function testDeviceMonitor(device: ZlgCanDevice, ch0: ChannelHandle, ch1: ChannelHandle): Promise<boolean> {
+    startGroup('设备热插拔监视测试');
+    let allPassed = true;
+
+    const initialState = device.getDeviceMonitorState();
+    allPassed = assert(
+        initialState !== null && !initialState.running && initialState.online,
+        '启动前getDeviceMonitorState',
+        `running=${initialState?.running}, online=${initialState?.online}`,
+        `状态异常: ${JSON.stringify(initialState)}`
+    ) && allPassed;
+
+    const events: DeviceMonitorEvent[] = [];
+    const started = device.startDeviceMonitor({ pollIntervalMs: 50 }, (event) => {
+        events.push(event);
+    });
+    allPassed = assert(started, 'startDeviceMonitor()', '启动成功', '启动失败') && allPassed;
+
+    await sleep(300);
+
+    const state = device.getDeviceMonitorState();
+    allPassed = assert(
+        state !== null && state.running && state.online && state.reconnectCount === 0,
+        '运行中getDeviceMonitorState',
+        `online=${state?.online}, reconnectCount=${state?.reconnectCount}`,
+        `状态异常: ${JSON.stringify(state)}`
+    ) && allPassed;
+
+    allPassed = assert(events.length === 0, '在线设备无热插拔事件', '无事件', `收到${events.length}个事件`) && allPassed;
+
+    // 监视期间通信不受影响
+    device.clearBuffer(ch1);
+    device.transmitFD(ch0, { id: 0xB10, len: 8, data: [8, 7, 6, 5, 4, 3, 2, 1], flags: 0, transmitType: 0 });
+    await sleep(50);
+    const received = device.receiveFD(ch1, 10, 100);
+    allPassed = assert(received.length > 0, '监视期间通信', `接收${received.length}帧`, '通信失败') && allPassed;
+
+    // 仿真后端以"sim/online"模拟设备离线，硬件不支持该路径
+    if (device.setValue('sim/online', '1') === 1) {
+        allPassed = await testDeviceReconnect(device, ch0, ch1, events) && allPassed;
+    } else {
+        logTest('设备离线重连', true, '非仿真后端，跳过', 0);
     }
+
+    const stopped = device.stopDeviceMonitor();
+    allPassed = assert(stopped, 'stopDeviceMonitor()', '停止成功', '停止失败') && allPassed;
+
+    const stoppedAgain = device.stopDeviceMonitor();
+    allPassed = assert(!stoppedAgain, '重复stopDeviceMonitor', '返回false', '应返回false') && allPassed;
+
+    return allPassed;
 }
 
-// ============== 主测试流程 ==============
+// 设备离线后监视线程重新打开设备，按原顺序回放通道初始化、启动和设置
+async function testDeviceReconnect(
+    device: ZlgCanDevice,
+    ch0: ChannelHandle,
+    ch1: ChannelHandle,
+    events: DeviceMonitorEvent[]
+): Promise<boolean> {
+    let allPassed = true;
 
-async function runAllTests(): Promise<void> {
-    console.log('='.repeat(60));
-    console.log('        ZLG CAN 完整接口测试 - USBCANFD-200U');
-    console.log('        连接拓扑: 通道0 <-> 通道1');
-    console.log('='.repeat(60));
-    console.log(`设备类型ID: ${TEST_CONFIG.deviceType}`);
-    console.log(`设备索引: ${TEST_CONFIG.deviceIndex}`);
+    // 同一路径先后设置，回放后应为最后一次的值
+    device.setValue('0/monitor_toggle', '1');
+    device.setValue('0/monitor_toggle', '0');
+    device.setValue('0/monitor_toggle', '1');
+    // 仿真总线号在下次StartCAN时生效：回放在启动之后时通道1仍在原总线上，提前回放则与通道0断开
+    device.setValue('1/sim_bus', '77');
 
-    // 辅助函数测试 (不需要设备)
-    testHelperFunctions();
+    events.length = 0;
+    device.setValue('sim/online', '0');
+    await waitUntil(() => events.length >= 2, 3000);
 
-    // 常量测试 (不需要设备)
-    testConstants();
+    const offline = events[0];
+    const reconnected = events[1];
+    allPassed = assert(
+        offline?.type === 'offline' && reconnected?.type === 'reconnected',
+        '离线与重连事件',
+        `重连耗时${((reconnected?.reconnectUs ?? 0) / 1000).toFixed(1)}ms, 尝试${reconnected?.attempts}次`,
+        `事件: ${JSON.stringify(events.map(event => event.type))}`
+    ) && allPassed;
 
-    // 设备实例化测试
-    testDeviceInstantiation();
+    const replayedChannels = reconnected?.channels.map(channel => channel.channelIndex).sort() ?? [];
+    allPassed = assert(
+        reconnected?.replayFailures === 0 && replayedChannels.join(',') === '0,1',
+        '重连后回放',
+        `回放通道${replayedChannels.join(',')}`,
+        `回放失败${reconnected?.replayFailures}项, 通道${replayedChannels.join(',')}`
+    ) && allPassed;
 
-    // 创建设备实例
-    const device = new ZlgCanDevice();
+    const toggle = device.getValue('0/monitor_toggle');
+    allPassed = assert(toggle === '1', '回放同一路径的最新值', `值为${toggle}`, `值为${toggle}，应为1`) && allPassed;
 
-    // 设备操作测试
-    const deviceOk = await testDeviceOperations(device);
-    if (!deviceOk) {
-        console.log('\n\x1b[31m设备打开失败，终止后续测试\x1b[0m');
-        printSummary();
-        return;
+    // 旧句柄继续可用；通道1在原总线上说明初始化、启动、设置依次回放
+    device.clearBuffer(ch1);
+    device.transmitFD(ch0, { id: 0xB11, len: 8, data: [1, 2, 3, 4, 5, 6, 7, 8], flags: 0, transmitType: 0 });
+    const received = device.receiveFD(ch1, 10, 200);
+    allPassed = assert(
+        received.some(frame => frame.id === 0xB11),
+        '重连后通信(原通道句柄)',
+        `接收${received.length}帧`,
+        '通道1未收到通道0的帧'
+    ) && allPassed;
+
+    const state = device.getDeviceMonitorState();
+    allPassed = assert(
+        state !== null && state.online && state.reconnectCount === 1,
+        '重连后getDeviceMonitorState',
+        `reconnectCount=${state?.reconnectCount}`,
+        `状态异常: ${JSON.stringify(state)}`
+    ) && allPassed;
+
+    device.setValue('1/sim_bus', '0');
+    return allPassed;
+}
+
+// ============== 异步设备操作测试 ==============
+
+async function testAsyncDeviceOperations(device: ZlgCanDevice, ch0: ChannelHandle, ch1: ChannelHandle): Promise<boolean> {
+    startGroup('异步设备操作测试');
+    let allPassed = true;
+
+    // 未打开设备的异步关闭
+    const idleDevice = new ZlgCanDevice();
+    const idleClose = await idleDevice.closeDeviceAsync(1000);
+    allPassed = assert(!idleClose, '未打开设备closeDeviceAsync', '返回false', '应返回false') && allPassed;
+
+    // 打开不存在的设备索引
+    const openStart = Date.now();
+    const openMissing = await idleDevice.openDeviceAsync(TEST_CONFIG.deviceType, 99, 0, 5000);
+    allPassed = assert(
+        !openMissing,
+        'openDeviceAsync(不存在的设备)',
+        `返回false, 耗时${Date.now() - openStart}ms`,
+        '应返回false'
+    ) && allPassed;
+
+    // 异步启动已启动的通道
+    const [start0, start1] = await Promise.all([
+        device.startCanChannelAsync(ch0, 2000),
+        device.startCanChannelAsync(ch1, 2000),
+    ]);
+    allPassed = assert(
+        typeof start0 === 'boolean' && typeof start1 === 'boolean',
+        '并行startCanChannelAsync',
+        `ch0=${start0}, ch1=${start1}`,
+        '返回值类型错误'
+    ) && allPassed;
+
+    // 完成前被重新初始化或复位的异步初始化结果作废，通道仍由之后的操作决定
+    if (device.setValue('sim/online', '1') === 1) {
+        const superseded = device.initCanChannelAsync(0, TEST_CONFIG.canfdConfig, 2000);
+        const reinit = device.initCanChannel(0, TEST_CONFIG.canfdConfig);
+        const supersededHandle = await superseded;
+        const restarted = device.startCanChannel(reinit);
+        allPassed = assert(
+            supersededHandle === 0n && restarted,
+            '被同步初始化取代的initCanChannelAsync',
+            '返回0n, 同步初始化的通道可启动',
+            `返回${supersededHandle}, 启动${restarted}`
+        ) && allPassed;
+
+        const reset = device.initCanChannelAsync(1, TEST_CONFIG.canfdConfig, 2000);
+        device.resetCanChannel(ch1);
+        const resetHandle = await reset;
+        allPassed = assert(
+            resetHandle === 0n,
+            '被复位取代的initCanChannelAsync',
+            '返回0n',
+            `返回${resetHandle}`
+        ) && allPassed;
+        device.initCanChannel(1, TEST_CONFIG.canfdConfig);
+        device.startCanChannel(ch1);
+    } else {
+        logTest('被取代的异步初始化', true, '非仿真后端，跳过', 0);
     }
 
-    // 属性操作测试
-    await testPropertyOperations(device);
+    // 异步操作后通信正常
+    device.clearBuffer(ch1);
+    device.transmitFD(ch0, { id: 0xB20, len: 8, data: [0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88], flags: 0, transmitType: 0 });
+    await sleep(50);
+    const received = device.receiveFD(ch1, 10, 100);
+    allPassed = assert(received.length > 0, '异步操作后通信', `接收${received.length}帧`, '通信失败') && allPassed;
 
-    // 通道操作测试
-    const channels = await testChannelOperations(device);
-    if (!channels) {
-        console.log('\n\x1b[31m通道初始化失败，终止后续测试\x1b[0m');
-        testCloseDevice(device);
-        printSummary();
-        return;
+    return allPassed;
+}
+
+// ============== 通道静默测试 ==============
+
+async function testQuiesce(device: ZlgCanDevice, ch0: ChannelHandle, ch1: ChannelHandle): Promise<boolean> {
+    startGroup('通道静默测试');
+    let allPassed = true;
+
+    // 空闲总线上应立即返回
+    const idle = await device.quiesceAsync([ch0, ch1], { timeoutMs: 100 });
+    allPassed = assert(
+        idle.clean && idle.elapsedUs < 100000,
+        'quiesceAsync(空闲总线)',
+        `耗时${(idle.elapsedUs / 1000).toFixed(1)}ms`,
+        `clean=${idle.clean}, 耗时${(idle.elapsedUs / 1000).toFixed(1)}ms`
+    ) && allPassed;
+
+    // 残留报文被丢弃
+    for (let i = 0; i < 20; i++) {
+        device.transmitFD(ch0, { id: 0xB30, len: 8, data: [i, 0, 0, 0, 0, 0, 0, 0], flags: 0, transmitType: 0 });
     }
+    const busy = await device.quiesceAsync([ch0, ch1], { timeoutMs: 200 });
+    allPassed = assert(
+        busy.clean && busy.discardedFrames > 0,
+        'quiesceAsync(有残留报文)',
+        `丢弃${busy.discardedFrames}帧, 耗时${(busy.elapsedUs / 1000).toFixed(1)}ms`,
+        `clean=${busy.clean}, 丢弃${busy.discardedFrames}帧`
+    ) && allPassed;
 
-    // CAN帧收发测试
-    await testCanTransmitReceive(device, channels.ch0, channels.ch1);
+    const remaining = device.getReceiveNum(ch1, CanType.TYPE_CANFD);
+    allPassed = assert(remaining === 0, '静默后接收缓冲区', '为空', `剩余${remaining}帧`) && allPassed;
 
-    // CANFD帧收发测试
-    await testCanFDTransmitReceive(device, channels.ch0, channels.ch1);
+    return allPassed;
+}
 
-    // 双向通信测试
-    await testBidirectionalCommunication(device, channels.ch0, channels.ch1);
+// ============== UDS诊断测试 ==============
 
-    // DataObj收发测试
-    await testDataObjTransmitReceive(device, channels.ch0, channels.ch1);
+async function testUdsRequest(device: ZlgCanDevice): Promise<boolean> {
+    startGroup('UDS诊断测试');
+    let allPassed = true;
 
-    // 边界条件测试
-    await testBoundaryConditions(device, channels.ch0, channels.ch1);
+    // 测试拓扑中没有ECU，请求应在P2超时后返回
+    const single = await device.udsRequestAsync({
+        channel: 0, srcAddr: 0x7E0, dstAddr: 0x7E8, sid: 0x22, data: [0xF1, 0x90], timeoutMs: 200,
+    });
+    allPassed = assert(
+        single.status === UdsError.TIMEOUT && single.type === UdsResponseType.NONE,
+        'udsRequestAsync(无ECU)',
+        `超时返回, 耗时${(single.timing.totalUs / 1000).toFixed(1)}ms`,
+        `status=0x${single.status.toString(16)}, type=${single.type}`
+    ) && allPassed;
 
-    // 扩展帧测试
-    await testExtendedFrames(device, channels.ch0, channels.ch1);
+    // 不同通道的请求并发执行
+    const concurrentStart = Date.now();
+    const [r0, r1] = await Promise.all([
+        device.udsRequestAsync({ channel: 0, srcAddr: 0x7E0, dstAddr: 0x7E8, sid: 0x10, data: [0x01], timeoutMs: 200 }),
+        device.udsRequestAsync({ channel: 1, srcAddr: 0x7E1, dstAddr: 0x7E9, sid: 0x10, data: [0x01], timeoutMs: 200 }),
+    ]);
+    const concurrentMs = Date.now() - concurrentStart;
+    allPassed = assert(
+        r0.reqId !== r1.reqId && concurrentMs < 380,
+        '双通道并发请求',
+        `耗时${concurrentMs}ms`,
+        `耗时${concurrentMs}ms，请求未并发执行`
+    ) && allPassed;
 
-    // CANFD BRS标志测试
-    await testCanFDBRS(device, channels.ch0, channels.ch1);
+    // 同一通道的请求依次执行，排队中的请求可取消
+    const first = device.udsRequestAsync({ channel: 0, srcAddr: 0x7E0, dstAddr: 0x7E8, sid: 0x3E, data: [0x00], timeoutMs: 200 });
+    const queued = device.udsRequestAsync({ channel: 0, srcAddr: 0x7E0, dstAddr: 0x7E8, sid: 0x3E, data: [0x00], timeoutMs: 200 });
+    allPassed = assert(
+        first.reqId !== queued.reqId,
+        'udsRequestAsync(分配请求ID)',
+        `reqId ${first.reqId}, ${queued.reqId}`,
+        `请求ID重复: ${first.reqId}`
+    ) && allPassed;
+    await sleep(10);
+    const cancelled = device.udsCancel(queued.reqId);
+    const [firstResult, queuedResult] = await Promise.all([first, queued]);
+    allPassed = assert(
+        cancelled && queuedResult.status === UdsError.CANCEL && firstResult.status === UdsError.TIMEOUT,
+        'udsCancel(排队中的请求)',
+        `已取消, 排队${(queuedResult.timing.queuedUs / 1000).toFixed(1)}ms`,
+        `cancel=${cancelled}, status=0x${queuedResult.status.toString(16)}`
+    ) && allPassed;
 
-    // 压力测试
-    await testStress(device, channels.ch0, channels.ch1);
+    allPassed = assert(
+        queuedResult.reqId === queued.reqId && firstResult.reqId === first.reqId,
+        'udsRequestAsync(响应reqId)', '与分配的ID一致', `响应reqId ${firstResult.reqId}, ${queuedResult.reqId}`
+    ) && allPassed;
 
-    // 双向并发测试
-    await testBidirectionalConcurrent(device, channels.ch0, channels.ch1);
+    allPassed = assert(!device.udsCancel(queued.reqId), 'udsCancel(已完成的请求)', '返回false', '应返回false') && allPassed;
 
-    // 错误处理测试
-    await testErrorHandling(device, channels.ch0, channels.ch1);
+    return allPassed;
+}
 
-    // 时间戳测试
-    await testTimestamp(device, channels.ch0, channels.ch1);
+// ============== ISO-TP传输层测试 ==============
+
+function waitIsoTpEvent(events: IsoTpEvent[], count: number, timeoutMs: number): Promise<boolean> {
+    const deadline = Date.now() + timeoutMs;
+    return new Promise(resolve => {
+        const check = () => {
+            if (events.length >= count) {
+                resolve(true);
+            } else if (Date.now() > deadline) {
+                resolve(false);
+            } else {
+                setTimeout(check, 5);
+            }
+        };
+        check();
+    });
+}
 
-    // CAN传统模式兼容测试
-    await testCanCompatibility(device, channels.ch0, channels.ch1);
+async function testIsoTp(device: ZlgCanDevice, ch0: ChannelHandle, ch1: ChannelHandle): Promise<boolean> {
+    startGroup('ISO-TP传输层测试');
+    let allPassed = true;
 
-    // 性能基准测试
-    await testPerformanceBenchmark(device, channels.ch0, channels.ch1);
+    const events0: IsoTpEvent[] = [];
+    const events1: IsoTpEvent[] = [];
+    const tester = device.isotpOpen(ch0, { txId: 0x7E0, rxId: 0x7E8 }, event => events0.push(event));
+    const ecu = device.isotpOpen(ch1, { txId: 0x7E8, rxId: 0x7E0, blockSize: 8, stMinUs: 200 }, event => events1.push(event));
+    allPassed = assert(tester > 0 && ecu > 0, 'isotpOpen', `会话${tester}, ${ecu}`, '打开失败') && allPassed;
 
-    // 单通道异步并发测试
-    await testAsyncConcurrentSingleChannel(device, channels.ch0, channels.ch1);
+    let duplicated = false;
+    try {
+        device.isotpOpen(ch1, { txId: 0x7E9, rxId: 0x7E0 }, () => {});
+    } catch {
+        duplicated = true;
+    }
+    allPassed = assert(duplicated, 'isotpOpen(重复接收ID)', '抛出异常', '应抛出异常') && allPassed;
 
-    // 双通道异步并发测试
-    await testAsyncConcurrentDualChannel(device, channels.ch0, channels.ch1);
+    // 最大长度的经典CAN多帧消息，接收方BS=8、STmin=200us
+    const payload = Array.from({ length: 4095 }, (_, i) => i & 0xFF);
+    const sent = await device.isotpSendAsync(tester, payload);
+    const received = await waitIsoTpEvent(events1, 1, 1000);
+    const match = received && events1[0].type === 'message' &&
+        events1[0].data.length === payload.length && events1[0].data.every((b, i) => b === payload[i]);
+    allPassed = assert(
+        sent.success && match,
+        'isotpSendAsync(CAN 4095字节)',
+        `${sent.frames}帧, 耗时${(sent.durationUs / 1000).toFixed(1)}ms, ${(sent.bytesPerSec / 1024).toFixed(1)}KB/s`,
+        `success=${sent.success}, error=${sent.error}, 接收${received ? events1[0].type : '超时'}`
+    ) && allPassed;
 
-    // 通道复位测试
-    await testChannelReset(device, channels.ch0, channels.ch1);
+    const ecuStats = device.isotpGetStats(ecu);
+    allPassed = assert(
+        ecuStats !== null && ecuStats.rxMessages === 1 && ecuStats.maxFcResponseUs < 1000,
+        'isotpGetStats(流控响应)',
+        `最大${ecuStats?.maxFcResponseUs}us`,
+        `rxMessages=${ecuStats?.rxMessages}, 最大${ecuStats?.maxFcResponseUs}us`
+    ) && allPassed;
+
+    // 反方向单帧
+    const reply = await device.isotpSendAsync(ecu, [0x62, 0xF1, 0x90]);
+    const replied = await waitIsoTpEvent(events0, 1, 500);
+    allPassed = assert(
+        reply.success && replied && events0[0].data.length === 3,
+        'isotpSendAsync(单帧)',
+        `耗时${reply.durationUs}us`,
+        `success=${reply.success}, 接收${replied}`
+    ) && allPassed;
+
+    device.isotpClose(tester);
+    device.isotpClose(ecu);
+
+    // CANFD 64字节帧
+    const fdEvents: IsoTpEvent[] = [];
+    const testerId = buildCanId(0x18DA10F1, true);
+    const ecuId = buildCanId(0x18DAF110, true);
+    const fdTester = device.isotpOpen(ch0, { txId: testerId, rxId: ecuId, fd: true, brs: true, txDataLength: 64 }, () => {});
+    const fdEcu = device.isotpOpen(ch1, { txId: ecuId, rxId: testerId, fd: true, brs: true, txDataLength: 64 }, event => fdEvents.push(event));
+    const fdSent = await device.isotpSendAsync(fdTester, payload);
+    const fdReceived = await waitIsoTpEvent(fdEvents, 1, 1000);
+    allPassed = assert(
+        fdSent.success && fdReceived && fdEvents[0].data.length === payload.length,
+        'isotpSendAsync(CANFD 4095字节)',
+        `${fdSent.frames}帧, 耗时${(fdSent.durationUs / 1000).toFixed(1)}ms`,
+        `success=${fdSent.success}, error=${fdSent.error}`
+    ) && allPassed;
+    device.isotpClose(fdTester);
+    device.isotpClose(fdEcu);
+
+    // 未被ISO-TP认领的帧仍可通过receive取出
+    device.transmit(ch0, { id: 0x123, dlc: 2, data: [0x01, 0x02] });
+    await sleep(20);
+    const frames = device.receive(ch1, 10, 0);
+    const stats = device.getReceiveThreadStats(ch1);
+    allPassed = assert(
+        frames.some(f => f.id === 0x123) && stats !== null && stats.framesClaimed > 0,
+        '接收线程透传',
+        `接收${stats?.framesReceived}帧, 协议引擎认领${stats?.framesClaimed}帧`,
+        `透传${frames.length}帧, stats=${JSON.stringify(stats)}`
+    ) && allPassed;
+
+    allPassed = assert(
+        device.stopReceiveThread(ch0) && device.stopReceiveThread(ch1) && device.getReceiveThreadStats(ch1) === null,
+        'stopReceiveThread',
+        '已停止',
+        '停止失败'
+    ) && allPassed;
+
+    return allPassed;
+}
+
+// ============== 在线烧写测试 ==============
+
+async function testFlash(device: ZlgCanDevice, ch0: ChannelHandle, ch1: ChannelHandle): Promise<boolean> {
+    startGroup('在线烧写测试');
+    let allPassed = true;
+
+    const image = Array.from({ length: 20000 }, (_, i) => (i * 13 + 1) & 0xFF);
+    const file = path.join(os.tmpdir(), `zlgcan-flash-${process.pid}.bin`);
+    fs.writeFileSync(file, Buffer.from(image));
+
+    // 通道1模拟ECU：0x34返回块长度1026，0x36按序号写入，0x37结束，0x31 0202校验已写入数据的CRC32
+    const memory: number[] = [];
+    let checkedCrc = -1;
+    let ecu = 0;
+    ecu = device.isotpOpen(ch1, { txId: 0x7E8, rxId: 0x7E0, stMinUs: 200, maxMessageLength: 2048 }, event => {
+        if (event.type !== 'message') return;
+        const request = event.data;
+        let response: number[] = [];
+        if (request[0] === 0x34) {
+            response = [0x74, 0x20, 0x04, 0x02];
+        } else if (request[0] === 0x36) {
+            memory.push(...request.slice(2));
+            response = [0x76, request[1]];
+        } else if (request[0] === 0x37) {
+            response = [0x77];
+        } else if (request[0] === 0x31 && request[1] === 0x01 && request[2] === 0x02 && request[3] === 0x02) {
+            checkedCrc = ((request[4] << 24) | (request[5] << 16) | (request[6] << 8) | request[7]) >>> 0;
+            response = [0x71, 0x01, 0x02, 0x02, checkedCrc === crc32(memory) ? 0x00 : 0x01];
+        }
+        device.isotpSendAsync(ecu, response);
+    });
+
+    const progress: FlashProgress[] = [];
+    const result = await device.flashAsync(ch0, {
+        file,
+        txId: 0x7E0,
+        rxId: 0x7E8,
+        baseAddress: 0x08000000,
+        autoTuneStMin: true,
+        progressIntervalMs: 0,
+        checkMemoryRoutineId: 0x0202,
+    }, p => progress.push(p));
+    await sleep(20);
+
+    const match = memory.length === image.length && memory.every((b, i) => b === image[i]);
+    allPassed = assert(
+        result.success && match && result.segments.length === 1 && result.blockLength === 1026,
+        'flashAsync(二进制)',
+        `${result.bytesSent}字节, 耗时${(result.elapsedUs / 1000).toFixed(1)}ms, ${(result.bytesPerSec / 1024).toFixed(1)}KB/s, STmin=${result.stMinUs}us`,
+        `success=${result.success}, error=${result.error}, 写入${memory.length}字节`
+    ) && allPassed;
+
+    allPassed = assert(
+        result.segments[0]?.crcVerified === true && checkedCrc === result.segments[0].crc32 && checkedCrc === crc32(image),
+        'flashAsync(0x31 CRC校验)',
+        `CRC32 0x${checkedCrc.toString(16)}`,
+        `crcVerified=${result.segments[0]?.crcVerified}, 发送0x${checkedCrc.toString(16)}, 结果0x${result.segments[0]?.crc32.toString(16)}`
+    ) && allPassed;
+
+    // 发送间隔不得小于ECU流控中的STmin（200us）
+    allPassed = assert(
+        result.remoteStMinUs === 200 && (result.stMinUs < 0 || result.stMinUs >= result.remoteStMinUs) &&
+            progress.every(p => p.stMinUs < 0 || p.stMinUs >= 200),
+        'flashAsync(STmin下限)',
+        `流控STmin=${result.remoteStMinUs}us, 使用${result.stMinUs}us`,
+        `流控STmin=${result.remoteStMinUs}us, 使用${result.stMinUs}us`
+    ) && allPassed;
+
+    allPassed = assert(
+        progress.length > 0 && progress[progress.length - 1].bytesSent === image.length,
+        'flashAsync(进度回调)',
+        `${progress.length}次`,
+        `${progress.length}次, 最后${progress[progress.length - 1]?.bytesSent}字节`
+    ) && allPassed;
+
+    const missing = await device.flashAsync(ch0, { file: file + '.missing', txId: 0x7E0, rxId: 0x7E8 });
+    allPassed = assert(!missing.success && !!missing.error, 'flashAsync(文件不存在)', missing.error ?? '', '应返回失败') && allPassed;
+
+    allPassed = assert(!device.flashCancel(ch0), 'flashCancel(无烧写)', '返回false', '应返回false') && allPassed;
+
+    device.isotpClose(ecu);
+    device.stopReceiveThread(ch0);
+    device.stopReceiveThread(ch1);
+    fs.unlinkSync(file);
+
+    return allPassed;
+}
+
+// ============== LIN通道测试 ==============
+
+async function testLin(device: ZlgCanDevice): Promise<boolean> {
+    startGroup('LIN通道测试');
+    let allPassed = true;
+
+    const infoEx = device.getDeviceInfoEx();
+    if (!infoEx || infoEx.linChannelNumber < 1) {
+        logTest('LIN通道', true, '设备无LIN通道，跳过', 0);
+        return allPassed;
+    }
+
+    const lin = device.initLinChannel(0, { linMode: 1, linBaud: 19200 });
+    allPassed = assert(isValidChannelHandle(lin), 'initLinChannel', `句柄${lin}`, '初始化失败') && allPassed;
+    if (!isValidChannelHandle(lin)) {
+        return allPassed;
+    }
+    allPassed = assert(device.startLinChannel(lin), 'startLinChannel', '启动成功', '启动失败') && allPassed;
+
+    // 主机发布0x10的数据，调度表依次发送0x10和0x11的帧头
+    allPassed = assert(
+        device.setLinPublish(lin, [{ id: 0x10, data: [0x01, 0x02, 0x03, 0x04] }]),
+        'setLinPublish', '设置成功', '设置失败'
+    ) && allPassed;
+
+    const messages: LinMessage[] = [];
+    allPassed = assert(
+        device.startLinReceiveThread(lin, {}, batch => messages.push(...batch)),
+        'startLinReceiveThread(回调)', '已启动', '启动失败'
+    ) && allPassed;
+
+    const schedule = device.addLinSchedule(lin, [
+        { id: 0x10, slotMs: 10 },
+        { id: 0x11, slotMs: 10 },
+    ]);
+    allPassed = assert(schedule !== null, 'addLinSchedule', `调度表${schedule}`, '创建失败') && allPassed;
+
+    if (schedule !== null) {
+        allPassed = assert(device.startLinSchedule(lin), 'startLinSchedule', '启动成功', '启动失败') && allPassed;
+        await sleep(200);
+        const status = device.getLinScheduleStatus(lin, schedule);
+        allPassed = assert(
+            status === LinScheduleStatus.RUNNING,
+            'getLinScheduleStatus', '运行中', `状态${status}`
+        ) && allPassed;
+        device.stopLinSchedule(lin);
+    }
+
+    const stats = device.getLinReceiveThreadStats(lin);
+    logTest('LIN接收回调', true, `推送${messages.length}条, 接收线程读取${stats?.framesReceived}条`, 0);
+
+    allPassed = assert(
+        device.clearLinSchedules(lin) && device.stopLinReceiveThread(lin) && device.getLinReceiveThreadStats(lin) === null,
+        'clearLinSchedules/stopLinReceiveThread', '已清理', '清理失败'
+    ) && allPassed;
+    allPassed = assert(device.resetLinChannel(lin), 'resetLinChannel', '复位成功', '复位失败') && allPassed;
+
+    return allPassed;
+}
+
+// ============== DoIP诊断测试 ==============
+
+async function testDoip(device: ZlgCanDevice): Promise<boolean> {
+    startGroup('DoIP诊断测试');
+    let allPassed = true;
+
+    const simulator = new DoipEcuSimulator({ largeDidLength: 16384, maxBlockLength: 4098 });
+    try {
+        await simulator.start(13400, '127.0.0.1');
+    } catch (err) {
+        logTest('DoIP模拟器', true, `端口13400不可用，跳过: ${(err as Error).message}`, 0);
+        return allPassed;
+    }
+
+    const base = { serverAddress: '127.0.0.1', sourceAddress: 0x0E00, requestTimeoutMs: 1000 };
+    const positive = (r: DoipResponse) => r.status === UdsError.OK && r.type === UdsResponseType.POSITIVE;
+
+    try {
+        // 首个请求建立连接并路由激活，之后的请求复用连接
+        const first = await device.doipRequestAsync({ ...base, targetAddress: 0x1001, sid: 0x22, data: [0xF1, 0x90] });
+        allPassed = assert(
+            positive(first) && first.sid === 0x62 && first.data.length === 19 && !first.timing.connectionReused,
+            'doipRequestAsync(建立连接)',
+            `耗时${(first.timing.requestUs / 1000).toFixed(1)}ms（含连接与路由激活）`,
+            `status=0x${first.status.toString(16)}, type=${first.type}, 长度${first.data.length}`
+        ) && allPassed;
+        if (!positive(first)) {
+            return allPassed;
+        }
+
+        const second = await device.doipRequestAsync({ ...base, targetAddress: 0x1001, sid: 0x3E, data: [0x00] });
+        allPassed = assert(
+            positive(second) && second.timing.connectionReused && simulator.stats.connections === 1,
+            'doipRequestAsync(复用连接)',
+            `耗时${(second.timing.requestUs / 1000).toFixed(2)}ms`,
+            `reused=${second.timing.connectionReused}, 连接数${simulator.stats.connections}`
+        ) && allPassed;
+
+        // 大DID读取
+        const large = await device.doipRequestAsync({ ...base, targetAddress: 0x1001, sid: 0x22, data: [0xF1, 0xA0] });
+        const largeOk = positive(large) && large.data.length === 2 + 16384 &&
+            large.data.slice(2).every((b, i) => b === (i & 0xFF));
+        allPassed = assert(
+            largeOk,
+            'doipRequestAsync(16KB DID)',
+            `${(16384 * 1e6 / Math.max(large.timing.requestUs, 1) / 1024).toFixed(0)}KB/s`,
+            `status=0x${large.status.toString(16)}, 长度${large.data.length}`
+        ) && allPassed;
+
+        // 消极响应与未知目标地址
+        const negative = await device.doipRequestAsync({ ...base, targetAddress: 0x1001, sid: 0x19, data: [0x02, 0xFF] });
+        allPassed = assert(
+            negative.type === UdsResponseType.NEGATIVE && negative.negativeCode === 0x11,
+            'doipRequestAsync(消极响应)', 'NRC 0x11',
+            `type=${negative.type}, nrc=${negative.negativeCode}`
+        ) && allPassed;
+
+        const unknown = await device.doipRequestAsync({ ...base, targetAddress: 0x1FFF, sid: 0x3E, data: [0x00] });
+        allPassed = assert(
+            unknown.status === UdsError.DOIP_DIAGNOSTIC_NACK_UNKNOWN_TARGET_ADDRESS,
+            'doipRequestAsync(未知目标地址)', '诊断NACK',
+            `status=0x${unknown.status.toString(16)}`
+        ) && allPassed;
+
+        // 发往不同目标地址的请求同时在途，同一目标地址的请求依次执行
+        simulator.setTiming(50, 1);
+        const pipelineStart = Date.now();
+        const pipelined = await Promise.all([
+            device.doipRequestAsync({ ...base, targetAddress: 0x1001, sid: 0x10, data: [0x03] }),
+            device.doipRequestAsync({ ...base, targetAddress: 0x1002, sid: 0x10, data: [0x03] }),
+            device.doipRequestAsync({ ...base, targetAddress: 0x1001, sid: 0x3E, data: [0x00] }),
+            device.doipRequestAsync({ ...base, targetAddress: 0x1002, sid: 0x3E, data: [0x00] }),
+        ]);
+        const pipelineMs = Date.now() - pipelineStart;
+        simulator.setTiming(0);
+        allPassed = assert(
+            pipelined.every(positive) && pipelineMs < 180 && simulator.stats.maxConcurrentRequests >= 2,
+            '流水线请求(2个目标x2)',
+            `耗时${pipelineMs}ms, 模拟器并发峰值${simulator.stats.maxConcurrentRequests}`,
+            `耗时${pipelineMs}ms, 状态${pipelined.map(r => r.status).join(',')}`
+        ) && allPassed;
+
+        // 下载64KB，测量TransferData吞吐
+        const imageSize = 64 * 1024;
+        const download = await device.doipRequestAsync({
+            ...base, targetAddress: 0x1002, sid: 0x34,
+            data: [0x00, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00],
+        });
+        const maxBlockLength = positive(download) ? (download.data[1] << 8) | download.data[2] : 0;
+        let transferOk = maxBlockLength > 2;
+        const transferStart = Date.now();
+        let transferUs = 0;
+        for (let offset = 0, seq = 1; transferOk && offset < imageSize; seq = (seq + 1) & 0xFF) {
+            const chunk = Math.min(maxBlockLength - 2, imageSize - offset);
+            const block = new Array<number>(chunk).fill(0x5A);
+            const r = await device.doipRequestAsync({ ...base, targetAddress: 0x1002, sid: 0x36, data: [seq, ...block] });
+            transferOk = positive(r) && r.data[0] === seq;
+            transferUs += r.timing.requestUs;
+            offset += chunk;
+        }
+        const exit = await device.doipRequestAsync({ ...base, targetAddress: 0x1002, sid: 0x37 });
+        const transferMs = Date.now() - transferStart;
+        allPassed = assert(
+            transferOk && positive(exit) && simulator.stats.downloadedBytes === imageSize,
+            'DoIP下载(64KB)',
+            `${transferMs}ms, 驱动内${(imageSize * 1e6 / Math.max(transferUs, 1) / 1024).toFixed(0)}KB/s`,
+            `块长度${maxBlockLength}, 已接收${simulator.stats.downloadedBytes}字节`
+        ) && allPassed;
+
+        const connection = device.getDoipConnections().find(c => c.serverAddress === '127.0.0.1');
+        allPassed = assert(
+            connection !== undefined && connection.connects === 1 && connection.maxInFlight >= 2 &&
+                simulator.stats.connections === 1,
+            'getDoipConnections',
+            `请求${connection?.requests}, 失败${connection?.failures}, 建立连接${connection?.lastConnectRequestUs}us`,
+            `connects=${connection?.connects}, maxInFlight=${connection?.maxInFlight}, 模拟器连接${simulator.stats.connections}`
+        ) && allPassed;
+    } finally {
+        await simulator.stop();
+    }
+
+    return allPassed;
+}
+
+// ============== J1939传输协议测试 ==============
+
+async function testJ1939(device: ZlgCanDevice, ch0: ChannelHandle, ch1: ChannelHandle): Promise<boolean> {
+    startGroup('J1939传输协议测试');
+    let allPassed = true;
+
+    // 通道0为节点0x80，通道1为节点0x90
+    const received0: J1939Message[] = [];
+    const received1: J1939Message[] = [];
+    const started = device.startJ1939(ch0, { addresses: [0x80] }, messages => received0.push(...messages)) &&
+        device.startJ1939(ch1, { addresses: [0x90], bamIntervalMs: 10 }, messages => received1.push(...messages));
+    allPassed = assert(started && !device.startJ1939(ch0, {}, () => {}), 'startJ1939', '已启动', '启动失败') && allPassed;
+
+    const waitMessages = async (list: J1939Message[], count: number, timeoutMs: number) => {
+        const deadline = Date.now() + timeoutMs;
+        while (list.length < count && Date.now() < deadline) {
+            await sleep(10);
+        }
+        return list.length >= count;
+    };
+
+    // 单帧
+    const single = await device.j1939SendAsync(ch0, { pgn: 0xFEF1, priority: 6, sa: 0x80, data: [1, 2, 3, 4, 5, 6, 7, 8] });
+    const singleReceived = await waitMessages(received1, 1, 500);
+    allPassed = assert(
+        single.success && singleReceived && received1[0].pgn === 0xFEF1 && received1[0].transport === 'single',
+        'j1939SendAsync(单帧)',
+        `PGN 0x${received1[0]?.pgn.toString(16)}`,
+        `success=${single.success}, 接收${received1.length}条`
+    ) && allPassed;
+    received1.length = 0;
+
+    // BAM广播（DM1）
+    const dm1 = Array.from({ length: 30 }, (_, i) => (i * 7) & 0xFF);
+    const bam = await device.j1939SendAsync(ch1, { pgn: 0xFECA, sa: 0x90, data: dm1 });
+    const bamReceived = await waitMessages(received0, 1, 1000);
+    allPassed = assert(
+        bam.success && bamReceived && received0[0].transport === 'bam' && received0[0].sa === 0x90 &&
+            received0[0].data.length === dm1.length && received0[0].data.every((b, i) => b === dm1[i]),
+        'j1939SendAsync(BAM)',
+        `${bam.packets}包, 耗时${(bam.durationUs / 1000).toFixed(1)}ms`,
+        `success=${bam.success}, error=${bam.error}, 接收${received0.length}条`
+    ) && allPassed;
+    received0.length = 0;
+
+    // RTS/CTS点对点，最大长度
+    const calibration = Array.from({ length: 1785 }, (_, i) => (i * 31 + 5) & 0xFF);
+    const cmdt = await device.j1939SendAsync(ch0, { pgn: 0xEF00, sa: 0x80, da: 0x90, data: calibration });
+    const cmdtReceived = await waitMessages(received1, 1, 1000);
+    allPassed = assert(
+        cmdt.success && cmdtReceived && received1[0].transport === 'cmdt' && received1[0].da === 0x90 &&
+            received1[0].data.length === calibration.length && received1[0].data.every((b, i) => b === calibration[i]),
+        'j1939SendAsync(RTS/CTS 1785字节)',
+        `${cmdt.packets}包, 耗时${(cmdt.durationUs / 1000).toFixed(1)}ms`,
+        `success=${cmdt.success}, error=${cmdt.error}, 接收${received1.length}条`
+    ) && allPassed;
+
+    const stats = device.getJ1939Stats(ch1);
+    allPassed = assert(
+        stats !== null && stats.cmdtSessions >= 1 && stats.ctsSent > 0 && stats.activeSessions === 0,
+        'getJ1939Stats',
+        `CTS ${stats?.ctsSent}个, 最大响应${stats?.maxCtsResponseUs}us`,
+        JSON.stringify(stats)
+    ) && allPassed;
+
+    // 无应答的目标地址以T3超时结束
+    const orphan = await device.j1939SendAsync(ch0, { pgn: 0xEF00, sa: 0x80, da: 0x33, data: calibration.slice(0, 20) });
+    allPassed = assert(!orphan.success && !!orphan.error, 'j1939SendAsync(无应答)', orphan.error ?? '', '应返回失败') && allPassed;
+
+    allPassed = assert(
+        device.stopJ1939(ch0) && device.stopJ1939(ch1) && device.getJ1939Stats(ch0) === null,
+        'stopJ1939',
+        '已停止',
+        '停止失败'
+    ) && allPassed;
+    device.stopReceiveThread(ch0);
+    device.stopReceiveThread(ch1);
+
+    return allPassed;
+}
+
+async function testXcp(device: ZlgCanDevice, ch0: ChannelHandle, ch1: ChannelHandle): Promise<boolean> {
+    startGroup('XCP测量测试');
+    let allPassed = true;
+
+    // 通道1运行从站模拟器，通道0为主站
+    const simulator = new XcpSlaveSimulator(device, ch1, { masterId: 0x700, slaveId: 0x701, eventPeriodsMs: [10, 100] });
+    simulator.start();
+
+    const batches: XcpDaqBatch[] = [];
+    const started = device.startXcp(ch0, { masterId: 0x700, slaveId: 0x701, timeoutMs: 50 }, b => batches.push(...b));
+    allPassed = assert(started && !device.startXcp(ch0, { masterId: 0x700, slaveId: 0x701 }, () => {}),
+        'startXcp', '已启动', '启动失败') && allPassed;
+
+    const connect = await device.xcpConnectAsync(ch0);
+    allPassed = assert(
+        connect.success && connect.maxCto === 8 && ((connect.daqProperties ?? 0) & 0x01) !== 0,
+        'xcpConnectAsync',
+        `${connect.byteOrder}, MAX_DTO ${connect.maxDto}, 事件通道${connect.maxEventChannel}个, ${connect.durationUs}us`,
+        `error=${connect.error}`
+    ) && allPassed;
+    if (!connect.success) {
+        device.stopXcp(ch0);
+        simulator.stop();
+        device.stopReceiveThread(ch0);
+        return false;
+    }
+
+    // DOWNLOAD后SHORT_UPLOAD读回
+    const pattern = Array.from({ length: 20 }, (_, i) => (i * 13 + 1) & 0xFF);
+    const download = await device.xcpDownloadAsync(ch0, { address: 0x2000, data: pattern });
+    const upload = await device.xcpShortUploadAsync(ch0, { address: 0x2000, length: 6 });
+    allPassed = assert(
+        download.success && upload.success && simulator.readMemory(0x2000, pattern.length).every((b, i) => b === pattern[i]) &&
+            upload.data?.every((b, i) => b === pattern[i]) === true,
+        'xcpDownloadAsync/xcpShortUploadAsync',
+        `写入${pattern.length}字节, 读回[${upload.data?.join(',')}]`,
+        `download=${download.error}, upload=${upload.error}`
+    ) && allPassed;
+
+    const outOfRange = await device.xcpShortUploadAsync(ch0, { address: 0xFFFFFF00, length: 4 });
+    allPassed = assert(!outOfRange.success && outOfRange.errorCode === 0x22, 'xcpShortUploadAsync(越界)',
+        outOfRange.error ?? '', '应返回ERR_OUT_OF_RANGE') && allPassed;
+
+    // 10ms列表4个信号，100ms列表1个信号
+    const daq = await device.xcpStartDaqAsync(ch0, {
+        lists: [
+            {
+                eventChannel: 0,
+                signals: [
+                    { name: 'counter', address: XcpSimulatedVariables.COUNTER, type: 'uint32' },
+                    { name: 'sine', address: XcpSimulatedVariables.SINE, type: 'float32' },
+                    { name: 'ramp', address: XcpSimulatedVariables.RAMP, type: 'int16' },
+                    { name: 'toggle', address: XcpSimulatedVariables.TOGGLE, type: 'uint8' },
+                ],
+            },
+            {
+                eventChannel: 1,
+                signals: [{ name: 'counter', address: XcpSimulatedVariables.COUNTER, type: 'uint32' }],
+            },
+        ],
+    });
+    allPassed = assert(
+        daq.success && daq.lists?.length === 2,
+        'xcpStartDaqAsync',
+        `ODT: ${daq.lists?.map(l => `${l.odts}@PID${l.firstPid}`).join(', ')}, ${daq.durationUs}us`,
+        `error=${daq.error}`
+    ) && allPassed;
+
+    await sleep(1000);
+    const stop = await device.xcpStopDaqAsync(ch0);
+    await sleep(100);
+
+    const fast = batches.filter(b => b.listIndex === 0);
+    const slow = batches.filter(b => b.listIndex === 1);
+    const concat = <T extends number>(columns: ArrayLike<T>[]) => columns.flatMap(c => Array.from(c));
+    const counters = concat(fast.map(b => b.signals.counter as Uint32Array));
+    const sines = concat(fast.map(b => b.signals.sine as Float32Array));
+    const ramps = concat(fast.map(b => b.signals.ramp as Int16Array));
+    const timestamps = concat(fast.map(b => b.timestamps));
+
+    let gaps = 0;
+    let valueErrors = 0;
+    let backwards = 0;
+    for (let i = 0; i < counters.length; i++) {
+        if (i > 0 && counters[i] !== counters[i - 1] + 1) gaps++;
+        if (i > 0 && timestamps[i] < timestamps[i - 1]) backwards++;
+        if (Math.abs(sines[i] - Math.sin(counters[i] * 0.01)) > 1e-5) valueErrors++;
+        if (ramps[i] !== ((counters[i] * 7) << 16) >> 16) valueErrors++;
+    }
+    allPassed = assert(
+        stop.success && counters.length >= 50 && gaps === 0 && valueErrors === 0 && backwards === 0,
+        'DAQ 10ms列表',
+        `${counters.length}个样本/${fast.length}批, 跨度${((timestamps[timestamps.length - 1] - timestamps[0]) / 1000).toFixed(1)}ms`,
+        `样本${counters.length}, 跳号${gaps}, 值错误${valueErrors}, 时间戳回退${backwards}`
+    ) && allPassed;
+
+    const slowCount = slow.reduce((sum, b) => sum + b.count, 0);
+    allPassed = assert(slowCount >= 5, 'DAQ 100ms列表', `${slowCount}个样本`, `样本${slowCount}`) && allPassed;
+
+    const stats = device.getXcpStats(ch0);
+    allPassed = assert(
+        stats !== null && stats.samples === counters.length + slowCount && stats.unknownPids === 0,
+        'getXcpStats',
+        `命令${stats?.commands}条, DTO ${stats?.dtos}个, 丢弃${stats?.lostSamples}, 最长命令${stats?.maxCommandUs}us`,
+        JSON.stringify(stats)
+    ) && allPassed;
+
+    const disconnect = await device.xcpDisconnectAsync(ch0);
+    allPassed = assert(
+        disconnect.success && device.stopXcp(ch0) && device.getXcpStats(ch0) === null,
+        'stopXcp',
+        '已断开并停止',
+        `disconnect=${disconnect.error}`
+    ) && allPassed;
+
+    simulator.stop();
+    device.stopReceiveThread(ch0);
+
+    return allPassed;
+}
+
+async function testCanOpen(device: ZlgCanDevice, ch0: ChannelHandle, ch1: ChannelHandle): Promise<boolean> {
+    startGroup('CANopen测试');
+    let allPassed = true;
+
+    // 通道1运行节点5的模拟器，通道0为客户端
+    const nodeId = 5;
+    const simulator = new CanOpenNodeSimulator(device, ch1, { nodeId, heartbeatMs: 50 });
+
+    const events: CanOpenEvent[] = [];
+    const started = device.startCanOpen(ch0, { heartbeats: [{ nodeId, timeoutMs: 200 }] }, e => events.push(...e));
+    allPassed = assert(started && !device.startCanOpen(ch0, {}, () => {}), 'startCanOpen', '已启动', '启动失败') && allPassed;
+    simulator.start();
+    await sleep(150);
+
+    const bootup = events.find(e => e.type === 'nodeState' && e.nodeId === nodeId);
+    allPassed = assert(
+        bootup !== undefined && bootup.type === 'nodeState' && bootup.state === CanOpenNmtState.PRE_OPERATIONAL,
+        '启动报文/心跳',
+        `节点${nodeId}进入预运行状态`,
+        JSON.stringify(events)
+    ) && allPassed;
+
+    // 加速上传、分段上传（长度小于协议切换阈值）、块上传
+    const key = (object: number) => ({ nodeId, index: object >> 8, subIndex: object & 0xFF });
+    const deviceType = await device.canopenSdoUploadAsync(ch0, key(CanOpenSimulatedObjects.DEVICE_TYPE));
+    const deviceName = await device.canopenSdoUploadAsync(ch0, key(CanOpenSimulatedObjects.DEVICE_NAME));
+    const large = await device.canopenSdoUploadAsync(ch0, key(CanOpenSimulatedObjects.LARGE_DOMAIN));
+    const expected = simulator.readObject(CanOpenSimulatedObjects.LARGE_DOMAIN)!;
+    allPassed = assert(
+        deviceType.success && deviceType.transfer === 'expedited' && deviceType.data?.join(',') === '146,1,2,0' &&
+            deviceName.success && Buffer.from(deviceName.data ?? []).toString() === 'ZLG CANopen simulator' &&
+            large.success && large.transfer === 'block' && large.data?.length === expected.length &&
+            large.data.every((b, i) => b === expected[i]),
+        'canopenSdoUploadAsync',
+        `${deviceName.transfer} ${deviceName.data?.length}字节, ${large.transfer} ${large.data?.length}字节 ${large.durationUs}us`,
+        `deviceType=${deviceType.error}, deviceName=${deviceName.error}, large=${large.error}`
+    ) && allPassed;
+
+    const segmented = await device.canopenSdoUploadAsync(ch0, { ...key(CanOpenSimulatedObjects.LARGE_DOMAIN), mode: 'segmented' });
+    allPassed = assert(
+        segmented.success && segmented.transfer === 'segmented' && segmented.data?.length === expected.length,
+        'canopenSdoUploadAsync(segmented)',
+        `${segmented.durationUs}us, 块传输${large.durationUs}us`,
+        `error=${segmented.error}`
+    ) && allPassed;
+
+    // 块下载与分段下载
+    const payload = Array.from({ length: 1000 }, (_, i) => (i * 17 + 3) & 0xFF);
+    const blockDownload = await device.canopenSdoDownloadAsync(ch0, { ...key(CanOpenSimulatedObjects.WRITABLE_DOMAIN), data: payload });
+    const written = simulator.readObject(CanOpenSimulatedObjects.WRITABLE_DOMAIN)!;
+    const segmentedDownload = await device.canopenSdoDownloadAsync(ch0, {
+        ...key(CanOpenSimulatedObjects.WRITABLE_DOMAIN), data: payload.slice(0, 30), mode: 'segmented',
+    });
+    allPassed = assert(
+        blockDownload.success && blockDownload.transfer === 'block' && written.length === payload.length &&
+            written.every((b, i) => b === payload[i]) &&
+            segmentedDownload.success && simulator.readObject(CanOpenSimulatedObjects.WRITABLE_DOMAIN)!.length === 30,
+        'canopenSdoDownloadAsync',
+        `块下载${payload.length}字节 ${blockDownload.durationUs}us, 分段下载30字节`,
+        `block=${blockDownload.error}, segmented=${segmentedDownload.error}`
+    ) && allPassed;
+
+    const missing = await device.canopenSdoUploadAsync(ch0, { nodeId, index: 0x5FFF });
+    const readOnly = await device.canopenSdoDownloadAsync(ch0, { ...key(CanOpenSimulatedObjects.DEVICE_TYPE), data: [1, 2, 3, 4] });
+    allPassed = assert(
+        !missing.success && missing.abortCode === 0x06020000 && !readOnly.success && readOnly.abortCode === 0x06010002,
+        'SDO中止',
+        missing.error ?? '',
+        `missing=${missing.abortCode}, readOnly=${readOnly.abortCode}`
+    ) && allPassed;
+
+    const noNode = await device.canopenSdoUploadAsync(ch0, { nodeId: 0x7E, index: 0x1000 });
+    allPassed = assert(!noNode.success && noNode.timeout === true, 'SDO超时', noNode.error ?? '', '应超时') && allPassed;
+
+    // TPDO1：状态字 + 实际速度；只上报变化的值
+    allPassed = assert(
+        device.canopenConfigurePdo(ch0, [{
+            cobId: 0x180 + nodeId,
+            entries: [{ name: 'statusword', type: 'uint16' }, { name: 'velocity', type: 'int32' }],
+        }]) && !device.canopenConfigurePdo(ch0, [{ cobId: 0x181, entries: [{ name: 'x', type: 'float32', bitLength: 12 }] }]),
+        'canopenConfigurePdo',
+        '映射已编译',
+        '配置失败'
+    ) && allPassed;
+
+    events.length = 0;
+    allPassed = assert(device.canopenNmt(ch0, 'start', nodeId), 'canopenNmt(start)', '已发送', '发送失败') && allPassed;
+    await sleep(550);
+
+    const pdoEvents = events.filter(e => e.type === 'pdo');
+    const velocities = pdoEvents.filter(e => e.type === 'pdo' && 'velocity' in e.values)
+        .map(e => (e.type === 'pdo' ? e.values.velocity : NaN));
+    const operational = events.some(e => e.type === 'nodeState' && e.state === CanOpenNmtState.OPERATIONAL);
+    const pdoStats = device.getCanOpenStats(ch0);
+    allPassed = assert(
+        operational && pdoEvents.length > 0 && velocities.every((v, i) => i === 0 || v === velocities[i - 1] + 1) &&
+            pdoStats !== null && pdoStats.pdoUnchanged > pdoEvents.length,
+        'PDO变化上报',
+        `${pdoStats?.pdoFrames}帧, 上报${pdoEvents.length}次, 无变化${pdoStats?.pdoUnchanged}帧`,
+        `operational=${operational}, velocities=[${velocities.join(',')}]`
+    ) && allPassed;
+
+    // 紧急报文与心跳丢失/恢复
+    events.length = 0;
+    simulator.emergency(0x2310, 0x03, [0xAA]);
+    simulator.setHeartbeatPaused(true);
+    await sleep(350);
+    simulator.setHeartbeatPaused(false);
+    await sleep(150);
+    const emergency = events.find(e => e.type === 'emergency');
+    const lost = events.findIndex(e => e.type === 'heartbeatLost');
+    const recovered = events.findIndex(e => e.type === 'nodeState' && e.state === CanOpenNmtState.OPERATIONAL);
+    allPassed = assert(
+        emergency !== undefined && emergency.type === 'emergency' && emergency.errorCode === 0x2310 &&
+            emergency.errorRegister === 0x03 && lost >= 0 && recovered > lost,
+        '紧急报文/心跳丢失',
+        '紧急报文0x2310, 心跳丢失后恢复',
+        JSON.stringify(events.filter(e => e.type !== 'pdo'))
+    ) && allPassed;
+
+    device.canopenNmt(ch0, 'stop', nodeId);
+    const stats = device.getCanOpenStats(ch0);
+    allPassed = assert(
+        stats !== null && stats.sdoTransfers >= 8 && stats.sdoAborts === 2 && stats.sdoTimeouts === 1 && stats.crcErrors === 0,
+        'getCanOpenStats',
+        `SDO ${stats?.sdoTransfers}次/${stats?.sdoBytes}字节, 心跳${stats?.heartbeats}, 批次${stats?.batches}`,
+        JSON.stringify(stats)
+    ) && allPassed;
+
+    allPassed = assert(device.stopCanOpen(ch0) && device.getCanOpenStats(ch0) === null, 'stopCanOpen', '已停止', '停止失败') && allPassed;
+
+    simulator.stop();
+    device.stopReceiveThread(ch0);
+
+    return allPassed;
+}
+
+async function testRestBus(device: ZlgCanDevice, ch0: ChannelHandle, ch1: ChannelHandle): Promise<boolean> {
+    startGroup('残余总线仿真测试');
+    let allPassed = true;
+
+    const crc8 = (bytes: number[]) => {
+        let crc = 0xFF;
+        for (const byte of bytes) {
+            crc ^= byte;
+            for (let bit = 0; bit < 8; bit++) {
+                crc = crc & 0x80 ? ((crc << 1) ^ 0x1D) & 0xFF : (crc << 1) & 0xFF;
+            }
+        }
+        return crc ^ 0xFF;
+    };
+
+    device.clearBuffer(ch1);
+    const table = device.startRestBus(ch0, [
+        {
+            name: 'engine',
+            id: 0x120,
+            length: 8,
+            periodMs: 10,
+            counter: { startBit: 8, bitLength: 4 },
+            checksum: { type: 'crc8', byte: 0 },
+            signals: [
+                { name: 'rpm', startBit: 16, bitLength: 16, factor: 0.25, initial: 800 },
+                { name: 'temp', startBit: 32, bitLength: 8, offset: -40, initial: 90 },
+            ],
+        },
+        {
+            name: 'chassis',
+            id: 0x240,
+            fd: true,
+            length: 16,
+            periodMs: 20,
+            offsetMs: 5,
+            signals: [{ name: 'speed', startBit: 7, bitLength: 16, byteOrder: 'motorola', factor: 0.01 }],
+        },
+        { name: 'status', id: 0x3A0, data: [1, 2, 3, 4, 5, 6, 7, 0], periodMs: 50, checksum: { type: 'sum8', byte: 7 } },
+    ]);
+    allPassed = assert(
+        table !== null && table.names.join(',') === 'engine.rpm,engine.temp,chassis.speed' && table.get('engine.rpm') === 800 &&
+            device.startRestBus(ch0, []) === null,
+        'startRestBus',
+        `信号表: ${table?.names.join(', ')}`,
+        '启动失败'
+    ) && allPassed;
+    if (!table) {
+        return false;
+    }
+
+    let invalid = '';
+    try {
+        device.startRestBus(ch1, [{ id: 0x100, periodMs: 10, signals: [{ name: 'x', startBit: 60, bitLength: 8 }] }]);
+    } catch (e) {
+        invalid = (e as Error).message;
+    }
+    allPassed = assert(invalid !== '' && device.getRestBusStats(ch1) === null, '无效报文', invalid, '应抛出TypeError') && allPassed;
+
+    const classic: ReceivedFrame[] = [];
+    const fd: ReceivedFDFrame[] = [];
+    const collect = async (ms: number) => {
+        const end = Date.now() + ms;
+        while (Date.now() < end) {
+            classic.push(...device.receive(ch1, 200, 0));
+            fd.push(...device.receiveFD(ch1, 200, 0));
+            await sleep(10);
+        }
+    };
+
+    await collect(500);
+    const missing = table.update({ 'engine.rpm': 3000.5, 'engine.temp': -10, 'chassis.speed': 123.45, 'engine.unknown': 1 });
+    device.restBusSetEnabled(ch0, 'status', false);
+    await collect(500);
+    const stats = device.getRestBusStats(ch0);
+    const stopped = device.stopRestBus(ch0);
+    await collect(50);
+
+    const engine = classic.filter(f => f.id === 0x120);
+    const chassis = fd.filter(f => f.id === 0x240);
+    const status = classic.filter(f => f.id === 0x3A0);
+    let counterErrors = 0;
+    let checksumErrors = 0;
+    engine.forEach((f, i) => {
+        if (i > 0 && (f.data[1] & 0x0F) !== (((engine[i - 1].data[1] & 0x0F) + 1) & 0x0F)) counterErrors++;
+        if (crc8(f.data.slice(1)) !== f.data[0]) checksumErrors++;
+    });
+    allPassed = assert(
+        engine.length >= 90 && engine.length <= 102 && chassis.length >= 45 && chassis.length <= 52 &&
+            counterErrors === 0 && checksumErrors === 0,
+        '周期/计数器/CRC',
+        `10ms报文${engine.length}帧, 20ms报文${chassis.length}帧`,
+        `engine=${engine.length}, chassis=${chassis.length}, 计数器错误${counterErrors}, 校验错误${checksumErrors}`
+    ) && allPassed;
+
+    const last = engine[engine.length - 1];
+    const lastSpeed = chassis[chassis.length - 1];
+    allPassed = assert(
+        missing.join(',') === 'engine.unknown' && engine[0].data[2] + engine[0].data[3] * 256 === 3200 &&
+            last !== undefined && last.data[2] + last.data[3] * 256 === 12002 && last.data[4] === 30 &&
+            lastSpeed !== undefined && lastSpeed.data[0] * 256 + lastSpeed.data[1] === 12345,
+        '信号表更新',
+        `rpm原始值${last?.data[2] + last?.data[3] * 256}, speed原始值${lastSpeed?.data[0] * 256 + lastSpeed?.data[1]}`,
+        `missing=${missing}, 首帧[${engine[0]?.data}], 末帧[${last?.data}]`
+    ) && allPassed;
+
+    allPassed = assert(
+        status.length >= 9 && status.length <= 11 && status.every(f => f.data[7] === (1 + 2 + 3 + 4 + 5 + 6 + 7)),
+        'restBusSetEnabled/sum8',
+        `停用前${status.length}帧`,
+        `status=${status.length}`
+    ) && allPassed;
+
+    allPassed = assert(
+        stats !== null && stats.frames <= engine.length + chassis.length + status.length && stats.failedFrames === 0 &&
+            stats.transmitCalls <= stats.ticks * 2 && stats.signalSnapshots === 1,
+        'getRestBusStats',
+        `${stats?.ticks}个刻度, ${stats?.transmitCalls}次发送调用, 最大延迟${stats?.maxLatenessUs}us, 单刻度最多${stats?.maxFramesPerTick}帧`,
+        JSON.stringify(stats)
+    ) && allPassed;
+
+    allPassed = assert(stopped && device.getRestBusStats(ch0) === null, 'stopRestBus', '已停止', '停止失败') && allPassed;
+
+    return allPassed;
+}
+
+// ============== E2E保护测试 ==============
+
+async function testE2e(device: ZlgCanDevice, ch0: ChannelHandle, ch1: ChannelHandle): Promise<boolean> {
+    startGroup('E2E保护测试');
+    let allPassed = true;
+
+    // CRC16 CCITT（初值0xFFFF），与P05一致
+    const crc16 = (bytes: number[], crc = 0xFFFF) => {
+        for (const byte of bytes) {
+            crc ^= byte << 8;
+            for (let bit = 0; bit < 8; bit++) {
+                crc = crc & 0x8000 ? ((crc << 1) ^ 0x1021) & 0xFFFF : (crc << 1) & 0xFFFF;
+            }
+        }
+        return crc;
+    };
+    // CRC8 SAE J1850（寄存器初值0x00、无结果异或），与P01一致
+    const crc8 = (bytes: number[]) => {
+        let crc = 0;
+        for (const byte of bytes) {
+            crc ^= byte;
+            for (let bit = 0; bit < 8; bit++) {
+                crc = crc & 0x80 ? ((crc << 1) ^ 0x1D) & 0xFF : (crc << 1) & 0xFF;
+            }
+        }
+        return crc;
+    };
+
+    const p05 = { id: 0x150, profile: 'p05' as const, dataId: 0x1234 };
+    const p07 = { id: 0x250, profile: 'p07' as const, dataId: 0xA5A55A5A, offset: 4 };
+    const p01 = { id: 0x160, profile: 'p01' as const, dataId: 0x55 };
+
+    device.clearBuffer(ch1);
+    const failures: E2eFailure[] = [];
+    const started = device.startE2eCheck(ch1, [p05, p07, p01], batch => failures.push(...batch));
+    let invalid = '';
+    try {
+        device.setE2eProtection(ch0, [{ id: 0x170, profile: 'p02' }]);
+    } catch (e) {
+        invalid = (e as Error).message;
+    }
+    allPassed = assert(
+        started && !device.startE2eCheck(ch1, []) && invalid !== '',
+        'startE2eCheck',
+        '已启动',
+        `started=${started}, invalid=${invalid}`
+    ) && allPassed;
+
+    const table = device.startRestBus(ch0, [
+        { name: 'p05', id: p05.id, length: 8, periodMs: 10, e2e: p05, signals: [{ name: 'v', startBit: 24, bitLength: 16, initial: 100 }] },
+        { name: 'p07', id: p07.id, fd: true, length: 32, periodMs: 10, offsetMs: 5, e2e: p07 },
+    ]);
+
+    // transmit路径：前3帧加保护，取消保护后的第4帧CRC错误
+    device.setE2eProtection(ch0, [p01]);
+    for (let i = 0; i < 3; i++) {
+        device.transmit(ch0, { id: 0x160, dlc: 8, data: [0, 0, i, 0, 0, 0, 0, 0] });
+        await sleep(20);
+    }
+    device.setE2eProtection(ch0, null);
+    device.transmit(ch0, { id: 0x160, dlc: 8, data: [0, 3, 3, 0, 0, 0, 0, 0] });
+
+    await sleep(200);
+    table?.set('p05.v', 500);
+    await sleep(200);
+    device.stopRestBus(ch0);
+    await sleep(50);
+
+    const received = device.receive(ch1, 1000, 0);
+    device.receiveFD(ch1, 1000, 0);
+    const frames = received.filter(f => f.id === p05.id);
+    const crcErrors = frames.filter(f => crc16([0x34, 0x12], crc16(f.data.slice(2))) !== (f.data[0] | (f.data[1] << 8))).length;
+    const manual = received.filter(f => f.id === 0x160);
+    const p01CrcOk = manual.slice(0, 3).every(f => f.data[0] === crc8([p01.dataId, 0x00, ...f.data.slice(1)]));
+    allPassed = assert(
+        frames.length >= 30 && crcErrors === 0 && manual.length === 4 && p01CrcOk &&
+            manual.slice(0, 3).every((f, i) => (f.data[1] & 0x0F) === i),
+        '发送保护',
+        `P05报文${frames.length}帧, CRC16/P01 CRC8与本地计算一致`,
+        `p05=${frames.length}, crcErrors=${crcErrors}, 0x160=${manual.map(f => f.data.join(' ')).join(' | ')}`
+    ) && allPassed;
+
+    const stats = device.getE2eStats(ch1);
+    const byId = (id: number) => stats?.find(s => s.id === id);
+    const s05 = byId(p05.id);
+    const s07 = byId(p07.id);
+    const s01 = byId(p01.id);
+    allPassed = assert(
+        s05 !== undefined && s05.ok === frames.length && s05.wrongCrc === 0 && s05.wrongSequence === 0 &&
+            s07 !== undefined && s07.ok >= 30 && s07.wrongCrc === 0 && s07.wrongDataId === 0 && s07.badLength === 0 &&
+            s01 !== undefined && s01.ok === 3 && s01.wrongCrc === 1 && s01.lastStatus === 'wrongCrc',
+        'getE2eStats',
+        `P05 ${s05?.ok}帧, P07 ${s07?.ok}帧, P01 ${s01?.ok}帧正确/${s01?.wrongCrc}帧CRC错误`,
+        JSON.stringify(stats)
+    ) && allPassed;
+
+    allPassed = assert(
+        failures.length === 1 && failures[0].id === 0x160 && failures[0].status === 'wrongCrc' && failures[0].counter === 3,
+        '失败回调',
+        `${failures.length}个失败事件`,
+        JSON.stringify(failures)
+    ) && allPassed;
+
+    const stopped = device.stopE2eCheck(ch1);
+    allPassed = assert(stopped && device.getE2eStats(ch1) === null, 'stopE2eCheck', '已停止', '停止失败') && allPassed;
+
+    return allPassed;
+}
+
+// ============== 帧流缓冲测试 ==============
+
+async function testReceiveStream(device: ZlgCanDevice, ch0: ChannelHandle, ch1: ChannelHandle): Promise<boolean> {
+    startGroup('帧流缓冲测试');
+    let allPassed = true;
+
+    device.startReceiveThread(ch1);
+    device.receive(ch1, 10000, 0);
+    device.receiveFD(ch1, 10000, 0);
+    let wideNotified = 0;
+    let narrowNotified = 0;
+    const wide = device.openReceiveStream(ch1, { capacity: 1000 }, () => wideNotified++);
+    const narrow = device.openReceiveStream(ch1, { capacity: 5, dropPolicy: 'dropNewest' }, () => narrowNotified++);
+    allPassed = assert(
+        wide !== null && narrow !== null && wide !== narrow &&
+            !device.armReceiveStream(ch1, wide) && !device.armReceiveStream(ch1, narrow),
+        'openReceiveStream',
+        `帧流${wide}/${narrow}已打开并登记通知`,
+        `wide=${wide}, narrow=${narrow}`
+    ) && allPassed;
+    if (wide === null || narrow === null) {
+        return false;
+    }
+
+    const FRAME_COUNT = 20;
+    for (let i = 0; i < FRAME_COUNT; i++) {
+        device.transmit(ch0, { id: 0x3D0 + i, dlc: 1, data: [i] });
+    }
+    await sleep(100);
+
+    // 各帧流与receive互不分取，均收到全部帧
+    const wideBatch = device.readReceiveStream(ch1, wide, 100);
+    const narrowBatch = device.readReceiveStream(ch1, narrow, 100);
+    const shared = device.receive(ch1, 100, 0).filter(f => f.id >= 0x3D0 && f.id < 0x3D0 + FRAME_COUNT);
+    allPassed = assert(
+        wideBatch !== null && wideBatch.frames.length === FRAME_COUNT && wideBatch.dropped === 0 &&
+            wideBatch.frames.every((f, i) => f.id === 0x3D0 + i) && shared.length === FRAME_COUNT,
+        '独立缓冲',
+        `帧流和receive各收到${FRAME_COUNT}帧`,
+        `stream=${wideBatch?.frames.length}, dropped=${wideBatch?.dropped}, receive=${shared.length}`
+    ) && allPassed;
+    allPassed = assert(
+        narrowBatch !== null && narrowBatch.frames.length === 5 && narrowBatch.dropped === FRAME_COUNT - 5 &&
+            narrowBatch.frames.every((f, i) => f.id === 0x3D0 + i),
+        '按帧流丢帧',
+        `容量5的dropNewest帧流保留最早5帧，丢弃${narrowBatch?.dropped}帧`,
+        `frames=${narrowBatch?.frames.map(f => f.id.toString(16)).join(',')}, dropped=${narrowBatch?.dropped}`
+    ) && allPassed;
+    allPassed = assert(wideNotified === 1 && narrowNotified === 1, '就绪通知', '每个帧流通知一次',
+        `wide=${wideNotified}, narrow=${narrowNotified}`) && allPassed;
+
+    const closed = device.closeReceiveStream(ch1, wide);
+    allPassed = assert(
+        closed && !device.closeReceiveStream(ch1, wide) && device.readReceiveStream(ch1, wide, 1) === null,
+        'closeReceiveStream',
+        '已关闭',
+        `closed=${closed}`
+    ) && allPassed;
+
+    // 接收线程停止时未关闭的帧流再收到一次通知，随后读取返回null
+    device.stopReceiveThread(ch1);
+    await sleep(50);
+    allPassed = assert(
+        narrowNotified === 2 && wideNotified === 1 && device.readReceiveStream(ch1, narrow, 1) === null,
+        '接收线程停止',
+        '帧流收到结束通知',
+        `wide=${wideNotified}, narrow=${narrowNotified}`
+    ) && allPassed;
+
+    return allPassed;
+}
+
+// ============== 时间线记录测试 ==============
+
+async function testTrace(device: ZlgCanDevice, ch0: ChannelHandle, ch1: ChannelHandle): Promise<boolean> {
+    startGroup('时间线记录测试');
+    let allPassed = true;
+
+    const recorder = TraceRecorder.getInstance();
+    device.clearBuffer(ch1);
+    recorder.start(64, 1024);
+    const spanStart = recorder.now();
+    for (let i = 0; i < 3; i++) {
+        device.transmit(ch0, { id: 0x3C0 + i, dlc: 2, data: [i, 0xAA] });
+    }
+    await sleep(20);
+    const received = device.receive(ch1, 10, 0);
+    recorder.span('tcans', 'executor', spanStart, { frames: received.length });
+    recorder.instant('marker', 'executor');
+    recorder.stop();
+
+    const file = path.join(os.tmpdir(), `zlgcan-trace-${process.pid}.json`);
+    const result = recorder.exportChromeTrace(file);
+    let trace: { traceEvents?: unknown; displayTimeUnit?: unknown } = {};
+    let parseError = '';
+    try {
+        trace = JSON.parse(fs.readFileSync(file, 'utf8'));
+    } catch (e) {
+        parseError = (e as Error).message;
+    } finally {
+        fs.rmSync(file, { force: true });
+    }
+
+    type TraceEvent = { name?: unknown; cat?: unknown; ph?: unknown; ts?: unknown; dur?: unknown; pid?: unknown; tid?: unknown; s?: unknown };
+    const events = Array.isArray(trace.traceEvents) ? trace.traceEvents as TraceEvent[] : [];
+    const malformed = events.filter(e =>
+        typeof e.name !== 'string' || typeof e.cat !== 'string' || typeof e.pid !== 'number' ||
+        typeof e.tid !== 'number' || typeof e.ts !== 'number' || !Number.isFinite(e.ts) ||
+        !['X', 'i', 'M'].includes(e.ph as string) ||
+        (e.ph === 'X' && (typeof e.dur !== 'number' || e.dur < 0)) ||
+        (e.ph === 'i' && e.s !== 't'));
+    allPassed = assert(
+        parseError === '' && trace.displayTimeUnit === 'ns' && events.length === result.events && malformed.length === 0,
+        'Chrome trace格式',
+        `${events.length}个事件均为合法的X/i/M事件`,
+        parseError || `events=${events.length}/${result.events}, malformed=${JSON.stringify(malformed.slice(0, 3))}`
+    ) && allPassed;
+
+    const named = (name: string, ph: string) => events.filter(e => e.name === name && e.ph === ph);
+    const transmits = named('ZCAN_Transmit', 'X');
+    const jsTransmits = named('js.transmit', 'X');
+    const span = named('tcans', 'X')[0];
+    const jsTid = named('thread_name', 'M').find(e => (e as { args?: { name?: string } }).args?.name === 'js-main')?.tid;
+    allPassed = assert(
+        result.nativeAvailable && transmits.length === 3 && jsTransmits.length === 3 && span !== undefined &&
+            named('marker', 'i').length === 1 && jsTransmits.every(e => e.tid === jsTid) &&
+            transmits.every(e => (e.ts as number) >= (span.ts as number) &&
+                (e.ts as number) + (e.dur as number) <= (span.ts as number) + (span.dur as number) + 1),
+        '原生调用事件',
+        `${transmits.length}次ZCAN_Transmit落在JS span内，与JS事件同一时间线`,
+        `native=${result.nativeAvailable}, transmit=${transmits.length}, js=${jsTransmits.length}, span=${JSON.stringify(span)}`
+    ) && allPassed;
+
+    return allPassed;
+}
+
+// ============== 设备关闭测试 ==============
+
+function testCloseDevice(device: ZlgCanDevice): boolean {
+    startGroup('设备关闭测试');
+    let allPassed = true;
+
+    const closeResult = device.closeDevice();
+    allPassed = assert(closeResult, 'closeDevice()', '设备关闭成功', '设备关闭失败') && allPassed;
+
+    // 验证关闭后isDeviceOnLine返回false
+    const onlineAfterClose = device.isDeviceOnLine();
+    allPassed = assert(!onlineAfterClose, 'closeDevice后isDeviceOnLine', '返回false', '应返回false') && allPassed;
+
+    return allPassed;
+}
+
+// ============== 打印测试摘要 ==============
+
+function printSummary(): void {
+    console.log('\n' + '='.repeat(60));
+    console.log('                    测试摘要');
+    console.log('='.repeat(60));
+
+    let totalPassed = 0;
+    let totalFailed = 0;
+
+    for (const group of testGroups) {
+        const passed = group.results.filter(r => r.passed).length;
+        const failed = group.results.filter(r => !r.passed).length;
+        totalPassed += passed;
+        totalFailed += failed;
+
+        const status = failed === 0 ? '\x1b[32m✓\x1b[0m' : '\x1b[31m✗\x1b[0m';
+        console.log(`  ${status} ${group.name}: ${passed}/${group.results.length} 通过`);
+
+        if (failed > 0) {
+            for (const result of group.results) {
+                if (!result.passed) {
+                    console.log(`      \x1b[31m✗\x1b[0m ${result.name}: ${result.message}`);
+                }
+            }
+        }
+    }
+
+    console.log('-'.repeat(60));
+    const allPassed = totalFailed === 0;
+    const summaryColor = allPassed ? '\x1b[32m' : '\x1b[31m';
+    console.log(`  ${summaryColor}总计: ${totalPassed} 通过, ${totalFailed} 失败, 共 ${totalPassed + totalFailed} 项测试\x1b[0m`);
+    console.log('='.repeat(60));
+
+    if (!allPassed) {
+        process.exit(1);
+    }
+}
+
+// ============== 主测试流程 ==============
+
+async function runAllTests(): Promise<void> {
+    console.log('='.repeat(60));
+    console.log('        ZLG CAN 完整接口测试 - USBCANFD-200U');
+    console.log('        连接拓扑: 通道0 <-> 通道1');
+    console.log('='.repeat(60));
+    console.log(`设备类型ID: ${TEST_CONFIG.deviceType}`);
+    console.log(`设备索引: ${TEST_CONFIG.deviceIndex}`);
+
+    // 辅助函数测试 (不需要设备)
+    testHelperFunctions();
+
+    // 常量测试 (不需要设备)
+    testConstants();
+
+    // 设备实例化测试
+    testDeviceInstantiation();
+
+    // 创建设备实例
+    const device = new ZlgCanDevice();
+
+    // 设备操作测试
+    const deviceOk = await testDeviceOperations(device);
+    if (!deviceOk) {
+        console.log('\n\x1b[31m设备打开失败，终止后续测试\x1b[0m');
+        printSummary();
+        return;
+    }
+
+    // 属性操作测试
+    await testPropertyOperations(device);
+
+    // 通道操作测试
+    const channels = await testChannelOperations(device);
+    if (!channels) {
+        console.log('\n\x1b[31m通道初始化失败，终止后续测试\x1b[0m');
+        testCloseDevice(device);
+        printSummary();
+        return;
+    }
+
+    // CAN帧收发测试
+    await testCanTransmitReceive(device, channels.ch0, channels.ch1);
+
+    // CANFD帧收发测试
+    await testCanFDTransmitReceive(device, channels.ch0, channels.ch1);
+
+    // 双向通信测试
+    await testBidirectionalCommunication(device, channels.ch0, channels.ch1);
+
+    // DataObj收发测试
+    await testDataObjTransmitReceive(device, channels.ch0, channels.ch1);
+
+    // 边界条件测试
+    await testBoundaryConditions(device, channels.ch0, channels.ch1);
+
+    // 扩展帧测试
+    await testExtendedFrames(device, channels.ch0, channels.ch1);
+
+    // CANFD BRS标志测试
+    await testCanFDBRS(device, channels.ch0, channels.ch1);
+
+    // 压力测试
+    await testStress(device, channels.ch0, channels.ch1);
+
+    // 双向并发测试
+    await testBidirectionalConcurrent(device, channels.ch0, channels.ch1);
+
+    // 错误处理测试
+    await testErrorHandling(device, channels.ch0, channels.ch1);
+
+    // 时间戳测试
+    await testTimestamp(device, channels.ch0, channels.ch1);
+
+    // CAN传统模式兼容测试
+    await testCanCompatibility(device, channels.ch0, channels.ch1);
+
+    // 性能基准测试
+    await testPerformanceBenchmark(device, channels.ch0, channels.ch1);
+
+    // 单通道异步并发测试
+    await testAsyncConcurrentSingleChannel(device, channels.ch0, channels.ch1);
+
+    // 双通道异步并发测试
+    await testAsyncConcurrentDualChannel(device, channels.ch0, channels.ch1);
+
+    // 通道复位测试
+    await testChannelReset(device, channels.ch0, channels.ch1);
+
+    // 通道健康监视测试
+    await testHealthMonitor(device, channels.ch0, channels.ch1);
+
+    // 设备热插拔监视测试
+    await testDeviceMonitor(device, channels.ch0, channels.ch1);
+
+    // 异步设备操作测试
+    await testAsyncDeviceOperations(device, channels.ch0, channels.ch1);
+
+    // 通道静默测试
+    await testQuiesce(device, channels.ch0, channels.ch1);
+
+    // UDS诊断测试
+    await testUdsRequest(device);
+
+    // ISO-TP传输层测试
+    await testIsoTp(device, channels.ch0, channels.ch1);
+
+    // 在线烧写测试
+    await testFlash(device, channels.ch0, channels.ch1);
+
+    // LIN通道测试
+    await testLin(device);
+
+    // DoIP诊断测试
+    await testDoip(device);
+
+    // J1939传输协议测试
+    await testJ1939(device, channels.ch0, channels.ch1);
+
+    // XCP测量测试
+    await testXcp(device, channels.ch0, channels.ch1);
+
+    // CANopen测试
+    await testCanOpen(device, channels.ch0, channels.ch1);
+
+    // 残余总线仿真测试
+    await testRestBus(device, channels.ch0, channels.ch1);
+
+    // E2E保护测试
+    await testE2e(device, channels.ch0, channels.ch1);
+
+    // 帧流缓冲测试
+    await testReceiveStream(device, channels.ch0, channels.ch1);
+
+    // 时间线记录测试
+    await testTrace(device, channels.ch0, channels.ch1);
 
     // 设备关闭测试
     testCloseDevice(device);
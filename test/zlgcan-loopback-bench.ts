@@ -0,0 +1,507 @@
+/**
+ * ZLG CAN 端到端回环延迟与吞吐基准
+ * 连接拓扑: 通道0 -> 通道1（仿真总线、虚拟设备或物理连接的两通道）
+ * 收发路径与TesterExecutor一致: CanDeviceManager/ZlgCanDriver创建设备，ICanChannel逐帧transmit，
+ * 定时器轮询receive(100, 0)（默认10ms，与执行器相同）
+ *
+ * 测量内容:
+ *   latency      逐帧往返: 发送调用 -> JS收到帧的单向延迟p50/p99/p99.9；
+ *                按硬件时间戳拆分为发送->总线（帧结束）和总线->应用两段
+ *   throughput   CAN（8字节）与CANFD（64字节，BRS）满负载持续发送的帧率、总线负载和每帧CPU时间
+ *
+ * 运行: npm run bench:loopback -- [选项]
+ *   --backend auto|sim|socketcan|virtual|hw  默认auto（Windows先尝试硬件，失败用虚拟设备；其余平台用仿真）
+ *   --device-type <n> --device-index <n>    硬件设备类型与索引，默认USBCANFD_200U/0
+ *   --abit <kbps> --dbit <kbps>             仲裁段/数据段波特率，默认500/2000
+ *   --pings <n>                             延迟测量帧数，默认2000
+ *   --duration <s>                          每项吞吐测量时长，默认5
+ *   --poll-ms <ms>                          接收轮询间隔，默认10；0为setImmediate连续轮询
+ *   --rx-batch <n>                          每次轮询的最大接收帧数，默认100
+ *   --only latency|throughput               只运行一类测量
+ *   --json <文件|->                          输出JSON结果（-为标准输出）
+ *
+ * 硬件时间戳与主机时钟的偏移未知，取总线->应用段的最小值为0对齐，
+ * 因此两段拆分反映的是相对最优投递的增量，二者之和等于端到端延迟。
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import type { ICanChannel, ICanDevice, IReceivedFrame, IReceivedFDFrame } from '../src/devices';
+
+// ==================== 配置 ====================
+
+type Backend = 'auto' | 'sim' | 'socketcan' | 'virtual' | 'hw';
+
+interface LoopbackOptions {
+    backend: Backend;
+    deviceType: number;
+    deviceIndex: number;
+    abitKbps: number;
+    dbitKbps: number;
+    pings: number;
+    durationS: number;
+    pollMs: number;
+    rxBatch: number;
+    only: 'latency' | 'throughput' | null;
+    json: string | null;
+}
+
+function parseArgs(argv: string[]): LoopbackOptions {
+    const options: LoopbackOptions = {
+        backend: 'auto',
+        deviceType: 41,     // ZCAN_USBCANFD_200U
+        deviceIndex: 0,
+        abitKbps: 500,
+        dbitKbps: 2000,
+        pings: 2000,
+        durationS: 5,
+        pollMs: 10,
+        rxBatch: 100,
+        only: null,
+        json: null,
+    };
+    for (let i = 0; i < argv.length; i++) {
+        const flag = argv[i];
+        const value = argv[++i];
+        switch (flag) {
+            case '--backend': options.backend = value as Backend; break;
+            case '--device-type': options.deviceType = Number(value); break;
+            case '--device-index': options.deviceIndex = Number(value); break;
+            case '--abit': options.abitKbps = Number(value); break;
+            case '--dbit': options.dbitKbps = Number(value); break;
+            case '--pings': options.pings = Math.max(1, Number(value)); break;
+            case '--duration': options.durationS = Math.max(0.5, Number(value)); break;
+            case '--poll-ms': options.pollMs = Math.max(0, Number(value)); break;
+            case '--rx-batch': options.rxBatch = Math.max(1, Number(value)); break;
+            case '--only': options.only = value as 'latency' | 'throughput'; break;
+            case '--json': options.json = value; break;
+            default: throw new Error(`未知参数: ${flag}`);
+        }
+    }
+    return options;
+}
+
+const options = parseArgs(process.argv.slice(2));
+
+// 原生模块在加载时按ZLGCAN_BACKEND选择，须在require之前设置
+if (options.backend === 'sim' || options.backend === 'socketcan') {
+    process.env.ZLGCAN_BACKEND = options.backend;
+}
+/* eslint-disable @typescript-eslint/no-require-imports */
+const devices = require('../src/devices') as typeof import('../src/devices');
+const zlgcan = require('../src/zlgcan') as typeof import('../src/zlgcan');
+/* eslint-enable @typescript-eslint/no-require-imports */
+
+const jsonToStdout = options.json === '-';
+const log = jsonToStdout ? console.error : console.log;
+
+// ==================== 工具 ====================
+
+function nowUs(): number {
+    return Number(process.hrtime.bigint()) / 1000;
+}
+
+function sleep(ms: number): Promise<void> {
+    return new Promise(resolve => setTimeout(resolve, ms));
+}
+
+function yieldMacrotask(): Promise<void> {
+    return new Promise(resolve => setImmediate(resolve));
+}
+
+interface Percentiles {
+    count: number;
+    min: number;
+    p50: number;
+    p99: number;
+    p999: number;
+    max: number;
+    mean: number;
+}
+
+function percentiles(samples: number[]): Percentiles {
+    const sorted = [...samples].sort((a, b) => a - b);
+    const at = (q: number) => sorted.length ? sorted[Math.min(sorted.length - 1, Math.floor(q * sorted.length))] : NaN;
+    const sum = sorted.reduce((acc, v) => acc + v, 0);
+    return {
+        count: sorted.length,
+        min: sorted.length ? sorted[0] : NaN,
+        p50: at(0.5),
+        p99: at(0.99),
+        p999: at(0.999),
+        max: sorted.length ? sorted[sorted.length - 1] : NaN,
+        mean: sorted.length ? sum / sorted.length : NaN,
+    };
+}
+
+/**
+ * 标称帧时长（微秒），不含动态填充位，作为总线负载的下限估计
+ * 经典帧（标准ID）: 47 + 8n位；CANFD（标准ID，BRS）: 仲裁段17位+尾部13位按仲裁段速率，
+ * 数据段ESI/DLC/数据/填充计数/CRC及其固定填充位按数据段速率
+ */
+function nominalFrameUs(fd: boolean, len: number, abitKbps: number, dbitKbps: number): number {
+    if (!fd) {
+        return (47 + 8 * len) * 1000 / abitKbps;
+    }
+    const crcBits = len <= 16 ? 17 : 21;
+    const dataBits = 1 + 4 + 8 * len + 5 + crcBits + Math.ceil(crcBits / 4);
+    return 30 * 1000 / abitKbps + dataBits * 1000 / dbitKbps;
+}
+
+// ==================== 接收轮询 ====================
+
+interface RxFrame {
+    id: number;
+    data: number[];
+    /** 硬件时间戳（微秒，设备时钟） */
+    timestamp: number;
+    /** 轮询取回时的主机时间（微秒） */
+    hostUs: number;
+}
+
+/**
+ * 与TesterExecutor.pollReceiveMessages相同的轮询方式：定时器中非阻塞receive/receiveFD
+ */
+class ReceivePoller {
+    private timer: ReturnType<typeof setInterval> | null = null;
+    private running = false;
+    private busy = false;
+
+    constructor(
+        private readonly channel: ICanChannel,
+        private readonly fd: boolean,
+        private readonly pollMs: number,
+        private readonly batch: number,
+        private readonly sink: (frames: RxFrame[]) => void,
+    ) {}
+
+    start(): void {
+        this.running = true;
+        if (this.pollMs > 0) {
+            this.timer = setInterval(() => { void this.poll(); }, this.pollMs);
+        } else {
+            const loop = async () => {
+                while (this.running) {
+                    await this.poll();
+                    await yieldMacrotask();
+                }
+            };
+            void loop();
+        }
+    }
+
+    stop(): void {
+        this.running = false;
+        if (this.timer) {
+            clearInterval(this.timer);
+            this.timer = null;
+        }
+    }
+
+    async poll(): Promise<void> {
+        if (this.busy) {
+            return;
+        }
+        this.busy = true;
+        try {
+            const frames: Array<IReceivedFrame | IReceivedFDFrame> = this.fd
+                ? await this.channel.receiveFD(this.batch, 0)
+                : await this.channel.receive(this.batch, 0);
+            if (frames.length > 0) {
+                const hostUs = nowUs();
+                this.sink(frames.map(f => ({ id: f.id, data: f.data, timestamp: f.timestamp, hostUs })));
+            }
+        } finally {
+            this.busy = false;
+        }
+    }
+}
+
+// ==================== 设备 ====================
+
+interface Loopback {
+    backend: string;
+    device: ICanDevice;
+    tx: ICanChannel;
+    rx: ICanChannel;
+}
+
+async function openDevice(type: number, index: number): Promise<ICanDevice | null> {
+    const manager = devices.CanDeviceManager.getInstance();
+    if (!manager.getDriver('zlgcan')) {
+        const driver = new devices.ZlgCanDriver();
+        await driver.initialize();
+        manager.registerDriver(driver);
+    }
+    const device = manager.createDeviceByVendorCode(type, 'zlgcan');
+    if (await device.open(index)) {
+        return device;
+    }
+    device.close();
+    return null;
+}
+
+async function openLoopback(): Promise<Loopback> {
+    let backend: string = options.backend;
+    let device: ICanDevice | null = null;
+    const simulated = process.env.ZLGCAN_BACKEND === 'sim' || process.platform !== 'win32';
+
+    if (options.backend === 'virtual') {
+        device = await openDevice(zlgcan.DeviceType.ZCAN_VIRTUAL_DEVICE, 0);
+    } else if (options.backend === 'auto' && !simulated) {
+        device = await openDevice(options.deviceType, options.deviceIndex);
+        backend = 'hw';
+        if (!device) {
+            device = await openDevice(zlgcan.DeviceType.ZCAN_VIRTUAL_DEVICE, 0);
+            backend = 'virtual';
+        }
+    } else {
+        device = await openDevice(options.deviceType, options.deviceIndex);
+        if (options.backend === 'auto') {
+            backend = simulated ? 'sim' : 'hw';
+        }
+    }
+    if (!device) {
+        throw new Error(`打开设备失败（backend=${backend}）`);
+    }
+
+    const config = {
+        protocolType: devices.CanProtocolType.CANFD,
+        arbitrationBaudrate: options.abitKbps,
+        dataBaudrate: options.dbitKbps,
+    };
+    const tx = await device.initChannel(0, config);
+    const rx = await device.initChannel(1, config);
+    await tx.start();
+    await rx.start();
+    return { backend, device, tx, rx };
+}
+
+// ==================== 延迟 ====================
+
+interface LatencyResult {
+    fd: boolean;
+    len: number;
+    /** 发送调用 -> JS收到（主机时钟） */
+    endToEndUs: Percentiles;
+    /** 发送调用 -> 帧在总线上结束（硬件时间戳，见文件头说明） */
+    txToBusUs: Percentiles;
+    /** 帧结束 -> 轮询取回 */
+    busToAppUs: Percentiles;
+    lost: number;
+}
+
+async function measureLatency(loop: Loopback, fd: boolean, len: number): Promise<LatencyResult> {
+    const pending = new Map<number, number>();
+    const samples: Array<{ txUs: number; rxUs: number; hwUs: number }> = [];
+    let arrived: (() => void) | null = null;
+
+    const poller = new ReceivePoller(loop.rx, fd, options.pollMs, options.rxBatch, frames => {
+        for (const frame of frames) {
+            const seq = frame.data[0] | (frame.data[1] << 8) | (frame.data[2] << 16);
+            const txUs = pending.get(seq);
+            if (txUs !== undefined) {
+                pending.delete(seq);
+                samples.push({ txUs, rxUs: frame.hostUs, hwUs: frame.timestamp });
+                arrived?.();
+            }
+        }
+    });
+
+    await loop.rx.clearBuffer();
+    poller.start();
+    let lost = 0;
+    try {
+        for (let seq = 0; seq < options.pings; seq++) {
+            const data = new Array<number>(len).fill(0);
+            data[0] = seq & 0xFF;
+            data[1] = (seq >> 8) & 0xFF;
+            data[2] = (seq >> 16) & 0xFF;
+            const received = new Promise<void>(resolve => { arrived = resolve; });
+            const timeout = sleep(Math.max(200, options.pollMs * 20)).then(() => false);
+
+            pending.set(seq, nowUs());
+            if (fd) {
+                await loop.tx.transmitFD({ id: 0x100, length: len, data, flags: zlgcan.CanFDFrameFlags.CANFD_BRS });
+            } else {
+                await loop.tx.transmit({ id: 0x100, dlc: len, data });
+            }
+            if (!await Promise.race([received.then(() => true), timeout])) {
+                pending.delete(seq);
+                lost++;
+            }
+        }
+    } finally {
+        poller.stop();
+    }
+
+    // 以总线->应用段的最小值对齐设备时钟与主机时钟
+    let offset = Infinity;
+    for (const s of samples) {
+        offset = Math.min(offset, s.rxUs - s.hwUs);
+    }
+    return {
+        fd,
+        len,
+        endToEndUs: percentiles(samples.map(s => s.rxUs - s.txUs)),
+        txToBusUs: percentiles(samples.map(s => s.hwUs + offset - s.txUs)),
+        busToAppUs: percentiles(samples.map(s => s.rxUs - s.hwUs - offset)),
+        lost,
+    };
+}
+
+// ==================== 吞吐 ====================
+
+interface ThroughputResult {
+    fd: boolean;
+    len: number;
+    durationS: number;
+    txFrames: number;
+    rxFrames: number;
+    /** JS收到的帧率 */
+    framesPerSecond: number;
+    /** 按硬件时间戳跨度计算的总线帧率 */
+    busFramesPerSecond: number;
+    /** 标称帧时长估计的总线负载（不含动态填充位，偏低） */
+    busLoad: number;
+    /** 发送队列满（transmit失败）的次数 */
+    txBackoffs: number;
+    /** 进程CPU时间（用户+系统，含原生线程）每帧 */
+    cpuUsPerFrame: number;
+}
+
+async function measureThroughput(loop: Loopback, fd: boolean, len: number): Promise<ThroughputResult> {
+    let rxFrames = 0;
+    let firstHw = NaN;
+    let lastHw = NaN;
+    const poller = new ReceivePoller(loop.rx, fd, options.pollMs, options.rxBatch, frames => {
+        rxFrames += frames.length;
+        if (Number.isNaN(firstHw)) {
+            firstHw = frames[0].timestamp;
+        }
+        lastHw = frames[frames.length - 1].timestamp;
+    });
+
+    await loop.rx.clearBuffer();
+    const data = Array.from({ length: len }, (_, i) => i & 0xFF);
+    let running = true;
+    let txFrames = 0;
+    let txBackoffs = 0;
+
+    // 与执行器相同逐帧发送；发送队列满时让出事件循环，保证轮询定时器得以运行
+    const sender = (async () => {
+        let sinceYield = 0;
+        while (running) {
+            try {
+                if (fd) {
+                    await loop.tx.transmitFD({ id: 0x100, length: len, data, flags: zlgcan.CanFDFrameFlags.CANFD_BRS });
+                } else {
+                    await loop.tx.transmit({ id: 0x100, dlc: len, data });
+                }
+                txFrames++;
+                if (++sinceYield >= 64) {
+                    sinceYield = 0;
+                    await yieldMacrotask();
+                }
+            } catch {
+                txBackoffs++;
+                sinceYield = 0;
+                await sleep(1);
+            }
+        }
+    })();
+
+    poller.start();
+    // 预热，让发送队列进入饱和
+    await sleep(200);
+    const startRx = rxFrames;
+    const startUs = nowUs();
+    const startCpu = process.cpuUsage();
+    const startHw = lastHw;
+    await sleep(options.durationS * 1000);
+    const cpu = process.cpuUsage(startCpu);
+    const elapsedUs = nowUs() - startUs;
+    const windowFrames = rxFrames - startRx;
+    const hwSpanUs = lastHw - (Number.isNaN(startHw) ? firstHw : startHw);
+    running = false;
+    await sender;
+    poller.stop();
+    await loop.rx.clearBuffer();
+
+    const frameUs = nominalFrameUs(fd, len, options.abitKbps, options.dbitKbps);
+    return {
+        fd,
+        len,
+        durationS: elapsedUs / 1e6,
+        txFrames,
+        rxFrames: windowFrames,
+        framesPerSecond: windowFrames * 1e6 / elapsedUs,
+        busFramesPerSecond: hwSpanUs > 0 ? windowFrames * 1e6 / hwSpanUs : NaN,
+        busLoad: windowFrames * frameUs / elapsedUs,
+        txBackoffs,
+        cpuUsPerFrame: windowFrames > 0 ? (cpu.user + cpu.system) / windowFrames : NaN,
+    };
+}
+
+// ==================== 报告 ====================
+
+function fmt(value: number, digits = 1): string {
+    return Number.isFinite(value) ? value.toFixed(digits) : '-';
+}
+
+function formatPercentiles(p: Percentiles): string {
+    return `p50=${fmt(p.p50)} p99=${fmt(p.p99)} p99.9=${fmt(p.p999)} max=${fmt(p.max)}`;
+}
+
+async function main(): Promise<void> {
+    const loop = await openLoopback();
+    log(`后端: ${loop.backend}，轮询间隔: ${options.pollMs}ms，波特率: ${options.abitKbps}k/${options.dbitKbps}k`);
+
+    const latency: LatencyResult[] = [];
+    const throughput: ThroughputResult[] = [];
+    try {
+        if (options.only !== 'throughput') {
+            for (const [fd, len] of [[false, 8], [true, 64]] as Array<[boolean, number]>) {
+                const result = await measureLatency(loop, fd, len);
+                latency.push(result);
+                const name = fd ? `CANFD/${len}` : `CAN/${len}`;
+                log(`[延迟] ${name} 端到端(us): ${formatPercentiles(result.endToEndUs)}，丢失${result.lost}`);
+                log(`       发送->总线(us): ${formatPercentiles(result.txToBusUs)}`);
+                log(`       总线->应用(us): ${formatPercentiles(result.busToAppUs)}`);
+            }
+        }
+        if (options.only !== 'latency') {
+            for (const [fd, len] of [[false, 8], [true, 64]] as Array<[boolean, number]>) {
+                const result = await measureThroughput(loop, fd, len);
+                throughput.push(result);
+                const name = fd ? `CANFD/${len}+BRS` : `CAN/${len}`;
+                log(`[吞吐] ${name}: ${fmt(result.framesPerSecond, 0)} 帧/s（总线 ${fmt(result.busFramesPerSecond, 0)}），` +
+                    `负载 ${fmt(result.busLoad * 100)}%，CPU ${fmt(result.cpuUsPerFrame, 2)} us/帧，发送退避 ${result.txBackoffs}`);
+            }
+        }
+    } finally {
+        loop.device.close();
+    }
+
+    const report = {
+        timestamp: new Date().toISOString(),
+        node: process.version,
+        platform: `${os.platform()}-${os.arch()}`,
+        cpu: os.cpus()[0]?.model ?? '',
+        backend: loop.backend,
+        options: { ...options, json: undefined },
+        latency,
+        throughput,
+    };
+    if (jsonToStdout) {
+        process.stdout.write(JSON.stringify(report, null, 2) + '\n');
+    } else if (options.json) {
+        fs.writeFileSync(options.json, JSON.stringify(report, null, 2));
+        log(`JSON结果已写入 ${options.json}`);
+    }
+}
+
+main().catch(error => {
+    console.error(error);
+    process.exitCode = 1;
+});